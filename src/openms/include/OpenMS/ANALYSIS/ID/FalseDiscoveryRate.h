@@ -100,6 +100,45 @@ public:
     */
     void apply(std::vector<ProteinIdentification> & ids);
 
+    /// Score of a target or decoy hit, as used by calculateFDRs()
+    struct OPENMS_DLLAPI ScoredHit
+    {
+      /// Default constructor
+      ScoredHit();
+
+      /// Detailed constructor
+      ScoredHit(double score, bool is_decoy, Size index, UInt group = 0);
+
+      /// score of the hit
+      double score;
+      /// position of the result in the output vector of calculateFDRs()
+      Size index;
+      /// hits of different groups (e.g. charge states or runs) are evaluated separately
+      UInt group;
+      /// decoy or target hit
+      bool is_decoy;
+    };
+
+    /**
+        @brief Calculates FDRs or q-values for a list of target and decoy scores
+
+        The hits are sorted once (in parallel, if OpenMP is enabled) by group
+        and score. Each group is then evaluated independently in linear time:
+        The FDR of a target score is the number of decoys with the same or a
+        better score, divided by the number of such targets. q-values are the
+        minimal FDR of all target scores that are not better (but at most 1).
+        Decoys get the value of the target with the closest score.
+        If a group contains no targets, its decoys get a value of 1.
+
+        @param hits Scores to evaluate (sorted by group and from the best to the worst score afterwards)
+        @param fdrs The FDR/q-value of a hit is written to position @p index (the size of the vector is not changed)
+        @param q_value Calculate q-values instead of FDRs?
+        @param higher_score_better Are higher scores better?
+
+        @exception Exception::IndexOverflow is thrown if an index does not fit into @p fdrs
+    */
+    static void calculateFDRs(std::vector<ScoredHit> & hits, std::vector<double> & fdrs, bool q_value, bool higher_score_better);
+
 private:
     ///Not implemented
     FalseDiscoveryRate(const FalseDiscoveryRate &);
@@ -107,9 +146,6 @@ private:
     ///Not implemented
     FalseDiscoveryRate & operator=(const FalseDiscoveryRate &);
 
-    /// calculates the fdr stored into fdrs, given two vectors of scores
-    void calculateFDRs_(Map<double, double> & score_to_fdr, std::vector<double> & target_scores, std::vector<double> & decoy_scores, bool q_value, bool higher_score_better);
-
   };
 
 } // namespace OpenMS
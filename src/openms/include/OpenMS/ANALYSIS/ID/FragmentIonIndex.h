@@ -0,0 +1,163 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_ANALYSIS_ID_FRAGMENTIONINDEX_H
+#define OPENMS_ANALYSIS_ID_FRAGMENTIONINDEX_H
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class TheoreticalSpectrumGenerator;
+
+  /**
+    @brief An index of the theoretical fragment ions of a set of candidate peptides
+
+    Instead of generating a theoretical spectrum for every candidate peptide
+    and comparing it against all spectra with a matching precursor mass,
+    the theoretical spectra of all candidates are generated once and stored
+    in an index which maps fragment m/z to peptides. A spectrum is then scored
+    against all candidates in its precursor mass window at once by looking
+    up its peaks in the index.
+
+    The candidates are sorted by mass and partitioned into blocks of
+    consecutive peptides. Within each block the fragments are sorted by m/z.
+    A search only visits the blocks overlapping the precursor mass window, so
+    for narrow (closed) searches the relevant part of the index stays small
+    enough to be cache resident while wide (open) searches remain possible.
+
+    Scores are X!Tandem HyperScores (see HyperScore) and are identical to
+    HyperScore::compute on the theoretical spectrum of the candidate: each
+    theoretical peak is matched to its nearest experimental peak if it lies
+    within the fragment mass tolerance.
+
+    The index is immutable after build(), search() is const and can be called
+    concurrently from several threads.
+
+    @ingroup Analysis_ID
+  */
+  class OPENMS_DLLAPI FragmentIonIndex
+  {
+public:
+    /// A candidate peptide (index into the mass-sorted peptides) and its score
+    typedef std::pair<Size, double> PeptideScore;
+
+    /// Number of peptides in a block of the index
+    static const Size BLOCK_SIZE = 4096;
+
+    /// Default constructor (empty index)
+    FragmentIonIndex();
+
+    /// Destructor
+    ~FragmentIonIndex();
+
+    /**
+      @brief Builds the index for the given candidate peptides
+
+      The peptides are sorted by their monoisotopic mass (see getPeptide())
+      and the theoretical spectrum of each peptide is generated with @p generator
+      (charge 1). The generator needs to annotate its peaks with the
+      "IonName" meta value (parameter "add_metainfo"), b- and y-ions are
+      counted for the HyperScore based on it.
+
+      @exception Exception::InvalidSize is thrown if there are too many peptides for the index
+    */
+    void build(const std::vector<AASequence>& peptides, const TheoreticalSpectrumGenerator& generator);
+
+    /**
+      @brief Scores a spectrum against all candidates within the precursor mass window
+
+      A candidate with mass m is considered if the precursor mass lies within
+      m +/- 0.5 * @p precursor_mass_tolerance (Da) or m +/- 0.5 * m * @p precursor_mass_tolerance * 1e-6 (ppm).
+
+      @param spectrum Experimental spectrum (sorted by m/z)
+      @param precursor_mass Neutral precursor mass of the spectrum
+      @param precursor_mass_tolerance Width of the precursor mass window
+      @param precursor_mass_tolerance_unit_ppm Unit of the precursor mass tolerance: Da if false, ppm if true
+      @param fragment_mass_tolerance Fragment mass tolerance applied left and right of a theoretical peak
+      @param fragment_mass_tolerance_unit_ppm Unit of the fragment mass tolerance: Th if false, ppm if true
+      @param hits Output: candidates with a score > 0 (in ascending order of peptide index)
+    */
+    void search(const PeakSpectrum& spectrum, double precursor_mass,
+                double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm,
+                double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm,
+                std::vector<PeptideScore>& hits) const;
+
+    /// Returns the number of candidate peptides
+    Size getNrPeptides() const;
+
+    /// Returns the number of indexed fragment ions
+    Size getNrFragments() const;
+
+    /// Returns the candidate peptide with the given index (peptides are sorted by mass)
+    const AASequence& getPeptide(Size index) const;
+
+    /// Returns the monoisotopic mass of the candidate peptide with the given index
+    double getPeptideMass(Size index) const;
+
+protected:
+    /// A theoretical fragment ion
+    struct Fragment
+    {
+      /// m/z of the fragment
+      double mz;
+      /// peptide index (lower 30 bits) and ion type (upper 2 bits)
+      UInt32 peptide_and_type;
+      /// intensity of the theoretical peak
+      float intensity;
+    };
+
+    /// ion types stored with a fragment
+    enum IonType {OTHER_ION = 0, B_ION = 1, Y_ION = 2};
+
+    /// candidate peptides, sorted by mass
+    std::vector<AASequence> peptides_;
+    /// monoisotopic masses of peptides_
+    std::vector<double> masses_;
+    /// fragments of all blocks (each block sorted by m/z)
+    std::vector<Fragment> fragments_;
+    /// start of each block in fragments_ (plus the end of the last block)
+    std::vector<Size> block_begin_;
+
+private:
+    FragmentIonIndex(const FragmentIonIndex&);
+    FragmentIonIndex& operator=(const FragmentIonIndex&);
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_ANALYSIS_ID_FRAGMENTIONINDEX_H
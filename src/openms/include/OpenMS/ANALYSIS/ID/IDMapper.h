@@ -237,6 +237,8 @@ public:
 
       If several features (incl. tolerance) overlap the position of a peptide identification, the identification is annotated to all of them.
 
+      Candidate features are looked up in a BoundingBoxIndex. Peptide identifications are matched in parallel (if OpenMP is enabled), but annotated in their input order.
+
       @param map FeatureMap to receive the identifications
       @param ids PeptideIdentification for the ConsensusFeatures
       @param protein_ids ProteinIdentification for the ConsensusMap
@@ -255,6 +257,8 @@ public:
       If several consensus features lie inside the allowed deviation, the peptide identifications
       are mapped to all the consensus features.
 
+      As for feature maps, candidates are looked up in a BoundingBoxIndex and peptide identifications are matched in parallel.
+
       @param map ConsensusMap to receive the identifications
       @param ids PeptideIdentification for the ConsensusFeatures
       @param protein_ids ProteinIdentification for the ConsensusMap
@@ -382,7 +386,10 @@ protected:
     void getIDDetails_(const PeptideIdentification& id, double& rt_pep, DoubleList& mz_values, IntList& charges, bool use_avg_mass = false) const;
 
     /// increase a bounding box by the given RT and m/z tolerances
-    void increaseBoundingBox_(DBoundingBox<2>& box);
+    void increaseBoundingBox_(DBoundingBox<2>& box) const;
+
+    /// get a box around the positions (@p rt, @p mz_values) that contains all positions accepted by isMatch_() (with a small safety margin)
+    DBoundingBox<2> getQueryBox_(const double rt, const DoubleList& mz_values) const;
 
     /// try to determine the type of m/z value reported for features, return
     /// whether average peptide masses should be used for matching
@@ -43,10 +43,13 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <fstream>
 
 namespace OpenMS
 {
+  class ProteinSuffixArrayIndex;
 
 /**
   @brief Refreshes the protein references for all peptide hits in a vector of PeptideIdentifications and adds target/decoy information.
@@ -102,6 +105,19 @@ namespace OpenMS
   which is usually cleaved off in vivo. For example, the two peptides AAAR and MAAAR would both match a protein starting with MAAAR.
   You can relax the requirements further by choosing <tt>semi-tryptic</tt> (only one of two "internal" termini must match requirements)
   or <tt>none</tt> (essentially allowing all hits, no matter their context).
+
+  Persistent protein index:
+  Both search modes prepare the protein database from scratch on every call. If the same database is used many times, a persistent
+  index (a suffix array of all proteins, see ProteinSuffixArrayIndex) can be used instead by setting the @p index_file parameter.
+  The index is built once and stored in @p index_file; subsequent runs (also from other processes) only map the file into memory
+  and look up each peptide in logarithmic time. The index also stores the FASTA entries: when the database is given by its file name
+  (see run(const String&, ...)), a valid index is used without loading the FASTA file at all. The index is keyed on a checksum of
+  the content of the FASTA file (see FileHandler::computeFileHash()) or, for a database in memory, on all of its entries, and on the
+  settings which influence it (@p IL_equivalent, @p decoy_string, @p decoy_string_position); it is rebuilt automatically if any of
+  these change. Computing the checksum reads the FASTA file once per run, which is far cheaper than parsing it and guarantees that a
+  modified database (even of the same size and time stamp) never reuses a stale index.
+  Within one PeptideIndexing object the mapped index is kept between calls of run() and is shared by all threads.
+  Results are identical to the exact and tolerant searches described above.
 */
 
  class OPENMS_DLLAPI PeptideIndexing :
@@ -129,6 +145,13 @@ public:
     /// main method of PeptideIndexing
     ExitCodes run(std::vector<FASTAFile::FASTAEntry>& proteins, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids);
 
+    /**
+      @brief Same as above, for the database stored in @p fasta_file
+
+      If a valid protein index (parameter @p index_file) exists for this file, the FASTA file is not loaded.
+    */
+    ExitCodes run(const String& fasta_file, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids);
+
 protected:
     virtual void updateMembers_();
 
@@ -136,6 +159,36 @@ protected:
 
     void writeDebug_(const String& text, const Size min_level) const;
 
+    /**
+      @brief Implementation of run()
+
+      @param proteins Protein database (duplicates are removed)
+      @param fasta_file File the database was loaded from (empty if unknown)
+      @param index_only If true, @p proteins is empty and the mapped protein index is used as database
+      @param prot_ids Protein identifications to update
+      @param pep_ids Peptide identifications to update
+    */
+    ExitCodes run_(std::vector<FASTAFile::FASTAEntry>& proteins, const String& fasta_file, bool index_only,
+                   std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids);
+
+    /// Hash of all settings which influence the protein index
+    UInt64 settingsKey_() const;
+
+    /// Key of the protein index for @p fasta_file: settings and a checksum of the content of the file
+    UInt64 fileKey_(const String& fasta_file) const;
+
+    /// Maps the protein index @p index_file_ if it was built with @p key; returns false if it needs to be (re)built
+    bool openProteinIndex_(UInt64 key);
+
+    /**
+      @brief Builds the protein index @p index_file_ with @p key and maps it
+
+      @param key Key of the index
+      @param proteins FASTA entries (stored in the index)
+      @param sequences Protein sequences as used for matching (same order as @p proteins)
+    */
+    void buildProteinIndex_(UInt64 key, const std::vector<FASTAFile::FASTAEntry>& proteins, const std::vector<String>& sequences);
+
     /// Output stream for log/debug info
     String log_file_;
     mutable std::ofstream log_;
@@ -159,6 +212,11 @@ protected:
     UInt mismatches_max_;
     bool filter_aaa_proteins_;
 
+    /// file name of the persistent protein index (empty: no index)
+    String index_file_;
+    /// the mapped protein index (kept between calls of run())
+    boost::shared_ptr<ProteinSuffixArrayIndex> protein_index_;
+
   };
 }
 
@@ -0,0 +1,233 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_ANALYSIS_ID_PROTEINSUFFIXARRAYINDEX_H
+#define OPENMS_ANALYSIS_ID_PROTEINSUFFIXARRAYINDEX_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Persistent, memory-mapped suffix array over a protein database
+
+    The index is built once for a protein database (see build()) and stored
+    in a binary file, which is mapped into memory when an object of this
+    class is constructed. Opening an existing index therefore costs only a
+    few milliseconds, independent of the size of the database, and the
+    operating system shares the mapped pages between all processes using
+    the same index. After construction the object is immutable, i.e. all
+    search functions can be called concurrently from multiple threads.
+
+    Every index carries a user defined key (e.g. the identity of the FASTA
+    file and all settings which influence the stored sequences), which can be
+    queried without mapping the file (see readKey()) to decide whether an
+    existing index can be reused.
+
+    Optionally, the original FASTA entries (identifier, description and
+    unmodified sequence) are stored as well (see getEntry()). An index with
+    entries is self-contained, i.e. a reused index does not require the
+    FASTA file to be loaded at all.
+
+    Protein sequences are stored in the 24 letter amino acid alphabet used
+    by PeptideIndexing (see normalizeSequence()). Besides exact lookups
+    (findExact()), the index supports the error tolerant matching of
+    PeptideIndexing, i.e. ambiguous amino acids in the proteins and real
+    mismatches (findTolerant()).
+
+    The file layout (all values in native byte order) is:
+
+    - a header of one page (4096 bytes) with the file identifier, the format version, the key and the section offsets
+    - the concatenated protein sequences, each terminated by a zero byte
+    - the start offset of each protein in the sequence section (plus the total length)
+    - one flag byte per protein (decoy, contains ambiguous amino acids)
+    - the start offset of each FASTA entry in the entry section (plus the total length; all zero if no entries were stored)
+    - the FASTA entries, each as identifier, description and sequence terminated by a zero byte
+    - the suffix array: the offsets of all suffixes of the sequence section (excluding terminators) in lexicographical order
+    - the file identifier (to detect truncated files)
+  */
+  class OPENMS_DLLAPI ProteinSuffixArrayIndex
+  {
+public:
+
+    /// File identifier stored at the beginning and at the end of the file
+    static const UInt64 FILE_IDENTIFIER;
+
+    /// Current version of the file format
+    static const UInt32 FILE_VERSION;
+
+    /// Size of the file header (one memory page)
+    static const Size HEADER_SIZE;
+
+    /// Position of a peptide in a protein of the index
+    struct Occurrence
+    {
+      /// index of the protein (order of build())
+      Size protein_index;
+      /// zero-based position of the peptide in the protein
+      Size position;
+    };
+
+    /**
+      @brief Maps the index @p filename into memory
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a valid protein index
+    */
+    explicit ProteinSuffixArrayIndex(const String& filename);
+
+    /// Destructor, unmaps the file
+    ~ProteinSuffixArrayIndex();
+
+    /**
+      @brief Builds the index for @p proteins and stores it in @p filename
+
+      The sequences are normalized (see normalizeSequence()) before they are
+      stored. The file is written under a temporary name and renamed at the
+      end, so concurrent readers never see a partially written index.
+
+      @param filename Output file
+      @param proteins Protein sequences (the order defines the protein indices)
+      @param is_decoy Decoy flag per protein (same size as @p proteins)
+      @param key User defined key stored in the header (see readKey())
+      @param entries FASTA entries of the proteins (same size as @p proteins, or empty to store none)
+
+      @exception Exception::InvalidSize is thrown if @p is_decoy or a non-empty @p entries and @p proteins differ in size
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    static void build(const String& filename, const std::vector<String>& proteins, const std::vector<bool>& is_decoy, UInt64 key,
+                      const std::vector<FASTAFile::FASTAEntry>& entries = std::vector<FASTAFile::FASTAEntry>());
+
+    /**
+      @brief Reads the key of the index @p filename without mapping it
+
+      @return false if the file does not exist or is not a protein index of the current format version
+    */
+    static bool readKey(const String& filename, UInt64& key);
+
+    /**
+      @brief Converts @p sequence to the alphabet of the index
+
+      Letters are converted to upper case; letters which are not in the 24
+      letter amino acid alphabet ("ARNDCQEGHILKMFPSTWYVBZX*") are replaced by 'X'.
+    */
+    static void normalizeSequence(String& sequence);
+
+    /// Key stored in the index
+    UInt64 getKey() const;
+
+    /// Number of proteins in the index
+    Size getNrProteins() const;
+
+    /// Normalized sequence of protein @p index
+    String getProteinSequence(Size index) const;
+
+    /// Returns true if the FASTA entries were stored during build()
+    bool hasEntries() const;
+
+    /// Identifier (accession) of protein @p index (empty if no entries were stored)
+    String getAccession(Size index) const;
+
+    /// FASTA entry of protein @p index as passed to build() (all members empty if no entries were stored)
+    FASTAFile::FASTAEntry getEntry(Size index) const;
+
+    /// Returns true if protein @p index was flagged as decoy during build()
+    bool isDecoy(Size index) const;
+
+    /// Returns true if protein @p index contains ambiguous amino acids ('B', 'Z' or 'X')
+    bool hasAmbiguousAA(Size index) const;
+
+    /**
+      @brief Finds all exact occurrences of @p peptide
+
+      @p peptide must be normalized (see normalizeSequence()). Each lookup
+      costs O(|peptide| * log(N)) for a database of N amino acids.
+      @p hits is cleared first.
+    */
+    void findExact(const String& peptide, std::vector<Occurrence>& hits) const;
+
+    /**
+      @brief Finds all occurrences of @p peptide allowing ambiguous amino acids and mismatches
+
+      Matching follows the tolerant search of PeptideIndexing: 'B', 'Z' and 'X'
+      in a protein match all amino acids of their class (e.g. 'B' matches 'D'
+      and 'N'), each costing one of @p aaa_max tokens; ambiguous amino acids
+      in the peptide only match the identical letter in the protein. All other
+      differences count as mismatches (at most @p mismatches_max).
+
+      @p peptide must be normalized (see normalizeSequence()). @p hits is cleared first.
+    */
+    void findTolerant(const String& peptide, Size aaa_max, Size mismatches_max, std::vector<Occurrence>& hits) const;
+
+    /// Name of the mapped file
+    const String& getFilename() const;
+
+private:
+
+    /// Not implemented (the mapping is not copyable, share the object instead)
+    ProteinSuffixArrayIndex(const ProteinSuffixArrayIndex& rhs);
+
+    /// Not implemented
+    ProteinSuffixArrayIndex& operator=(const ProteinSuffixArrayIndex& rhs);
+
+    /// Recursive step of findTolerant(): extends the match of the suffixes in [@p first, @p last) by @p depth
+    void extendTolerant_(const String& peptide, Size depth, Size first, Size last, Size aaa_left, Size mismatches_left, std::vector<Occurrence>& hits) const;
+
+    /// Appends the occurrences of the suffixes in [@p first, @p last) to @p hits
+    void reportOccurrences_(Size first, Size last, std::vector<Occurrence>& hits) const;
+
+    String filename_;
+    boost::iostreams::mapped_file_source file_;
+    UInt64 key_;
+    Size nr_proteins_;
+    Size sa_length_;
+    const char* text_;
+    const UInt64* protein_offsets_;
+    const Byte* flags_;
+    const UInt64* entry_offsets_;
+    const char* entries_;
+    const UInt64* suffix_array_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_ANALYSIS_ID_PROTEINSUFFIXARRAYINDEX_H
@@ -15,6 +15,7 @@ ConsensusIDAlgorithmRanks.h
 ConsensusIDAlgorithmSimilarity.h
 ConsensusIDAlgorithmWorst.h
 FalseDiscoveryRate.h
+FragmentIonIndex.h
 HiddenMarkovModel.h
 IDDecoyProbability.h
 IDMapper.h
@@ -23,6 +24,7 @@ MetaboliteSpectralMatching.h
 PeptideProteinResolution.h
 ProtonDistributionModel.h
 PeptideIndexing.h
+ProteinSuffixArrayIndex.h
 )
 
 ### add path to the filenames
@@ -41,6 +41,7 @@
 
 #include <utility>
 #include <fstream>
+#include <set>
 
 namespace OpenMS
 {
@@ -89,8 +90,18 @@ protected:
     */
     void checkIds_(const std::vector<ConsensusMap> & maps) const;
 
+    /**
+      @brief Checks if the file descriptions of two maps have disjoint map identifiers
+
+      @exception Exception::IllegalArgument Is thrown if a file id is found twice
+    */
+    void checkIds_(const ConsensusMap & map_0, const ConsensusMap & map_1) const;
+
 private:
 
+    /// Adds the file ids of @p map to @p used_ids, throws Exception::IllegalArgument if an id was used before
+    void checkIds_(const ConsensusMap & map, std::set<Size> & used_ids) const;
+
     /// Copy constructor intentionally not implemented
     BaseGroupFinder(const BaseGroupFinder &);
 
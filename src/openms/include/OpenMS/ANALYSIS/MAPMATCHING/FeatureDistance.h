@@ -103,6 +103,9 @@ public:
     FeatureDistance(double max_intensity = 1.0,
                     bool force_constraints = false);
 
+    /// Copy constructor
+    FeatureDistance(const FeatureDistance & other);
+
     /// Destructor
     virtual ~FeatureDistance();
 
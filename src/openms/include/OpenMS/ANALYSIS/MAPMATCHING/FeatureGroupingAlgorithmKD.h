@@ -39,9 +39,14 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/KDTreeFeatureMaps.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/FeatureDistance.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/DATASTRUCTURES/DRange.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/FORMAT/FileTypes.h>
 
 namespace OpenMS
 {
+  class MapAlignmentAlgorithmKD;
+
 
 ///
 /**
@@ -204,6 +209,32 @@ public:
     virtual void group(const std::vector<ConsensusMap>& maps,
                        ConsensusMap& out);
 
+    /**
+        @brief Applies the algorithm to the maps stored in @p filenames, out of core
+
+        Produces the same result as group() on the loaded maps, but never
+        holds more than one complete input map and one chunk of features in
+        memory (plus the result). Consecutive m/z partitions are combined into
+        chunks of at most @p max_chunk_size features (summed over all maps; a
+        chunk contains at least one partition). After a scan of the inputs
+        that collects the m/z values for partitioning and the document level
+        data, two passes over the chunks follow: the first computes the RT fit
+        data for the LOWESS transformations (only if 'warp' is enabled), the
+        second links the features. For each chunk, only the features in its
+        m/z range are loaded from every input file and its partitions are
+        processed in parallel. Every input file is thus parsed once per chunk
+        and pass.
+
+        As group() does not know the input files, the file descriptions
+        (file name, size, unique id) and primary MS run paths of @p out are
+        set here as well. Feature maps are loaded without convex hulls,
+        subordinates and meta values.
+
+        @exception IllegalArgument is thrown if less than two input files are given.
+        @exception InvalidParameter is thrown if the input files are not all of the same type (featureXML, consensusXML, featureBin or consensusBin).
+    */
+    void group(const StringList& filenames, ConsensusMap& out, Size max_chunk_size);
+
     /// Creates a new instance of this class (for Factory)
     static FeatureGroupingAlgorithm* create()
     {
@@ -232,14 +263,41 @@ private:
     template <typename MapType>
     void group_(const std::vector<MapType>& input_maps, ConsensusMap& out);
 
-    /// Run the actual clustering algorithm
-    void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out);
+    /// Reads the tolerances from the parameters and sets up feature_distance_ (normalized to @p max_intensity)
+    void setUpDistance_(double max_intensity);
+
+    /// Computes the m/z partition boundaries from the m/z values of all features (sorts @p massrange)
+    void computePartitionBoundaries_(std::vector<double>& massrange, std::vector<double>& partition_boundaries) const;
+
+    /// Fills @p partition_indices (one entry per partition, starting at @p first_partition) with the indices of the features of @p input_maps in each partition; features outside these partitions are skipped
+    template <typename MapType>
+    void assignPartitions_(const std::vector<MapType>& input_maps, const std::vector<double>& partition_boundaries, Size first_partition, std::vector<std::vector<std::vector<Size> > >& partition_indices) const;
+
+    /// Computes the RT fit data of the partitions in parallel and adds it to @p aligner in partition order
+    template <typename MapType>
+    void addRTFitData_(const std::vector<MapType>& input_maps, const std::vector<std::vector<std::vector<Size> > >& partition_indices, MapAlignmentAlgorithmKD& aligner, Size& progress);
+
+    /// Links the partitions in parallel (after transforming RTs with @p aligner, if not null) and appends the results to @p out in partition order
+    template <typename MapType>
+    void linkPartitions_(const std::vector<MapType>& input_maps, const std::vector<std::vector<std::vector<Size> > >& partition_indices, const MapAlignmentAlgorithmKD* aligner, ConsensusMap& out, Size& progress);
+
+    /// Sorts the result into canonical order
+    void sortResult_(ConsensusMap& out);
+
+    /// Loads the features of @p filename within @p mz_range (all features if the range is empty) into @p map
+    void loadMap_(const String& filename, FileTypes::Type type, Size map_index, const DRange<1>& mz_range, ConsensusMap& map) const;
+
+    /// Loads the features of the partitions [@p first_partition, @p last_partition) from all @p filenames and assigns them to their partitions
+    void loadChunk_(const StringList& filenames, FileTypes::Type type, const std::vector<double>& partition_boundaries, Size first_partition, Size last_partition, std::vector<ConsensusMap>& maps, std::vector<std::vector<std::vector<Size> > >& partition_indices) const;
+
+    /// Run the actual clustering algorithm (@p feature_distance is a per-thread copy of feature_distance_)
+    void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out, FeatureDistance& feature_distance) const;
 
     /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these
-    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data);
+    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const;
 
     /// Compute the current best cluster with center index @p i (mutates @p proxy and @p cf_indices)
-    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const;
+    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const;
 
     /// Construct consensus feature and add to out map
     void addConsensusFeature_(const std::vector<Size>& indices, const KDTreeFeatureMaps& kd_data, ConsensusMap& out) const;
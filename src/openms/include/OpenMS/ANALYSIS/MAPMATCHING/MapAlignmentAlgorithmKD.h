@@ -72,6 +72,12 @@ public:
   /// Compute data points needed for RT transformation in the current @p kd_data, add to fit_data_
   void addRTFitData(const KDTreeFeatureMaps& kd_data);
 
+  /// Compute data points needed for RT transformation in the current @p kd_data, append to @p fit_data (one entry per map). Does not modify the aligner, so several threads may call it concurrently.
+  void computeRTFitData(const KDTreeFeatureMaps& kd_data, std::vector<TransformationModel::DataPoints>& fit_data) const;
+
+  /// Add data points previously computed by computeRTFitData() to fit_data_
+  void addRTFitData(const std::vector<TransformationModel::DataPoints>& fit_data);
+
   /// Fit LOWESS to fit_data_, store final models in transformations_
   void fitLOWESS();
 
@@ -79,9 +79,23 @@ public:
     /// Destructor
     virtual ~MapAlignmentAlgorithmPoseClustering();
 
-    void align(const FeatureMap& map, TransformationDescription& trafo);
-    void align(const PeakMap& map, TransformationDescription& trafo);
-    void align(const ConsensusMap& map, TransformationDescription& trafo);
+    /**
+      @name Alignment of a map to the reference
+
+      The reference is preprocessed only once (in setReference()) and not
+      modified by these functions. They do not report progress either (the
+      superimposer and the pair finder are called without their
+      ProgressLogger), hence several maps can be aligned to the same
+      reference concurrently (e.g. in a parallel loop).
+
+      setReference() and setParameters() must not be called concurrently
+      with align().
+    */
+    //@{
+    void align(const FeatureMap& map, TransformationDescription& trafo) const;
+    void align(const PeakMap& map, TransformationDescription& trafo) const;
+    void align(const ConsensusMap& map, TransformationDescription& trafo) const;
+    //@}
 
     /// Sets the reference for the alignment
     template <typename MapType>
@@ -89,18 +103,28 @@ public:
     {
       MapType map2 = map; // todo: avoid copy (MSExperiment version of convert() demands non-const version)
       MapConversion::convert(0, map2, reference_, max_num_peaks_considered_);
+      preprocessReference_();
     }
 
+    /// Sets the reference for the alignment (without copying @p map)
+    void setReference(const FeatureMap& map);
+
 protected:
 
     virtual void updateMembers_();
 
+    /// Preprocesses the reference for the superimposer (once for all calls of align())
+    void preprocessReference_();
+
     PoseClusteringAffineSuperimposer superimposer_;
 
     StablePairFinder pairfinder_;
 
     ConsensusMap reference_;
 
+    /// Reference elements as used by the superimposer
+    PoseClusteringAffineSuperimposer::PreprocessedMap reference_points_;
+
     Int max_num_peaks_considered_;
 
 private:
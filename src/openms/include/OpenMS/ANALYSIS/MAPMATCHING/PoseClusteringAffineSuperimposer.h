@@ -69,6 +69,30 @@ namespace OpenMS
   {
 public:
 
+    /**
+      @brief Elements of a map as used for hashing (see preprocess())
+
+      Preprocessing a map once allows to superimpose it with many other maps
+      without repeating the selection, e.g. for the reference map of an
+      alignment.
+    */
+    struct PreprocessedMap
+    {
+      /// the most abundant elements ('num_used_points'), sorted by ascending m/z
+      std::vector<Peak2D> points;
+      /// minimal RT of all elements (not only the selected ones)
+      double min_rt;
+      /// maximal RT of all elements (not only the selected ones)
+      double max_rt;
+      /// total intensity of the selected elements
+      double total_intensity;
+
+      PreprocessedMap() :
+        points(), min_rt(0.0), max_rt(0.0), total_intensity(0.0)
+      {
+      }
+    };
+
     /// Default ctor
     PoseClusteringAffineSuperimposer();
 
@@ -101,6 +125,24 @@ public:
     /// Perform alignment on vector of 1D peaks
     virtual void run(const std::vector<Peak2D> & map_model, const std::vector<Peak2D> & map_scene, TransformationDescription & transformation);
 
+    /**
+      @brief Perform alignment on preprocessed maps
+
+      Neither the maps nor the superimposer are modified and no progress is
+      reported (unlike the other run() overloads, which share the
+      ProgressLogger of this instance), hence one (preprocessed) model map
+      can be superimposed with several scene maps concurrently.
+
+      @exception IllegalArgument is thrown if one of the maps is empty.
+    */
+    void run(const PreprocessedMap & map_model, const PreprocessedMap & map_scene, TransformationDescription & transformation) const;
+
+    /// Selects the elements of @p map used for hashing (see PreprocessedMap)
+    void preprocess(const std::vector<Peak2D> & map, PreprocessedMap & result) const;
+
+    /// Selects the elements of @p map used for hashing (see PreprocessedMap)
+    void preprocess(const ConsensusMap & map, PreprocessedMap & result) const;
+
     /// Returns an instance of this class
     static BaseSuperimposer * create()
     {
@@ -92,7 +92,9 @@ namespace OpenMS
    This algorithm includes a number of optimizations to reduce run-time:
    @li two-dimensional hashing of features,
    @li a look-up table for feature distances,
-   @li a variant of QT clustering that requires only one round of clustering.
+   @li a variant of QT clustering that requires only one round of clustering,
+   @li parallel computation of the initial clusters (if OpenMP is enabled),
+   @li a priority queue of the clusters, so the best one is found without scanning all of them.
 
    @see FeatureGroupingAlgorithmQT
 
@@ -111,9 +113,11 @@ private:
               std::pair<OpenMS::GridFeature*, OpenMS::GridFeature*>,
               double> PairDistances;
 
-    /// Map to store which grid features are next to which clusters
-    typedef OpenMSBoost::unordered_map<
-              OpenMS::GridFeature*, std::vector<QTCluster*> > ElementMapping;
+    /// Stores which clusters (by index) each grid feature (by index, see featureIndex_) is next to
+    typedef std::vector<std::vector<Size> > ElementMapping;
+
+    /// Valid clusters ordered by decreasing quality (ties: by increasing cluster index)
+    typedef std::set<std::pair<double, Size> > ClusterQueue;
 
     typedef HashGrid<OpenMS::GridFeature*> Grid;
 
@@ -135,25 +139,29 @@ private:
     /// Feature distance functor
     FeatureDistance feature_distance_;
 
-    /// Set of features already used
-    std::set<OpenMS::GridFeature*> already_used_;
+    /// Features already used (indexed by featureIndex_)
+    std::vector<bool> already_used_;
 
-    /**
-       @brief Calculates the distance between two grid features.
-    */
-    double getDistance_(const OpenMS::GridFeature* left, const
-        OpenMS::GridFeature* right);
+    /// Index of the first grid feature of each input map (plus the total number of features at the end)
+    std::vector<Size> map_offsets_;
+
+    /// Returns the index of a grid feature in the per-feature arrays (already_used_, ElementMapping)
+    inline Size featureIndex_(const OpenMS::GridFeature* feature) const
+    {
+      return map_offsets_[feature->getMapIndex()] + feature->getFeatureIndex();
+    }
 
     /// Sets algorithm parameters
     void setParameters_(double max_intensity, double max_mz);
 
     /// Generates a consensus feature from the best cluster and updates the clustering
-    void makeConsensusFeature_(std::list<QTCluster>& clustering,
+    void makeConsensusFeature_(std::vector<QTCluster>& clustering,
                                ConsensusFeature& feature,
-                               ElementMapping& element_mapping, Grid&);
+                               ElementMapping& element_mapping, Grid&,
+                               ClusterQueue& queue);
 
-    /// Computes an initial QT clustering of the points in the hash grid
-    void computeClustering_(Grid& grid, std::list<QTCluster>& clustering);
+    /// Computes an initial QT clustering of the points in the hash grid (in parallel, if OpenMP is enabled)
+    void computeClustering_(Grid& grid, std::vector<QTCluster>& clustering);
 
     /// Runs the algorithm on feature maps or consensus maps
     template <typename MapType>
@@ -164,9 +172,13 @@ private:
     void run_internal_(const std::vector<MapType>& input_maps,
                        ConsensusMap& result_map, bool do_progress);
 
-    /// Adds elements to the cluster based on the elements hashed in the grid
+    /**
+       @brief Adds elements to the cluster based on the elements hashed in the grid
+
+       Distances are computed with @p feature_distance (which is not thread-safe, so every thread needs its own copy).
+    */
     void addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-      const OpenMS::GridFeature* center_feature);
+      const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance);
 
 protected:
 
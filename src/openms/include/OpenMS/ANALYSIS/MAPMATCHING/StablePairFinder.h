@@ -144,6 +144,17 @@ public:
     void run(const std::vector<ConsensusMap>& input_maps,
              ConsensusMap& result_map);
 
+    /**
+      @brief Run the algorithm on two maps (without copying them into a vector)
+
+      Neither the maps nor the pair finder are modified and no progress is
+      reported, hence one map can be paired with several other maps concurrently.
+
+      @exception Exception::IllegalArgument is thrown if the input data is not valid.
+    */
+    void run(const ConsensusMap& map_0, const ConsensusMap& map_1,
+             ConsensusMap& result_map) const;
+
 protected:
 
     ///@name Internal helper classes and enums
@@ -104,6 +104,32 @@ public:
         std::vector<ExtractionCoordinates> extraction_coordinates, double mz_extraction_window,
         bool ppm, String filter);
 
+    /**
+     * @brief Extract chromatograms for a batch of (unsorted) ExtractionCoordinates.
+     *
+     * Same as extractChromatograms, but the coordinates do not need to be
+     * sorted by m/z. They are sorted once (output[k] still corresponds to
+     * extraction_coordinates[k]) after which each spectrum is traversed in a
+     * single merge-sweep: the lower and upper bound of the extraction windows
+     * only ever move forward through the spectrum, so the cost per spectrum is
+     * O(peaks + transitions) plus the summation of the peaks within each
+     * window. All peaks strictly inside a window are summed up.
+     *
+     * @param input Input spectral map
+     * @param output Output chromatograms (XICs), same size as extraction_coordinates
+     * @param extraction_coordinates Extracts around these coordinates (see extractChromatograms)
+     * @param mz_extraction_window Extracts a window of this size in m/z
+     * dimension in Th or ppm (e.g. a window of 50 ppm means an extraction of
+     * 25 ppm on either side)
+     * @param ppm Whether mz_extraction_window is in ppm or in Th
+     * @param filter Which function to apply in m/z space (currently "tophat" only)
+     *
+    */
+    void extractChromatogramsBatch(const OpenSwath::SpectrumAccessPtr input,
+        std::vector< OpenSwath::ChromatogramPtr >& output,
+        const std::vector<ExtractionCoordinates>& extraction_coordinates, double mz_extraction_window,
+        bool ppm, String filter);
+
     /**
      * @brief Extract the next mz value and add the integrated intensity to integrated_intensity. 
      *
@@ -128,6 +154,17 @@ private:
 
     int getFilterNr_(String filter);
 
+    /**
+     * @brief Sweep all spectra and extract the coordinates in the given order
+     *
+     * @p order contains indices into @p extraction_coordinates (and @p output)
+     * and has to be sorted by ascending m/z of the coordinates.
+    */
+    void sweepExtract_(const OpenSwath::SpectrumAccessPtr input,
+        std::vector< OpenSwath::ChromatogramPtr >& output,
+        const std::vector<ExtractionCoordinates>& extraction_coordinates,
+        const std::vector<Size>& order, double mz_extraction_window, bool ppm);
+
   };
 
 }
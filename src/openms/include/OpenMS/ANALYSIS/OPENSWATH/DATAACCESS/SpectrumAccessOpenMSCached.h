@@ -44,8 +44,11 @@
 
 #include <fstream>
 
+#include <boost/shared_ptr.hpp>
+
 namespace OpenMS
 {
+  class MappedCachedmzML;
 
   /**
     @brief An implementation of the Spectrum Access interface using on-disk caching
@@ -54,10 +57,15 @@ namespace OpenMS
     (ISpectrumAccess) using the CachedmzML class which is able to read and
     write a cached mzML file.
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    If the cached file was written by MappedCachedmzML, the file is mapped
+    into memory and data items are read directly from the mapping. In this
+    case access is thread-safe and lightClone() shares the mapping.
+
+    @note For the stream based format (CachedmzML), this implementation is
+    @a not thread-safe since it keeps internally a single file access pointer
+    which it moves when accessing a specific data item. The caller is
+    responsible to ensure that access is performed atomically (or uses
+    lightClone() to obtain one copy per thread).
 
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
@@ -125,6 +133,9 @@ private:
     /// Indices
     std::vector<std::streampos> spectra_index_;
     std::vector<std::streampos> chrom_index_;
+
+    /// Memory-mapped cache file (only set if the cache is in the mapped format)
+    boost::shared_ptr<const MappedCachedmzML> mapped_cache_;
   };
 
 } //end namespace
@@ -46,6 +46,8 @@
 
 namespace OpenMS
 {
+  class IsotopeDistributionTable;
+
   /**
     @brief Scoring of an spectrum at the peak apex of an chromatographic elution peak.
 
@@ -208,6 +210,9 @@ private:
     double dia_nr_isotopes_;
     double dia_nr_charges_;
     double peak_before_mono_max_ppm_diff_;
+
+    /// shared averagine table for peptides (fetched once in the constructor)
+    const IsotopeDistributionTable* averagine_table_;
   };
 }
 
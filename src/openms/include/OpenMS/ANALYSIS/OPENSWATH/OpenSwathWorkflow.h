@@ -226,6 +226,57 @@ namespace OpenMS
                            int batchSize,
                            bool load_into_memory);
 
+    /** @brief Execute OpenSWATH analysis as a pipeline over all SWATH maps
+     *
+     * Produces the same output as performExtraction but, instead of assigning
+     * one SWATH map to each thread, splits the work into three kinds of
+     * jobs which are scheduled across all threads:
+     *
+     * 1. Load a SWATH map (optionally into memory) and select its transitions
+     * 2. Extract the chromatograms for one batch of a loaded SWATH map
+     * 3. Score the chromatograms of one extracted batch
+     *
+     * Scoring jobs are preferred over extraction jobs, which in turn are
+     * preferred over loading new maps. Thus I/O of the next map overlaps with
+     * extraction and scoring of the current maps while the memory footprint
+     * stays bounded: at most @p max_loaded_maps SWATH maps are held at any
+     * time and at most @p max_pending_batches extracted batches wait for
+     * scoring. A SWATH map is released as soon as all of its batches have been
+     * scored. Features, chromatograms and TSV lines are collected per thread
+     * and handed to the (shared) output in bulk.
+     *
+     * @note Features and chromatograms may be written in a different order
+     * than with performExtraction.
+     *
+     * @param swath_maps The raw data (swath maps)
+     * @param trafo Transformation description (translating this runs' RT to normalized RT space)
+     * @param cp Parameter set for the chromatogram extraction
+     * @param feature_finder_param Parameter set for the feature finding in chromatographic dimension
+     * @param transition_exp The set of assays to be extracted and scored
+     * @param out_featureFile Output feature map to store identified features
+     * @param store_features Whether features should be appended to the output feature map
+     * @param tsv_writer TSV Writer object to store identified features in csv format
+     * @param chromConsumer Chromatogram consumer object to store the extracted chromatograms
+     * @param batchSize Size of the batches which should be extracted and scored
+     * @param load_into_memory Whether to cache the SWATH maps in memory
+     * @param max_loaded_maps Maximal number of SWATH maps held at the same time (at least 1)
+     * @param max_pending_batches Maximal number of extracted batches waiting for scoring (at least 1)
+     *
+    */
+    void performExtractionPipelined(const std::vector< OpenSwath::SwathMap > & swath_maps,
+                                    const TransformationDescription trafo,
+                                    const ChromExtractParams & cp,
+                                    const Param & feature_finder_param,
+                                    const OpenSwath::LightTargetedExperiment& transition_exp,
+                                    FeatureMap& out_featureFile,
+                                    bool store_features,
+                                    OpenSwathTSVWriter & tsv_writer,
+                                    Interfaces::IMSDataConsumer * chromConsumer,
+                                    int batchSize,
+                                    bool load_into_memory,
+                                    Size max_loaded_maps,
+                                    Size max_pending_batches);
+
   protected:
 
 
@@ -238,6 +289,17 @@ namespace OpenMS
                                     bool store_features,
                                     Interfaces::IMSDataConsumer * chromConsumer);
 
+    /** @brief Write out and clear the thread-local output of the pipelined workflow
+     *
+    */
+    void flushPipelineSinks_(std::vector< OpenMS::MSChromatogram<> > & chromatograms,
+                             FeatureMap& features,
+                             std::vector<String>& tsv_lines,
+                             FeatureMap& out_featureFile,
+                             bool store_features,
+                             OpenSwathTSVWriter & tsv_writer,
+                             Interfaces::IMSDataConsumer * chromConsumer);
+
     /** @brief Perform MS1 extraction and store result in ms1_chromatograms
      *
     */
@@ -275,6 +337,24 @@ namespace OpenMS
         const double rt_extraction_window,
         FeatureMap& output, OpenSwathTSVWriter & tsv_writer);
 
+    /** @brief Perform scoring on a set of chromatograms, collecting TSV lines
+     *
+     * Same as scoreAllChromatograms but, instead of writing the TSV output
+     * directly, appends the prepared lines to @p tsv_lines (only if the
+     * @p tsv_writer is active). The caller is responsible for writing them.
+     *
+    */
+    void scoreAllChromatograms_(
+        const OpenSwath::SpectrumAccessPtr input,
+        const std::map< std::string, OpenSwath::ChromatogramPtr > & ms1_chromatograms,
+        const std::vector< OpenSwath::SwathMap > swath_maps,
+        OpenSwath::LightTargetedExperiment& transition_exp,
+        const Param& feature_finder_param,
+        TransformationDescription trafo,
+        const double rt_extraction_window,
+        FeatureMap& output, OpenSwathTSVWriter & tsv_writer,
+        std::vector<String>& tsv_lines);
+
 
     /** @brief Select which compounds to analyze in the next batch (and copy to output)
      *
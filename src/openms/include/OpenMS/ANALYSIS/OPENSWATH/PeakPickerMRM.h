@@ -40,6 +40,7 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/KERNEL/ChromatogramPeak.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
 
 #ifdef WITH_CRAWDAD
 #include <CrawdadWrapper.h>
@@ -150,6 +151,9 @@ protected:
     /// Temporary vector to hold the peak right widths
     std::vector<int> right_width_;
 
+    /// Signal to noise estimator, configured once and reused for all chromatograms
+    SignalToNoiseEstimatorMedian<MSChromatogram<> > snt_;
+
   };
 }
 
@@ -36,6 +36,7 @@
 #define OPENMS_ANALYSIS_QUANTITATION_KDTREEDATA_H
 
 #include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/KERNEL/Feature.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
@@ -72,6 +73,16 @@ public:
     addMaps(maps);
   }
 
+  /// Constructor (only the features of @p maps listed in @p feature_indices are added, see addMaps())
+  template <typename MapType>
+  KDTreeFeatureMaps(const std::vector<MapType>& maps, const std::vector<std::vector<Size> >& feature_indices, const Param& param) :
+    DefaultParamHandler("KDTreeFeatureMaps")
+  {
+    check_defaults_ = false;
+    setParameters(param);
+    addMaps(maps, feature_indices);
+  }
+
   /// Destructor
   ~KDTreeFeatureMaps()
   {
@@ -94,6 +105,35 @@ public:
     optimizeTree();
   }
 
+  /**
+    @brief Add a subset of the features of @p maps and balance kd-tree
+
+    @p feature_indices holds one list of feature indices per map. Features are
+    referenced, not copied, so @p maps must outlive this object.
+
+    @exception Exception::InvalidSize is thrown if @p feature_indices does not hold one list per map
+  */
+  template <typename MapType>
+  void addMaps(const std::vector<MapType>& maps, const std::vector<std::vector<Size> >& feature_indices)
+  {
+    if (feature_indices.size() != maps.size())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, feature_indices.size());
+    }
+    num_maps_ = maps.size();
+
+    for (Size i = 0; i < num_maps_; ++i)
+    {
+      const MapType& m = maps[i];
+      const std::vector<Size>& indices = feature_indices[i];
+      for (std::vector<Size>::const_iterator it = indices.begin(); it != indices.end(); ++it)
+      {
+        addFeature(i, &(m[*it]));
+      }
+    }
+    optimizeTree();
+  }
+
   /// Add feature
   void addFeature(Size mt_map_index, const BaseFeature* feature);
 
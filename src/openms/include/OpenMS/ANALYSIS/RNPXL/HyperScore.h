@@ -36,6 +36,7 @@
 #define OPENMS_ANALYSIS_RNPXL_HYPERSCORE_H
 
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/CONCEPT/Macros.h>
 #include <vector>
@@ -62,6 +63,23 @@ struct OPENMS_DLLAPI HyperScore
    */
   static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const RichPeakSpectrum& theo_spectrum);
 
+  /* @brief compute the (ln transformed) X!Tandem HyperScore for a theoretical spectrum given as flat arrays
+   * @note All theoretical peaks have intensity 1.
+   * @param fragment_mass_tolerance mass tolerance applied left and right of the theoretical spectrum peak position
+   * @param fragment_mass_tolerance_unit_ppm Unit of the mass tolerance is: Thomson if false, ppm if true
+   * @param exp_spectrum measured spectrum
+   * @param theo_mz m/z values of the theoretical peaks (see TheoreticalSpectrumGenerator::getIonMZs())
+   * @param theo_annotations ion annotations of the theoretical peaks (same size as @p theo_mz)
+   */
+  static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const std::vector<double>& theo_mz, const std::vector<TheoreticalSpectrumGenerator::IonAnnotation>& theo_annotations);
+
+  /* @brief compute the (ln transformed) X!Tandem HyperScore from already matched peaks (e.g. using a fragment ion index)
+   * @param dot_product sum of the products of experimental and theoretical intensities of all matching peaks
+   * @param y_ion_count number of matching y-ions
+   * @param b_ion_count number of matching b-ions
+   */
+  static double computeFromMatches(double dot_product, UInt y_ion_count, UInt b_ion_count);
+
   private:
     // helper to compute the log factorial
     static double logfactorial_(UInt x);
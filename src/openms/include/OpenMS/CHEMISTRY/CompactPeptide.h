@@ -0,0 +1,295 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_CHEMISTRY_COMPACTPEPTIDE_H
+#define OPENMS_CHEMISTRY_COMPACTPEPTIDE_H
+
+#include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <map>
+#include <vector>
+
+namespace OpenMS
+{
+  class AASequence;
+  class Element;
+  class ResidueModification;
+
+  /**
+    @brief Compact peptide representation for fast mass and formula calculations
+
+    A CompactPeptide stores a peptide as one byte per residue plus one byte per
+    terminal modification. The codes refer to an Alphabet, which holds the
+    precomputed internal mono and average weights and the elemental composition
+    of every residue (incl. modifications) and terminal modification, as well as
+    the weights of the terminal groups of all ion types.
+
+    Weights and formulas are computed by table lookups, without memory
+    allocation. The results are the same as the corresponding AASequence
+    methods, e.g. getMonoWeight() equals AASequence::getMonoWeight() and
+    getPrefixMonoWeight() equals <tt>getPrefix(length).getMonoWeight()</tt>.
+
+    Unmodified sequences can also be encoded directly from their one-letter
+    codes (e.g. the StringView%s returned by EnzymaticDigestion), which avoids
+    constructing an AASequence. The letters are looked up in a table of the
+    alphabet, so the residues have to be added beforehand (see
+    Alphabet::addUnmodifiedResidues()).
+
+    The Alphabet grows while AASequence%s are encoded, so this must not happen
+    concurrently with other operations on a shared alphabet. Encoding strings
+    and all other (const) operations are thread-safe. A CompactPeptide must not
+    outlive its alphabet.
+
+    @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI CompactPeptide
+  {
+public:
+    /// Code of a residue or terminal modification
+    typedef unsigned char Code;
+
+    /**
+      @brief Residue and modification codes with precomputed weights and compositions
+
+      Holds at most 256 residues (incl. modified variants) and 255 terminal
+      modifications (code 0 means "unmodified").
+    */
+    class OPENMS_DLLAPI Alphabet
+    {
+public:
+      /// Default constructor
+      Alphabet();
+
+      /// Returns the code of @p residue (adds it, if necessary). @exception Exception::InvalidSize is thrown if the alphabet is full.
+      Code getResidueCode(const Residue& residue);
+
+      /**
+        @brief Adds all unmodified residues of ResidueDB that have a one-letter code
+
+        Afterwards, all unmodified sequences that AASequence::fromString() accepts without modifications can be encoded from strings.
+      */
+      void addUnmodifiedResidues();
+
+      /// Returns the code of the unmodified residue with one-letter code @p one_letter_code. @exception Exception::InvalidValue is thrown if the residue is not in the alphabet.
+      Code getResidueCode(char one_letter_code) const
+      {
+        Int code = one_letter_codes_[(unsigned char)one_letter_code];
+        if (code < 0)
+        {
+          throwUnknownResidue_(one_letter_code);
+        }
+        return Code(code);
+      }
+
+      /// Returns the code of the terminal modification @p mod (adds it, if necessary; 0 for no modification). @exception Exception::InvalidSize is thrown if the alphabet is full.
+      Code getModificationCode(const ResidueModification* mod);
+
+      /// Returns the residue with code @p code
+      const Residue& getResidue(Code code) const;
+
+      /// Returns the modification with code @p code (0 for code 0)
+      const ResidueModification* getModification(Code code) const;
+
+      /// Returns the number of residue codes
+      Size size() const;
+
+      /// Returns the elements, in the order used for compositions (see CompactPeptide::getComposition())
+      const std::vector<const Element*>& getElements() const;
+
+      /// Returns the internal monoisotopic weight of residue @p code
+      double getResidueMonoWeight(Code code) const
+      {
+        return residue_mono_[code];
+      }
+
+      /// Returns the internal average weight of residue @p code
+      double getResidueAverageWeight(Code code) const
+      {
+        return residue_average_[code];
+      }
+
+      /// Returns the monoisotopic weight difference of terminal modification @p code
+      double getModificationMonoWeight(Code code) const
+      {
+        return mod_mono_[code];
+      }
+
+      /// Returns the average weight difference of terminal modification @p code
+      double getModificationAverageWeight(Code code) const
+      {
+        return mod_average_[code];
+      }
+
+      /// Returns the monoisotopic weight of the terminal groups of ion type @p type (0 for Residue::Internal)
+      double getTypeMonoWeight(Residue::ResidueType type) const;
+
+      /// Returns the average weight of the terminal groups of ion type @p type (0 for Residue::Internal)
+      double getTypeAverageWeight(Residue::ResidueType type) const;
+
+protected:
+      friend class CompactPeptide;
+
+      /// (element index, count) pairs of all compositions
+      typedef std::vector<std::pair<Size, SignedSize> > CompositionStore;
+
+      /// throws Exception::InvalidValue for a one-letter code that is not in the alphabet
+      static void throwUnknownResidue_(char one_letter_code);
+
+      /// appends @p formula to the composition store and its begin/end positions to @p bounds
+      void addComposition_(const EmpiricalFormula& formula, std::vector<Size>& bounds);
+
+      /// adds the composition with index @p index (see residue_composition_ etc.) to @p composition
+      void addToComposition_(const std::vector<Size>& bounds, Size index, std::vector<SignedSize>& composition, SignedSize factor = 1) const;
+
+      std::vector<const Residue*> residues_;
+      std::map<const Residue*, Code> residue_codes_;
+      /// codes of the unmodified residues by one-letter code (-1 if not in the alphabet)
+      Int one_letter_codes_[256];
+      std::vector<double> residue_mono_;
+      std::vector<double> residue_average_;
+
+      std::vector<const ResidueModification*> mods_;
+      std::map<const ResidueModification*, Code> mod_codes_;
+      std::vector<double> mod_mono_;
+      std::vector<double> mod_average_;
+
+      /// weights of the terminal groups, indexed by Residue::ResidueType
+      std::vector<double> type_mono_;
+      std::vector<double> type_average_;
+
+      std::vector<const Element*> elements_;
+      std::map<const Element*, Size> element_index_;
+      CompositionStore compositions_;
+      /// composition bounds (begin of entry i is bounds[2 * i], end is bounds[2 * i + 1]) for residues, modifications and types
+      std::vector<Size> residue_composition_;
+      std::vector<Size> mod_composition_;
+      std::vector<Size> type_composition_;
+    };
+
+    /// Default constructor (empty peptide)
+    CompactPeptide();
+
+    /// Constructor that encodes @p sequence using @p alphabet
+    CompactPeptide(const AASequence& sequence, Alphabet& alphabet);
+
+    /**
+      @brief Constructor that encodes the unmodified sequence @p sequence (one-letter codes) using @p alphabet
+
+      @exception Exception::InvalidValue is thrown if a residue is not in the alphabet
+    */
+    CompactPeptide(const StringView& sequence, const Alphabet& alphabet);
+
+    /// Encodes @p sequence using @p alphabet (reuses the allocated memory)
+    void assign(const AASequence& sequence, Alphabet& alphabet);
+
+    /**
+      @brief Encodes the unmodified sequence @p sequence (one-letter codes) using @p alphabet (reuses the allocated memory)
+
+      The result equals the encoding of <tt>AASequence::fromString(sequence)</tt>.
+
+      @exception Exception::InvalidValue is thrown if a residue is not in the alphabet
+    */
+    void assign(const StringView& sequence, const Alphabet& alphabet);
+
+    /// Returns the number of residues
+    Size size() const;
+
+    /// Returns whether the peptide has no residues
+    bool empty() const;
+
+    /// Returns the residue codes
+    const std::vector<Code>& getResidueCodes() const;
+
+    /// Returns the code of the N-terminal modification (0 if unmodified)
+    Code getNTerminalModificationCode() const;
+
+    /// Returns the code of the C-terminal modification (0 if unmodified)
+    Code getCTerminalModificationCode() const;
+
+    /// Returns the alphabet (0 for a default-constructed peptide)
+    const Alphabet* getAlphabet() const;
+
+    /// Returns the monoisotopic weight (as AASequence::getMonoWeight(); 0 for empty peptides)
+    double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /// Returns the average weight (as AASequence::getAverageWeight(); 0 for empty peptides)
+    double getAverageWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief Returns the monoisotopic weight of the prefix of length @p length (as <tt>AASequence::getPrefix(length).getMonoWeight(type, charge)</tt>)
+
+      @exception Exception::IndexOverflow is thrown if @p length is larger than the peptide
+    */
+    double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief Returns the monoisotopic weight of the suffix of length @p length (as <tt>AASequence::getSuffix(length).getMonoWeight(type, charge)</tt>)
+
+      @exception Exception::IndexOverflow is thrown if @p length is larger than the peptide
+    */
+    double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief Computes the elemental composition
+
+      @param composition Number of atoms per element, in the order of Alphabet::getElements() (resized and overwritten)
+      @param type Ion type (terminal groups)
+    */
+    void getComposition(std::vector<SignedSize>& composition, Residue::ResidueType type = Residue::Full) const;
+
+    /// Returns the formula (as AASequence::getFormula())
+    EmpiricalFormula getFormula(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /// Equality operator (same codes and alphabet)
+    bool operator==(const CompactPeptide& rhs) const;
+
+    /// Inequality operator
+    bool operator!=(const CompactPeptide& rhs) const;
+
+protected:
+    /// returns the monoisotopic weight of residues [begin, end) with the given terminal modifications
+    double getMonoWeight_(Size begin, Size end, Code n_term_mod, Code c_term_mod, Residue::ResidueType type, Int charge) const;
+
+    std::vector<Code> residues_;
+    Code n_term_mod_;
+    Code c_term_mod_;
+    const Alphabet* alphabet_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_CHEMISTRY_COMPACTPEPTIDE_H
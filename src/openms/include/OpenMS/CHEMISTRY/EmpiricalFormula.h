@@ -166,6 +166,21 @@ public:
     */
     IsotopeDistribution getIsotopeDistribution(UInt max_depth) const;
 
+    /**
+      @brief returns the isotope distribution of the formula, computed by FFT
+
+      Same result as getIsotopeDistribution() (up to rounding errors, which
+      only affect probabilities far below the maximum), but all elements are
+      convolved at once in Fourier space. This is faster for large molecules
+      if many or all isotopes are requested; for a few isotopes,
+      getIsotopeDistribution() is faster. If @p max_depth cuts off almost the
+      whole distribution, getIsotopeDistribution() is used.
+
+      @param max_depth: the maximum isotope which is considered, if 0 all are reported
+      @exception Exception::InvalidValue is thrown if the formula contains negative element counts
+    */
+    IsotopeDistribution getIsotopeDistributionFFT(UInt max_depth) const;
+
     /**
       @brief returns the fragment isotope distribution of this given a precursor formula
       and conditioned on a set of isolated precursor isotopes.
@@ -0,0 +1,164 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_CHEMISTRY_ISOTOPEDISTRIBUTIONTABLE_H
+#define OPENMS_CHEMISTRY_ISOTOPEDISTRIBUTIONTABLE_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class Element;
+
+  /**
+    @brief Precomputed tables for fast averagine isotope distributions
+
+    IsotopeDistribution::estimateFromWeightAndComp() estimates an averagine
+    formula from the average weight and convolves the isotope distributions
+    of its elements from scratch on every call. This class stores, for every
+    element of the averagine model, the first isotopes of the distributions
+    of 0, 1, 2, ... atoms (up to the number needed for the maximal weight).
+    An estimate then only takes the rounded atom counts (computed exactly as
+    in EmpiricalFormula::estimateFromWeightAndComp()) and convolves the five
+    or six stored rows. The estimate() overload that writes the probabilities
+    into a std::vector does not allocate memory if the capacity of the vector
+    suffices; the IsotopeDistribution overload creates a new container.
+
+    Since the averagine formula changes in discrete steps (one atom at a
+    time), the table is indexed by atom counts instead of interpolating
+    between mass bins; the results therefore equal those of
+    IsotopeDistribution::estimateFromWeightAndComp() (up to rounding errors).
+    Requests the table cannot answer (more isotopes than stored, all
+    isotopes, or weights outside the table) are computed the conventional way.
+    The same applies if the isotope distribution of an element was changed
+    (see Element::setIsotopeDistribution()) after the table was built.
+
+    The table is immutable after construction, so it can be shared between
+    threads. Shared tables for the peptide, RNA and DNA averagine models are
+    available via getPeptideTable(), getRNATable() and getDNATable(). These
+    functions synchronize the construction of the tables, so fetch the
+    reference once and not in hot loops.
+
+    @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI IsotopeDistributionTable
+  {
+public:
+
+    /**
+      @brief Builds the table
+
+      @param max_isotope Number of isotopes stored per distribution
+      @param max_weight Largest average weight covered by the table
+      @param C, H, N, O, S, P Relative stoichiometry of the averagine model (see IsotopeDistribution::estimateFromWeightAndComp())
+    */
+    IsotopeDistributionTable(Size max_isotope, double max_weight, double C, double H, double N, double O, double S, double P);
+
+    /// Shared table for the peptide averagine model (see IsotopeDistribution::estimateFromPeptideWeight()), built on first use
+    static const IsotopeDistributionTable& getPeptideTable();
+
+    /// Shared table for the RNA averagine model (see IsotopeDistribution::estimateFromRNAWeight()), built on first use
+    static const IsotopeDistributionTable& getRNATable();
+
+    /// Shared table for the DNA averagine model (see IsotopeDistribution::estimateFromDNAWeight()), built on first use
+    static const IsotopeDistributionTable& getDNATable();
+
+    /// Number of isotopes stored per distribution
+    Size getMaxIsotope() const;
+
+    /// Largest average weight covered by the table
+    double getMaxWeight() const;
+
+    /**
+      @brief Estimates the isotope distribution for @p average_weight
+
+      Equivalent to IsotopeDistribution::estimateFromWeightAndComp() with
+      the composition of this table, using the maximal isotope set in
+      @p distribution. The container of @p distribution is replaced, use the
+      std::vector overload to avoid memory allocation.
+    */
+    void estimate(double average_weight, IsotopeDistribution& distribution) const;
+
+    /**
+      @brief Estimates the probabilities of the first @p max_isotope isotopes for @p average_weight
+
+      The result has the size of the distribution computed by
+      estimate(), i.e. it may be shorter than @p max_isotope for very light
+      molecules. @p probabilities is overwritten (no allocation if its capacity
+      suffices and the request is covered by the table).
+      Returns the nominal mass of the first isotope.
+    */
+    Size estimate(double average_weight, Size max_isotope, std::vector<double>& probabilities) const;
+
+protected:
+
+    /// Element of the averagine model
+    struct ElementRow_
+    {
+      const Element* element;
+      /// isotope distribution of the element when the table was built
+      IsotopeDistribution::ContainerType isotopes;
+      /// relative stoichiometry
+      double composition;
+      double average_weight;
+      /// nominal mass of the lightest isotope
+      Size nominal_mass;
+      /// number of isotopes of a single atom (without gaps)
+      Size width;
+      /// probabilities of the first max_isotope_ isotopes of n atoms, for n = 0 ... max_count
+      std::vector<double> powers;
+      Size max_count;
+    };
+
+    /// Computes the atom counts for @p average_weight (as EmpiricalFormula::estimateFromWeightAndComp())
+    void getCounts_(double average_weight, SignedSize* counts) const;
+
+    /// Computes the distribution without the table
+    Size estimateDirectly_(double average_weight, Size max_isotope, std::vector<double>& probabilities) const;
+
+    Size max_isotope_;
+    double max_weight_;
+    /// averagine composition C, N, O, S, P, H (hydrogens are added last to match the weight)
+    std::vector<ElementRow_> elements_;
+    /// sum of the average weights of the averagine composition
+    double average_total_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_CHEMISTRY_ISOTOPEDISTRIBUTIONTABLE_H
@@ -55,6 +55,25 @@ namespace OpenMS
   {
     public:
 
+    /**
+      @brief Compact annotation of a fragment ion peak
+
+      Alternative to the "IonName" meta value for getIonMZs(): ion series, ion
+      number and charge packed into 32 bits.
+    */
+    struct OPENMS_DLLAPI IonAnnotation
+    {
+      /// ion series (Residue::ResidueType, e.g. Residue::BIon)
+      UInt32 type : 8;
+      /// charge of the ion
+      UInt32 charge : 8;
+      /// ion number, e.g. 3 for b3
+      UInt32 index : 16;
+
+      /// returns the ion name as stored in the "IonName" meta value, e.g. "b3++"
+      String toString() const;
+    };
+
     /** @name Constructors and Destructors
     */
     //@{
@@ -86,6 +105,29 @@ namespace OpenMS
     /// Adds the common, most abundant immonium ions to the theoretical spectra if the residue is contained in the peptide sequence
     void addAbundantImmoniumIons(RichPeakSpectrum & spec, const AASequence& peptide) const;
 
+    /**
+      @brief Fast path: writes the m/z values of all fragment ions of the enabled series into a flat buffer
+
+      Generates the same monoisotopic a/b/c/x/y/z ion peaks as getSpectrum() (for charges 1 to @p charge,
+      respecting "add_first_prefix_ion"), but without RichPeak1D objects and meta values. Losses,
+      isotopes, precursor and immonium peaks are not generated, regardless of the parameters.
+
+      Residue masses are looked up once per peptide and the ion series are merged while they are
+      generated, so the output is sorted by m/z without a final sort. The buffers are cleared, but
+      keep their capacity; reusing them across calls avoids memory allocations.
+
+      @param mz Output m/z values (sorted ascending)
+      @param peptide The peptide
+      @param charge Maximal charge of the fragment ions
+      @param annotations Optional output: annotation of each entry of @p mz (same order)
+
+      @exception Exception::InvalidSize is thrown if c- or x-ions are requested for a peptide of length 1
+    */
+    void getIonMZs(std::vector<double> & mz, const AASequence & peptide, Int charge = 1, std::vector<IonAnnotation> * annotations = 0) const;
+
+    /// Fast path with single precision output, see the overload above
+    void getIonMZs(std::vector<float> & mz, const AASequence & peptide, Int charge = 1, std::vector<IonAnnotation> * annotations = 0) const;
+
     /// overwrite
     void updateMembers_();
 
@@ -104,6 +146,10 @@ namespace OpenMS
       /// helper to add full neutral loss ladders
       void addLosses_(RichPeakSpectrum & spectrum, const AASequence & ion, double intensity, Residue::ResidueType res_type, int charge) const;
 
+      /// implementation of getIonMZs() for single and double precision output
+      template <typename MZType>
+      void getIonMZs_(std::vector<MZType> & mz, const AASequence & peptide, Int charge, std::vector<IonAnnotation> * annotations) const;
+
       bool add_b_ions_;
       bool add_y_ions_; 
       bool add_a_ions_; 
@@ -4,6 +4,7 @@ set(directory include/OpenMS/CHEMISTRY)
 ### list all header files of the directory here
 set(sources_list_h
 AASequence.h
+CompactPeptide.h
 CrossLinksDB.h
 Element.h
 ElementDB.h
@@ -13,6 +14,7 @@ EnzymaticDigestion.h
 Enzyme.h
 EnzymesDB.h
 IsotopeDistribution.h
+IsotopeDistributionTable.h
 ModificationDefinition.h
 ModificationDefinitionsSet.h
 ModificationsDB.h
@@ -0,0 +1,106 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#ifndef OPENMS_CONCEPT_PARALLELSORT_H
+#define OPENMS_CONCEPT_PARALLELSORT_H
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  /**
+    @brief Sorts the range [@p begin, @p end) using all OpenMP threads
+
+    The range is split into one chunk per thread, each chunk is sorted with
+    std::sort and the sorted chunks are then merged pairwise with
+    std::inplace_merge. Without OpenMP this is a plain std::sort.
+
+    Like std::sort, the sort is not stable.
+
+    @param begin Start of the range
+    @param end End of the range
+    @param less Strict weak ordering (must be safe to call concurrently)
+    @param min_chunk_size Minimal number of elements per chunk, so small ranges are not split across threads
+  */
+  template <typename RandomAccessIterator, typename Compare>
+  void parallelSort(RandomAccessIterator begin, RandomAccessIterator end, Compare less, Size min_chunk_size = 1)
+  {
+    const Size size = end - begin;
+    Size nr_chunks = 1;
+#ifdef _OPENMP
+    nr_chunks = std::max(1, omp_get_max_threads());
+#endif
+    nr_chunks = std::max<Size>(1, std::min(nr_chunks, size / std::max<Size>(1, min_chunk_size)));
+    std::vector<Size> bounds(nr_chunks + 1);
+    for (Size i = 0; i <= nr_chunks; ++i)
+    {
+      bounds[i] = size * i / nr_chunks;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)nr_chunks; ++i)
+    {
+      std::sort(begin + bounds[i], begin + bounds[i + 1], less);
+    }
+
+    for (Size width = 1; width < nr_chunks; width *= 2)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)nr_chunks; i += 2 * width)
+      {
+        const Size middle = std::min<Size>(i + width, nr_chunks);
+        const Size stop = std::min<Size>(i + 2 * width, nr_chunks);
+        if (middle < stop)
+        {
+          std::inplace_merge(begin + bounds[i], begin + bounds[middle], begin + bounds[stop], less);
+        }
+      }
+    }
+  }
+
+} // namespace OpenMS
+
+#endif // OPENMS_CONCEPT_PARALLELSORT_H
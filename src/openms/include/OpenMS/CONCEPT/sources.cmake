@@ -15,6 +15,7 @@ Helpers.h
 LogConfigHandler.h
 LogStream.h
 Macros.h
+ParallelSort.h
 PrecisionWrapper.h
 ProgressLogger.h
 SingletonRegistry.h
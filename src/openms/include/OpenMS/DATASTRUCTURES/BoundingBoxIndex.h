@@ -0,0 +1,143 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_DATASTRUCTURES_BOUNDINGBOXINDEX_H
+#define OPENMS_DATASTRUCTURES_BOUNDINGBOXINDEX_H
+
+#include <OpenMS/DATASTRUCTURES/DBoundingBox.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Static R-tree over two-dimensional bounding boxes
+
+    The index is bulk-loaded from a list of boxes (e.g. RT/m/z bounding boxes
+    of features) using Sort-Tile-Recursive packing and cannot be modified
+    afterwards. Queries return the positions of the matching boxes in the
+    input list, in ascending order, so results do not depend on the internal
+    layout of the tree.
+
+    Invalid boxes (minimum larger than maximum in any dimension, e.g. a
+    default-constructed DBoundingBox) are never reported. Degenerate boxes
+    (points or lines) are valid.
+
+    Queries do not modify the index and can be run concurrently from several
+    threads.
+
+    @ingroup Datastructures
+  */
+  class OPENMS_DLLAPI BoundingBoxIndex
+  {
+public:
+    /// Box type
+    typedef DBoundingBox<2> BoxType;
+    /// Position type
+    typedef BoxType::PositionType PositionType;
+
+    /// Default constructor (empty index)
+    BoundingBoxIndex();
+
+    /// Constructor that builds the index from @p boxes
+    explicit BoundingBoxIndex(const std::vector<BoxType>& boxes);
+
+    /// Destructor
+    virtual ~BoundingBoxIndex();
+
+    /// (Re-)builds the index from @p boxes
+    void build(const std::vector<BoxType>& boxes);
+
+    /// Removes all boxes
+    void clear();
+
+    /// Returns the number of (valid) boxes in the index
+    Size size() const;
+
+    /// Returns whether the index contains no (valid) boxes
+    bool empty() const;
+
+    /// Returns the bounding box of all boxes in the index
+    const BoxType& getBoundingBox() const;
+
+    /**
+      @brief Finds all boxes that enclose @p position
+
+      @param position Query position
+      @param result Input indices of the matching boxes, in ascending order (cleared first)
+    */
+    void query(const PositionType& position, std::vector<Size>& result) const;
+
+    /**
+      @brief Finds all boxes that intersect @p box
+
+      @param box Query box
+      @param result Input indices of the matching boxes, in ascending order (cleared first)
+    */
+    void query(const BoxType& box, std::vector<Size>& result) const;
+
+protected:
+    /// Maximum number of children of a node
+    static const Size fanout_ = 16;
+
+    /// Box together with its index in the input
+    struct Entry
+    {
+      BoxType box;
+      Size index;
+    };
+
+    /// Entries in leaf order
+    std::vector<Entry> entries_;
+
+    /**
+      @brief Node boxes, level by level
+
+      Node @em i of level 0 covers the entries <tt>[i * fanout_, (i + 1) * fanout_)</tt>,
+      node @em i of level @em k covers the nodes <tt>[i * fanout_, (i + 1) * fanout_)</tt>
+      of level @em k - 1. The last level holds only the root.
+    */
+    std::vector<std::vector<BoxType> > levels_;
+
+    /// Bounding box of all entries
+    BoxType bounding_box_;
+
+    /// Collects the indices of all entries intersecting @p box
+    void query_(const BoxType& box, std::vector<Size>& result) const;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_DATASTRUCTURES_BOUNDINGBOXINDEX_H
@@ -491,11 +491,24 @@ public:
     {
     }
 
+    // create view on @p size characters starting at @p begin
+    StringView(const char* begin, Size size) : begin_(begin), size_(size)
+    {
+    }
+
     // construct from other view
     StringView(const StringView & s) : begin_(s.begin_), size_(s.size_) 
     {
     }
 
+    /// assignment operator
+    StringView& operator=(const StringView & s)
+    {
+      begin_ = s.begin_;
+      size_ = s.size_;
+      return *this;
+    }
+
     /// less operator
     bool operator<(const StringView other) const
     {
@@ -533,6 +546,12 @@ public:
       return size_;
     }   
 
+    /// first character of the view (not null-terminated)
+    inline const char* data() const
+    {
+      return begin_;
+    }
+
     /// create String object from view
     inline String getString() const
     {
@@ -45,6 +45,7 @@
 
 namespace OpenMS
 {
+  class IsotopeDistributionTable;
 
   /**
     @brief Internal structure used in @ref FeatureFindingMetabo that keeps
@@ -249,8 +250,12 @@ private:
      * Compare the isotopic intensity distribution with the theoretical one
      * expected for peptides, using the averagine model. Compute the cosine
      * similarity between the two values.
+     *
+     * @p averagine_ratios is used as buffer for the theoretical distribution
+     * (reused between calls to avoid memory allocation).
     */
-    double computeAveragineSimScore_(const std::vector<double>& intensities, const double& molecular_weight) const;
+    double computeAveragineSimScore_(const std::vector<double>& intensities, const double& molecular_weight,
+                                     const IsotopeDistributionTable& averagine_table, std::vector<double>& averagine_ratios) const;
 
     /** @brief Identify groupings of mass traces based on a set of reasonable candidates
      *
@@ -259,8 +264,10 @@ private:
      * is assumed that candidates[0] is the monoisotopic trace.
      *
      * The resulting possible groupings are appended to output_hypotheses.
+     * The averagine_table is used for peptide isotope filtering.
     */
-    void findLocalFeatures_(const std::vector<const MassTrace*>& candidates, const double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const;
+    void findLocalFeatures_(const std::vector<const MassTrace*>& candidates, const double total_intensity,
+                            const IsotopeDistributionTable& averagine_table, std::vector<FeatureHypothesis>& output_hypotheses) const;
 
     /// SVM parameters
     svm_model* isotope_filt_svm_;
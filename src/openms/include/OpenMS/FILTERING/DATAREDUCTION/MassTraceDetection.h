@@ -41,8 +41,11 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <boost/dynamic_bitset.hpp>
+
 namespace OpenMS
 {
+  class MassTraceDetectionConsumer;
 
   /**
     @brief A mass trace extraction method that gathers peaks similar in m/z and moving along retention time.
@@ -66,6 +69,18 @@ namespace OpenMS
     length as well as having the minimal sample rate criterion fulfilled) get
     added to the result.
 
+    Parallel mode: if the parameter @p mz_stripes is larger than one, the m/z
+    axis is partitioned into this number of stripes (containing similar
+    numbers of apex candidates). Each stripe is extended by a small overlap
+    (a few times the allowed mass deviation) and traces are detected in all
+    stripes in parallel. A trace found in a stripe is kept if its m/z search
+    window never left the (extended) stripe and if it does not share peaks
+    with a trace of higher apex intensity found in a neighboring stripe.
+    All remaining apex candidates are processed serially afterwards on the
+    complete map. The result does not depend on the number of threads and
+    differs from the serial mode only for (rare) traces which compete for
+    peaks across a stripe border.
+
     @htmlinclude OpenMS_MassTraceDetection.parameters
 
     @ingroup Quantitation
@@ -102,15 +117,67 @@ protected:
     virtual void updateMembers_();
 
 private:
+    /// detects traces on a sliding window of streamed spectra with the same extension
+    friend class MassTraceDetectionConsumer;
+
+    /// Peaks above the noise threshold of all MS1 spectra (or of an m/z stripe), stored in contiguous arrays
+    struct PeakArrays
+    {
+      /// retention time of each spectrum
+      std::vector<double> rt;
+      /// index of the first peak of each spectrum (plus the total number of peaks)
+      std::vector<Size> spec_offsets;
+      /// number of peaks of each spectrum in the complete map (for stripes)
+      std::vector<Size> full_spec_size;
+      std::vector<double> mz;
+      std::vector<float> intensity;
+      /// peak FWHM meta values (empty if not available)
+      std::vector<float> fwhm;
+      /// index of each peak in the complete map (empty if this is the complete map)
+      std::vector<Size> global_idx;
+    };
+
+    /// Candidate for a chromatographic apex
+    struct Apex
+    {
+      float intensity;
+      Size scan_idx;
+      /// index of the peak in PeakArrays
+      Size peak_idx;
+    };
+
+    /// Accepted mass traces: peak indices (in RT order) of all traces in one contiguous buffer
+    struct TraceBuffer
+    {
+      /// rank of the apex of each trace (position in the list of apices sorted by intensity)
+      std::vector<Size> apex_rank;
+      /// index of the first peak of each trace in @p peaks (plus the total number of peaks)
+      std::vector<Size> offsets;
+      std::vector<Size> peaks;
+    };
+
+    /**
+      @brief Extends a mass trace from the apex peak @p apex_peak_idx of spectrum @p apex_scan_idx
+
+      @param peaks The peaks (complete map or m/z stripe)
+      @param peak_visited Peaks already assigned to a mass trace
+      @param trace Indices of the collected peaks (RT order)
+      @param mz_bounds Smallest and largest m/z of the search windows used during extension
+      @return true if the trace passes the length and quality criteria
+    */
+    bool extendTrace_(const PeakArrays& peaks, Size apex_scan_idx, Size apex_peak_idx,
+                      const boost::dynamic_bitset<>& peak_visited,
+                      std::vector<Size>& trace, std::pair<double, double>& mz_bounds);
+
+    /// Collects the peaks above the noise threshold and the apex candidates (sorted by decreasing intensity) of all MS1 spectra
+    void collectPeaks_(const PeakMap& input_exp, PeakArrays& peaks, std::vector<Apex>& apices) const;
 
-    typedef std::multimap<double, std::pair<Size, Size> > MapIdxSortedByInt;
+    /// Detects traces in the m/z stripes in parallel (accepted traces are marked in @p peak_visited, the processed apices in @p apex_resolved)
+    void runStripes_(const PeakArrays& peaks, const std::vector<Apex>& apices, Size nr_stripes,
+                     boost::dynamic_bitset<>& peak_visited, std::vector<char>& apex_resolved, TraceBuffer& traces);
 
-    /// The internal run method
-    void run_(const MapIdxSortedByInt& chrom_apices,
-              const Size peak_count, 
-              const PeakMap & work_exp,
-              const std::vector<Size>& spec_offsets,
-              std::vector<MassTrace> & found_masstraces);
+    /// Creates a MassTrace from the peak indices @p begin to @p end
+    MassTrace createMassTrace_(const PeakArrays& peaks, std::vector<Size>::const_iterator begin, std::vector<Size>::const_iterator end) const;
 
     // parameter stuff
     double mass_error_ppm_;
@@ -125,6 +192,7 @@ private:
     double max_trace_length_;
 
     bool reestimate_mt_sd_;
+    Size mz_stripes_;
   };
 }
 
@@ -0,0 +1,200 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FILTERING_DATAREDUCTION_MASSTRACEDETECTIONCONSUMER_H
+#define OPENMS_FILTERING_DATAREDUCTION_MASSTRACEDETECTIONCONSUMER_H
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/KERNEL/MassTrace.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Detects mass traces while spectra are streamed in (e.g. from MzMLFile::transform)
+
+    Uses the algorithm of @ref MassTraceDetection (apex-first extension, same
+    parameters except @p mz_stripes) on a sliding retention time window
+    instead of the complete map, so memory does not grow with the length of
+    the run.
+
+    MS1 spectra are buffered (peaks above @p noise_threshold_int only). Once
+    the buffer spans three times @p window_length seconds, traces are
+    detected in it exactly like in @ref MassTraceDetection: apices are
+    processed in order of decreasing intensity and extended in both
+    directions of retention time. Traces which end more than
+    @p window_length seconds (and more than @p trace_termination_outliers
+    spectra) before the most recent spectrum are final: they are appended to
+    the output and their peaks are not used again. All other traces are
+    detected again with the next spectra, and spectra older than twice
+    @p window_length are dropped from the buffer (traces with an apex in
+    these spectra are final as well, i.e. longer traces are split). flush() processes the
+    remaining spectra and sorts all traces found by the consumer by
+    decreasing apex intensity (labels "T1", "T2", ...), as
+    @ref MassTraceDetection does.
+
+    The result is identical to @ref MassTraceDetection (serial mode) if
+    @p window_length covers the run. Otherwise it only differs for traces
+    which are longer than @p window_length or which compete for peaks with a
+    trace whose apex is more than @p window_length seconds away; such traces
+    may be truncated at the buffer start. @p window_length should therefore
+    be well above the expected width of a chromatographic peak.
+
+    Like @ref MassTraceDetection, the consumer expects centroided spectra:
+    profile spectra are rejected when the first MS1 spectrum is consumed
+    (see setAllowProfileData()). At least three MS1 spectra are required
+    (checked by flush()).
+
+    Usage:
+
+    @code
+    std::vector<MassTrace> traces;
+    MassTraceDetectionConsumer consumer(traces);
+    consumer.setParameters(mtd_param);
+    MzMLFile().transform(filename, &consumer);
+    consumer.flush(); // detect traces in the remaining spectra
+    @endcode
+
+    @note Spectra are expected in order of increasing retention time.
+    Spectra which are not sorted by m/z are sorted.
+
+    @htmlinclude OpenMS_MassTraceDetectionConsumer.parameters
+
+    @ingroup Quantitation
+  */
+  class OPENMS_DLLAPI MassTraceDetectionConsumer :
+    public Interfaces::IMSDataConsumer,
+    public DefaultParamHandler
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param found_masstraces Final mass traces are appended to this vector (needs to live as long as the consumer)
+    */
+    explicit MassTraceDetectionConsumer(std::vector<MassTrace>& found_masstraces);
+
+    /// Destructor (spectra which were not flushed are discarded)
+    virtual ~MassTraceDetectionConsumer();
+
+    /**
+      @brief Consume a spectrum (only MS1 spectra are used)
+
+      @exception Exception::IllegalArgument is thrown if the retention time is smaller than the one of the previous MS1 spectrum
+      @exception Exception::IllegalArgument is thrown if the first MS1 spectrum is profile data (unless allowed, see setAllowProfileData())
+      @exception Exception::Precondition is thrown if FWHM meta arrays are present for some MS1 spectra only
+    */
+    virtual void consumeSpectrum(SpectrumType& s);
+
+    /// Chromatograms are ignored
+    virtual void consumeChromatogram(ChromatogramType&) {}
+
+    virtual void setExpectedSize(Size, Size) {}
+
+    virtual void setExperimentalSettings(const ExperimentalSettings&) {}
+
+    /**
+      @brief Detects the traces in the buffered spectra and sorts all traces of the consumer by apex intensity (call after the last spectrum)
+
+      @exception Exception::InvalidValue is thrown if less than three MS1 spectra were consumed
+    */
+    void flush();
+
+    /// Accept profile spectra (SpectrumSettings::RAWDATA) as input (default: false)
+    void setAllowProfileData(bool allow);
+
+    /// Number of MS1 spectra currently buffered
+    Size getNrBufferedSpectra() const;
+
+protected:
+    virtual void updateMembers_();
+
+    /// Orders indices of apices by decreasing intensity (ties: later peak first, as in MassTraceDetection)
+    struct ApexOrder;
+
+    /**
+      @brief Detects traces in the buffered spectra and appends the final ones to the output
+
+      @param keep_rt Spectra before this retention time are dropped afterwards: traces with an apex before it are final, too
+    */
+    void detectTraces_(double keep_rt);
+
+    /// Removes the spectra before @p rt from the buffer
+    void dropSpectra_(double rt);
+
+    /// Clears the buffer (after flush())
+    void reset_();
+
+    std::vector<MassTrace>& found_masstraces_;
+    /// provides the trace extension and the creation of mass traces
+    MassTraceDetection mass_trace_detection_;
+
+    /// peaks of the buffered MS1 spectra
+    MassTraceDetection::PeakArrays peaks_;
+    /// buffered peaks which belong to a final trace
+    boost::dynamic_bitset<> peak_assigned_;
+    /// number of peaks dropped from the buffer (stream index of the first buffered peak)
+    Size dropped_peaks_;
+    /// apex of each final trace (peak_idx: stream index of the peak), for sorting by flush()
+    std::vector<MassTraceDetection::Apex> trace_apices_;
+    /// index of the first trace of this consumer in @p found_masstraces_
+    Size first_trace_;
+
+    /// number of MS1 spectra consumed and number of those with FWHM meta data
+    Size scan_count_;
+    Size fwhm_count_;
+    bool allow_profile_data_;
+
+    // parameter stuff
+    double noise_threshold_int_;
+    double chrom_peak_snr_;
+    Size trace_termination_outliers_;
+    double window_length_;
+
+private:
+    /// Not implemented
+    MassTraceDetectionConsumer();
+    MassTraceDetectionConsumer(const MassTraceDetectionConsumer&);
+    MassTraceDetectionConsumer& operator=(const MassTraceDetectionConsumer&);
+  };
+}
+
+#endif // OPENMS_FILTERING_DATAREDUCTION_MASSTRACEDETECTIONCONSUMER_H
@@ -298,7 +298,7 @@ protected:
 
       // index of bin where the median is located
       int median_bin = 0;
-      // additive number of elements from left to x in histogram
+      // number of elements in bins 0..median_bin (kept up to date while the window slides)
       int element_inc_count = 0;
 
       // tracks elements in current window, which may vary because of unevenly spaced data
@@ -330,6 +330,7 @@ protected:
         {
           to_bin = std::max(std::min<int>((int)((*window_pos_borderleft).getIntensity() / bin_size), bin_count_minus_1), 0);
           --histogram[to_bin];
+          if (to_bin <= median_bin) --element_inc_count;
           --elements_in_window;
           ++window_pos_borderleft;
         }
@@ -341,6 +342,7 @@ protected:
           //std::cerr << (*window_pos_borderright).getIntensity() << " " << bin_size << " " << bin_count_minus_1 << std::endl;
           to_bin = std::max(std::min<int>((int)((*window_pos_borderright).getIntensity() / bin_size), bin_count_minus_1), 0);
           ++histogram[to_bin];
+          if (to_bin <= median_bin) ++element_inc_count;
           ++elements_in_window;
           ++window_pos_borderright;
         }
@@ -352,15 +354,20 @@ protected:
         }
         else
         {
-          // find bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] }
-          median_bin = -1;
-          element_inc_count = 0;
+          // find the first bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] },
+          // starting from the median bin of the previous window (the median only moves a few bins
+          // per step, so this avoids scanning the whole histogram for every data point)
           element_in_window_half = (elements_in_window + 1) / 2;
           while (median_bin < bin_count_minus_1 && element_inc_count < element_in_window_half)
           {
             ++median_bin;
             element_inc_count += histogram[median_bin];
           }
+          while (median_bin > 0 && element_inc_count - histogram[median_bin] >= element_in_window_half)
+          {
+            element_inc_count -= histogram[median_bin];
+            --median_bin;
+          }
 
           // increase the error count
           if (median_bin == bin_count_minus_1) {++histogram_oob_percent_; }
@@ -369,8 +376,10 @@ protected:
           noise = std::max(1.0, bin_value[median_bin]);
         }
 
-        // store result
-        stn_estimates_[*window_pos_center] = (*window_pos_center).getIntensity() / noise;
+        // store result (data points arrive in ascending order, so insert at the end of the map)
+        typename std::map<PeakType, double, typename PeakType::PositionLess>::iterator stn_it =
+          stn_estimates_.insert(stn_estimates_.end(), std::make_pair(*window_pos_center, 0.0));
+        stn_it->second = (*window_pos_center).getIntensity() / noise;
 
 
         // advance the window center by one datapoint
@@ -149,6 +149,62 @@ public:
     */
     void decodeSingleString(const String & in, QByteArray & base64_uncompressed, bool zlib_compression);
 
+    /**
+        @brief Decodes Base64 data directly into a vector of numbers (fast path)
+
+        Gives the same result as decode() and decodeIntegers() (the element
+        type is determined by @p ToType), but works on a raw character
+        buffer and writes directly into the memory of @p out without any
+        intermediate String or QByteArray. On x86 CPUs supporting SSE4.1 or
+        AVX2 (detected at runtime, no special compiler flags are needed), the
+        Base64 characters are decoded with vector instructions, otherwise a
+        table driven scalar decoder is used.
+
+        In contrast to decode(), which does not validate its input and
+        silently produces garbage values for characters outside of the Base64
+        alphabet, decodeFast() checks every character and throws an
+        exception for invalid input.
+
+        Compressed data is inflated directly into @p out. The decoded (but
+        still compressed) bytes are kept in an internal buffer that is reused
+        across calls, therefore each thread should use its own Base64 object.
+
+        @param in Pointer to the Base64 encoded data (no whitespaces allowed)
+        @param in_length Number of characters in @p in
+        @param from_byte_order Byte order of the encoded data
+        @param out The decoded values
+        @param zlib_compression Whether the data is zlib-compressed
+
+        @exception Exception::ConversionError is thrown if the input contains invalid characters, has a length that is not a multiple of 4 or cannot be decompressed
+    */
+    template <typename ToType>
+    void decodeFast(const char * in, Size in_length, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression = false);
+
+    /// Convenience overload of decodeFast() taking a String
+    template <typename ToType>
+    void decodeFast(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression = false)
+    {
+      decodeFast(in.c_str(), in.size(), from_byte_order, out, zlib_compression);
+    }
+
+    /**
+        @brief Returns the number of bytes encoded by a Base64 string of length @p in_length
+
+        @exception Exception::ConversionError is thrown if the length is not a multiple of 4
+    */
+    static Size decodedSize(const char * in, Size in_length);
+
+    /**
+        @brief Decodes Base64 characters into raw bytes
+
+        @p out must provide space for at least decodedSize() bytes.
+
+        @return The number of bytes written to @p out
+
+        @exception Exception::ConversionError is thrown if the input contains invalid characters
+    */
+    static Size decodeRaw(const char * in, Size in_length, unsigned char * out);
+
 private:
 
     ///Internal class needed for type-punning
@@ -182,6 +238,13 @@ private:
     ///Decodes a compressed Base64 string to a vector of integer numbers
     template <typename ToType>
     void decodeIntegersCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
+
+    /// Inflates the zlib stream in @p in into @p out (resized as needed), returns the number of bytes written
+    template <typename ToType>
+    Size inflate_(const unsigned char * in, Size in_length, std::vector<ToType> & out);
+
+    /// Reusable buffer for the Base64-decoded (still compressed) data
+    std::vector<unsigned char> compressed_buffer_;
   };
 
   /// Endianizes a 32 bit type from big endian to little endian and vice versa
@@ -894,6 +957,124 @@ private:
     }
   }
 
+  template <typename ToType>
+  void Base64::decodeFast(const char * in, Size in_length, ByteOrder from_byte_order, std::vector<ToType> & out, bool zlib_compression)
+  {
+    out.clear();
+    if (in_length == 0) return;
+
+    const Size element_size = sizeof(ToType);
+    const Size byte_count = decodedSize(in, in_length);
+    Size written = 0;
+
+    if (zlib_compression)
+    {
+      compressed_buffer_.resize(byte_count);
+      if (byte_count == 0)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+      }
+      decodeRaw(in, in_length, &compressed_buffer_[0]);
+      written = inflate_(&compressed_buffer_[0], byte_count, out);
+    }
+    else
+    {
+      // same as decode(): padding characters count as zero bytes and
+      // surplus bytes that do not form a complete element are ignored
+      out.resize(in_length / 4 * 3 / element_size);
+      if (out.empty()) return;
+
+      unsigned char * dest = reinterpret_cast<unsigned char *>(&out[0]);
+      written = out.size() * element_size;
+      if (byte_count <= written)
+      {
+        decodeRaw(in, in_length, dest);
+        std::fill(dest + byte_count, dest + written, 0);
+      }
+      else
+      {
+        compressed_buffer_.resize(byte_count);
+        decodeRaw(in, in_length, &compressed_buffer_[0]);
+        std::copy(compressed_buffer_.begin(), compressed_buffer_.begin() + written, dest);
+      }
+    }
+
+    if (written == 0) return;
+
+    // change endianness if necessary
+    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
+    {
+      if (element_size == 4) // 32 bit
+      {
+        UInt32 * p = reinterpret_cast<UInt32 *>(&out[0]);
+        std::transform(p, p + out.size(), p, endianize32);
+      }
+      else // 64 bit
+      {
+        UInt64 * p = reinterpret_cast<UInt64 *>(&out[0]);
+        std::transform(p, p + out.size(), p, endianize64);
+      }
+    }
+  }
+
+  template <typename ToType>
+  Size Base64::inflate_(const unsigned char * in, Size in_length, std::vector<ToType> & out)
+  {
+    const Size element_size = sizeof(ToType);
+
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = const_cast<Bytef *>(in);
+    stream.avail_in = (uInt) in_length;
+    if (inflateInit(&stream) != Z_OK)
+    {
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
+
+    // peak data usually compresses by a factor of 2-4, start with a generous guess and grow if needed
+    out.resize(std::max<Size>(in_length * 4 / element_size, 64));
+
+    int zlib_error = Z_OK;
+    while (true)
+    {
+      Bytef * begin = reinterpret_cast<Bytef *>(&out[0]);
+      stream.next_out = begin + stream.total_out;
+      stream.avail_out = (uInt) (out.size() * element_size - stream.total_out);
+
+      zlib_error = inflate(&stream, Z_NO_FLUSH);
+      if (zlib_error == Z_STREAM_END) break;
+      if (zlib_error != Z_OK && zlib_error != Z_BUF_ERROR) break;
+      if (stream.avail_out == 0)
+      {
+        out.resize(out.size() * 2);
+      }
+      else if (stream.avail_in == 0)
+      {
+        // truncated input
+        zlib_error = Z_DATA_ERROR;
+        break;
+      }
+    }
+
+    Size written = stream.total_out;
+    inflateEnd(&stream);
+
+    if (zlib_error != Z_STREAM_END || written == 0)
+    {
+      out.clear();
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
+    if (written % element_size != 0)
+    {
+      out.clear();
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+    }
+    out.resize(written / element_size);
+    return written;
+  }
+
 } //namespace OpenMS
 
 #endif /* OPENMS_FORMAT_BASE64_H */
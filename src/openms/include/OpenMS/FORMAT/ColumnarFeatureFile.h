@@ -0,0 +1,296 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_COLUMNARFEATUREFILE_H
+#define OPENMS_FORMAT_COLUMNARFEATUREFILE_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/FileTypes.h>
+#include <OpenMS/FORMAT/OPTIONS/FeatureFileOptions.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace OpenMS
+{
+  class Feature;
+  class FeatureMap;
+  class ConsensusFeature;
+  class ConsensusMap;
+
+  /**
+    @brief Binary, column-oriented file format for feature and consensus maps
+
+    This is a compact companion format to featureXML and consensusXML
+    (file extensions featureBin and consensusBin) that stores the same
+    information, but is much faster to read and write. It is meant for
+    intermediate files of processing pipelines.
+
+    The numerical core of every (consensus) feature - position, intensity,
+    charge, quality, width and unique id - is stored column-wise in
+    contiguous arrays; for consensus maps the feature handles are stored
+    column-wise as well. Everything else is stored in side tables, which
+    contain one binary record per feature and an offset array for random
+    access:
+
+    - convex hulls (feature maps only)
+    - subordinate features (feature maps only)
+    - meta values
+    - peptide identifications
+
+    Document level information (identifier, unique id, meta values, protein
+    identifications, unassigned peptide identifications, data processing and,
+    for consensus maps, file descriptions and experiment type) is stored in
+    one more binary record.
+
+    The file is mapped into memory when an object is constructed. Columns
+    can then be accessed directly (e.g. getMZ()) without decoding anything,
+    and individual features can be decoded with getFeature() or
+    getConsensusFeature(); a side table is only touched when it is needed.
+    load() decodes the complete map, taking the options (convex hulls,
+    subordinates, meta data only, RT/m/z/intensity ranges) into account.
+    Ranges are evaluated on the columns, so features outside the ranges
+    are never decoded. Apart from the options, the object is immutable after
+    construction, hence all access functions may be used from multiple
+    threads concurrently.
+
+    The file layout (all values in native byte order) is:
+
+    - a header of one page (4096 bytes) containing the file identifier, the
+      format version and the kind of map stored
+    - the blocks (columns, side tables and the document record), each
+      starting on a 64 byte boundary
+    - the block directory: one BlockEntry per block
+    - the trailer: offset of the directory, number of blocks, number of
+      features and the file identifier
+
+    Side tables consist of two blocks: an array of (number of features + 1)
+    offsets and the concatenated records. Side tables without any content
+    are not written.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI ColumnarFeatureFile
+  {
+public:
+
+    /// Kind of map stored in a file
+    enum MapKind
+    {
+      FEATURE_MAP = 1,
+      CONSENSUS_MAP = 2
+    };
+
+    /// Identifiers of the blocks of a file
+    enum BlockId
+    {
+      RT,                 ///< retention times (double)
+      MZ,                 ///< m/z values (double)
+      INTENSITY,          ///< intensities (float)
+      CHARGE,             ///< charges (Int32)
+      QUALITY,            ///< overall qualities (float)
+      WIDTH,              ///< widths (float)
+      UNIQUE_ID,          ///< unique ids (UInt64)
+      QUALITY_RT,         ///< RT qualities (float, feature maps only)
+      QUALITY_MZ,         ///< m/z qualities (float, feature maps only)
+      HULL_OFFSETS,       ///< side table of convex hulls (feature maps only)
+      HULL_DATA,
+      SUBORDINATE_OFFSETS,///< side table of subordinate features (feature maps only)
+      SUBORDINATE_DATA,
+      META_OFFSETS,       ///< side table of meta values
+      META_DATA,
+      PEPTIDE_OFFSETS,    ///< side table of peptide identifications
+      PEPTIDE_DATA,
+      HANDLE_OFFSETS,     ///< index of the first handle of each consensus feature (UInt64, consensus maps only)
+      HANDLE_MAP_INDEX,   ///< map indices of the handles (UInt64)
+      HANDLE_UNIQUE_ID,   ///< unique ids of the handles (UInt64)
+      HANDLE_RT,          ///< retention times of the handles (double)
+      HANDLE_MZ,          ///< m/z values of the handles (double)
+      HANDLE_INTENSITY,   ///< intensities of the handles (float)
+      HANDLE_CHARGE,      ///< charges of the handles (Int32)
+      HANDLE_WIDTH,       ///< widths of the handles (float)
+      DOCUMENT,           ///< document level record
+      SIZE_OF_BLOCKID
+    };
+
+    /// File identifier stored at the beginning and at the end of the file
+    static const UInt64 FILE_IDENTIFIER;
+
+    /// Current version of the file format
+    static const UInt32 FILE_VERSION;
+
+    /// Size of the file header (one memory page)
+    static const Size HEADER_SIZE;
+
+    /// Alignment of the blocks in the file
+    static const Size DATA_ALIGNMENT;
+
+    /// Entry of the block directory stored at the end of the file
+    struct BlockEntry
+    {
+      /// block identifier (see BlockId)
+      UInt64 id;
+      /// offset of the block from the beginning of the file
+      UInt64 offset;
+      /// size of the block in bytes
+      UInt64 size;
+    };
+
+    /**
+      @brief Maps @p filename into memory and validates its block directory
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a valid columnar feature file
+    */
+    explicit ColumnarFeatureFile(const String& filename);
+
+    /// Destructor, unmaps the file
+    ~ColumnarFeatureFile();
+
+    /**
+      @brief Writes @p feature_map to @p filename
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    static void store(const String& filename, const FeatureMap& feature_map);
+
+    /**
+      @brief Writes @p consensus_map to @p filename
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    static void store(const String& filename, const ConsensusMap& consensus_map);
+
+    /// Returns FileTypes::FEATUREBIN or FileTypes::CONSENSUSBIN if @p filename starts with the header of this format, FileTypes::UNKNOWN otherwise
+    static FileTypes::Type getTypeByContent(const String& filename);
+
+    /// Kind of the stored map
+    MapKind getMapKind() const;
+
+    /// Number of (consensus) features in the file
+    Size size() const;
+
+    /// Returns true if the block @p id is present in the file
+    bool hasBlock(BlockId id) const;
+
+    ///@name Column access (the pointers are valid as long as this object exists)
+    //@{
+    /// Retention times of the (consensus) features
+    const double* getRT() const;
+    /// m/z values of the (consensus) features
+    const double* getMZ() const;
+    /// Intensities of the (consensus) features
+    const float* getIntensity() const;
+    /// Charges of the (consensus) features
+    const Int32* getCharge() const;
+    /// Overall qualities of the (consensus) features
+    const float* getQuality() const;
+    //@}
+
+    /**
+      @brief Decodes feature @p index (including its convex hulls and subordinates, if the options say so)
+
+      @exception Exception::ParseError is thrown if the file does not contain a feature map or a record is corrupt
+    */
+    void getFeature(Size index, Feature& feature) const;
+
+    /**
+      @brief Decodes consensus feature @p index
+
+      @exception Exception::ParseError is thrown if the file does not contain a consensus map or a record is corrupt
+    */
+    void getConsensusFeature(Size index, ConsensusFeature& feature) const;
+
+    /**
+      @brief Loads the complete feature map
+
+      @exception Exception::ParseError is thrown if the file does not contain a feature map or a record is corrupt
+    */
+    void load(FeatureMap& feature_map) const;
+
+    /**
+      @brief Loads the complete consensus map
+
+      @exception Exception::ParseError is thrown if the file does not contain a consensus map or a record is corrupt
+    */
+    void load(ConsensusMap& consensus_map) const;
+
+    /// Mutable access to the options for loading
+    FeatureFileOptions& getOptions();
+
+    /// Non-mutable access to the options for loading
+    const FeatureFileOptions& getOptions() const;
+
+    /// Name of the mapped file
+    const String& getFilename() const;
+
+private:
+
+    /// Not implemented (the mapping is not copyable)
+    ColumnarFeatureFile(const ColumnarFeatureFile& rhs);
+
+    /// Not implemented
+    ColumnarFeatureFile& operator=(const ColumnarFeatureFile& rhs);
+
+    /// Returns a typed pointer to the start of block @p id (0 if the block is not present)
+    template <typename T>
+    const T* block_(BlockId id) const
+    {
+      return reinterpret_cast<const T*>(blocks_[id]);
+    }
+
+    /// Returns the record of feature @p index in the side table @p offsets_id (begin and end)
+    bool record_(BlockId offsets_id, Size index, const char*& begin, const char*& end) const;
+
+    /// Throws if the file does not contain a map of kind @p kind
+    void checkMapKind_(MapKind kind) const;
+
+    /// Returns true if feature @p index is within the ranges of the options
+    bool inRanges_(Size index) const;
+
+    String filename_;
+    boost::iostreams::mapped_file_source file_;
+    MapKind map_kind_;
+    Size size_;
+    Size nr_handles_;
+    const char* blocks_[SIZE_OF_BLOCKID];
+    UInt64 block_sizes_[SIZE_OF_BLOCKID];
+    FeatureFileOptions options_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_FORMAT_COLUMNARFEATUREFILE_H
@@ -38,6 +38,7 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <iosfwd>
 #include <vector>
 
 namespace OpenMS
@@ -108,6 +109,9 @@ public:
     */
     void store(const String& filename, const std::vector<FASTAEntry>& data) const;
 
+    /// writes a single entry to @p os (in the format used by store(), e.g. for streaming output)
+    static void writeEntry(std::ostream& os, const FASTAEntry& entry);
+
   };
 
 } // namespace OpenMS
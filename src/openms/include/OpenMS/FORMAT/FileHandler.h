@@ -39,12 +39,14 @@
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
+#include <OpenMS/FORMAT/OPTIONS/FeatureFileOptions.h>
 
 namespace OpenMS
 {
   class PeakFileOptions;
   class MSExperiment;
   class FeatureMap;
+  class ConsensusMap;
 
   /**
     @brief Facilitates file handling by file type recognition.
@@ -95,6 +97,15 @@ public:
     /// set options for loading/storing
     void setOptions(const PeakFileOptions&);
 
+    /// Mutable access to the options for loading feature maps
+    FeatureFileOptions& getFeatOptions();
+
+    /// Non-mutable access to the options for loading feature maps
+    const FeatureFileOptions& getFeatOptions() const;
+
+    /// set options for loading feature maps
+    void setFeatOptions(const FeatureFileOptions&);
+
     /**
       @brief Loads a file into an MSExperiment
 
@@ -139,6 +150,44 @@ public:
     */
     bool loadFeatures(const String& filename, FeatureMap& map, FileTypes::Type force_type = FileTypes::UNKNOWN);
 
+    /**
+      @brief Stores a FeatureMap to a file
+
+      The file type to store the data in is determined by the file name. Supported formats for storing are featureXML and featureBin. If the file format cannot be determined from the file name, the featureXML format is used.
+
+      @param filename The name of the file to store the data in.
+      @param map The FeatureMap to store.
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    void storeFeatures(const String& filename, const FeatureMap& map);
+
+    /**
+      @brief Loads a file into a ConsensusMap
+
+      @param filename the file name of the file to load.
+      @param map The ConsensusMap to load the data into.
+      @param force_type Forces to load the file with that file type. If no type is forced, it is determined from the extension (or from the content if that fails).
+
+      @return true if the file could be loaded, false otherwise
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    bool loadConsensusFeatures(const String& filename, ConsensusMap& map, FileTypes::Type force_type = FileTypes::UNKNOWN);
+
+    /**
+      @brief Stores a ConsensusMap to a file
+
+      The file type to store the data in is determined by the file name. Supported formats for storing are consensusXML and consensusBin. If the file format cannot be determined from the file name, the consensusXML format is used.
+
+      @param filename The name of the file to store the data in.
+      @param map The ConsensusMap to store.
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    void storeConsensusFeatures(const String& filename, const ConsensusMap& map);
+
     /**
       @brief Computes a SHA-1 hash value for the content of the given file.
 
@@ -148,6 +197,7 @@ public:
 
 private:
     PeakFileOptions options_;
+    FeatureFileOptions feature_options_;
 
   };
 
@@ -102,6 +102,8 @@ namespace OpenMS
       MRM,                ///< SpectraST MRM List
       PSMS,               ///< Percolator tab-delimited output (PSM level)
       PARAMXML,           ///< internal format for writing and reading parameters (also used as part of CTD)
+      FEATUREBIN,         ///< OpenMS binary columnar feature map format (see ColumnarFeatureFile)
+      CONSENSUSBIN,       ///< OpenMS binary columnar consensus map format (see ColumnarFeatureFile)
       SIZE_OF_TYPE        ///< No file type. Simply stores the number of types
     };
 
@@ -0,0 +1,117 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_HANDLERS_MAPPEDFILEHELPER_H
+#define OPENMS_FORMAT_HANDLERS_MAPPEDFILEHELPER_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <fstream>
+
+namespace OpenMS
+{
+  namespace Internal
+  {
+    /**
+      @brief Common layout of the binary file formats that are read via memory mapping
+
+      All of these files (see MappedCachedmzML, ColumnarFeatureFile and
+      ProteinSuffixArrayIndex) consist of
+      - a header of one page (HEADER_SIZE bytes) that starts with a format specific structure,
+      - data sections that start at multiples of DATA_ALIGNMENT (or HEADER_SIZE),
+      - a trailer that ends with the file identifier, so that truncated files are detected.
+
+      The helper functions write this layout and check it when a file is mapped.
+      Data is stored in native byte order.
+    */
+    class OPENMS_DLLAPI MappedFileHelper
+    {
+public:
+      /// Size of the file header (one page)
+      static const Size HEADER_SIZE = 4096;
+
+      /// Alignment of the data sections in bytes (one cache line)
+      static const Size DATA_ALIGNMENT = 64;
+
+      /**
+        @brief Creates @p filename and writes the header
+
+        The @p header_size bytes of @p header are padded with zeros to HEADER_SIZE bytes.
+        @p pos is set to the stream position after the header.
+
+        @exception Exception::UnableToCreateFile is thrown if the file cannot be created
+      */
+      static void writeHeader(std::ofstream& ofs, UInt64& pos, const String& filename, const void* header, Size header_size);
+
+      /// Writes zero bytes until @p pos is a multiple of @p alignment (at most HEADER_SIZE)
+      static void pad(std::ofstream& ofs, UInt64& pos, Size alignment);
+
+      /**
+        @brief Writes the trailer followed by @p identifier and closes the file
+
+        @exception Exception::UnableToCreateFile is thrown if writing the file failed
+      */
+      static void writeTrailer(std::ofstream& ofs, const String& filename, UInt64 identifier, const void* trailer = 0, Size trailer_size = 0);
+
+      /**
+        @brief Reads the first @p header_size bytes of @p filename without mapping the file
+
+        @return false if the file cannot be read or is too short
+      */
+      static bool readHeader(const String& filename, void* header, Size header_size);
+
+      /**
+        @brief Maps @p filename read-only into memory
+
+        @exception Exception::FileNotFound is thrown if the file does not exist
+        @exception Exception::ParseError is thrown if the file cannot be mapped
+      */
+      static void mapFile(boost::iostreams::mapped_file_source& file, const String& filename);
+
+      /**
+        @brief Reads the trailer of a mapped file
+
+        Copies the @p trailer_size bytes in front of the file identifier to @p trailer.
+
+        @return false if the file is too short to hold the header and the trailer or does not end with @p identifier
+      */
+      static bool readTrailer(const boost::iostreams::mapped_file_source& file, UInt64 identifier, void* trailer = 0, Size trailer_size = 0);
+    };
+  }
+}
+
+#endif // OPENMS_FORMAT_HANDLERS_MAPPEDFILEHELPER_H
@@ -230,7 +230,8 @@ protected:
           @brief Fill a single spectrum with data from input
 
           @note Do not modify any internal state variables of the class since
-          this function will be executed in parallel.
+          this function will be executed in parallel. @p decoder must not be
+          shared between threads.
 
           Speed: this function takes about 50 % of total load time with a
           single thread and parallelizes linearly up to at least 10 threads.
@@ -238,18 +239,25 @@ protected:
       */
       void populateSpectraWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                     Size& default_arr_length, const PeakFileOptions& peak_file_options,
-                                    SpectrumType& spectrum);
+                                    SpectrumType& spectrum, Base64& decoder);
 
       /**
           @brief Fill a single chromatogram with data from input
 
           @note Do not modify any internal state variables of the class since
-          this function will be executed in parallel.
+          this function will be executed in parallel. @p decoder must not be
+          shared between threads.
 
       */
       void populateChromatogramsWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                           Size& default_arr_length, const PeakFileOptions& peak_file_options,
-                                          ChromatogramType& inp_chromatogram);
+                                          ChromatogramType& inp_chromatogram, Base64& decoder);
+
+      /// Makes sure there is one decoder per thread in thread_decoders_
+      void initThreadDecoders_();
+
+      /// Returns the decoder of the calling thread (initThreadDecoders_() must have been called)
+      Base64& threadDecoder_();
 
       template <typename DataType>
       void writeBinaryDataArray(std::ostream& os, const PeakFileOptions& pf_options_, std::vector<DataType> data_to_encode, bool is32bit, String array_type);
@@ -338,6 +346,9 @@ protected:
       /// Decoder/Encoder for Base64-data in MzML
       Base64 decoder_;
 
+      /// One decoder per thread for the parallel decoding of binary data (buffers are reused across spectra)
+      std::vector<Base64> thread_decoders_;
+
       /// Progress logger
       const ProgressLogger& logger_;
 
@@ -35,6 +35,7 @@
 #ifndef OPENMS_FORMAT_HANDLERS_MZMLHANDLERHELPER_H
 #define OPENMS_FORMAT_HANDLERS_MZMLHANDLERHELPER_H
 
+#include <OpenMS/FORMAT/Base64.h>
 #include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
 #include <OpenMS/FORMAT/MSNumpressCoder.h>
 #include <OpenMS/METADATA/MetaInfoDescription.h>
@@ -110,6 +111,19 @@ namespace OpenMS
       */
       static void decodeBase64Arrays(std::vector<BinaryData> & data_, bool skipXMLCheck = false);
 
+      /**
+        @brief Decode Base64 arrays and write into data_ array, using the given decoder
+
+        The internal buffers of @p decoder are reused, so repeated calls
+        (e.g. for all spectra of a file) avoid allocations. Since the
+        buffers are modified, each thread needs its own decoder.
+
+        @param data_ The input and output
+        @param skipXMLCheck whether to skip cleaning the Base64 arrays and remove whitespaces
+        @param decoder The Base64 decoder to use
+      */
+      static void decodeBase64Arrays(std::vector<BinaryData> & data_, bool skipXMLCheck, Base64 & decoder);
+
       static void computeDataProperties_(std::vector<BinaryData>& data_, bool& precision_64, SignedSize& index, String index_name);
 
       static bool handleBinaryDataArrayCVParam(std::vector<BinaryData>& data_,
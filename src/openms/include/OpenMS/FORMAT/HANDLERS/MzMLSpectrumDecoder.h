@@ -66,6 +66,9 @@ namespace OpenMS
   protected:
 
     bool skip_xml_checks_;
+
+    /// Base64 decoder (its buffers are reused for all spectra decoded by this object)
+    Base64 decoder_;
       
     typedef Internal::MzMLHandlerHelper::BinaryData BinaryData;
 
@@ -119,7 +122,8 @@ namespace OpenMS
   public:
 
     MzMLSpectrumDecoder() :
-      skip_xml_checks_(false)
+      skip_xml_checks_(false),
+      decoder_()
     {}
 
 
@@ -86,6 +86,32 @@ namespace OpenMS
       return exp.openFile(filename);
     }
 
+    /**
+      @brief Load an indexed mzML file completely into memory using multiple threads
+
+      The offsets stored in the <indexList> are used to split the spectra and
+      chromatograms into one contiguous range per thread (of similar size in
+      bytes). Every range is parsed concurrently (using OpenMP) in a single
+      pass as a complete mzML document made of the document header and the
+      elements of the range, so meta data and all binary data arrays
+      (including additional float, integer and string arrays such as ion
+      mobility) are read exactly as by MzMLFile::load. The results are merged
+      into @p exp in the order of the file.
+
+      The file is memory-mapped and each thread holds a copy of its range
+      while parsing. Loading only the meta data or the sizes does not profit
+      from the index and falls back to the sequential MzMLFile::load, as do
+      files whose index does not point to their spectra and chromatograms.
+
+      @param filename Filename determines where the file is located
+      @param exp Object which will contain the data after the call
+
+      @return Indicates whether parsing was successful (if it is false, the file most likely was not an mzML or not indexed).
+
+      @exception Exception::ParseError is thrown if a spectrum or chromatogram cannot be parsed
+    */
+    bool load(const String& filename, PeakMap& exp);
+
     /**
       @brief Store a file from an on-disc data-structure
 
@@ -0,0 +1,185 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_MAPPEDCACHEDMZML_H
+#define OPENMS_FORMAT_MAPPEDCACHEDMZML_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Memory-mapped, random access cached mzML format
+
+    In contrast to CachedmzML, which reads every data item through a file
+    stream, this class maps the complete cache file into memory and provides
+    light-weight views (pointers into the mapping) of the spectra and
+    chromatograms. After construction the object is immutable, therefore all
+    access functions can be called concurrently from multiple threads without
+    any locking and each access costs O(1).
+
+    The file layout (all values in native byte order) is:
+
+    - a header of one page (4096 bytes) containing the file identifier and
+      the format version
+    - the data section: for each spectrum its m/z and intensity arrays, for
+      each chromatogram its time and intensity arrays (doubles), each data
+      item starting on a 64 byte boundary
+    - the index: one IndexEntry per spectrum followed by one per chromatogram
+    - the trailer: offset of the index, number of spectra, number of
+      chromatograms and the file identifier
+
+    Like CachedmzML, only the binary data is stored; the meta data is stored
+    in a separate mzML file (see CachedmzML::writeMetadata).
+  */
+  class OPENMS_DLLAPI MappedCachedmzML
+  {
+public:
+
+    typedef PeakMap MapType;
+
+    /// File identifier stored at the beginning and at the end of the file
+    static const UInt64 FILE_IDENTIFIER;
+
+    /// Current version of the file format
+    static const UInt32 FILE_VERSION;
+
+    /// Size of the file header (one memory page)
+    static const Size HEADER_SIZE;
+
+    /// Alignment of the individual data items in the file
+    static const Size DATA_ALIGNMENT;
+
+    /// Entry of the index stored at the end of the file
+    struct IndexEntry
+    {
+      /// offset of the first array from the beginning of the file
+      UInt64 offset;
+      /// number of data points
+      UInt64 size;
+      /// retention time (spectra only)
+      double rt;
+      /// MS level (spectra only)
+      Int64 ms_level;
+    };
+
+    /// A non-owning view of a spectrum in the mapped file
+    struct SpectrumView
+    {
+      const double* mz;
+      const double* intensity;
+      Size size;
+      double rt;
+      int ms_level;
+    };
+
+    /// A non-owning view of a chromatogram in the mapped file
+    struct ChromatogramView
+    {
+      const double* rt;
+      const double* intensity;
+      Size size;
+    };
+
+    /**
+      @brief Maps @p filename into memory and validates its index
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a valid memory-mapped cache file
+    */
+    explicit MappedCachedmzML(const String& filename);
+
+    /// Destructor, unmaps the file
+    ~MappedCachedmzML();
+
+    /**
+      @brief Writes the binary data of all spectra and chromatograms of @p exp to @p filename
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    static void store(const String& filename, const MapType& exp);
+
+    /// Returns true if @p filename exists and starts with the identifier of this format
+    static bool isMappedCache(const String& filename);
+
+    /// Number of spectra in the file
+    Size getNrSpectra() const;
+
+    /// Number of chromatograms in the file
+    Size getNrChromatograms() const;
+
+    /// Returns a view of spectrum @p id (valid as long as this object exists)
+    SpectrumView getSpectrumView(Size id) const;
+
+    /// Returns a view of chromatogram @p id (valid as long as this object exists)
+    ChromatogramView getChromatogramView(Size id) const;
+
+    /**
+      @brief Copies the data of all spectra and chromatograms into @p exp
+
+      If @p exp already contains the meta data (the same number of spectra
+      and chromatograms as the file), only the peaks are replaced; otherwise
+      @p exp is cleared first.
+    */
+    void load(MapType& exp) const;
+
+    /// Name of the mapped file
+    const String& getFilename() const;
+
+private:
+
+    /// Not implemented (the mapping is not copyable, share the object instead)
+    MappedCachedmzML(const MappedCachedmzML& rhs);
+
+    /// Not implemented
+    MappedCachedmzML& operator=(const MappedCachedmzML& rhs);
+
+    String filename_;
+    boost::iostreams::mapped_file_source file_;
+    const char* data_;
+    const IndexEntry* spectra_index_;
+    const IndexEntry* chrom_index_;
+    Size nr_spectra_;
+    Size nr_chromatograms_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_FORMAT_MAPPEDCACHEDMZML_H
@@ -0,0 +1,192 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_FORMAT_MAPPEDFASTAFILE_H
+#define OPENMS_FORMAT_MAPPEDFASTAFILE_H
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Memory-mapped, streaming reader for FASTA files
+
+    In contrast to FASTAFile::load, which copies all entries into memory,
+    this class maps the file into memory and parses the entries on demand.
+    Identifiers and descriptions are returned as views (StringView) into the
+    mapping; sequences can span several lines and are therefore returned as
+    a raw view (including the line breaks) that can be copied into a reused
+    buffer with EntryView::getSequence(). Thus, iterating over a database of
+    any size needs constant memory.
+
+    Entries are read sequentially with a Reader. Optionally, the offsets of
+    all entries are indexed in one pass during construction, which allows
+    random access via size() and getEntryView(). After construction the
+    object is immutable, therefore all access functions can be called
+    concurrently, e.g. to process an indexed file in parallel:
+
+    @code
+    MappedFASTAFile fasta("db.fasta", true);
+    #pragma omp parallel for
+    for (SignedSize i = 0; i < (SignedSize)fasta.size(); ++i)
+    {
+      MappedFASTAFile::EntryView entry = fasta.getEntryView(i);
+      ...
+    }
+    @endcode
+
+    Entries are parsed like in FASTAFile::load: the header line is trimmed,
+    the identifier ends at the first whitespace and the rest of the line is
+    the description. All whitespace is removed from the sequence.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI MappedFASTAFile
+  {
+public:
+
+    /// A non-owning view of an entry in the mapped file (valid as long as the file object exists)
+    struct OPENMS_DLLAPI EntryView
+    {
+      StringView identifier;
+      StringView description;
+      /// the sequence lines as stored in the file (including line breaks)
+      StringView raw_sequence;
+
+      /// Copies the sequence (without whitespace) into @p sequence, reusing its memory
+      void getSequence(String& sequence) const;
+
+      /// Copies the entry into @p entry (as read by FASTAFile::load)
+      void getEntry(FASTAFile::FASTAEntry& entry) const;
+    };
+
+    /// Sequential reader for all entries of a mapped file
+    class OPENMS_DLLAPI Reader
+    {
+public:
+      /// Reader for the whole file
+      explicit Reader(const MappedFASTAFile& file);
+
+      /// Parses the next entry into @p entry; returns false if there are no more entries
+      bool next(EntryView& entry);
+
+private:
+      const MappedFASTAFile* file_;
+      Size position_;
+    };
+
+    /**
+      @brief Maps @p filename into memory
+
+      @param filename The FASTA file
+      @param build_index Index the offsets of all entries (required for size() and getEntryView())
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::FileNotReadable is thrown if the file cannot be read
+      @exception Exception::ParseError is thrown if the file cannot be mapped or does not start with an entry
+    */
+    explicit MappedFASTAFile(const String& filename, bool build_index = false);
+
+    /// Destructor, unmaps the file
+    ~MappedFASTAFile();
+
+    /// Name of the mapped file
+    const String& getFilename() const;
+
+    /// Size of the file in bytes
+    Size getFileSize() const;
+
+    /// Returns true if the offsets of the entries were indexed
+    bool hasIndex() const;
+
+    /**
+      @brief Number of entries in the file
+
+      @exception Exception::Precondition is thrown if the file was not indexed
+    */
+    Size size() const;
+
+    /**
+      @brief Offset of entry @p index in the file
+
+      @exception Exception::Precondition is thrown if the file was not indexed
+      @exception Exception::IndexOverflow is thrown if @p index is out of range
+    */
+    Size getEntryOffset(Size index) const;
+
+    /**
+      @brief Returns a view of entry @p index
+
+      @exception Exception::Precondition is thrown if the file was not indexed
+      @exception Exception::IndexOverflow is thrown if @p index is out of range
+    */
+    EntryView getEntryView(Size index) const;
+
+private:
+
+    /// Not implemented (the mapping is not copyable, share the object instead)
+    MappedFASTAFile(const MappedFASTAFile& rhs);
+
+    /// Not implemented
+    MappedFASTAFile& operator=(const MappedFASTAFile& rhs);
+
+    /// Returns the offset of the first entry starting at or after @p position (the file size if there is none)
+    Size nextEntry_(Size position) const;
+
+    /// Parses the entry starting at @p position into @p entry, returns the offset of the next entry
+    Size parseEntry_(Size position, EntryView& entry) const;
+
+    String filename_;
+    boost::iostreams::mapped_file_source file_;
+    const char* data_;
+    Size size_;
+    /// offset of the first entry (leading whitespace is skipped)
+    Size begin_;
+    /// entry offsets (only if indexed)
+    std::vector<Size> offsets_;
+    bool has_index_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_FORMAT_MAPPEDFASTAFILE_H
@@ -83,6 +83,18 @@ public:
     */
     void load(const String& filename, PeakMap& map);
 
+    /**
+      @brief Loads a map from an mzML document held in memory (uncompressed).
+
+      Behaves like load(), except that the loaded file path and type of @p map are not set.
+
+      @p buffer The complete mzML document
+      @p map Is an MSExperiment
+
+      @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void loadBuffer(const std::string& buffer, PeakMap& map);
+
     /**
       @brief Only count the number of spectra and chromatograms from a file
     */
@@ -159,6 +171,9 @@ protected:
     /// Safe parse that catches exceptions and handles them accordingly
     void safeParse_(const String & filename, Internal::XMLHandler * handler);
 
+    /// Safe parse of an in-memory document (see safeParse_)
+    void safeParseBuffer_(const std::string & buffer, Internal::XMLHandler * handler);
+
 private:
 
     /// Options for loading / storing
@@ -83,6 +83,15 @@ protected:
       */
       void parse_(const String & filename, XMLHandler * handler);
 
+      /**
+        @brief Parses the in-memory XML document given by @p buffer using the handler given by @p handler.
+
+        Only uncompressed documents are supported. Several buffers can be parsed concurrently (with different handlers).
+
+        @exception Exception::ParseError is thrown if an error occurred during the parsing
+      */
+      void parseBuffer_(const std::string & buffer, XMLHandler * handler);
+
       /**
         @brief Stores the contents of the XML handler given by @p handler in the file given by @p filename.
 
@@ -26,6 +26,7 @@ Base64.h
 Bzip2Ifstream.h
 Bzip2InputStream.h
 CachedMzML.h
+ColumnarFeatureFile.h
 CompressedInputSource.h
 CVMappingFile.h
 ConsensusXMLFile.h
@@ -52,6 +53,8 @@ LibSVMEncoder.h
 MS2File.h
 MSNumpressCoder.h
 MSPFile.h
+MappedCachedMzML.h
+MappedFASTAFile.h
 MascotInfile.h
 MascotGenericFile.h
 MascotRemoteQuery.h
@@ -0,0 +1,451 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#ifndef OPENMS_KERNEL_COLUMNARSPECTRUM_H
+#define OPENMS_KERNEL_COLUMNARSPECTRUM_H
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/Peak1D.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/DATAACCESS/DataStructures.h>
+
+#include <iterator>
+
+namespace OpenMS
+{
+  class MSExperiment;
+
+  /**
+    @brief A spectrum that stores its peaks as separate m/z and intensity columns.
+
+    In contrast to MSSpectrum, which stores an array of peaks (m/z and
+    intensity interleaved), this class keeps all m/z values and all
+    intensity values in two contiguous arrays. Algorithms that only scan the
+    m/z dimension (binary searches, range extraction) thus only touch the
+    m/z array, and the arrays can directly be handed to vectorized kernels
+    (see getMZData() and getIntensityData()).
+
+    The two columns are stored as OpenSwath::BinaryDataArrayPtr, so a
+    ColumnarSpectrum can be created from and converted to an
+    OpenSwath::SpectrumPtr without copying any peak data (the arrays are
+    shared). Copying a ColumnarSpectrum itself always performs a deep copy.
+
+    Peaks are accessed through lightweight proxy objects (PeakReference)
+    which offer the same getters and setters as Peak1D, so that generic code
+    written against the MSSpectrum iterator interface (e.g. @p it->getMZ())
+    also works on a ColumnarSpectrum. Float, String and Integer data arrays
+    as well as the spectrum meta data are handled as in MSSpectrum.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI ColumnarSpectrum :
+    public RangeManager<1>,
+    public SpectrumSettings
+  {
+public:
+
+    ///@name Base type definitions
+    //@{
+    /// Coordinate (m/z) type
+    typedef double CoordinateType;
+    /// Intensity type
+    typedef double IntensityType;
+    /// Float data array vector type
+    typedef MSSpectrum<Peak1D>::FloatDataArray FloatDataArray;
+    typedef MSSpectrum<Peak1D>::FloatDataArrays FloatDataArrays;
+    /// String data array vector type
+    typedef MSSpectrum<Peak1D>::StringDataArray StringDataArray;
+    typedef MSSpectrum<Peak1D>::StringDataArrays StringDataArrays;
+    /// Integer data array vector type
+    typedef MSSpectrum<Peak1D>::IntegerDataArray IntegerDataArray;
+    typedef MSSpectrum<Peak1D>::IntegerDataArrays IntegerDataArrays;
+    //@}
+
+    /**
+      @brief Proxy for a single peak of a ColumnarSpectrum
+
+      Offers the getters (and for non-const value types also the setters) of
+      Peak1D while pointing directly into the m/z and intensity columns.
+    */
+    template <typename ValueT>
+    class PeakReference
+    {
+public:
+      PeakReference() :
+        mz_(0),
+        intensity_(0)
+      {}
+
+      PeakReference(ValueT* mz, ValueT* intensity) :
+        mz_(mz),
+        intensity_(intensity)
+      {}
+
+      /// Conversion from mutable to non-mutable proxy
+      template <typename OtherT>
+      PeakReference(const PeakReference<OtherT>& rhs) :
+        mz_(rhs.mzPtr()),
+        intensity_(rhs.intensityPtr())
+      {}
+
+      inline CoordinateType getMZ() const { return *mz_; }
+      inline CoordinateType getPos() const { return *mz_; }
+      inline Peak1D::PositionType getPosition() const { return Peak1D::PositionType(*mz_); }
+      inline IntensityType getIntensity() const { return *intensity_; }
+
+      inline void setMZ(CoordinateType mz) const { *mz_ = mz; }
+      inline void setPos(CoordinateType mz) const { *mz_ = mz; }
+      inline void setIntensity(IntensityType intensity) const { *intensity_ = intensity; }
+
+      /// Returns a Peak1D with the same m/z and intensity
+      inline operator Peak1D() const
+      {
+        Peak1D p;
+        p.setMZ(*mz_);
+        p.setIntensity(*intensity_);
+        return p;
+      }
+
+      inline ValueT* mzPtr() const { return mz_; }
+      inline ValueT* intensityPtr() const { return intensity_; }
+
+protected:
+      ValueT* mz_;
+      ValueT* intensity_;
+    };
+
+    /**
+      @brief Random access iterator over the peaks of a ColumnarSpectrum
+
+      Dereferencing yields a PeakReference (by value), the arrow operator
+      gives access to the members of the referenced peak.
+    */
+    template <typename ValueT>
+    class PeakIterator
+    {
+public:
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef Peak1D value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef PeakReference<ValueT> reference;
+      typedef const PeakReference<ValueT>* pointer;
+
+      PeakIterator() :
+        ref_()
+      {}
+
+      PeakIterator(ValueT* mz, ValueT* intensity) :
+        ref_(mz, intensity)
+      {}
+
+      /// Conversion from mutable to non-mutable iterator
+      template <typename OtherT>
+      PeakIterator(const PeakIterator<OtherT>& rhs) :
+        ref_(rhs.operator*())
+      {}
+
+      inline reference operator*() const { return ref_; }
+      inline pointer operator->() const { return &ref_; }
+      inline reference operator[](difference_type n) const { return reference(ref_.mzPtr() + n, ref_.intensityPtr() + n); }
+
+      inline PeakIterator& operator++() { advance_(1); return *this; }
+      inline PeakIterator operator++(int) { PeakIterator tmp(*this); advance_(1); return tmp; }
+      inline PeakIterator& operator--() { advance_(-1); return *this; }
+      inline PeakIterator operator--(int) { PeakIterator tmp(*this); advance_(-1); return tmp; }
+      inline PeakIterator& operator+=(difference_type n) { advance_(n); return *this; }
+      inline PeakIterator& operator-=(difference_type n) { advance_(-n); return *this; }
+      inline PeakIterator operator+(difference_type n) const { PeakIterator tmp(*this); tmp.advance_(n); return tmp; }
+      inline PeakIterator operator-(difference_type n) const { PeakIterator tmp(*this); tmp.advance_(-n); return tmp; }
+      inline difference_type operator-(const PeakIterator& rhs) const { return ref_.mzPtr() - rhs.ref_.mzPtr(); }
+
+      inline bool operator==(const PeakIterator& rhs) const { return ref_.mzPtr() == rhs.ref_.mzPtr(); }
+      inline bool operator!=(const PeakIterator& rhs) const { return ref_.mzPtr() != rhs.ref_.mzPtr(); }
+      inline bool operator<(const PeakIterator& rhs) const { return ref_.mzPtr() < rhs.ref_.mzPtr(); }
+      inline bool operator>(const PeakIterator& rhs) const { return ref_.mzPtr() > rhs.ref_.mzPtr(); }
+      inline bool operator<=(const PeakIterator& rhs) const { return ref_.mzPtr() <= rhs.ref_.mzPtr(); }
+      inline bool operator>=(const PeakIterator& rhs) const { return ref_.mzPtr() >= rhs.ref_.mzPtr(); }
+
+protected:
+      inline void advance_(difference_type n)
+      {
+        ref_ = PeakReference<ValueT>(ref_.mzPtr() + n, ref_.intensityPtr() + n);
+      }
+
+      PeakReference<ValueT> ref_;
+    };
+
+    ///@name Peak container iterator type definitions
+    //@{
+    /// Mutable iterator
+    typedef PeakIterator<double> Iterator;
+    /// Non-mutable iterator
+    typedef PeakIterator<const double> ConstIterator;
+    typedef Iterator iterator;
+    typedef ConstIterator const_iterator;
+    typedef PeakReference<double> reference;
+    typedef PeakReference<const double> const_reference;
+    typedef Peak1D value_type;
+    typedef Size size_type;
+    //@}
+
+    /// Default constructor
+    ColumnarSpectrum();
+
+    /// Copy constructor (performs a deep copy of the peak data)
+    ColumnarSpectrum(const ColumnarSpectrum& source);
+
+    /// Constructor from an MSSpectrum (copies peaks, meta data and data arrays)
+    explicit ColumnarSpectrum(const MSSpectrum<Peak1D>& spectrum);
+
+    /**
+      @brief Constructor from an OpenSwath spectrum
+
+      The m/z and intensity arrays of @p sptr are shared, not copied.
+      Changes to the peak data are thus visible through @p sptr as well.
+
+      @exception Exception::IllegalArgument is thrown if @p sptr is a null pointer or the two arrays differ in length
+    */
+    explicit ColumnarSpectrum(const OpenSwath::SpectrumPtr& sptr);
+
+    /// Destructor
+    virtual ~ColumnarSpectrum();
+
+    /// Assignment operator (performs a deep copy of the peak data)
+    ColumnarSpectrum& operator=(const ColumnarSpectrum& source);
+
+    /// Equality operator
+    bool operator==(const ColumnarSpectrum& rhs) const;
+
+    /// Equality operator
+    bool operator!=(const ColumnarSpectrum& rhs) const;
+
+    // Docu in base class (RangeManager)
+    virtual void updateRanges();
+
+    ///@name Conversion
+    ///@{
+    /// Writes all peaks, meta data and data arrays to @p spectrum (existing peaks are replaced)
+    void toMSSpectrum(MSSpectrum<Peak1D>& spectrum) const;
+
+    /**
+      @brief Returns an OpenSwath spectrum that shares the m/z and intensity arrays of this spectrum
+
+      No peak data is copied. As long as the returned spectrum is alive, changes
+      to the peaks of this spectrum are visible through it (and vice versa).
+    */
+    OpenSwath::SpectrumPtr getSpectrumPtr() const;
+
+    /// Converts all spectra of @p exp, replacing the content of @p spectra
+    static void fromExperiment(const MSExperiment& exp, std::vector<ColumnarSpectrum>& spectra);
+
+    /// Replaces the spectra of @p exp by the content of @p spectra (experiment-level meta data is kept)
+    static void toExperiment(const std::vector<ColumnarSpectrum>& spectra, MSExperiment& exp);
+    ///@}
+
+    ///@name Peak data access
+    ///@{
+    /// Returns the number of peaks
+    inline Size size() const
+    {
+      return mz_array_->data.size();
+    }
+
+    /// Returns if the spectrum contains no peaks
+    inline bool empty() const
+    {
+      return mz_array_->data.empty();
+    }
+
+    /// Reserves space for @p n peaks
+    void reserve(Size n);
+
+    /// Resizes the spectrum to @p n peaks (new peaks have m/z and intensity 0)
+    void resize(Size n);
+
+    /// Appends a peak
+    void push_back(CoordinateType mz, IntensityType intensity);
+
+    /// Appends a peak
+    void push_back(const Peak1D& peak);
+
+    inline Iterator begin() { return Iterator(mzPtr_(), intensityPtr_()); }
+    inline Iterator end() { return begin() + size(); }
+    inline ConstIterator begin() const { return ConstIterator(mzPtr_(), intensityPtr_()); }
+    inline ConstIterator end() const { return begin() + size(); }
+
+    inline reference operator[](Size i) { return reference(mzPtr_() + i, intensityPtr_() + i); }
+    inline const_reference operator[](Size i) const { return const_reference(mzPtr_() + i, intensityPtr_() + i); }
+
+    /// Returns the contiguous m/z column
+    inline const std::vector<double>& getMZData() const
+    {
+      return mz_array_->data;
+    }
+
+    /// Returns the contiguous intensity column
+    inline const std::vector<double>& getIntensityData() const
+    {
+      return intensity_array_->data;
+    }
+
+    /// Returns the (shared) m/z array
+    inline OpenSwath::BinaryDataArrayPtr getMZArray() const
+    {
+      return mz_array_;
+    }
+
+    /// Returns the (shared) intensity array
+    inline OpenSwath::BinaryDataArrayPtr getIntensityArray() const
+    {
+      return intensity_array_;
+    }
+    ///@}
+
+    ///@name Accessors for meta information
+    ///@{
+    /// Returns the absolute retention time (in seconds)
+    inline double getRT() const { return retention_time_; }
+    /// Sets the absolute retention time (in seconds)
+    inline void setRT(double rt) { retention_time_ = rt; }
+    /// Returns the ion mobility drift time in milliseconds (-1 means it is not set)
+    inline double getDriftTime() const { return drift_time_; }
+    /// Sets the ion mobility drift time in milliseconds
+    inline void setDriftTime(double dt) { drift_time_ = dt; }
+    /// Returns the MS level
+    inline UInt getMSLevel() const { return ms_level_; }
+    /// Sets the MS level
+    inline void setMSLevel(UInt ms_level) { ms_level_ = ms_level; }
+    /// Returns the name
+    inline const String& getName() const { return name_; }
+    /// Sets the name
+    inline void setName(const String& name) { name_ = name; }
+    ///@}
+
+    ///@name Peak data array methods
+    ///@{
+    inline const FloatDataArrays& getFloatDataArrays() const { return float_data_arrays_; }
+    inline FloatDataArrays& getFloatDataArrays() { return float_data_arrays_; }
+    inline void setFloatDataArrays(const FloatDataArrays& fda) { float_data_arrays_ = fda; }
+    inline const StringDataArrays& getStringDataArrays() const { return string_data_arrays_; }
+    inline StringDataArrays& getStringDataArrays() { return string_data_arrays_; }
+    inline void setStringDataArrays(const StringDataArrays& sda) { string_data_arrays_ = sda; }
+    inline const IntegerDataArrays& getIntegerDataArrays() const { return integer_data_arrays_; }
+    inline IntegerDataArrays& getIntegerDataArrays() { return integer_data_arrays_; }
+    inline void setIntegerDataArrays(const IntegerDataArrays& ida) { integer_data_arrays_ = ida; }
+    ///@}
+
+    ///@name Sorting and searching
+    ///@{
+    /// Sorts the peaks by m/z. Meta data arrays will be sorted accordingly.
+    void sortByPosition();
+
+    /// Checks if all peaks are sorted with respect to ascending m/z
+    bool isSorted() const;
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z
+
+      @note Make sure the spectrum is sorted with respect to m/z! Otherwise the result is undefined.
+
+      @exception Exception::Precondition is thrown if the spectrum is empty (not only in debug mode)
+    */
+    Size findNearest(CoordinateType mz) const;
+
+    /**
+      @brief Binary search for the peak nearest to a specific m/z given a +/- tolerance windows in Th
+
+      @return Returns the index of the peak or -1 if no peak present in tolerance window or if spectrum is empty
+    */
+    Int findNearest(CoordinateType mz, CoordinateType tolerance) const;
+
+    /// Binary search for peak range begin (only the m/z column is accessed)
+    ConstIterator MZBegin(CoordinateType mz) const;
+
+    /// Binary search for peak range end (returns the past-the-end iterator, only the m/z column is accessed)
+    ConstIterator MZEnd(CoordinateType mz) const;
+
+    /// Binary search for peak range begin (only the m/z column is accessed)
+    Iterator MZBegin(CoordinateType mz);
+
+    /// Binary search for peak range end (returns the past-the-end iterator, only the m/z column is accessed)
+    Iterator MZEnd(CoordinateType mz);
+    ///@}
+
+    /**
+      @brief Clears all data and meta data
+
+      @param clear_meta_data If @em true, all meta data is cleared in addition to the data.
+    */
+    void clear(bool clear_meta_data);
+
+    /// Keeps only the peaks (and data array entries) at the given indices, in the given order
+    ColumnarSpectrum& select(const std::vector<Size>& indices);
+
+protected:
+
+    inline double* mzPtr_() { return mz_array_->data.empty() ? 0 : &mz_array_->data[0]; }
+    inline const double* mzPtr_() const { return mz_array_->data.empty() ? 0 : &mz_array_->data[0]; }
+    inline double* intensityPtr_() { return intensity_array_->data.empty() ? 0 : &intensity_array_->data[0]; }
+    inline const double* intensityPtr_() const { return intensity_array_->data.empty() ? 0 : &intensity_array_->data[0]; }
+
+    /// m/z column
+    OpenSwath::BinaryDataArrayPtr mz_array_;
+
+    /// intensity column
+    OpenSwath::BinaryDataArrayPtr intensity_array_;
+
+    /// Retention time
+    double retention_time_;
+
+    /// Drift time
+    double drift_time_;
+
+    /// MS level
+    UInt ms_level_;
+
+    /// Name
+    String name_;
+
+    /// Float data arrays
+    FloatDataArrays float_data_arrays_;
+
+    /// String data arrays
+    StringDataArrays string_data_arrays_;
+
+    /// Integer data arrays
+    IntegerDataArrays integer_data_arrays_;
+  };
+
+} // namespace OpenMS
+
+#endif // OPENMS_KERNEL_COLUMNARSPECTRUM_H
@@ -607,6 +607,35 @@ public:
       }
     }
 
+    /**
+      @brief Swaps the content of this chromatogram with the content of @p from
+
+      Peaks and data arrays are swapped without copying them.
+    */
+    void swap(MSChromatogram& from)
+    {
+      MSChromatogram tmp;
+
+      //swap range information
+      tmp.RangeManager<1>::operator=(*this);
+      this->RangeManager<1>::operator=(from);
+      from.RangeManager<1>::operator=(tmp);
+
+      //swap chromatogram settings
+      tmp.ChromatogramSettings::operator=(*this);
+      this->ChromatogramSettings::operator=(from);
+      from.ChromatogramSettings::operator=(tmp);
+
+      //swap peaks and data arrays
+      ContainerType::swap(from);
+      float_data_arrays_.swap(from.float_data_arrays_);
+      string_data_arrays_.swap(from.string_data_arrays_);
+      integer_data_arrays_.swap(from.integer_data_arrays_);
+
+      //swap remaining members
+      name_.swap(from.name_);
+    }
+
     ///@}
 
 protected:
@@ -708,6 +708,38 @@ public:
       }
     }
 
+    /**
+      @brief Swaps the content of this spectrum with the content of @p from
+
+      Peaks and data arrays are swapped without copying them.
+    */
+    void swap(MSSpectrum& from)
+    {
+      MSSpectrum tmp;
+
+      //swap range information
+      tmp.RangeManager<1>::operator=(*this);
+      this->RangeManager<1>::operator=(from);
+      from.RangeManager<1>::operator=(tmp);
+
+      //swap spectrum settings
+      tmp.SpectrumSettings::operator=(*this);
+      this->SpectrumSettings::operator=(from);
+      from.SpectrumSettings::operator=(tmp);
+
+      //swap peaks and data arrays
+      ContainerType::swap(from);
+      float_data_arrays_.swap(from.float_data_arrays_);
+      string_data_arrays_.swap(from.string_data_arrays_);
+      integer_data_arrays_.swap(from.integer_data_arrays_);
+
+      //swap remaining members
+      std::swap(retention_time_, from.retention_time_);
+      std::swap(drift_time_, from.drift_time_);
+      std::swap(ms_level_, from.ms_level_);
+      name_.swap(from.name_);
+    }
+
     /*
       @brief Select a (subset of) spectrum and its data_arrays, only retaining the indices given in @p indices
 
@@ -7,6 +7,7 @@ AreaIterator.h
 BaseFeature.h
 ChromatogramPeak.h
 ChromatogramTools.h
+ColumnarSpectrum.h
 ComparatorUtils.h
 ConsensusFeature.h
 ConversionHelper.h
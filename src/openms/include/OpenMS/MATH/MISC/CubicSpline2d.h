@@ -54,6 +54,10 @@ namespace OpenMS
     
     Construction of the spline takes by far the most time. Evaluating it is rather fast 
     (one evaluation is about 50x faster than construction -- depending on number of points etc.).
+
+    When many splines are fitted one after the other (e.g. one per peak), a single
+    object can be re-initialized with init(), which reuses the memory of the
+    coefficient vectors instead of allocating new ones for every spline.
    
    */
   class OPENMS_DLLAPI CubicSpline2d
@@ -67,6 +71,11 @@ namespace OpenMS
 
 public:
 
+    /**
+     * @brief default constructor: an empty spline, which needs to be initialized with init() before evaluation
+     */
+    CubicSpline2d();
+
     /**
      * @brief constructor of spline interpolation
      *
@@ -86,6 +95,18 @@ public:
      */
     CubicSpline2d(const std::map<double, double>& m);
 
+    /**
+     * @brief (re-)initializes the spline in place
+     *
+     * Same requirements as the constructor. The memory of the previous
+     * spline is reused, i.e. no allocation takes place if the new spline
+     * has at most as many knots as any spline this object held before.
+     *
+     * @param x x-coordinates of input data points (knots)
+     * @param y y-coordinates of input data points
+     */
+    void init(const std::vector<double>& x, const std::vector<double>& y);
+
     /**
      * @brief evaluates the spline at position x
      *
@@ -105,7 +126,7 @@ public:
 private:
 
     /**
-     * @brief initialize the spline
+     * @brief initialize the spline (input is not checked)
      *
      * @param x x-coordinates of input data points (knots)
      * @param y y-coordinates of input data points
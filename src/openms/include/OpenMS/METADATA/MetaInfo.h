@@ -41,6 +41,8 @@
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 #include <OpenMS/DATASTRUCTURES/DataValue.h>
 
+#include <boost/container/flat_map.hpp>
+
 namespace OpenMS
 {
   class String;
@@ -62,6 +64,17 @@ namespace OpenMS
       member. MetaInfoInterface implements a full interface to a MetaInfo
       member and is more memory efficient if no meta info gets added.
 
+      The values are stored in a flat map (a vector sorted by index). Objects
+      usually carry only a handful of meta values, for which a contiguous
+      array is both smaller and faster to search and copy than a node based
+      tree.
+
+      @note As in a vector, adding or removing values moves the stored
+      values. References returned by getValue() are therefore only valid
+      until the next call of setValue(), removeValue() or clear() on the
+      same object; copy the DataValue if it is needed longer. Passing such a
+      reference to setValue() of the same object is safe.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfo
@@ -120,10 +133,13 @@ public:
     void clear();
 
 private:
+    /// Container for the mapping of indexes to values (sorted by index)
+    typedef boost::container::flat_map<UInt, DataValue> MapType;
+
     /// Static MetaInfoRegistry
     static MetaInfoRegistry registry_;
     /// The actual mapping of indexes to values
-    std::map<UInt, DataValue> index_to_value_;
+    MapType index_to_value_;
 
   };
 
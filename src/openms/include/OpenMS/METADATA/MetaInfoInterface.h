@@ -72,9 +72,13 @@ public:
     /// Equality operator
     bool operator!=(const MetaInfoInterface& rhs) const;
 
-    /// Returns the value corresponding to a string (or DataValue::EMPTY if not found)
+    /**
+      @brief Returns the value corresponding to a string (or DataValue::EMPTY if not found)
+
+      @note The returned reference is only valid until meta values of this object are set, removed or cleared (see MetaInfo).
+    */
     const DataValue& getMetaValue(const String& name) const;
-    /// Returns the value corresponding to an index (or DataValue::EMPTY if not found)
+    /// Returns the value corresponding to an index (or DataValue::EMPTY if not found), see getMetaValue(const String&) const
     const DataValue& getMetaValue(UInt index) const;
 
     /// Returns whether an entry with the given name exists
@@ -37,6 +37,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/CONCEPT/Types.h>
@@ -69,6 +70,20 @@ namespace OpenMS
       12 - low_quality<BR>
       13 - charge<BR>
 
+      The registry is read-mostly: names are registered once and then looked
+      up many times, often from several threads at the same time (e.g. in
+      MetaInfoInterface::setMetaValue). Lookups of registered names and
+      indices (getIndex, getName and registerName for an existing name)
+      therefore do not take a lock. Registered (name, index) pairs are
+      immutable and kept in hash buckets with a fixed number of singly linked
+      lists; a new pair is prepended to its lists with an atomic store (with
+      release semantics) after it is fully constructed, and readers load the
+      list heads atomically (with acquire semantics). Nothing is moved or
+      freed before the registry is destroyed. Registering a new name as well
+      as access to descriptions and units is serialized.
+
+      Copying and assigning a registry is not thread-safe.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfoRegistry
@@ -160,12 +175,45 @@ public:
     String getUnit(const String& name) const;
 
 private:
+    /// A registered (name, index) pair, immutable once published
+    struct NameEntry
+    {
+      NameEntry(const String& n, UInt i) :
+        name(n), index(i), next_by_name(0), next_by_index(0)
+      {
+      }
+
+      String name;
+      UInt index;
+      /// next entry in the same bucket of by_name_
+      const NameEntry* next_by_name;
+      /// next entry in the same bucket of by_index_
+      const NameEntry* next_by_index;
+    };
+
+    /// number of buckets of the lookup tables (fixed, so they never have to be reallocated while being read)
+    static const Size NR_BUCKETS = 4096;
+
+    /// lock-free lookup of a name, returns 0 if not registered
+    const NameEntry* findName_(const String& name) const;
+
+    /// lock-free lookup of an index, returns 0 if not registered
+    const NameEntry* findIndex_(UInt index) const;
+
+    /// adds a new name (only call while holding the lock or during construction)
+    void addName_(const String& name, UInt index, const String& description, const String& unit);
+
+    /// frees all entries and empties the lookup tables
+    void clear_();
+
     /// internal counter, that stores the next index to assign
     UInt next_index_;
-    /// map from name to index
-    std::map<String, UInt> name_to_index_;
-    /// map from index to name
-    std::map<UInt, String> index_to_name_;
+    /// bucket lists of entries by name hash (list heads are only accessed atomically)
+    const NameEntry* by_name_[NR_BUCKETS];
+    /// bucket lists of entries by index (list heads are only accessed atomically)
+    const NameEntry* by_index_[NR_BUCKETS];
+    /// all registered entries (owned)
+    std::vector<NameEntry*> entries_;
     /// map from index to description
     std::map<UInt, String> index_to_description_;
     /// map from index to unit
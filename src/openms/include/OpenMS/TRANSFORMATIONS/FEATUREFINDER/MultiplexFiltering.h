@@ -50,6 +50,8 @@
 
 namespace OpenMS
 {
+  class IsotopeDistributionTable;
+
   /**
    * @brief base class for filtering centroided and profile data for peak patterns
    *
@@ -311,6 +313,11 @@ protected:
      */
     String averagine_type_;
 
+    /**
+     * @brief shared averagine table of the averagine type (0 if the type is unrecognized)
+     */
+    const IsotopeDistributionTable* averagine_table_;
+
   };
 
 }
@@ -44,6 +44,9 @@
 
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define DEBUG_PEAK_PICKING
 #undef DEBUG_PEAK_PICKING
@@ -118,6 +121,291 @@ public:
      */
     template <typename PeakType>
       void pick(const MSSpectrum<PeakType>& input, MSSpectrum<PeakType>& output, std::vector<PeakBoundary>& boundaries, bool check_spacings = true) const
+    {
+      PickingBuffers buffers;
+      pick_(input, output, boundaries, check_spacings, buffers);
+    }
+
+     /**
+     * @brief Applies the peak-picking algorithm to a single chromatogram
+     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
+     *
+     * @param input  input chromatogram in profile mode
+     * @param output  output chromatogram with picked peaks
+     */
+    template <typename PeakType>
+    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output) const
+    {
+      std::vector<PeakBoundary> boundaries;
+      pick(input, output, boundaries);
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a single chromatogram
+     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
+     *
+     * @param input  input chromatogram in profile mode
+     * @param output  output chromatogram with picked peaks
+     * @param boundaries  boundaries of the picked peaks
+     */
+    template <typename PeakType>
+    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output, std::vector<PeakBoundary>& boundaries) const
+    {
+      // copy meta data of the input chromatogram
+      output.clear(true);
+      output.ChromatogramSettings::operator=(input);
+      output.MetaInfoInterface::operator=(input);
+      output.setName(input.getName());
+
+      MSSpectrum<PeakType> input_spectrum;
+      MSSpectrum<PeakType> output_spectrum;
+      for (typename MSChromatogram<PeakType>::const_iterator it = input.begin(); it != input.end(); ++it)
+      {
+        input_spectrum.push_back(*it);
+      }
+      pick(input_spectrum, output_spectrum, boundaries, false); // no spacing checks!
+      output.insert(output.begin(), output_spectrum.begin(), output_spectrum.end());
+      // copy float data arrays (for FWHM)
+      output.getFloatDataArrays().resize(output_spectrum.getFloatDataArrays().size());
+      for (Size i = 0; i < output_spectrum.getFloatDataArrays().size(); ++i)
+      {
+        output.getFloatDataArrays()[i].insert(output.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].end());
+        output.getFloatDataArrays()[i].setName(output_spectrum.getFloatDataArrays()[i].getName());
+      }
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
+     * method picks peaks for each scan in the map consecutively. The resulting
+     * picked peaks are written to the output map.
+     *
+     * @param input  input map in profile mode
+     * @param output  output map with picked peaks
+     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
+     */
+    void pickExperiment(const PeakMap& input, PeakMap& output, const bool check_spectrum_type = true) const
+    {
+        std::vector<std::vector<PeakBoundary> > boundaries_spec;
+        std::vector<std::vector<PeakBoundary> > boundaries_chrom;
+        pickExperiment(input, output, boundaries_spec, boundaries_chrom, check_spectrum_type);
+    }
+
+    /**
+     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
+     * method picks peaks for each scan in the map (in parallel, if OpenMP is
+     * enabled). The resulting picked peaks are written to the output map.
+     *
+     * @param input  input map in profile mode
+     * @param output  output map with picked peaks
+     * @param boundaries_spec  boundaries of the picked peaks in spectra
+     * @param boundaries_chrom  boundaries of the picked peaks in chromatograms
+     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
+     */
+    void pickExperiment(const PeakMap& input, PeakMap& output, std::vector<std::vector<PeakBoundary> >& boundaries_spec, std::vector<std::vector<PeakBoundary> >& boundaries_chrom, const bool check_spectrum_type = true) const
+    {
+      // make sure that output is clear
+      output.clear(true);
+
+      // copy experimental settings
+      static_cast<ExperimentalSettings &>(output) = input;
+
+      // resize output with respect to input
+      output.resize(input.size());
+
+      Size progress = 0;
+      startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
+
+      if (input.getNrSpectra() > 0)
+      {
+        // determine type of spectral data (profile or centroided) up front,
+        // exceptions must not be thrown from within the parallel section
+        if (check_spectrum_type)
+        {
+          for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+          {
+            if (ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()) &&
+                input[scan_idx].getType() == SpectrumSettings::PEAKS)
+            {
+              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            }
+          }
+        }
+
+        // peak boundaries of each spectrum (empty for spectra that are not picked)
+        std::vector<std::vector<PeakBoundary> > boundaries_scan(input.size());
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+          PickingBuffers buffers; // scratch space of this thread, reused for all its spectra
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 10)
+#endif
+          for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
+          {
+            IF_MASTERTHREAD setProgress(progress);
+
+            if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
+            {
+              output[scan_idx] = input[scan_idx];
+            }
+            else
+            {
+              pick_(input[scan_idx], output[scan_idx], boundaries_scan[scan_idx], true, buffers);
+            }
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            ++progress;
+          }
+        }
+
+        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+        {
+          if (ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
+          {
+            boundaries_spec.push_back(std::vector<PeakBoundary>());
+            boundaries_spec.back().swap(boundaries_scan[scan_idx]);
+          }
+        }
+      }
+
+
+      for (Size i = 0; i < input.getChromatograms().size(); ++i)
+      {
+        MSChromatogram<> chromatogram;
+        std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
+        pick(input.getChromatograms()[i], chromatogram, boundaries_c);
+        output.addChromatogram(chromatogram);
+        boundaries_chrom.push_back(boundaries_c);
+        setProgress(++progress);
+      }
+      endProgress();
+
+      return;
+    }
+
+    /**
+      @brief Applies the peak-picking algorithm to a map (MSExperiment). This
+      method picks peaks for each scan in the map consecutively. The resulting
+      picked peaks are written to the output map.
+
+      Currently we have to give up const-correctness but we know that everything on disc is constant
+    */
+    void pickExperiment(/* const */ OnDiscPeakMap& input, PeakMap& output, const bool check_spectrum_type = true) const
+    {
+      // make sure that output is clear
+      output.clear(true);
+
+      // copy experimental settings
+      static_cast<ExperimentalSettings &>(output) = *input.getExperimentalSettings();
+
+      Size progress = 0;
+      startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
+
+      if (input.getNrSpectra() > 0)
+      {
+
+        // resize output with respect to input
+        output.resize(input.size());
+
+        PickingBuffers buffers; // scratch space, reused for all spectra
+        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+        {
+          if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
+          {
+            output[scan_idx] = input[scan_idx];
+          }
+          else
+          {
+            MSSpectrum<> s = input[scan_idx];
+            s.sortByPosition();
+
+            // determine type of spectral data (profile or centroided)
+            SpectrumSettings::SpectrumType spectrum_type = s.getType();
+
+            if (spectrum_type == SpectrumSettings::PEAKS && check_spectrum_type)
+            {
+              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            }
+
+            std::vector<PeakBoundary> boundaries_s;
+            pick_(s, output[scan_idx], boundaries_s, true, buffers);
+          }
+          setProgress(++progress);
+        }
+      }
+
+      for (Size i = 0; i < input.getNrChromatograms(); ++i)
+      {
+        MSChromatogram<> chromatogram;
+        pick(input.getChromatogram(i), chromatogram);
+        output.addChromatogram(chromatogram);
+        setProgress(++progress);
+      }
+      endProgress();
+
+      return;
+    }
+
+protected:
+    // signal-to-noise parameter
+    double signal_to_noise_;
+
+    // maximal spacing difference defining a large gap
+    double spacing_difference_gap_;
+    
+    // maximal spacing difference defining a missing data point
+    double spacing_difference_;
+
+    // maximum number of missing points
+    unsigned missing_;
+
+    // MS levels to which peak picking is applied
+    std::vector<Int> ms_levels_;
+
+    /// add floatDataArray 'FWHM'/'FWHM_ppm' to spectra with peak FWHM
+    bool report_FWHM_;
+
+    /// unit of 'FWHM' float data array (can be absolute or ppm).
+    bool report_FWHM_as_ppm_;
+
+    // docu in base class
+    void updateMembers_();
+
+    /**
+      @brief Scratch space of the peak picking of a single spectrum
+
+      All vectors only grow, so a single instance (e.g. one per thread) can be
+      reused for many spectra without further memory allocations.
+    */
+    struct PickingBuffers
+    {
+      /// signal-to-noise ratio of each data point of the spectrum
+      std::vector<double> snt;
+      /// extension of the current peak to the left (from the apex outwards)
+      std::vector<double> left_mz, left_int;
+      /// extension of the current peak to the right (from the apex outwards)
+      std::vector<double> right_mz, right_int;
+      /// data points of the current peak (ascending m/z, distinct positions)
+      std::vector<double> peak_mz, peak_int;
+      /// spline of the current peak (re-initialized for every peak)
+      CubicSpline2d spline;
+    };
+
+    /// Adds the data point (@p mz, @p intensity) to the current peak (see pick_())
+    static void addPeakPoint_(PickingBuffers& buffers, double mz, double intensity, bool overwrite);
+
+    /**
+      @brief Applies the peak-picking algorithm to a single spectrum, using @p buffers as scratch space
+
+      See pick() for a description of the other parameters.
+    */
+    template <typename PeakType>
+    void pick_(const MSSpectrum<PeakType>& input, MSSpectrum<PeakType>& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, PickingBuffers& buffers) const
     {
       // copy meta data of the input spectrum
       output.clear(true);
@@ -143,13 +431,19 @@ public:
         check_spacings = false;
       }
 
-      // signal-to-noise estimation
-      SignalToNoiseEstimatorMedian<MSSpectrum<PeakType> > snt;
-      snt.setParameters(param_.copy("SignalToNoise:", true));
-
+      // signal-to-noise estimation (looked up once per data point, the
+      // estimator stores its results in a map)
+      std::vector<double>& snt_values = buffers.snt;
+      snt_values.assign(input.size(), 0.0);
       if (signal_to_noise_ > 0.0)
       {
+        SignalToNoiseEstimatorMedian<MSSpectrum<PeakType> > snt;
+        snt.setParameters(param_.copy("SignalToNoise:", true));
         snt.init(input);
+        for (Size i = 0; i < input.size(); ++i)
+        {
+          snt_values[i] = snt.getSignalToNoise(input[i]);
+        }
       }
 
       // find local maxima in raw data
@@ -172,20 +466,12 @@ public:
           min_spacing = (left_to_central < central_to_right) ? left_to_central : central_to_right;
         }
 
-        double act_snt = 0.0, act_snt_l1 = 0.0, act_snt_r1 = 0.0;
-        if (signal_to_noise_ > 0.0)
-        {
-          act_snt = snt.getSignalToNoise(input[i]);
-          act_snt_l1 = snt.getSignalToNoise(input[i - 1]);
-          act_snt_r1 = snt.getSignalToNoise(input[i + 1]);
-        }
-
         // look for peak cores meeting MZ and intensity/SNT criteria
         if ((central_peak_int > left_neighbor_int) && 
             (central_peak_int > right_neighbor_int) && 
-            (act_snt >= signal_to_noise_) && 
-            (act_snt_l1 >= signal_to_noise_) && 
-            (act_snt_r1 >= signal_to_noise_) &&
+            (snt_values[i] >= signal_to_noise_) && 
+            (snt_values[i - 1] >= signal_to_noise_) && 
+            (snt_values[i + 1] >= signal_to_noise_) &&
             (!check_spacings || 
              ((left_to_central < spacing_difference_ * min_spacing) && 
               (central_to_right < spacing_difference_ * min_spacing))))
@@ -194,21 +480,13 @@ public:
           // satellite peaks (indicates oscillation rather than
           // real peaks) -> remove
 
-          double act_snt_l2 = 0.0, act_snt_r2 = 0.0;
-
-          if (signal_to_noise_ > 0.0)
-          {
-            act_snt_l2 = snt.getSignalToNoise(input[i - 2]);
-            act_snt_r2 = snt.getSignalToNoise(input[i + 2]);
-          }
-
           // checking signal-to-noise?
           if ((i > 1) &&
               (i + 2 < input.size()) &&
               (left_neighbor_int < input[i - 2].getIntensity()) &&
               (right_neighbor_int < input[i + 2].getIntensity()) &&
-              (act_snt_l2 >= signal_to_noise_) &&
-              (act_snt_r2 >= signal_to_noise_) &&
+              (snt_values[i - 2] >= signal_to_noise_) &&
+              (snt_values[i + 2] >= signal_to_noise_) &&
               (!check_spacings ||
                ((left_neighbor_mz - input[i - 2].getMZ() < spacing_difference_ * min_spacing) && 
                 (input[i + 2].getMZ() - right_neighbor_mz < spacing_difference_ * min_spacing))))
@@ -217,14 +495,11 @@ public:
             continue;
           }
 
-          std::map<double, double> peak_raw_data;
-
-          peak_raw_data[central_peak_mz] = central_peak_int;
-          peak_raw_data[left_neighbor_mz] = left_neighbor_int;
-          peak_raw_data[right_neighbor_mz] = right_neighbor_int;
-
           // peak core found, now extend it
           // to the left
+          buffers.left_mz.clear();
+          buffers.left_int.clear();
+          double leftmost_mz = left_neighbor_mz, leftmost_int = left_neighbor_int;
           Size k = 2;
 
           bool previous_zero_left(false); // no need to extend peak if previous intensity was zero
@@ -235,30 +510,24 @@ public:
                  (i - k + 1 > 0) && 
                  !previous_zero_left && 
                  (missing_left <= missing_) && 
-                 (input[i - k].getIntensity() <= peak_raw_data.begin()->second) &&
+                 (input[i - k].getIntensity() <= leftmost_int) &&
                  (!check_spacings || 
-                  (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_gap_ * min_spacing)))
+                  (leftmost_mz - input[i - k].getMZ() < spacing_difference_gap_ * min_spacing)))
           {
-            double act_snt_lk = 0.0;
-
-            if (signal_to_noise_ > 0.0)
+            bool add_point = (snt_values[i - k] >= signal_to_noise_) && 
+                             (!check_spacings ||
+                              (leftmost_mz - input[i - k].getMZ() < spacing_difference_ * min_spacing));
+            if (!add_point)
             {
-              act_snt_lk = snt.getSignalToNoise(input[i - k]);
+              ++missing_left;
+              add_point = (missing_left <= missing_);
             }
-
-            if ((act_snt_lk >= signal_to_noise_) && 
-                (!check_spacings ||
-                 (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_ * min_spacing)))
+            if (add_point)
             {
-              peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
-            }
-            else
-            {
-              ++missing_left;
-              if (missing_left <= missing_)
-              {
-                peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
-              }
+              leftmost_mz = input[i - k].getMZ();
+              leftmost_int = input[i - k].getIntensity();
+              buffers.left_mz.push_back(leftmost_mz);
+              buffers.left_int.push_back(leftmost_int);
             }
 
             previous_zero_left = (input[i - k].getIntensity() == 0);
@@ -267,6 +536,9 @@ public:
           }
 
           // to the right
+          buffers.right_mz.clear();
+          buffers.right_int.clear();
+          double rightmost_mz = right_neighbor_mz, rightmost_int = right_neighbor_int;
           k = 2;
 
           bool previous_zero_right(false); // no need to extend peak if previous intensity was zero
@@ -276,30 +548,24 @@ public:
           while ((i + k < input.size()) && 
                  !previous_zero_right && 
                  (missing_right <= missing_) && 
-                 (input[i + k].getIntensity() <= peak_raw_data.rbegin()->second) &&
+                 (input[i + k].getIntensity() <= rightmost_int) &&
                  (!check_spacings ||
-                  (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_gap_ * min_spacing)))
+                  (input[i + k].getMZ() - rightmost_mz < spacing_difference_gap_ * min_spacing)))
           {
-            double act_snt_rk = 0.0;
-
-            if (signal_to_noise_ > 0.0)
-            {
-              act_snt_rk = snt.getSignalToNoise(input[i + k]);
-            }
-
-            if ((act_snt_rk >= signal_to_noise_) && 
-                (!check_spacings ||
-                 (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_ * min_spacing)))
+            bool add_point = (snt_values[i + k] >= signal_to_noise_) && 
+                             (!check_spacings ||
+                              (input[i + k].getMZ() - rightmost_mz < spacing_difference_ * min_spacing));
+            if (!add_point)
             {
-              peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
+              ++missing_right;
+              add_point = (missing_right <= missing_);
             }
-            else
+            if (add_point)
             {
-              ++missing_right;
-              if (missing_right <= missing_)
-              {
-                peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
-              }
+              rightmost_mz = input[i + k].getMZ();
+              rightmost_int = input[i + k].getIntensity();
+              buffers.right_mz.push_back(rightmost_mz);
+              buffers.right_int.push_back(rightmost_int);
             }
 
             previous_zero_right = (input[i + k].getIntensity() == 0);
@@ -307,10 +573,27 @@ public:
             ++k;
           }
 
+          // collect the data points of the peak in ascending m/z order; for
+          // duplicate positions, the point further away from the apex is used
+          buffers.peak_mz.clear();
+          buffers.peak_int.clear();
+          for (Size j = buffers.left_mz.size(); j > 0; --j)
+          {
+            addPeakPoint_(buffers, buffers.left_mz[j - 1], buffers.left_int[j - 1], false);
+          }
+          addPeakPoint_(buffers, left_neighbor_mz, left_neighbor_int, false);
+          addPeakPoint_(buffers, central_peak_mz, central_peak_int, false);
+          addPeakPoint_(buffers, right_neighbor_mz, right_neighbor_int, true);
+          for (Size j = 0; j < buffers.right_mz.size(); ++j)
+          {
+            addPeakPoint_(buffers, buffers.right_mz[j], buffers.right_int[j], true);
+          }
+
           // skip if the minimal number of 3 points for fitting is not reached
-          if (peak_raw_data.size() < 3) continue;
+          if (buffers.peak_mz.size() < 3) continue;
 
-          CubicSpline2d peak_spline (peak_raw_data);
+          CubicSpline2d& peak_spline = buffers.spline;
+          peak_spline.init(buffers.peak_mz, buffers.peak_int);
 
           // calculate maximum by evaluating the spline's 1st derivative
           // (bisection method)
@@ -360,7 +643,7 @@ public:
             threshold = 0.01 * fwhm_int;
             double mz_mid, int_mid; 
             // left:
-            double mz_left = peak_raw_data.begin()->first;
+            double mz_left = buffers.peak_mz.front();
             double mz_center = max_peak_mz;
             if (peak_spline.eval(mz_left) > fwhm_int)
             { // the spline ends before half max is reached -- take the leftmost point (probably an underestimation)
@@ -384,7 +667,7 @@ public:
             const double fwhm_left_mz = mz_mid;
 
             // right ...
-            double mz_right = peak_raw_data.rbegin()->first;
+            double mz_right = buffers.peak_mz.back();
             mz_center = max_peak_mz;
             if (peak_spline.eval(mz_right) > fwhm_int)
             { // the spline ends before half max is reached -- take the rightmost point (probably an underestimation)
@@ -430,223 +713,6 @@ public:
       return;
     }
 
-     /**
-     * @brief Applies the peak-picking algorithm to a single chromatogram
-     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
-     *
-     * @param input  input chromatogram in profile mode
-     * @param output  output chromatogram with picked peaks
-     */
-    template <typename PeakType>
-    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output) const
-    {
-      std::vector<PeakBoundary> boundaries;
-      pick(input, output, boundaries);
-    }
-
-    /**
-     * @brief Applies the peak-picking algorithm to a single chromatogram
-     * (MSChromatogram). The resulting picked peaks are written to the output chromatogram.
-     *
-     * @param input  input chromatogram in profile mode
-     * @param output  output chromatogram with picked peaks
-     * @param boundaries  boundaries of the picked peaks
-     */
-    template <typename PeakType>
-    void pick(const MSChromatogram<PeakType>& input, MSChromatogram<PeakType>& output, std::vector<PeakBoundary>& boundaries) const
-    {
-      // copy meta data of the input chromatogram
-      output.clear(true);
-      output.ChromatogramSettings::operator=(input);
-      output.MetaInfoInterface::operator=(input);
-      output.setName(input.getName());
-
-      MSSpectrum<PeakType> input_spectrum;
-      MSSpectrum<PeakType> output_spectrum;
-      for (typename MSChromatogram<PeakType>::const_iterator it = input.begin(); it != input.end(); ++it)
-      {
-        input_spectrum.push_back(*it);
-      }
-      pick(input_spectrum, output_spectrum, boundaries, false); // no spacing checks!
-      output.insert(output.begin(), output_spectrum.begin(), output_spectrum.end());
-      // copy float data arrays (for FWHM)
-      output.getFloatDataArrays().resize(output_spectrum.getFloatDataArrays().size());
-      for (Size i = 0; i < output_spectrum.getFloatDataArrays().size(); ++i)
-      {
-        output.getFloatDataArrays()[i].insert(output.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].begin(), output_spectrum.getFloatDataArrays()[i].end());
-        output.getFloatDataArrays()[i].setName(output_spectrum.getFloatDataArrays()[i].getName());
-      }
-    }
-
-    /**
-     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
-     *
-     * @param input  input map in profile mode
-     * @param output  output map with picked peaks
-     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
-     */
-    void pickExperiment(const PeakMap& input, PeakMap& output, const bool check_spectrum_type = true) const
-    {
-        std::vector<std::vector<PeakBoundary> > boundaries_spec;
-        std::vector<std::vector<PeakBoundary> > boundaries_chrom;
-        pickExperiment(input, output, boundaries_spec, boundaries_chrom, check_spectrum_type);
-    }
-
-    /**
-     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
-     *
-     * @param input  input map in profile mode
-     * @param output  output map with picked peaks
-     * @param boundaries_spec  boundaries of the picked peaks in spectra
-     * @param boundaries_chrom  boundaries of the picked peaks in chromatograms
-     * @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed 
-     */
-    void pickExperiment(const PeakMap& input, PeakMap& output, std::vector<std::vector<PeakBoundary> >& boundaries_spec, std::vector<std::vector<PeakBoundary> >& boundaries_chrom, const bool check_spectrum_type = true) const
-    {
-      // make sure that output is clear
-      output.clear(true);
-
-      // copy experimental settings
-      static_cast<ExperimentalSettings &>(output) = input;
-
-      // resize output with respect to input
-      output.resize(input.size());
-
-      Size progress = 0;
-      startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
-
-      if (input.getNrSpectra() > 0)
-      {
-        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
-        {
-          if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-
-            // determine type of spectral data (profile or centroided)
-            SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType();
-
-            if (spectrum_type == SpectrumSettings::PEAKS && check_spectrum_type)
-            {
-              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-            }
-
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            boundaries_spec.push_back(boundaries_s);
-          }
-          setProgress(++progress);
-        }
-      }
-
-
-      for (Size i = 0; i < input.getChromatograms().size(); ++i)
-      {
-        MSChromatogram<> chromatogram;
-        std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-        pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-        output.addChromatogram(chromatogram);
-        boundaries_chrom.push_back(boundaries_c);
-        setProgress(++progress);
-      }
-      endProgress();
-
-      return;
-    }
-
-    /**
-      @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-      method picks peaks for each scan in the map consecutively. The resulting
-      picked peaks are written to the output map.
-
-      Currently we have to give up const-correctness but we know that everything on disc is constant
-    */
-    void pickExperiment(/* const */ OnDiscPeakMap& input, PeakMap& output, const bool check_spectrum_type = true) const
-    {
-      // make sure that output is clear
-      output.clear(true);
-
-      // copy experimental settings
-      static_cast<ExperimentalSettings &>(output) = *input.getExperimentalSettings();
-
-      Size progress = 0;
-      startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
-
-      if (input.getNrSpectra() > 0)
-      {
-
-        // resize output with respect to input
-        output.resize(input.size());
-
-        for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
-        {
-          if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel()))
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            MSSpectrum<> s = input[scan_idx];
-            s.sortByPosition();
-
-            // determine type of spectral data (profile or centroided)
-            SpectrumSettings::SpectrumType spectrum_type = s.getType();
-
-            if (spectrum_type == SpectrumSettings::PEAKS && check_spectrum_type)
-            {
-              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-            }
-
-            pick(s, output[scan_idx]);
-          }
-          setProgress(++progress);
-        }
-      }
-
-      for (Size i = 0; i < input.getNrChromatograms(); ++i)
-      {
-        MSChromatogram<> chromatogram;
-        pick(input.getChromatogram(i), chromatogram);
-        output.addChromatogram(chromatogram);
-        setProgress(++progress);
-      }
-      endProgress();
-
-      return;
-    }
-
-protected:
-    // signal-to-noise parameter
-    double signal_to_noise_;
-
-    // maximal spacing difference defining a large gap
-    double spacing_difference_gap_;
-    
-    // maximal spacing difference defining a missing data point
-    double spacing_difference_;
-
-    // maximum number of missing points
-    unsigned missing_;
-
-    // MS levels to which peak picking is applied
-    std::vector<Int> ms_levels_;
-
-    /// add floatDataArray 'FWHM'/'FWHM_ppm' to spectra with peak FWHM
-    bool report_FWHM_;
-
-    /// unit of 'FWHM' float data array (can be absolute or ppm).
-    bool report_FWHM_as_ppm_;
-
-    // docu in base class
-    void updateMembers_();
-
   }; // end PeakPickerHiRes
 
 } // namespace OpenMS
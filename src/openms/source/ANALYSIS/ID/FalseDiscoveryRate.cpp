@@ -35,8 +35,10 @@
 #include <OpenMS/ANALYSIS/ID/FalseDiscoveryRate.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/ParallelSort.h>
 
 #include <algorithm>
+#include <cmath>
 
 // #define FALSE_DISCOVERY_RATE_DEBUG
 // #undef  FALSE_DISCOVERY_RATE_DEBUG
@@ -45,6 +47,165 @@ using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    typedef FalseDiscoveryRate::ScoredHit ScoredHit;
+
+    /// Role of a hit in the target/decoy calculation
+    enum HitKind {TARGET_HIT, DECOY_HIT, UNLABELED_HIT, REMOVED_HIT};
+
+    /// Orders hits by group, then from the best to the worst score
+    struct ScoredHitLess
+    {
+      explicit ScoredHitLess(bool higher_score_better) :
+        higher_score_better_(higher_score_better)
+      {
+      }
+
+      bool operator()(const ScoredHit& a, const ScoredHit& b) const
+      {
+        if (a.group != b.group) return a.group < b.group;
+        return higher_score_better_ ? a.score > b.score : a.score < b.score;
+      }
+
+      bool higher_score_better_;
+    };
+
+    /// Calculates the FDRs of the hits [begin, end) of one group (sorted from best to worst)
+    void calculateGroupFDRs_(const std::vector<ScoredHit>& hits, Size begin, Size end, std::vector<double>& fdrs, bool q_value)
+    {
+      // FDR of the target scores; hits with equal scores are counted together
+      Size targets = 0, decoys = 0;
+      for (Size block = begin; block < end; )
+      {
+        Size block_end = block;
+        for (; block_end < end && hits[block_end].score == hits[block].score; ++block_end)
+        {
+          if (hits[block_end].is_decoy) ++decoys;
+          else ++targets;
+        }
+        for (Size i = block; i < block_end; ++i)
+        {
+          if (!hits[i].is_decoy) fdrs[hits[i].index] = double(decoys) / double(targets);
+        }
+        block = block_end;
+      }
+
+      if (targets == 0)
+      {
+        for (Size i = begin; i < end; ++i)
+        {
+          fdrs[hits[i].index] = 1.0;
+        }
+        return;
+      }
+
+      // q-value: minimal FDR of all thresholds that include the hit
+      if (q_value)
+      {
+        double minimal_fdr = 1.0;
+        for (Size i = end; i > begin; --i)
+        {
+          if (hits[i - 1].is_decoy) continue;
+          double& fdr = fdrs[hits[i - 1].index];
+          minimal_fdr = std::min(minimal_fdr, fdr);
+          fdr = minimal_fdr;
+        }
+      }
+
+      // decoys get the value of the closest target score; of two equally close
+      // targets, the worse one is used for q-values and the better one for FDRs
+      Size previous = end, next = begin;
+      for (Size i = begin; i < end; ++i)
+      {
+        if (!hits[i].is_decoy)
+        {
+          previous = i;
+          continue;
+        }
+        next = std::max(next, i);
+        while (next < end && hits[next].is_decoy) ++next;
+
+        Size closest = previous;
+        if (previous == end)
+        {
+          closest = next;
+        }
+        else if (next != end)
+        {
+          double previous_distance = fabs(hits[i].score - hits[previous].score);
+          double next_distance = fabs(hits[i].score - hits[next].score);
+          if (next_distance < previous_distance || (next_distance == previous_distance && q_value))
+          {
+            closest = next;
+          }
+        }
+        fdrs[hits[i].index] = fdrs[hits[closest].index];
+      }
+    }
+
+    /// Describes a group of peptide hits in error messages
+    String groupDescription_(bool split_charge_variants, SignedSize charge, bool treat_runs_separately, const String& run)
+    {
+      String description;
+      if (split_charge_variants || treat_runs_separately)
+      {
+        description += "(";
+        if (split_charge_variants)
+        {
+          description += "charge_variant=" + String(charge) + " ";
+        }
+        if (treat_runs_separately)
+        {
+          description += "run-id=" + run;
+        }
+        description += ")";
+      }
+      return description;
+    }
+
+    /// Appends the scores of all hits of @p ids to @p scored_hits (the index is the position in @p scored_hits)
+    template <typename IdentificationType>
+    void collectScores_(const std::vector<IdentificationType>& ids, bool is_decoy, std::vector<ScoredHit>& scored_hits)
+    {
+      for (typename std::vector<IdentificationType>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+      {
+        for (Size i = 0; i < it->getHits().size(); ++i)
+        {
+          scored_hits.push_back(ScoredHit(it->getHits()[i].getScore(), is_decoy, scored_hits.size()));
+        }
+      }
+    }
+
+    /// Replaces the scores of all hits of @p ids by @p fdrs (starting at @p offset); the original score is stored as meta value @p score_type
+    template <typename IdentificationType>
+    void annotateScores_(std::vector<IdentificationType>& ids, const std::vector<double>& fdrs, Size offset, const String& score_type, bool q_value)
+    {
+      std::vector<Size> first_hit(ids.size());
+      for (Size i = 0; i < ids.size(); ++i)
+      {
+        first_hit[i] = offset;
+        offset += ids[i].getHits().size();
+      }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
+      {
+        IdentificationType& id = ids[i];
+        id.setScoreType(q_value ? "q-value" : "FDR");
+        id.setHigherScoreBetter(false);
+        for (Size k = 0; k < id.getHits().size(); ++k)
+        {
+          typename IdentificationType::HitType& hit = id.getHits()[k];
+          hit.setMetaValue(score_type, hit.getScore());
+          hit.setScore(fdrs[first_hit[i] + k]);
+        }
+      }
+    }
+  }
+
   FalseDiscoveryRate::FalseDiscoveryRate() :
     DefaultParamHandler("FalseDiscoveryRate")
   {
@@ -61,6 +222,22 @@ namespace OpenMS
     defaultsToParam_();
   }
 
+  FalseDiscoveryRate::ScoredHit::ScoredHit() :
+    score(0.0),
+    index(0),
+    group(0),
+    is_decoy(false)
+  {
+  }
+
+  FalseDiscoveryRate::ScoredHit::ScoredHit(double score, bool is_decoy, Size index, UInt group) :
+    score(score),
+    index(index),
+    group(group),
+    is_decoy(is_decoy)
+  {
+  }
+
   void FalseDiscoveryRate::apply(vector<PeptideIdentification>& ids)
   {
     bool q_value = !param_.getValue("no_qvalues").toBool();
@@ -82,6 +259,7 @@ namespace OpenMS
     // first search for all identifiers and charge variants
     set<String> identifiers;
     set<SignedSize> charge_variants;
+    Size nr_hits = 0;
     for (vector<PeptideIdentification>::iterator it = ids.begin(); it != ids.end(); ++it)
     {
       identifiers.insert(it->getIdentifier());
@@ -96,6 +274,7 @@ namespace OpenMS
       {
         charge_variants.insert(pit->getCharge());
       }
+      nr_hits += it->getHits().size();
     }
 
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
@@ -115,204 +294,151 @@ namespace OpenMS
     cerr << endl;
 #endif
 
-    for (set<SignedSize>::const_iterator zit = charge_variants.begin(); zit != charge_variants.end(); ++zit)
+    // hits are grouped by charge variant (if split) and by run within (if treated separately)
+    const vector<String> runs(identifiers.begin(), identifiers.end());
+    const vector<SignedSize> charges(charge_variants.begin(), charge_variants.end());
+    const Size nr_runs = treat_runs_separately ? runs.size() : 1;
+    const Size nr_charges = split_charge_variants ? charges.size() : std::min<Size>(charges.size(), 1);
+    const Size nr_groups = nr_runs * nr_charges;
+
+    // get the scores of all peptide hits (the index is the position of the hit among all hits)
+    vector<ScoredHit> scored_hits, unlabeled_hits;
+    scored_hits.reserve(nr_hits);
+    vector<char> kinds(nr_hits, UNLABELED_HIT);
+    vector<Size> nr_targets(nr_groups, 0), nr_decoys(nr_groups, 0), nr_unlabeled(nr_groups, 0);
+    Size index = 0;
+    for (vector<PeptideIdentification>::const_iterator it = ids.begin(); it != ids.end(); ++it)
     {
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-      cerr << "Charge variant=" << *zit << endl;
-#endif
+      Size run = 0;
+      if (treat_runs_separately)
+      {
+        run = lower_bound(runs.begin(), runs.end(), it->getIdentifier()) - runs.begin();
+      }
 
-      // for all identifiers
-      for (set<String>::const_iterator iit = identifiers.begin(); iit != identifiers.end(); ++iit)
+      for (Size i = 0; i < it->getHits().size(); ++i, ++index)
       {
-        if (!treat_runs_separately && iit != identifiers.begin())
+        const PeptideHit& hit = it->getHits()[i];
+        Size group = run;
+        if (split_charge_variants)
         {
-          continue;
+          group += nr_runs * (lower_bound(charges.begin(), charges.end(), hit.getCharge()) - charges.begin());
         }
 
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << "Id-run: " << *iit << endl;
-#endif
-        // get the scores of all peptide hits
-        vector<double> target_scores, decoy_scores;
-        for (vector<PeptideIdentification>::iterator it = ids.begin(); it != ids.end(); ++it)
+        if (!hit.metaValueExists("target_decoy"))
         {
-          // if runs should be treated separately, the identifiers must be the same
-          if (treat_runs_separately && it->getIdentifier() != *iit)
-          {
-            continue;
-          }
+          LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' first (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << it->getHits().size() << ")!" << endl;
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
+        }
 
-          for (Size i = 0; i < it->getHits().size(); ++i)
-          {
-            if (split_charge_variants && it->getHits()[i].getCharge() != *zit)
-            {
-              continue;
-            }
-
-            if (!it->getHits()[i].metaValueExists("target_decoy"))
-            {
-              LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' first (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << it->getHits().size() << ")!" << endl;
-              throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
-            }
-
-            String target_decoy(it->getHits()[i].getMetaValue("target_decoy"));
-            if (target_decoy == "target" || target_decoy == "target+decoy")
-            {
-              target_scores.push_back(it->getHits()[i].getScore());
-            }
-            else
-            {
-              if (target_decoy == "decoy")
-              {
-                decoy_scores.push_back(it->getHits()[i].getScore());
-              }
-              else
-              {
-                if (target_decoy != "")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
-              }
-            }
-          }
+        String target_decoy(hit.getMetaValue("target_decoy"));
+        if (target_decoy == "target" || target_decoy == "target+decoy")
+        {
+          kinds[index] = TARGET_HIT;
+          ++nr_targets[group];
+          scored_hits.push_back(ScoredHit(hit.getScore(), false, index, group));
         }
+        else if (target_decoy == "decoy")
+        {
+          kinds[index] = DECOY_HIT;
+          ++nr_decoys[group];
+          scored_hits.push_back(ScoredHit(hit.getScore(), true, index, group));
+        }
+        else if (target_decoy == "")
+        {
+          ++nr_unlabeled[group];
+          unlabeled_hits.push_back(ScoredHit(hit.getScore(), false, index, group));
+        }
+        else
+        {
+          throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
+        }
+      }
+    }
+
+    // calculate fdr for all groups at once
+    bool higher_score_better(ids.begin()->isHigherScoreBetter());
+    vector<double> fdrs(nr_hits, 0.0);
+    calculateFDRs(scored_hits, fdrs, q_value, higher_score_better);
 
+    // hits without target/decoy information get the value of an equal score of their group (if any)
+    const ScoredHitLess less(higher_score_better);
+    for (vector<ScoredHit>::const_iterator it = unlabeled_hits.begin(); it != unlabeled_hits.end(); ++it)
+    {
+      vector<ScoredHit>::const_iterator match = lower_bound(scored_hits.begin(), scored_hits.end(), *it, less);
+      if (match != scored_hits.end() && match->group == it->group && match->score == it->score)
+      {
+        fdrs[it->index] = fdrs[match->index];
+      }
+    }
+
+    // groups without targets or decoys: targets get q-value/FDR 0, decoys are removed
+    vector<bool> incomplete(nr_groups, false);
+    for (Size c = 0; c < nr_charges; ++c)
+    {
+      for (Size r = 0; r < nr_runs; ++r)
+      {
+        const Size group = c * nr_runs + r;
+        const String description = groupDescription_(split_charge_variants, charges[c], treat_runs_separately, runs[treat_runs_separately ? r : 0]);
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << "#target-scores=" << target_scores.size() << ", #decoy-scores=" << decoy_scores.size() << endl;
+        cerr << "Group " << description << ": #target-scores=" << nr_targets[group] << ", #decoy-scores=" << nr_decoys[group] << endl;
 #endif
-
-        // check decoy scores
-        if (decoy_scores.empty())
+        if (nr_decoys[group] == 0)
         {
-          String error_string = "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! ";
-          if (split_charge_variants || treat_runs_separately)
-          {
-            error_string += "(";
-            if (split_charge_variants)
-            {
-              error_string += "charge_variant=" + String(*zit) + " ";
-            }
-            if (treat_runs_separately)
-            {
-              error_string += "run-id=" + *iit;
-            }
-            error_string += ")";
-          }
-          LOG_ERROR << error_string << std::endl;
+          LOG_ERROR << "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! " << description << std::endl;
         }
-
-        // check target scores
-        if (target_scores.empty())
+        if (nr_targets[group] == 0)
         {
-          String error_string = "FalseDiscoveryRate: #target sequences is zero! Ignoring. ";
-          if (split_charge_variants || treat_runs_separately)
-          {
-            error_string += "(";
-            if (split_charge_variants)
-            {
-              error_string += "charge_variant=" + String(*zit) + " ";
-            }
-            if (treat_runs_separately)
-            {
-              error_string += "run-id=" + *iit;
-            }
-            error_string += ")";
-          }
-          LOG_ERROR << error_string << std::endl;
+          LOG_ERROR << "FalseDiscoveryRate: #target sequences is zero! Ignoring. " << description << std::endl;
         }
-
-        if (target_scores.empty() || decoy_scores.empty())
+        incomplete[group] = nr_targets[group] == 0 || nr_decoys[group] == 0;
+        if (incomplete[group] && nr_unlabeled[group] > 0)
         {
-          // no remove the the relevant entries, or put 'pseudo-scores' in
-          for (vector<PeptideIdentification>::iterator it = ids.begin(); it != ids.end(); ++it)
-          {
-            // if runs should be treated separately, the identifiers must be the same
-            if (treat_runs_separately && it->getIdentifier() != *iit)
-            {
-              continue;
-            }
-
-            vector<PeptideHit> hits(it->getHits()), new_hits;
-            for (Size i = 0; i < hits.size(); ++i)
-            {
-              if (split_charge_variants && hits[i].getCharge() != *zit)
-              {
-                new_hits.push_back(hits[i]);
-                continue;
-              }
-
-              if (!hits[i].metaValueExists("target_decoy"))
-              {
-                LOG_FATAL_ERROR << "Meta value 'target_decoy' does not exists, reindex the idXML file with 'PeptideIndexer' (run-id='" << it->getIdentifier() << ", rank=" << i + 1 << " of " << hits.size() << ")!" << endl;
-                throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Meta value 'target_decoy' does not exist!");
-              }
-
-              String target_decoy(hits[i].getMetaValue("target_decoy"));
-              if (target_decoy == "target" || target_decoy == "target+decoy")
-              {
-                // if it is a target hit, there are now decoys, fdr/q-value should be zero then
-                new_hits.push_back(hits[i]);
-                String score_type = it->getScoreType() + "_score";
-                new_hits.back().setMetaValue(score_type, new_hits.back().getScore());
-                new_hits.back().setScore(0);
-              }
-              else
-              {
-                if (target_decoy != "decoy")
-                {
-                  throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
-                }
-              }
-            }
-            it->setHits(new_hits);
-          }
-          continue;
+          throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", "");
         }
+      }
+    }
+    for (vector<ScoredHit>::const_iterator it = scored_hits.begin(); it != scored_hits.end(); ++it)
+    {
+      if (!incomplete[it->group]) continue;
+      if (it->is_decoy)
+      {
+        kinds[it->index] = REMOVED_HIT;
+      }
+      else
+      {
+        fdrs[it->index] = 0.0;
+      }
+    }
 
-        // calculate fdr for the forward scores
-        bool higher_score_better(ids.begin()->isHigherScoreBetter());
-        Map<double, double> score_to_fdr;
-        calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+    // annotate fdr
+    vector<Size> first_hit(ids.size());
+    for (Size i = 0, offset = 0; i < ids.size(); ++i)
+    {
+      first_hit[i] = offset;
+      offset += ids[i].getHits().size();
+    }
 
-        // annotate fdr
-        for (vector<PeptideIdentification>::iterator it = ids.begin(); it != ids.end(); ++it)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
+    {
+      String score_type = ids[i].getScoreType() + "_score";
+      const vector<PeptideHit>& old_hits = ids[i].getHits();
+      vector<PeptideHit> hits;
+      hits.reserve(old_hits.size());
+      for (Size k = 0; k < old_hits.size(); ++k)
+      {
+        const char kind = kinds[first_hit[i] + k];
+        if (kind == REMOVED_HIT || (kind == DECOY_HIT && !add_decoy_peptides))
         {
-          // if runs should be treated separately, the identifiers must be the same
-          if (treat_runs_separately && it->getIdentifier() != *iit)
-          {
-            continue;
-          }
-
-          String score_type = it->getScoreType() + "_score";
-          vector<PeptideHit> hits;
-          for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-          {
-            PeptideHit hit = *pit;
-
-            if (split_charge_variants && pit->getCharge() != *zit)
-            {
-              hits.push_back(*pit);
-              continue;
-            }
-            if (hit.metaValueExists("target_decoy"))
-            {
-              String meta_value = (String)hit.getMetaValue("target_decoy");
-              if (meta_value == "decoy" && !add_decoy_peptides)
-              {
-                continue;
-              }
-            }
-            hit.setMetaValue(score_type, pit->getScore());
-            hit.setScore(score_to_fdr[pit->getScore()]);
-            hits.push_back(hit);
-          }
-          it->setHits(hits);
+          continue;
         }
+        hits.push_back(old_hits[k]);
+        hits.back().setMetaValue(score_type, old_hits[k].getScore());
+        hits.back().setScore(fdrs[first_hit[i] + k]);
       }
-      if (!split_charge_variants)
-      {
-        break;
-      }
+      ids[i].getHits().swap(hits);
     }
 
     // higher-score-better can be set now, calculations are finished
@@ -345,83 +471,25 @@ namespace OpenMS
     {
       return;
     }
-    vector<double> target_scores, decoy_scores;
     // get the scores of all peptide hits
-    for (vector<PeptideIdentification>::const_iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
-    {
-      for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-      {
-        target_scores.push_back(pit->getScore());
-      }
-    }
-
-    for (vector<PeptideIdentification>::const_iterator it = rev_ids.begin(); it != rev_ids.end(); ++it)
-    {
-      for (vector<PeptideHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-      {
-        decoy_scores.push_back(pit->getScore());
-      }
-    }
+    vector<ScoredHit> scored_hits;
+    collectScores_(fwd_ids, false, scored_hits);
+    const Size nr_targets = scored_hits.size();
+    collectScores_(rev_ids, true, scored_hits);
 
     bool q_value = !param_.getValue("no_qvalues").toBool();
     bool higher_score_better = fwd_ids.begin()->isHigherScoreBetter();
     bool add_decoy_peptides = param_.getValue("add_decoy_peptides").toBool();
     // calculate fdr for the forward scores
-    Map<double, double> score_to_fdr;
-    calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+    vector<double> fdrs(scored_hits.size(), 0.0);
+    calculateFDRs(scored_hits, fdrs, q_value, higher_score_better);
 
     // annotate fdr
-    String score_type = fwd_ids.begin()->getScoreType() + "_score";
-    for (vector<PeptideIdentification>::iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
-    {
-      if (q_value)
-      {
-        it->setScoreType("q-value");
-      }
-      else
-      {
-        it->setScoreType("FDR");
-      }
-
-      it->setHigherScoreBetter(false);
-      vector<PeptideHit> hits = it->getHits();
-      for (vector<PeptideHit>::iterator pit = hits.begin(); pit != hits.end(); ++pit)
-      {
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << pit->getScore() << " " << score_to_fdr[pit->getScore()] << endl;
-#endif
-        pit->setMetaValue(score_type, pit->getScore());
-        pit->setScore(score_to_fdr[pit->getScore()]);
-      }
-      it->setHits(hits);
-    }
+    annotateScores_(fwd_ids, fdrs, 0, fwd_ids.begin()->getScoreType() + "_score", q_value);
     //write as well decoy peptides
     if (add_decoy_peptides)
     {
-      score_type = rev_ids.begin()->getScoreType() + "_score";
-      for (vector<PeptideIdentification>::iterator it = rev_ids.begin(); it != rev_ids.end(); ++it)
-      {
-        if (q_value)
-        {
-          it->setScoreType("q-value");
-        }
-        else
-        {
-          it->setScoreType("FDR");
-        }
-
-        it->setHigherScoreBetter(false);
-        vector<PeptideHit> hits = it->getHits();
-        for (vector<PeptideHit>::iterator pit = hits.begin(); pit != hits.end(); ++pit)
-        {
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-          cerr << pit->getScore() << " " << score_to_fdr[pit->getScore()] << endl;
-#endif
-          pit->setMetaValue(score_type, pit->getScore());
-          pit->setScore(score_to_fdr[pit->getScore()]);
-        }
-        it->setHits(hits);
-      }
+      annotateScores_(rev_ids, fdrs, nr_targets, rev_ids.begin()->getScoreType() + "_score", q_value);
     }
 
     return;
@@ -435,7 +503,7 @@ namespace OpenMS
       return;
     }
 
-    vector<double> target_scores, decoy_scores;
+    vector<ScoredHit> scored_hits;
     for (vector<ProteinIdentification>::const_iterator it = ids.begin(); it != ids.end(); ++it)
     {
       for (vector<ProteinHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
@@ -449,11 +517,11 @@ namespace OpenMS
         String target_decoy = pit->getMetaValue("target_decoy");
         if (target_decoy == "decoy")
         {
-          decoy_scores.push_back(pit->getScore());
+          scored_hits.push_back(ScoredHit(pit->getScore(), true, scored_hits.size()));
         }
         else if (target_decoy == "target")
         {
-          target_scores.push_back(pit->getScore());
+          scored_hits.push_back(ScoredHit(pit->getScore(), false, scored_hits.size()));
         }
         else
         {
@@ -466,30 +534,11 @@ namespace OpenMS
     bool higher_score_better = ids.begin()->isHigherScoreBetter();
 
     // calculate fdr for the forward scores
-    Map<double, double> score_to_fdr;
-    calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+    vector<double> fdrs(scored_hits.size(), 0.0);
+    calculateFDRs(scored_hits, fdrs, q_value, higher_score_better);
 
     // annotate fdr
-    String score_type = ids.begin()->getScoreType() + "_score";
-    for (vector<ProteinIdentification>::iterator it = ids.begin(); it != ids.end(); ++it)
-    {
-      if (q_value)
-      {
-        it->setScoreType("q-value");
-      }
-      else
-      {
-        it->setScoreType("FDR");
-      }
-      it->setHigherScoreBetter(false);
-      vector<ProteinHit> hits = it->getHits();
-      for (vector<ProteinHit>::iterator pit = hits.begin(); pit != hits.end(); ++pit)
-      {
-        pit->setMetaValue(score_type, pit->getScore());
-        pit->setScore(score_to_fdr[pit->getScore()]);
-      }
-      it->setHits(hits);
-    }
+    annotateScores_(ids, fdrs, 0, ids.begin()->getScoreType() + "_score", q_value);
 
     return;
   }
@@ -500,178 +549,52 @@ namespace OpenMS
     {
       return;
     }
-    vector<double> target_scores, decoy_scores;
-    // get the scores of all peptide hits
-    for (vector<ProteinIdentification>::const_iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
-    {
-      for (vector<ProteinHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-      {
-        target_scores.push_back(pit->getScore());
-      }
-    }
-    for (vector<ProteinIdentification>::const_iterator it = rev_ids.begin(); it != rev_ids.end(); ++it)
-    {
-      for (vector<ProteinHit>::const_iterator pit = it->getHits().begin(); pit != it->getHits().end(); ++pit)
-      {
-        decoy_scores.push_back(pit->getScore());
-      }
-    }
+    // get the scores of all protein hits
+    vector<ScoredHit> scored_hits;
+    collectScores_(fwd_ids, false, scored_hits);
+    collectScores_(rev_ids, true, scored_hits);
 
     bool q_value = !param_.getValue("no_qvalues").toBool();
     bool higher_score_better = fwd_ids.begin()->isHigherScoreBetter();
     // calculate fdr for the forward scores
-    Map<double, double> score_to_fdr;
-    calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+    vector<double> fdrs(scored_hits.size(), 0.0);
+    calculateFDRs(scored_hits, fdrs, q_value, higher_score_better);
 
     // annotate fdr
-    String score_type = fwd_ids.begin()->getScoreType() + "_score";
-    for (vector<ProteinIdentification>::iterator it = fwd_ids.begin(); it != fwd_ids.end(); ++it)
-    {
-      if (q_value)
-      {
-        it->setScoreType("q-value");
-      }
-      else
-      {
-        it->setScoreType("FDR");
-      }
-      it->setHigherScoreBetter(false);
-      vector<ProteinHit> hits = it->getHits();
-      for (vector<ProteinHit>::iterator pit = hits.begin(); pit != hits.end(); ++pit)
-      {
-        pit->setMetaValue(score_type, pit->getScore());
-        pit->setScore(score_to_fdr[pit->getScore()]);
-      }
-      it->setHits(hits);
-    }
+    annotateScores_(fwd_ids, fdrs, 0, fwd_ids.begin()->getScoreType() + "_score", q_value);
 
     return;
   }
 
-  void FalseDiscoveryRate::calculateFDRs_(Map<double, double>& score_to_fdr, vector<double>& target_scores, vector<double>& decoy_scores, bool q_value, bool higher_score_better)
+  void FalseDiscoveryRate::calculateFDRs(vector<ScoredHit>& hits, vector<double>& fdrs, bool q_value, bool higher_score_better)
   {
-    Size number_of_target_scores = target_scores.size();
-    // sort the scores
-    if (higher_score_better && !q_value)
-    {
-      sort(target_scores.rbegin(), target_scores.rend());
-      sort(decoy_scores.rbegin(), decoy_scores.rend());
-    }
-    else if (!higher_score_better && !q_value)
-    {
-      sort(target_scores.begin(), target_scores.end());
-      sort(decoy_scores.begin(), decoy_scores.end());
-    }
-    else if (higher_score_better)
-    {
-      sort(target_scores.begin(), target_scores.end());
-      sort(decoy_scores.rbegin(), decoy_scores.rend());
-    }
-    else
+    for (vector<ScoredHit>::const_iterator it = hits.begin(); it != hits.end(); ++it)
     {
-      sort(target_scores.rbegin(), target_scores.rend());
-      sort(decoy_scores.begin(), decoy_scores.end());
-    }
-
-    Size j = 0;
-
-    if (q_value)
-    {
-      double minimal_fdr = 1.;
-      for (Size i = 0; i != target_scores.size(); ++i)
+      if (it->index >= fdrs.size())
       {
-        if (decoy_scores.empty())
-        {
-          // set FDR to 0 (done below automatically)
-        }
-        else if (i == 0 && j == 0)
-        {
-          while (j != decoy_scores.size()
-                && ((target_scores[i] <= decoy_scores[j] && higher_score_better) ||
-                    (target_scores[i] >= decoy_scores[j] && !higher_score_better)))
-          {
-            ++j;
-          }
-        }
-        else
-        {
-          if (j == decoy_scores.size())
-          {
-            j--;
-          }
-          while (j != 0
-                && ((target_scores[i] > decoy_scores[j] && higher_score_better) ||
-                    (target_scores[i] < decoy_scores[j] && !higher_score_better)))
-          {
-            --j;
-          }
-          // Since j has to be equal to the number of fps above the threshold we add one
-          if ((target_scores[i] <= decoy_scores[j] && higher_score_better)
-             || (target_scores[i] >= decoy_scores[j] && !higher_score_better))
-          {
-            ++j;
-          }
-        }
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << target_scores[i] << " " << decoy_scores[j] << " " << i << " " << j << " ";
-#endif
-
-        double fdr = 0.;
-
-        if (minimal_fdr >= (double)j / (number_of_target_scores - i))
-        {
-          minimal_fdr = (double)j / (number_of_target_scores - i);
-        }
-        fdr = minimal_fdr;
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << fdr << endl;
-#endif
-        score_to_fdr[target_scores[i]] = fdr;
-
+        throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, it->index, fdrs.size());
       }
     }
-    else
+
+    // sort once; the hits of each group are contiguous afterwards
+    parallelSort(hits.begin(), hits.end(), ScoredHitLess(higher_score_better), 10000); // small inputs are not worth the threads
+    vector<Size> group_begin;
+    for (Size i = 0; i < hits.size(); ++i)
     {
-      for (Size i = 0; i != target_scores.size(); ++i)
+      if (i == 0 || hits[i].group != hits[i - 1].group)
       {
-        while (j != decoy_scores.size() &&
-               ((target_scores[i] <= decoy_scores[j] && higher_score_better) ||
-                (target_scores[i] >= decoy_scores[j] && !higher_score_better)))
-        {
-          ++j;
-        }
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << target_scores[i] << " " << decoy_scores[j] << " " << i << " " << j << " ";
-#endif
-        double fdr(0);
-
-        fdr = (double)j / (double)(i + 1);
-
-#ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << fdr << endl;
-#endif
-        score_to_fdr[target_scores[i]] = fdr;
+        group_begin.push_back(i);
       }
     }
+    group_begin.push_back(hits.size());
 
-
-    // assign q-value of decoy_score to closest target_score
-    for (Size i = 0; i != decoy_scores.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize g = 0; g < (SignedSize)group_begin.size() - 1; ++g)
     {
-      Size closest_idx = 0;
-      for (Size k = 0; k != target_scores.size(); ++k)
-      {
-        if (fabs(decoy_scores[i] - target_scores[k]) < fabs(decoy_scores[i] - target_scores[closest_idx]))
-        {
-          closest_idx = k;
-        }
-      }
-      score_to_fdr[decoy_scores[i]] = score_to_fdr[target_scores[closest_idx]];
+      calculateGroupFDRs_(hits, group_begin[g], group_begin[g + 1], fdrs, q_value);
     }
-
   }
 
 } // namespace OpenMS
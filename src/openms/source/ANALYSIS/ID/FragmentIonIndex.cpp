@@ -0,0 +1,335 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/FragmentIonIndex.h>
+
+#include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/RichPeak1D.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using std::vector;
+
+namespace OpenMS
+{
+  namespace
+  {
+    const UInt32 PEPTIDE_MASK = (1u << 30) - 1;
+    const UInt32 TYPE_SHIFT = 30;
+
+    /// relative widening of search windows, exact checks are done afterwards
+    const double WINDOW_SLACK = 1e-9;
+
+    struct FragmentLess
+    {
+      template <typename FragmentType>
+      bool operator()(const FragmentType& a, const FragmentType& b) const
+      {
+        if (a.mz != b.mz) return a.mz < b.mz;
+        return a.peptide_and_type < b.peptide_and_type;
+      }
+
+      template <typename FragmentType>
+      bool operator()(const FragmentType& a, double mz) const
+      {
+        return a.mz < mz;
+      }
+    };
+
+    /// same as MSSpectrum::findNearest, starting the search at @p hint
+    inline Size nearestPeak(const PeakSpectrum& spectrum, double mz, Size hint)
+    {
+      Size n = spectrum.size();
+      Size j = hint;
+      while (j < n && spectrum[j].getMZ() < mz) ++j;
+      while (j > 0 && spectrum[j - 1].getMZ() >= mz) --j;
+      if (j == 0) return 0;
+      if (j == n) return n - 1;
+      if (std::fabs(spectrum[j].getMZ() - mz) < std::fabs(spectrum[j - 1].getMZ() - mz))
+      {
+        return j;
+      }
+      return j - 1;
+    }
+
+    /// accumulated matches of one candidate
+    struct MatchCounts
+    {
+      MatchCounts() :
+        dot_product(0.0), b_ion_count(0), y_ion_count(0), matched(false)
+      {
+      }
+
+      double dot_product;
+      UInt b_ion_count;
+      UInt y_ion_count;
+      bool matched;
+    };
+  }
+
+  const Size FragmentIonIndex::BLOCK_SIZE;
+
+  FragmentIonIndex::FragmentIonIndex() :
+    peptides_(), masses_(), fragments_(), block_begin_(1, 0)
+  {
+  }
+
+  FragmentIonIndex::~FragmentIonIndex()
+  {
+  }
+
+  void FragmentIonIndex::build(const vector<AASequence>& peptides, const TheoreticalSpectrumGenerator& generator)
+  {
+    if (peptides.size() > PEPTIDE_MASK)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, peptides.size());
+    }
+
+    // sort candidates by mass
+    vector<std::pair<double, Size> > mass_order(peptides.size());
+    for (Size i = 0; i < peptides.size(); ++i)
+    {
+      mass_order[i] = std::make_pair(peptides[i].getMonoWeight(), i);
+    }
+    std::sort(mass_order.begin(), mass_order.end());
+
+    peptides_.resize(peptides.size());
+    masses_.resize(peptides.size());
+    for (Size i = 0; i < mass_order.size(); ++i)
+    {
+      masses_[i] = mass_order[i].first;
+      peptides_[i] = peptides[mass_order[i].second];
+    }
+
+    // generate the fragments of each block (blocks are independent)
+    Size nr_blocks = (peptides_.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    vector<vector<Fragment> > blocks(nr_blocks);
+    vector<char> missing_annotation(nr_blocks, 0); // per block, to avoid shared writes
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < (SignedSize)nr_blocks; ++b)
+    {
+      vector<Fragment>& block = blocks[b];
+      Size end = std::min(peptides_.size(), (Size)(b + 1) * BLOCK_SIZE);
+      for (Size p = (Size)b * BLOCK_SIZE; p < end; ++p)
+      {
+        RichPeakSpectrum theo_spectrum;
+        generator.getSpectrum(theo_spectrum, peptides_[p], 1);
+        for (RichPeakSpectrum::ConstIterator it = theo_spectrum.begin(); it != theo_spectrum.end(); ++it)
+        {
+          if (!it->metaValueExists("IonName"))
+          {
+            missing_annotation[b] = 1;
+            break;
+          }
+          const String ion_name = it->getMetaValue("IonName").toString();
+          UInt32 type = OTHER_ION;
+          if (ion_name[0] == 'y') type = Y_ION;
+          else if (ion_name[0] == 'b') type = B_ION;
+
+          Fragment fragment;
+          fragment.mz = it->getMZ();
+          fragment.peptide_and_type = (UInt32)p | (type << TYPE_SHIFT);
+          fragment.intensity = it->getIntensity();
+          block.push_back(fragment);
+        }
+      }
+      std::sort(block.begin(), block.end(), FragmentLess());
+    }
+
+    if (std::find(missing_annotation.begin(), missing_annotation.end(), 1) != missing_annotation.end())
+    {
+      peptides_.clear();
+      masses_.clear();
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Theoretical spectra need to be annotated with 'IonName' (set 'add_metainfo' of the spectrum generator)");
+    }
+
+    // concatenate the blocks
+    block_begin_.assign(1, 0);
+    Size nr_fragments = 0;
+    for (Size b = 0; b < nr_blocks; ++b)
+    {
+      nr_fragments += blocks[b].size();
+    }
+    fragments_.clear();
+    fragments_.reserve(nr_fragments);
+    for (Size b = 0; b < nr_blocks; ++b)
+    {
+      fragments_.insert(fragments_.end(), blocks[b].begin(), blocks[b].end());
+      vector<Fragment>().swap(blocks[b]);
+      block_begin_.push_back(fragments_.size());
+    }
+  }
+
+  void FragmentIonIndex::search(const PeakSpectrum& spectrum, double precursor_mass,
+                                double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm,
+                                double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm,
+                                vector<PeptideScore>& hits) const
+  {
+    hits.clear();
+    if (spectrum.empty() || peptides_.empty())
+    {
+      return;
+    }
+
+    // candidate range: masses m with m - 0.5 * tol(m) <= precursor_mass <= m + 0.5 * tol(m)
+    const double infinity = std::numeric_limits<double>::max();
+    double min_mass, max_mass;
+    if (precursor_mass_tolerance_unit_ppm)
+    {
+      double rel = 0.5 * precursor_mass_tolerance * 1e-6;
+      min_mass = precursor_mass / (1.0 + rel);
+      max_mass = rel < 1.0 ? precursor_mass / (1.0 - rel) : infinity;
+    }
+    else
+    {
+      min_mass = precursor_mass - 0.5 * precursor_mass_tolerance;
+      max_mass = precursor_mass + 0.5 * precursor_mass_tolerance;
+    }
+    min_mass -= std::fabs(min_mass) * WINDOW_SLACK;
+    if (max_mass != infinity) max_mass += std::fabs(max_mass) * WINDOW_SLACK;
+
+    const Size first = std::lower_bound(masses_.begin(), masses_.end(), min_mass) - masses_.begin();
+    const Size last = std::upper_bound(masses_.begin(), masses_.end(), max_mass) - masses_.begin();
+    if (first >= last)
+    {
+      return;
+    }
+
+    vector<MatchCounts> matches(last - first);
+    const Size nr_peaks = spectrum.size();
+
+    for (Size b = first / BLOCK_SIZE; b <= (last - 1) / BLOCK_SIZE; ++b)
+    {
+      vector<Fragment>::const_iterator block_end = fragments_.begin() + block_begin_[b + 1];
+      vector<Fragment>::const_iterator frag_it = fragments_.begin() + block_begin_[b];
+
+      // peaks and fragments are both sorted by m/z: merge them
+      for (Size i = 0; i < nr_peaks; ++i)
+      {
+        const double exp_mz = spectrum[i].getMZ();
+
+        // window of theoretical m/z which may match this peak
+        double min_theo, max_theo;
+        if (fragment_mass_tolerance_unit_ppm)
+        {
+          double rel = fragment_mass_tolerance * 1e-6;
+          min_theo = exp_mz / (1.0 + rel);
+          max_theo = rel < 1.0 ? exp_mz / (1.0 - rel) : infinity;
+        }
+        else
+        {
+          min_theo = exp_mz - fragment_mass_tolerance;
+          max_theo = exp_mz + fragment_mass_tolerance;
+        }
+        min_theo -= std::fabs(min_theo) * WINDOW_SLACK;
+        if (max_theo != infinity) max_theo += std::fabs(max_theo) * WINDOW_SLACK;
+
+        frag_it = std::lower_bound(frag_it, block_end, min_theo, FragmentLess());
+        for (vector<Fragment>::const_iterator it = frag_it; it != block_end && it->mz <= max_theo; ++it)
+        {
+          const Size peptide = it->peptide_and_type & PEPTIDE_MASK;
+          if (peptide < first || peptide >= last)
+          {
+            continue;
+          }
+
+          // same criterion as HyperScore::compute: the nearest experimental
+          // peak of the theoretical peak needs to be within the tolerance
+          const double theo_mz = it->mz;
+          double max_dist_dalton = fragment_mass_tolerance_unit_ppm ? theo_mz * fragment_mass_tolerance * 1e-6 : fragment_mass_tolerance;
+          if (!(std::fabs(theo_mz - exp_mz) < max_dist_dalton) || nearestPeak(spectrum, theo_mz, i) != i)
+          {
+            continue;
+          }
+
+          MatchCounts& m = matches[peptide - first];
+          m.matched = true;
+          m.dot_product += spectrum[i].getIntensity() * (double)it->intensity;
+          UInt32 type = it->peptide_and_type >> TYPE_SHIFT;
+          if (type == Y_ION) ++m.y_ion_count;
+          else if (type == B_ION) ++m.b_ion_count;
+        }
+      }
+    }
+
+    for (Size k = 0; k < matches.size(); ++k)
+    {
+      if (!matches[k].matched) continue;
+
+      // exact precursor mass criterion
+      const double mass = masses_[first + k];
+      double half_window = precursor_mass_tolerance_unit_ppm ? 0.5 * mass * precursor_mass_tolerance * 1e-6 : 0.5 * precursor_mass_tolerance;
+      if (precursor_mass < mass - half_window || precursor_mass > mass + half_window)
+      {
+        continue;
+      }
+
+      double score = HyperScore::computeFromMatches(matches[k].dot_product, matches[k].y_ion_count, matches[k].b_ion_count);
+      if (score < 1e-16)
+      {
+        continue;
+      }
+      hits.push_back(std::make_pair(first + k, score));
+    }
+  }
+
+  Size FragmentIonIndex::getNrPeptides() const
+  {
+    return peptides_.size();
+  }
+
+  Size FragmentIonIndex::getNrFragments() const
+  {
+    return fragments_.size();
+  }
+
+  const AASequence& FragmentIonIndex::getPeptide(Size index) const
+  {
+    return peptides_[index];
+  }
+
+  double FragmentIonIndex::getPeptideMass(Size index) const
+  {
+    return masses_[index];
+  }
+
+}
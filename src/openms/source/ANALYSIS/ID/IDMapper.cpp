@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
+#include <OpenMS/DATASTRUCTURES/BoundingBoxIndex.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
@@ -112,31 +113,55 @@ namespace OpenMS
     // keep track of assigned/unassigned precursors
     std::map<Size, Size> assigned_precursors;
 
-    // store which peptides fit which feature (and avoid double entries)
-    // consensusMap -> {peptide_index}
-    std::vector<std::set<size_t> > mapping(map.size());
-
-    DoubleList mz_values;
-    double rt_pep;
-    IntList charges;
+    // index the consensus features (or the range of their subelements)
+    std::vector<DBoundingBox<2> > boxes;
+    boxes.reserve(map.size());
+    for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+    {
+      DBoundingBox<2> box;
+      if (!measure_from_subelements)
+      {
+        box.enlarge(map[cm_index].getRT(), map[cm_index].getMZ());
+      }
+      else
+      {
+        for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
+             it_handle != map[cm_index].getFeatures().end();
+             ++it_handle)
+        {
+          box.enlarge(it_handle->getRT(), it_handle->getMZ());
+        }
+      }
+      boxes.push_back(box);
+    }
+    const BoundingBoxIndex index(boxes);
 
     // for statistics
     Size id_matches_none(0), id_matches_single(0), id_matches_multiple(0);
 
-    // iterate over the peptide IDs
-    for (Size i = 0; i < ids.size(); ++i)
+    // find the matching consensus features of each peptide ID (in parallel);
+    // per ID: pairs of consensus feature index and map index of the matching
+    // subelement (if "measure_from_subelements")
+    std::vector<std::vector<std::pair<Size, Size> > > id_matches(ids.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
     {
       if (ids[i].getHits().empty()) continue;
 
+      DoubleList mz_values;
+      double rt_pep;
+      IntList charges;
       getIDDetails_(ids[i], rt_pep, mz_values, charges);
 
-      bool id_mapped(false);
+      std::vector<Size> candidates;
+      index.query(getQueryBox_(rt_pep, mz_values), candidates);
 
-      // iterate over the features
-      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      // iterate over the candidate features
+      for (std::vector<Size>::const_iterator cand_it = candidates.begin(); cand_it != candidates.end(); ++cand_it)
       {
-        // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
-        bool was_added = false; // was current pep-m/z matched?!
+        const ConsensusFeature& feature = map[*cand_it];
 
         // iterate over m/z values of pepIds
         for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
@@ -160,59 +185,63 @@ namespace OpenMS
             current_charges.push_back(0); // "not specified" always matches
           }
 
+          bool was_added = false; // was current pep-m/z matched?!
+
           //check if we compare distance from centroid or subelements
           if (!measure_from_subelements)
           {
-            if (isMatch_(rt_pep - map[cm_index].getRT(), mz_pep, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge())))
+            if (isMatch_(rt_pep - feature.getRT(), mz_pep, feature.getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, feature.getCharge())))
             {
-              id_mapped = true;
               was_added = true;
-              map[cm_index].getPeptideIdentifications().push_back(ids[i]);
-              ++assigned_ids[i];
+              id_matches[i].push_back(std::make_pair(*cand_it, Size(0)));
             }
           }
           else
           {
-            for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
-                 it_handle != map[cm_index].getFeatures().end();
+            for (ConsensusFeature::HandleSetType::const_iterator it_handle = feature.getFeatures().begin();
+                 it_handle != feature.getFeatures().end();
                  ++it_handle)
             {
               if (isMatch_(rt_pep - it_handle->getRT(), mz_pep, it_handle->getMZ())  && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
               {
-                id_mapped = true;
                 was_added = true;
-                if (mapping[cm_index].count(i) == 0)
-                {
-                  // Store the map index of the peptide feature in the id the feature was mapped to.
-                  PeptideIdentification id_pep = ids[i];
-                  if (annotate_ids_with_subelements)
-                  {
-                    id_pep.setMetaValue("map_index", it_handle->getMapIndex());
-                  }
-                  
-                  map[cm_index].getPeptideIdentifications().push_back(id_pep);
-                  ++assigned_ids[i];
-                  mapping[cm_index].insert(i);
-                }
+                id_matches[i].push_back(std::make_pair(*cand_it, it_handle->getMapIndex()));
                 break; // we added this peptide already.. no need to check other handles
               }
             }
-            // continue to here
           }
 
+          // we added the whole ID with all hits, no need to check other m/z values
           if (was_added) break;
 
         } // m/z values to check
 
-        // break to here
-
       } // features
+    }
+
+    // annotate in the order of the IDs
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      if (ids[i].getHits().empty()) continue;
 
       // the id has not been mapped to any consensus feature
-      if (!id_mapped)
+      if (id_matches[i].empty())
       {
         map.getUnassignedPeptideIdentifications().push_back(ids[i]);
         ++id_matches_none;
+        continue;
+      }
+
+      for (std::vector<std::pair<Size, Size> >::const_iterator match_it = id_matches[i].begin(); match_it != id_matches[i].end(); ++match_it)
+      {
+        std::vector<PeptideIdentification>& feature_ids = map[match_it->first].getPeptideIdentifications();
+        feature_ids.push_back(ids[i]);
+        if (measure_from_subelements && annotate_ids_with_subelements)
+        {
+          // Store the map index of the peptide feature in the id the feature was mapped to.
+          feature_ids.back().setMetaValue("map_index", match_it->second);
+        }
+        ++assigned_ids[i];
       }
     } // Identifications
 
@@ -292,9 +321,13 @@ namespace OpenMS
         }
         precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
 
-        // iterate over the consensus features
-        for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+        // iterate over the candidate consensus features
+        std::vector<Size> candidates;
+        index.query(getQueryBox_(rt_value, DoubleList(1, mz_p)), candidates);
+        for (std::vector<Size>::const_iterator cand_it = candidates.begin(); cand_it != candidates.end(); ++cand_it)
         {
+          Size cm_index = *cand_it;
+
           // charge states to use for checking:
           IntList current_charges;
           if (!ignore_charge_)
@@ -403,8 +436,6 @@ namespace OpenMS
     
     // calculate feature bounding boxes only once:
     std::vector<DBoundingBox<2> > boxes;
-    double min_rt = std::numeric_limits<double>::max();
-    double max_rt = -std::numeric_limits<double>::max();
     // std::cout << "Precomputing bounding boxes..." << std::endl;
     boxes.reserve(map.size());
     for (FeatureMap::Iterator f_it = map.begin();
@@ -427,36 +458,11 @@ namespace OpenMS
       }
       increaseBoundingBox_(box);
       boxes.push_back(box);
-      
-      min_rt = std::min(min_rt, box.minPosition().getX());
-      max_rt = std::max(max_rt, box.maxPosition().getX());
-    }
-    
-    // hash bounding boxes of features by RT:
-    // RT range is partitioned into slices (bins) of 1 second; every feature
-    // that overlaps a certain slice is hashed into the corresponding bin
-    std::vector<std::vector<SignedSize> > hash_table;
-    // make sure the RT hash table has indices >= 0 and doesn't waste space
-    // in the beginning:
-    SignedSize offset(0);
-    
-    if (map.size() > 0)
-    {
-      // std::cout << "Setting up hash table..." << std::endl;
-      offset = SignedSize(floor(min_rt));
-      // this only works if features were found
-      hash_table.resize(SignedSize(floor(max_rt)) - offset + 1);
-      for (Size index = 0; index < boxes.size(); ++index)
-      {
-        const DBoundingBox<2> & box = boxes[index];
-        for (SignedSize i = SignedSize(floor(box.minPosition().getX()));
-             i <= SignedSize(floor(box.maxPosition().getX())); ++i)
-        {
-          hash_table[i - offset].push_back(index);
-        }
-      }
     }
-    else
+
+    // spatial index over the bounding boxes of the features
+    const BoundingBoxIndex index(boxes);
+    if (map.empty())
     {
       LOG_WARN << "IDMapper received an empty FeatureMap! All peptides are mapped as 'unassigned'!" << std::endl;
     }
@@ -465,34 +471,33 @@ namespace OpenMS
     Size matches_none = 0, matches_single = 0, matches_multi = 0;
     
     // std::cout << "Finding matches..." << std::endl;
-    // iterate over peptide IDs:
-    for (std::vector<PeptideIdentification>::const_iterator id_it =
-         ids.begin(); id_it != ids.end(); ++id_it)
+    // find the matching features of each peptide ID (in parallel); the
+    // annotation is done afterwards in the order of the IDs
+    std::vector<std::vector<Size> > id_matches(ids.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize id_index = 0; id_index < (SignedSize)ids.size(); ++id_index)
     {
-      // std::cout << "Peptide ID: " << id_it - ids.begin() << std::endl;
-
-      if (id_it->getHits().empty()) continue;
+      const PeptideIdentification& id = ids[id_index];
+      if (id.getHits().empty()) continue;
 
       DoubleList mz_values;
       double rt_value;
       IntList charges;
-      getIDDetails_(*id_it, rt_value, mz_values, charges, use_avg_mass);
-      
-      if ((rt_value < min_rt) || (rt_value > max_rt))             // RT out of bounds
-      {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
-        ++matches_none;
-        continue;
-      }
+      getIDDetails_(id, rt_value, mz_values, charges, use_avg_mass);
       
+      // candidate features: bounding box encloses the ID at one of its m/z values
+      std::vector<Size> candidates;
+      index.query(DBoundingBox<2>(DPosition<2>(rt_value, *std::min_element(mz_values.begin(), mz_values.end())),
+                                  DPosition<2>(rt_value, *std::max_element(mz_values.begin(), mz_values.end()))),
+                  candidates);
+
       // iterate over candidate features:
-      Size index = SignedSize(floor(rt_value)) - offset;
-      Size matching_features = 0;
-      for (std::vector<SignedSize>::iterator hash_it =
-           hash_table[index].begin(); hash_it != hash_table[index].end();
-           ++hash_it)
+      for (std::vector<Size>::const_iterator cand_it = candidates.begin();
+           cand_it != candidates.end(); ++cand_it)
       {
-        Feature & feat = map[*hash_it];
+        const Feature& feat = map[*cand_it];
         
         // need to check the charge state?
         bool check_charge = !ignore_charge_;
@@ -504,7 +509,7 @@ namespace OpenMS
         
         // iterate over m/z values (only one if "mz_ref." is "precursor"):
         Size l_index = 0;
-        for (DoubleList::iterator mz_it = mz_values.begin();
+        for (DoubleList::const_iterator mz_it = mz_values.begin();
              mz_it != mz_values.end(); ++mz_it, ++l_index)
         {
           if (check_charge && (charges[l_index] != feat.getCharge()))
@@ -513,19 +518,18 @@ namespace OpenMS
           }
           
           DPosition<2> id_pos(rt_value, *mz_it);
-          if (boxes[*hash_it].encloses(id_pos))                 // potential match
+          if (boxes[*cand_it].encloses(id_pos))                 // potential match
           {
             if (use_centroid_mz)
             {
               // only one m/z value to check, which was already incorporated
               // into the overall bounding box -> success!
-              feat.getPeptideIdentifications().push_back(*id_it);
-              ++matching_features;
+              id_matches[id_index].push_back(*cand_it);
               break;                     // "mz_it" loop
             }
             // else: check all the mass traces
             bool found_match = false;
-            for (std::vector<ConvexHull2D>::iterator ch_it =
+            for (std::vector<ConvexHull2D>::const_iterator ch_it =
                  feat.getConvexHulls().begin(); ch_it !=
                  feat.getConvexHulls().end(); ++ch_it)
             {
@@ -538,8 +542,7 @@ namespace OpenMS
               increaseBoundingBox_(box);
               if (box.encloses(id_pos)) // success!
               {
-                feat.getPeptideIdentifications().push_back(*id_it);
-                ++matching_features;
+                id_matches[id_index].push_back(*cand_it);
                 found_match = true;
                 break; // "ch_it" loop
               }
@@ -548,12 +551,25 @@ namespace OpenMS
           }
         }
       }
-      if (matching_features == 0)
+    }
+
+    // annotate in the order of the IDs
+    for (Size id_index = 0; id_index < ids.size(); ++id_index)
+    {
+      if (ids[id_index].getHits().empty()) continue;
+
+      const std::vector<Size>& matching_features = id_matches[id_index];
+      for (std::vector<Size>::const_iterator match_it = matching_features.begin();
+           match_it != matching_features.end(); ++match_it)
+      {
+        map[*match_it].getPeptideIdentifications().push_back(ids[id_index]);
+      }
+      if (matching_features.empty())
       {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
+        map.getUnassignedPeptideIdentifications().push_back(ids[id_index]);
         ++matches_none;
       }
-      else if (matching_features == 1) 
+      else if (matching_features.size() == 1) 
       {
         ++matches_single;
       }
@@ -607,14 +623,10 @@ namespace OpenMS
         double rt_value = spectrum.getRT();
         int z_p = precursors[i_p].getCharge();
 
-        if ((rt_value < min_rt) || (rt_value > max_rt)) // RT out of bounds
-        {
-          ++spectrum_matches_none;
-          continue;
-        }
-      
         // iterate over candidate features:
-        Size index = SignedSize(floor(rt_value)) - offset;
+        DPosition<2> id_pos(rt_value, mz_p);
+        std::vector<Size> candidates;
+        index.query(id_pos, candidates);
         Size matching_features = 0;
 
         PeptideIdentification precursor_empty_id;
@@ -628,11 +640,10 @@ namespace OpenMS
         precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
         //precursor_empty_id.setCharge(z_p);
 
-        for (std::vector<SignedSize>::iterator hash_it =
-           hash_table[index].begin(); hash_it != hash_table[index].end();
-           ++hash_it)
+        for (std::vector<Size>::const_iterator cand_it =
+           candidates.begin(); cand_it != candidates.end(); ++cand_it)
         {
-          Feature & feat = map[*hash_it];
+          Feature & feat = map[*cand_it];
         
           // (optinally) check charge state
           if (!ignore_charge_)
@@ -640,9 +651,7 @@ namespace OpenMS
             if (z_p != feat.getCharge()) continue;
           }
         
-          DPosition<2> id_pos(rt_value, mz_p);
-
-          if (boxes[*hash_it].encloses(id_pos)) // potential match
+          if (boxes[*cand_it].encloses(id_pos)) // potential match
           {
             if (use_centroid_mz)
             {
@@ -777,7 +786,7 @@ namespace OpenMS
     }
   }
 
-  void IDMapper::increaseBoundingBox_(DBoundingBox<2>& box)
+  void IDMapper::increaseBoundingBox_(DBoundingBox<2>& box) const
   {
     DPosition<2> sub_min(rt_tolerance_,
                          getAbsoluteMZTolerance_(box.minPosition().getY())),
@@ -787,6 +796,21 @@ namespace OpenMS
     box.setMax(box.maxPosition() + add_max);
   }
 
+  DBoundingBox<2> IDMapper::getQueryBox_(const double rt, const DoubleList& mz_values) const
+  {
+    double min_mz = *std::min_element(mz_values.begin(), mz_values.end());
+    double max_mz = *std::max_element(mz_values.begin(), mz_values.end());
+    // slightly enlarge the tolerances, so rounding cannot exclude borderline
+    // matches (candidates are checked with isMatch_() anyway)
+    const double margin = 1.0 + 1e-6;
+    DPosition<2> sub_min(rt_tolerance_ * margin + 1e-9,
+                         getAbsoluteMZTolerance_(min_mz) * margin + 1e-9),
+    add_max(rt_tolerance_ * margin + 1e-9, getAbsoluteMZTolerance_(max_mz) * margin + 1e-9);
+
+    return DBoundingBox<2>(DPosition<2>(rt, min_mz) - sub_min,
+                           DPosition<2>(rt, max_mz) + add_max);
+  }
+
   bool IDMapper::checkMassType_(const vector<DataProcessing>& processing) const
   {
     bool use_avg_mass = false;
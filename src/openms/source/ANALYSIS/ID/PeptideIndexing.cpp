@@ -34,6 +34,7 @@
 
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArrayIndex.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Macros.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
@@ -44,6 +45,9 @@
 #include <OpenMS/METADATA/PeptideEvidence.h>
 #include <OpenMS/CHEMISTRY/EnzymesDB.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+
+#include <QtCore/QDateTime>
 
 #include <algorithm>
 
@@ -365,6 +369,32 @@ public:
   }
 }
 
+namespace
+{
+  /// FNV-1a hash of @p data (terminated by a separator), continuing from @p hash
+  OpenMS::UInt64 hashString_(OpenMS::UInt64 hash, const OpenMS::String& data)
+  {
+    for (OpenMS::String::const_iterator it = data.begin(); it != data.end(); ++it)
+    {
+      hash = (hash ^ (unsigned char)*it) * 0x100000001B3ULL;
+    }
+    return (hash ^ 0xFFu) * 0x100000001B3ULL;
+  }
+
+  /// Protein @p index, either from @p proteins or (if @p index_db is given) from the protein index (cached in @p cache)
+  const OpenMS::FASTAFile::FASTAEntry& proteinEntry_(const std::vector<OpenMS::FASTAFile::FASTAEntry>& proteins, const OpenMS::ProteinSuffixArrayIndex* index_db,
+                                                     OpenMS::Map<OpenMS::Size, OpenMS::FASTAFile::FASTAEntry>& cache, OpenMS::Size index)
+  {
+    if (index_db == 0) return proteins[index];
+    OpenMS::Map<OpenMS::Size, OpenMS::FASTAFile::FASTAEntry>::iterator it = cache.find(index);
+    if (it == cache.end())
+    {
+      it = cache.insert(std::make_pair(index, index_db->getEntry(index))).first;
+    }
+    return it->second;
+  }
+}
+
 PeptideIndexing::PeptideIndexing() :
 DefaultParamHandler("PeptideIndexing")
   {
@@ -419,6 +449,8 @@ DefaultParamHandler("PeptideIndexing")
     defaults_.setValue("filter_aaa_proteins", "false", "In the tolerant search for matches to proteins with ambiguous amino acids (AAAs), rebuild the search database to only consider proteins with AAAs. This may save time if most proteins don't contain AAAs and if there is a significant number of peptides that enter the tolerant search.");
     defaults_.setValidStrings("filter_aaa_proteins", ListUtils::create<String>("true,false"));
 
+    defaults_.setValue("index_file", "", "Persistent protein index (memory-mapped suffix array) of the database. If the file does not exist or was built for a different database or different 'IL_equivalent'/decoy settings, it is (re)built and stored there. Subsequent runs only map the index into memory, which avoids preparing the database for every search. The database is identified by a checksum of its content, so the FASTA file is still read once per run (much faster than parsing it), but a modified database is always detected.");
+
     defaults_.setValue("log", "", "Name of log file (created only when specified)");
     defaults_.setValue("debug", 0, "Sets the debug level");
 
@@ -447,6 +479,68 @@ DefaultParamHandler("PeptideIndexing")
     }
   }
 
+  UInt64 PeptideIndexing::settingsKey_() const
+  {
+    UInt64 key = 0xCBF29CE484222325ULL;
+    return hashString_(key, String(IL_equivalent_ ? "IL" : "") + "|" + (prefix_ ? "prefix" : "suffix") + "|" + decoy_string_);
+  }
+
+  UInt64 PeptideIndexing::fileKey_(const String& fasta_file) const
+  {
+    // a checksum of the content (instead of e.g. the modification time) never
+    // reuses a stale index and finds the index for a copy of the database, too
+    return hashString_(settingsKey_(), FileHandler::computeFileHash(fasta_file));
+  }
+
+  bool PeptideIndexing::openProteinIndex_(UInt64 key)
+  {
+    if (protein_index_ && protein_index_->getKey() == key && protein_index_->getFilename() == index_file_)
+    {
+      writeDebug_("Reusing protein index '" + index_file_ + "'.", 1);
+      return true;
+    }
+    protein_index_.reset();
+
+    UInt64 stored_key;
+    if (!ProteinSuffixArrayIndex::readKey(index_file_, stored_key) || stored_key != key)
+    {
+      return false;
+    }
+    try
+    {
+      protein_index_ = boost::shared_ptr<ProteinSuffixArrayIndex>(new ProteinSuffixArrayIndex(index_file_));
+    }
+    catch (Exception::BaseException& e)
+    {
+      LOG_WARN << "Warning: Protein index '" << index_file_ << "' cannot be used (" << e.getMessage() << "), rebuilding it." << std::endl;
+      return false;
+    }
+    if (!protein_index_->hasEntries()) // not built by PeptideIndexing
+    {
+      protein_index_.reset();
+      return false;
+    }
+    writeDebug_("Using protein index '" + index_file_ + "'.", 1);
+    return true;
+  }
+
+  void PeptideIndexing::buildProteinIndex_(UInt64 key, const vector<FASTAFile::FASTAEntry>& proteins, const vector<String>& sequences)
+  {
+    writeLog_("Building protein index '" + index_file_ + "' (only required once for this database and these settings)...");
+    StopWatch sw;
+    sw.start();
+    vector<bool> is_decoy(proteins.size());
+    for (Size i = 0; i < proteins.size(); ++i)
+    {
+      const String& acc = proteins[i].identifier;
+      is_decoy[i] = (prefix_ && acc.hasPrefix(decoy_string_)) || (!prefix_ && acc.hasSuffix(decoy_string_));
+    }
+    ProteinSuffixArrayIndex::build(index_file_, sequences, is_decoy, key, proteins);
+    sw.stop();
+    writeLog_(String("... done (time: ") + sw.getClockTime() + " s (wall), " + sw.getCPUTime() + " s (CPU)).");
+    protein_index_ = boost::shared_ptr<ProteinSuffixArrayIndex>(new ProteinSuffixArrayIndex(index_file_));
+  }
+
   void PeptideIndexing::updateMembers_()
   {
     decoy_string_ = static_cast<String>(param_.getValue("decoy_string"));
@@ -465,12 +559,35 @@ DefaultParamHandler("PeptideIndexing")
     aaa_max_ = static_cast<Size>(param_.getValue("aaa_max"));
     mismatches_max_ = static_cast<Size>(param_.getValue("mismatches_max"));
     filter_aaa_proteins_ = param_.getValue("filter_aaa_proteins").toBool();
+    index_file_ = param_.getValue("index_file");
+    if (protein_index_ && protein_index_->getFilename() != index_file_)
+    {
+      protein_index_.reset();
+    }
 
     log_file_ = param_.getValue("log");
     debug_ = static_cast<Size>(param_.getValue("debug")) > 0;
   }
 
+ PeptideIndexing::ExitCodes PeptideIndexing::run(const String& fasta_file, vector<ProteinIdentification>& prot_ids, vector<PeptideIdentification>& pep_ids)
+  {
+    vector<FASTAFile::FASTAEntry> proteins;
+    if (!index_file_.empty() && openProteinIndex_(fileKey_(fasta_file)))
+    {
+      // the index stores the FASTA entries: neither load nor prepare the database
+      return run_(proteins, fasta_file, true, prot_ids, pep_ids);
+    }
+    FASTAFile().load(fasta_file, proteins);
+    return run_(proteins, fasta_file, false, prot_ids, pep_ids);
+  }
+
  PeptideIndexing::ExitCodes PeptideIndexing::run(vector<FASTAFile::FASTAEntry>& proteins, vector<ProteinIdentification>& prot_ids, vector<PeptideIdentification>& pep_ids)
+  {
+    return run_(proteins, "", false, prot_ids, pep_ids);
+  }
+
+ PeptideIndexing::ExitCodes PeptideIndexing::run_(vector<FASTAFile::FASTAEntry>& proteins, const String& fasta_file, bool index_only,
+                                                  vector<ProteinIdentification>& prot_ids, vector<PeptideIdentification>& pep_ids)
   {
     //-------------------------------------------------------------
     // parsing parameters
@@ -489,7 +606,8 @@ DefaultParamHandler("PeptideIndexing")
     // calculations
     //-------------------------------------------------------------
 
-    if (proteins.empty()) // we do not allow an empty database
+    const Size nr_proteins = index_only ? protein_index_->getNrProteins() : proteins.size();
+    if (nr_proteins == 0) // we do not allow an empty database
     {
       LOG_ERROR << "Error: An empty database was provided. Mapping makes no sense. Aborting..." << std::endl;
       return DATABASE_EMPTY;
@@ -524,7 +642,21 @@ DefaultParamHandler("PeptideIndexing")
 
       vector<String> duplicate_accessions;
 
-      for (Size i = 0; i != proteins.size(); ++i)
+      if (index_only)
+      {
+        // accessions are only required to update existing protein hits
+        bool has_protein_hits = false;
+        for (Size run_idx = 0; run_idx < prot_ids.size(); ++run_idx)
+        {
+          has_protein_hits |= !prot_ids[run_idx].getHits().empty();
+        }
+        for (Size i = 0; has_protein_hits && i < nr_proteins; ++i)
+        {
+          acc_to_prot[protein_index_->getAccession(i)] = i;
+        }
+      }
+
+      for (Size i = 0; !index_only && i != proteins.size(); ++i)
       {
         String seq = proteins[i].sequence.remove('*');
         if (IL_equivalent_) // convert  L to I; warning: do not use 'J', since Seqan does not know about it and will convert 'J' to 'X'
@@ -585,7 +717,7 @@ DefaultParamHandler("PeptideIndexing")
         }
       }
 
-      writeLog_(String("Mapping ") + length(pep_DB) + " peptides to " + length(prot_DB) + " proteins.");
+      writeLog_(String("Mapping ") + length(pep_DB) + " peptides to " + (index_only ? protein_index_->getNrProteins() : length(prot_DB)) + " proteins.");
 
       bool SA_only = param_.getValue("full_tolerant_search").toBool();
 
@@ -603,8 +735,95 @@ DefaultParamHandler("PeptideIndexing")
         return ILLEGAL_PARAMETERS;
       }
 
+      if (!index_file_.empty() && !index_only)
+      {
+        // the key covers everything that influences the content of the index:
+        // the identity of the FASTA file or, for databases in memory, all entries
+        UInt64 key;
+        if (!fasta_file.empty())
+        {
+          key = fileKey_(fasta_file);
+        }
+        else
+        {
+          key = settingsKey_();
+          for (Size i = 0; i < proteins.size(); ++i)
+          {
+            key = hashString_(key, proteins[i].identifier);
+            key = hashString_(key, proteins[i].description);
+            key = hashString_(key, proteins[i].sequence);
+          }
+        }
+        if (!openProteinIndex_(key))
+        {
+          vector<String> sequences(length(prot_DB));
+          for (Size i = 0; i < sequences.size(); ++i)
+          {
+            sequences[i] = String(begin(prot_DB[i]), end(prot_DB[i]));
+          }
+          buildProteinIndex_(key, proteins, sequences);
+        }
+      }
+
+      /** use the persistent protein index -- exact matching first, tolerant matching for peptides without hit */
+      if (protein_index_)
+      {
+        StopWatch sw;
+        sw.start();
+        const ProteinSuffixArrayIndex& index = *protein_index_;
+        const bool tolerant = (aaa_max_ > 0) || (mismatches_max_ > 0);
+        const SignedSize pepDB_length = (SignedSize) length(pep_DB);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+          seqan::FoundProteinFunctor func_threads(enzyme);
+          vector<ProteinSuffixArrayIndex::Occurrence> hits;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+          for (SignedSize i = 0; i < pepDB_length; ++i)
+          {
+            const String seq_pep(begin(pep_DB[i]), end(pep_DB[i]));
+            if (!SA_only)
+            {
+              index.findExact(seq_pep, hits);
+              for (Size j = 0; j < hits.size(); ++j)
+              {
+                func_threads.addHit(i, hits[j].protein_index, seq_pep, index.getProteinSequence(hits[j].protein_index), hits[j].position);
+              }
+              if (func_threads.pep_to_prot.has(i) || !tolerant) continue;
+            }
+            index.findTolerant(seq_pep, aaa_max_, mismatches_max_, hits);
+            for (Size j = 0; j < hits.size(); ++j)
+            {
+              // after the exact search, only proteins with ambiguous AA's are of interest (if requested)
+              if (!SA_only && filter_aaa_proteins_ && !index.hasAmbiguousAA(hits[j].protein_index)) continue;
+              func_threads.addHit(i, hits[j].protein_index, seq_pep, index.getProteinSequence(hits[j].protein_index), hits[j].position);
+            }
+          }
+
+          // join results again
+#ifdef _OPENMP
+#pragma omp critical(PeptideIndexer_joinIndex)
+#endif
+          {
+            func.filter_passed += func_threads.filter_passed;
+            func.filter_rejected += func_threads.filter_rejected;
+            for (seqan::FoundProteinFunctor::MapType::const_iterator it = func_threads.pep_to_prot.begin(); it != func_threads.pep_to_prot.end(); ++it)
+            {
+              func.pep_to_prot[it->first].insert(it->second.begin(), it->second.end());
+            }
+          }
+        } // end parallel
+
+        sw.stop();
+
+        writeLog_(String("\nProtein index search done:\n  found ") + func.filter_passed + " hits for " + func.pep_to_prot.size() + " of " + length(pep_DB) + " peptides (time: " + sw.getClockTime() + " s (wall), " + sw.getCPUTime() + " s (CPU)).");
+      }
       /** first, try Aho Corasick (fast) -- using exact matching only */
-      if (!SA_only)
+      else if (!SA_only)
       {
         StopWatch sw;
         sw.start();
@@ -658,7 +877,7 @@ DefaultParamHandler("PeptideIndexing")
 
       /// now, search using a suffix array -- allows approximate matching:
       /// check if every peptide was found:
-      if ((func.pep_to_prot.size() != length(pep_DB)) &&
+      if (!protein_index_ && (func.pep_to_prot.size() != length(pep_DB)) &&
           ((aaa_max_> 0) || (mismatches_max_ > 0)))
       {
         // search using SA, which supports mismatches (introduced by resolving ambiguous AA's by e.g. Mascot) -- expensive!
@@ -814,6 +1033,10 @@ DefaultParamHandler("PeptideIndexing")
     Size stats_count_m_td(0);
     Map<Size, set<Size> > runidx_to_protidx; // in which protID do appear which proteins (according to mapped peptides)
 
+    /// entries of the referenced proteins (only used if the database was not loaded)
+    const ProteinSuffixArrayIndex* index_db = index_only ? protein_index_.get() : 0;
+    Map<Size, FASTAFile::FASTAEntry> index_entries;
+
     Size pep_idx(0);
     for (vector<PeptideIdentification>::iterator it1 = pep_ids.begin(); it1 != pep_ids.end(); ++it1)
     {
@@ -831,7 +1054,7 @@ DefaultParamHandler("PeptideIndexing")
         for (set<PeptideProteinMatchInformation>::const_iterator it_i = func.pep_to_prot[pep_idx].begin();
              it_i != func.pep_to_prot[pep_idx].end(); ++it_i)
         {
-          const String& accession = proteins[it_i->protein_index].identifier;
+          const String& accession = proteinEntry_(proteins, index_db, index_entries, it_i->protein_index).identifier;
           PeptideEvidence pe;
           pe.setProteinAccession(accession);
           pe.setStart(it_i->position);
@@ -844,7 +1067,14 @@ DefaultParamHandler("PeptideIndexing")
 
           if (!protein_is_decoy.has(accession))
           {
-            protein_is_decoy[accession] = (prefix_ && accession.hasPrefix(decoy_string_)) || (!prefix_ && accession.hasSuffix(decoy_string_));
+            if (protein_index_)
+            {
+              protein_is_decoy[accession] = protein_index_->isDecoy(it_i->protein_index);
+            }
+            else
+            {
+              protein_is_decoy[accession] = (prefix_ && accession.hasPrefix(decoy_string_)) || (!prefix_ && accession.hasSuffix(decoy_string_));
+            }
           }
         }
 
@@ -963,13 +1193,13 @@ DefaultParamHandler("PeptideIndexing")
           String seq;
           if (write_protein_sequence_)
           {
-            seq = proteins[acc_to_prot[acc]].sequence;
+            seq = proteinEntry_(proteins, index_db, index_entries, acc_to_prot[acc]).sequence;
           }
           p_hit->setSequence(seq);
 
           if (write_protein_description_)
           {
-            const String& description = proteins[acc_to_prot[acc]].description;
+            const String& description = proteinEntry_(proteins, index_db, index_entries, acc_to_prot[acc]).description;
             //std::cout << "Description = " << description << "\n";
             p_hit->setDescription(description);
           }
@@ -988,17 +1218,18 @@ DefaultParamHandler("PeptideIndexing")
       for (set<Size>::const_iterator it = masterset.begin();
            it != masterset.end(); ++it)
       {
+        const FASTAFile::FASTAEntry& protein = proteinEntry_(proteins, index_db, index_entries, *it);
         ProteinHit hit;
-        hit.setAccession(proteins[*it].identifier);
+        hit.setAccession(protein.identifier);
         if (write_protein_sequence_)
         {
-          hit.setSequence(proteins[*it].sequence);
+          hit.setSequence(protein.sequence);
         }
 
         if (write_protein_description_)
         {
-          //std::cout << "Description = " << proteins[*it].description << "\n";
-          hit.setDescription(proteins[*it].description);
+          //std::cout << "Description = " << protein.description << "\n";
+          hit.setDescription(protein.description);
         }
 
         new_protein_hits.push_back(hit);
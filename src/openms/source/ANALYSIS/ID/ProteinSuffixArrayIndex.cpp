@@ -0,0 +1,564 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArrayIndex.h>
+
+#include <OpenMS/CONCEPT/Macros.h>
+#include <OpenMS/CONCEPT/ParallelSort.h>
+#include <OpenMS/FORMAT/HANDLERS/MappedFileHelper.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace OpenMS
+{
+  const UInt64 ProteinSuffixArrayIndex::FILE_IDENTIFIER = 0x3141535452504D4FULL; // "OMPRTSA1"
+  const UInt32 ProteinSuffixArrayIndex::FILE_VERSION = 2;
+  const Size ProteinSuffixArrayIndex::HEADER_SIZE = Internal::MappedFileHelper::HEADER_SIZE;
+
+  namespace
+  {
+    const Size SECTION_ALIGNMENT = Internal::MappedFileHelper::DATA_ALIGNMENT;
+
+    const Byte FLAG_DECOY = 1;
+    const Byte FLAG_AMBIGUOUS = 2;
+
+    /// Header stored at the beginning of the file
+    struct Header
+    {
+      UInt64 file_identifier;
+      UInt32 file_version;
+      UInt32 reserved;
+      UInt64 key;
+      UInt64 nr_proteins;
+      UInt64 text_offset;
+      UInt64 text_length;
+      UInt64 offsets_offset;
+      UInt64 flags_offset;
+      UInt64 entry_offsets_offset;
+      UInt64 entries_offset;
+      UInt64 entries_length;
+      UInt64 sa_offset;
+      UInt64 sa_length;
+    };
+
+    /// Lookup tables for the amino acid alphabet (equivalence classes as used by PeptideIndexing)
+    struct AlphabetTables
+    {
+      char normalized[256];
+      UInt32 classes[256];
+
+      AlphabetTables()
+      {
+        const char* letters = "ARNDCQEGHILKMFPSTWYV";
+        for (Size i = 0; i < 256; ++i)
+        {
+          normalized[i] = 'X';
+          classes[i] = 0;
+        }
+        for (Size i = 0; i < 20; ++i)
+        {
+          setLetter_(letters[i], 1u << i);
+        }
+        setLetter_('B', classes[(unsigned char)'D'] | classes[(unsigned char)'N']);
+        setLetter_('Z', classes[(unsigned char)'E'] | classes[(unsigned char)'Q']);
+        setLetter_('X', ~0u);
+        setLetter_('*', ~0u);
+        normalized[0] = '\0';
+      }
+
+      void setLetter_(char letter, UInt32 equivalence_class)
+      {
+        normalized[(unsigned char)letter] = letter;
+        normalized[(unsigned char)std::tolower(letter)] = letter;
+        classes[(unsigned char)letter] = equivalence_class;
+      }
+    };
+
+    const AlphabetTables& alphabet_()
+    {
+      static const AlphabetTables tables;
+      return tables;
+    }
+
+    inline bool isAmbiguous_(char c)
+    {
+      return c == 'B' || c == 'Z' || c == 'X';
+    }
+
+    /// Lexicographical order of the suffixes (each ending at the next terminator), ties broken by position
+    struct SuffixLess
+    {
+      explicit SuffixLess(const char* text) :
+        text_(text)
+      {
+      }
+
+      bool operator()(UInt64 a, UInt64 b) const
+      {
+        int cmp = std::strcmp(text_ + a, text_ + b);
+        return cmp < 0 || (cmp == 0 && a < b);
+      }
+
+      const char* text_;
+    };
+
+    /// Compares the first @p length characters of a suffix with a peptide
+    struct PrefixCompare
+    {
+      PrefixCompare(const char* text, const String& peptide) :
+        text_(text),
+        peptide_(peptide.c_str()),
+        length_(peptide.size())
+      {
+      }
+
+      bool operator()(UInt64 suffix, const String&) const // suffix < peptide
+      {
+        return std::strncmp(text_ + suffix, peptide_, length_) < 0;
+      }
+
+      bool operator()(const String&, UInt64 suffix) const // peptide < suffix
+      {
+        return std::strncmp(text_ + suffix, peptide_, length_) > 0;
+      }
+
+      const char* text_;
+      const char* peptide_;
+      Size length_;
+    };
+
+    /// Compares the character at offset @p depth of a suffix with a given character
+    struct CharAtCompare
+    {
+      CharAtCompare(const char* text, Size depth) :
+        text_(text),
+        depth_(depth)
+      {
+      }
+
+      bool operator()(char c, UInt64 suffix) const
+      {
+        return (unsigned char)c < (unsigned char)text_[suffix + depth_];
+      }
+
+      const char* text_;
+      Size depth_;
+    };
+  }
+
+  ProteinSuffixArrayIndex::ProteinSuffixArrayIndex(const String& filename) :
+    filename_(filename),
+    key_(0),
+    nr_proteins_(0),
+    sa_length_(0),
+    text_(0),
+    protein_offsets_(0),
+    flags_(0),
+    entry_offsets_(0),
+    entries_(0),
+    suffix_array_(0)
+  {
+    Internal::MappedFileHelper::mapFile(file_, filename);
+    const char* data = file_.data();
+    const Size file_size = file_.size();
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    if (file_size >= sizeof(Header))
+    {
+      std::memcpy(&header, data, sizeof(Header));
+    }
+    if (header.file_identifier != FILE_IDENTIFIER || header.file_version != FILE_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename,
+        "File is not a protein index of format version " + String(FILE_VERSION) + ". Aborting!");
+    }
+    if (!Internal::MappedFileHelper::readTrailer(file_, FILE_IDENTIFIER) ||
+        header.text_offset != HEADER_SIZE ||
+        header.offsets_offset < header.text_offset + header.text_length ||
+        header.flags_offset < header.offsets_offset + (header.nr_proteins + 1) * sizeof(UInt64) ||
+        header.entry_offsets_offset < header.flags_offset + header.nr_proteins ||
+        header.entry_offsets_offset % sizeof(UInt64) != 0 ||
+        header.entries_offset < header.entry_offsets_offset + (header.nr_proteins + 1) * sizeof(UInt64) ||
+        header.sa_offset < header.entries_offset + header.entries_length ||
+        header.sa_offset % sizeof(UInt64) != 0 ||
+        header.sa_offset + header.sa_length * sizeof(UInt64) + sizeof(UInt64) != file_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename,
+        "File is truncated or corrupt. Aborting!");
+    }
+
+    key_ = header.key;
+    nr_proteins_ = header.nr_proteins;
+    sa_length_ = header.sa_length;
+    text_ = data + header.text_offset;
+    protein_offsets_ = reinterpret_cast<const UInt64*>(data + header.offsets_offset);
+    flags_ = reinterpret_cast<const Byte*>(data + header.flags_offset);
+    entry_offsets_ = reinterpret_cast<const UInt64*>(data + header.entry_offsets_offset);
+    entries_ = data + header.entries_offset;
+    suffix_array_ = reinterpret_cast<const UInt64*>(data + header.sa_offset);
+
+    // the protein boundaries are used to resolve every hit, make sure they are sane
+    if (protein_offsets_[0] != 0 || protein_offsets_[nr_proteins_] != header.text_length ||
+        sa_length_ + nr_proteins_ != header.text_length)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename,
+        "Invalid protein offsets found. Aborting!");
+    }
+    if (entry_offsets_[0] != 0 || entry_offsets_[nr_proteins_] != header.entries_length)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename,
+        "Invalid entry offsets found. Aborting!");
+    }
+    for (Size i = 0; i < nr_proteins_; ++i)
+    {
+      if (protein_offsets_[i + 1] <= protein_offsets_[i] || text_[protein_offsets_[i + 1] - 1] != '\0')
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename,
+          String("Invalid offset of protein ") + i + " found. Aborting!");
+      }
+      // each entry holds three zero-terminated strings (or nothing, if no entries were stored)
+      if (header.entries_length != 0 &&
+          (entry_offsets_[i + 1] < entry_offsets_[i] + 3 || entries_[entry_offsets_[i + 1] - 1] != '\0'))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename,
+          String("Invalid FASTA entry of protein ") + i + " found. Aborting!");
+      }
+    }
+  }
+
+  ProteinSuffixArrayIndex::~ProteinSuffixArrayIndex()
+  {
+    if (file_.is_open())
+    {
+      file_.close();
+    }
+  }
+
+  void ProteinSuffixArrayIndex::build(const String& filename, const std::vector<String>& proteins, const std::vector<bool>& is_decoy, UInt64 key,
+                                      const std::vector<FASTAFile::FASTAEntry>& entries)
+  {
+    if (proteins.size() != is_decoy.size())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, is_decoy.size());
+    }
+    if (!entries.empty() && proteins.size() != entries.size())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, entries.size());
+    }
+
+    // FASTA entries: identifier, description and sequence, each terminated by '\0'
+    std::vector<UInt64> entry_offsets(proteins.size() + 1, 0);
+    String entry_text;
+    for (Size i = 0; i < entries.size(); ++i)
+    {
+      entry_text.append(entries[i].identifier.c_str(), entries[i].identifier.size() + 1);
+      entry_text.append(entries[i].description.c_str(), entries[i].description.size() + 1);
+      entry_text.append(entries[i].sequence.c_str(), entries[i].sequence.size() + 1);
+      entry_offsets[i + 1] = entry_text.size();
+    }
+
+    // concatenate all (normalized) sequences, each terminated by '\0'
+    std::vector<UInt64> offsets(proteins.size() + 1, 0);
+    std::vector<Byte> flags(proteins.size(), 0);
+    for (Size i = 0; i < proteins.size(); ++i)
+    {
+      offsets[i + 1] = offsets[i] + proteins[i].size() + 1;
+    }
+    std::vector<char> text(offsets.back());
+    std::vector<UInt64> suffix_array;
+    suffix_array.reserve(text.size() - proteins.size());
+    for (Size i = 0; i < proteins.size(); ++i)
+    {
+      String seq = proteins[i];
+      normalizeSequence(seq);
+      flags[i] = is_decoy[i] ? FLAG_DECOY : 0;
+      for (Size j = 0; j < seq.size(); ++j)
+      {
+        text[offsets[i] + j] = seq[j];
+        suffix_array.push_back(offsets[i] + j);
+        if (isAmbiguous_(seq[j]))
+        {
+          flags[i] |= FLAG_AMBIGUOUS;
+        }
+      }
+      text[offsets[i] + seq.size()] = '\0';
+    }
+    if (!text.empty())
+    {
+      parallelSort(suffix_array.begin(), suffix_array.end(), SuffixLess(&text[0]));
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    header.file_identifier = FILE_IDENTIFIER;
+    header.file_version = FILE_VERSION;
+    header.key = key;
+    header.nr_proteins = proteins.size();
+    header.text_offset = HEADER_SIZE;
+    header.text_length = text.size();
+    header.offsets_offset = HEADER_SIZE + text.size();
+    header.offsets_offset += (SECTION_ALIGNMENT - header.offsets_offset % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+    header.flags_offset = header.offsets_offset + offsets.size() * sizeof(UInt64);
+    header.entry_offsets_offset = header.flags_offset + flags.size();
+    header.entry_offsets_offset += (SECTION_ALIGNMENT - header.entry_offsets_offset % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+    header.entries_offset = header.entry_offsets_offset + entry_offsets.size() * sizeof(UInt64);
+    header.entries_length = entry_text.size();
+    header.sa_offset = header.entries_offset + entry_text.size();
+    header.sa_offset += (SECTION_ALIGNMENT - header.sa_offset % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+    header.sa_length = suffix_array.size();
+
+    // write to a temporary file first: readers of an existing index are not affected
+    const String tmp_filename = filename + "." + File::getUniqueName() + ".tmp";
+    std::ofstream ofs;
+    UInt64 pos = 0;
+    Internal::MappedFileHelper::writeHeader(ofs, pos, tmp_filename, &header, sizeof(Header));
+    if (!text.empty())
+    {
+      ofs.write(&text[0], text.size());
+      pos += text.size();
+    }
+    Internal::MappedFileHelper::pad(ofs, pos, SECTION_ALIGNMENT);
+    ofs.write((const char*)&offsets[0], offsets.size() * sizeof(UInt64));
+    pos += offsets.size() * sizeof(UInt64);
+    if (!flags.empty())
+    {
+      ofs.write((const char*)&flags[0], flags.size());
+      pos += flags.size();
+    }
+    Internal::MappedFileHelper::pad(ofs, pos, SECTION_ALIGNMENT);
+    ofs.write((const char*)&entry_offsets[0], entry_offsets.size() * sizeof(UInt64));
+    pos += entry_offsets.size() * sizeof(UInt64);
+    ofs.write(entry_text.c_str(), entry_text.size());
+    pos += entry_text.size();
+    Internal::MappedFileHelper::pad(ofs, pos, SECTION_ALIGNMENT);
+    if (!suffix_array.empty())
+    {
+      ofs.write((const char*)&suffix_array[0], suffix_array.size() * sizeof(UInt64));
+    }
+    try
+    {
+      Internal::MappedFileHelper::writeTrailer(ofs, tmp_filename, FILE_IDENTIFIER);
+    }
+    catch (Exception::UnableToCreateFile&)
+    {
+      File::remove(tmp_filename);
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    if (File::exists(filename))
+    {
+      File::remove(filename); // std::rename does not replace existing files on all platforms
+    }
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    {
+      File::remove(tmp_filename);
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  bool ProteinSuffixArrayIndex::readKey(const String& filename, UInt64& key)
+  {
+    Header header;
+    if (!Internal::MappedFileHelper::readHeader(filename, &header, sizeof(Header)))
+    {
+      return false;
+    }
+    if (header.file_identifier != FILE_IDENTIFIER || header.file_version != FILE_VERSION)
+    {
+      return false;
+    }
+    key = header.key;
+    return true;
+  }
+
+  void ProteinSuffixArrayIndex::normalizeSequence(String& sequence)
+  {
+    const AlphabetTables& tables = alphabet_();
+    for (String::iterator it = sequence.begin(); it != sequence.end(); ++it)
+    {
+      *it = tables.normalized[(unsigned char)*it];
+    }
+  }
+
+  UInt64 ProteinSuffixArrayIndex::getKey() const
+  {
+    return key_;
+  }
+
+  Size ProteinSuffixArrayIndex::getNrProteins() const
+  {
+    return nr_proteins_;
+  }
+
+  String ProteinSuffixArrayIndex::getProteinSequence(Size index) const
+  {
+    OPENMS_PRECONDITION(index < nr_proteins_, "Protein index out of range");
+    return String(text_ + protein_offsets_[index], protein_offsets_[index + 1] - protein_offsets_[index] - 1);
+  }
+
+  bool ProteinSuffixArrayIndex::hasEntries() const
+  {
+    return entry_offsets_[nr_proteins_] != 0;
+  }
+
+  String ProteinSuffixArrayIndex::getAccession(Size index) const
+  {
+    OPENMS_PRECONDITION(index < nr_proteins_, "Protein index out of range");
+    if (!hasEntries()) return String();
+    return String(entries_ + entry_offsets_[index]);
+  }
+
+  FASTAFile::FASTAEntry ProteinSuffixArrayIndex::getEntry(Size index) const
+  {
+    OPENMS_PRECONDITION(index < nr_proteins_, "Protein index out of range");
+    FASTAFile::FASTAEntry entry;
+    if (!hasEntries()) return entry;
+    // the entry ends with '\0' (checked when mapping), never read beyond it
+    const char* p = entries_ + entry_offsets_[index];
+    const char* end = entries_ + entry_offsets_[index + 1];
+    const char* next = std::find(p, end, '\0');
+    entry.identifier = String(p, next - p);
+    p = std::min(next + 1, end);
+    next = std::find(p, end, '\0');
+    entry.description = String(p, next - p);
+    p = std::min(next + 1, end);
+    next = std::find(p, end, '\0');
+    entry.sequence = String(p, next - p);
+    return entry;
+  }
+
+  bool ProteinSuffixArrayIndex::isDecoy(Size index) const
+  {
+    OPENMS_PRECONDITION(index < nr_proteins_, "Protein index out of range");
+    return (flags_[index] & FLAG_DECOY) != 0;
+  }
+
+  bool ProteinSuffixArrayIndex::hasAmbiguousAA(Size index) const
+  {
+    OPENMS_PRECONDITION(index < nr_proteins_, "Protein index out of range");
+    return (flags_[index] & FLAG_AMBIGUOUS) != 0;
+  }
+
+  void ProteinSuffixArrayIndex::findExact(const String& peptide, std::vector<Occurrence>& hits) const
+  {
+    hits.clear();
+    if (peptide.empty() || sa_length_ == 0) return;
+
+    std::pair<const UInt64*, const UInt64*> range =
+      std::equal_range(suffix_array_, suffix_array_ + sa_length_, peptide, PrefixCompare(text_, peptide));
+    reportOccurrences_(range.first - suffix_array_, range.second - suffix_array_, hits);
+  }
+
+  void ProteinSuffixArrayIndex::findTolerant(const String& peptide, Size aaa_max, Size mismatches_max, std::vector<Occurrence>& hits) const
+  {
+    hits.clear();
+    if (peptide.empty() || sa_length_ == 0) return;
+
+    extendTolerant_(peptide, 0, 0, sa_length_, aaa_max, mismatches_max, hits);
+  }
+
+  void ProteinSuffixArrayIndex::extendTolerant_(const String& peptide, Size depth, Size first, Size last, Size aaa_left, Size mismatches_left, std::vector<Occurrence>& hits) const
+  {
+    if (depth == peptide.size())
+    {
+      reportOccurrences_(first, last, hits);
+      return;
+    }
+
+    const UInt32* classes = alphabet_().classes;
+    const char pep_aa = peptide[depth];
+    // all suffixes in [first, last) share the first 'depth' characters, i.e.
+    // they are sorted by the character at 'depth': visit each character once
+    while (first < last)
+    {
+      const char prot_aa = text_[suffix_array_[first] + depth];
+      const Size next = std::upper_bound(suffix_array_ + first, suffix_array_ + last, prot_aa,
+                                         CharAtCompare(text_, depth)) - suffix_array_;
+      if (prot_aa != '\0') // end of protein
+      {
+        Size aaa = aaa_left;
+        Size mismatches = mismatches_left;
+        bool match = true;
+        if ((classes[(unsigned char)pep_aa] & classes[(unsigned char)prot_aa]) != 0)
+        {
+          // ambiguous AA in the protein: costs a token
+          if (isAmbiguous_(prot_aa))
+          {
+            if (aaa == 0) match = false;
+            else --aaa;
+          }
+          // ambiguous AA in the peptide: only matches the same letter
+          if (isAmbiguous_(pep_aa) && pep_aa != prot_aa)
+          {
+            match = false;
+          }
+        }
+        else // real mismatch
+        {
+          if (mismatches == 0) match = false;
+          else --mismatches;
+        }
+        if (match)
+        {
+          extendTolerant_(peptide, depth + 1, first, next, aaa, mismatches, hits);
+        }
+      }
+      first = next;
+    }
+  }
+
+  void ProteinSuffixArrayIndex::reportOccurrences_(Size first, Size last, std::vector<Occurrence>& hits) const
+  {
+    const UInt64* offsets_end = protein_offsets_ + nr_proteins_ + 1;
+    for (Size i = first; i < last; ++i)
+    {
+      const UInt64 pos = suffix_array_[i];
+      Occurrence occ;
+      occ.protein_index = std::upper_bound(protein_offsets_, offsets_end, pos) - protein_offsets_ - 1;
+      occ.position = pos - protein_offsets_[occ.protein_index];
+      hits.push_back(occ);
+    }
+  }
+
+  const String& ProteinSuffixArrayIndex::getFilename() const
+  {
+    return filename_;
+  }
+
+} // namespace OpenMS
@@ -15,6 +15,7 @@ ConsensusIDAlgorithmRanks.cpp
 ConsensusIDAlgorithmSimilarity.cpp
 ConsensusIDAlgorithmWorst.cpp
 FalseDiscoveryRate.cpp
+FragmentIonIndex.cpp
 HiddenMarkovModel.cpp
 IDMapper.cpp
 IDRipper.cpp
@@ -23,6 +24,7 @@ MetaboliteSpectralMatching.cpp
 PeptideProteinResolution.cpp
 ProtonDistributionModel.cpp
 PeptideIndexing.cpp
+ProteinSuffixArrayIndex.cpp
 )
 
 ### add path to the filenames
@@ -71,17 +71,28 @@ namespace OpenMS
     std::set<Size> used_ids;
     for (Size i = 0; i < maps.size(); ++i)
     {
-      const ConsensusMap& map = maps[i];
-      for (ConsensusMap::FileDescriptions::const_iterator it = map.getFileDescriptions().begin(); it != map.getFileDescriptions().end(); ++it)
+      checkIds_(maps[i], used_ids);
+    }
+  }
+
+  void BaseGroupFinder::checkIds_(const ConsensusMap& map_0, const ConsensusMap& map_1) const
+  {
+    std::set<Size> used_ids;
+    checkIds_(map_0, used_ids);
+    checkIds_(map_1, used_ids);
+  }
+
+  void BaseGroupFinder::checkIds_(const ConsensusMap& map, std::set<Size>& used_ids) const
+  {
+    for (ConsensusMap::FileDescriptions::const_iterator it = map.getFileDescriptions().begin(); it != map.getFileDescriptions().end(); ++it)
+    {
+      if (used_ids.find(it->first) != used_ids.end())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "file ids have to be unique");
+      }
+      else
       {
-        if (used_ids.find(it->first) != used_ids.end())
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "file ids have to be unique");
-        }
-        else
-        {
-          used_ids.insert(it->first);
-        }
+        used_ids.insert(it->first);
       }
     }
   }
@@ -90,6 +90,19 @@ namespace OpenMS
   {
   }
 
+  FeatureDistance::FeatureDistance(const FeatureDistance & other) :
+    DefaultParamHandler(other),
+    params_rt_(other.params_rt_),
+    params_mz_(other.params_mz_),
+    params_intensity_(other.params_intensity_),
+    total_weight_reciprocal_(other.total_weight_reciprocal_),
+    max_intensity_(other.max_intensity_),
+    ignore_charge_(other.ignore_charge_),
+    force_constraints_(other.force_constraints_),
+    log_transform_(other.log_transform_)
+  {
+  }
+
   FeatureDistance & FeatureDistance::operator=(const FeatureDistance & other)
   {
     DefaultParamHandler::operator=(other);
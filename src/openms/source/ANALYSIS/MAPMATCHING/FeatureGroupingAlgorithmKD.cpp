@@ -37,8 +37,14 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/KERNEL/ConversionHelper.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -98,9 +104,7 @@ namespace OpenMS
   {
   }
 
-  template <typename MapType>
-  void FeatureGroupingAlgorithmKD::group_(const vector<MapType>& input_maps,
-                                          ConsensusMap& out)
+  void FeatureGroupingAlgorithmKD::setUpDistance_(double max_intensity)
   {
     // set parameters
     String mz_unit(param_.getValue("mz_unit").toString());
@@ -108,33 +112,6 @@ namespace OpenMS
     mz_tol_ = (double)(param_.getValue("mz_tol"));
     rt_tol_secs_ = (double)(param_.getValue("rt_tol"));
 
-    // check that the number of maps is ok:
-    if (input_maps.size() < 2)
-    {
-      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                       "At least two maps must be given!");
-    }
-
-    out.clear(false);
-
-    // collect all m/z values for partitioning, find intensity maximum
-    vector<double> massrange;
-    double max_intensity(0.0);
-    for (typename vector<MapType>::const_iterator map_it = input_maps.begin();
-         map_it != input_maps.end(); ++map_it)
-    {
-      for (typename MapType::const_iterator feat_it = map_it->begin();
-          feat_it != map_it->end(); feat_it++)
-      {
-        massrange.push_back(feat_it->getMZ());
-        double inty = feat_it->getIntensity();
-        if (inty > max_intensity)
-        {
-          max_intensity = inty;
-        }
-      }
-    }
-
     // set up distance functor
     Param distance_params;
     distance_params.insert("", param_.copy("distance_RT:"));
@@ -145,15 +122,22 @@ namespace OpenMS
     distance_params.setValue("distance_MZ:unit", (mz_ppm_ ? "ppm" : "Da"));
     feature_distance_ = FeatureDistance(max_intensity, false);
     feature_distance_.setParameters(distance_params);
+  }
 
+  void FeatureGroupingAlgorithmKD::computePartitionBoundaries_(vector<double>& massrange, vector<double>& partition_boundaries) const
+  {
     // partition at boundaries -> this should be safe because there cannot be
     // any cluster reaching across boundaries
+    partition_boundaries.clear();
+    if (massrange.empty())
+    {
+      return;
+    }
 
     sort(massrange.begin(), massrange.end());
     int pts_per_partition = massrange.size() / (int)(param_.getValue("nr_partitions"));
 
     // compute partition boundaries
-    vector<double> partition_boundaries;
     partition_boundaries.push_back(massrange.front());
     for (size_t j = 0; j < massrange.size()-1; j++)
     {
@@ -170,42 +154,183 @@ namespace OpenMS
     }
     // add last partition (a bit more since we use "smaller than" below)
     partition_boundaries.push_back(massrange.back() + 1.0);
+  }
 
-    // ------------ compute RT transformation models ------------
+  template <typename MapType>
+  void FeatureGroupingAlgorithmKD::assignPartitions_(const vector<MapType>& input_maps,
+                                                     const vector<double>& partition_boundaries,
+                                                     Size first_partition,
+                                                     vector<vector<vector<Size> > >& partition_indices) const
+  {
+    // the partitions only reference the input features by index, so no
+    // copies of the input maps are made and memory per partition is limited
+    // to its kd-tree
+    Size nr_partitions = partition_indices.size();
+    for (Size j = 0; j < nr_partitions; j++)
+    {
+      partition_indices[j].assign(input_maps.size(), vector<Size>());
+    }
+    for (size_t k = 0; k < input_maps.size(); k++)
+    {
+      for (size_t m = 0; m < input_maps[k].size(); m++)
+      {
+        Size j = upper_bound(partition_boundaries.begin(), partition_boundaries.end(),
+                             input_maps[k][m].getMZ()) - partition_boundaries.begin() - 1;
+        if (j >= first_partition && j < first_partition + nr_partitions)
+        {
+          partition_indices[j - first_partition][k].push_back(m);
+        }
+      }
+    }
+  }
 
-    MapAlignmentAlgorithmKD aligner(input_maps.size(), param_);
-    bool align = param_.getValue("warp").toString() == "true";
-    if (align)
+  template <typename MapType>
+  void FeatureGroupingAlgorithmKD::addRTFitData_(const vector<MapType>& input_maps,
+                                                 const vector<vector<vector<Size> > >& partition_indices,
+                                                 MapAlignmentAlgorithmKD& aligner,
+                                                 Size& progress)
+  {
+    // fit data is collected per partition and added in partition order, so
+    // the LOWESS fit does not depend on the number of threads
+    SignedSize nr_partitions = partition_indices.size();
+    vector<vector<TransformationModel::DataPoints> > partition_fit_data(nr_partitions);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize j = 0; j < nr_partitions; j++)
     {
-      Size progress = 0;
-      startProgress(0, partition_boundaries.size(), "computing RT transformations");
-      for (size_t j = 0; j < partition_boundaries.size()-1; j++)
+      IF_MASTERTHREAD setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+
+      // set up kd-tree
+      KDTreeFeatureMaps kd_data(input_maps, partition_indices[j], param_);
+      aligner.computeRTFitData(kd_data, partition_fit_data[j]);
+    }
+    for (SignedSize j = 0; j < nr_partitions; j++)
+    {
+      aligner.addRTFitData(partition_fit_data[j]);
+      vector<TransformationModel::DataPoints>().swap(partition_fit_data[j]);
+    }
+  }
+
+  template <typename MapType>
+  void FeatureGroupingAlgorithmKD::linkPartitions_(const vector<MapType>& input_maps,
+                                                   const vector<vector<vector<Size> > >& partition_indices,
+                                                   const MapAlignmentAlgorithmKD* aligner,
+                                                   ConsensusMap& out,
+                                                   Size& progress)
+  {
+    // partitions are separated by m/z gaps larger than the tolerance, so they
+    // can be linked independently; results are concatenated in partition order
+    SignedSize nr_partitions = partition_indices.size();
+    vector<ConsensusMap> partition_out(nr_partitions);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // the distance functor caches its normalization factor in ppm mode
+      FeatureDistance feature_distance(feature_distance_);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for (SignedSize j = 0; j < nr_partitions; j++)
       {
-        double partition_start = partition_boundaries[j];
-        double partition_end = partition_boundaries[j+1];
+        IF_MASTERTHREAD setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
 
-        std::vector<MapType> tmp_input_maps(input_maps.size());
-        for (size_t k = 0; k < input_maps.size(); k++)
+        // set up kd-tree
+        KDTreeFeatureMaps kd_data(input_maps, partition_indices[j], param_);
+
+        // alignment
+        if (aligner)
         {
-          // iterate over all features in the current input map and append
-          // matching features (within the current partition) to the temporary
-          // map
-          for (size_t m = 0; m < input_maps[k].size(); m++)
-          {
-            if (input_maps[k][m].getMZ() >= partition_start &&
-                input_maps[k][m].getMZ() < partition_end)
-            {
-              tmp_input_maps[k].push_back(input_maps[k][m]);
-            }
-          }
-          tmp_input_maps[k].updateRanges();
+          aligner->transform(kd_data);
         }
 
-        // set up kd-tree
-        KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
-        aligner.addRTFitData(kd_data);
-        setProgress(progress++);
+        // link features
+        runClustering_(kd_data, partition_out[j], feature_distance);
+      }
+    }
+    for (SignedSize j = 0; j < nr_partitions; j++)
+    {
+      for (ConsensusMap::const_iterator cf_it = partition_out[j].begin(); cf_it != partition_out[j].end(); ++cf_it)
+      {
+        out.push_back(*cf_it);
+      }
+      ConsensusMap().swap(partition_out[j]);
+    }
+  }
+
+  void FeatureGroupingAlgorithmKD::sortResult_(ConsensusMap& out)
+  {
+    // canonical ordering for checking the results:
+    startProgress(0, 3, String("sorting results"));
+    out.sortByQuality();
+    setProgress(1);
+    out.sortByMaps();
+    setProgress(2);
+    out.sortBySize();
+    endProgress();
+  }
+
+  template <typename MapType>
+  void FeatureGroupingAlgorithmKD::group_(const vector<MapType>& input_maps,
+                                          ConsensusMap& out)
+  {
+    // check that the number of maps is ok:
+    if (input_maps.size() < 2)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "At least two maps must be given!");
+    }
+
+    out.clear(false);
+
+    // collect all m/z values for partitioning, find intensity maximum
+    vector<double> massrange;
+    double max_intensity(0.0);
+    for (typename vector<MapType>::const_iterator map_it = input_maps.begin();
+         map_it != input_maps.end(); ++map_it)
+    {
+      for (typename MapType::const_iterator feat_it = map_it->begin();
+          feat_it != map_it->end(); feat_it++)
+      {
+        massrange.push_back(feat_it->getMZ());
+        double inty = feat_it->getIntensity();
+        if (inty > max_intensity)
+        {
+          max_intensity = inty;
+        }
       }
+    }
+
+    setUpDistance_(max_intensity);
+
+    vector<double> partition_boundaries;
+    computePartitionBoundaries_(massrange, partition_boundaries);
+    vector<double>().swap(massrange);
+
+    // assign each feature to its partition
+    Size nr_partitions = partition_boundaries.empty() ? 0 : partition_boundaries.size() - 1;
+    vector<vector<vector<Size> > > partition_indices(nr_partitions);
+    assignPartitions_(input_maps, partition_boundaries, 0, partition_indices);
+
+    // ------------ compute RT transformation models ------------
+
+    MapAlignmentAlgorithmKD aligner(input_maps.size(), param_);
+    bool align = param_.getValue("warp").toString() == "true";
+    if (align)
+    {
+      Size progress = 0;
+      startProgress(0, partition_boundaries.size(), "computing RT transformations");
+      addRTFitData_(input_maps, partition_indices, aligner, progress);
 
       // fit LOWESS on RT fit data collected across all partitions
       try
@@ -222,43 +347,10 @@ namespace OpenMS
     }
 
     // ------------ run alignment + feature linking on individual partitions ------------
+
     Size progress = 0;
     startProgress(0, partition_boundaries.size(), "linking features");
-    for (size_t j = 0; j < partition_boundaries.size()-1; j++)
-    {
-      double partition_start = partition_boundaries[j];
-      double partition_end = partition_boundaries[j+1];
-
-      std::vector<MapType> tmp_input_maps(input_maps.size());
-      for (size_t k = 0; k < input_maps.size(); k++)
-      {
-        // iterate over all features in the current input map and append
-        // matching features (within the current partition) to the temporary
-        // map
-        for (size_t m = 0; m < input_maps[k].size(); m++)
-        {
-          if (input_maps[k][m].getMZ() >= partition_start &&
-              input_maps[k][m].getMZ() < partition_end)
-          {
-            tmp_input_maps[k].push_back(input_maps[k][m]);
-          }
-        }
-        tmp_input_maps[k].updateRanges();
-      }
-
-      // set up kd-tree
-      KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
-
-      // alignment
-      if (align)
-      {
-        aligner.transform(kd_data);
-      }
-
-      // link features
-      runClustering_(kd_data, out);
-      setProgress(progress++);
-    }
+    linkPartitions_(input_maps, partition_indices, align ? &aligner : 0, out, progress);
     endProgress();
 
     // add protein IDs and unassigned peptide IDs to the result map here,
@@ -279,14 +371,7 @@ namespace OpenMS
         map_it->getUnassignedPeptideIdentifications().end());
     }
 
-    // canonical ordering for checking the results:
-    startProgress(0, 3, String("sorting results"));
-    out.sortByQuality();
-    setProgress(1);
-    out.sortByMaps();
-    setProgress(2);
-    out.sortBySize();
-    endProgress();
+    sortResult_(out);
     return;
   }
 
@@ -302,7 +387,195 @@ namespace OpenMS
     group_(maps, out);
   }
 
-  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out)
+  void FeatureGroupingAlgorithmKD::loadMap_(const String& filename, FileTypes::Type type, Size map_index, const DRange<1>& mz_range, ConsensusMap& map) const
+  {
+    FileHandler f;
+    if (type == FileTypes::FEATUREXML || type == FileTypes::FEATUREBIN)
+    {
+      // to save memory don't load convex hulls and subordinates
+      f.getFeatOptions().setLoadSubordinates(false);
+      f.getFeatOptions().setLoadConvexHull(false);
+      if (!mz_range.isEmpty())
+      {
+        f.getFeatOptions().setMZRange(mz_range);
+      }
+      FeatureMap tmp;
+      f.loadFeatures(filename, tmp, type);
+      for (FeatureMap::Iterator it = tmp.begin(); it != tmp.end(); ++it)
+      {
+        it->clearMetaInfo();
+      }
+      MapConversion::convert(map_index, tmp, map);
+      map.setPrimaryMSRunPath(tmp.getPrimaryMSRunPath());
+    }
+    else
+    {
+      if (!mz_range.isEmpty())
+      {
+        f.getOptions().setMZRange(mz_range);
+      }
+      f.loadConsensusFeatures(filename, map, type);
+    }
+  }
+
+  void FeatureGroupingAlgorithmKD::group(const StringList& filenames, ConsensusMap& out, Size max_chunk_size)
+  {
+    // check that the number of maps is ok:
+    if (filenames.size() < 2)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "At least two maps must be given!");
+    }
+    FileTypes::Type type = FileHandler::getType(filenames[0]);
+    for (Size i = 0; i < filenames.size(); ++i)
+    {
+      FileTypes::Type file_type = FileHandler::getType(filenames[i]);
+      if (file_type != type || (type != FileTypes::FEATUREXML && type != FileTypes::CONSENSUSXML &&
+                                type != FileTypes::FEATUREBIN && type != FileTypes::CONSENSUSBIN))
+      {
+        throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                          "All input files must be of the same type (featureXML, consensusXML, featureBin or consensusBin): '" + filenames[i] + "'");
+      }
+    }
+
+    out.clear(false);
+
+    // ------------ scan: m/z values and document level data of one map at a time ------------
+
+    vector<double> massrange;
+    double max_intensity(0.0);
+    StringList ms_run_locations;
+    startProgress(0, filenames.size(), "scanning input");
+    for (Size i = 0; i < filenames.size(); ++i)
+    {
+      ConsensusMap map;
+      loadMap_(filenames[i], type, i, DRange<1>(), map);
+      for (ConsensusMap::const_iterator feat_it = map.begin(); feat_it != map.end(); ++feat_it)
+      {
+        massrange.push_back(feat_it->getMZ());
+        double inty = feat_it->getIntensity();
+        if (inty > max_intensity)
+        {
+          max_intensity = inty;
+        }
+      }
+
+      out.getFileDescriptions()[i].filename = filenames[i];
+      out.getFileDescriptions()[i].size = map.size();
+      out.getFileDescriptions()[i].unique_id = map.getUniqueId();
+
+      // copy over information on the primary MS run
+      const StringList& ms_runs = map.getPrimaryMSRunPath();
+      ms_run_locations.insert(ms_run_locations.end(), ms_runs.begin(), ms_runs.end());
+
+      // add protein IDs and unassigned peptide IDs in the order of the input maps
+      out.getProteinIdentifications().insert(
+        out.getProteinIdentifications().end(),
+        map.getProteinIdentifications().begin(),
+        map.getProteinIdentifications().end());
+      out.getUnassignedPeptideIdentifications().insert(
+        out.getUnassignedPeptideIdentifications().end(),
+        map.getUnassignedPeptideIdentifications().begin(),
+        map.getUnassignedPeptideIdentifications().end());
+
+      setProgress(i);
+    }
+    endProgress();
+    out.setPrimaryMSRunPath(ms_run_locations);
+
+    setUpDistance_(max_intensity);
+
+    vector<double> partition_boundaries;
+    computePartitionBoundaries_(massrange, partition_boundaries);
+    Size nr_partitions = partition_boundaries.empty() ? 0 : partition_boundaries.size() - 1;
+
+    // combine consecutive partitions into chunks of at most max_chunk_size
+    // features (at least one partition per chunk)
+    vector<Size> chunk_begin;
+    Size chunk_features = 0;
+    vector<double>::iterator mz_it = massrange.begin();
+    for (Size j = 0; j < nr_partitions; ++j)
+    {
+      vector<double>::iterator mz_end = lower_bound(mz_it, massrange.end(), partition_boundaries[j + 1]);
+      Size partition_features = mz_end - mz_it;
+      mz_it = mz_end;
+      if (chunk_begin.empty() || chunk_features + partition_features > max_chunk_size)
+      {
+        chunk_begin.push_back(j);
+        chunk_features = 0;
+      }
+      chunk_features += partition_features;
+    }
+    chunk_begin.push_back(nr_partitions);
+    vector<double>().swap(massrange);
+
+    // ------------ pass 1: compute RT transformation models ------------
+
+    MapAlignmentAlgorithmKD aligner(filenames.size(), param_);
+    bool align = param_.getValue("warp").toString() == "true";
+    if (align)
+    {
+      Size progress = 0;
+      startProgress(0, partition_boundaries.size(), "computing RT transformations");
+      for (Size c = 0; c + 1 < chunk_begin.size(); ++c)
+      {
+        vector<ConsensusMap> chunk_maps;
+        vector<vector<vector<Size> > > partition_indices;
+        loadChunk_(filenames, type, partition_boundaries, chunk_begin[c], chunk_begin[c + 1], chunk_maps, partition_indices);
+        addRTFitData_(chunk_maps, partition_indices, aligner, progress);
+      }
+
+      // fit LOWESS on RT fit data collected across all partitions
+      try
+      {
+        aligner.fitLOWESS();
+      }
+      catch (Exception::BaseException& e)
+      {
+        LOG_ERROR << "Error: " << e.what() << endl;
+        return;
+      }
+
+      endProgress();
+    }
+
+    // ------------ pass 2: run alignment + feature linking chunk by chunk ------------
+
+    Size progress = 0;
+    startProgress(0, partition_boundaries.size(), "linking features");
+    for (Size c = 0; c + 1 < chunk_begin.size(); ++c)
+    {
+      vector<ConsensusMap> chunk_maps;
+      vector<vector<vector<Size> > > partition_indices;
+      loadChunk_(filenames, type, partition_boundaries, chunk_begin[c], chunk_begin[c + 1], chunk_maps, partition_indices);
+      linkPartitions_(chunk_maps, partition_indices, align ? &aligner : 0, out, progress);
+    }
+    endProgress();
+
+    sortResult_(out);
+  }
+
+  void FeatureGroupingAlgorithmKD::loadChunk_(const StringList& filenames,
+                                              FileTypes::Type type,
+                                              const vector<double>& partition_boundaries,
+                                              Size first_partition,
+                                              Size last_partition,
+                                              vector<ConsensusMap>& maps,
+                                              vector<vector<vector<Size> > >& partition_indices) const
+  {
+    // load only the features in the m/z range of the chunk (features on the
+    // boundaries are dropped again by the partition assignment)
+    DRange<1> mz_range(partition_boundaries[first_partition], partition_boundaries[last_partition]);
+    maps.assign(filenames.size(), ConsensusMap());
+    for (Size i = 0; i < filenames.size(); ++i)
+    {
+      loadMap_(filenames[i], type, i, mz_range, maps[i]);
+    }
+    partition_indices.assign(last_partition - first_partition, vector<vector<Size> >());
+    assignPartitions_(maps, partition_boundaries, first_partition, partition_indices);
+  }
+
+  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out, FeatureDistance& feature_distance) const
   {
     Size n = kd_data.size();
 
@@ -315,7 +588,7 @@ namespace OpenMS
     set<ClusterProxyKD> potential_clusters;
     vector<ClusterProxyKD> cluster_for_idx(n);
     vector<Int> assigned(n, false);
-    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, feature_distance);
 
     // pass 2: construct consensus features until all points assigned.
     while (!potential_clusters.empty())
@@ -325,7 +598,7 @@ namespace OpenMS
 
       // compile the actual list of sub feature indices for cluster with center i
       vector<Size> cf_indices;
-      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data);
+      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data, feature_distance);
 
       // add consensus feature
       addConsensusFeature_(cf_indices, kd_data, out);
@@ -353,7 +626,7 @@ namespace OpenMS
       }
 
       // now that the points are marked assigned, update the neighborhoods of their neighbors
-      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, feature_distance);
     }
   }
 
@@ -363,14 +636,15 @@ namespace OpenMS
                                                          vector<ClusterProxyKD>& cluster_for_idx,
                                                          const set<Size>& update_these,
                                                          const vector<Int>& assigned,
-                                                         const KDTreeFeatureMaps& kd_data)
+                                                         const KDTreeFeatureMaps& kd_data,
+                                                         FeatureDistance& feature_distance) const
   {
     for (set<Size>::const_iterator it = update_these.begin(); it != update_these.end(); ++it)
     {
       Size i = *it;
       const ClusterProxyKD& old_proxy = cluster_for_idx[i];
       vector<Size> unused;
-      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data);
+      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data, feature_distance);
 
       // only need to update if size and/or average distance have changed
       if (new_proxy != old_proxy)
@@ -382,7 +656,7 @@ namespace OpenMS
     }
   }
 
-  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const
+  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance) const
   {
     // compute i's neighborhood, together with a look-up table
     // map index -> corresponding points
@@ -413,8 +687,7 @@ namespace OpenMS
       Size best_index = numeric_limits<double>::max();
       for (vector<Size>::const_iterator c_it = candidates.begin(); c_it != candidates.end(); ++c_it)
       {
-        double dist = const_cast<FeatureDistance&>(feature_distance_)(*(kd_data.feature(*c_it)),
-                                                                      *(kd_data.feature(i))).second;
+        double dist = feature_distance(*(kd_data.feature(*c_it)), *(kd_data.feature(i))).second;
 
         if (dist < min_dist)
         {
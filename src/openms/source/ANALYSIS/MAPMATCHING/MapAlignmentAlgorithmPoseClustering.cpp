@@ -65,20 +65,34 @@ namespace OpenMS
     pairfinder_.setLogType(getLogType());
 
     max_num_peaks_considered_ = param_.getValue("max_num_peaks_considered");
+
+    // the selection of reference elements depends on the superimposer parameters
+    preprocessReference_();
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::preprocessReference_()
+  {
+    superimposer_.preprocess(reference_, reference_points_);
+  }
+
+  void MapAlignmentAlgorithmPoseClustering::setReference(const FeatureMap& map)
+  {
+    MapConversion::convert(0, map, reference_, max_num_peaks_considered_);
+    preprocessReference_();
   }
 
   MapAlignmentAlgorithmPoseClustering::~MapAlignmentAlgorithmPoseClustering()
   {
   }
 
-  void MapAlignmentAlgorithmPoseClustering::align(const FeatureMap& map, TransformationDescription& trafo)
+  void MapAlignmentAlgorithmPoseClustering::align(const FeatureMap& map, TransformationDescription& trafo) const
   {
     ConsensusMap map_scene;
     MapConversion::convert(1, map, map_scene, max_num_peaks_considered_);
     align(map_scene, trafo);
   }
 
-  void MapAlignmentAlgorithmPoseClustering::align(const PeakMap& map, TransformationDescription& trafo)
+  void MapAlignmentAlgorithmPoseClustering::align(const PeakMap& map, TransformationDescription& trafo) const
   {
     ConsensusMap map_scene;
     PeakMap map2(map);
@@ -86,16 +100,16 @@ namespace OpenMS
     align(map_scene, trafo);
   }
 
-  void MapAlignmentAlgorithmPoseClustering::align(const ConsensusMap& map, TransformationDescription& trafo)
+  void MapAlignmentAlgorithmPoseClustering::align(const ConsensusMap& map, TransformationDescription& trafo) const
   {
-    // TODO: move this to updateMembers_? (if ConsensusMap prevails)
-    // TODO: why does superimposer work on consensus map???
     const ConsensusMap & map_model = reference_;
     ConsensusMap map_scene = map;
 
     // run superimposer to find the global transformation
+    PoseClusteringAffineSuperimposer::PreprocessedMap scene_points;
+    superimposer_.preprocess(map_scene, scene_points);
     TransformationDescription si_trafo;
-    superimposer_.run(map_model, map_scene, si_trafo);
+    superimposer_.run(reference_points_, scene_points, si_trafo);
 
     // apply transformation to consensus features and contained feature
     // handles
@@ -112,11 +126,7 @@ namespace OpenMS
 
     // run pairfinder to find pairs
     ConsensusMap result;
-    // TODO: add another 2-map interface to pairfinder?
-    std::vector<ConsensusMap> input(2);
-    input[0] = map_model;
-    input[1] = map_scene;
-    pairfinder_.run(input, result);
+    pairfinder_.run(map_model, map_scene, result);
 
     // calculate the local transformation
     si_trafo.invert(); // to undo the transformation applied above
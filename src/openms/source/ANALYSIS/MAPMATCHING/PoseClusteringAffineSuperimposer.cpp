@@ -726,21 +726,55 @@ namespace OpenMS
     }
   }
 
-  double computeIntensityRatio(const std::vector<Peak2D> & model_map, const std::vector<Peak2D> & scene_map)
+  void PoseClusteringAffineSuperimposer::preprocess(const std::vector<Peak2D> & map, PreprocessedMap & result) const
   {
-    double total_int_model_map = 0;
-    for (Size i = 0; i < model_map.size(); ++i)
+    // use copy to truncate
+    result.points = map;
+    result.min_rt = 0.0;
+    result.max_rt = 0.0;
+    result.total_intensity = 0.0;
+    if (map.empty()) return;
+
+    // take estimates of the minimal / maximal element from the map
+    // possible improvement: use the truncated map below which should be
+    // more reliable (one outlier of low intensity could derail the estimate)
+    result.min_rt = std::min_element(map.begin(), map.end(), Peak2D::RTLess())->getRT();
+    result.max_rt = std::max_element(map.begin(), map.end(), Peak2D::RTLess())->getRT();
+
+    // truncate the data as necessary
+    const Size num_used_points = (Int) param_.getValue("num_used_points");
+
+    // sort the last data points by ascending intensity (from the right, using reverse iterators)
+    //  -> linear in complexity, should be faster than sorting and then taking cutoff
+    std::vector<Peak2D>& points = result.points;
+    if (points.size() > num_used_points)
     {
-      total_int_model_map += model_map[i].getIntensity();
+      std::nth_element(points.rbegin(), points.rbegin() + (points.size() - num_used_points),
+          points.rend(), Peak2D::IntensityLess());
+      points.resize(num_used_points);
     }
+    // sort by ascending m/z
+    std::sort(points.begin(), points.end(), Peak2D::MZLess());
 
-    double total_int_scene_map = 0;
-    for (Size i = 0; i < scene_map.size(); ++i)
+    for (Size i = 0; i < points.size(); ++i)
     {
-      total_int_scene_map += scene_map[i].getIntensity();
+      result.total_intensity += points[i].getIntensity();
     }
+  }
 
-    return total_int_model_map / total_int_scene_map;
+  void PoseClusteringAffineSuperimposer::preprocess(const ConsensusMap & map, PreprocessedMap & result) const
+  {
+    std::vector<Peak2D> c_map;
+    c_map.reserve(map.size());
+    for (ConsensusMap::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+      Peak2D c;
+      c.setIntensity( it->getIntensity() );
+      c.setRT( it->getRT() );
+      c.setMZ( it->getMZ() );
+      c_map.push_back(c);
+    }
+    preprocess(c_map, result);
   }
 
   void PoseClusteringAffineSuperimposer::run(const std::vector<Peak2D> & map_model,
@@ -748,7 +782,23 @@ namespace OpenMS
                                              TransformationDescription & transformation)
 
   {
-    if (map_model.empty() || map_scene.empty())
+    //**************************************************************************
+    // Step 1: Select the most abundant data points only.
+    //**************************************************************************
+    PreprocessedMap model, scene;
+    preprocess(map_model, model);
+    preprocess(map_scene, scene);
+
+    startProgress(0, 1, "affine pose clustering");
+    run(model, scene, transformation);
+    endProgress();
+  }
+
+  void PoseClusteringAffineSuperimposer::run(const PreprocessedMap & map_model,
+                                             const PreprocessedMap & map_scene,
+                                             TransformationDescription & transformation) const
+  {
+    if (map_model.points.empty() || map_scene.points.empty())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                        "One of the input maps is empty! This is not allowed!");
@@ -787,10 +837,7 @@ namespace OpenMS
     LinearInterpolationType_ scaling_hash_2; //scaling estimate from round 2 hashing
     LinearInterpolationType_ rt_low_hash_; // rt shift estimate of map start
     LinearInterpolationType_ rt_high_hash_; // rt shift estimate of map end
-    UInt actual_progress = 0;
 
-    startProgress(0, 100, "affine pose clustering");
-    setProgress(++actual_progress);
     // Optionally, we will write dumps of the hash table buckets.
     bool do_dump_buckets = false;
     String dump_buckets_basename;
@@ -799,7 +846,6 @@ namespace OpenMS
       do_dump_buckets = true;
       dump_buckets_basename = param_.getValue("dump_buckets");
     }
-    setProgress(++actual_progress);
 
     // Even more optionally, we will write dumps of the hashed pairs.
     bool do_dump_pairs = false;
@@ -809,51 +855,18 @@ namespace OpenMS
       do_dump_pairs = true;
       dump_pairs_basename = param_.getValue("dump_pairs");
     }
-    setProgress(++actual_progress);
-
-    //**************************************************************************
-    // Step 1: Select the most abundant data points only.
-    //**************************************************************************
-    // use copy to truncate
-    std::vector<Peak2D> model_map(map_model);
-    std::vector<Peak2D> scene_map(map_scene);
-    {
-      // truncate the data as necessary
-      const Size num_used_points = (Int) param_.getValue("num_used_points");
 
-      // sort the last data points by ascending intensity (from the right, using reverse iterators)
-      //  -> linear in complexity, should be faster than sorting and then taking cutoff
-      if (model_map.size() > num_used_points)
-      {
-        std::nth_element(model_map.rbegin(), model_map.rbegin() + (model_map.size() - num_used_points),
-            model_map.rend(), Peak2D::IntensityLess());
-        model_map.resize(num_used_points);
-      }
-      setProgress(++actual_progress);
-      if (scene_map.size() > num_used_points)
-      {
-        std::nth_element(scene_map.rbegin(), scene_map.rbegin() + (scene_map.size() - num_used_points),
-            scene_map.rend(), Peak2D::IntensityLess());
-        scene_map.resize(num_used_points);
-      }
-      setProgress(++actual_progress);
-    }
-    // sort by ascending m/z
-    std::sort(model_map.begin(), model_map.end(), Peak2D::MZLess());
-    std::sort(scene_map.begin(), scene_map.end(), Peak2D::MZLess());
-    setProgress((actual_progress = 10));
+    const std::vector<Peak2D> & model_map = map_model.points;
+    const std::vector<Peak2D> & scene_map = map_scene.points;
 
     //**************************************************************************
     // Preprocessing
     //**************************************************************************
-    // take estimates of the minimal / maximal element from both maps
-    // possible improvement: use the truncated map from above which should be
-    // more reliable (one outlier of low intensity could derail the estimate
-    // below)
-    const double model_minrt = std::min_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
-    const double scene_minrt = std::min_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
-    const double model_maxrt = std::max_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
-    const double scene_maxrt = std::max_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
+    // take estimates of the minimal / maximal element from both maps (see preprocess())
+    const double model_minrt = map_model.min_rt;
+    const double scene_minrt = map_scene.min_rt;
+    const double model_maxrt = map_model.max_rt;
+    const double scene_maxrt = map_scene.max_rt;
     const double rt_low =  (model_minrt + scene_minrt) / 2.;
     const double rt_high = (model_maxrt + scene_maxrt) / 2.;
 
@@ -901,19 +914,20 @@ namespace OpenMS
                          param_.getValue("scaling_bucket_size"), param_.getValue("shift_bucket_size"),
                          rt_low, rt_high);
 
-    setProgress(++actual_progress);
-
     //**************************************************************************
     // Step 3: compute the ratio of the total intensities of both maps, for
     //         normalization
     //**************************************************************************
-    double total_intensity_ratio = computeIntensityRatio(model_map, scene_map);
-    setProgress((actual_progress = 20));
+    double total_intensity_ratio = map_model.total_intensity / map_scene.total_intensity;
 
     // The serial number is incremented for each invocation of this, to avoid
     // overwriting of hash table dumps.
-    static Int dump_buckets_serial = 0;
-    ++dump_buckets_serial;
+    static Int dump_buckets_serial_counter = 0;
+    Int dump_buckets_serial;
+#ifdef _OPENMP
+#pragma omp critical (PoseClusteringAffineSuperimposer_dump_serial)
+#endif
+    dump_buckets_serial = ++dump_buckets_serial_counter;
 
     //**************************************************************************
     // Step 4: Hashing
@@ -943,7 +957,6 @@ namespace OpenMS
       -1, // only used in 2nd round of hashing
       -1, // only used in 2nd round of hashing
       rt_low, rt_high);
-    setProgress((actual_progress = 30));
 
     ///////////////////////////////////////////////////////////////////
     // Step 4.2 Estimate the scaling factor (and potential bounds) based on the
@@ -963,7 +976,6 @@ namespace OpenMS
       scale_low_1,
       scale_high_1,
       scale_centroid_1);
-    setProgress((actual_progress = 40));
 
     ///////////////////////////////////////////////////////////////////
     // Step 4.3 Second round of hashing: Estimate the shift at both ends and
@@ -983,7 +995,6 @@ namespace OpenMS
       scale_low_1,
       scale_high_1,
       rt_low, rt_high);
-    setProgress((actual_progress = 50));
 
     ///////////////////////////////////////////////////////////////////
     // Step 4.4 Estimate the shift factor at start/end of the map based on the
@@ -1002,7 +1013,6 @@ namespace OpenMS
       dump_buckets_basename,
       rt_low_centroid,
       rt_high_centroid);
-    setProgress(80);
 
     //**************************************************************************
     // Step 5: Estimate transform
@@ -1034,8 +1044,6 @@ namespace OpenMS
     rt_high_image = rt_high_hash_.index2key(rt_high_max_index);
 #endif
 
-    setProgress(++actual_progress);
-
     // 5.2 compute slope and intercept from matching high/low retention times
     {
       Param params;
@@ -1054,34 +1062,19 @@ namespace OpenMS
 
       transformation.fitModel("linear", params);       // no data, but explicit parameters
     }
-
-    setProgress(++actual_progress);
-    endProgress();
   }
 
   void PoseClusteringAffineSuperimposer::run(const ConsensusMap& map_model,
                                              const ConsensusMap& map_scene,
                                              TransformationDescription& transformation)
   {
-    std::vector<Peak2D> c_map_model, c_map_scene;
-    for (ConsensusMap::const_iterator it = map_model.begin(); it != map_model.end(); ++it)
-    {
-      Peak2D c;
-      c.setIntensity( it->getIntensity() );
-      c.setRT( it->getRT() );
-      c.setMZ( it->getMZ() );
-      c_map_model.push_back(c);
-    }
-    for (ConsensusMap::const_iterator it = map_scene.begin(); it != map_scene.end(); ++it)
-    {
-      Peak2D c;
-      c.setIntensity( it->getIntensity() );
-      c.setRT( it->getRT() );
-      c.setMZ( it->getMZ() );
-      c_map_scene.push_back(c);
-    }
+    PreprocessedMap model, scene;
+    preprocess(map_model, model);
+    preprocess(map_scene, scene);
 
-    run(c_map_model, c_map_scene, transformation);
+    startProgress(0, 1, "affine pose clustering");
+    run(model, scene, transformation);
+    endProgress();
   }
 
 } // namespace OpenMS
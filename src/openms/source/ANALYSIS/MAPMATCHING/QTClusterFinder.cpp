@@ -222,8 +222,10 @@ namespace OpenMS
     // std::cout << "Hashing..." << std::endl;
     list<OpenMS::GridFeature> grid_features;
     Grid grid(Grid::ClusterCenter(max_diff_rt_, max_diff_mz_));
+    map_offsets_.assign(1, 0);
     for (Size map_index = 0; map_index < num_maps_; ++map_index)
     {
+      map_offsets_.push_back(map_offsets_.back() + input_maps[map_index].size());
       for (Size feature_index = 0; feature_index < input_maps[map_index].size();
            ++feature_index)
       {
@@ -246,18 +248,17 @@ namespace OpenMS
 
     // compute QT clustering:
     // std::cout << "Clustering..." << std::endl;
-    list<QTCluster> clustering;
+    vector<QTCluster> clustering;
     computeClustering_(grid, clustering);
     // number of clusters == number of data points:
     Size size = clustering.size();
 
     // create a temp. map storing which grid features are next to which clusters
     typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
-    ElementMapping element_mapping;
-    for (list<QTCluster>::iterator it = clustering.begin();
-         it != clustering.end(); ++it)
+    ElementMapping element_mapping(map_offsets_.back());
+    for (Size cluster_index = 0; cluster_index < size; ++cluster_index)
     {
-      NeighborList neigh = it->getAllNeighbors();
+      NeighborList neigh = clustering[cluster_index].getAllNeighbors();
       for (NeighborList::iterator n_it = neigh.begin(); n_it != neigh.end(); ++n_it)
       {
         for (std::vector<GridFeature*>::iterator i_it = n_it->second.begin();
@@ -265,17 +266,23 @@ namespace OpenMS
         {
           // remember for each feature (gridfeature) all the cluster elements
           // it belongs to
-          element_mapping[*i_it].push_back(&(*it));
+          element_mapping[featureIndex_(*i_it)].push_back(cluster_index);
         }
       }
     }
 
     // ensure that all cluster centers are in the list
-    for (list<QTCluster>::iterator it = clustering.begin();
-         it != clustering.end(); ++it)
+    for (Size cluster_index = 0; cluster_index < size; ++cluster_index)
     {
-      OpenMS::GridFeature* center_feature = it->getCenterPoint();
-      element_mapping[center_feature].push_back(&(*it));
+      OpenMS::GridFeature* center_feature = clustering[cluster_index].getCenterPoint();
+      element_mapping[featureIndex_(center_feature)].push_back(cluster_index);
+    }
+
+    // all clusters are valid initially
+    ClusterQueue queue;
+    for (Size cluster_index = 0; cluster_index < size; ++cluster_index)
+    {
+      queue.insert(make_pair(-clustering[cluster_index].getQuality(), cluster_index));
     }
 
     ProgressLogger logger;
@@ -286,61 +293,38 @@ namespace OpenMS
       logger.startProgress(0, size, "linking features");
     }
 
-    while (!clustering.empty())
+    while (!queue.empty())
     {
-      // std::cout << "Clusters: " << clustering.size() << std::endl;
       ConsensusFeature consensus_feature;
-      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid);
-      if (!clustering.empty())
-      {
-        result_map.push_back(consensus_feature);
-      }
+      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid, queue);
+      result_map.push_back(consensus_feature);
       if (do_progress) logger.setProgress(progress++);
     }
 
     if (do_progress) logger.endProgress();
   }
 
-  void QTClusterFinder::makeConsensusFeature_(list<QTCluster>& clustering,
+  void QTClusterFinder::makeConsensusFeature_(vector<QTCluster>& clustering,
                                               ConsensusFeature& feature,
                                               ElementMapping& element_mapping,
-                                              Grid& grid)
+                                              Grid& grid,
+                                              ClusterQueue& queue)
   {
-    // find the best cluster (a valid cluster with the highest score)
-    // -> this is equivalent to std::max_element but we can skip invalid clusters
-    list<QTCluster>::iterator best = clustering.begin();
-    while (best != clustering.end() && best->isInvalid()) // find start element
-    {
-      ++best;
-    }
-    for (list<QTCluster>::iterator it = best;
-         it != clustering.end(); ++it)
-    {
-      if (!it->isInvalid())
-      {
-        if (it->getQuality() > best->getQuality())
-        {
-          best = it;
-        }
-      }
-    }
-
-    // no more clusters to process -> clear clustering and return
-    if (best == clustering.end())
-    {
-      clustering.clear();
-      return;
-    }
+    // the best cluster (a valid cluster with the highest score) is the first
+    // in the queue - in case of ties, the one that was created first
+    const Size best_index = queue.begin()->second;
+    queue.erase(queue.begin());
+    QTCluster& best = clustering[best_index];
 
     OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*> elements;
-    best->getElements(elements);
+    best.getElements(elements);
 #ifdef DEBUG_QTCLUSTERFINDER
     std::cout << "Elements: " << elements.size() << " with best "
-         << best->getQuality() << " invalid " << best->isInvalid() << std::endl;
+         << best.getQuality() << " invalid " << best.isInvalid() << std::endl;
 #endif
 
     // create consensus feature from best cluster:
-    feature.setQuality(best->getQuality());
+    feature.setQuality(best.getQuality());
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
          it = elements.begin(); it != elements.end(); ++it)
     {
@@ -349,7 +333,7 @@ namespace OpenMS
     feature.computeConsensus();
 
 #ifdef DEBUG_QTCLUSTERFINDER
-    std::cout << " create new consensus feature " << feature.getRT() << " " << feature.getMZ() << " from " << best->getCenterPoint()->getFeature().getUniqueId() << std::endl;
+    std::cout << " create new consensus feature " << feature.getRT() << " " << feature.getMZ() << " from " << best.getCenterPoint()->getFeature().getUniqueId() << std::endl;
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
          it = elements.begin(); it != elements.end(); ++it)
     {
@@ -362,81 +346,83 @@ namespace OpenMS
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
          it = elements.begin(); it != elements.end(); ++it)
     {
-      already_used_.insert(it->second);
+      already_used_[featureIndex_(it->second)] = true;
     }
 
     // update the clustering:
     // 1. remove current "best" cluster from list
     // 2. update all clusters accordingly by removing already used elements
     // 3. Invalidate elements whose central has been used already
-    best->setInvalid();
+    best.setInvalid();
+
+    // Identify all clusters that may potentially need updating (each of them
+    // only once - the result of an update does not depend on the order)
+    vector<Size> affected;
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
         it = elements.begin(); it != elements.end(); ++it)
     {
-      // Identify all features that could potentially have been touched by this
-      //  Get all clusters that may potentially need updating
-
-      ElementMapping tmp_element_mapping; // modify copy, then update
-
-      for (std::vector<QTCluster*>::iterator
-           cluster  = element_mapping[&(*it->second)].begin();
-           cluster != element_mapping[&(*it->second)].end(); ++cluster)
+      const vector<Size>& clusters = element_mapping[featureIndex_(it->second)];
+      for (vector<Size>::const_iterator cluster_it = clusters.begin(); cluster_it != clusters.end(); ++cluster_it)
       {
         // we do not want to update invalid features (saves time and does not
         // recompute the quality)
-        if (!(*cluster)->isInvalid())
+        if (!clustering[*cluster_it].isInvalid())
         {
-          // remove the elements of the new feature from the cluster
-          if ((*cluster)->update(elements))
-          {
-            // If update returns true, it means that at least one element was
-            // removed from the cluster and we need to update that cluster
-
-            // Get the coordinates of the current cluster
-            const Int x = (*cluster)->getXCoord(); 
-            const Int y = (*cluster)->getYCoord();
-
-            ////////////////////////////////////////
-            // Step 1: Iterate through all neighboring grid features and try to
-            // add elements to the current cluster to replace the ones we just
-            // removed
-            const OpenMS::GridFeature* center_feature = (*cluster)->getCenterPoint();
-            addClusterElements_(x, y, grid, (**cluster), center_feature);
-
-            ////////////////////////////////////////
-            // Step 2: update element_mapping as the best feature for each
-            // cluster may have changed
-            typedef OpenMSBoost::unordered_map<Size,
-                    std::vector<GridFeature*> > NeighborList;
-            NeighborList neigh = (*cluster)->getAllNeighbors();
-            for (NeighborList::iterator n_it = neigh.begin(); n_it != neigh.end(); ++n_it)
-            {
-              for (std::vector<GridFeature*>::iterator i_it =
-                  n_it->second.begin(); i_it != n_it->second.end(); ++i_it)
-              {
-                // remember for each feature (gridfeature) all the cluster
-                // elements it belongs to
-                tmp_element_mapping[*i_it].push_back(*cluster);
-              }
-            }
-          }
+          affected.push_back(*cluster_it);
         }
       }
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
 
-      for (ElementMapping::iterator it = tmp_element_mapping.begin(); 
-          it != tmp_element_mapping.end(); ++it )
+    for (vector<Size>::const_iterator cluster_it = affected.begin(); cluster_it != affected.end(); ++cluster_it)
+    {
+      QTCluster& cluster = clustering[*cluster_it];
+      const double old_quality = cluster.getQuality();
+
+      // remove the elements of the new feature from the cluster
+      if (cluster.update(elements))
       {
-        for (std::vector<QTCluster*>::iterator it2 = it->second.begin();
-            it2 != it->second.end(); ++it2)
+        // If update returns true, it means that at least one element was
+        // removed from the cluster and we need to update that cluster
+
+        ////////////////////////////////////////
+        // Step 1: Iterate through all neighboring grid features and try to
+        // add elements to the current cluster to replace the ones we just
+        // removed
+        addClusterElements_(cluster.getXCoord(), cluster.getYCoord(), grid, cluster,
+                            cluster.getCenterPoint(), feature_distance_);
+
+        queue.erase(make_pair(-old_quality, *cluster_it));
+        queue.insert(make_pair(-cluster.getQuality(), *cluster_it));
+
+        ////////////////////////////////////////
+        // Step 2: update element_mapping as the best feature for each
+        // cluster may have changed
+        typedef OpenMSBoost::unordered_map<Size,
+                std::vector<GridFeature*> > NeighborList;
+        NeighborList neigh = cluster.getAllNeighbors();
+        for (NeighborList::iterator n_it = neigh.begin(); n_it != neigh.end(); ++n_it)
         {
-          element_mapping[ it->first ].push_back(*it2);
+          for (std::vector<GridFeature*>::iterator i_it =
+              n_it->second.begin(); i_it != n_it->second.end(); ++i_it)
+          {
+            // remember for each feature (gridfeature) all the cluster
+            // elements it belongs to
+            element_mapping[featureIndex_(*i_it)].push_back(*cluster_it);
+          }
         }
       }
+      else if (cluster.isInvalid())
+      {
+        // the cluster center was used
+        queue.erase(make_pair(-old_quality, *cluster_it));
+      }
     }
   }
 
   void QTClusterFinder::addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-    const OpenMS::GridFeature* center_feature)
+    const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance)
   {
     cluster.initializeCluster();
 
@@ -470,7 +456,7 @@ namespace OpenMS
 
             // Skip features that we have already used -> we cannot add them to
             // be neighbors any more
-            if (already_used_.find(neighbor_feature) != already_used_.end() )
+            if (already_used_[featureIndex_(neighbor_feature)])
             {
               continue;
             }
@@ -479,7 +465,7 @@ namespace OpenMS
             if (center_feature != neighbor_feature)
             {
               // NOTE: this actually caches the distance -> memory problem
-              double dist = getDistance_(center_feature, neighbor_feature);
+              double dist = feature_distance(center_feature->getFeature(), neighbor_feature->getFeature()).second;
 
               if (dist == FeatureDistance::infinity)
               {
@@ -532,36 +518,46 @@ namespace OpenMS
   }
 
   void QTClusterFinder::computeClustering_(Grid& grid,
-                                           list<QTCluster>& clustering)
+                                           vector<QTCluster>& clustering)
   {
     clustering.clear();
-    already_used_.clear();
+    already_used_.assign(map_offsets_.back(), false);
 
     // FeatureDistance produces normalized distances (between 0 and 1):
     const double max_distance = 1.0;
 
-    // iterate over all grid cells:
+    // one cluster per grid feature (in the order of the grid cells):
+    clustering.reserve(map_offsets_.back());
     for (Grid::iterator it = grid.begin(); it != grid.end(); ++it)
     {
       const Grid::CellIndex& act_coords = it.index();
       const Int x = act_coords[0], y = act_coords[1];
 
       OpenMS::GridFeature* center_feature = it->second;
-      QTCluster cluster(center_feature, num_maps_, max_distance, use_IDs_, x, y);
+      clustering.push_back(QTCluster(center_feature, num_maps_, max_distance, use_IDs_, x, y));
+    }
 
-      addClusterElements_(x, y, grid, cluster, center_feature);
+    // collect the cluster elements (clusters are independent of each other at
+    // this point, so this can be done in parallel):
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // the distance functor is not thread-safe (for m/z tolerances in ppm)
+      FeatureDistance feature_distance(feature_distance_);
 
-      clustering.push_back(cluster);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)clustering.size(); ++i)
+      {
+        QTCluster& cluster = clustering[i];
+        addClusterElements_(cluster.getXCoord(), cluster.getYCoord(), grid, cluster,
+                            cluster.getCenterPoint(), feature_distance);
+      }
     }
   }
 
-  double QTClusterFinder::getDistance_(const OpenMS::GridFeature* left,
-                                       const OpenMS::GridFeature* right)
-  {
-    return feature_distance_(left->getFeature(), right->getFeature()).second;
-  }
-  
-
   QTClusterFinder::~QTClusterFinder()
   {
   }
@@ -38,9 +38,42 @@
 
 #include <OpenMS/CONCEPT/Exception.h>
 
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// Sum up the intensities in [begin, end)
+    inline double sumIntensities(const double* begin, const double* end)
+    {
+      double sum = 0;
+#if defined(__SSE2__)
+      if (end - begin >= 4)
+      {
+        __m128d acc = _mm_setzero_pd();
+        for (; end - begin >= 2; begin += 2)
+        {
+          acc = _mm_add_pd(acc, _mm_loadu_pd(begin));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, acc);
+        sum = lanes[0] + lanes[1];
+      }
+#endif
+      for (; begin != end; ++begin)
+      {
+        sum += *begin;
+      }
+      return sum;
+    }
+  }
+
   void ChromatogramExtractorAlgorithm::extract_value_tophat(
       const std::vector<double>::const_iterator& mz_start,
             std::vector<double>::const_iterator& mz_it,
@@ -165,6 +198,76 @@ namespace OpenMS
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
         "Input to extractChromatogram needs to be sorted by m/z");
     }
+    if (used_filter == 2)
+    {
+      throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
+
+    // the coordinates are already sorted, extract them in the given order
+    std::vector<Size> order(extraction_coordinates.size());
+    for (Size k = 0; k < order.size(); ++k)
+    {
+      order[k] = k;
+    }
+    sweepExtract_(input, output, extraction_coordinates, order, mz_extraction_window, ppm);
+  }
+
+  void ChromatogramExtractorAlgorithm::extractChromatogramsBatch(const OpenSwath::SpectrumAccessPtr input,
+      std::vector< OpenSwath::ChromatogramPtr >& output,
+      const std::vector<ExtractionCoordinates>& extraction_coordinates, double mz_extraction_window,
+      bool ppm, String filter)
+  {
+    if (input->getNrSpectra() < 1)
+    {
+      return;
+    }
+
+    if (output.size() != extraction_coordinates.size())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Output and extraction coordinates need to have the same size");
+    }
+
+    int used_filter = getFilterNr_(filter);
+    if (used_filter == 2)
+    {
+      throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
+
+    // sort the coordinates by m/z once (stable, such that identical m/z
+    // values are extracted in input order)
+    std::vector<std::pair<double, Size> > sorted(extraction_coordinates.size());
+    for (Size k = 0; k < sorted.size(); ++k)
+    {
+      sorted[k] = std::make_pair(extraction_coordinates[k].mz, k);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<Size> order(sorted.size());
+    for (Size k = 0; k < sorted.size(); ++k)
+    {
+      order[k] = sorted[k].second;
+    }
+    sweepExtract_(input, output, extraction_coordinates, order, mz_extraction_window, ppm);
+  }
+
+  void ChromatogramExtractorAlgorithm::sweepExtract_(const OpenSwath::SpectrumAccessPtr input,
+      std::vector< OpenSwath::ChromatogramPtr >& output,
+      const std::vector<ExtractionCoordinates>& extraction_coordinates,
+      const std::vector<Size>& order, double mz_extraction_window, bool ppm)
+  {
+    Size input_size = input->getNrSpectra();
+
+    // Compute the extraction windows once. Since the coordinates are visited
+    // by ascending m/z, both the left and the right window boundaries are
+    // monotonically increasing (also for ppm windows).
+    std::vector<double> left(order.size()), right(order.size());
+    for (Size k = 0; k < order.size(); ++k)
+    {
+      double mz = extraction_coordinates[order[k]].mz;
+      double half_window = ppm ? mz * mz_extraction_window / 2.0 * 1.0e-6 : mz_extraction_window / 2.0;
+      left[k] = mz - half_window;
+      right[k] = mz + half_window;
+    }
 
     //go through all spectra
     startProgress(0, input_size, "Extracting chromatograms");
@@ -175,46 +278,45 @@ namespace OpenMS
       OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
       OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
 
-      OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
-      OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
-      std::vector<double>::const_iterator mz_start = mz_arr->data.begin();
-      std::vector<double>::const_iterator mz_end = mz_arr->data.end();
-      std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
-      std::vector<double>::const_iterator int_it = int_arr->data.begin();
-
-      if (sptr->getMZArray()->data.size() == 0)
+      const std::vector<double>& mz_arr = sptr->getMZArray()->data;
+      const std::vector<double>& int_arr = sptr->getIntensityArray()->data;
+      if (mz_arr.empty())
       {
         continue;
       }
+      const Size nr_peaks = mz_arr.size();
+      const double current_rt = s_meta.RT;
 
-      // go through all transitions / chromatograms which are sorted by
-      // ProductMZ. We can use this to step through the spectrum and at the
-      // same time step through the transitions. We increase the peak counter
-      // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+      // Merge-sweep over the peaks and the transitions / chromatograms: the
+      // first peak inside the window (lo) and the first peak to the right of
+      // the window (hi) only ever move forward.
+      Size lo = 0, hi = 0;
+      for (Size k = 0; k < order.size(); ++k)
       {
-        double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
-        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
-             (current_rt < extraction_coordinates[k].rt_start ||
-              current_rt > extraction_coordinates[k].rt_end) )
+        const ExtractionCoordinates& coord = extraction_coordinates[order[k]];
+        if (coord.rt_end - coord.rt_start > 0 &&
+             (current_rt < coord.rt_start || current_rt > coord.rt_end) )
         {
           continue;
         }
 
-        if (used_filter == 1)
+        while (lo < nr_peaks && mz_arr[lo] <= left[k])
+        {
+          ++lo;
+        }
+        if (hi < lo)
         {
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it,
-                               extraction_coordinates[k].mz, integrated_intensity, mz_extraction_window, ppm);
+          hi = lo;
         }
-        else if (used_filter == 2)
+        while (hi < nr_peaks && mz_arr[hi] < right[k])
         {
-          throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+          ++hi;
         }
+        double integrated_intensity = sumIntensities(&int_arr[0] + lo, &int_arr[0] + hi);
 
         // Time is first, intensity is second
-        output[k]->binaryDataArrayPtrs[0]->data.push_back(current_rt);
-        output[k]->binaryDataArrayPtrs[1]->data.push_back(integrated_intensity);
+        output[order[k]]->binaryDataArrayPtrs[0]->data.push_back(current_rt);
+        output[order[k]]->binaryDataArrayPtrs[1]->data.push_back(integrated_intensity);
       }
     }
     endProgress();
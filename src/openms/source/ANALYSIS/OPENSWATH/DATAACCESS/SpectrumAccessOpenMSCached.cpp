@@ -36,6 +36,7 @@
 
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/CachedMzML.h>
+#include <OpenMS/FORMAT/MappedCachedMzML.h>
 
 namespace OpenMS
 {
@@ -45,14 +46,22 @@ namespace OpenMS
     filename_cached_ = filename + ".cached";
     filename_ = filename;
 
-    // Create the index from the given file
-    CachedmzML cache;
-    cache.createMemdumpIndex(filename_cached_);
-    spectra_index_ = cache.getSpectraIndex();
-    chrom_index_ = cache.getChromatogramIndex();;
-
-    // open the filestream
-    ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    if (MappedCachedmzML::isMappedCache(filename_cached_))
+    {
+      // map the file into memory, no index or filestream needed
+      mapped_cache_ = boost::shared_ptr<const MappedCachedmzML>(new MappedCachedmzML(filename_cached_));
+    }
+    else
+    {
+      // Create the index from the given file
+      CachedmzML cache;
+      cache.createMemdumpIndex(filename_cached_);
+      spectra_index_ = cache.getSpectraIndex();
+      chrom_index_ = cache.getChromatogramIndex();
+
+      // open the filestream
+      ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    }
 
     // load the meta data from disk
     MzMLFile().load(filename, meta_ms_experiment_);
@@ -60,16 +69,24 @@ namespace OpenMS
 
   SpectrumAccessOpenMSCached::~SpectrumAccessOpenMSCached()
   {
-    ifs_.close();
+    if (ifs_.is_open())
+    {
+      ifs_.close();
+    }
   }
 
   SpectrumAccessOpenMSCached::SpectrumAccessOpenMSCached(const SpectrumAccessOpenMSCached & rhs) :
     meta_ms_experiment_(rhs.meta_ms_experiment_),
-    ifs_(rhs.filename_cached_.c_str(), std::ios::binary),
     filename_(rhs.filename_),
+    filename_cached_(rhs.filename_cached_),
     spectra_index_(rhs.spectra_index_),
-    chrom_index_(rhs.chrom_index_)
+    chrom_index_(rhs.chrom_index_),
+    mapped_cache_(rhs.mapped_cache_)
   {
+    if (!mapped_cache_)
+    {
+      ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    }
   }
 
   boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessOpenMSCached::lightClone() const 
@@ -87,6 +104,20 @@ namespace OpenMS
     int ms_level = -1;
     double rt = -1.0;
 
+    if (mapped_cache_)
+    {
+      // the OpenSwath data structures own their data, a single copy out of
+      // the mapping is needed (no seeking, no locking)
+      MappedCachedmzML::SpectrumView view = mapped_cache_->getSpectrumView(id);
+      mz_array->data.assign(view.mz, view.mz + view.size);
+      intensity_array->data.assign(view.intensity, view.intensity + view.size);
+
+      OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+      sptr->setMZArray(mz_array);
+      sptr->setIntensityArray(intensity_array);
+      return sptr;
+    }
+
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -122,6 +153,18 @@ namespace OpenMS
     OpenSwath::BinaryDataArrayPtr rt_array(new OpenSwath::BinaryDataArray);
     OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
 
+    if (mapped_cache_)
+    {
+      MappedCachedmzML::ChromatogramView view = mapped_cache_->getChromatogramView(id);
+      rt_array->data.assign(view.rt, view.rt + view.size);
+      intensity_array->data.assign(view.intensity, view.intensity + view.size);
+
+      OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+      cptr->setTimeArray(rt_array);
+      cptr->setIntensityArray(intensity_array);
+      return cptr;
+    }
+
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
@@ -36,6 +36,7 @@
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/IsotopeDistributionTable.h>
 #include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
@@ -57,7 +58,8 @@ const double C13C12_MASSDIFF_U = 1.0033548;
 namespace OpenMS
 {
   DIAScoring::DIAScoring() :
-    DefaultParamHandler("DIAScoring")
+    DefaultParamHandler("DIAScoring"),
+    averagine_table_(&IsotopeDistributionTable::getPeptideTable())
   {
 
     defaults_.setValue("dia_extraction_window", 0.05, "DIA extraction window in Th.");
@@ -351,24 +353,20 @@ namespace OpenMS
     typedef OpenMS::FeatureFinderAlgorithmPickedHelperStructs::TheoreticalIsotopePattern TheoreticalIsotopePattern;
 
     TheoreticalIsotopePattern isotopes;
-    IsotopeDistribution isotope_dist;
     if (!sum_formula.empty())
     {
       // create the theoretical distribution from the sum formula
       EmpiricalFormula empf(sum_formula);
-      isotope_dist = empf.getIsotopeDistribution(dia_nr_isotopes_);
+      IsotopeDistribution isotope_dist = empf.getIsotopeDistribution(dia_nr_isotopes_);
+      for (IsotopeDistribution::Iterator it = isotope_dist.begin(); it != isotope_dist.end(); ++it)
+      {
+        isotopes.intensity.push_back(it->second);
+      }
     }
     else 
     {
-      // create the theoretical distribution from the peptide weight
-      isotope_dist.setMaxIsotope(dia_nr_isotopes_ + 1);
-      isotope_dist.estimateFromPeptideWeight(product_mz * putative_fragment_charge);
-    }
-
-
-    for (IsotopeDistribution::Iterator it = isotope_dist.begin(); it != isotope_dist.end(); ++it)
-    {
-      isotopes.intensity.push_back(it->second);
+      // create the theoretical distribution from the peptide weight (directly into the pattern)
+      averagine_table_->estimate(product_mz * putative_fragment_charge, (Size)dia_nr_isotopes_ + 1, isotopes.intensity);
     }
     isotopes.optional_begin = 0;
     isotopes.optional_end = dia_nr_isotopes_;
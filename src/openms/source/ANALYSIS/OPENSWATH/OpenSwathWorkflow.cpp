@@ -34,6 +34,11 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
 
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+
+#include <deque>
+
 // OpenSwathRetentionTimeNormalization
 namespace OpenMS
 {
@@ -381,6 +386,43 @@ namespace OpenMS
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// Number of buffered chromatograms (or TSV lines) after which a thread flushes its output
+    const Size PIPELINE_FLUSH_SIZE = 1000;
+
+    /// State of a single SWATH map in OpenSwathWorkflow::performExtractionPipelined
+    struct PipelineWindow
+    {
+      explicit PipelineWindow(Size idx) :
+        map_idx(idx), batch_size(0), nr_batches(0), next_batch(0), batches_done(0)
+      {
+      }
+
+      Size map_idx; ///< index into the input swath maps
+      OpenSwath::SpectrumAccessPtr map; ///< set once loaded, reset once all batches are scored
+      OpenSwath::LightTargetedExperiment transition_exp_used_all; ///< all transitions of this window
+      Size batch_size;
+      Size nr_batches;
+      Size next_batch; ///< next batch to be extracted
+      Size batches_done; ///< number of scored batches
+    };
+
+    /// An extracted batch waiting to be scored
+    struct PipelineBatch
+    {
+      explicit PipelineBatch(Size w) :
+        window(w)
+      {
+      }
+
+      Size window; ///< index of the PipelineWindow
+      OpenSwath::SpectrumAccessPtr map; ///< private clone of the SWATH map
+      OpenSwath::LightTargetedExperiment transition_exp_used;
+      std::vector< OpenMS::MSChromatogram<> > chromatograms;
+    };
+  }
+
   void OpenSwathWorkflow::performExtraction(
     const std::vector< OpenSwath::SwathMap > & swath_maps,
     const TransformationDescription trafo,
@@ -508,6 +550,306 @@ namespace OpenMS
     this->endProgress();
   }
 
+  void OpenSwathWorkflow::performExtractionPipelined(
+    const std::vector< OpenSwath::SwathMap > & swath_maps,
+    const TransformationDescription trafo,
+    const ChromExtractParams & cp,
+    const Param & feature_finder_param,
+    const OpenSwath::LightTargetedExperiment& transition_exp,
+    FeatureMap& out_featureFile,
+    bool store_features,
+    OpenSwathTSVWriter & tsv_writer,
+    Interfaces::IMSDataConsumer * chromConsumer,
+    int batchSize,
+    bool load_into_memory,
+    Size max_loaded_maps,
+    Size max_pending_batches)
+  {
+    tsv_writer.writeHeader();
+
+    // Compute inversion of the transformation
+    TransformationDescription trafo_inverse = trafo;
+    trafo_inverse.invert();
+
+    std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
+
+    // (i) Obtain precursor chromatograms (MS1) if precursor extraction is enabled
+    std::map< std::string, OpenSwath::ChromatogramPtr > ms1_chromatograms;
+    MS1Extraction_(swath_maps, ms1_chromatograms, chromConsumer, cp,
+                   transition_exp, trafo_inverse, load_into_memory);
+
+    // (ii) Set up the pipeline: one entry per MS2 SWATH map, in the order in
+    // which the maps were given to the program / acquired
+    std::vector<PipelineWindow> windows;
+    for (Size i = 0; i < swath_maps.size(); ++i)
+    {
+      if (!swath_maps[i].ms1) windows.push_back(PipelineWindow(i));
+    }
+    max_loaded_maps = std::max(max_loaded_maps, Size(1));
+    max_pending_batches = std::max(max_pending_batches, Size(1));
+
+    std::deque< boost::shared_ptr<PipelineBatch> > scoring_queue;
+    Size next_load = 0; // next window to be loaded
+    Size loaded_maps = 0; // windows being loaded or held in memory
+    Size pending_batches = 0; // batches being extracted or waiting for scoring
+    Size finished_windows = 0;
+    Size error_count = 0;
+    String error_message;
+
+    // Guards the pipeline state above; idle threads wait on the condition
+    // until another thread finishes a job (which may create new work)
+    QMutex pipeline_mutex;
+    QWaitCondition pipeline_changed;
+
+    int progress = 0;
+    this->startProgress(0, windows.size(), "Extracting and scoring transitions");
+
+    // (iii) Every thread repeatedly takes the most urgent job: scoring frees
+    // memory and is done first, extraction next and loading of a new map only
+    // if the memory limits allow it.
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // Thread-local output sinks, handed to the shared output in bulk
+      std::vector< OpenMS::MSChromatogram<> > chromatogram_sink;
+      FeatureMap feature_sink;
+      std::vector<String> tsv_sink;
+
+      bool done = false;
+      while (!done)
+      {
+        enum {NO_JOB, LOAD_JOB, EXTRACT_JOB, SCORE_JOB} job = NO_JOB;
+        Size w = 0, batch_idx = 0;
+        boost::shared_ptr<PipelineBatch> batch;
+
+        {
+          QMutexLocker locker(&pipeline_mutex);
+          while (true)
+          {
+            if (error_count > 0 || finished_windows == windows.size())
+            {
+              done = true;
+              break;
+            }
+            if (!scoring_queue.empty())
+            {
+              batch = scoring_queue.front();
+              scoring_queue.pop_front();
+              job = SCORE_JOB;
+              break;
+            }
+            if (pending_batches < max_pending_batches)
+            {
+              for (Size k = 0; k < next_load; ++k)
+              {
+                if (windows[k].map && windows[k].next_batch < windows[k].nr_batches)
+                {
+                  w = k;
+                  batch_idx = windows[k].next_batch++;
+                  ++pending_batches;
+                  job = EXTRACT_JOB;
+                  break;
+                }
+              }
+            }
+            if (job == NO_JOB && next_load < windows.size() && loaded_maps < max_loaded_maps)
+            {
+              w = next_load++;
+              ++loaded_maps;
+              job = LOAD_JOB;
+            }
+            if (job != NO_JOB) break;
+
+            // all remaining work is in progress on other threads, sleep until
+            // one of them finishes a job instead of polling the state
+            pipeline_changed.wait(&pipeline_mutex);
+          }
+        }
+
+        if (done) break;
+
+        try
+        {
+          if (job == LOAD_JOB)
+          {
+            PipelineWindow& window = windows[w];
+            const OpenSwath::SwathMap& swath_map = swath_maps[window.map_idx];
+
+            // Select which transitions to extract (proceed in batches)
+            OpenSwathHelper::selectSwathTransitions(transition_exp, window.transition_exp_used_all,
+                cp.min_upper_edge_dist, swath_map.lower, swath_map.upper);
+            Size nr_compounds = window.transition_exp_used_all.getCompounds().size();
+            Size batch_size = 0, nr_batches = 0;
+            if (!window.transition_exp_used_all.getTransitions().empty())
+            {
+              batch_size = (batchSize <= 0 || batchSize >= (int)nr_compounds) ? nr_compounds : batchSize;
+              nr_batches = nr_compounds / batch_size + 1;
+            }
+
+            OpenSwath::SpectrumAccessPtr current_swath_map = swath_map.sptr;
+            if (load_into_memory && nr_batches > 0)
+            {
+              // This creates an InMemory object that keeps all data in memory
+              current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
+            }
+
+            {
+              QMutexLocker locker(&pipeline_mutex);
+              if (nr_batches == 0)
+              {
+                // skip if no transitions found
+                --loaded_maps;
+                ++finished_windows;
+                this->setProgress(++progress);
+              }
+              else
+              {
+                window.batch_size = batch_size;
+                window.nr_batches = nr_batches;
+                window.map = current_swath_map;
+                std::cout << "Thread " <<
+#ifdef _OPENMP
+                omp_get_thread_num() << " " <<
+#endif
+                "will analyze " << nr_compounds <<  " compounds and "
+                << window.transition_exp_used_all.getTransitions().size() <<  " transitions "
+                "from SWATH " << window.map_idx << " in batches of " << window.batch_size << std::endl;
+              }
+              pipeline_changed.wakeAll();
+            }
+          }
+          else if (job == EXTRACT_JOB)
+          {
+            PipelineWindow& window = windows[w];
+            batch = boost::shared_ptr<PipelineBatch>(new PipelineBatch(w));
+
+            // The window itself is not modified while it has batches left, a
+            // light clone makes concurrent access to the same map safe.
+            batch->map = window.map->lightClone();
+
+            // Create the new, batch-size transition experiment
+            selectCompoundsForBatch_(window.transition_exp_used_all, batch->transition_exp_used, (int)window.batch_size, batch_idx);
+
+            // Prepare the extraction coordinates and extract chromatograms
+            ChromatogramExtractor extractor;
+            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
+            prepareExtractionCoordinates_(chrom_list, coordinates, batch->transition_exp_used, false, trafo_inverse, cp);
+            extractor.extractChromatograms(batch->map, chrom_list, coordinates, cp.mz_extraction_window,
+                cp.ppm, cp.extraction_function);
+            extractor.return_chromatogram(chrom_list, coordinates, batch->transition_exp_used, SpectrumSettings(), batch->chromatograms, false);
+
+            {
+              QMutexLocker locker(&pipeline_mutex);
+              scoring_queue.push_back(batch);
+              pipeline_changed.wakeAll();
+            }
+          }
+          else // SCORE_JOB
+          {
+            boost::shared_ptr<PeakMap > chrom_exp(new PeakMap);
+            chrom_exp->setChromatograms(batch->chromatograms);
+            OpenSwath::SpectrumAccessPtr chromatogram_ptr = OpenSwath::SpectrumAccessPtr(new OpenMS::SpectrumAccessOpenMS(chrom_exp));
+
+            FeatureMap featureFile;
+            std::vector< OpenSwath::SwathMap > dummy_maps;
+            OpenSwath::SwathMap dummy_map (swath_maps[windows[batch->window].map_idx]);
+            dummy_map.sptr = batch->map;
+            dummy_maps.push_back(dummy_map);
+            scoreAllChromatograms_(chromatogram_ptr, ms1_chromatograms, dummy_maps, batch->transition_exp_used,
+                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, tsv_sink);
+
+            // Collect the results locally, the shared output is only touched in bulk
+            chromatogram_sink.insert(chromatogram_sink.end(), batch->chromatograms.begin(), batch->chromatograms.end());
+            if (store_features)
+            {
+              for (FeatureMap::const_iterator feature_it = featureFile.begin();
+                   feature_it != featureFile.end(); ++feature_it)
+              {
+                feature_sink.push_back(*feature_it);
+              }
+              feature_sink.getProteinIdentifications().insert(feature_sink.getProteinIdentifications().end(),
+                  featureFile.getProteinIdentifications().begin(), featureFile.getProteinIdentifications().end());
+            }
+
+            {
+              QMutexLocker locker(&pipeline_mutex);
+              --pending_batches;
+              PipelineWindow& window = windows[batch->window];
+              if (++window.batches_done == window.nr_batches)
+              {
+                // release the SWATH map, the batches hold their own clones
+                window.map.reset();
+                window.transition_exp_used_all = OpenSwath::LightTargetedExperiment();
+                --loaded_maps;
+                ++finished_windows;
+                this->setProgress(++progress);
+              }
+              pipeline_changed.wakeAll();
+            }
+            batch.reset();
+          }
+        }
+        catch (std::exception& e)
+        {
+          {
+            QMutexLocker locker(&pipeline_mutex);
+            if (error_count++ == 0) error_message = e.what();
+            pipeline_changed.wakeAll();
+          }
+        }
+
+        // Step 4: write all chromatograms and features out into an output object / file
+        // (this needs to be done in a critical section since we only have one
+        // output file and one output map).
+        if (chromatogram_sink.size() >= PIPELINE_FLUSH_SIZE || tsv_sink.size() >= PIPELINE_FLUSH_SIZE)
+        {
+          flushPipelineSinks_(chromatogram_sink, feature_sink, tsv_sink, out_featureFile, store_features, tsv_writer, chromConsumer);
+        }
+      }
+
+      flushPipelineSinks_(chromatogram_sink, feature_sink, tsv_sink, out_featureFile, store_features, tsv_writer, chromConsumer);
+    }
+    this->endProgress();
+
+    if (error_count > 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Error during pipelined extraction and scoring (" + String(error_count) + " failed job(s)): " + error_message);
+    }
+  }
+
+  void OpenSwathWorkflow::flushPipelineSinks_(std::vector< OpenMS::MSChromatogram<> > & chromatograms,
+                                              FeatureMap& features,
+                                              std::vector<String>& tsv_lines,
+                                              FeatureMap& out_featureFile,
+                                              bool store_features,
+                                              OpenSwathTSVWriter & tsv_writer,
+                                              Interfaces::IMSDataConsumer * chromConsumer)
+  {
+    if (chromatograms.empty() && features.empty() && tsv_lines.empty()) return;
+
+#ifdef _OPENMP
+#pragma omp critical (featureFinder)
+#endif
+    {
+      writeOutFeaturesAndChroms_(chromatograms, features, out_featureFile, store_features, chromConsumer);
+    }
+    if (tsv_writer.isActive() && !tsv_lines.empty())
+    {
+#ifdef _OPENMP
+#pragma omp critical (scoreAll)
+#endif
+      {
+        tsv_writer.writeLines(tsv_lines);
+      }
+    }
+    chromatograms.clear();
+    features.clear(true);
+    tsv_lines.clear();
+  }
+
   void OpenSwathWorkflow::writeOutFeaturesAndChroms_(
     std::vector< OpenMS::MSChromatogram<> > & chromatograms,
     const FeatureMap & featureFile,
@@ -600,6 +942,33 @@ namespace OpenMS
     TransformationDescription trafo,
     const double rt_extraction_window,
     FeatureMap& output, OpenSwathTSVWriter & tsv_writer)
+  {
+    std::vector<String> to_output;
+    scoreAllChromatograms_(input, ms1_chromatograms, swath_maps, transition_exp, feature_finder_param,
+        trafo, rt_extraction_window, output, tsv_writer, to_output);
+
+    // Only write at the very end since this is a step that needs a barrier
+    if (tsv_writer.isActive())
+    {
+#ifdef _OPENMP
+#pragma omp critical (scoreAll)
+#endif
+      {
+        tsv_writer.writeLines(to_output);
+      }
+    }
+  }
+
+  void OpenSwathWorkflow::scoreAllChromatograms_(
+    const OpenSwath::SpectrumAccessPtr input,
+    const std::map< std::string, OpenSwath::ChromatogramPtr > & ms1_chromatograms,
+    const std::vector< OpenSwath::SwathMap > swath_maps,
+    OpenSwath::LightTargetedExperiment& transition_exp,
+    const Param& feature_finder_param,
+    TransformationDescription trafo,
+    const double rt_extraction_window,
+    FeatureMap& output, OpenSwathTSVWriter & tsv_writer,
+    std::vector<String>& to_output)
   {
     TransformationDescription trafo_inv = trafo;
     trafo_inv.invert();
@@ -641,7 +1010,6 @@ namespace OpenMS
       assay_map[transition_exp.getTransitions()[i].getPeptideRef()].push_back(&transition_exp.getTransitions()[i]);
     }
 
-    std::vector<String> to_output;
     // Iterating over all the assays
     for (AssayMapT::iterator assay_it = assay_map.begin(); assay_it != assay_map.end(); ++assay_it)
     {
@@ -717,17 +1085,6 @@ namespace OpenMS
         to_output.push_back(tsv_writer.prepareLine(pep, transition, output, id));
       }
     }
-
-    // Only write at the very end since this is a step that needs a barrier
-    if (tsv_writer.isActive())
-    {
-#ifdef _OPENMP
-#pragma omp critical (scoreAll)
-#endif
-      {
-        tsv_writer.writeLines(to_output);
-      }
-    }
   }
 
 
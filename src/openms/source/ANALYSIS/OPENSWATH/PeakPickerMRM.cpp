@@ -178,13 +178,6 @@ namespace OpenMS
 
   void PeakPickerMRM::pickChromatogram_(const MSChromatogram<>& chromatogram, MSChromatogram<>& picked_chrom)
   {
-    SignalToNoiseEstimatorMedian<MSChromatogram<> > snt;
-    Param snt_parameters = snt.getParameters();
-    snt_parameters.setValue("win_len", sn_win_len_);
-    snt_parameters.setValue("bin_count", sn_bin_count_);
-    snt_parameters.setValue("write_log_messages", param_.getValue("write_sn_log_messages"));
-    snt.setParameters(snt_parameters);
-
     integrated_intensities_.clear();
     left_width_.clear();
     right_width_.clear();
@@ -194,7 +187,7 @@ namespace OpenMS
 
     if (signal_to_noise_ > 0.0)
     {
-      snt.init(chromatogram);
+      snt_.init(chromatogram);
     }
     Size current_peak = 0;
     for (Size i = 0; i < picked_chrom.size(); i++)
@@ -210,7 +203,7 @@ namespace OpenMS
             && (chromatogram[min_i - k].getIntensity() < chromatogram[min_i - k + 1].getIntensity()
                || (peak_width_ > 0.0 && std::fabs(chromatogram[min_i - k].getMZ() - central_peak_mz) < peak_width_)
                 )
-            && (signal_to_noise_ > 0.0 && snt.getSignalToNoise(chromatogram[min_i - k]) >= signal_to_noise_) )
+            && (signal_to_noise_ > 0.0 && snt_.getSignalToNoise(chromatogram[min_i - k]) >= signal_to_noise_) )
       {
         ++k;
       }
@@ -223,7 +216,7 @@ namespace OpenMS
             && (chromatogram[min_i + k].getIntensity() < chromatogram[min_i + k - 1].getIntensity()
                || (peak_width_ > 0.0 && std::fabs(chromatogram[min_i + k].getMZ() - central_peak_mz) < peak_width_)
                 )
-            && (signal_to_noise_ > 0.0 && snt.getSignalToNoise(chromatogram[min_i + k]) >= signal_to_noise_) )
+            && (signal_to_noise_ > 0.0 && snt_.getSignalToNoise(chromatogram[min_i + k]) >= signal_to_noise_) )
       {
         ++k;
       }
@@ -421,6 +414,12 @@ namespace OpenMS
     write_sn_log_messages_ = (bool)param_.getValue("write_sn_log_messages").toBool();
     method_ = (String)param_.getValue("method");
 
+    Param snt_parameters = snt_.getParameters();
+    snt_parameters.setValue("win_len", sn_win_len_);
+    snt_parameters.setValue("bin_count", sn_bin_count_);
+    snt_parameters.setValue("write_log_messages", param_.getValue("write_sn_log_messages"));
+    snt_.setParameters(snt_parameters);
+
     if (method_ != "crawdad" && method_ != "corrected" && method_ != "legacy")
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
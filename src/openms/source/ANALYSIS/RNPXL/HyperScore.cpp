@@ -109,6 +109,43 @@ namespace OpenMS
       }
     }
 
+    return computeFromMatches(dot_product, y_ion_count, b_ion_count);
+  }
+
+  double HyperScore::compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const std::vector<double>& theo_mz, const std::vector<TheoreticalSpectrumGenerator::IonAnnotation>& theo_annotations)
+  {
+    double dot_product = 0.0;
+    UInt y_ion_count = 0;
+    UInt b_ion_count = 0;
+
+    for (Size i = 0; i < theo_mz.size(); ++i)
+    {
+      const double theo_mz_i = theo_mz[i];
+      double max_dist_dalton = fragment_mass_tolerance_unit_ppm ? theo_mz_i * fragment_mass_tolerance * 1e-6 : fragment_mass_tolerance;
+
+      // find nearest peak in experimental spectrum
+      Size index = exp_spectrum.findNearest(theo_mz_i);
+
+      // found peak match (theoretical intensity is 1)
+      if (std::abs(theo_mz_i - exp_spectrum[index].getMZ()) < max_dist_dalton)
+      {
+        dot_product += exp_spectrum[index].getIntensity();
+        if (theo_annotations[i].type == Residue::YIon)
+        {
+          ++y_ion_count;
+        }
+        else if (theo_annotations[i].type == Residue::BIon)
+        {
+          ++b_ion_count;
+        }
+      }
+    }
+
+    return computeFromMatches(dot_product, y_ion_count, b_ion_count);
+  }
+
+  double HyperScore::computeFromMatches(double dot_product, UInt y_ion_count, UInt b_ion_count)
+  {
     // discard very low scoring hits (basically no matching peaks)
     if (dot_product > 1e-1)
     {
@@ -0,0 +1,432 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/CompactPeptide.h>
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// number of residue types that have terminal groups (Full ... ZIon)
+    const Size NUMBER_OF_ION_TYPES = Residue::ZIon + 1;
+
+    /// does the N-terminal modification count for ion type @p type?
+    inline bool hasNTerminus(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::AIon || type == Residue::BIon ||
+             type == Residue::CIon || type == Residue::NTerminal;
+    }
+
+    /// does the C-terminal modification count for ion type @p type?
+    inline bool hasCTerminus(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::XIon || type == Residue::YIon ||
+             type == Residue::ZIon || type == Residue::CTerminal;
+    }
+
+    /// formula of the terminal groups of ion type @p type
+    EmpiricalFormula getTypeFormula(Residue::ResidueType type)
+    {
+      switch (type)
+      {
+        case Residue::Full: return Residue::getInternalToFull();
+        case Residue::NTerminal: return Residue::getInternalToNTerm();
+        case Residue::CTerminal: return Residue::getInternalToCTerm();
+        case Residue::AIon: return Residue::getInternalToAIon();
+        case Residue::BIon: return Residue::getInternalToBIon();
+        case Residue::CIon: return Residue::getInternalToCIon();
+        case Residue::XIon: return Residue::getInternalToXIon();
+        case Residue::YIon: return Residue::getInternalToYIon();
+        case Residue::ZIon: return Residue::getInternalToZIon();
+        default: return EmpiricalFormula();
+      }
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // CompactPeptide::Alphabet
+  // ---------------------------------------------------------------------------
+
+  CompactPeptide::Alphabet::Alphabet()
+  {
+    std::fill(one_letter_codes_, one_letter_codes_ + 256, -1);
+
+    // terminal groups of all ion types
+    for (Size type = 0; type < NUMBER_OF_ION_TYPES; ++type)
+    {
+      EmpiricalFormula formula = getTypeFormula(Residue::ResidueType(type));
+      type_mono_.push_back(formula.getMonoWeight());
+      type_average_.push_back(formula.getAverageWeight());
+      addComposition_(formula, type_composition_);
+    }
+
+    // code 0: no terminal modification
+    mods_.push_back(0);
+    mod_mono_.push_back(0.0);
+    mod_average_.push_back(0.0);
+    addComposition_(EmpiricalFormula(), mod_composition_);
+  }
+
+  void CompactPeptide::Alphabet::addComposition_(const EmpiricalFormula& formula, std::vector<Size>& bounds)
+  {
+    bounds.push_back(compositions_.size());
+    for (EmpiricalFormula::ConstIterator it = formula.begin(); it != formula.end(); ++it)
+    {
+      std::map<const Element*, Size>::const_iterator pos = element_index_.find(it->first);
+      Size index;
+      if (pos == element_index_.end())
+      {
+        index = elements_.size();
+        element_index_[it->first] = index;
+        elements_.push_back(it->first);
+      }
+      else
+      {
+        index = pos->second;
+      }
+      compositions_.push_back(std::make_pair(index, it->second));
+    }
+    bounds.push_back(compositions_.size());
+  }
+
+  void CompactPeptide::Alphabet::addToComposition_(const std::vector<Size>& bounds, Size index, std::vector<SignedSize>& composition, SignedSize factor) const
+  {
+    for (Size i = bounds[2 * index]; i < bounds[2 * index + 1]; ++i)
+    {
+      composition[compositions_[i].first] += factor * compositions_[i].second;
+    }
+  }
+
+  CompactPeptide::Code CompactPeptide::Alphabet::getResidueCode(const Residue& residue)
+  {
+    std::map<const Residue*, Code>::const_iterator pos = residue_codes_.find(&residue);
+    if (pos != residue_codes_.end()) return pos->second;
+
+    if (residues_.size() > 255)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, residues_.size() + 1);
+    }
+    Code code = Code(residues_.size());
+    residue_codes_[&residue] = code;
+    residues_.push_back(&residue);
+
+    // same contributions as in AASequence::getMonoWeight() / getAverageWeight()
+    EmpiricalFormula formula = residue.getFormula(Residue::Internal);
+    residue_mono_.push_back(residue.getMonoWeight(Residue::Internal));
+    double average = formula.getAverageWeight();
+    if (residue.getOneLetterCode() == "") // tag, e.g. "X[148.5]"
+    {
+      average += residue.getAverageWeight(Residue::Internal);
+    }
+    residue_average_.push_back(average);
+    addComposition_(formula, residue_composition_);
+
+    // unmodified residues can be looked up by one-letter code (as in AASequence::fromString())
+    const String& one_letter_code = residue.getOneLetterCode();
+    if (one_letter_code.size() == 1 && ResidueDB::getInstance()->getResidue((unsigned char)one_letter_code[0]) == &residue)
+    {
+      one_letter_codes_[(unsigned char)one_letter_code[0]] = code;
+    }
+    return code;
+  }
+
+  void CompactPeptide::Alphabet::addUnmodifiedResidues()
+  {
+    const ResidueDB* residue_db = ResidueDB::getInstance();
+    for (Size i = 0; i < 256; ++i)
+    {
+      const Residue* residue = residue_db->getResidue((unsigned char)i);
+      if (residue != 0)
+      {
+        getResidueCode(*residue);
+      }
+    }
+  }
+
+  void CompactPeptide::Alphabet::throwUnknownResidue_(char one_letter_code)
+  {
+    throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "One-letter code is not in the alphabet (see CompactPeptide::Alphabet::addUnmodifiedResidues()).", String(one_letter_code));
+  }
+
+  CompactPeptide::Code CompactPeptide::Alphabet::getModificationCode(const ResidueModification* mod)
+  {
+    if (mod == 0) return 0;
+
+    std::map<const ResidueModification*, Code>::const_iterator pos = mod_codes_.find(mod);
+    if (pos != mod_codes_.end()) return pos->second;
+
+    if (mods_.size() > 255)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, mods_.size());
+    }
+    Code code = Code(mods_.size());
+    mod_codes_[mod] = code;
+    mods_.push_back(mod);
+    mod_mono_.push_back(mod->getDiffMonoMass());
+    mod_average_.push_back(mod->getDiffFormula().getAverageWeight());
+    addComposition_(mod->getDiffFormula(), mod_composition_);
+    return code;
+  }
+
+  const Residue& CompactPeptide::Alphabet::getResidue(Code code) const
+  {
+    if (code >= residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, code, residues_.size());
+    }
+    return *residues_[code];
+  }
+
+  const ResidueModification* CompactPeptide::Alphabet::getModification(Code code) const
+  {
+    if (code >= mods_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, code, mods_.size());
+    }
+    return mods_[code];
+  }
+
+  Size CompactPeptide::Alphabet::size() const
+  {
+    return residues_.size();
+  }
+
+  const std::vector<const Element*>& CompactPeptide::Alphabet::getElements() const
+  {
+    return elements_;
+  }
+
+  double CompactPeptide::Alphabet::getTypeMonoWeight(Residue::ResidueType type) const
+  {
+    return Size(type) < type_mono_.size() ? type_mono_[type] : 0.0;
+  }
+
+  double CompactPeptide::Alphabet::getTypeAverageWeight(Residue::ResidueType type) const
+  {
+    return Size(type) < type_average_.size() ? type_average_[type] : 0.0;
+  }
+
+  // ---------------------------------------------------------------------------
+  // CompactPeptide
+  // ---------------------------------------------------------------------------
+
+  CompactPeptide::CompactPeptide() :
+    n_term_mod_(0),
+    c_term_mod_(0),
+    alphabet_(0)
+  {
+  }
+
+  CompactPeptide::CompactPeptide(const AASequence& sequence, Alphabet& alphabet) :
+    n_term_mod_(0),
+    c_term_mod_(0),
+    alphabet_(0)
+  {
+    assign(sequence, alphabet);
+  }
+
+  CompactPeptide::CompactPeptide(const StringView& sequence, const Alphabet& alphabet) :
+    n_term_mod_(0),
+    c_term_mod_(0),
+    alphabet_(0)
+  {
+    assign(sequence, alphabet);
+  }
+
+  void CompactPeptide::assign(const AASequence& sequence, Alphabet& alphabet)
+  {
+    alphabet_ = &alphabet;
+    residues_.resize(sequence.size());
+    for (Size i = 0; i < sequence.size(); ++i)
+    {
+      residues_[i] = alphabet.getResidueCode(sequence[i]);
+    }
+    n_term_mod_ = alphabet.getModificationCode(sequence.getNTerminalModification());
+    c_term_mod_ = alphabet.getModificationCode(sequence.getCTerminalModification());
+  }
+
+  void CompactPeptide::assign(const StringView& sequence, const Alphabet& alphabet)
+  {
+    alphabet_ = &alphabet;
+    residues_.resize(sequence.size());
+    const char* letters = sequence.data();
+    for (Size i = 0; i < sequence.size(); ++i)
+    {
+      residues_[i] = alphabet.getResidueCode(letters[i]);
+    }
+    n_term_mod_ = 0;
+    c_term_mod_ = 0;
+  }
+
+  Size CompactPeptide::size() const
+  {
+    return residues_.size();
+  }
+
+  bool CompactPeptide::empty() const
+  {
+    return residues_.empty();
+  }
+
+  const std::vector<CompactPeptide::Code>& CompactPeptide::getResidueCodes() const
+  {
+    return residues_;
+  }
+
+  CompactPeptide::Code CompactPeptide::getNTerminalModificationCode() const
+  {
+    return n_term_mod_;
+  }
+
+  CompactPeptide::Code CompactPeptide::getCTerminalModificationCode() const
+  {
+    return c_term_mod_;
+  }
+
+  const CompactPeptide::Alphabet* CompactPeptide::getAlphabet() const
+  {
+    return alphabet_;
+  }
+
+  double CompactPeptide::getMonoWeight_(Size begin, Size end, Code n_term_mod, Code c_term_mod, Residue::ResidueType type, Int charge) const
+  {
+    if (begin == end) return 0.0;
+
+    // same order of summation as AASequence::getMonoWeight()
+    double mono_weight(Constants::PROTON_MASS_U * charge);
+    if (n_term_mod != 0 && hasNTerminus(type)) mono_weight += alphabet_->mod_mono_[n_term_mod];
+    if (c_term_mod != 0 && hasCTerminus(type)) mono_weight += alphabet_->mod_mono_[c_term_mod];
+    for (Size i = begin; i < end; ++i)
+    {
+      mono_weight += alphabet_->residue_mono_[residues_[i]];
+    }
+    return mono_weight + alphabet_->getTypeMonoWeight(type);
+  }
+
+  double CompactPeptide::getMonoWeight(Residue::ResidueType type, Int charge) const
+  {
+    return getMonoWeight_(0, residues_.size(), n_term_mod_, c_term_mod_, type, charge);
+  }
+
+  double CompactPeptide::getPrefixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length > residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, residues_.size());
+    }
+    // the whole sequence keeps its C-terminal modification (as AASequence::getPrefix())
+    Code c_term_mod = (length == residues_.size()) ? c_term_mod_ : Code(0);
+    return getMonoWeight_(0, length, n_term_mod_, c_term_mod, type, charge);
+  }
+
+  double CompactPeptide::getSuffixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length > residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, residues_.size());
+    }
+    Code n_term_mod = (length == residues_.size()) ? n_term_mod_ : Code(0);
+    return getMonoWeight_(residues_.size() - length, residues_.size(), n_term_mod, c_term_mod_, type, charge);
+  }
+
+  double CompactPeptide::getAverageWeight(Residue::ResidueType type, Int charge) const
+  {
+    if (residues_.empty()) return 0.0;
+
+    double average_weight = (charge > 0) ? Constants::PROTON_MASS_U * charge : 0.0;
+    if (n_term_mod_ != 0 && hasNTerminus(type)) average_weight += alphabet_->mod_average_[n_term_mod_];
+    if (c_term_mod_ != 0 && hasCTerminus(type)) average_weight += alphabet_->mod_average_[c_term_mod_];
+    for (std::vector<Code>::const_iterator it = residues_.begin(); it != residues_.end(); ++it)
+    {
+      average_weight += alphabet_->residue_average_[*it];
+    }
+    return average_weight + alphabet_->getTypeAverageWeight(type);
+  }
+
+  void CompactPeptide::getComposition(std::vector<SignedSize>& composition, Residue::ResidueType type) const
+  {
+    composition.assign(alphabet_ ? alphabet_->elements_.size() : 0, 0);
+    if (residues_.empty()) return;
+
+    if (n_term_mod_ != 0 && hasNTerminus(type)) alphabet_->addToComposition_(alphabet_->mod_composition_, n_term_mod_, composition);
+    if (c_term_mod_ != 0 && hasCTerminus(type)) alphabet_->addToComposition_(alphabet_->mod_composition_, c_term_mod_, composition);
+    for (std::vector<Code>::const_iterator it = residues_.begin(); it != residues_.end(); ++it)
+    {
+      alphabet_->addToComposition_(alphabet_->residue_composition_, *it, composition);
+    }
+    if (Size(type) < NUMBER_OF_ION_TYPES)
+    {
+      alphabet_->addToComposition_(alphabet_->type_composition_, type, composition);
+    }
+  }
+
+  EmpiricalFormula CompactPeptide::getFormula(Residue::ResidueType type, Int charge) const
+  {
+    EmpiricalFormula formula;
+    if (residues_.empty()) return formula;
+
+    std::vector<SignedSize> composition;
+    getComposition(composition, type);
+    for (Size i = 0; i < composition.size(); ++i)
+    {
+      if (composition[i] != 0)
+      {
+        formula += EmpiricalFormula(composition[i], alphabet_->elements_[i]);
+      }
+    }
+    formula.setCharge(charge);
+    return formula;
+  }
+
+  bool CompactPeptide::operator==(const CompactPeptide& rhs) const
+  {
+    return alphabet_ == rhs.alphabet_ && residues_ == rhs.residues_ &&
+           n_term_mod_ == rhs.n_term_mod_ && c_term_mod_ == rhs.c_term_mod_;
+  }
+
+  bool CompactPeptide::operator!=(const CompactPeptide& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+} // namespace OpenMS
@@ -39,6 +39,9 @@
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <unsupported/Eigen/FFT>
+
+#include <complex>
 #include <iostream>
 
 using namespace std;
@@ -168,6 +171,80 @@ namespace OpenMS
     return result;
   }
 
+  IsotopeDistribution EmpiricalFormula::getIsotopeDistributionFFT(UInt max_depth) const
+  {
+    // nominal mass of the lightest isotope and number of isotopes of the whole formula
+    Size nominal_mass(0), length(1);
+    for (MapType_::const_iterator it = formula_.begin(); it != formula_.end(); ++it)
+    {
+      if (it->second < 0)
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Negative element counts have no isotope distribution", String(it->second));
+      }
+      const IsotopeDistribution::ContainerType& iso = it->first->getIsotopeDistribution().getContainer();
+      if (it->second == 0 || iso.empty()) continue;
+      nominal_mass += it->second * iso.front().first;
+      length += it->second * (iso.back().first - iso.front().first);
+    }
+
+    // the transform must be long enough to avoid wrap-around of the (cyclic) convolution
+    Size fft_size(2);
+    while (fft_size < length)
+    {
+      fft_size <<= 1;
+    }
+
+    // multiply the transforms of the element distributions, raised to the number of atoms
+    Eigen::FFT<double> fft;
+    std::vector<double> buffer(fft_size);
+    std::vector<std::complex<double> > transform, product(fft_size, std::complex<double>(1.0, 0.0));
+    for (MapType_::const_iterator it = formula_.begin(); it != formula_.end(); ++it)
+    {
+      const IsotopeDistribution::ContainerType& iso = it->first->getIsotopeDistribution().getContainer();
+      if (it->second == 0 || iso.empty()) continue;
+
+      std::fill(buffer.begin(), buffer.end(), 0.0);
+      for (IsotopeDistribution::ConstIterator iso_it = iso.begin(); iso_it != iso.end(); ++iso_it)
+      {
+        buffer[iso_it->first - iso.front().first] = iso_it->second;
+      }
+      fft.fwd(transform, buffer);
+      for (Size i = 0; i < fft_size; ++i)
+      {
+        product[i] *= std::pow(transform[i], (int)it->second);
+      }
+    }
+    fft.inv(buffer, product);
+
+    Size size = (max_depth != 0 && max_depth < length) ? max_depth : length;
+    IsotopeDistribution::ContainerType distribution(size);
+    double total(0.0), kept(0.0);
+    for (Size i = 0; i < length; ++i)
+    {
+      // rounding errors can produce tiny negative values
+      buffer[i] = std::max(buffer[i], 0.0);
+      total += buffer[i];
+      if (i < size)
+      {
+        distribution[i] = make_pair(nominal_mass + i, buffer[i]);
+        kept += buffer[i];
+      }
+    }
+
+    // The FFT has an absolute precision relative to the most abundant isotope. If
+    // only isotopes far below it are requested, their renormalized probabilities
+    // would be dominated by rounding errors, so compute them directly instead.
+    if (kept < 1e-3 * total)
+    {
+      return getIsotopeDistribution(max_depth);
+    }
+
+    IsotopeDistribution result(max_depth);
+    result.set(distribution);
+    result.renormalize();
+    return result;
+  }
+
   IsotopeDistribution EmpiricalFormula::getConditionalFragmentIsotopeDist(const EmpiricalFormula& precursor, const std::set<UInt>& precursor_isotopes) const
   {
     // A fragment's isotopes can only be as high as the largest isolated precursor isotope.
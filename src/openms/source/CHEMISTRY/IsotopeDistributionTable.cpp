@@ -0,0 +1,269 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/IsotopeDistributionTable.h>
+
+#include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/MATH/MISC/MathFunctions.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// averagine elements in the order of the table (hydrogen last)
+    enum AveragineElement {AVG_C, AVG_N, AVG_O, AVG_S, AVG_P, AVG_H, AVG_SIZE};
+  }
+
+  IsotopeDistributionTable::IsotopeDistributionTable(Size max_isotope, double max_weight, double C, double H, double N, double O, double S, double P) :
+    max_isotope_(max_isotope),
+    max_weight_(max_weight),
+    elements_(AVG_SIZE)
+  {
+    const ElementDB* db = ElementDB::getInstance();
+    const char* symbols[AVG_SIZE] = {"C", "N", "O", "S", "P", "H"};
+    const double composition[AVG_SIZE] = {C, N, O, S, P, H};
+    for (Size e = 0; e < AVG_SIZE; ++e)
+    {
+      elements_[e].element = db->getElement(symbols[e]);
+      elements_[e].composition = composition[e];
+      elements_[e].average_weight = elements_[e].element->getAverageWeight();
+    }
+
+    // same order of summation as in EmpiricalFormula::estimateFromWeightAndComp()
+    average_total_ = C * elements_[AVG_C].average_weight +
+                     H * elements_[AVG_H].average_weight +
+                     N * elements_[AVG_N].average_weight +
+                     O * elements_[AVG_O].average_weight +
+                     S * elements_[AVG_S].average_weight +
+                     P * elements_[AVG_P].average_weight;
+
+    const double max_factor = std::max(max_weight, 0.0) / average_total_;
+    for (Size e = 0; e < AVG_SIZE; ++e)
+    {
+      ElementRow_& row = elements_[e];
+      row.max_count = (Size) Math::round(row.composition * max_factor) + 1;
+      if (e == AVG_H)
+      {
+        // hydrogens compensate the rounding of all other elements
+        row.max_count += 64;
+      }
+
+      // distribution of a single atom without gaps
+      row.isotopes = row.element->getIsotopeDistribution().getContainer();
+      const IsotopeDistribution::ContainerType& iso = row.isotopes;
+      row.nominal_mass = iso.front().first;
+      row.width = iso.back().first - iso.front().first + 1;
+      std::vector<double> atom(row.width, 0.0);
+      for (IsotopeDistribution::ConstIterator it = iso.begin(); it != iso.end(); ++it)
+      {
+        atom[it->first - row.nominal_mass] = it->second;
+      }
+
+      // distributions of 0 ... max_count atoms, truncated to max_isotope_ isotopes
+      row.powers.assign((row.max_count + 1) * max_isotope_, 0.0);
+      if (max_isotope_ == 0) continue;
+      row.powers[0] = 1.0;
+      for (Size n = 1; n <= row.max_count; ++n)
+      {
+        const double* previous = &row.powers[(n - 1) * max_isotope_];
+        double* current = &row.powers[n * max_isotope_];
+        for (Size i = 0; i < max_isotope_; ++i)
+        {
+          double sum = 0.0;
+          for (Size j = 0; j < row.width && j <= i; ++j)
+          {
+            sum += previous[i - j] * atom[j];
+          }
+          current[i] = sum;
+        }
+      }
+    }
+  }
+
+  const IsotopeDistributionTable& IsotopeDistributionTable::getPeptideTable()
+  {
+    static IsotopeDistributionTable* table = 0;
+#ifdef _OPENMP
+#pragma omp critical (IsotopeDistributionTable_getTable)
+#endif
+    {
+      if (table == 0)
+      {
+        // Element counts are from Senko's Averagine model (as IsotopeDistribution::estimateFromPeptideWeight())
+        table = new IsotopeDistributionTable(20, 20000.0, 4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0);
+      }
+    }
+    return *table;
+  }
+
+  const IsotopeDistributionTable& IsotopeDistributionTable::getRNATable()
+  {
+    static IsotopeDistributionTable* table = 0;
+#ifdef _OPENMP
+#pragma omp critical (IsotopeDistributionTable_getTable)
+#endif
+    {
+      if (table == 0)
+      {
+        table = new IsotopeDistributionTable(20, 20000.0, 9.75, 12.25, 3.75, 7, 0, 1);
+      }
+    }
+    return *table;
+  }
+
+  const IsotopeDistributionTable& IsotopeDistributionTable::getDNATable()
+  {
+    static IsotopeDistributionTable* table = 0;
+#ifdef _OPENMP
+#pragma omp critical (IsotopeDistributionTable_getTable)
+#endif
+    {
+      if (table == 0)
+      {
+        table = new IsotopeDistributionTable(20, 20000.0, 9.75, 12.25, 3.75, 6, 0, 1);
+      }
+    }
+    return *table;
+  }
+
+  Size IsotopeDistributionTable::getMaxIsotope() const
+  {
+    return max_isotope_;
+  }
+
+  double IsotopeDistributionTable::getMaxWeight() const
+  {
+    return max_weight_;
+  }
+
+  void IsotopeDistributionTable::getCounts_(double average_weight, SignedSize* counts) const
+  {
+    const double factor = average_weight / average_total_;
+    double formula_weight = 0.0;
+    for (Size e = 0; e < AVG_H; ++e)
+    {
+      counts[e] = (SignedSize) Math::round(elements_[e].composition * factor);
+      formula_weight += counts[e] * elements_[e].average_weight;
+    }
+    // a negative number of hydrogens is not added to the formula
+    SignedSize adjusted_H = Math::round((average_weight - formula_weight) / elements_[AVG_H].average_weight);
+    counts[AVG_H] = std::max(adjusted_H, SignedSize(0));
+  }
+
+  Size IsotopeDistributionTable::estimateDirectly_(double average_weight, Size max_isotope, std::vector<double>& probabilities) const
+  {
+    IsotopeDistribution distribution(max_isotope);
+    distribution.estimateFromWeightAndComp(average_weight, elements_[AVG_C].composition, elements_[AVG_H].composition,
+                                           elements_[AVG_N].composition, elements_[AVG_O].composition,
+                                           elements_[AVG_S].composition, elements_[AVG_P].composition);
+    probabilities.resize(distribution.size());
+    for (Size i = 0; i < distribution.size(); ++i)
+    {
+      probabilities[i] = distribution.getContainer()[i].second;
+    }
+    return distribution.getMin();
+  }
+
+  Size IsotopeDistributionTable::estimate(double average_weight, Size max_isotope, std::vector<double>& probabilities) const
+  {
+    if (max_isotope == 0 || max_isotope > max_isotope_ || !(average_weight >= 0.0 && average_weight <= max_weight_))
+    {
+      return estimateDirectly_(average_weight, max_isotope, probabilities);
+    }
+
+    SignedSize counts[AVG_SIZE];
+    getCounts_(average_weight, counts);
+
+    Size nominal_mass = 0;
+    Size length = 1;
+    for (Size e = 0; e < AVG_SIZE; ++e)
+    {
+      if (counts[e] < 0 || Size(counts[e]) > elements_[e].max_count ||
+          elements_[e].element->getIsotopeDistribution().getContainer() != elements_[e].isotopes)
+      {
+        return estimateDirectly_(average_weight, max_isotope, probabilities);
+      }
+      nominal_mass += counts[e] * elements_[e].nominal_mass;
+      length += counts[e] * (elements_[e].width - 1);
+    }
+    const Size size = std::min(length, max_isotope);
+
+    // convolve the rows of all elements (in place, from the back)
+    probabilities.resize(size);
+    const double* first = &elements_[0].powers[counts[0] * max_isotope_];
+    std::copy(first, first + size, probabilities.begin());
+    for (Size e = 1; e < AVG_SIZE; ++e)
+    {
+      if (counts[e] == 0) continue;
+      const double* row = &elements_[e].powers[counts[e] * max_isotope_];
+      for (SignedSize i = size - 1; i >= 0; --i)
+      {
+        double sum = 0.0;
+        for (SignedSize j = i; j >= 0; --j)
+        {
+          sum += probabilities[j] * row[i - j];
+        }
+        probabilities[i] = sum;
+      }
+    }
+
+    double sum = 0.0;
+    for (Size i = size; i > 0; --i)
+    {
+      sum += probabilities[i - 1];
+    }
+    for (Size i = 0; i < size; ++i)
+    {
+      probabilities[i] /= sum;
+    }
+    return nominal_mass;
+  }
+
+  void IsotopeDistributionTable::estimate(double average_weight, IsotopeDistribution& distribution) const
+  {
+    std::vector<double> probabilities;
+    Size nominal_mass = estimate(average_weight, distribution.getMaxIsotope(), probabilities);
+    IsotopeDistribution::ContainerType container(probabilities.size());
+    for (Size i = 0; i < probabilities.size(); ++i)
+    {
+      container[i] = std::make_pair(nominal_mass + i, probabilities[i]);
+    }
+    distribution.set(container);
+  }
+
+} // namespace OpenMS
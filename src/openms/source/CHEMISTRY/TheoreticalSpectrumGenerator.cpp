@@ -116,6 +116,7 @@ namespace OpenMS
   TheoreticalSpectrumGenerator::TheoreticalSpectrumGenerator(const TheoreticalSpectrumGenerator & rhs) :
     DefaultParamHandler(rhs)
   {
+    updateMembers_();
   }
 
   TheoreticalSpectrumGenerator & TheoreticalSpectrumGenerator::operator=(const TheoreticalSpectrumGenerator & rhs)
@@ -123,6 +124,7 @@ namespace OpenMS
     if (this != &rhs)
     {
       DefaultParamHandler::operator=(rhs);
+      updateMembers_();
     }
     return *this;
   }
@@ -518,6 +520,167 @@ namespace OpenMS
     return;
   }
 
+  String TheoreticalSpectrumGenerator::IonAnnotation::toString() const
+  {
+    char letter = ' ';
+    switch (type)
+    {
+      case Residue::AIon: letter = 'a'; break;
+      case Residue::BIon: letter = 'b'; break;
+      case Residue::CIon: letter = 'c'; break;
+      case Residue::XIon: letter = 'x'; break;
+      case Residue::YIon: letter = 'y'; break;
+      case Residue::ZIon: letter = 'z'; break;
+      default: break;
+    }
+    return String(letter) + String(Size(index)) + String(Size(charge), '+');
+  }
+
+  namespace
+  {
+    /// state of one ion series (type and charge) while merging in getIonMZs_()
+    struct IonSeries
+    {
+      double weight; ///< accumulated weight (protons, terminal modification, residues)
+      double offset; ///< weight of the internal-to-ion formula
+      double mz; ///< m/z of the current ion
+      Int charge;
+      Residue::ResidueType type;
+      SignedSize residue; ///< next residue to add
+      SignedSize step; ///< direction: 1 for prefix ions, -1 for suffix ions
+      Size remaining; ///< number of ions not yet written (incl. the current one)
+      Size index; ///< ion number of the current ion
+    };
+
+    /// adds the next residue and computes the m/z of the next ion
+    inline void advanceIonSeries(IonSeries & series, const double * residue_weights, Size length)
+    {
+      series.weight += residue_weights[series.residue];
+      series.mz = (series.weight + series.offset) / series.charge;
+      series.index = series.step > 0 ? series.residue + 1 : length - series.residue;
+      series.residue += series.step;
+    }
+  }
+
+  template <typename MZType>
+  void TheoreticalSpectrumGenerator::getIonMZs_(std::vector<MZType> & mz, const AASequence & peptide, Int charge, std::vector<IonAnnotation> * annotations) const
+  {
+    mz.clear();
+    if (annotations) annotations->clear();
+    if (peptide.empty()) return;
+
+    const Size length = peptide.size();
+    if ((add_c_ions_ || add_x_ions_) && length < 2)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 1);
+    }
+
+    // internal residue weights (incl. modifications), looked up only once;
+    // short peptides need no heap memory
+    const Size stack_length = 64;
+    double stack_weights[stack_length];
+    std::vector<double> heap_weights;
+    double * residue_weights = stack_weights;
+    if (length > stack_length)
+    {
+      heap_weights.resize(length);
+      residue_weights = &heap_weights[0];
+    }
+    for (Size i = 0; i < length; ++i)
+    {
+      residue_weights[i] = peptide[i].getMonoWeight(Residue::Internal);
+    }
+
+    // enabled ion series with their internal-to-ion weights
+    std::pair<Residue::ResidueType, double> types[6];
+    Size n_types = 0;
+    if (add_b_ions_) types[n_types++] = std::make_pair(Residue::BIon, Residue::getInternalToBIon().getMonoWeight());
+    if (add_y_ions_) types[n_types++] = std::make_pair(Residue::YIon, Residue::getInternalToYIon().getMonoWeight());
+    if (add_a_ions_) types[n_types++] = std::make_pair(Residue::AIon, Residue::getInternalToAIon().getMonoWeight());
+    if (add_c_ions_) types[n_types++] = std::make_pair(Residue::CIon, Residue::getInternalToCIon().getMonoWeight());
+    if (add_x_ions_) types[n_types++] = std::make_pair(Residue::XIon, Residue::getInternalToXIon().getMonoWeight());
+    if (add_z_ions_) types[n_types++] = std::make_pair(Residue::ZIon, Residue::getInternalToZIon().getMonoWeight());
+    if (n_types == 0 || charge < 1) return;
+
+    const double n_term_diff = peptide.hasNTerminalModification() ? peptide.getNTerminalModification()->getDiffMonoMass() : 0.0;
+    const double c_term_diff = peptide.hasCTerminalModification() ? peptide.getCTerminalModification()->getDiffMonoMass() : 0.0;
+
+    // one series per type and charge; every series is sorted by m/z, so the
+    // output is a merge of the series (accumulation as in addPeaks())
+    const Size n_series = n_types * charge;
+    const Size stack_series_size = 24;
+    IonSeries stack_series[stack_series_size];
+    std::vector<IonSeries> heap_series;
+    IonSeries * series = stack_series;
+    if (n_series > stack_series_size)
+    {
+      heap_series.resize(n_series);
+      series = &heap_series[0];
+    }
+    Size total = 0;
+    for (Int z = 1; z <= charge; ++z)
+    {
+      for (Size t = 0; t < n_types; ++t)
+      {
+        IonSeries & current = series[(z - 1) * n_types + t];
+        current.type = types[t].first;
+        current.offset = types[t].second;
+        current.charge = z;
+        current.weight = Constants::PROTON_MASS_U * z;
+        if (current.type == Residue::AIon || current.type == Residue::BIon || current.type == Residue::CIon)
+        {
+          current.weight += n_term_diff;
+          current.step = 1;
+          current.residue = add_first_prefix_ion_ ? 0 : 1;
+          if (current.residue == 1) current.weight += residue_weights[0];
+          current.remaining = length - 1 > Size(current.residue) ? length - 1 - current.residue : 0;
+        }
+        else
+        {
+          current.weight += c_term_diff;
+          current.step = -1;
+          current.residue = length - 1;
+          current.remaining = length - 1;
+        }
+        if (current.remaining > 0) advanceIonSeries(current, residue_weights, length);
+        total += current.remaining;
+      }
+    }
+
+    mz.reserve(total);
+    if (annotations) annotations->reserve(total);
+    for (Size written = 0; written < total; ++written)
+    {
+      // find the series with the smallest current m/z
+      IonSeries * next = 0;
+      for (IonSeries * it = series; it != series + n_series; ++it)
+      {
+        if (it->remaining > 0 && (next == 0 || it->mz < next->mz)) next = it;
+      }
+
+      mz.push_back(MZType(next->mz));
+      if (annotations)
+      {
+        IonAnnotation annotation;
+        annotation.type = next->type;
+        annotation.charge = next->charge;
+        annotation.index = next->index;
+        annotations->push_back(annotation);
+      }
+      if (--next->remaining > 0) advanceIonSeries(*next, residue_weights, length);
+    }
+  }
+
+  void TheoreticalSpectrumGenerator::getIonMZs(std::vector<double> & mz, const AASequence & peptide, Int charge, std::vector<IonAnnotation> * annotations) const
+  {
+    getIonMZs_(mz, peptide, charge, annotations);
+  }
+
+  void TheoreticalSpectrumGenerator::getIonMZs(std::vector<float> & mz, const AASequence & peptide, Int charge, std::vector<IonAnnotation> * annotations) const
+  {
+    getIonMZs_(mz, peptide, charge, annotations);
+  }
+
   void TheoreticalSpectrumGenerator::addPrecursorPeaks(RichPeakSpectrum & spec, const AASequence & peptide, Int charge) const
   {
     RichPeak1D p;
@@ -4,6 +4,7 @@ set(directory source/CHEMISTRY)
 ### list all filenames of the directory here
 set(sources_list
 AASequence.cpp
+CompactPeptide.cpp
 CrossLinksDB.cpp
 Element.cpp
 ElementDB.cpp
@@ -13,6 +14,7 @@ EnzymaticDigestion.cpp
 Enzyme.cpp
 EnzymesDB.cpp
 IsotopeDistribution.cpp
+IsotopeDistributionTable.cpp
 ModificationDefinition.cpp
 ModificationDefinitionsSet.cpp
 ModificationsDB.cpp
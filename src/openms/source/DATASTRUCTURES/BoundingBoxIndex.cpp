@@ -0,0 +1,192 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/DATASTRUCTURES/BoundingBoxIndex.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// orders boxes by the center of one dimension
+    template <UInt DIM, typename EntryType>
+    struct CenterLess
+    {
+      bool operator()(const EntryType& a, const EntryType& b) const
+      {
+        return (a.box.minPosition()[DIM] + a.box.maxPosition()[DIM]) <
+               (b.box.minPosition()[DIM] + b.box.maxPosition()[DIM]);
+      }
+    };
+  }
+
+  BoundingBoxIndex::BoundingBoxIndex()
+  {
+  }
+
+  BoundingBoxIndex::BoundingBoxIndex(const std::vector<BoxType>& boxes)
+  {
+    build(boxes);
+  }
+
+  BoundingBoxIndex::~BoundingBoxIndex()
+  {
+  }
+
+  void BoundingBoxIndex::clear()
+  {
+    entries_.clear();
+    levels_.clear();
+    bounding_box_ = BoxType();
+  }
+
+  Size BoundingBoxIndex::size() const
+  {
+    return entries_.size();
+  }
+
+  bool BoundingBoxIndex::empty() const
+  {
+    return entries_.empty();
+  }
+
+  const BoundingBoxIndex::BoxType& BoundingBoxIndex::getBoundingBox() const
+  {
+    return bounding_box_;
+  }
+
+  void BoundingBoxIndex::build(const std::vector<BoxType>& boxes)
+  {
+    clear();
+    entries_.reserve(boxes.size());
+    for (Size i = 0; i < boxes.size(); ++i)
+    {
+      const BoxType& box = boxes[i];
+      // skip invalid boxes (but keep degenerate ones, e.g. single points)
+      if ((box.minPosition()[0] > box.maxPosition()[0]) ||
+          (box.minPosition()[1] > box.maxPosition()[1]))
+      {
+        continue;
+      }
+      Entry entry;
+      entry.box = box;
+      entry.index = i;
+      entries_.push_back(entry);
+      bounding_box_.enlarge(box.minPosition());
+      bounding_box_.enlarge(box.maxPosition());
+    }
+    if (entries_.empty()) return;
+
+    // Sort-Tile-Recursive packing: sort by RT, cut into vertical slices of
+    // about sqrt(#leaves) leaves each, sort every slice by m/z
+    Size n_leaves = (entries_.size() + fanout_ - 1) / fanout_;
+    Size n_slices = Size(std::ceil(std::sqrt(double(n_leaves))));
+    Size slice_size = ((n_leaves + n_slices - 1) / n_slices) * fanout_;
+    std::sort(entries_.begin(), entries_.end(), CenterLess<0, Entry>());
+    for (Size start = 0; start < entries_.size(); start += slice_size)
+    {
+      Size end = std::min(start + slice_size, entries_.size());
+      std::sort(entries_.begin() + start, entries_.begin() + end, CenterLess<1, Entry>());
+    }
+
+    // leaf level
+    levels_.push_back(std::vector<BoxType>(n_leaves));
+    for (Size i = 0; i < entries_.size(); ++i)
+    {
+      BoxType& node = levels_.back()[i / fanout_];
+      node.enlarge(entries_[i].box.minPosition());
+      node.enlarge(entries_[i].box.maxPosition());
+    }
+    // inner levels, up to the root
+    while (levels_.back().size() > 1)
+    {
+      const std::vector<BoxType> children = levels_.back();
+      levels_.push_back(std::vector<BoxType>((children.size() + fanout_ - 1) / fanout_));
+      for (Size i = 0; i < children.size(); ++i)
+      {
+        BoxType& node = levels_.back()[i / fanout_];
+        node.enlarge(children[i].minPosition());
+        node.enlarge(children[i].maxPosition());
+      }
+    }
+  }
+
+  void BoundingBoxIndex::query(const PositionType& position, std::vector<Size>& result) const
+  {
+    query_(BoxType(position, position), result);
+  }
+
+  void BoundingBoxIndex::query(const BoxType& box, std::vector<Size>& result) const
+  {
+    query_(box, result);
+  }
+
+  void BoundingBoxIndex::query_(const BoxType& box, std::vector<Size>& result) const
+  {
+    result.clear();
+    if (entries_.empty() || !bounding_box_.intersects(box)) return;
+
+    // depth-first traversal; stack holds (level, node index)
+    std::vector<std::pair<Size, Size> > stack;
+    stack.push_back(std::make_pair(levels_.size() - 1, Size(0)));
+    while (!stack.empty())
+    {
+      Size level = stack.back().first, node = stack.back().second;
+      stack.pop_back();
+      Size first = node * fanout_;
+      if (level == 0)
+      {
+        Size last = std::min(first + fanout_, entries_.size());
+        for (Size i = first; i < last; ++i)
+        {
+          if (entries_[i].box.intersects(box)) result.push_back(entries_[i].index);
+        }
+      }
+      else
+      {
+        const std::vector<BoxType>& children = levels_[level - 1];
+        Size last = std::min(first + fanout_, children.size());
+        for (Size i = first; i < last; ++i)
+        {
+          if (children[i].intersects(box)) stack.push_back(std::make_pair(level - 1, i));
+        }
+      }
+    }
+    std::sort(result.begin(), result.end());
+  }
+
+} // namespace OpenMS
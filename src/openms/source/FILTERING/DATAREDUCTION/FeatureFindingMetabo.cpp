@@ -34,6 +34,7 @@
 
 #include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/IsotopeDistributionTable.h>
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/SYSTEM/File.h>
@@ -294,13 +295,13 @@ namespace OpenMS
     report_convex_hulls_ = param_.getValue("report_convex_hulls").toBool();
   }
 
-  double FeatureFindingMetabo::computeAveragineSimScore_(const std::vector<double>& hypo_ints, const double& mol_weight) const
+  double FeatureFindingMetabo::computeAveragineSimScore_(const std::vector<double>& hypo_ints, const double& mol_weight,
+                                                         const IsotopeDistributionTable& averagine_table, std::vector<double>& averagine_ratios) const
   {
-    IsotopeDistribution isodist(hypo_ints.size());
-    isodist.estimateFromPeptideWeight(mol_weight);
-    // isodist.renormalize();
+    averagine_table.estimate(mol_weight, hypo_ints.size(), averagine_ratios);
+    // very light molecules have fewer isotopes
+    averagine_ratios.resize(hypo_ints.size(), 0.0);
 
-    std::vector<std::pair<Size, double> > averagine_dist = isodist.getContainer();
     double max_int(0.0), theo_max_int(0.0);
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
@@ -309,22 +310,27 @@ namespace OpenMS
         max_int = hypo_ints[i];
       }
 
-      if (averagine_dist[i].second > theo_max_int)
+      if (averagine_ratios[i] > theo_max_int)
       {
-        theo_max_int = averagine_dist[i].second;
+        theo_max_int = averagine_ratios[i];
       }
     }
 
-    // compute normalized intensities
-    std::vector<double> averagine_ratios, hypo_isos;
+    // cosine similarity of the normalized intensities (see computeCosineSim_)
+    double mixed_sum(0.0);
+    double x_squared_sum(0.0);
+    double y_squared_sum(0.0);
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
-      averagine_ratios.push_back(averagine_dist[i].second / theo_max_int);
-      hypo_isos.push_back(hypo_ints[i] / max_int);
+      const double x(averagine_ratios[i] / theo_max_int);
+      const double y(hypo_ints[i] / max_int);
+      mixed_sum += x * y;
+      x_squared_sum += x * x;
+      y_squared_sum += y * y;
     }
 
-    double iso_score = computeCosineSim_(averagine_ratios, hypo_isos);
-    return iso_score;
+    double denom(std::sqrt(x_squared_sum) * std::sqrt(y_squared_sum));
+    return (denom > 0.0) ? mixed_sum / denom : 0.0;
   }
 
   int FeatureFindingMetabo::isLegalIsotopePattern_(const FeatureHypothesis& feat_hypo) const
@@ -506,72 +512,55 @@ namespace OpenMS
 
     // continue to check overlap and cosine similarity
     // ...
-    std::map<double, std::vector<double> > coinciding_rts;
-
     std::pair<Size, Size> tr1_fwhm_idx(tr1.getFWHMborders());
     std::pair<Size, Size> tr2_fwhm_idx(tr2.getFWHMborders());
 
-    //    std::cout << tr1_fwhm_idx.first << " " << tr1_fwhm_idx.second << std::endl;
-    //    std::cout << tr2_fwhm_idx.first << " " << tr2_fwhm_idx.second << std::endl;
-
-    //    Size tr1_fwhm_size(tr1_fwhm_idx.second - tr1_fwhm_idx.first);
-    //    Size tr2_fwhm_size(tr2_fwhm_idx.second - tr2_fwhm_idx.first);
-
-    //    double max_length = (tr1_fwhm_size > tr2_fwhm_size) ? tr1_fwhm_size : tr2_fwhm_size;
-
     double tr1_length(tr1.getFWHM());
     double tr2_length(tr2.getFWHM());
     double max_length = (tr1_length > tr2_length) ? tr1_length : tr2_length;
 
-    // std::cout << "tr1 " << tr1_length << " tr2 " << tr2_length << std::endl;
-
-    // Extract peak shape between FWHM borders for both peaks
-    for (Size i = tr1_fwhm_idx.first; i <= tr1_fwhm_idx.second; ++i)
-    {
-      coinciding_rts[tr1[i].getRT()].push_back(tr1[i].getIntensity());
-    }
-    for (Size i = tr2_fwhm_idx.first; i <= tr2_fwhm_idx.second; ++i)
-    {
-      coinciding_rts[tr2[i].getRT()].push_back(tr2[i].getIntensity());
-    }
-
-    // Look at peaks at the same RT 
+    // Look at peaks at the same RT between the FWHM borders of both peaks
+    // (both traces are sorted by RT, so a merge yields the coinciding RTs in
+    // ascending order) and compute their cosine similarity on the fly
     // TODO: this only works if both traces are sampled with equal rate at the same RT
-    std::vector<double> x, y, overlap_rts;
-    for (std::map<double, std::vector<double> >::const_iterator m_it = coinciding_rts.begin(); m_it != coinciding_rts.end(); ++m_it)
-    {
-      if (m_it->second.size() == 2)
+    double mixed_sum(0.0), x_squared_sum(0.0), y_squared_sum(0.0);
+    double start_rt(0.0), end_rt(0.0);
+    Size overlap_count(0);
+    Size i1(tr1_fwhm_idx.first), i2(tr2_fwhm_idx.first);
+    while (i1 <= tr1_fwhm_idx.second && i2 <= tr2_fwhm_idx.second)
+    {
+      const double rt1(tr1[i1].getRT()), rt2(tr2[i2].getRT());
+      if (rt1 < rt2)
+      {
+        ++i1;
+      }
+      else if (rt2 < rt1)
+      {
+        ++i2;
+      }
+      else
       {
-        x.push_back(m_it->second[0]);
-        y.push_back(m_it->second[1]);
-        overlap_rts.push_back(m_it->first);
+        const double x(tr1[i1].getIntensity()), y(tr2[i2].getIntensity());
+        mixed_sum += x * y;
+        x_squared_sum += x * x;
+        y_squared_sum += y * y;
+        if (overlap_count == 0) start_rt = rt1;
+        end_rt = rt1;
+        ++overlap_count;
+        ++i1;
+        ++i2;
       }
     }
 
-    //    if (x.size() < std::floor(0.8*max_length))
-    //        {
-    //            return 0.0;
-    //        }
-    // double rt_range(0.0)
-    // if (coinciding_rts.size() > 0)
-    // {
-    //     rt_range = std::fabs(coinciding_rts.rbegin()->first - coinciding_rts.begin()->first);
-    // }
-
-
-    double overlap(0.0);
-    if (overlap_rts.size() > 0)
-    {
-      double start_rt(*(overlap_rts.begin())), end_rt(*(overlap_rts.rbegin()));
-      overlap = std::fabs(end_rt - start_rt);
-    }
+    double overlap(std::fabs(end_rt - start_rt));
 
     double proportion(overlap / max_length);
     if (proportion < 0.7)
     {
       return 0.0;
     }
-    return computeCosineSim_(x, y);
+    double denom(std::sqrt(x_squared_sum) * std::sqrt(y_squared_sum));
+    return (denom > 0.0) ? mixed_sum / denom : 0.0;
   }
 
   double FeatureFindingMetabo::computeCosineSim_(const std::vector<double>& x, const std::vector<double>& y) const
@@ -597,20 +586,19 @@ namespace OpenMS
   }
 
 
-  void FeatureFindingMetabo::findLocalFeatures_(const std::vector<const MassTrace*>& candidates, const double total_intensity, std::vector<FeatureHypothesis>& output_hypotheses) const
+  void FeatureFindingMetabo::findLocalFeatures_(const std::vector<const MassTrace*>& candidates, const double total_intensity,
+                                                const IsotopeDistributionTable& averagine_table, std::vector<FeatureHypothesis>& output_hypotheses) const
   {
     // single Mass trace hypothesis
     FeatureHypothesis tmp_hypo;
     tmp_hypo.addMassTrace(*candidates[0]);
     tmp_hypo.setScore((candidates[0]->getIntensity(use_smoothed_intensities_)) / total_intensity);
+    output_hypotheses.push_back(tmp_hypo);
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
-    {
-      // pushing back to shared vector needs to be synchronized
-      output_hypotheses.push_back(tmp_hypo);
-    }
+    // the RT score does not depend on charge and isotopic position: compute it once per candidate
+    std::vector<double> rt_scores(candidates.size(), -1.0);
+    std::vector<double> hypo_ints;
+    std::vector<double> averagine_ratios;
 
     for (Size charge = charge_lower_bound_; charge <= charge_upper_bound_; ++charge)
     {
@@ -622,6 +610,8 @@ namespace OpenMS
       // double mono_iso_mz(candidates[0]->getCentroidMZ());
       // double mono_iso_int(candidates[0]->computePeakArea());
 
+      hypo_ints.clear();
+
       Size last_iso_idx(0);
       Size iso_pos_max(static_cast<Size>(std::floor(charge * local_mz_range_)));
       for (Size iso_pos = 1; iso_pos <= iso_pos_max; ++iso_pos)
@@ -643,8 +633,11 @@ namespace OpenMS
 #endif
 
           // Score current mass trace candidates against hypothesis
-          double rt_score(scoreRT_(*candidates[0], *candidates[mt_idx]));
           double mz_score(scoreMZ_(*candidates[0], *candidates[mt_idx], iso_pos, charge));
+          if (mz_score <= 0.0) continue; // cannot be better than best_so_far
+
+          if (rt_scores[mt_idx] < 0.0) rt_scores[mt_idx] = scoreRT_(*candidates[0], *candidates[mt_idx]);
+          double rt_score(rt_scores[mt_idx]);
 
           // disable intensity scoring for now...
           double int_score(1.0);
@@ -652,9 +645,10 @@ namespace OpenMS
 
           if (isotope_filtering_model_ == "peptides")
           {
-            std::vector<double> tmp_ints(fh_tmp.getAllIntensities());
-            tmp_ints.push_back(candidates[mt_idx]->getIntensity(use_smoothed_intensities_));
-            int_score = computeAveragineSimScore_(tmp_ints, candidates[mt_idx]->getCentroidMZ() * charge);
+            if (hypo_ints.empty()) hypo_ints = fh_tmp.getAllIntensities();
+            hypo_ints.push_back(candidates[mt_idx]->getIntensity(use_smoothed_intensities_));
+            int_score = computeAveragineSimScore_(hypo_ints, candidates[mt_idx]->getCentroidMZ() * charge, averagine_table, averagine_ratios);
+            hypo_ints.pop_back();
           }
 
 #ifdef FFM_DEBUG
@@ -685,14 +679,9 @@ namespace OpenMS
           fh_tmp.setScore(fh_tmp.getScore() + weighted_score);
           fh_tmp.setCharge(charge);
           last_iso_idx = best_idx;
+          hypo_ints.clear();
 
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_FFMetabo_output_hypos)
-#endif
-          {
-            // pushing back to shared vector needs to be synchronized
-            output_hypotheses.push_back(fh_tmp);
-          }
+          output_hypotheses.push_back(fh_tmp);
         }
         else
         {
@@ -706,6 +695,78 @@ namespace OpenMS
     } // end for charge
   } // end of findLocalFeatures_(...)
 
+  namespace
+  {
+    /**
+      @brief Grid of RT buckets over the centroids of mass traces sorted by m/z
+
+      Each bucket holds the indices of its traces in ascending order (i.e. in
+      order of m/z), so the neighbors of a trace are found by a binary search
+      in three adjacent buckets.
+    */
+    class TraceGrid
+    {
+  public:
+      TraceGrid(const std::vector<MassTrace>& traces, double rt_range) :
+        mz_(traces.size()),
+        rt_(traces.size()),
+        rt_min_(0.0),
+        bucket_width_(1.0)
+      {
+        for (Size i = 0; i < traces.size(); ++i)
+        {
+          mz_[i] = traces[i].getCentroidMZ();
+          rt_[i] = traces[i].getCentroidRT();
+        }
+        if (traces.empty()) return;
+
+        rt_min_ = *std::min_element(rt_.begin(), rt_.end());
+        const double rt_max(*std::max_element(rt_.begin(), rt_.end()));
+        // buckets (slightly) wider than the RT range, so neighbors are in
+        // adjacent buckets, and not more buckets than traces
+        bucket_width_ = std::max(rt_range, (rt_max - rt_min_) / traces.size()) * 1.001;
+        if (!(bucket_width_ > 0.0)) bucket_width_ = 1.0;
+
+        buckets_.resize(bucketOf_(rt_max) + 1);
+        for (Size i = 0; i < traces.size(); ++i)
+        {
+          buckets_[bucketOf_(rt_[i])].push_back(i);
+        }
+      }
+
+      /// Indices (ascending) of all traces after @p idx with an m/z difference up to @p mz_range and an RT difference up to @p rt_range
+      void findNeighbors(Size idx, double mz_range, double rt_range, std::vector<Size>& neighbors) const
+      {
+        neighbors.clear();
+        const Size bucket(bucketOf_(rt_[idx]));
+        const Size first_bucket(bucket > 0 ? bucket - 1 : 0);
+        const Size last_bucket(std::min(bucket + 1, buckets_.size() - 1));
+        for (Size b = first_bucket; b <= last_bucket; ++b)
+        {
+          for (std::vector<Size>::const_iterator it = std::upper_bound(buckets_[b].begin(), buckets_[b].end(), idx); it != buckets_[b].end(); ++it)
+          {
+            // traces are sorted by m/z, so we can break when we leave the allowed window
+            if (std::fabs(mz_[*it] - mz_[idx]) > mz_range) break;
+            if (std::fabs(rt_[*it] - rt_[idx]) <= rt_range) neighbors.push_back(*it);
+          }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+      }
+
+  private:
+      Size bucketOf_(double rt) const
+      {
+        return static_cast<Size>((rt - rt_min_) / bucket_width_);
+      }
+
+      std::vector<double> mz_;
+      std::vector<double> rt_;
+      double rt_min_;
+      double bucket_width_;
+      std::vector<std::vector<Size> > buckets_;
+    };
+  }
+
   void FeatureFindingMetabo::run(std::vector<MassTrace>& input_mtraces, FeatureMap& output_featmap)
   {
     output_featmap.clear();
@@ -744,42 +805,72 @@ namespace OpenMS
     // Step 2 Iterate through all mass traces to find likely matches 
     // and generate isotopic / charge hypotheses
     // *********************************************************** //
-    std::vector<FeatureHypothesis> feat_hypos;
+    const TraceGrid trace_grid(input_mtraces, local_rt_range_);
+    // fetched once, the shared table is then read concurrently
+    const IsotopeDistributionTable& averagine_table = IsotopeDistributionTable::getPeptideTable();
+
+    // hypotheses are collected per thread and merged in order of their
+    // monoisotopic trace, i.e. the result does not depend on the number of threads
+    Size nr_threads(1);
+#ifdef _OPENMP
+    nr_threads = omp_get_max_threads();
+#endif
+    std::vector<std::vector<FeatureHypothesis> > thread_hypos(nr_threads);
+    std::vector<std::pair<Size, Size> > trace_hypos(input_mtraces.size()); // thread, end of the hypotheses of each trace
     Size progress(0);
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel
 #endif
-    for (SignedSize i = 0; i < (SignedSize)input_mtraces.size(); ++i)
     {
-      IF_MASTERTHREAD this->setProgress(progress);
+      Size thread_num(0);
 #ifdef _OPENMP
-#pragma omp atomic
+      thread_num = omp_get_thread_num();
 #endif
-      ++progress;
-
+      std::vector<FeatureHypothesis>& hypos = thread_hypos[thread_num];
+      std::vector<Size> neighbors;
       std::vector<const MassTrace*> local_traces;
-      double ref_trace_mz(input_mtraces[i].getCentroidMZ());
-      double ref_trace_rt(input_mtraces[i].getCentroidRT());
-
-      local_traces.push_back(&input_mtraces[i]);
 
-      for (Size ext_idx = i + 1; ext_idx < input_mtraces.size(); ++ext_idx)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)input_mtraces.size(); ++i)
       {
-        // traces are sorted by m/z, so we can break when we leave the allowed window
-        double diff_mz = std::fabs(input_mtraces[ext_idx].getCentroidMZ() - ref_trace_mz);
-        if (diff_mz > local_mz_range_) break;
+        IF_MASTERTHREAD this->setProgress(progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
 
-        double diff_rt = std::fabs(input_mtraces[ext_idx].getCentroidRT() - ref_trace_rt);
-        if (diff_rt <= local_rt_range_)
+        trace_grid.findNeighbors(i, local_mz_range_, local_rt_range_, neighbors);
+
+        local_traces.clear();
+        local_traces.push_back(&input_mtraces[i]);
+        for (Size n = 0; n < neighbors.size(); ++n)
         {
-          // std::cout << " accepted!" << std::endl;
-          local_traces.push_back(&input_mtraces[ext_idx]);
+          local_traces.push_back(&input_mtraces[neighbors[n]]);
         }
+        findLocalFeatures_(local_traces, total_intensity, averagine_table, hypos);
+        trace_hypos[i] = std::make_pair(thread_num, hypos.size());
       }
-      findLocalFeatures_(local_traces, total_intensity, feat_hypos);
     }
     this->endProgress();
 
+    std::vector<FeatureHypothesis> feat_hypos;
+    Size nr_hypos(0);
+    for (Size t = 0; t < nr_threads; ++t)
+    {
+      nr_hypos += thread_hypos[t].size();
+    }
+    feat_hypos.reserve(nr_hypos);
+    std::vector<Size> thread_pos(nr_threads, 0);
+    for (Size i = 0; i < trace_hypos.size(); ++i)
+    {
+      const Size t(trace_hypos[i].first);
+      feat_hypos.insert(feat_hypos.end(), thread_hypos[t].begin() + thread_pos[t], thread_hypos[t].begin() + trace_hypos[i].second);
+      thread_pos[t] = trace_hypos[i].second;
+    }
+    thread_hypos.clear();
+
     // sort feature candidates by their score
     std::sort(feat_hypos.begin(), feat_hypos.end(), CmpHypothesesByScore());
 
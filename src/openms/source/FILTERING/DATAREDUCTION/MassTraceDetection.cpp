@@ -43,6 +43,7 @@
 #include <algorithm>
 #include <numeric>
 #include <sstream>
+#include <limits>
 
 #include <boost/dynamic_bitset.hpp>
 
@@ -70,6 +71,9 @@ namespace OpenMS
     defaults_.setValue("min_trace_length", 5.0, "Minimum expected length of a mass trace (in seconds).", ListUtils::create<String>("advanced"));
     defaults_.setValue("max_trace_length", -1.0, "Maximum expected length of a mass trace (in seconds). Set to a negative value to disable maximal length check during mass trace detection.", ListUtils::create<String>("advanced"));
 
+    defaults_.setValue("mz_stripes", 0, "Number of m/z stripes in which mass traces are detected in parallel (0 or 1: serial detection). Traces crossing stripe borders are resolved serially afterwards, so results may differ slightly from serial detection.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("mz_stripes", 0);
+
     defaultsToParam_();
 
     this->setLogType(CMD);
@@ -195,32 +199,138 @@ namespace OpenMS
   }
 
 
+  namespace
+  {
+    /// Overlap of neighboring m/z stripes (in multiples of the allowed mass deviation at the stripe border)
+    const double STRIPE_OVERLAP_FACTOR = 10.0;
+
+    /// Orders apex candidates by decreasing intensity (equal intensities: later peaks first, as in a reverse traversal of a multimap)
+    struct ApexGreater
+    {
+      template <typename ApexType>
+      bool operator()(const ApexType& a, const ApexType& b) const
+      {
+        return a.intensity > b.intensity || (a.intensity == b.intensity && a.peak_idx > b.peak_idx);
+      }
+    };
+
+    /// Index of the peak closest to @p mz in [@p first, @p last) (same rules as MSSpectrum::findNearest)
+    Size findNearestPeak_(const std::vector<double>& mzs, Size first, Size last, double mz)
+    {
+      const Size it = std::lower_bound(mzs.begin() + first, mzs.begin() + last, mz) - mzs.begin();
+      if (it == first) return first;
+      if (it == last) return last - 1;
+      return (std::fabs(mzs[it] - mz) < std::fabs(mzs[it - 1] - mz)) ? it : it - 1;
+    }
+  }
+
   void MassTraceDetection::run(const PeakMap& input_exp, std::vector<MassTrace>& found_masstraces)
   {
     // make sure the output vector is empty
     found_masstraces.clear();
 
-    // gather all peaks that are potential chromatographic peak apices
-    //   - use work_exp for actual work (remove peaks below noise threshold)
-    //   - store potential apices in chrom_apices
-    PeakMap work_exp;
-    MapIdxSortedByInt chrom_apices;
+    // *********************************************************** //
+    //  Step 1: Detecting potential chromatographic apices
+    // *********************************************************** //
+    PeakArrays peaks;
+    std::vector<Apex> apices;
+    collectPeaks_(input_exp, peaks, apices);
 
-    Size total_peak_count(0);
-    std::vector<Size> spec_offsets;
-    spec_offsets.push_back(0);
+    // *********************************************************************
+    // Step 2: start extending mass traces beginning with the apex peak (go
+    // through all peaks in order of decreasing intensity)
+    // *********************************************************************
+    const Size total_peak_count(peaks.mz.size());
+    boost::dynamic_bitset<> peak_visited(total_peak_count);
+    std::vector<char> apex_resolved(apices.size(), 0);
+    TraceBuffer traces;
+    traces.offsets.push_back(0);
 
-    Size spectra_count(0);
+    this->startProgress(0, total_peak_count, "mass trace detection");
+
+    // Step 2.0: detect traces in m/z stripes in parallel (optional)
+    if (mz_stripes_ > 1)
+    {
+      runStripes_(peaks, apices, mz_stripes_, peak_visited, apex_resolved, traces);
+    }
+    Size peaks_detected(traces.peaks.size());
+    this->setProgress(peaks_detected);
+
+    // Step 2.1: all apices not resolved in a stripe
+    std::vector<Size> trace;
+    std::pair<double, double> mz_bounds(std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+    for (Size rank = 0; rank < apices.size(); ++rank)
+    {
+      if (apex_resolved[rank] || peak_visited[apices[rank].peak_idx])
+      {
+        continue;
+      }
+      if (extendTrace_(peaks, apices[rank].scan_idx, apices[rank].peak_idx, peak_visited, trace, mz_bounds))
+      {
+        // mark all peaks as visited
+        for (Size i = 0; i < trace.size(); ++i)
+        {
+          peak_visited[trace[i]] = true;
+        }
+        traces.apex_rank.push_back(rank);
+        traces.peaks.insert(traces.peaks.end(), trace.begin(), trace.end());
+        traces.offsets.push_back(traces.peaks.size());
+
+        peaks_detected += trace.size();
+        this->setProgress(peaks_detected);
+      }
+    }
+
+    this->endProgress();
 
     // *********************************************************** //
-    //  Step 1: Detecting potential chromatographic apices
+    // Step 3: create the mass traces (in order of decreasing apex intensity)
     // *********************************************************** //
+    std::vector<std::pair<Size, Size> > order; // apex rank, index in traces
+    order.reserve(traces.apex_rank.size());
+    for (Size i = 0; i < traces.apex_rank.size(); ++i)
+    {
+      order.push_back(std::make_pair(traces.apex_rank[i], i));
+    }
+    std::sort(order.begin(), order.end());
+
+    found_masstraces.reserve(order.size());
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      const Size t = order[i].second;
+      found_masstraces.push_back(createMassTrace_(peaks, traces.peaks.begin() + traces.offsets[t], traces.peaks.begin() + traces.offsets[t + 1]));
+      found_masstraces.back().setLabel("T" + String(i + 1));
+    }
+
+    return;
+  } // end of MassTraceDetection::run
+
+  void MassTraceDetection::collectPeaks_(const PeakMap& input_exp, PeakArrays& peaks, std::vector<Apex>& apices) const
+  {
+    peaks = PeakArrays();
+    peaks.spec_offsets.push_back(0);
+    apices.clear();
+
+    // gather all peaks that are potential chromatographic peak apices
+    //   - only keep peaks above the noise threshold
+    //   - store potential apices in apices
+    Size fwhm_meta_count(0);
     for (PeakMap::ConstIterator it = input_exp.begin(); it != input_exp.end(); ++it)
     {
       // check if this is a MS1 survey scan
       if (it->getMSLevel() != 1) continue;
 
-      std::vector<Size> indices_passing;
+      // check presence of FWHM meta data
+      const bool has_fwhm = !it->getFloatDataArrays().empty() && it->getFloatDataArrays()[0].getName() == "FWHM_ppm";
+      if (has_fwhm)
+      {
+        if (it->getFloatDataArrays()[0].size() != it->size())
+        { // float data should always have the same size as the corresponding array
+          throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, it->size());
+        }
+        ++fwhm_meta_count;
+      }
+
       for (Size peak_idx = 0; peak_idx < it->size(); ++peak_idx)
       {
         double tmp_peak_int((*it)[peak_idx].getIntensity());
@@ -231,330 +341,398 @@ namespace OpenMS
           // --> add this peak as possible chromatographic apex
           if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
           {
-            chrom_apices.insert(std::make_pair(tmp_peak_int, std::make_pair(spectra_count, indices_passing.size())));
+            Apex apex;
+            apex.intensity = (*it)[peak_idx].getIntensity();
+            apex.scan_idx = peaks.rt.size();
+            apex.peak_idx = peaks.mz.size();
+            apices.push_back(apex);
+          }
+          peaks.mz.push_back((*it)[peak_idx].getMZ());
+          peaks.intensity.push_back((*it)[peak_idx].getIntensity());
+          if (has_fwhm)
+          {
+            peaks.fwhm.push_back(it->getFloatDataArrays()[0][peak_idx]);
           }
-          indices_passing.push_back(peak_idx);
-          ++total_peak_count;
         }
       }
-      PeakMap::SpectrumType tmp_spec(*it);
-      tmp_spec.select(indices_passing);
-      work_exp.addSpectrum(tmp_spec);
-      spec_offsets.push_back(spec_offsets.back() + tmp_spec.size());
-      ++spectra_count;
+      peaks.rt.push_back(it->getRT());
+      peaks.full_spec_size.push_back(peaks.mz.size() - peaks.spec_offsets.back());
+      peaks.spec_offsets.push_back(peaks.mz.size());
     }
 
-    if (spectra_count < 3)
+    if (peaks.rt.size() < 3)
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                    "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(spectra_count));
+                                    "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(peaks.rt.size()));
+    }
+    if (fwhm_meta_count > 0 && fwhm_meta_count != peaks.rt.size())
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                    String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + peaks.rt.size() + "].");
     }
 
-    // discard last spectrum's offset
-    spec_offsets.pop_back();
+    std::sort(apices.begin(), apices.end(), ApexGreater());
+  }
 
-    // *********************************************************************
-    // Step 2: start extending mass traces beginning with the apex peak (go
-    // through all peaks in order of decreasing intensity)
-    // *********************************************************************
-    run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces);
+  void MassTraceDetection::runStripes_(const PeakArrays& peaks, const std::vector<Apex>& apices, Size nr_stripes,
+                                       boost::dynamic_bitset<>& peak_visited, std::vector<char>& apex_resolved, TraceBuffer& traces)
+  {
+    if (apices.empty()) return;
 
-    return;
-  } // end of MassTraceDetection::run
+    // stripe borders: quantiles of the apex m/z, i.e. similar work per stripe
+    std::vector<double> apex_mz(apices.size());
+    for (Size i = 0; i < apices.size(); ++i)
+    {
+      apex_mz[i] = peaks.mz[apices[i].peak_idx];
+    }
+    std::sort(apex_mz.begin(), apex_mz.end());
+    std::vector<double> borders(1, -std::numeric_limits<double>::max());
+    for (Size k = 1; k < nr_stripes; ++k)
+    {
+      const double border = apex_mz[apex_mz.size() * k / nr_stripes];
+      if (border > borders.back()) borders.push_back(border);
+    }
+    borders.push_back(std::numeric_limits<double>::max());
+    nr_stripes = borders.size() - 1;
 
-  void MassTraceDetection::run_(const MapIdxSortedByInt& chrom_apices,
-                                const Size total_peak_count, 
-                                const PeakMap& work_exp, 
-                                const std::vector<Size>& spec_offsets,
-                                std::vector<MassTrace>& found_masstraces)
-  {
-    boost::dynamic_bitset<> peak_visited(total_peak_count);
-    Size trace_number(1);
+    std::vector<TraceBuffer> stripe_traces(nr_stripes);
 
-    // check presence of FWHM meta data
-    int fwhm_meta_idx(-1);
-    Size fwhm_meta_count(0);
-    for (Size i = 0; i < work_exp.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize s = 0; s < (SignedSize)nr_stripes; ++s)
     {
-      if (work_exp[i].getFloatDataArrays().size() > 0 && 
-          work_exp[i].getFloatDataArrays()[0].getName() == "FWHM_ppm")
+      // apices are taken from the core of the stripe, peaks also from the overlap with its neighbors
+      const double core_lo(borders[s]), core_hi(borders[s + 1]);
+      const double data_lo = (s == 0) ? core_lo : core_lo * (1.0 - STRIPE_OVERLAP_FACTOR * mass_error_ppm_ * 1e-6);
+      const double data_hi = (s + 1 == (SignedSize)nr_stripes) ? core_hi : core_hi * (1.0 + STRIPE_OVERLAP_FACTOR * mass_error_ppm_ * 1e-6);
+
+      PeakArrays stripe;
+      stripe.rt = peaks.rt;
+      stripe.full_spec_size = peaks.full_spec_size;
+      stripe.spec_offsets.push_back(0);
+      for (Size scan = 0; scan < peaks.rt.size(); ++scan)
       {
-        if (work_exp[i].getFloatDataArrays()[0].size() != work_exp[i].size()) 
-        { // float data should always have the same size as the corresponding array
-          throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, work_exp[i].size());
+        const std::vector<double>::const_iterator scan_begin = peaks.mz.begin() + peaks.spec_offsets[scan];
+        const std::vector<double>::const_iterator scan_end = peaks.mz.begin() + peaks.spec_offsets[scan + 1];
+        const Size first = std::lower_bound(scan_begin, scan_end, data_lo) - peaks.mz.begin();
+        const Size last = std::lower_bound(scan_begin, scan_end, data_hi) - peaks.mz.begin();
+        stripe.mz.insert(stripe.mz.end(), peaks.mz.begin() + first, peaks.mz.begin() + last);
+        stripe.intensity.insert(stripe.intensity.end(), peaks.intensity.begin() + first, peaks.intensity.begin() + last);
+        for (Size i = first; i < last; ++i)
+        {
+          stripe.global_idx.push_back(i);
+        }
+        stripe.spec_offsets.push_back(stripe.mz.size());
+      }
+
+      boost::dynamic_bitset<> stripe_visited(stripe.mz.size());
+      TraceBuffer& result = stripe_traces[s];
+      result.offsets.push_back(0);
+      std::vector<Size> trace;
+      for (Size rank = 0; rank < apices.size(); ++rank)
+      {
+        const double mz = peaks.mz[apices[rank].peak_idx];
+        if (mz < core_lo || mz >= core_hi) continue;
+
+        const Size local_idx = std::lower_bound(stripe.global_idx.begin(), stripe.global_idx.end(), apices[rank].peak_idx) - stripe.global_idx.begin();
+        if (stripe_visited[local_idx]) continue; // decided after merging the stripes
+
+        std::pair<double, double> mz_bounds(std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+        const bool accepted = extendTrace_(stripe, apices[rank].scan_idx, local_idx, stripe_visited, trace, mz_bounds);
+        // the search window left the stripe: leave this apex to the serial pass
+        if (mz_bounds.first < data_lo || mz_bounds.second >= data_hi) continue;
+
+        apex_resolved[rank] = 1; // each apex belongs to exactly one stripe
+        if (accepted)
+        {
+          for (Size i = 0; i < trace.size(); ++i)
+          {
+            stripe_visited[trace[i]] = true;
+            result.peaks.push_back(stripe.global_idx[trace[i]]);
+          }
+          result.apex_rank.push_back(rank);
+          result.offsets.push_back(result.peaks.size());
         }
-        fwhm_meta_idx = 0;
-        ++fwhm_meta_count;
       }
-    }    
-    if (fwhm_meta_count > 0 && fwhm_meta_count != work_exp.size())
-    {
-      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                    String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + work_exp.size() + "].");
     }
-     
 
-    this->startProgress(0, total_peak_count, "mass trace detection");
-    Size peaks_detected(0);
+    // merge the stripes in order of apex intensity: traces which share peaks
+    // with a more intense trace of a neighboring stripe are discarded
+    std::vector<std::pair<Size, std::pair<Size, Size> > > order; // apex rank, (stripe, trace)
+    for (Size s = 0; s < nr_stripes; ++s)
+    {
+      for (Size t = 0; t < stripe_traces[s].apex_rank.size(); ++t)
+      {
+        order.push_back(std::make_pair(stripe_traces[s].apex_rank[t], std::make_pair(s, t)));
+      }
+    }
+    std::sort(order.begin(), order.end());
 
-    for (MapIdxSortedByInt::const_reverse_iterator m_it = chrom_apices.rbegin(); m_it != chrom_apices.rend(); ++m_it)
+    for (Size i = 0; i < order.size(); ++i)
     {
-      Size apex_scan_idx(m_it->second.first);
-      Size apex_peak_idx(m_it->second.second);
+      const TraceBuffer& stripe_result = stripe_traces[order[i].second.first];
+      const Size t = order[i].second.second;
+      const std::vector<Size>::const_iterator trace_begin = stripe_result.peaks.begin() + stripe_result.offsets[t];
+      const std::vector<Size>::const_iterator trace_end = stripe_result.peaks.begin() + stripe_result.offsets[t + 1];
 
-      if (peak_visited[spec_offsets[apex_scan_idx] + apex_peak_idx])
+      bool conflict = false;
+      for (std::vector<Size>::const_iterator it = trace_begin; it != trace_end; ++it)
+      {
+        if (peak_visited[*it])
+        {
+          conflict = true;
+          break;
+        }
+      }
+      if (conflict)
       {
+        apex_resolved[order[i].first] = 0;
         continue;
       }
+      for (std::vector<Size>::const_iterator it = trace_begin; it != trace_end; ++it)
+      {
+        peak_visited[*it] = true;
+      }
+      traces.apex_rank.push_back(order[i].first);
+      traces.peaks.insert(traces.peaks.end(), trace_begin, trace_end);
+      traces.offsets.push_back(traces.peaks.size());
+    }
+  }
 
-      Peak2D apex_peak;
-      apex_peak.setRT(work_exp[apex_scan_idx].getRT());
-      apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
-      apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
-
-      Size trace_up_idx(apex_scan_idx);
-      Size trace_down_idx(apex_scan_idx);
+  bool MassTraceDetection::extendTrace_(const PeakArrays& peaks, Size apex_scan_idx, Size apex_peak_idx,
+                                        const boost::dynamic_bitset<>& peak_visited,
+                                        std::vector<Size>& trace, std::pair<double, double>& mz_bounds)
+  {
+    const Size spectra_count(peaks.rt.size());
+    const double apex_mz(peaks.mz[apex_peak_idx]);
+    const double apex_int(peaks.intensity[apex_peak_idx]);
 
-      std::list<PeakType> current_trace;
-      current_trace.push_back(apex_peak);
-      std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+    Size trace_up_idx(apex_scan_idx);
+    Size trace_down_idx(apex_scan_idx);
+    Size first_scan(apex_scan_idx), last_scan(apex_scan_idx);
 
-      // Initialization for the iterative version of weighted m/z mean calculation
-      double centroid_mz(apex_peak.getMZ());
-      double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
-      double prev_denom(apex_peak.getIntensity());
+    // collected peaks: moving down in reverse RT order, moving up in RT order
+    std::vector<Size> down_peaks;
+    trace.clear();
+    trace.push_back(apex_peak_idx);
 
-      updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
+    // Initialization for the iterative version of weighted m/z mean calculation
+    double centroid_mz(apex_mz);
+    double prev_counter(apex_int * apex_mz);
+    double prev_denom(apex_int);
 
-      std::vector<std::pair<Size, Size> > gathered_idx;
-      gathered_idx.push_back(std::make_pair(apex_scan_idx, apex_peak_idx));
-      if (fwhm_meta_idx != -1)
-      {
-        fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
-      }
+    updateIterativeWeightedMeanMZ(apex_mz, apex_int, centroid_mz, prev_counter, prev_denom);
 
-      Size up_hitting_peak(0), down_hitting_peak(0);
-      Size up_scan_counter(0), down_scan_counter(0);
+    Size up_hitting_peak(0), down_hitting_peak(0);
+    Size up_scan_counter(0), down_scan_counter(0);
 
-      bool toggle_up = true, toggle_down = true;
+    bool toggle_up = true, toggle_down = true;
 
-      Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
-      Size max_consecutive_missing(trace_termination_outliers_);
+    Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
+    Size max_consecutive_missing(trace_termination_outliers_);
 
-      double current_sample_rate(1.0);
-      // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
-      Size min_scans_to_consider(5);
+    double current_sample_rate(1.0);
+    Size min_scans_to_consider(5);
 
-      // double outlier_ratio(0.3);
+    double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
+    double intensity_so_far(apex_int);
 
-      // double ftl_mean(centroid_mz);
-      double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
-      double intensity_so_far(apex_peak.getIntensity());
+    const bool outlier_criterion = (trace_termination_criterion_ == "outlier");
+    const bool sample_rate_criterion = (trace_termination_criterion_ == "sample_rate");
 
-      while (((trace_down_idx > 0) && toggle_down) ||
-             ((trace_up_idx < work_exp.size() - 1) && toggle_up)
-             )
+    while (((trace_down_idx > 0) && toggle_down) ||
+           ((trace_up_idx < spectra_count - 1) && toggle_up)
+           )
+    {
+      // *********************************************************** //
+      // Step 2.1 MOVE DOWN in RT dim
+      // *********************************************************** //
+      if ((trace_down_idx > 0) && toggle_down)
       {
-        // *********************************************************** //
-        // Step 2.1 MOVE DOWN in RT dim
-        // *********************************************************** //
-        if ((trace_down_idx > 0) && toggle_down)
+        const Size scan = trace_down_idx - 1;
+        if (peaks.full_spec_size[scan] > 0)
         {
-          const MSSpectrum<>& spec_trace_down = work_exp[trace_down_idx - 1];
-          if (!spec_trace_down.empty())
-          {
-            Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
-            double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
-            double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
+          double right_bound = centroid_mz + 3 * ftl_sd;
+          double left_bound = centroid_mz - 3 * ftl_sd;
+          mz_bounds.first = std::min(mz_bounds.first, left_bound);
+          mz_bounds.second = std::max(mz_bounds.second, right_bound);
 
-            double right_bound = centroid_mz + 3 * ftl_sd;
-            double left_bound = centroid_mz - 3 * ftl_sd;
+          bool found = false;
+          if (peaks.spec_offsets[scan] < peaks.spec_offsets[scan + 1])
+          {
+            Size next_down_peak_idx = findNearestPeak_(peaks.mz, peaks.spec_offsets[scan], peaks.spec_offsets[scan + 1], centroid_mz);
+            double next_down_peak_mz = peaks.mz[next_down_peak_idx];
+            double next_down_peak_int = peaks.intensity[next_down_peak_idx];
 
             if ((next_down_peak_mz <= right_bound) &&
                 (next_down_peak_mz >= left_bound) &&
-                !peak_visited[spec_offsets[trace_down_idx - 1] + next_down_peak_idx]
+                !peak_visited[next_down_peak_idx]
                 )
             {
               Peak2D next_peak;
-              next_peak.setRT(spec_trace_down.getRT());
+              next_peak.setRT(peaks.rt[scan]);
               next_peak.setMZ(next_down_peak_mz);
               next_peak.setIntensity(next_down_peak_int);
 
-              current_trace.push_front(next_peak);
-              // FWHM average
-              if (fwhm_meta_idx != -1)
-              {
-                fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
-              }
+              down_peaks.push_back(next_down_peak_idx);
+              first_scan = scan;
               // Update the m/z mean of the current trace as we added a new peak
               updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
-              gathered_idx.push_back(std::make_pair(trace_down_idx - 1, next_down_peak_idx));
 
               // Update the m/z variance dynamically
-              if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
+              if (reestimate_mt_sd_)
               {
-                // if (ftl_t > min_fwhm_scans)
-                {
-                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                }
+                updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
               }
 
               ++down_hitting_peak;
               conseq_missed_peak_down = 0;
+              found = true;
             }
-            else
-            {
-              ++conseq_missed_peak_down;
-            }
-
           }
-          --trace_down_idx;
-          ++down_scan_counter;
+          if (!found)
+          {
+            ++conseq_missed_peak_down;
+          }
+        }
+        --trace_down_idx;
+        ++down_scan_counter;
 
-          // trace termination criterion: max allowed number of
-          // consecutive outliers reached OR cancel extension if
-          // sampling_rate falls below min_sample_rate_
-          if (trace_termination_criterion_ == "outlier")
+        // trace termination criterion: max allowed number of
+        // consecutive outliers reached OR cancel extension if
+        // sampling_rate falls below min_sample_rate_
+        if (outlier_criterion)
+        {
+          if (conseq_missed_peak_down > max_consecutive_missing)
           {
-            if (conseq_missed_peak_down > max_consecutive_missing)
-            {
-              toggle_down = false;
-            }
+            toggle_down = false;
           }
-          else if (trace_termination_criterion_ == "sample_rate")
+        }
+        else if (sample_rate_criterion)
+        {
+          current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
+                                (double)(down_scan_counter + up_scan_counter + 1);
+          if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
           {
-            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
-                                  (double)(down_scan_counter + up_scan_counter + 1);
-            if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-            {
-              // std::cout << "stopping down..." << std::endl;
-              toggle_down = false;
-            }
+            toggle_down = false;
           }
         }
+      }
 
-        // *********************************************************** //
-        // Step 2.2 MOVE UP in RT dim
-        // *********************************************************** //
-        if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+      // *********************************************************** //
+      // Step 2.2 MOVE UP in RT dim
+      // *********************************************************** //
+      if ((trace_up_idx < spectra_count - 1) && toggle_up)
+      {
+        const Size scan = trace_up_idx + 1;
+        if (peaks.full_spec_size[scan] > 0)
         {
-          const MSSpectrum<>& spec_trace_up = work_exp[trace_up_idx + 1];
-          if (!spec_trace_up.empty())
-          {
-            Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
-            double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
-            double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
+          double right_bound = centroid_mz + 3 * ftl_sd;
+          double left_bound = centroid_mz - 3 * ftl_sd;
+          mz_bounds.first = std::min(mz_bounds.first, left_bound);
+          mz_bounds.second = std::max(mz_bounds.second, right_bound);
 
-            double right_bound = centroid_mz + 3 * ftl_sd;
-            double left_bound = centroid_mz - 3 * ftl_sd;
+          bool found = false;
+          if (peaks.spec_offsets[scan] < peaks.spec_offsets[scan + 1])
+          {
+            Size next_up_peak_idx = findNearestPeak_(peaks.mz, peaks.spec_offsets[scan], peaks.spec_offsets[scan + 1], centroid_mz);
+            double next_up_peak_mz = peaks.mz[next_up_peak_idx];
+            double next_up_peak_int = peaks.intensity[next_up_peak_idx];
 
             if ((next_up_peak_mz <= right_bound) &&
                 (next_up_peak_mz >= left_bound) &&
-                !peak_visited[spec_offsets[trace_up_idx + 1] + next_up_peak_idx])
+                !peak_visited[next_up_peak_idx])
             {
               Peak2D next_peak;
-              next_peak.setRT(spec_trace_up.getRT());
+              next_peak.setRT(peaks.rt[scan]);
               next_peak.setMZ(next_up_peak_mz);
               next_peak.setIntensity(next_up_peak_int);
 
-              current_trace.push_back(next_peak);
-              if (fwhm_meta_idx != -1)
-              {
-                fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
-              }
+              trace.push_back(next_up_peak_idx);
+              last_scan = scan;
               // Update the m/z mean of the current trace as we added a new peak
               updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
-              gathered_idx.push_back(std::make_pair(trace_up_idx + 1, next_up_peak_idx));
 
               // Update the m/z variance dynamically
-              if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
+              if (reestimate_mt_sd_)
               {
-                // if (ftl_t > min_fwhm_scans)
-                {
-                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                }
+                updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
               }
 
               ++up_hitting_peak;
               conseq_missed_peak_up = 0;
-
-            }
-            else
-            {
-              ++conseq_missed_peak_up;
+              found = true;
             }
-
           }
+          if (!found)
+          {
+            ++conseq_missed_peak_up;
+          }
+        }
 
-          ++trace_up_idx;
-          ++up_scan_counter;
+        ++trace_up_idx;
+        ++up_scan_counter;
 
-          if (trace_termination_criterion_ == "outlier")
+        if (outlier_criterion)
+        {
+          if (conseq_missed_peak_up > max_consecutive_missing)
           {
-            if (conseq_missed_peak_up > max_consecutive_missing)
-            {
-              toggle_up = false;
-            }
+            toggle_up = false;
           }
-          else if (trace_termination_criterion_ == "sample_rate")
-          {
-            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
+        }
+        else if (sample_rate_criterion)
+        {
+          current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
 
-            if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-            {
-              // std::cout << "stopping up" << std::endl;
-              toggle_up = false;
-            }
+          if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
+          {
+            toggle_up = false;
           }
-
-
         }
-
       }
+    }
 
-      // std::cout << "current sr: " << current_sample_rate << std::endl;
-      double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
-
-      double mt_quality((double)current_trace.size() / (double)num_scans);
-      // std::cout << "mt quality: " << mt_quality << std::endl;
-      double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
+    // contiguous trace in RT order: peaks found moving down (reversed), apex, peaks found moving up
+    trace.insert(trace.begin(), down_peaks.rbegin(), down_peaks.rend());
 
-      // *********************************************************** //
-      // Step 2.3 check if minimum length and quality of mass trace criteria are met
-      // *********************************************************** //
-      bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
-      if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
-      {
-        // std::cout << "T" << trace_number << "\t" << mt_quality << std::endl;
-
-        // mark all peaks as visited
-        for (Size i = 0; i < gathered_idx.size(); ++i)
-        {
-          peak_visited[spec_offsets[gathered_idx[i].first] +  gathered_idx[i].second] = true;
-        }
+    double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
 
-        // create new MassTrace object and store collected peaks from list current_trace
-        MassTrace new_trace(current_trace);
-        new_trace.updateWeightedMeanRT();
-        new_trace.updateWeightedMeanMZ();
-        if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
-        new_trace.setQuantMethod(quant_method_);
-        //new_trace.setCentroidSD(ftl_sd);
-        new_trace.updateWeightedMZsd();
-        new_trace.setLabel("T" + String(trace_number));
-        ++trace_number;
+    double mt_quality((double)trace.size() / (double)num_scans);
+    double rt_range(std::fabs(peaks.rt[last_scan] - peaks.rt[first_scan]));
 
-        found_masstraces.push_back(new_trace);
+    // *********************************************************** //
+    // Step 2.3 check if minimum length and quality of mass trace criteria are met
+    // *********************************************************** //
+    bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
+    return rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_;
+  }
 
-        peaks_detected += new_trace.getSize();
-        this->setProgress(peaks_detected);
-      }
+  MassTrace MassTraceDetection::createMassTrace_(const PeakArrays& peaks, std::vector<Size>::const_iterator begin, std::vector<Size>::const_iterator end) const
+  {
+    std::vector<PeakType> trace_peaks;
+    trace_peaks.reserve(end - begin);
+    std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+    for (std::vector<Size>::const_iterator it = begin; it != end; ++it)
+    {
+      const Size scan = std::upper_bound(peaks.spec_offsets.begin(), peaks.spec_offsets.end(), *it) - peaks.spec_offsets.begin() - 1;
+      PeakType p;
+      p.setRT(peaks.rt[scan]);
+      p.setMZ(peaks.mz[*it]);
+      p.setIntensity(peaks.intensity[*it]);
+      trace_peaks.push_back(p);
+      if (!peaks.fwhm.empty()) fwhms_mz.push_back(peaks.fwhm[*it]);
     }
 
-    this->endProgress();
-
+    MassTrace new_trace(trace_peaks);
+    new_trace.updateWeightedMeanRT();
+    new_trace.updateWeightedMeanMZ();
+    if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
+    new_trace.setQuantMethod(quant_method_);
+    new_trace.updateWeightedMZsd();
+    return new_trace;
   }
-  
+
   void MassTraceDetection::updateMembers_()
   {
     mass_error_ppm_ = (double)param_.getValue("mass_error_ppm");
@@ -568,6 +746,7 @@ namespace OpenMS
     min_trace_length_ = (double)param_.getValue("min_trace_length");
     max_trace_length_ = (double)param_.getValue("max_trace_length");
     reestimate_mt_sd_ = param_.getValue("reestimate_mt_sd").toBool();
+    mz_stripes_ = (Size)(int)param_.getValue("mz_stripes");
   }
 
 }
@@ -0,0 +1,292 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetectionConsumer.h>
+
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace OpenMS
+{
+  struct MassTraceDetectionConsumer::ApexOrder
+  {
+    explicit ApexOrder(const std::vector<MassTraceDetection::Apex>& apices) :
+      apices_(apices)
+    {
+    }
+
+    bool operator()(Size a, Size b) const
+    {
+      return apices_[a].intensity > apices_[b].intensity ||
+             (apices_[a].intensity == apices_[b].intensity && apices_[a].peak_idx > apices_[b].peak_idx);
+    }
+
+    const std::vector<MassTraceDetection::Apex>& apices_;
+  };
+
+  MassTraceDetectionConsumer::MassTraceDetectionConsumer(std::vector<MassTrace>& found_masstraces) :
+    DefaultParamHandler("MassTraceDetectionConsumer"),
+    found_masstraces_(found_masstraces),
+    dropped_peaks_(0),
+    first_trace_(found_masstraces.size()),
+    scan_count_(0),
+    fwhm_count_(0),
+    allow_profile_data_(false)
+  {
+    defaults_ = mass_trace_detection_.getDefaults();
+    defaults_.remove("mz_stripes");
+    defaults_.setValue("window_length", 120.0, "Length of the retention time window (in seconds). Traces which end this long before the most recent spectrum are final, and about three times this length of spectra is kept in memory. Should be well above the width of a chromatographic peak; longer traces may be split.", ListUtils::create<String>("advanced"));
+    defaults_.setMinFloat("window_length", 1.0);
+
+    defaultsToParam_();
+
+    peaks_.spec_offsets.push_back(0);
+  }
+
+  MassTraceDetectionConsumer::~MassTraceDetectionConsumer()
+  {
+  }
+
+  void MassTraceDetectionConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    if (s.getMSLevel() != 1) return;
+
+    if (!peaks_.rt.empty() && s.getRT() < peaks_.rt.back())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       String("Spectra need to be consumed in order of increasing retention time (") + s.getRT() + " after " + peaks_.rt.back() + ").");
+    }
+    // check the type of data up front instead of after the whole run was processed
+    if (scan_count_ == 0 && !allow_profile_data_ && s.getType() == SpectrumSettings::RAWDATA)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "Profile data provided but centroided spectra expected. Aborting!");
+    }
+    if (!s.isSorted()) s.sortByPosition();
+
+    // check presence of FWHM meta data
+    const bool has_fwhm = !s.getFloatDataArrays().empty() && s.getFloatDataArrays()[0].getName() == "FWHM_ppm";
+    if (has_fwhm && s.getFloatDataArrays()[0].size() != s.size())
+    { // float data should always have the same size as the corresponding array
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, s.size());
+    }
+    if (scan_count_ > 0 && has_fwhm != (fwhm_count_ > 0))
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                    String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + (fwhm_count_ + has_fwhm) + "/" + (scan_count_ + 1) + "].");
+    }
+    ++scan_count_;
+    if (has_fwhm) ++fwhm_count_;
+
+    // only keep peaks above the noise threshold
+    for (Size i = 0; i < s.size(); ++i)
+    {
+      if (s[i].getIntensity() > noise_threshold_int_)
+      {
+        peaks_.mz.push_back(s[i].getMZ());
+        peaks_.intensity.push_back(s[i].getIntensity());
+        if (has_fwhm)
+        {
+          peaks_.fwhm.push_back(s.getFloatDataArrays()[0][i]);
+        }
+      }
+    }
+    peaks_.rt.push_back(s.getRT());
+    peaks_.full_spec_size.push_back(peaks_.mz.size() - peaks_.spec_offsets.back());
+    peaks_.spec_offsets.push_back(peaks_.mz.size());
+    peak_assigned_.resize(peaks_.mz.size());
+
+    if (peaks_.rt.back() - peaks_.rt.front() >= 3 * window_length_)
+    {
+      const double keep_rt(peaks_.rt.back() - 2 * window_length_);
+      detectTraces_(keep_rt);
+      dropSpectra_(keep_rt);
+    }
+  }
+
+  void MassTraceDetectionConsumer::flush()
+  {
+    if (scan_count_ < 3)
+    {
+      const Size scan_count(scan_count_);
+      reset_();
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                    "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(scan_count));
+    }
+    detectTraces_(std::numeric_limits<double>::max());
+
+    // order the traces by decreasing apex intensity (as MassTraceDetection does)
+    std::vector<Size> order(trace_apices_.size());
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), ApexOrder(trace_apices_));
+
+    std::vector<MassTrace> sorted;
+    sorted.reserve(order.size());
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      sorted.push_back(found_masstraces_[first_trace_ + order[i]]);
+      sorted.back().setLabel("T" + String(i + 1));
+    }
+    std::swap_ranges(sorted.begin(), sorted.end(), found_masstraces_.begin() + first_trace_);
+
+    reset_();
+  }
+
+  void MassTraceDetectionConsumer::setAllowProfileData(bool allow)
+  {
+    allow_profile_data_ = allow;
+  }
+
+  Size MassTraceDetectionConsumer::getNrBufferedSpectra() const
+  {
+    return peaks_.rt.size();
+  }
+
+  void MassTraceDetectionConsumer::detectTraces_(double keep_rt)
+  {
+    if (peaks_.rt.empty()) return;
+
+    // traces ending before this retention time (and scan) cannot be changed by the following spectra
+    const double final_rt(peaks_.rt.back() - window_length_);
+    const Size last_scan(peaks_.rt.size() - 1);
+
+    // apex candidates which do not belong to a final trace yet
+    std::vector<MassTraceDetection::Apex> apices;
+    std::vector<Size> apex_order;
+    for (Size scan = 0; scan < peaks_.rt.size(); ++scan)
+    {
+      for (Size i = peaks_.spec_offsets[scan]; i < peaks_.spec_offsets[scan + 1]; ++i)
+      {
+        if (!peak_assigned_[i] && peaks_.intensity[i] > chrom_peak_snr_ * noise_threshold_int_)
+        {
+          MassTraceDetection::Apex apex;
+          apex.intensity = peaks_.intensity[i];
+          apex.scan_idx = scan;
+          apex.peak_idx = i;
+          apex_order.push_back(apices.size());
+          apices.push_back(apex);
+        }
+      }
+    }
+    std::sort(apex_order.begin(), apex_order.end(), ApexOrder(apices));
+
+    // extend all apices (as MassTraceDetection::run), but keep only the final traces
+    boost::dynamic_bitset<> peak_visited(peak_assigned_);
+    std::vector<Size> trace;
+    for (Size rank = 0; rank < apex_order.size(); ++rank)
+    {
+      const MassTraceDetection::Apex& apex = apices[apex_order[rank]];
+      if (peak_visited[apex.peak_idx])
+      {
+        continue;
+      }
+      std::pair<double, double> mz_bounds(std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+      if (!mass_trace_detection_.extendTrace_(peaks_, apex.scan_idx, apex.peak_idx, peak_visited, trace, mz_bounds))
+      {
+        continue;
+      }
+      for (Size i = 0; i < trace.size(); ++i)
+      {
+        peak_visited[trace[i]] = true;
+      }
+
+      // traces whose apex is dropped from the buffer are kept as they are (i.e. split if they continue)
+      const Size end_scan = std::upper_bound(peaks_.spec_offsets.begin(), peaks_.spec_offsets.end(), trace.back()) - peaks_.spec_offsets.begin() - 1;
+      if ((peaks_.rt[end_scan] < final_rt && end_scan + trace_termination_outliers_ < last_scan) || peaks_.rt[apex.scan_idx] < keep_rt)
+      {
+        for (Size i = 0; i < trace.size(); ++i)
+        {
+          peak_assigned_[trace[i]] = true;
+        }
+        found_masstraces_.push_back(mass_trace_detection_.createMassTrace_(peaks_, trace.begin(), trace.end()));
+        trace_apices_.push_back(apex);
+        trace_apices_.back().peak_idx += dropped_peaks_;
+      }
+    }
+  }
+
+  void MassTraceDetectionConsumer::dropSpectra_(double rt)
+  {
+    const Size nr_scans = std::lower_bound(peaks_.rt.begin(), peaks_.rt.end(), rt) - peaks_.rt.begin();
+    if (nr_scans == 0) return;
+    const Size nr_peaks = peaks_.spec_offsets[nr_scans];
+
+    peaks_.rt.erase(peaks_.rt.begin(), peaks_.rt.begin() + nr_scans);
+    peaks_.full_spec_size.erase(peaks_.full_spec_size.begin(), peaks_.full_spec_size.begin() + nr_scans);
+    peaks_.spec_offsets.erase(peaks_.spec_offsets.begin(), peaks_.spec_offsets.begin() + nr_scans);
+    for (Size i = 0; i < peaks_.spec_offsets.size(); ++i)
+    {
+      peaks_.spec_offsets[i] -= nr_peaks;
+    }
+    peaks_.mz.erase(peaks_.mz.begin(), peaks_.mz.begin() + nr_peaks);
+    peaks_.intensity.erase(peaks_.intensity.begin(), peaks_.intensity.begin() + nr_peaks);
+    if (!peaks_.fwhm.empty())
+    {
+      peaks_.fwhm.erase(peaks_.fwhm.begin(), peaks_.fwhm.begin() + nr_peaks);
+    }
+    peak_assigned_ >>= nr_peaks;
+    peak_assigned_.resize(peaks_.mz.size());
+    dropped_peaks_ += nr_peaks;
+  }
+
+  void MassTraceDetectionConsumer::reset_()
+  {
+    peaks_ = MassTraceDetection::PeakArrays();
+    peaks_.spec_offsets.push_back(0);
+    peak_assigned_.clear();
+    dropped_peaks_ = 0;
+    trace_apices_.clear();
+    first_trace_ = found_masstraces_.size();
+    scan_count_ = 0;
+    fwhm_count_ = 0;
+  }
+
+  void MassTraceDetectionConsumer::updateMembers_()
+  {
+    noise_threshold_int_ = (double)param_.getValue("noise_threshold_int");
+    chrom_peak_snr_ = (double)param_.getValue("chrom_peak_snr");
+    trace_termination_outliers_ = (Size)param_.getValue("trace_termination_outliers");
+    window_length_ = (double)param_.getValue("window_length");
+
+    Param mtd_param(param_);
+    mtd_param.remove("window_length");
+    mass_trace_detection_.setParameters(mtd_param);
+  }
+
+}
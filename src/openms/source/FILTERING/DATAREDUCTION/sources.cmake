@@ -8,6 +8,7 @@ ElutionPeakDetection.cpp
 FeatureFindingMetabo.cpp
 IsotopeDistributionCache.cpp
 MassTraceDetection.cpp
+MassTraceDetectionConsumer.cpp
 SplinePackage.cpp
 SplineSpectrum.cpp
 )
@@ -38,6 +38,21 @@
 #include <QtCore/QList>
 #include <QtCore/QString>
 
+// The vectorized Base64 decoders are compiled for SSE4.1 and AVX2 regardless
+// of the compiler flags and selected at runtime depending on the CPU.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define OPENMS_BASE64_SIMD
+#define OPENMS_BASE64_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define OPENMS_BASE64_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define OPENMS_BASE64_SIMD
+#define OPENMS_BASE64_TARGET_SSE41
+#define OPENMS_BASE64_TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -281,4 +296,233 @@ print s
     }
   }
 
+  namespace
+  {
+    /// Maps a Base64 character to its 6 bit value (-1 for invalid characters, including '=')
+    struct Base64DecodeTable_
+    {
+      signed char table[256];
+
+      Base64DecodeTable_()
+      {
+        std::fill(table, table + 256, -1);
+        const char* encoder = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i)
+        {
+          table[(unsigned char) encoder[i]] = (signed char) i;
+        }
+      }
+    };
+
+    const Base64DecodeTable_ decode_table_;
+
+    /// Decodes a single block of four Base64 characters (without padding) into three bytes
+    inline bool decodeBlock_(const char* in, unsigned char* out)
+    {
+      const signed char a = decode_table_.table[(unsigned char) in[0]];
+      const signed char b = decode_table_.table[(unsigned char) in[1]];
+      const signed char c = decode_table_.table[(unsigned char) in[2]];
+      const signed char d = decode_table_.table[(unsigned char) in[3]];
+      if ((a | b | c | d) < 0) return false;
+
+      const UInt32 v = (UInt32(a) << 18) | (UInt32(b) << 12) | (UInt32(c) << 6) | UInt32(d);
+      out[0] = (unsigned char) (v >> 16);
+      out[1] = (unsigned char) (v >> 8);
+      out[2] = (unsigned char) v;
+      return true;
+    }
+
+#ifdef OPENMS_BASE64_SIMD
+    /// Instruction set extensions usable for decoding
+    enum SimdLevel_ {SIMD_NONE, SIMD_SSE41, SIMD_AVX2};
+
+    /// Determines the best instruction set supported by the CPU (and the operating system)
+    SimdLevel_ detectSimdLevel_()
+    {
+#ifdef _MSC_VER
+      int info[4];
+      __cpuid(info, 0);
+      const int max_leaf = info[0];
+      __cpuid(info, 1);
+      const bool sse41 = (info[2] & (1 << 19)) != 0;
+      const bool osxsave = (info[2] & (1 << 27)) != 0;
+      const bool avx = (info[2] & (1 << 28)) != 0;
+      bool avx2 = false;
+      if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+      {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+      }
+#else
+      // needed since this runs during static initialization
+      __builtin_cpu_init();
+      const bool sse41 = __builtin_cpu_supports("sse4.1");
+      const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+      if (avx2) return SIMD_AVX2;
+      if (sse41) return SIMD_SSE41;
+      return SIMD_NONE;
+    }
+
+    const SimdLevel_ simd_level_ = detectSimdLevel_();
+
+    /*
+      Vectorized decoding of 16 Base64 characters into 12 bytes, see
+      W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+      Instructions", ACM Transactions on the Web 12(3), 2018.
+
+      The high and low nibbles of each character are used to look up a bit
+      mask in two tables: their intersection is non-zero for characters
+      outside of the Base64 alphabet. A third table gives the offset that
+      maps each valid character to its 6 bit value. Finally, the four 6 bit
+      values of each 32 bit lane are merged into three bytes and the bytes
+      of all lanes are compacted. 16 bytes are stored, of which the last 4
+      are garbage.
+    */
+    OPENMS_BASE64_TARGET_SSE41 inline bool decodeSSE_(const char* in, unsigned char* out)
+    {
+      const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+      const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+      const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+      const __m128i mask_2F = _mm_set1_epi8(0x2F);
+
+      __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+      const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2F);
+      const __m128i lo_nibbles = _mm_and_si128(str, mask_2F);
+      const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+      const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+      if (!_mm_testz_si128(lo, hi)) return false;
+
+      const __m128i eq_2F = _mm_cmpeq_epi8(str, mask_2F);
+      const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2F, hi_nibbles));
+      str = _mm_add_epi8(str, roll);
+
+      const __m128i merge_ab_and_bc = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+      __m128i merged = _mm_madd_epi16(merge_ab_and_bc, _mm_set1_epi32(0x00011000));
+      merged = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), merged);
+      return true;
+    }
+
+    /**
+      Decodes blocks of 16 characters with decodeSSE_ while at least 32
+      characters follow (the surplus bytes stored are overwritten later on).
+      Stops at the first invalid block and returns the number of characters decoded.
+    */
+    OPENMS_BASE64_TARGET_SSE41 Size decodeBlocksSSE_(const char* in, Size in_length, unsigned char* out)
+    {
+      Size i = 0;
+      for (; i + 32 <= in_length; i += 16, out += 12)
+      {
+        if (!decodeSSE_(in + i, out)) break;
+      }
+      return i;
+    }
+
+    /// Same as decodeSSE_ for 32 Base64 characters (24 bytes decoded, 32 bytes stored)
+    OPENMS_BASE64_TARGET_AVX2 inline bool decodeAVX2_(const char* in, unsigned char* out)
+    {
+      const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                              0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+      const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                              0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+      const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+      const __m256i mask_2F = _mm256_set1_epi8(0x2F);
+
+      __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+      const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2F);
+      const __m256i lo_nibbles = _mm256_and_si256(str, mask_2F);
+      const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+      const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+      if (!_mm256_testz_si256(lo, hi)) return false;
+
+      const __m256i eq_2F = _mm256_cmpeq_epi8(str, mask_2F);
+      const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2F, hi_nibbles));
+      str = _mm256_add_epi8(str, roll);
+
+      const __m256i merge_ab_and_bc = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+      __m256i merged = _mm256_madd_epi16(merge_ab_and_bc, _mm256_set1_epi32(0x00011000));
+      merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+      // move the 12 valid bytes of the upper lane next to the ones of the lower lane
+      merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), merged);
+      return true;
+    }
+
+    /// Same as decodeBlocksSSE_ for blocks of 32 characters (while at least 64 characters follow)
+    OPENMS_BASE64_TARGET_AVX2 Size decodeBlocksAVX2_(const char* in, Size in_length, unsigned char* out)
+    {
+      Size i = 0;
+      for (; i + 64 <= in_length; i += 32, out += 24)
+      {
+        if (!decodeAVX2_(in + i, out)) break;
+      }
+      return i;
+    }
+#endif
+
+    void throwInvalidCharacter_(const char* file, int line, const char* function)
+    {
+      throw Exception::ConversionError(file, line, function, "Malformed base64 input, invalid character found.");
+    }
+  }
+
+  Size Base64::decodedSize(const char* in, Size in_length)
+  {
+    // too short to contain any data (same behavior as decode())
+    if (in_length < 4) return 0;
+    if (in_length % 4 != 0)
+    {
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Malformed base64 input, length is not a multiple of 4.");
+    }
+    Size padding = 0;
+    if (in[in_length - 1] == '=') padding++;
+    if (in[in_length - 2] == '=') padding++;
+    return in_length / 4 * 3 - padding;
+  }
+
+  Size Base64::decodeRaw(const char* in, Size in_length, unsigned char* out)
+  {
+    const Size byte_count = decodedSize(in, in_length);
+    if (byte_count == 0) return 0;
+
+    // the last block may contain padding and is handled separately
+    const Size full_length = in_length - 4;
+    Size i = 0;
+    unsigned char* to = out;
+
+    // vectorized decoding of the bulk of the data (if supported by the CPU);
+    // at an invalid character the scalar decoder takes over and reports the error
+#ifdef OPENMS_BASE64_SIMD
+    if (simd_level_ == SIMD_AVX2)
+    {
+      i = decodeBlocksAVX2_(in, in_length, to);
+      to += i / 4 * 3;
+    }
+    if (simd_level_ >= SIMD_SSE41)
+    {
+      const Size decoded = decodeBlocksSSE_(in + i, in_length - i, to);
+      i += decoded;
+      to += decoded / 4 * 3;
+    }
+#endif
+    for (; i < full_length; i += 4, to += 3)
+    {
+      if (!decodeBlock_(in + i, to)) throwInvalidCharacter_(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
+
+    // last block (with up to two padding characters)
+    char last[4] = {in[i], in[i + 1], in[i + 2], in[i + 3]};
+    const Size remaining = byte_count - (to - out);
+    if (last[3] == '=') last[3] = 'A';
+    if (last[2] == '=') last[2] = 'A';
+    unsigned char tmp[3];
+    if (!decodeBlock_(last, tmp)) throwInvalidCharacter_(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    std::copy(tmp, tmp + remaining, to);
+
+    return byte_count;
+  }
+
 } //end OpenMS
@@ -0,0 +1,1298 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/ColumnarFeatureFile.h>
+
+#include <OpenMS/CHEMISTRY/EnzymesDB.h>
+#include <OpenMS/DATASTRUCTURES/DateTime.h>
+#include <OpenMS/FORMAT/HANDLERS/MappedFileHelper.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/METADATA/DataProcessing.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <fstream>
+#include <cstring>
+
+namespace OpenMS
+{
+  const UInt64 ColumnarFeatureFile::FILE_IDENTIFIER = 0x4C4F43544146534FULL; // "OSFATCOL"
+  const UInt32 ColumnarFeatureFile::FILE_VERSION = 1;
+  const Size ColumnarFeatureFile::HEADER_SIZE = Internal::MappedFileHelper::HEADER_SIZE;
+  const Size ColumnarFeatureFile::DATA_ALIGNMENT = Internal::MappedFileHelper::DATA_ALIGNMENT;
+
+  namespace
+  {
+    /// Header stored at the beginning of the file
+    struct Header
+    {
+      UInt64 file_identifier;
+      UInt32 file_version;
+      UInt32 map_kind;
+    };
+
+    /// Trailer stored at the end of the file (in front of the file identifier)
+    struct Trailer
+    {
+      UInt64 directory_offset;
+      UInt64 nr_blocks;
+      UInt64 nr_features;
+    };
+
+    /// Appends binary values to a record
+    class RecordWriter
+    {
+public:
+      explicit RecordWriter(std::vector<char>& buffer) :
+        buffer_(buffer)
+      {
+      }
+
+      template <typename T>
+      void write(const T& value)
+      {
+        const char* p = reinterpret_cast<const char*>(&value);
+        buffer_.insert(buffer_.end(), p, p + sizeof(T));
+      }
+
+      void writeString(const String& s)
+      {
+        write<UInt64>(s.size());
+        buffer_.insert(buffer_.end(), s.begin(), s.end());
+      }
+
+      void writeStringList(const std::vector<String>& list)
+      {
+        write<UInt64>(list.size());
+        for (Size i = 0; i < list.size(); ++i)
+        {
+          writeString(list[i]);
+        }
+      }
+
+      void writeDateTime(const DateTime& date)
+      {
+        writeString(date.isValid() ? date.get() : String());
+      }
+
+      void writeDataValue(const DataValue& value)
+      {
+        write<unsigned char>(value.valueType());
+        switch (value.valueType())
+        {
+        case DataValue::STRING_VALUE:
+          writeString(value.toString());
+          break;
+
+        case DataValue::INT_VALUE:
+          write<Int64>((SignedSize)value);
+          break;
+
+        case DataValue::DOUBLE_VALUE:
+          write<double>((double)value);
+          break;
+
+        case DataValue::STRING_LIST:
+          writeStringList(value.toStringList());
+          break;
+
+        case DataValue::INT_LIST:
+        {
+          IntList list = value.toIntList();
+          write<UInt64>(list.size());
+          for (Size i = 0; i < list.size(); ++i)
+          {
+            write<Int64>(list[i]);
+          }
+        }
+        break;
+
+        case DataValue::DOUBLE_LIST:
+        {
+          DoubleList list = value.toDoubleList();
+          write<UInt64>(list.size());
+          for (Size i = 0; i < list.size(); ++i)
+          {
+            write<double>(list[i]);
+          }
+        }
+        break;
+
+        default:
+          break;
+        }
+        writeString(value.getUnit());
+      }
+
+      void writeMetaInfo(const MetaInfoInterface& meta)
+      {
+        std::vector<String> keys;
+        meta.getKeys(keys);
+        write<UInt64>(keys.size());
+        for (Size i = 0; i < keys.size(); ++i)
+        {
+          writeString(keys[i]);
+          writeDataValue(meta.getMetaValue(keys[i]));
+        }
+      }
+
+      void writeConvexHulls(const std::vector<ConvexHull2D>& hulls)
+      {
+        write<UInt64>(hulls.size());
+        for (Size i = 0; i < hulls.size(); ++i)
+        {
+          const ConvexHull2D::PointArrayType& points = hulls[i].getHullPoints();
+          write<UInt64>(points.size());
+          for (Size j = 0; j < points.size(); ++j)
+          {
+            write<double>(points[j][0]);
+            write<double>(points[j][1]);
+          }
+        }
+      }
+
+      void writePeptideIdentifications(const std::vector<PeptideIdentification>& peptides)
+      {
+        write<UInt64>(peptides.size());
+        for (Size i = 0; i < peptides.size(); ++i)
+        {
+          const PeptideIdentification& id = peptides[i];
+          writeString(id.getIdentifier());
+          writeString(id.getScoreType());
+          write<unsigned char>(id.isHigherScoreBetter());
+          write<double>(id.getSignificanceThreshold());
+          write<double>(id.getRT());
+          write<double>(id.getMZ());
+          writeString(id.getBaseName());
+          writeMetaInfo(id);
+
+          const std::vector<PeptideHit>& hits = id.getHits();
+          write<UInt64>(hits.size());
+          for (Size j = 0; j < hits.size(); ++j)
+          {
+            const PeptideHit& hit = hits[j];
+            write<double>(hit.getScore());
+            write<UInt32>(hit.getRank());
+            write<Int32>(hit.getCharge());
+            writeString(hit.getSequence().toString());
+            const std::vector<PeptideEvidence>& evidences = hit.getPeptideEvidences();
+            write<UInt64>(evidences.size());
+            for (Size k = 0; k < evidences.size(); ++k)
+            {
+              writeString(evidences[k].getProteinAccession());
+              write<Int32>(evidences[k].getStart());
+              write<Int32>(evidences[k].getEnd());
+              write<char>(evidences[k].getAABefore());
+              write<char>(evidences[k].getAAAfter());
+            }
+            writeMetaInfo(hit);
+          }
+        }
+      }
+
+      void writeProteinGroups(const std::vector<ProteinIdentification::ProteinGroup>& groups)
+      {
+        write<UInt64>(groups.size());
+        for (Size i = 0; i < groups.size(); ++i)
+        {
+          write<double>(groups[i].probability);
+          writeStringList(groups[i].accessions);
+        }
+      }
+
+      void writeProteinIdentifications(const std::vector<ProteinIdentification>& proteins)
+      {
+        write<UInt64>(proteins.size());
+        for (Size i = 0; i < proteins.size(); ++i)
+        {
+          const ProteinIdentification& id = proteins[i];
+          writeString(id.getIdentifier());
+          writeString(id.getSearchEngine());
+          writeString(id.getSearchEngineVersion());
+          writeDateTime(id.getDateTime());
+          writeString(id.getScoreType());
+          write<unsigned char>(id.isHigherScoreBetter());
+          write<double>(id.getSignificanceThreshold());
+
+          const ProteinIdentification::SearchParameters& param = id.getSearchParameters();
+          writeString(param.db);
+          writeString(param.db_version);
+          writeString(param.taxonomy);
+          writeString(param.charges);
+          write<Int32>(param.mass_type);
+          writeStringList(param.fixed_modifications);
+          writeStringList(param.variable_modifications);
+          write<UInt32>(param.missed_cleavages);
+          write<double>(param.fragment_mass_tolerance);
+          write<unsigned char>(param.fragment_mass_tolerance_ppm);
+          write<double>(param.precursor_mass_tolerance);
+          write<unsigned char>(param.precursor_mass_tolerance_ppm);
+          writeString(param.digestion_enzyme.getName());
+          writeMetaInfo(param);
+
+          const std::vector<ProteinHit>& hits = id.getHits();
+          write<UInt64>(hits.size());
+          for (Size j = 0; j < hits.size(); ++j)
+          {
+            write<double>(hits[j].getScore());
+            write<UInt32>(hits[j].getRank());
+            writeString(hits[j].getAccession());
+            writeString(hits[j].getSequence());
+            write<double>(hits[j].getCoverage());
+            writeMetaInfo(hits[j]);
+          }
+          writeProteinGroups(id.getProteinGroups());
+          writeProteinGroups(id.getIndistinguishableProteins());
+          writeMetaInfo(id);
+        }
+      }
+
+      void writeDataProcessing(const std::vector<DataProcessing>& processing)
+      {
+        write<UInt64>(processing.size());
+        for (Size i = 0; i < processing.size(); ++i)
+        {
+          writeString(processing[i].getSoftware().getName());
+          writeString(processing[i].getSoftware().getVersion());
+          const std::set<DataProcessing::ProcessingAction>& actions = processing[i].getProcessingActions();
+          write<UInt64>(actions.size());
+          for (std::set<DataProcessing::ProcessingAction>::const_iterator it = actions.begin(); it != actions.end(); ++it)
+          {
+            write<Int32>(*it);
+          }
+          writeDateTime(processing[i].getCompletionTime());
+          writeMetaInfo(processing[i]);
+        }
+      }
+
+      /// Complete record of a (subordinate) feature
+      void writeFeature(const Feature& feature)
+      {
+        write<double>(feature.getRT());
+        write<double>(feature.getMZ());
+        write<float>(feature.getIntensity());
+        write<Int32>(feature.getCharge());
+        write<float>(feature.getOverallQuality());
+        write<float>(feature.getQuality(0));
+        write<float>(feature.getQuality(1));
+        write<float>(feature.getWidth());
+        write<UInt64>(feature.getUniqueId());
+        writeConvexHulls(feature.getConvexHulls());
+        writeMetaInfo(feature);
+        writePeptideIdentifications(feature.getPeptideIdentifications());
+        writeFeatures(feature.getSubordinates());
+      }
+
+      void writeFeatures(const std::vector<Feature>& features)
+      {
+        write<UInt64>(features.size());
+        for (Size i = 0; i < features.size(); ++i)
+        {
+          writeFeature(features[i]);
+        }
+      }
+
+      /// Document level information shared by feature and consensus maps
+      template <typename MapType>
+      void writeDocument(const MapType& map)
+      {
+        writeString(map.getIdentifier());
+        write<UInt64>(map.getUniqueId());
+        writeMetaInfo(map);
+        writeProteinIdentifications(map.getProteinIdentifications());
+        writePeptideIdentifications(map.getUnassignedPeptideIdentifications());
+        writeDataProcessing(map.getDataProcessing());
+      }
+
+private:
+      std::vector<char>& buffer_;
+    };
+
+    /// Reads binary values from a record, throws Exception::ParseError if the record is too short
+    class RecordReader
+    {
+public:
+      RecordReader(const char* begin, const char* end, const String& filename) :
+        pos_(begin),
+        end_(end),
+        filename_(filename)
+      {
+      }
+
+      template <typename T>
+      T read()
+      {
+        check_(sizeof(T));
+        T value;
+        std::memcpy(&value, pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+      }
+
+      /// Reads a count of items with at least @p item_size bytes each
+      Size readCount(Size item_size)
+      {
+        UInt64 count = read<UInt64>();
+        if (item_size > 0 && count > (UInt64)(end_ - pos_) / item_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            filename_, "Corrupt record (item count exceeds record size). Aborting!");
+        }
+        return count;
+      }
+
+      String readString()
+      {
+        Size length = readCount(1);
+        String s(pos_, pos_ + length);
+        pos_ += length;
+        return s;
+      }
+
+      void readStringList(std::vector<String>& list)
+      {
+        list.resize(readCount(sizeof(UInt64)));
+        for (Size i = 0; i < list.size(); ++i)
+        {
+          list[i] = readString();
+        }
+      }
+
+      DateTime readDateTime()
+      {
+        DateTime date;
+        String s = readString();
+        if (!s.empty())
+        {
+          date.set(s);
+        }
+        return date;
+      }
+
+      DataValue readDataValue()
+      {
+        DataValue value;
+        switch (read<unsigned char>())
+        {
+        case DataValue::STRING_VALUE:
+          value = DataValue(readString());
+          break;
+
+        case DataValue::INT_VALUE:
+          value = DataValue(read<Int64>());
+          break;
+
+        case DataValue::DOUBLE_VALUE:
+          value = DataValue(read<double>());
+          break;
+
+        case DataValue::STRING_LIST:
+        {
+          StringList list;
+          readStringList(list);
+          value = DataValue(list);
+        }
+        break;
+
+        case DataValue::INT_LIST:
+        {
+          IntList list(readCount(sizeof(Int64)));
+          for (Size i = 0; i < list.size(); ++i)
+          {
+            list[i] = read<Int64>();
+          }
+          value = DataValue(list);
+        }
+        break;
+
+        case DataValue::DOUBLE_LIST:
+        {
+          DoubleList list(readCount(sizeof(double)));
+          for (Size i = 0; i < list.size(); ++i)
+          {
+            list[i] = read<double>();
+          }
+          value = DataValue(list);
+        }
+        break;
+
+        case DataValue::EMPTY_VALUE:
+          break;
+
+        default:
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            filename_, "Corrupt record (unknown meta value type). Aborting!");
+        }
+        String unit = readString();
+        if (!unit.empty())
+        {
+          value.setUnit(unit);
+        }
+        return value;
+      }
+
+      void readMetaInfo(MetaInfoInterface& meta)
+      {
+        Size count = readCount(sizeof(UInt64));
+        for (Size i = 0; i < count; ++i)
+        {
+          String key = readString();
+          meta.setMetaValue(key, readDataValue());
+        }
+      }
+
+      void readConvexHulls(std::vector<ConvexHull2D>& hulls)
+      {
+        hulls.resize(readCount(sizeof(UInt64)));
+        ConvexHull2D::PointArrayType points;
+        for (Size i = 0; i < hulls.size(); ++i)
+        {
+          points.resize(readCount(2 * sizeof(double)));
+          for (Size j = 0; j < points.size(); ++j)
+          {
+            points[j][0] = read<double>();
+            points[j][1] = read<double>();
+          }
+          hulls[i].setHullPoints(points);
+        }
+      }
+
+      void readPeptideIdentifications(std::vector<PeptideIdentification>& peptides)
+      {
+        peptides.resize(readCount(sizeof(UInt64)));
+        for (Size i = 0; i < peptides.size(); ++i)
+        {
+          PeptideIdentification& id = peptides[i];
+          id.setIdentifier(readString());
+          id.setScoreType(readString());
+          id.setHigherScoreBetter(read<unsigned char>() != 0);
+          id.setSignificanceThreshold(read<double>());
+          id.setRT(read<double>());
+          id.setMZ(read<double>());
+          id.setBaseName(readString());
+          readMetaInfo(id);
+
+          std::vector<PeptideHit>& hits = id.getHits();
+          hits.resize(readCount(sizeof(double)));
+          for (Size j = 0; j < hits.size(); ++j)
+          {
+            PeptideHit& hit = hits[j];
+            hit.setScore(read<double>());
+            hit.setRank(read<UInt32>());
+            hit.setCharge(read<Int32>());
+            hit.setSequence(AASequence::fromString(readString()));
+            std::vector<PeptideEvidence> evidences(readCount(sizeof(UInt64)));
+            for (Size k = 0; k < evidences.size(); ++k)
+            {
+              evidences[k].setProteinAccession(readString());
+              evidences[k].setStart(read<Int32>());
+              evidences[k].setEnd(read<Int32>());
+              evidences[k].setAABefore(read<char>());
+              evidences[k].setAAAfter(read<char>());
+            }
+            hit.setPeptideEvidences(evidences);
+            readMetaInfo(hit);
+          }
+        }
+      }
+
+      void readProteinGroups(std::vector<ProteinIdentification::ProteinGroup>& groups)
+      {
+        groups.resize(readCount(sizeof(double)));
+        for (Size i = 0; i < groups.size(); ++i)
+        {
+          groups[i].probability = read<double>();
+          readStringList(groups[i].accessions);
+        }
+      }
+
+      void readProteinIdentifications(std::vector<ProteinIdentification>& proteins)
+      {
+        proteins.resize(readCount(sizeof(UInt64)));
+        for (Size i = 0; i < proteins.size(); ++i)
+        {
+          ProteinIdentification& id = proteins[i];
+          id.setIdentifier(readString());
+          id.setSearchEngine(readString());
+          id.setSearchEngineVersion(readString());
+          id.setDateTime(readDateTime());
+          id.setScoreType(readString());
+          id.setHigherScoreBetter(read<unsigned char>() != 0);
+          id.setSignificanceThreshold(read<double>());
+
+          ProteinIdentification::SearchParameters param;
+          param.db = readString();
+          param.db_version = readString();
+          param.taxonomy = readString();
+          param.charges = readString();
+          param.mass_type = (ProteinIdentification::PeakMassType)read<Int32>();
+          readStringList(param.fixed_modifications);
+          readStringList(param.variable_modifications);
+          param.missed_cleavages = read<UInt32>();
+          param.fragment_mass_tolerance = read<double>();
+          param.fragment_mass_tolerance_ppm = read<unsigned char>() != 0;
+          param.precursor_mass_tolerance = read<double>();
+          param.precursor_mass_tolerance_ppm = read<unsigned char>() != 0;
+          String enzyme = readString();
+          if (EnzymesDB::getInstance()->hasEnzyme(enzyme))
+          {
+            param.digestion_enzyme = *EnzymesDB::getInstance()->getEnzyme(enzyme);
+          }
+          readMetaInfo(param);
+          id.setSearchParameters(param);
+
+          std::vector<ProteinHit>& hits = id.getHits();
+          hits.resize(readCount(sizeof(double)));
+          for (Size j = 0; j < hits.size(); ++j)
+          {
+            hits[j].setScore(read<double>());
+            hits[j].setRank(read<UInt32>());
+            hits[j].setAccession(readString());
+            hits[j].setSequence(readString());
+            hits[j].setCoverage(read<double>());
+            readMetaInfo(hits[j]);
+          }
+          readProteinGroups(id.getProteinGroups());
+          readProteinGroups(id.getIndistinguishableProteins());
+          readMetaInfo(id);
+        }
+      }
+
+      void readDataProcessing(std::vector<DataProcessing>& processing)
+      {
+        processing.resize(readCount(sizeof(UInt64)));
+        for (Size i = 0; i < processing.size(); ++i)
+        {
+          processing[i].getSoftware().setName(readString());
+          processing[i].getSoftware().setVersion(readString());
+          Size nr_actions = readCount(sizeof(Int32));
+          for (Size j = 0; j < nr_actions; ++j)
+          {
+            Int32 action = read<Int32>();
+            if (action < 0 || action >= DataProcessing::SIZE_OF_PROCESSINGACTION)
+            {
+              throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                filename_, "Corrupt record (unknown processing action). Aborting!");
+            }
+            processing[i].getProcessingActions().insert((DataProcessing::ProcessingAction)action);
+          }
+          processing[i].setCompletionTime(readDateTime());
+          readMetaInfo(processing[i]);
+        }
+      }
+
+      /// Complete record of a (subordinate) feature
+      void readFeature(Feature& feature, bool load_convex_hulls)
+      {
+        feature.setRT(read<double>());
+        feature.setMZ(read<double>());
+        feature.setIntensity(read<float>());
+        feature.setCharge(read<Int32>());
+        feature.setOverallQuality(read<float>());
+        feature.setQuality(0, read<float>());
+        feature.setQuality(1, read<float>());
+        feature.setWidth(read<float>());
+        feature.removeMetaValue("FWHM"); // restored with the meta values, if it was present
+        feature.setUniqueId(read<UInt64>());
+        readConvexHulls(feature.getConvexHulls());
+        if (!load_convex_hulls)
+        {
+          feature.getConvexHulls().clear();
+        }
+        readMetaInfo(feature);
+        readPeptideIdentifications(feature.getPeptideIdentifications());
+        readFeatures(feature.getSubordinates(), load_convex_hulls);
+      }
+
+      void readFeatures(std::vector<Feature>& features, bool load_convex_hulls)
+      {
+        features.resize(readCount(sizeof(double)));
+        for (Size i = 0; i < features.size(); ++i)
+        {
+          readFeature(features[i], load_convex_hulls);
+        }
+      }
+
+      /// Document level information shared by feature and consensus maps
+      template <typename MapType>
+      void readDocument(MapType& map)
+      {
+        map.setIdentifier(readString());
+        map.setUniqueId(read<UInt64>());
+        readMetaInfo(map);
+        readProteinIdentifications(map.getProteinIdentifications());
+        readPeptideIdentifications(map.getUnassignedPeptideIdentifications());
+        readDataProcessing(map.getDataProcessing());
+      }
+
+private:
+      void check_(Size bytes) const
+      {
+        if ((Size)(end_ - pos_) < bytes)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            filename_, "Corrupt record (unexpected end of record). Aborting!");
+        }
+      }
+
+      const char* pos_;
+      const char* end_;
+      const String& filename_;
+    };
+
+    /// Accumulates a side table: one record per feature and an offset array
+    struct SideTable
+    {
+      std::vector<UInt64> offsets;
+      std::vector<char> data;
+
+      SideTable()
+      {
+        offsets.push_back(0);
+      }
+
+      /// Closes the record of the current feature
+      void next()
+      {
+        offsets.push_back(data.size());
+      }
+    };
+
+    /// Writes an aligned block and adds it to the directory
+    void writeBlock_(std::ofstream& ofs, UInt64& pos, std::vector<ColumnarFeatureFile::BlockEntry>& directory,
+                     ColumnarFeatureFile::BlockId id, const void* data, Size bytes)
+    {
+      Internal::MappedFileHelper::pad(ofs, pos, ColumnarFeatureFile::DATA_ALIGNMENT);
+      ColumnarFeatureFile::BlockEntry entry;
+      entry.id = id;
+      entry.offset = pos;
+      entry.size = bytes;
+      directory.push_back(entry);
+      if (bytes > 0)
+      {
+        ofs.write(reinterpret_cast<const char*>(data), bytes);
+      }
+      pos += bytes;
+    }
+
+    template <typename T>
+    void writeColumn_(std::ofstream& ofs, UInt64& pos, std::vector<ColumnarFeatureFile::BlockEntry>& directory,
+                      ColumnarFeatureFile::BlockId id, const std::vector<T>& column)
+    {
+      writeBlock_(ofs, pos, directory, id, column.empty() ? 0 : &column[0], column.size() * sizeof(T));
+    }
+
+    /// Writes a side table (if it contains any data)
+    void writeSideTable_(std::ofstream& ofs, UInt64& pos, std::vector<ColumnarFeatureFile::BlockEntry>& directory,
+                         ColumnarFeatureFile::BlockId offsets_id, const SideTable& table)
+    {
+      if (table.data.empty()) return;
+      writeColumn_(ofs, pos, directory, offsets_id, table.offsets);
+      writeColumn_(ofs, pos, directory, (ColumnarFeatureFile::BlockId)(offsets_id + 1), table.data);
+    }
+
+    /// Opens @p filename and writes the file header
+    void writeHeader_(std::ofstream& ofs, UInt64& pos, const String& filename, ColumnarFeatureFile::MapKind kind)
+    {
+      Header header;
+      header.file_identifier = ColumnarFeatureFile::FILE_IDENTIFIER;
+      header.file_version = ColumnarFeatureFile::FILE_VERSION;
+      header.map_kind = kind;
+      Internal::MappedFileHelper::writeHeader(ofs, pos, filename, &header, sizeof(Header));
+    }
+
+    /// Writes the block directory and the trailer and closes the file
+    void writeTrailer_(std::ofstream& ofs, UInt64& pos, const String& filename,
+                       const std::vector<ColumnarFeatureFile::BlockEntry>& directory, Size nr_features)
+    {
+      Internal::MappedFileHelper::pad(ofs, pos, ColumnarFeatureFile::DATA_ALIGNMENT);
+      Trailer trailer;
+      trailer.directory_offset = pos;
+      trailer.nr_blocks = directory.size();
+      trailer.nr_features = nr_features;
+      ofs.write((const char*)&directory[0], directory.size() * sizeof(ColumnarFeatureFile::BlockEntry));
+      Internal::MappedFileHelper::writeTrailer(ofs, filename, ColumnarFeatureFile::FILE_IDENTIFIER, &trailer, sizeof(Trailer));
+    }
+
+    /// Collects the columns and side tables shared by features and consensus features
+    struct CommonColumns
+    {
+      std::vector<double> rt, mz;
+      std::vector<float> intensity, quality, width;
+      std::vector<Int32> charge;
+      std::vector<UInt64> unique_id;
+      SideTable meta, peptides;
+
+      explicit CommonColumns(Size n)
+      {
+        rt.reserve(n);
+        mz.reserve(n);
+        intensity.reserve(n);
+        quality.reserve(n);
+        width.reserve(n);
+        charge.reserve(n);
+        unique_id.reserve(n);
+      }
+
+      void add(const BaseFeature& feature)
+      {
+        rt.push_back(feature.getRT());
+        mz.push_back(feature.getMZ());
+        intensity.push_back(feature.getIntensity());
+        quality.push_back(feature.getQuality());
+        width.push_back(feature.getWidth());
+        charge.push_back(feature.getCharge());
+        unique_id.push_back(feature.getUniqueId());
+        if (!feature.isMetaEmpty())
+        {
+          RecordWriter(meta.data).writeMetaInfo(feature);
+        }
+        meta.next();
+        if (!feature.getPeptideIdentifications().empty())
+        {
+          RecordWriter(peptides.data).writePeptideIdentifications(feature.getPeptideIdentifications());
+        }
+        peptides.next();
+      }
+
+      void write(std::ofstream& ofs, UInt64& pos, std::vector<ColumnarFeatureFile::BlockEntry>& directory) const
+      {
+        writeColumn_(ofs, pos, directory, ColumnarFeatureFile::RT, rt);
+        writeColumn_(ofs, pos, directory, ColumnarFeatureFile::MZ, mz);
+        writeColumn_(ofs, pos, directory, ColumnarFeatureFile::INTENSITY, intensity);
+        writeColumn_(ofs, pos, directory, ColumnarFeatureFile::CHARGE, charge);
+        writeColumn_(ofs, pos, directory, ColumnarFeatureFile::QUALITY, quality);
+        writeColumn_(ofs, pos, directory, ColumnarFeatureFile::WIDTH, width);
+        writeColumn_(ofs, pos, directory, ColumnarFeatureFile::UNIQUE_ID, unique_id);
+        writeSideTable_(ofs, pos, directory, ColumnarFeatureFile::META_OFFSETS, meta);
+        writeSideTable_(ofs, pos, directory, ColumnarFeatureFile::PEPTIDE_OFFSETS, peptides);
+      }
+    };
+  }
+
+  ColumnarFeatureFile::ColumnarFeatureFile(const String& filename) :
+    filename_(filename),
+    map_kind_(FEATURE_MAP),
+    size_(0),
+    nr_handles_(0),
+    options_()
+  {
+    for (Size i = 0; i < SIZE_OF_BLOCKID; ++i)
+    {
+      blocks_[i] = 0;
+      block_sizes_[i] = 0;
+    }
+
+    Internal::MappedFileHelper::mapFile(file_, filename);
+    const char* data = file_.data();
+    const Size file_size = file_.size();
+
+    // check the header
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    if (file_size >= sizeof(Header))
+    {
+      std::memcpy(&header, data, sizeof(Header));
+    }
+    if (header.file_identifier != FILE_IDENTIFIER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, "File is not a columnar feature file (wrong file identifier). Aborting!");
+    }
+    Trailer trailer;
+    if (!Internal::MappedFileHelper::readTrailer(file_, FILE_IDENTIFIER, &trailer, sizeof(Trailer)))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, "File is truncated (no block directory found). Aborting!");
+    }
+    if (header.file_version != FILE_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, String("Unsupported file format version ") + header.file_version + " (expected " + FILE_VERSION + ").");
+    }
+    map_kind_ = (MapKind)header.map_kind;
+
+    // check the block directory
+    if (trailer.directory_offset < HEADER_SIZE ||
+        trailer.directory_offset % DATA_ALIGNMENT != 0 ||
+        trailer.nr_blocks > SIZE_OF_BLOCKID ||
+        trailer.directory_offset + trailer.nr_blocks * sizeof(BlockEntry) + sizeof(Trailer) + sizeof(UInt64) != file_size)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, "File is truncated or the block directory is corrupt. Aborting!");
+    }
+    size_ = trailer.nr_features;
+    const BlockEntry* directory = reinterpret_cast<const BlockEntry*>(data + trailer.directory_offset);
+    for (Size i = 0; i < trailer.nr_blocks; ++i)
+    {
+      const BlockEntry& entry = directory[i];
+      if (entry.id >= SIZE_OF_BLOCKID || blocks_[entry.id] != 0 ||
+          entry.offset < HEADER_SIZE || entry.offset % DATA_ALIGNMENT != 0 ||
+          entry.offset > trailer.directory_offset || entry.size > trailer.directory_offset - entry.offset)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          filename, String("Invalid block directory entry ") + i + " found. Aborting!");
+      }
+      blocks_[entry.id] = data + entry.offset;
+      block_sizes_[entry.id] = entry.size;
+    }
+
+    // make sure that all required blocks are present and have the right
+    // size, so that the access functions do not need to check anything
+    std::vector<std::pair<BlockId, UInt64> > required;
+    required.push_back(std::make_pair(RT, size_ * sizeof(double)));
+    required.push_back(std::make_pair(MZ, size_ * sizeof(double)));
+    required.push_back(std::make_pair(INTENSITY, size_ * sizeof(float)));
+    required.push_back(std::make_pair(CHARGE, size_ * sizeof(Int32)));
+    required.push_back(std::make_pair(QUALITY, size_ * sizeof(float)));
+    required.push_back(std::make_pair(WIDTH, size_ * sizeof(float)));
+    required.push_back(std::make_pair(UNIQUE_ID, size_ * sizeof(UInt64)));
+    if (map_kind_ == FEATURE_MAP)
+    {
+      required.push_back(std::make_pair(QUALITY_RT, size_ * sizeof(float)));
+      required.push_back(std::make_pair(QUALITY_MZ, size_ * sizeof(float)));
+    }
+    else if (map_kind_ == CONSENSUS_MAP)
+    {
+      required.push_back(std::make_pair(HANDLE_OFFSETS, (size_ + 1) * sizeof(UInt64)));
+    }
+    else
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, String("Unknown map kind ") + header.map_kind + " found. Aborting!");
+    }
+    for (Size i = 0; i < required.size(); ++i)
+    {
+      if (blocks_[required[i].first] == 0 || block_sizes_[required[i].first] != required[i].second)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          filename, String("Block ") + required[i].first + " is missing or has a wrong size. Aborting!");
+      }
+    }
+    if (blocks_[DOCUMENT] == 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, "Document block is missing. Aborting!");
+    }
+
+    // offset arrays must be non-decreasing and end at the size of their data
+    for (Size id = HULL_OFFSETS; id <= HANDLE_OFFSETS; id += 2)
+    {
+      if (blocks_[id] == 0) continue;
+      const UInt64* offsets = block_<UInt64>((BlockId)id);
+      UInt64 end = (id == HANDLE_OFFSETS) ? offsets[size_] : block_sizes_[id + 1];
+      bool valid = block_sizes_[id] == (size_ + 1) * sizeof(UInt64) && offsets[0] == 0 && offsets[size_] == end &&
+                   (id == HANDLE_OFFSETS || blocks_[id + 1] != 0);
+      for (Size i = 0; valid && i < size_; ++i)
+      {
+        valid = offsets[i] <= offsets[i + 1];
+      }
+      if (!valid)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          filename, String("Invalid offsets found in block ") + id + ". Aborting!");
+      }
+    }
+    if (map_kind_ == CONSENSUS_MAP)
+    {
+      nr_handles_ = block_<UInt64>(HANDLE_OFFSETS)[size_];
+      const Size handle_sizes[] = {sizeof(UInt64), sizeof(UInt64), sizeof(double), sizeof(double), sizeof(float), sizeof(Int32), sizeof(float)};
+      for (Size id = HANDLE_MAP_INDEX; id <= HANDLE_WIDTH; ++id)
+      {
+        if (blocks_[id] == 0 || block_sizes_[id] != nr_handles_ * handle_sizes[id - HANDLE_MAP_INDEX])
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            filename, String("Block ") + id + " is missing or has a wrong size. Aborting!");
+        }
+      }
+    }
+  }
+
+  ColumnarFeatureFile::~ColumnarFeatureFile()
+  {
+    if (file_.is_open())
+    {
+      file_.close();
+    }
+  }
+
+  void ColumnarFeatureFile::store(const String& filename, const FeatureMap& feature_map)
+  {
+    std::ofstream ofs;
+    UInt64 pos = 0;
+    writeHeader_(ofs, pos, filename, FEATURE_MAP);
+
+    // columns and side tables
+    const Size n = feature_map.size();
+    CommonColumns common(n);
+    std::vector<float> quality_rt, quality_mz;
+    quality_rt.reserve(n);
+    quality_mz.reserve(n);
+    SideTable hulls, subordinates;
+    for (Size i = 0; i < n; ++i)
+    {
+      const Feature& feature = feature_map[i];
+      common.add(feature);
+      quality_rt.push_back(feature.getQuality(0));
+      quality_mz.push_back(feature.getQuality(1));
+      if (!feature.getConvexHulls().empty())
+      {
+        RecordWriter(hulls.data).writeConvexHulls(feature.getConvexHulls());
+      }
+      hulls.next();
+      if (!feature.getSubordinates().empty())
+      {
+        RecordWriter(subordinates.data).writeFeatures(feature.getSubordinates());
+      }
+      subordinates.next();
+    }
+
+    std::vector<BlockEntry> directory;
+    common.write(ofs, pos, directory);
+    writeColumn_(ofs, pos, directory, QUALITY_RT, quality_rt);
+    writeColumn_(ofs, pos, directory, QUALITY_MZ, quality_mz);
+    writeSideTable_(ofs, pos, directory, HULL_OFFSETS, hulls);
+    writeSideTable_(ofs, pos, directory, SUBORDINATE_OFFSETS, subordinates);
+
+    std::vector<char> document;
+    RecordWriter(document).writeDocument(feature_map);
+    writeColumn_(ofs, pos, directory, DOCUMENT, document);
+
+    writeTrailer_(ofs, pos, filename, directory, n);
+  }
+
+  void ColumnarFeatureFile::store(const String& filename, const ConsensusMap& consensus_map)
+  {
+    std::ofstream ofs;
+    UInt64 pos = 0;
+    writeHeader_(ofs, pos, filename, CONSENSUS_MAP);
+
+    // columns and side tables
+    const Size n = consensus_map.size();
+    CommonColumns common(n);
+    std::vector<UInt64> handle_offsets(1, 0), handle_map_index, handle_unique_id;
+    std::vector<double> handle_rt, handle_mz;
+    std::vector<float> handle_intensity, handle_width;
+    std::vector<Int32> handle_charge;
+    for (Size i = 0; i < n; ++i)
+    {
+      const ConsensusFeature& feature = consensus_map[i];
+      common.add(feature);
+      for (ConsensusFeature::HandleSetType::const_iterator it = feature.begin(); it != feature.end(); ++it)
+      {
+        handle_map_index.push_back(it->getMapIndex());
+        handle_unique_id.push_back(it->getUniqueId());
+        handle_rt.push_back(it->getRT());
+        handle_mz.push_back(it->getMZ());
+        handle_intensity.push_back(it->getIntensity());
+        handle_charge.push_back(it->getCharge());
+        handle_width.push_back(it->getWidth());
+      }
+      handle_offsets.push_back(handle_map_index.size());
+    }
+
+    std::vector<BlockEntry> directory;
+    common.write(ofs, pos, directory);
+    writeColumn_(ofs, pos, directory, HANDLE_OFFSETS, handle_offsets);
+    writeColumn_(ofs, pos, directory, HANDLE_MAP_INDEX, handle_map_index);
+    writeColumn_(ofs, pos, directory, HANDLE_UNIQUE_ID, handle_unique_id);
+    writeColumn_(ofs, pos, directory, HANDLE_RT, handle_rt);
+    writeColumn_(ofs, pos, directory, HANDLE_MZ, handle_mz);
+    writeColumn_(ofs, pos, directory, HANDLE_INTENSITY, handle_intensity);
+    writeColumn_(ofs, pos, directory, HANDLE_CHARGE, handle_charge);
+    writeColumn_(ofs, pos, directory, HANDLE_WIDTH, handle_width);
+
+    std::vector<char> document;
+    RecordWriter writer(document);
+    writer.writeDocument(consensus_map);
+    writer.writeString(consensus_map.getExperimentType());
+    const ConsensusMap::FileDescriptions& descriptions = consensus_map.getFileDescriptions();
+    writer.write<UInt64>(descriptions.size());
+    for (ConsensusMap::FileDescriptions::const_iterator it = descriptions.begin(); it != descriptions.end(); ++it)
+    {
+      writer.write<UInt64>(it->first);
+      writer.writeString(it->second.filename);
+      writer.writeString(it->second.label);
+      writer.write<UInt64>(it->second.size);
+      writer.write<UInt64>(it->second.unique_id);
+      writer.writeMetaInfo(it->second);
+    }
+    writeColumn_(ofs, pos, directory, DOCUMENT, document);
+
+    writeTrailer_(ofs, pos, filename, directory, n);
+  }
+
+  FileTypes::Type ColumnarFeatureFile::getTypeByContent(const String& filename)
+  {
+    Header header;
+    if (!Internal::MappedFileHelper::readHeader(filename, &header, sizeof(Header)) ||
+        header.file_identifier != FILE_IDENTIFIER)
+    {
+      return FileTypes::UNKNOWN;
+    }
+    if (header.map_kind == FEATURE_MAP)
+    {
+      return FileTypes::FEATUREBIN;
+    }
+    if (header.map_kind == CONSENSUS_MAP)
+    {
+      return FileTypes::CONSENSUSBIN;
+    }
+    return FileTypes::UNKNOWN;
+  }
+
+  ColumnarFeatureFile::MapKind ColumnarFeatureFile::getMapKind() const
+  {
+    return map_kind_;
+  }
+
+  Size ColumnarFeatureFile::size() const
+  {
+    return size_;
+  }
+
+  bool ColumnarFeatureFile::hasBlock(BlockId id) const
+  {
+    return blocks_[id] != 0;
+  }
+
+  const double* ColumnarFeatureFile::getRT() const
+  {
+    return block_<double>(RT);
+  }
+
+  const double* ColumnarFeatureFile::getMZ() const
+  {
+    return block_<double>(MZ);
+  }
+
+  const float* ColumnarFeatureFile::getIntensity() const
+  {
+    return block_<float>(INTENSITY);
+  }
+
+  const Int32* ColumnarFeatureFile::getCharge() const
+  {
+    return block_<Int32>(CHARGE);
+  }
+
+  const float* ColumnarFeatureFile::getQuality() const
+  {
+    return block_<float>(QUALITY);
+  }
+
+  bool ColumnarFeatureFile::record_(BlockId offsets_id, Size index, const char*& begin, const char*& end) const
+  {
+    if (blocks_[offsets_id] == 0) return false;
+    const UInt64* offsets = block_<UInt64>(offsets_id);
+    if (offsets[index] == offsets[index + 1]) return false;
+    begin = blocks_[offsets_id + 1] + offsets[index];
+    end = blocks_[offsets_id + 1] + offsets[index + 1];
+    return true;
+  }
+
+  void ColumnarFeatureFile::checkMapKind_(MapKind kind) const
+  {
+    if (map_kind_ != kind)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename_, kind == FEATURE_MAP ? "File does not contain a feature map. Aborting!" : "File does not contain a consensus map. Aborting!");
+    }
+  }
+
+  bool ColumnarFeatureFile::inRanges_(Size index) const
+  {
+    return (!options_.hasRTRange() || options_.getRTRange().encloses(getRT()[index])) &&
+           (!options_.hasMZRange() || options_.getMZRange().encloses(getMZ()[index])) &&
+           (!options_.hasIntensityRange() || options_.getIntensityRange().encloses(getIntensity()[index]));
+  }
+
+  void ColumnarFeatureFile::getFeature(Size index, Feature& feature) const
+  {
+    OPENMS_PRECONDITION(index < size(), "Index cannot be larger than number of features");
+    checkMapKind_(FEATURE_MAP);
+
+    feature = Feature();
+    feature.setRT(getRT()[index]);
+    feature.setMZ(getMZ()[index]);
+    feature.setIntensity(getIntensity()[index]);
+    feature.setCharge(getCharge()[index]);
+    feature.setOverallQuality(getQuality()[index]);
+    feature.setQuality(0, block_<float>(QUALITY_RT)[index]);
+    feature.setQuality(1, block_<float>(QUALITY_MZ)[index]);
+    feature.setWidth(block_<float>(WIDTH)[index]);
+    feature.removeMetaValue("FWHM"); // restored with the meta values, if it was present
+    feature.setUniqueId(block_<UInt64>(UNIQUE_ID)[index]);
+
+    const char* begin;
+    const char* end;
+    if (options_.getLoadConvexHull() && record_(HULL_OFFSETS, index, begin, end))
+    {
+      RecordReader(begin, end, filename_).readConvexHulls(feature.getConvexHulls());
+    }
+    if (options_.getLoadSubordinates() && record_(SUBORDINATE_OFFSETS, index, begin, end))
+    {
+      RecordReader(begin, end, filename_).readFeatures(feature.getSubordinates(), options_.getLoadConvexHull());
+    }
+    if (record_(META_OFFSETS, index, begin, end))
+    {
+      RecordReader(begin, end, filename_).readMetaInfo(feature);
+    }
+    if (record_(PEPTIDE_OFFSETS, index, begin, end))
+    {
+      RecordReader(begin, end, filename_).readPeptideIdentifications(feature.getPeptideIdentifications());
+    }
+  }
+
+  void ColumnarFeatureFile::getConsensusFeature(Size index, ConsensusFeature& feature) const
+  {
+    OPENMS_PRECONDITION(index < size(), "Index cannot be larger than number of features");
+    checkMapKind_(CONSENSUS_MAP);
+
+    feature = ConsensusFeature();
+    feature.setRT(getRT()[index]);
+    feature.setMZ(getMZ()[index]);
+    feature.setIntensity(getIntensity()[index]);
+    feature.setCharge(getCharge()[index]);
+    feature.setQuality(getQuality()[index]);
+    feature.setWidth(block_<float>(WIDTH)[index]);
+    feature.removeMetaValue("FWHM"); // restored with the meta values, if it was present
+    feature.setUniqueId(block_<UInt64>(UNIQUE_ID)[index]);
+
+    const UInt64* handle_offsets = block_<UInt64>(HANDLE_OFFSETS);
+    for (UInt64 h = handle_offsets[index]; h < handle_offsets[index + 1]; ++h)
+    {
+      FeatureHandle handle;
+      handle.setMapIndex(block_<UInt64>(HANDLE_MAP_INDEX)[h]);
+      handle.setUniqueId(block_<UInt64>(HANDLE_UNIQUE_ID)[h]);
+      handle.setRT(block_<double>(HANDLE_RT)[h]);
+      handle.setMZ(block_<double>(HANDLE_MZ)[h]);
+      handle.setIntensity(block_<float>(HANDLE_INTENSITY)[h]);
+      handle.setCharge(block_<Int32>(HANDLE_CHARGE)[h]);
+      handle.setWidth(block_<float>(HANDLE_WIDTH)[h]);
+      feature.insert(handle);
+    }
+
+    const char* begin;
+    const char* end;
+    if (record_(META_OFFSETS, index, begin, end))
+    {
+      RecordReader(begin, end, filename_).readMetaInfo(feature);
+    }
+    if (record_(PEPTIDE_OFFSETS, index, begin, end))
+    {
+      RecordReader(begin, end, filename_).readPeptideIdentifications(feature.getPeptideIdentifications());
+    }
+  }
+
+  void ColumnarFeatureFile::load(FeatureMap& feature_map) const
+  {
+    checkMapKind_(FEATURE_MAP);
+
+    feature_map.clear(true);
+    feature_map.setLoadedFileType(filename_);
+    feature_map.setLoadedFilePath(filename_);
+
+    RecordReader(blocks_[DOCUMENT], blocks_[DOCUMENT] + block_sizes_[DOCUMENT], filename_).readDocument(feature_map);
+
+    if (!options_.getMetadataOnly())
+    {
+      feature_map.reserve(size_);
+      for (Size i = 0; i < size_; ++i)
+      {
+        if (inRanges_(i))
+        {
+          feature_map.push_back(Feature());
+          getFeature(i, feature_map.back());
+        }
+      }
+    }
+    feature_map.updateRanges();
+  }
+
+  void ColumnarFeatureFile::load(ConsensusMap& consensus_map) const
+  {
+    checkMapKind_(CONSENSUS_MAP);
+
+    consensus_map.clear(true);
+    consensus_map.setLoadedFileType(filename_);
+    consensus_map.setLoadedFilePath(filename_);
+
+    RecordReader reader(blocks_[DOCUMENT], blocks_[DOCUMENT] + block_sizes_[DOCUMENT], filename_);
+    reader.readDocument(consensus_map);
+    consensus_map.setExperimentType(reader.readString());
+    Size nr_descriptions = reader.readCount(sizeof(UInt64));
+    for (Size i = 0; i < nr_descriptions; ++i)
+    {
+      ConsensusMap::FileDescription& description = consensus_map.getFileDescriptions()[reader.read<UInt64>()];
+      description.filename = reader.readString();
+      description.label = reader.readString();
+      description.size = reader.read<UInt64>();
+      description.unique_id = reader.read<UInt64>();
+      reader.readMetaInfo(description);
+    }
+
+    if (!options_.getMetadataOnly())
+    {
+      consensus_map.reserve(size_);
+      for (Size i = 0; i < size_; ++i)
+      {
+        if (inRanges_(i))
+        {
+          consensus_map.push_back(ConsensusFeature());
+          getConsensusFeature(i, consensus_map.back());
+        }
+      }
+    }
+    consensus_map.updateRanges();
+  }
+
+  FeatureFileOptions& ColumnarFeatureFile::getOptions()
+  {
+    return options_;
+  }
+
+  const FeatureFileOptions& ColumnarFeatureFile::getOptions() const
+  {
+    return options_;
+  }
+
+  const String& ColumnarFeatureFile::getFilename() const
+  {
+    return filename_;
+  }
+
+} // namespace OpenMS
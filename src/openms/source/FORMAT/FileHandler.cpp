@@ -39,6 +39,8 @@
 #include <OpenMS/FORMAT/MzXMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/FORMAT/ColumnarFeatureFile.h>
 #include <OpenMS/FORMAT/MzDataFile.h>
 #include <OpenMS/FORMAT/MascotGenericFile.h>
 #include <OpenMS/FORMAT/MS2File.h>
@@ -121,6 +123,13 @@ namespace OpenMS
 
   FileTypes::Type FileHandler::getTypeByContent(const String& filename)
   {
+    // binary formats are recognized by their header
+    FileTypes::Type binary_type = ColumnarFeatureFile::getTypeByContent(filename);
+    if (binary_type != FileTypes::UNKNOWN)
+    {
+      return binary_type;
+    }
+
     String first_line;
     String two_five;
     String all_simple;
@@ -460,6 +469,21 @@ if (first_line.hasSubstring("File	First Scan	Last Scan	Num of Scans	Charge	Monoi
     options_ = options;
   }
 
+  FeatureFileOptions& FileHandler::getFeatOptions()
+  {
+    return feature_options_;
+  }
+
+  const FeatureFileOptions& FileHandler::getFeatOptions() const
+  {
+    return feature_options_;
+  }
+
+  void FileHandler::setFeatOptions(const FeatureFileOptions& options)
+  {
+    feature_options_ = options;
+  }
+
   String FileHandler::computeFileHash(const String& filename)
   {
     QCryptographicHash crypto(QCryptographicHash::Sha1);
@@ -495,7 +519,15 @@ if (first_line.hasSubstring("File	First Scan	Last Scan	Num of Scans	Charge	Monoi
     //load right file
     if (type == FileTypes::FEATUREXML)
     {
-      FeatureXMLFile().load(filename, map);
+      FeatureXMLFile f;
+      f.getOptions() = feature_options_;
+      f.load(filename, map);
+    }
+    else if (type == FileTypes::FEATUREBIN)
+    {
+      ColumnarFeatureFile f(filename);
+      f.getOptions() = feature_options_;
+      f.load(map);
     }
     else if (type == FileTypes::TSV)
     {
@@ -517,6 +549,83 @@ if (first_line.hasSubstring("File	First Scan	Last Scan	Num of Scans	Charge	Monoi
     return true;
   }
 
+  void FileHandler::storeFeatures(const String& filename, const FeatureMap& map)
+  {
+    if (getTypeByFileName(filename) == FileTypes::FEATUREBIN)
+    {
+      ColumnarFeatureFile::store(filename, map);
+    }
+    else
+    {
+      FeatureXMLFile().store(filename, map);
+    }
+  }
+
+  bool FileHandler::loadConsensusFeatures(const String& filename, ConsensusMap& map, FileTypes::Type force_type)
+  {
+    //determine file type
+    FileTypes::Type type;
+    if (force_type != FileTypes::UNKNOWN)
+    {
+      type = force_type;
+    }
+    else
+    {
+      try
+      {
+        type = getType(filename);
+      }
+      catch (Exception::FileNotFound)
+      {
+        return false;
+      }
+    }
+
+    //load right file
+    if (type == FileTypes::CONSENSUSXML)
+    {
+      ConsensusXMLFile f;
+      f.getOptions() = options_;
+      f.load(filename, map);
+    }
+    else if (type == FileTypes::CONSENSUSBIN)
+    {
+      // consensus maps only support the ranges of the peak file options
+      ColumnarFeatureFile f(filename);
+      if (options_.hasRTRange())
+      {
+        f.getOptions().setRTRange(options_.getRTRange());
+      }
+      if (options_.hasMZRange())
+      {
+        f.getOptions().setMZRange(options_.getMZRange());
+      }
+      if (options_.hasIntensityRange())
+      {
+        f.getOptions().setIntensityRange(options_.getIntensityRange());
+      }
+      f.load(map);
+    }
+    else
+    {
+      return false;
+    }
+
+    return true;
+  }
+
+  void FileHandler::storeConsensusFeatures(const String& filename, const ConsensusMap& map)
+  {
+    if (getTypeByFileName(filename) == FileTypes::CONSENSUSBIN)
+    {
+      ColumnarFeatureFile::store(filename, map);
+    }
+    else
+    {
+      ConsensusXMLFile().store(filename, map);
+    }
+  }
+
   bool FileHandler::loadExperiment(const String& filename, PeakMap& exp, FileTypes::Type force_type, ProgressLogger::LogType log, const bool rewrite_source_file, const bool compute_hash)
   {
     // setting the flag for hash recomputation only works if source file entries are rewritten 
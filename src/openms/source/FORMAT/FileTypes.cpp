@@ -131,6 +131,8 @@ namespace OpenMS
     targetMap[FileTypes::MRM] = "mrm";
     targetMap[FileTypes::PSMS] = "psms";
     targetMap[FileTypes::PARAMXML] = "paramXML";
+    targetMap[FileTypes::FEATUREBIN] = "featureBin";
+    targetMap[FileTypes::CONSENSUSBIN] = "consensusBin";
 
     return targetMap;
   }
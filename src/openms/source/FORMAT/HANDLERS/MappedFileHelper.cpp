@@ -0,0 +1,130 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/HANDLERS/MappedFileHelper.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Macros.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <cstring>
+
+namespace OpenMS
+{
+  namespace Internal
+  {
+    const Size MappedFileHelper::HEADER_SIZE;
+    const Size MappedFileHelper::DATA_ALIGNMENT;
+
+    void MappedFileHelper::writeHeader(std::ofstream& ofs, UInt64& pos, const String& filename, const void* header, Size header_size)
+    {
+      OPENMS_PRECONDITION(header_size <= HEADER_SIZE, "Header does not fit into the first page");
+      ofs.open(filename.c_str(), std::ios::binary);
+      if (!ofs)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      ofs.write(reinterpret_cast<const char*>(header), header_size);
+      pos = header_size;
+      pad(ofs, pos, HEADER_SIZE);
+    }
+
+    void MappedFileHelper::pad(std::ofstream& ofs, UInt64& pos, Size alignment)
+    {
+      static const char zeros[HEADER_SIZE] = {0};
+      Size rest = pos % alignment;
+      if (rest == 0) return;
+      ofs.write(zeros, alignment - rest);
+      pos += alignment - rest;
+    }
+
+    void MappedFileHelper::writeTrailer(std::ofstream& ofs, const String& filename, UInt64 identifier, const void* trailer, Size trailer_size)
+    {
+      if (trailer_size > 0)
+      {
+        ofs.write(reinterpret_cast<const char*>(trailer), trailer_size);
+      }
+      ofs.write((const char*)&identifier, sizeof(identifier));
+
+      ofs.close();
+      if (ofs.fail())
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+    }
+
+    bool MappedFileHelper::readHeader(const String& filename, void* header, Size header_size)
+    {
+      std::ifstream ifs(filename.c_str(), std::ios::binary);
+      return bool(ifs.read(reinterpret_cast<char*>(header), header_size));
+    }
+
+    void MappedFileHelper::mapFile(boost::iostreams::mapped_file_source& file, const String& filename)
+    {
+      if (!File::exists(filename))
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      try
+      {
+        file.open(filename);
+      }
+      catch (std::exception& e)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          filename, String("Unable to map file into memory: ") + e.what());
+      }
+    }
+
+    bool MappedFileHelper::readTrailer(const boost::iostreams::mapped_file_source& file, UInt64 identifier, void* trailer, Size trailer_size)
+    {
+      const Size file_size = file.size();
+      if (file_size < HEADER_SIZE + trailer_size + sizeof(identifier))
+      {
+        return false;
+      }
+      UInt64 file_identifier;
+      std::memcpy(&file_identifier, file.data() + file_size - sizeof(identifier), sizeof(identifier));
+      if (file_identifier != identifier)
+      {
+        return false;
+      }
+      if (trailer_size > 0)
+      {
+        std::memcpy(trailer, file.data() + file_size - sizeof(identifier) - trailer_size, trailer_size);
+      }
+      return true;
+    }
+  }
+}
@@ -37,6 +37,10 @@
 #include <OpenMS/FORMAT/ControlledVocabulary.h>
 #include <OpenMS/FORMAT/CVMappingFile.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   namespace Internal
@@ -54,6 +58,7 @@ namespace OpenMS
       default_array_length_(0),
       in_spectrum_list_(false),
       decoder_(),
+      thread_decoders_(),
       logger_(logger),
       consumer_(NULL),
       scan_count(0),
@@ -91,6 +96,7 @@ namespace OpenMS
       default_array_length_(0),
       in_spectrum_list_(false),
       decoder_(),
+      thread_decoders_(),
       logger_(logger),
       consumer_(NULL),
       scan_count(0),
@@ -121,6 +127,27 @@ namespace OpenMS
     {
     }
 
+    void MzMLHandler::initThreadDecoders_()
+    {
+      Size nr_threads = 1;
+#ifdef _OPENMP
+      nr_threads = omp_get_max_threads();
+#endif
+      if (thread_decoders_.size() < nr_threads)
+      {
+        thread_decoders_.resize(nr_threads);
+      }
+    }
+
+    Base64& MzMLHandler::threadDecoder_()
+    {
+#ifdef _OPENMP
+      return thread_decoders_[omp_get_thread_num()];
+#else
+      return thread_decoders_[0];
+#endif
+    }
+
     void MzMLHandler::populateSpectraWithData()
     {
 
@@ -128,6 +155,7 @@ namespace OpenMS
       if (options_.getFillData())
       {
         size_t errCount = 0;
+        initThreadDecoders_();
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -140,7 +168,7 @@ namespace OpenMS
             {
               populateSpectraWithData_(spectrum_data_[i].data,
                                        spectrum_data_[i].default_array_length, options_,
-                                       spectrum_data_[i].spectrum);
+                                       spectrum_data_[i].spectrum, threadDecoder_());
               if (options_.getSortSpectraByMZ() && !spectrum_data_[i].spectrum.isSorted())
               {
                 spectrum_data_[i].spectrum.sortByPosition();
@@ -186,6 +214,7 @@ namespace OpenMS
       if (options_.getFillData())
       {
         size_t errCount = 0;
+        initThreadDecoders_();
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -196,7 +225,7 @@ namespace OpenMS
           {
             populateChromatogramsWithData_(chromatogram_data_[i].data,
                                            chromatogram_data_[i].default_array_length, options_,
-                                           chromatogram_data_[i].chromatogram);
+                                           chromatogram_data_[i].chromatogram, threadDecoder_());
             if (options_.getSortChromatogramsByRT() && !chromatogram_data_[i].chromatogram.isSorted())
             {
               chromatogram_data_[i].chromatogram.sortByPosition();
@@ -278,12 +307,12 @@ namespace OpenMS
 
     void MzMLHandler::populateSpectraWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                   Size& default_arr_length, const PeakFileOptions& peak_file_options,
-                                  SpectrumType& spectrum)
+                                  SpectrumType& spectrum, Base64& decoder)
     {
       typedef SpectrumType::PeakType PeakType;
 
       //decode all base64 arrays
-      MzMLHandlerHelper::decodeBase64Arrays(input_data, options_.getSkipXMLChecks());
+      MzMLHandlerHelper::decodeBase64Arrays(input_data, options_.getSkipXMLChecks(), decoder);
 
       //look up the precision and the index of the intensity and m/z array
       bool mz_precision_64 = true;
@@ -446,12 +475,12 @@ namespace OpenMS
 
     void MzMLHandler::populateChromatogramsWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                         Size& default_arr_length, const PeakFileOptions& peak_file_options,
-                                        ChromatogramType& inp_chromatogram)
+                                        ChromatogramType& inp_chromatogram, Base64& decoder)
     {
       typedef ChromatogramType::PeakType ChromatogramPeakType;
 
       //decode all base64 arrays
-      MzMLHandlerHelper::decodeBase64Arrays(input_data, options_.getSkipXMLChecks());
+      MzMLHandlerHelper::decodeBase64Arrays(input_data, options_.getSkipXMLChecks(), decoder);
 
       //look up the precision and the index of the intensity and m/z array
       bool int_precision_64 = true;
@@ -165,7 +165,12 @@ namespace OpenMS
   void MzMLHandlerHelper::decodeBase64Arrays(std::vector<BinaryData> & data_, bool skipXMLCheck)
   {
     // Decoder/Encoder for Base64-data in MzML
-    Base64 decoder_;
+    Base64 decoder;
+    decodeBase64Arrays(data_, skipXMLCheck, decoder);
+  }
+
+  void MzMLHandlerHelper::decodeBase64Arrays(std::vector<BinaryData> & data_, bool skipXMLCheck, Base64 & decoder_)
+  {
 
     // decode all base64 arrays
     for (Size i = 0; i < data_.size(); i++)
@@ -208,7 +213,7 @@ namespace OpenMS
         }
         else if (data_[i].precision == BinaryData::PRE_64)
         {
-          decoder_.decode(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].floats_64, data_[i].compression);
+          decoder_.decodeFast(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].floats_64, data_[i].compression);
           if (data_[i].size != data_[i].floats_64.size())
           {
             MzMLHandlerHelper::warning(0, String("Float binary data array '") + data_[i].meta.getName() + 
@@ -218,7 +223,7 @@ namespace OpenMS
         }
         else if (data_[i].precision == BinaryData::PRE_32)
         {
-          decoder_.decode(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].floats_32, data_[i].compression);
+          decoder_.decodeFast(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].floats_32, data_[i].compression);
           if (data_[i].size != data_[i].floats_32.size())
           {
             MzMLHandlerHelper::warning(0, String("Float binary data array '") + data_[i].meta.getName() + 
@@ -231,7 +236,7 @@ namespace OpenMS
       {
         if (data_[i].precision == BinaryData::PRE_64)
         {
-          decoder_.decodeIntegers(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].ints_64, data_[i].compression);
+          decoder_.decodeFast(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].ints_64, data_[i].compression);
           if (data_[i].size != data_[i].ints_64.size())
           {
             MzMLHandlerHelper::warning(0, String("Integer binary data array '") + data_[i].meta.getName() + 
@@ -241,7 +246,7 @@ namespace OpenMS
         }
         else if (data_[i].precision == BinaryData::PRE_32)
         {
-          decoder_.decodeIntegers(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].ints_32, data_[i].compression);
+          decoder_.decodeFast(data_[i].base64, Base64::BYTEORDER_LITTLEENDIAN, data_[i].ints_32, data_[i].compression);
           if (data_[i].size != data_[i].ints_32.size())
           {
             MzMLHandlerHelper::warning(0, String("Integer binary data array '") + data_[i].meta.getName() + 
@@ -6,6 +6,7 @@ set(sources_list
 	AcqusHandler.cpp
 	FidHandler.cpp
   IndexedMzMLDecoder.cpp
+	MappedFileHelper.cpp
 	MascotXMLHandler.cpp
 	MzDataHandler.cpp
 	MzIdentMLHandler.cpp
@@ -80,7 +80,8 @@ namespace OpenMS
     spectra_before_chroms_(source.spectra_before_chroms_),
     // do not copy the filestream itself but open a new filestream using the same file
     filestream_(source.filename_.c_str()),
-    parsing_success_(source.parsing_success_)
+    parsing_success_(source.parsing_success_),
+    skip_xml_checks_(source.skip_xml_checks_)
   {
   }
 
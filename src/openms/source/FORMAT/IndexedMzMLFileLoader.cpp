@@ -34,6 +34,20 @@
 
 #include <OpenMS/FORMAT/IndexedMzMLFileLoader.h>
 
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -59,4 +73,260 @@ namespace OpenMS
   {
       options_ = options;
   }
+
+  namespace
+  {
+    /// Position of a <spectrumList> or <chromatogramList> and its elements in the file
+    struct ElementList_
+    {
+      /// position of the opening list tag
+      Size open_tag;
+      /// position of the closing list tag
+      Size close_tag;
+      /// positions of the elements (from the index)
+      std::vector<Size> offsets;
+    };
+
+    /// Returns the position of the first occurrence of @p pattern in [@p begin, @p end) or @p end if there is none
+    Size findForward_(const char* data, Size begin, Size end, const std::string& pattern)
+    {
+      return std::search(data + begin, data + end, pattern.begin(), pattern.end()) - data;
+    }
+
+    /// Returns the position of the last occurrence of @p pattern in [@p begin, @p end) or @p end if there is none
+    Size findBackward_(const char* data, Size begin, Size end, const std::string& pattern)
+    {
+      return std::find_end(data + begin, data + end, pattern.begin(), pattern.end()) - data;
+    }
+
+    /**
+      @brief Locates the list @p tag (e.g. "spectrumList") in the file and checks the offsets of its elements
+
+      @return false if the offsets do not point to the elements of the list
+    */
+    bool locateList_(const char* data, Size size, const std::string& tag,
+                     const IndexedMzMLDecoder::OffsetVector& offsets, ElementList_& list)
+    {
+      list.offsets.clear();
+      if (offsets.empty()) return true;
+
+      // e.g. "<spectrum" for "spectrumList"
+      const std::string element = "<" + tag.substr(0, tag.size() - 4);
+      for (Size i = 0; i < offsets.size(); ++i)
+      {
+        std::streamoff offset = offsets[i].second;
+        if (offset < 0 || (Size)offset + element.size() >= size ||
+            (!list.offsets.empty() && (Size)offset <= list.offsets.back()) ||
+            element.compare(0, element.size(), data + offset, element.size()) != 0 ||
+            !std::isspace((unsigned char)data[offset + element.size()]))
+        {
+          return false;
+        }
+        list.offsets.push_back(offset);
+      }
+      list.open_tag = findBackward_(data, 0, list.offsets[0], "<" + tag);
+      list.close_tag = findForward_(data, list.offsets.back(), size, "</" + tag + ">");
+      return list.open_tag != list.offsets[0] && list.close_tag != size;
+    }
+
+    /// Returns the opening tag of @p list (with everything up to the first element) with its count attribute set to @p count
+    std::string openTag_(const char* data, const ElementList_& list, Size count)
+    {
+      std::string tag(data + list.open_tag, data + list.offsets[0]);
+      const std::string attribute = " count=\"";
+      Size value_begin = tag.find(attribute);
+      if (value_begin != std::string::npos && value_begin < tag.find('>'))
+      {
+        value_begin += attribute.size();
+        tag.replace(value_begin, tag.find('"', value_begin) - value_begin, String(count));
+      }
+      return tag;
+    }
+
+    /// Splits the elements of @p list into @p nr_chunks ranges of similar size in bytes
+    std::vector<Size> splitList_(const ElementList_& list, Size nr_chunks)
+    {
+      std::vector<Size> bounds(nr_chunks + 1, list.offsets.size());
+      bounds[0] = 0;
+      if (list.offsets.empty()) return bounds;
+      const double bytes_per_chunk = double(list.close_tag - list.offsets[0]) / nr_chunks;
+      Size element = 0;
+      for (Size chunk = 1; chunk < nr_chunks; ++chunk)
+      {
+        const double chunk_end = list.offsets[0] + chunk * bytes_per_chunk;
+        while (element < list.offsets.size() && list.offsets[element] < chunk_end)
+        {
+          ++element;
+        }
+        bounds[chunk] = element;
+      }
+      return bounds;
+    }
+
+    /// Appends the elements [@p first, @p last) of @p list (and its tags) to @p buffer
+    void appendList_(const char* data, const ElementList_& list, const std::string& tag,
+                     Size first, Size last, std::string& buffer)
+    {
+      if (list.offsets.empty()) return;
+      buffer += openTag_(data, list, last - first);
+      if (first < last)
+      {
+        const Size end = last < list.offsets.size() ? list.offsets[last] : list.close_tag;
+        buffer.append(data + list.offsets[first], data + end);
+      }
+      buffer += "</" + tag + ">\n";
+    }
+  }
+
+  bool IndexedMzMLFileLoader::load(const String& filename, PeakMap& exp)
+  {
+    // nothing to gain from the index if the spectra are not read
+    if (options_.getMetadataOnly() || options_.getSizeOnly())
+    {
+      MzMLFile f;
+      f.setOptions(options_);
+      f.load(filename, exp);
+      return true;
+    }
+
+    IndexedMzMLDecoder::OffsetVector spectra_offsets, chromatograms_offsets;
+    std::streampos index_offset = IndexedMzMLDecoder().findIndexListOffset(filename);
+    if (index_offset == (std::streampos)-1 ||
+        IndexedMzMLDecoder().parseOffsets(filename, index_offset, spectra_offsets, chromatograms_offsets) != 0)
+    {
+      return false;
+    }
+
+    boost::iostreams::mapped_file_source file;
+    try
+    {
+      file.open(filename);
+    }
+    catch (std::exception& e)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename,
+        String("Unable to map file into memory: ") + e.what());
+    }
+    const char* data = file.data();
+    const Size size = file.size();
+
+    ElementList_ spectra, chromatograms;
+    bool index_valid = locateList_(data, size, "spectrumList", spectra_offsets, spectra) &&
+                       locateList_(data, size, "chromatogramList", chromatograms_offsets, chromatograms) &&
+                       (spectra.offsets.empty() || chromatograms.offsets.empty() || spectra.close_tag < chromatograms.open_tag);
+    if (!index_valid)
+    {
+      // e.g. line endings were converted after the index was written
+      LOG_WARN << "The index of '" << filename << "' does not match the spectra and chromatograms in the file, reading it sequentially." << std::endl;
+    }
+    if (!index_valid || (spectra.offsets.empty() && chromatograms.offsets.empty()))
+    {
+      file.close();
+      MzMLFile f;
+      f.setOptions(options_);
+      f.load(filename, exp);
+      return true;
+    }
+
+    // Every chunk is parsed as a complete mzML document: the document header
+    // (everything in front of the first list, including the referenceable
+    // param groups, instrument configurations, data processing etc. the
+    // elements refer to) is followed by a contiguous range of spectra and a
+    // contiguous range of chromatograms and the closing tags. Creating an
+    // MzMLHandler is expensive (it loads the controlled vocabularies), so
+    // each thread parses exactly one chunk.
+    const std::string header(data, data + (spectra.offsets.empty() ? chromatograms.open_tag : spectra.open_tag));
+    std::string footer = "</run>\n</mzML>\n";
+    if (header.find("<indexedmzML") != std::string::npos)
+    {
+      footer += "</indexedmzML>\n";
+    }
+
+    Size nr_chunks = 1;
+#ifdef _OPENMP
+    nr_chunks = omp_get_max_threads();
+#endif
+    nr_chunks = std::max(Size(1), std::min(nr_chunks, std::max(spectra.offsets.size(), chromatograms.offsets.size())));
+    const std::vector<Size> spectra_bounds = splitList_(spectra, nr_chunks);
+    const std::vector<Size> chromatograms_bounds = splitList_(chromatograms, nr_chunks);
+
+    // every thread loads the controlled vocabularies through File::find,
+    // resolve the (lazily cached) data path while there is only one thread
+    File::getOpenMSDataPath();
+
+    std::vector<PeakMap> chunks(nr_chunks);
+    String error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)nr_chunks; ++i)
+    {
+      try
+      {
+        std::string buffer(header);
+        appendList_(data, spectra, "spectrumList", spectra_bounds[i], spectra_bounds[i + 1], buffer);
+        appendList_(data, chromatograms, "chromatogramList", chromatograms_bounds[i], chromatograms_bounds[i + 1], buffer);
+        buffer += footer;
+
+        MzMLFile f;
+        f.setOptions(options_);
+        f.loadBuffer(buffer, chunks[i]);
+      }
+      catch (Exception::BaseException& e)
+      {
+#ifdef _OPENMP
+#pragma omp critical (IndexedMzMLFileLoader_error)
+#endif
+        error = String(e.getName()) + ": " + e.getMessage();
+      }
+      catch (std::exception& e)
+      {
+#ifdef _OPENMP
+#pragma omp critical (IndexedMzMLFileLoader_error)
+#endif
+        error = e.what();
+      }
+    }
+    file.close();
+    if (!error.empty())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, error);
+    }
+
+    // merge the chunks in the order of the file, the meta data of the
+    // experiment is identical in all chunks. The spectra and chromatograms
+    // are swapped into place, so their peaks are never copied.
+    exp.swap(chunks[0]);
+    std::vector<MSSpectrum<Peak1D> >& spectra_out = exp.getSpectra();
+    std::vector<MSChromatogram<ChromatogramPeak> >& chromatograms_out = exp.getChromatograms();
+    Size nr_spectra = spectra_out.size(), nr_chromatograms = chromatograms_out.size();
+    for (Size i = 1; i < nr_chunks; ++i)
+    {
+      nr_spectra += chunks[i].size();
+      nr_chromatograms += chunks[i].getChromatograms().size();
+    }
+    spectra_out.reserve(nr_spectra);
+    chromatograms_out.reserve(nr_chromatograms);
+    for (Size i = 1; i < nr_chunks; ++i)
+    {
+      std::vector<MSSpectrum<Peak1D> >& spectra_in = chunks[i].getSpectra();
+      for (Size j = 0; j < spectra_in.size(); ++j)
+      {
+        spectra_out.push_back(MSSpectrum<Peak1D>());
+        spectra_out.back().swap(spectra_in[j]);
+      }
+      std::vector<MSChromatogram<ChromatogramPeak> >& chromatograms_in = chunks[i].getChromatograms();
+      for (Size j = 0; j < chromatograms_in.size(); ++j)
+      {
+        chromatograms_out.push_back(MSChromatogram<ChromatogramPeak>());
+        chromatograms_out.back().swap(chromatograms_in[j]);
+      }
+      // free the (now empty) chunk right away
+      PeakMap().swap(chunks[i]);
+    }
+    exp.setLoadedFileType(filename);
+    exp.setLoadedFilePath(filename);
+    return true;
+  }
+
 }
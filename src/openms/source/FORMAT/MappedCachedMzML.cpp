@@ -0,0 +1,305 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/MappedCachedMzML.h>
+
+#include <OpenMS/FORMAT/HANDLERS/MappedFileHelper.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <fstream>
+#include <cstring>
+
+namespace OpenMS
+{
+  const UInt64 MappedCachedmzML::FILE_IDENTIFIER = 0x324843414D4D534FULL; // "OSMMACH2"
+  const UInt32 MappedCachedmzML::FILE_VERSION = 1;
+  const Size MappedCachedmzML::HEADER_SIZE = Internal::MappedFileHelper::HEADER_SIZE;
+  const Size MappedCachedmzML::DATA_ALIGNMENT = Internal::MappedFileHelper::DATA_ALIGNMENT;
+
+  namespace
+  {
+    /// Header stored at the beginning of the file
+    struct Header
+    {
+      UInt64 file_identifier;
+      UInt32 file_version;
+      UInt32 reserved;
+    };
+
+    /// Trailer stored at the end of the file (in front of the file identifier)
+    struct Trailer
+    {
+      UInt64 index_offset;
+      UInt64 nr_spectra;
+      UInt64 nr_chromatograms;
+    };
+
+    template <typename ContainerT>
+    void writeItem_(const ContainerT& container, std::ofstream& ofs, UInt64& pos,
+                    MappedCachedmzML::IndexEntry& entry, std::vector<double>& buffer)
+    {
+      Internal::MappedFileHelper::pad(ofs, pos, MappedCachedmzML::DATA_ALIGNMENT);
+      entry.offset = pos;
+      entry.size = container.size();
+      if (container.empty()) return;
+
+      buffer.resize(container.size());
+      for (Size j = 0; j < container.size(); ++j)
+      {
+        buffer[j] = container[j].getPos();
+      }
+      ofs.write((const char*)&buffer[0], buffer.size() * sizeof(double));
+      for (Size j = 0; j < container.size(); ++j)
+      {
+        buffer[j] = container[j].getIntensity();
+      }
+      ofs.write((const char*)&buffer[0], buffer.size() * sizeof(double));
+      pos += 2 * buffer.size() * sizeof(double);
+    }
+  }
+
+  MappedCachedmzML::MappedCachedmzML(const String& filename) :
+    filename_(filename),
+    data_(0),
+    spectra_index_(0),
+    chrom_index_(0),
+    nr_spectra_(0),
+    nr_chromatograms_(0)
+  {
+    Internal::MappedFileHelper::mapFile(file_, filename);
+    data_ = file_.data();
+    const Size file_size = file_.size();
+
+    // check the header
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    if (file_size >= sizeof(Header))
+    {
+      std::memcpy(&header, data_, sizeof(Header));
+    }
+    if (header.file_identifier != FILE_IDENTIFIER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, "File is not a memory-mapped cached mzML file (wrong file identifier). Aborting!");
+    }
+    Trailer trailer;
+    if (!Internal::MappedFileHelper::readTrailer(file_, FILE_IDENTIFIER, &trailer, sizeof(Trailer)))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, "File is truncated (no index found). Aborting!");
+    }
+    if (header.file_version != FILE_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, String("Unsupported file format version ") + header.file_version + " (expected " + FILE_VERSION + ").");
+    }
+
+    // check the index; all sizes are compared by subtraction and division,
+    // so that corrupt values from the trailer cannot overflow the checks
+    const UInt64 data_end = file_size - sizeof(Trailer) - sizeof(UInt64);
+    const UInt64 max_entries = data_end / sizeof(IndexEntry);
+    if (trailer.index_offset < HEADER_SIZE ||
+        trailer.index_offset % DATA_ALIGNMENT != 0 ||
+        trailer.index_offset > data_end ||
+        trailer.nr_spectra > max_entries ||
+        trailer.nr_chromatograms > max_entries - trailer.nr_spectra ||
+        (data_end - trailer.index_offset) / sizeof(IndexEntry) != trailer.nr_spectra + trailer.nr_chromatograms ||
+        (data_end - trailer.index_offset) % sizeof(IndexEntry) != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        filename, "File is truncated or the index is corrupt. Aborting!");
+    }
+    nr_spectra_ = trailer.nr_spectra;
+    nr_chromatograms_ = trailer.nr_chromatograms;
+    spectra_index_ = reinterpret_cast<const IndexEntry*>(data_ + trailer.index_offset);
+    chrom_index_ = spectra_index_ + nr_spectra_;
+
+    // make sure that every data item lies within the data section, so that
+    // the access functions do not need to check anything
+    for (Size i = 0; i < nr_spectra_ + nr_chromatograms_; ++i)
+    {
+      const IndexEntry& entry = spectra_index_[i];
+      if (entry.offset < HEADER_SIZE || entry.offset % sizeof(double) != 0 ||
+          entry.offset > trailer.index_offset ||
+          entry.size > (trailer.index_offset - entry.offset) / (2 * sizeof(double)))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          filename, String("Invalid index entry ") + i + " found. Aborting!");
+      }
+    }
+  }
+
+  MappedCachedmzML::~MappedCachedmzML()
+  {
+    if (file_.is_open())
+    {
+      file_.close();
+    }
+  }
+
+  void MappedCachedmzML::store(const String& filename, const MapType& exp)
+  {
+    // header
+    Header header;
+    header.file_identifier = FILE_IDENTIFIER;
+    header.file_version = FILE_VERSION;
+    header.reserved = 0;
+    std::ofstream ofs;
+    UInt64 pos = 0;
+    Internal::MappedFileHelper::writeHeader(ofs, pos, filename, &header, sizeof(Header));
+
+    // data section
+    const std::vector<MSChromatogram<ChromatogramPeak> >& chromatograms = exp.getChromatograms();
+    std::vector<IndexEntry> index(exp.size() + chromatograms.size());
+    std::vector<double> buffer;
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      writeItem_(exp[i], ofs, pos, index[i], buffer);
+      index[i].rt = exp[i].getRT();
+      index[i].ms_level = exp[i].getMSLevel();
+    }
+    for (Size i = 0; i < chromatograms.size(); ++i)
+    {
+      IndexEntry& entry = index[exp.size() + i];
+      writeItem_(chromatograms[i], ofs, pos, entry, buffer);
+      entry.rt = 0.0;
+      entry.ms_level = 0;
+    }
+
+    // index and trailer
+    Internal::MappedFileHelper::pad(ofs, pos, DATA_ALIGNMENT);
+    Trailer trailer;
+    trailer.index_offset = pos;
+    trailer.nr_spectra = exp.size();
+    trailer.nr_chromatograms = chromatograms.size();
+    if (!index.empty())
+    {
+      ofs.write((const char*)&index[0], index.size() * sizeof(IndexEntry));
+    }
+    Internal::MappedFileHelper::writeTrailer(ofs, filename, FILE_IDENTIFIER, &trailer, sizeof(Trailer));
+  }
+
+  bool MappedCachedmzML::isMappedCache(const String& filename)
+  {
+    UInt64 identifier = 0;
+    return Internal::MappedFileHelper::readHeader(filename, &identifier, sizeof(identifier)) &&
+           identifier == FILE_IDENTIFIER;
+  }
+
+  Size MappedCachedmzML::getNrSpectra() const
+  {
+    return nr_spectra_;
+  }
+
+  Size MappedCachedmzML::getNrChromatograms() const
+  {
+    return nr_chromatograms_;
+  }
+
+  MappedCachedmzML::SpectrumView MappedCachedmzML::getSpectrumView(Size id) const
+  {
+    OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    const IndexEntry& entry = spectra_index_[id];
+    SpectrumView view;
+    view.mz = reinterpret_cast<const double*>(data_ + entry.offset);
+    view.intensity = view.mz + entry.size;
+    view.size = entry.size;
+    view.rt = entry.rt;
+    view.ms_level = (int)entry.ms_level;
+    return view;
+  }
+
+  MappedCachedmzML::ChromatogramView MappedCachedmzML::getChromatogramView(Size id) const
+  {
+    OPENMS_PRECONDITION(id < getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+
+    const IndexEntry& entry = chrom_index_[id];
+    ChromatogramView view;
+    view.rt = reinterpret_cast<const double*>(data_ + entry.offset);
+    view.intensity = view.rt + entry.size;
+    view.size = entry.size;
+    return view;
+  }
+
+  void MappedCachedmzML::load(MapType& exp) const
+  {
+    // take over the existing chromatograms (swap, no copy) so that their
+    // memory can be reused
+    std::vector<MSChromatogram<ChromatogramPeak> > chromatograms;
+    chromatograms.swap(exp.getChromatograms());
+    if (exp.size() != nr_spectra_ || chromatograms.size() != nr_chromatograms_)
+    {
+      exp.clear(true);
+      exp.resize(nr_spectra_);
+      chromatograms.clear();
+      chromatograms.resize(nr_chromatograms_);
+    }
+
+    for (Size i = 0; i < nr_spectra_; ++i)
+    {
+      SpectrumView view = getSpectrumView(i);
+      MSSpectrum<Peak1D>& spectrum = exp[i];
+      spectrum.clear(false);
+      spectrum.setRT(view.rt);
+      spectrum.setMSLevel(view.ms_level);
+      spectrum.resize(view.size);
+      for (Size j = 0; j < view.size; ++j)
+      {
+        spectrum[j].setMZ(view.mz[j]);
+        spectrum[j].setIntensity(view.intensity[j]);
+      }
+    }
+
+    for (Size i = 0; i < nr_chromatograms_; ++i)
+    {
+      ChromatogramView view = getChromatogramView(i);
+      MSChromatogram<ChromatogramPeak>& chromatogram = chromatograms[i];
+      chromatogram.clear(false);
+      chromatogram.resize(view.size);
+      for (Size j = 0; j < view.size; ++j)
+      {
+        chromatogram[j].setRT(view.rt[j]);
+        chromatogram[j].setIntensity(view.intensity[j]);
+      }
+    }
+    exp.getChromatograms().swap(chromatograms);
+  }
+
+  const String& MappedCachedmzML::getFilename() const
+  {
+    return filename_;
+  }
+
+} // namespace OpenMS
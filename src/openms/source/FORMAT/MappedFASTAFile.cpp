@@ -0,0 +1,245 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
+
+#include <OpenMS/SYSTEM/File.h>
+
+#include <cstring>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// whitespace as removed by String::trim() and String::removeWhitespaces()
+    inline bool isWhitespace(char c)
+    {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // MappedFASTAFile::EntryView
+  // ---------------------------------------------------------------------------
+
+  void MappedFASTAFile::EntryView::getSequence(String& sequence) const
+  {
+    sequence.clear();
+    sequence.reserve(raw_sequence.size());
+    const char* it = raw_sequence.data();
+    const char* end = it + raw_sequence.size();
+    for (; it != end; ++it)
+    {
+      if (!isWhitespace(*it)) sequence.push_back(*it);
+    }
+  }
+
+  void MappedFASTAFile::EntryView::getEntry(FASTAFile::FASTAEntry& entry) const
+  {
+    entry.identifier.assign(identifier.data(), identifier.size());
+    entry.description.assign(description.data(), description.size());
+    getSequence(entry.sequence);
+  }
+
+  // ---------------------------------------------------------------------------
+  // MappedFASTAFile::Reader
+  // ---------------------------------------------------------------------------
+
+  MappedFASTAFile::Reader::Reader(const MappedFASTAFile& file) :
+    file_(&file),
+    position_(file.begin_)
+  {
+  }
+
+  bool MappedFASTAFile::Reader::next(EntryView& entry)
+  {
+    if (position_ >= file_->size_) return false;
+    position_ = file_->parseEntry_(position_, entry);
+    return true;
+  }
+
+  // ---------------------------------------------------------------------------
+  // MappedFASTAFile
+  // ---------------------------------------------------------------------------
+
+  MappedFASTAFile::MappedFASTAFile(const String& filename, bool build_index) :
+    filename_(filename),
+    data_(0),
+    size_(0),
+    begin_(0),
+    has_index_(build_index)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    if (!File::readable(filename))
+    {
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    // empty files cannot be mapped, but are valid (no entries)
+    if (!File::empty(filename))
+    {
+      try
+      {
+        file_.open(filename);
+      }
+      catch (std::exception& e)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          String("Unable to map file into memory: ") + e.what(), filename);
+      }
+      data_ = file_.data();
+      size_ = file_.size();
+    }
+
+    // skip leading whitespace, then an entry must start
+    while (begin_ < size_ && isWhitespace(data_[begin_]))
+    {
+      ++begin_;
+    }
+    if (begin_ < size_ && data_[begin_] != '>')
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Error while parsing FASTA file! The first entry could not be read! Please check the file!", filename);
+    }
+
+    if (build_index)
+    {
+      for (Size position = begin_; position < size_; position = nextEntry_(position + 1))
+      {
+        offsets_.push_back(position);
+      }
+    }
+  }
+
+  MappedFASTAFile::~MappedFASTAFile()
+  {
+    if (file_.is_open())
+    {
+      file_.close();
+    }
+  }
+
+  const String& MappedFASTAFile::getFilename() const
+  {
+    return filename_;
+  }
+
+  Size MappedFASTAFile::getFileSize() const
+  {
+    return size_;
+  }
+
+  Size MappedFASTAFile::nextEntry_(Size position) const
+  {
+    if (position <= begin_) return begin_;
+
+    // an entry starts with '>' at the beginning of a line
+    const char* end = data_ + size_;
+    const char* it = data_ + position - 1;
+    while (it < end)
+    {
+      it = static_cast<const char*>(std::memchr(it, '\n', end - it));
+      if (it == 0) break;
+      ++it;
+      if (it < end && *it == '>') return it - data_;
+    }
+    return size_;
+  }
+
+  Size MappedFASTAFile::parseEntry_(Size position, EntryView& entry) const
+  {
+    const char* end = data_ + size_;
+
+    // header line (without '>'), trimmed like in FASTAFile::load
+    const char* header_begin = data_ + position + 1;
+    const char* header_end = static_cast<const char*>(std::memchr(header_begin, '\n', end - header_begin));
+    if (header_end == 0) header_end = end;
+    const char* sequence_begin = (header_end == end) ? end : header_end + 1;
+    while (header_begin < header_end && isWhitespace(*header_begin)) ++header_begin;
+    while (header_end > header_begin && isWhitespace(*(header_end - 1))) --header_end;
+
+    // identifier ends at the first whitespace, the rest is the description
+    const char* id_end = header_begin;
+    while (id_end < header_end && *id_end != ' ' && *id_end != '\v' && *id_end != '\t') ++id_end;
+    entry.identifier = StringView(header_begin, id_end - header_begin);
+    if (id_end < header_end)
+    {
+      entry.description = StringView(id_end + 1, header_end - id_end - 1);
+    }
+    else
+    {
+      entry.description = StringView();
+    }
+
+    // the sequence lasts until the next entry
+    Size next = nextEntry_(sequence_begin - data_);
+    entry.raw_sequence = StringView(sequence_begin, data_ + next - sequence_begin);
+    return next;
+  }
+
+  bool MappedFASTAFile::hasIndex() const
+  {
+    return has_index_;
+  }
+
+  Size MappedFASTAFile::size() const
+  {
+    if (!has_index_)
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The FASTA file was not indexed.");
+    }
+    return offsets_.size();
+  }
+
+  Size MappedFASTAFile::getEntryOffset(Size index) const
+  {
+    if (index >= size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, offsets_.size());
+    }
+    return offsets_[index];
+  }
+
+  MappedFASTAFile::EntryView MappedFASTAFile::getEntryView(Size index) const
+  {
+    EntryView entry;
+    parseEntry_(getEntryOffset(index), entry);
+    return entry;
+  }
+
+} // namespace OpenMS
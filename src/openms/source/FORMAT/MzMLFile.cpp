@@ -132,13 +132,10 @@ namespace OpenMS
     options_.setSizeOnly(size_only_before_);
   }
 
-  void MzMLFile::safeParse_(const String& filename, Internal::XMLHandler* handler)
+  namespace
   {
-    try
-    {
-      parse_(filename, handler);
-    }
-    catch (Exception::BaseException& e)
+    /// Converts any error during parsing into an Exception::ParseError that names the original error
+    void throwParseError_(const Exception::BaseException& e)
     {
       std::string expr;
       expr.append(e.getFile());
@@ -154,6 +151,30 @@ namespace OpenMS
     }
   }
 
+  void MzMLFile::safeParse_(const String& filename, Internal::XMLHandler* handler)
+  {
+    try
+    {
+      parse_(filename, handler);
+    }
+    catch (Exception::BaseException& e)
+    {
+      throwParseError_(e);
+    }
+  }
+
+  void MzMLFile::safeParseBuffer_(const std::string& buffer, Internal::XMLHandler* handler)
+  {
+    try
+    {
+      parseBuffer_(buffer, handler);
+    }
+    catch (Exception::BaseException& e)
+    {
+      throwParseError_(e);
+    }
+  }
+
   void MzMLFile::load(const String& filename, PeakMap& map)
   {
     map.reset();
@@ -167,6 +188,15 @@ namespace OpenMS
     safeParse_(filename, &handler);
   }
 
+  void MzMLFile::loadBuffer(const std::string& buffer, PeakMap& map)
+  {
+    map.reset();
+
+    Internal::MzMLHandler handler(map, "memory", getVersion(), *this);
+    handler.setOptions(options_);
+    safeParseBuffer_(buffer, &handler);
+  }
+
   void MzMLFile::store(const String& filename, const PeakMap& map) const
   {
     Internal::MzMLHandler handler(map, filename, getVersion(), *this);
@@ -46,6 +46,7 @@
 #include <xercesc/framework/XMLFormatter.hpp>
 #include <xercesc/sax2/SAX2XMLReader.hpp>
 #include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/sax2/XMLReaderFactory.hpp>
 
 #include <fstream>
@@ -81,6 +82,64 @@ private:
       XMLHandler * p_;
     };
 
+    namespace
+    {
+      /// Initializes the Xerces platform (may be called concurrently from several threads)
+      void initializeXerces_()
+      {
+        // exceptions must not leave the critical section
+        String error;
+#ifdef _OPENMP
+#pragma omp critical (XMLFile_initialize)
+#endif
+        {
+          try
+          {
+            xercesc::XMLPlatformUtils::Initialize();
+          }
+          catch (const xercesc::XMLException & toCatch)
+          {
+            error = String("Error during initialization: ") + StringManager().convert(toCatch.getMessage());
+          }
+        }
+        if (!error.empty())
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", error);
+        }
+      }
+
+      /// Parses the XML input given by @p source using the SAX handler given by @p handler
+      void parseSource_(xercesc::InputSource & source, XMLHandler * handler)
+      {
+        boost::shared_ptr< xercesc::SAX2XMLReader > parser(xercesc::XMLReaderFactory::createXMLReader());
+        parser->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, false);
+        parser->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpacePrefixes, false);
+
+        parser->setContentHandler(handler);
+        parser->setErrorHandler(handler);
+
+        try
+        {
+          parser->parse(source);
+        }
+        catch (const xercesc::XMLException & toCatch)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", 
+              String("XMLException: ") + StringManager().convert(toCatch.getMessage()));
+        }
+        catch (const xercesc::SAXException & toCatch)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "",
+              String("SAXException: ") + StringManager().convert(toCatch.getMessage()));
+        }
+        catch (const XMLHandler::EndParsingSoftly & /*toCatch*/)
+        {
+          // nothing to do here, as this exception is used to softly abort the
+          // parsing for whatever reason.
+        }
+      }
+    }
+
     XMLFile::XMLFile()
     {
     }
@@ -113,23 +172,7 @@ private:
       }
 
       // initialize parser
-      try
-      {
-        xercesc::XMLPlatformUtils::Initialize();
-      }
-      catch (const xercesc::XMLException & toCatch)
-      {
-        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-            "", String("Error during initialization: ") + StringManager().convert(toCatch.getMessage()));
-      }
-
-
-      boost::shared_ptr< xercesc::SAX2XMLReader > parser(xercesc::XMLReaderFactory::createXMLReader());
-      parser->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, false);
-      parser->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpacePrefixes, false);
-
-      parser->setContentHandler(handler);
-      parser->setErrorHandler(handler);
+      initializeXerces_();
 
       //is it bzip2 or gzip compressed?
       std::ifstream file(filename.c_str());
@@ -162,30 +205,19 @@ private:
         source->setEncoding(s_enc);
       }
       // try to parse file
-      try
-      {
-        parser->parse(*source);
-      }
-      catch (const xercesc::XMLException & toCatch)
-      {
-        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", 
-            String("XMLException: ") + StringManager().convert(toCatch.getMessage()));
-      }
-      catch (const xercesc::SAXException & toCatch)
-      {
-        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "",
-            String("SAXException: ") + StringManager().convert(toCatch.getMessage()));
-      }
-      catch (const XMLHandler::EndParsingSoftly & /*toCatch*/)
-      {
-        // nothing to do here, as this exception is used to softly abort the
-        // parsing for whatever reason.
-      }
-      catch (...)
-      {
-        // re-throw
-        throw;
-      }
+      parseSource_(*source, handler);
+    }
+
+    void XMLFile::parseBuffer_(const std::string & buffer, XMLHandler * handler)
+    {
+      // ensure handler->reset() is called to save memory
+      XMLCleaner_ clean(handler);
+
+      initializeXerces_();
+
+      const XMLByte* xml_buffer = reinterpret_cast<const XMLByte*>(buffer.c_str());
+      xercesc::MemBufInputSource source(xml_buffer, buffer.size(), "memory_buffer");
+      parseSource_(source, handler);
     }
 
     void XMLFile::save_(const String & filename, XMLHandler * handler) const
@@ -7,6 +7,7 @@ Base64.cpp
 Bzip2Ifstream.cpp
 Bzip2InputStream.cpp
 CachedMzML.cpp
+ColumnarFeatureFile.cpp
 CompressedInputSource.cpp
 CVMappingFile.cpp
 ConsensusXMLFile.cpp
@@ -34,6 +35,8 @@ LibSVMEncoder.cpp
 MS2File.cpp
 MSNumpressCoder.cpp
 MSPFile.cpp
+MappedCachedMzML.cpp
+MappedFASTAFile.cpp
 MascotInfile.cpp
 MascotGenericFile.cpp
 MascotRemoteQuery.cpp
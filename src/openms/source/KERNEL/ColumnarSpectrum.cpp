@@ -0,0 +1,436 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// Returns @p sptr after checking that it points to a spectrum
+    const OpenSwath::SpectrumPtr& checkSpectrumPtr_(const OpenSwath::SpectrumPtr& sptr)
+    {
+      if (!sptr)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Null pointer given instead of a spectrum");
+      }
+      return sptr;
+    }
+  }
+
+  ColumnarSpectrum::ColumnarSpectrum() :
+    RangeManager<1>(),
+    SpectrumSettings(),
+    mz_array_(new OpenSwath::BinaryDataArray),
+    intensity_array_(new OpenSwath::BinaryDataArray),
+    retention_time_(-1),
+    drift_time_(-1),
+    ms_level_(1),
+    name_(),
+    float_data_arrays_(),
+    string_data_arrays_(),
+    integer_data_arrays_()
+  {
+  }
+
+  ColumnarSpectrum::ColumnarSpectrum(const ColumnarSpectrum& source) :
+    RangeManager<1>(source),
+    SpectrumSettings(source),
+    mz_array_(new OpenSwath::BinaryDataArray(*source.mz_array_)),
+    intensity_array_(new OpenSwath::BinaryDataArray(*source.intensity_array_)),
+    retention_time_(source.retention_time_),
+    drift_time_(source.drift_time_),
+    ms_level_(source.ms_level_),
+    name_(source.name_),
+    float_data_arrays_(source.float_data_arrays_),
+    string_data_arrays_(source.string_data_arrays_),
+    integer_data_arrays_(source.integer_data_arrays_)
+  {
+  }
+
+  ColumnarSpectrum::ColumnarSpectrum(const MSSpectrum<Peak1D>& spectrum) :
+    RangeManager<1>(spectrum),
+    SpectrumSettings(spectrum),
+    mz_array_(new OpenSwath::BinaryDataArray),
+    intensity_array_(new OpenSwath::BinaryDataArray),
+    retention_time_(spectrum.getRT()),
+    drift_time_(spectrum.getDriftTime()),
+    ms_level_(spectrum.getMSLevel()),
+    name_(spectrum.getName()),
+    float_data_arrays_(spectrum.getFloatDataArrays()),
+    string_data_arrays_(spectrum.getStringDataArrays()),
+    integer_data_arrays_(spectrum.getIntegerDataArrays())
+  {
+    std::vector<double>& mz = mz_array_->data;
+    std::vector<double>& intensity = intensity_array_->data;
+    mz.resize(spectrum.size());
+    intensity.resize(spectrum.size());
+    for (Size i = 0; i < spectrum.size(); ++i)
+    {
+      mz[i] = spectrum[i].getMZ();
+      intensity[i] = spectrum[i].getIntensity();
+    }
+  }
+
+  ColumnarSpectrum::ColumnarSpectrum(const OpenSwath::SpectrumPtr& sptr) :
+    RangeManager<1>(),
+    SpectrumSettings(),
+    mz_array_(checkSpectrumPtr_(sptr)->getMZArray()),
+    intensity_array_(sptr->getIntensityArray()),
+    retention_time_(-1),
+    drift_time_(-1),
+    ms_level_(1),
+    name_(),
+    float_data_arrays_(),
+    string_data_arrays_(),
+    integer_data_arrays_()
+  {
+    if (!mz_array_) mz_array_ = OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray);
+    if (!intensity_array_) intensity_array_ = OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray);
+    if (mz_array_->data.size() != intensity_array_->data.size())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "m/z and intensity arrays of the spectrum differ in length");
+    }
+  }
+
+  ColumnarSpectrum::~ColumnarSpectrum()
+  {
+  }
+
+  ColumnarSpectrum& ColumnarSpectrum::operator=(const ColumnarSpectrum& source)
+  {
+    if (&source == this) return *this;
+
+    RangeManager<1>::operator=(source);
+    SpectrumSettings::operator=(source);
+
+    // do not write into arrays that may be shared with OpenSwath spectra
+    mz_array_ = OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray(*source.mz_array_));
+    intensity_array_ = OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray(*source.intensity_array_));
+    retention_time_ = source.retention_time_;
+    drift_time_ = source.drift_time_;
+    ms_level_ = source.ms_level_;
+    name_ = source.name_;
+    float_data_arrays_ = source.float_data_arrays_;
+    string_data_arrays_ = source.string_data_arrays_;
+    integer_data_arrays_ = source.integer_data_arrays_;
+
+    return *this;
+  }
+
+  bool ColumnarSpectrum::operator==(const ColumnarSpectrum& rhs) const
+  {
+    //name_ can differ => it is not checked
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wfloat-equal"
+    return mz_array_->data == rhs.mz_array_->data &&
+           intensity_array_->data == rhs.intensity_array_->data &&
+           RangeManager<1>::operator==(rhs) &&
+           SpectrumSettings::operator==(rhs) &&
+           retention_time_ == rhs.retention_time_ &&
+           drift_time_ == rhs.drift_time_ &&
+           ms_level_ == rhs.ms_level_ &&
+           float_data_arrays_ == rhs.float_data_arrays_ &&
+           string_data_arrays_ == rhs.string_data_arrays_ &&
+           integer_data_arrays_ == rhs.integer_data_arrays_;
+#pragma clang diagnostic pop
+  }
+
+  bool ColumnarSpectrum::operator!=(const ColumnarSpectrum& rhs) const
+  {
+    return !(operator==(rhs));
+  }
+
+  void ColumnarSpectrum::updateRanges()
+  {
+    this->clearRanges();
+    if (empty()) return;
+
+    const std::vector<double>& mz = mz_array_->data;
+    const std::vector<double>& intensity = intensity_array_->data;
+    double mz_min = mz[0], mz_max = mz[0];
+    double int_min = intensity[0], int_max = intensity[0];
+    for (Size i = 1; i < mz.size(); ++i)
+    {
+      if (mz[i] < mz_min) mz_min = mz[i];
+      if (mz[i] > mz_max) mz_max = mz[i];
+      if (intensity[i] < int_min) int_min = intensity[i];
+      if (intensity[i] > int_max) int_max = intensity[i];
+    }
+    pos_range_.setMinX(mz_min);
+    pos_range_.setMaxX(mz_max);
+    int_range_.setMinX(int_min);
+    int_range_.setMaxX(int_max);
+  }
+
+  void ColumnarSpectrum::toMSSpectrum(MSSpectrum<Peak1D>& spectrum) const
+  {
+    spectrum.clear(true);
+    spectrum.SpectrumSettings::operator=(*this);
+    spectrum.setRT(retention_time_);
+    spectrum.setDriftTime(drift_time_);
+    spectrum.setMSLevel(ms_level_);
+    spectrum.setName(name_);
+    spectrum.setFloatDataArrays(float_data_arrays_);
+    spectrum.setStringDataArrays(string_data_arrays_);
+    spectrum.setIntegerDataArrays(integer_data_arrays_);
+
+    const std::vector<double>& mz = mz_array_->data;
+    const std::vector<double>& intensity = intensity_array_->data;
+    spectrum.resize(mz.size());
+    for (Size i = 0; i < mz.size(); ++i)
+    {
+      spectrum[i].setMZ(mz[i]);
+      spectrum[i].setIntensity(intensity[i]);
+    }
+    spectrum.updateRanges();
+  }
+
+  OpenSwath::SpectrumPtr ColumnarSpectrum::getSpectrumPtr() const
+  {
+    OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+    sptr->setMZArray(mz_array_);
+    sptr->setIntensityArray(intensity_array_);
+    return sptr;
+  }
+
+  void ColumnarSpectrum::fromExperiment(const MSExperiment& exp, std::vector<ColumnarSpectrum>& spectra)
+  {
+    spectra.clear();
+    spectra.reserve(exp.size());
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      spectra.push_back(ColumnarSpectrum(exp[i]));
+    }
+  }
+
+  void ColumnarSpectrum::toExperiment(const std::vector<ColumnarSpectrum>& spectra, MSExperiment& exp)
+  {
+    exp.clear(false);
+    exp.resize(spectra.size());
+    for (Size i = 0; i < spectra.size(); ++i)
+    {
+      spectra[i].toMSSpectrum(exp[i]);
+    }
+    exp.updateRanges();
+  }
+
+  void ColumnarSpectrum::reserve(Size n)
+  {
+    mz_array_->data.reserve(n);
+    intensity_array_->data.reserve(n);
+  }
+
+  void ColumnarSpectrum::resize(Size n)
+  {
+    mz_array_->data.resize(n, 0.0);
+    intensity_array_->data.resize(n, 0.0);
+  }
+
+  void ColumnarSpectrum::push_back(CoordinateType mz, IntensityType intensity)
+  {
+    mz_array_->data.push_back(mz);
+    intensity_array_->data.push_back(intensity);
+  }
+
+  void ColumnarSpectrum::push_back(const Peak1D& peak)
+  {
+    push_back(peak.getMZ(), peak.getIntensity());
+  }
+
+  void ColumnarSpectrum::sortByPosition()
+  {
+    if (isSorted()) return;
+
+    const std::vector<double>& mz = mz_array_->data;
+    std::vector<std::pair<double, Size> > sorted_indices;
+    sorted_indices.reserve(mz.size());
+    for (Size i = 0; i < mz.size(); ++i)
+    {
+      sorted_indices.push_back(std::make_pair(mz[i], i));
+    }
+    std::stable_sort(sorted_indices.begin(), sorted_indices.end(), PairComparatorFirstElement<std::pair<double, Size> >());
+
+    std::vector<Size> select_indices;
+    select_indices.reserve(sorted_indices.size());
+    for (Size i = 0; i < sorted_indices.size(); ++i)
+    {
+      select_indices.push_back(sorted_indices[i].second);
+    }
+    select(select_indices);
+  }
+
+  bool ColumnarSpectrum::isSorted() const
+  {
+    const std::vector<double>& mz = mz_array_->data;
+    for (Size i = 1; i < mz.size(); ++i)
+    {
+      if (mz[i - 1] > mz[i]) return false;
+    }
+    return true;
+  }
+
+  Size ColumnarSpectrum::findNearest(CoordinateType mz) const
+  {
+    // no peak => no search
+    if (empty()) throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There must be at least one peak to determine the nearest peak!");
+
+    const std::vector<double>& data = mz_array_->data;
+    std::vector<double>::const_iterator it = std::lower_bound(data.begin(), data.end(), mz);
+    // border cases
+    if (it == data.begin()) return 0;
+    if (it == data.end()) return data.size() - 1;
+
+    // the peak before or the current peak are closest
+    std::vector<double>::const_iterator it2 = it - 1;
+    if (std::fabs(*it - mz) < std::fabs(*it2 - mz))
+    {
+      return Size(it - data.begin());
+    }
+    else
+    {
+      return Size(it2 - data.begin());
+    }
+  }
+
+  Int ColumnarSpectrum::findNearest(CoordinateType mz, CoordinateType tolerance) const
+  {
+    if (empty()) return -1;
+    Size i = findNearest(mz);
+    const double found_mz = mz_array_->data[i];
+    if (found_mz >= mz - tolerance && found_mz <= mz + tolerance)
+    {
+      return static_cast<Int>(i);
+    }
+    return -1;
+  }
+
+  ColumnarSpectrum::ConstIterator ColumnarSpectrum::MZBegin(CoordinateType mz) const
+  {
+    const std::vector<double>& data = mz_array_->data;
+    return begin() + (std::lower_bound(data.begin(), data.end(), mz) - data.begin());
+  }
+
+  ColumnarSpectrum::ConstIterator ColumnarSpectrum::MZEnd(CoordinateType mz) const
+  {
+    const std::vector<double>& data = mz_array_->data;
+    return begin() + (std::upper_bound(data.begin(), data.end(), mz) - data.begin());
+  }
+
+  ColumnarSpectrum::Iterator ColumnarSpectrum::MZBegin(CoordinateType mz)
+  {
+    const std::vector<double>& data = mz_array_->data;
+    return begin() + (std::lower_bound(data.begin(), data.end(), mz) - data.begin());
+  }
+
+  ColumnarSpectrum::Iterator ColumnarSpectrum::MZEnd(CoordinateType mz)
+  {
+    const std::vector<double>& data = mz_array_->data;
+    return begin() + (std::upper_bound(data.begin(), data.end(), mz) - data.begin());
+  }
+
+  void ColumnarSpectrum::clear(bool clear_meta_data)
+  {
+    mz_array_->data.clear();
+    intensity_array_->data.clear();
+
+    if (clear_meta_data)
+    {
+      clearRanges();
+      this->SpectrumSettings::operator=(SpectrumSettings()); // no "clear" method
+      retention_time_ = -1.0;
+      drift_time_ = -1.0;
+      ms_level_ = 1;
+      name_.clear();
+      float_data_arrays_.clear();
+      string_data_arrays_.clear();
+      integer_data_arrays_.clear();
+    }
+  }
+
+  ColumnarSpectrum& ColumnarSpectrum::select(const std::vector<Size>& indices)
+  {
+    Size snew = indices.size();
+    std::vector<double> mz_tmp, int_tmp;
+    mz_tmp.reserve(snew);
+    int_tmp.reserve(snew);
+    for (Size i = 0; i < snew; ++i)
+    {
+      mz_tmp.push_back(mz_array_->data[indices[i]]);
+      int_tmp.push_back(intensity_array_->data[indices[i]]);
+    }
+    mz_array_->data.swap(mz_tmp);
+    intensity_array_->data.swap(int_tmp);
+
+    for (Size i = 0; i < float_data_arrays_.size(); ++i)
+    {
+      std::vector<float> mda_tmp;
+      mda_tmp.reserve(snew);
+      for (Size j = 0; j < snew; ++j)
+      {
+        mda_tmp.push_back(float_data_arrays_[i][indices[j]]);
+      }
+      std::swap(static_cast<std::vector<float>&>(float_data_arrays_[i]), mda_tmp);
+    }
+
+    for (Size i = 0; i < string_data_arrays_.size(); ++i)
+    {
+      std::vector<String> mda_tmp;
+      mda_tmp.reserve(snew);
+      for (Size j = 0; j < snew; ++j)
+      {
+        mda_tmp.push_back(string_data_arrays_[i][indices[j]]);
+      }
+      std::swap(static_cast<std::vector<String>&>(string_data_arrays_[i]), mda_tmp);
+    }
+
+    for (Size i = 0; i < integer_data_arrays_.size(); ++i)
+    {
+      std::vector<Int> mda_tmp;
+      mda_tmp.reserve(snew);
+      for (Size j = 0; j < snew; ++j)
+      {
+        mda_tmp.push_back(integer_data_arrays_[i][indices[j]]);
+      }
+      std::swap(static_cast<std::vector<Int>&>(integer_data_arrays_[i]), mda_tmp);
+    }
+
+    return *this;
+  }
+
+} // namespace OpenMS
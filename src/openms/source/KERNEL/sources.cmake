@@ -30,6 +30,7 @@ SpectrumHelper.cpp
 ChromatogramPeak.cpp
 MSChromatogram.cpp
 ChromatogramTools.cpp
+ColumnarSpectrum.cpp
 )
 
 ### add path to the filenames
@@ -42,7 +42,16 @@ using namespace std;
 
 namespace OpenMS
 {
+  CubicSpline2d::CubicSpline2d()
+  {
+  }
+
   CubicSpline2d::CubicSpline2d(const std::vector<double>& x, const std::vector<double>& y)
+  {
+    init(x, y);
+  }
+
+  void CubicSpline2d::init(const std::vector<double>& x, const std::vector<double>& y)
   {
     if (x.size() != y.size())
     {
@@ -88,7 +97,7 @@ namespace OpenMS
 
   double CubicSpline2d::eval(double x) const
   {
-    if (x < x_.front() || x > x_.back())
+    if (x_.empty() || x < x_.front() || x > x_.back())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Argument out of range of spline interpolation.");
     }
@@ -106,7 +115,7 @@ namespace OpenMS
 
   double CubicSpline2d::derivatives(double x, unsigned order) const
   {
-    if (x < x_.front() || x > x_.back())
+    if (x_.empty() || x < x_.front() || x > x_.back())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Argument out of range of spline interpolation.");
     }
@@ -142,41 +151,37 @@ namespace OpenMS
   {
     const size_t n = x.size() - 1;
 
-    std::vector<double> h;
-    h.reserve(n);
-    a_.reserve(n);
-    x_.reserve(n+1);
-    // do the 0'th element manually, since the loop below only starts at 1
-    h.push_back(x[1] - x[0]);
-    x_.push_back(x[0]);
-    a_.push_back(y[0]);
-
-    std::vector<double> mu(n, 0.0);
-    std::vector<double> z(n, 0.0);
+    // store x,y -- required for evaluation later on
+    // ('x_' needs to be full length, all other member vectors (except c_) are one element shorter)
+    x_.assign(x.begin(), x.end());
+    a_.assign(y.begin(), y.end() - 1);
+    b_.resize(n);
+    c_.resize(n + 1);
+    d_.resize(n);
+
+    // forward sweep: the intervals (h) are stored in b_, the temporaries mu and z in d_ and c_,
+    // so (re-)initialization needs no memory besides the coefficients
+    b_[0] = x[1] - x[0];
+    d_[0] = 0.0;
+    c_[0] = 0.0;
     for (unsigned i = 1; i < n; ++i)
     {
-      h.push_back(x[i + 1] - x[i]);
-      const double l = 2 * (x[i + 1] - x[i - 1]) - h[i - 1] * mu[i - 1];
-      mu[i] = h[i] / l;
-      z[i] = (3 * (y[i + 1] * h[i - 1] - y[i] * (x[i + 1] - x[i - 1]) + y[i - 1] * h[i]) / (h[i - 1] * h[i]) - h[i - 1] * z[i - 1]) / l;
-      // store x,y -- required for evaluation later on
-      x_.push_back(x[i]);
-      a_.push_back(y[i]);
+      b_[i] = x[i + 1] - x[i];
+      const double l = 2 * (x[i + 1] - x[i - 1]) - b_[i - 1] * d_[i - 1];
+      d_[i] = b_[i] / l;
+      c_[i] = (3 * (y[i + 1] * b_[i - 1] - y[i] * (x[i + 1] - x[i - 1]) + y[i - 1] * b_[i]) / (b_[i - 1] * b_[i]) - b_[i - 1] * c_[i - 1]) / l;
     }
-    // 'x_' needs to be full length (all other member vectors (except c_) are one element shorter)
-    x_.push_back(x[n]);
 
-    b_.resize(n); 
-    d_.resize(n);
-    c_.resize(n+1);
-    c_.back() = 0;
+    // back substitution (overwrites h, mu and z with the coefficients)
+    c_[n] = 0;
     for (int j = n - 1; j >= 0; --j)
     {
-      c_[j] = z[j] - mu[j] * c_[j + 1];
-      b_[j] = (y[j + 1] - y[j]) / h[j] - h[j] * (c_[j + 1] + 2 * c_[j]) / 3;
-      d_[j] = (c_[j + 1] - c_[j]) / (3 * h[j]);
+      const double h = b_[j];
+      const double mu = d_[j];
+      c_[j] = c_[j] - mu * c_[j + 1];
+      b_[j] = (y[j + 1] - y[j]) / h - h * (c_[j + 1] + 2 * c_[j]) / 3;
+      d_[j] = (c_[j + 1] - c_[j]) / (3 * h);
     }
-
   }
 
 }
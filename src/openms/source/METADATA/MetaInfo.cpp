@@ -76,7 +76,7 @@ namespace OpenMS
 
   const DataValue & MetaInfo::getValue(const String & name) const
   {
-    map<UInt, DataValue>::const_iterator it = index_to_value_.find(registry_.getIndex(name));
+    MapType::const_iterator it = index_to_value_.find(registry_.getIndex(name));
     if (it != index_to_value_.end())
     {
       return it->second;
@@ -86,7 +86,7 @@ namespace OpenMS
 
   const DataValue & MetaInfo::getValue(UInt index) const
   {
-    map<UInt, DataValue>::const_iterator it = index_to_value_.find(index);
+    MapType::const_iterator it = index_to_value_.find(index);
     if (it != index_to_value_.end())
     {
       return it->second;
@@ -97,13 +97,23 @@ namespace OpenMS
   void MetaInfo::setValue(const String & name, const DataValue & value)
   {
     UInt index = registry_.registerName(name); // no-op if name is already registered
-    index_to_value_[index] = value;
+    setValue(index, value);
   }
 
   void MetaInfo::setValue(UInt index, const DataValue & value)
   {
     // @TODO: check if that index is registered in MetaInfoRegistry?
-    index_to_value_[index] = value;
+    MapType::iterator it = index_to_value_.find(index);
+    if (it != index_to_value_.end())
+    {
+      it->second = value;
+    }
+    else
+    {
+      // 'value' may refer into this map (e.g. setValue(a, getValue(b))) and
+      // inserting moves the stored values, so copy it first
+      index_to_value_.insert(MapType::value_type(index, DataValue(value)));
+    }
   }
 
   MetaInfoRegistry & MetaInfo::registry()
@@ -128,7 +138,7 @@ namespace OpenMS
 
   void MetaInfo::removeValue(const String & name)
   {
-    map<UInt, DataValue>::iterator it = index_to_value_.find(registry_.getIndex(name));
+    MapType::iterator it = index_to_value_.find(registry_.getIndex(name));
     if (it != index_to_value_.end())
     {
       index_to_value_.erase(it);
@@ -137,7 +147,7 @@ namespace OpenMS
 
   void MetaInfo::removeValue(UInt index)
   {
-    map<UInt, DataValue>::iterator it = index_to_value_.find(index);
+    MapType::iterator it = index_to_value_.find(index);
     if (it != index_to_value_.end())
     {
       index_to_value_.erase(it);
@@ -148,7 +158,7 @@ namespace OpenMS
   {
     keys.resize(index_to_value_.size());
     UInt i = 0;
-    for (map<UInt, DataValue>::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
+    for (MapType::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
     {
       keys[i++] = registry_.getName(it->first);
     }
@@ -158,7 +168,7 @@ namespace OpenMS
   {
     keys.resize(index_to_value_.size());
     UInt i = 0;
-    for (map<UInt, DataValue>::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
+    for (MapType::const_iterator it = index_to_value_.begin(); it != index_to_value_.end(); ++it)
     {
       keys[i++] = it->first;
     }
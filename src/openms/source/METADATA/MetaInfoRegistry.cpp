@@ -32,91 +32,96 @@
 // $Authors: Marc Sturm, Hendrik Weisser $
 // -------------------------------------------------------------------------
 
-#include <sstream>
-
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// FNV-1a hash of a string
+    inline Size hashName(const String& name)
+    {
+      Size hash = 2166136261u;
+      for (String::const_iterator it = name.begin(); it != name.end(); ++it)
+      {
+        hash ^= (unsigned char)(*it);
+        hash *= 16777619u;
+      }
+      return hash;
+    }
+
+    /// Loads a list head with acquire semantics (the entry it points to is completely visible)
+    template <typename T>
+    inline const T* loadAcquire(const T* const* ptr)
+    {
+#if defined(_MSC_VER)
+      return static_cast<const T*>(_InterlockedCompareExchangePointer((void* volatile*)ptr, 0, 0));
+#elif defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+      return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+      return __sync_val_compare_and_swap(const_cast<const T**>(ptr), (const T*)0, (const T*)0);
+#endif
+    }
+
+    /// Stores a list head with release semantics (all prior writes to the entry become visible first)
+    template <typename T>
+    inline void storeRelease(const T** ptr, const T* value)
+    {
+#if defined(_MSC_VER)
+      _InterlockedExchangePointer((void* volatile*)ptr, (void*)value);
+#elif defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+      __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+      __sync_synchronize();
+      *(const T* volatile*)ptr = value;
+      __sync_synchronize();
+#endif
+    }
+  }
+
+  const Size MetaInfoRegistry::NR_BUCKETS;
+
   MetaInfoRegistry::MetaInfoRegistry() :
-    next_index_(1024), name_to_index_(), index_to_name_(), index_to_description_(), index_to_unit_()
+    next_index_(1024), entries_(), index_to_description_(), index_to_unit_()
   {
-    name_to_index_["isotopic_range"] = 1;
-    index_to_name_[1] = "isotopic_range";
-    index_to_description_[1] = "consecutive numbering of the peaks in an isotope pattern. 0 is the monoisotopic peak";
-    index_to_unit_[1] = "";
-
-    name_to_index_["cluster_id"] = 2;
-    index_to_name_[2] = "cluster_id";
-    index_to_description_[2] = "consecutive numbering of isotope clusters in a spectrum";
-    index_to_unit_[2] = "";
-
-    name_to_index_["label"] = 3;
-    index_to_name_[3] = "label";
-    index_to_description_[3] = "label e.g. shown in visialization";
-    index_to_unit_[3] = "";
-
-    name_to_index_["icon"] = 4;
-    index_to_name_[4] = "icon";
-    index_to_description_[4] = "icon shown in visialization";
-    index_to_unit_[4] = "";
-
-    name_to_index_["color"] = 5;
-    index_to_name_[5] = "color";
-    index_to_description_[5] = "color used for visialization e.g. #FF00FF for purple";
-    index_to_unit_[5] = "";
-
-    name_to_index_["RT"] = 6;
-    index_to_name_[6] = "RT";
-    index_to_description_[6] = "the retention time of an identification";
-    index_to_unit_[6] = "";
-
-    name_to_index_["MZ"] = 7;
-    index_to_name_[7] = "MZ";
-    index_to_description_[7] = "the MZ of an identification";
-    index_to_unit_[7] = "";
-
-    name_to_index_["predicted_RT"] = 8;
-    index_to_name_[8] = "predicted_RT";
-    index_to_description_[8] = "the predicted retention time of a peptide hit";
-    index_to_unit_[8] = "";
-
-    name_to_index_["predicted_RT_p_value"] = 9;
-    index_to_name_[9] = "predicted_RT_p_value";
-    index_to_description_[9] = "the predicted RT p-value of a peptide hit";
-    index_to_unit_[9] = "";
-
-    name_to_index_["spectrum_reference"] = 10;
-    index_to_name_[10] = "spectrum_reference";
-    index_to_description_[10] = "Refenference to a spectrum or feature number";
-    index_to_unit_[10] = "";
-
-    name_to_index_["ID"] = 11;
-    index_to_name_[11] = "ID";
-    index_to_description_[11] = "Some type of identifier";
-    index_to_unit_[11] = "";
-
-    name_to_index_["low_quality"] = 12;
-    index_to_name_[12] = "low_quality";
-    index_to_description_[12] = "Flag which indicatest that some entity has a low quality (e.g. a feature pair)";
-    index_to_unit_[12] = "";
-
-    name_to_index_["charge"] = 13;
-    index_to_name_[13] = "charge";
-    index_to_description_[13] = "Charge of a feature or peak";
-    index_to_unit_[13] = "";
+    std::fill(by_name_, by_name_ + NR_BUCKETS, (const NameEntry*)0);
+    std::fill(by_index_, by_index_ + NR_BUCKETS, (const NameEntry*)0);
+
+    addName_("isotopic_range", 1, "consecutive numbering of the peaks in an isotope pattern. 0 is the monoisotopic peak", "");
+    addName_("cluster_id", 2, "consecutive numbering of isotope clusters in a spectrum", "");
+    addName_("label", 3, "label e.g. shown in visialization", "");
+    addName_("icon", 4, "icon shown in visialization", "");
+    addName_("color", 5, "color used for visialization e.g. #FF00FF for purple", "");
+    addName_("RT", 6, "the retention time of an identification", "");
+    addName_("MZ", 7, "the MZ of an identification", "");
+    addName_("predicted_RT", 8, "the predicted retention time of a peptide hit", "");
+    addName_("predicted_RT_p_value", 9, "the predicted RT p-value of a peptide hit", "");
+    addName_("spectrum_reference", 10, "Refenference to a spectrum or feature number", "");
+    addName_("ID", 11, "Some type of identifier", "");
+    addName_("low_quality", 12, "Flag which indicatest that some entity has a low quality (e.g. a feature pair)", "");
+    addName_("charge", 13, "Charge of a feature or peak", "");
   }
 
-  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs)
+  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs) :
+    next_index_(1024), entries_(), index_to_description_(), index_to_unit_()
   {
+    std::fill(by_name_, by_name_ + NR_BUCKETS, (const NameEntry*)0);
+    std::fill(by_index_, by_index_ + NR_BUCKETS, (const NameEntry*)0);
     *this = rhs;
   }
 
   MetaInfoRegistry::~MetaInfoRegistry()
   {
+    clear_();
   }
 
   MetaInfoRegistry& MetaInfoRegistry::operator=(const MetaInfoRegistry& rhs)
@@ -125,32 +130,86 @@ namespace OpenMS
 
 #pragma omp critical (MetaInfoRegistry)
     {
+      clear_();
+      for (vector<NameEntry*>::const_iterator it = rhs.entries_.begin(); it != rhs.entries_.end(); ++it)
+      {
+        addName_((*it)->name, (*it)->index, "", "");
+      }
       next_index_ = rhs.next_index_;
-      name_to_index_ = rhs.name_to_index_;
-      index_to_name_ = rhs.index_to_name_;
       index_to_description_ = rhs.index_to_description_;
       index_to_unit_ = rhs.index_to_unit_;
     }
     return *this;
   }
 
+  void MetaInfoRegistry::clear_()
+  {
+    std::fill(by_name_, by_name_ + NR_BUCKETS, (const NameEntry*)0);
+    std::fill(by_index_, by_index_ + NR_BUCKETS, (const NameEntry*)0);
+    for (vector<NameEntry*>::iterator it = entries_.begin(); it != entries_.end(); ++it)
+    {
+      delete *it;
+    }
+    entries_.clear();
+  }
+
+  const MetaInfoRegistry::NameEntry* MetaInfoRegistry::findName_(const String& name) const
+  {
+    // the list behind an atomically loaded head is immutable (see addName_)
+    const NameEntry* entry = loadAcquire(&by_name_[hashName(name) % NR_BUCKETS]);
+    while (entry != 0 && entry->name != name)
+    {
+      entry = entry->next_by_name;
+    }
+    return entry;
+  }
+
+  const MetaInfoRegistry::NameEntry* MetaInfoRegistry::findIndex_(UInt index) const
+  {
+    const NameEntry* entry = loadAcquire(&by_index_[index % NR_BUCKETS]);
+    while (entry != 0 && entry->index != index)
+    {
+      entry = entry->next_by_index;
+    }
+    return entry;
+  }
+
+  void MetaInfoRegistry::addName_(const String& name, UInt index, const String& description, const String& unit)
+  {
+    const NameEntry** name_bucket = &by_name_[hashName(name) % NR_BUCKETS];
+    const NameEntry** index_bucket = &by_index_[index % NR_BUCKETS];
+
+    // complete the entry before it is published by the release stores, only
+    // the writer (holding the lock) changes the list heads
+    NameEntry* entry = new NameEntry(name, index);
+    entry->next_by_name = *name_bucket;
+    entry->next_by_index = *index_bucket;
+    entries_.push_back(entry);
+    index_to_description_[index] = description;
+    index_to_unit_[index] = unit;
+
+    storeRelease(index_bucket, (const NameEntry*)entry);
+    storeRelease(name_bucket, (const NameEntry*)entry);
+  }
+
   UInt MetaInfoRegistry::registerName(const String& name, const String& description, const String& unit)
   {
+    // fast path: the name is already registered
+    const NameEntry* entry = findName_(name);
+    if (entry != 0) return entry->index;
+
     UInt rv;
 #pragma omp critical (MetaInfoRegistry)
     {
-      map<String, UInt>::iterator it = name_to_index_.find(name);
-      if (it == name_to_index_.end())
+      entry = findName_(name);
+      if (entry == 0)
       {
-        name_to_index_[name] = next_index_;
-        index_to_name_[next_index_] = name;
-        index_to_description_[next_index_] = description;
-        index_to_unit_[next_index_] = unit;
+        addName_(name, next_index_, description, unit);
         rv = next_index_++;
       }
       else
       {
-        rv = it->second;
+        rv = entry->index;
       }
     }
     return rv;
@@ -175,18 +234,14 @@ namespace OpenMS
 
   void MetaInfoRegistry::setDescription(const String& name, const String& description)
   {
-    map<String, UInt>::iterator pos;
+    const NameEntry* entry = findName_(name);
+    if (entry == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
-      {
-        index_to_description_[pos->second] = description;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
-      }
+      index_to_description_[entry->index] = description;
     }
   }
 
@@ -209,33 +264,22 @@ namespace OpenMS
 
   void MetaInfoRegistry::setUnit(const String& name, const String& unit)
   {
-    map<String, UInt>::iterator pos;
+    const NameEntry* entry = findName_(name);
+    if (entry == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
-      {
-        index_to_unit_[pos->second] = unit;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
-      }
+      index_to_unit_[entry->index] = unit;
     }
   }
 
   UInt MetaInfoRegistry::getIndex(const String& name) const
   {
-    UInt rv = UInt(-1);
-#pragma omp critical (MetaInfoRegistry)
-    {
-      map<String, UInt>::const_iterator it = name_to_index_.find(name);
-      if (it != name_to_index_.end())
-      {
-        rv = it->second;
-      }
-    }
-    return rv;
+    const NameEntry* entry = findName_(name);
+    if (entry == 0) return UInt(-1);
+    return entry->index;
   }
 
   String MetaInfoRegistry::getDescription(UInt index) const
@@ -306,20 +350,12 @@ namespace OpenMS
 
   String MetaInfoRegistry::getName(UInt index) const
   {
-    String rv;
-#pragma omp critical (MetaInfoRegistry)
+    const NameEntry* entry = findIndex_(index);
+    if (entry == 0)
     {
-      map<UInt, String>::const_iterator it = index_to_name_.find(index);
-      if (it != index_to_name_.end())
-      {
-        rv = it->second;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
     }
-    return rv;
+    return entry->name;
   }
 
 } //namespace
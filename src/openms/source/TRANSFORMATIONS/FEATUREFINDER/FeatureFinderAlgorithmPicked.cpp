@@ -42,6 +42,7 @@
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/IsotopeDistributionTable.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/CONCEPT/Constants.h>
@@ -402,13 +403,15 @@ namespace OpenMS
       //reserve enough space
       isotope_distributions_.resize(num_isotopes);
 
+      const IsotopeDistributionTable& averagine_table = IsotopeDistributionTable::getPeptideTable();
+
       //calculate distribution if necessary
       for (Size index = 0; index < num_isotopes; ++index)
       {
         //if(debug_) log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
         IsotopeDistribution d;
         d.setMaxIsotope(max_isotopes);
-        d.estimateFromPeptideWeight(0.5 * mass_window_width_ + index * mass_window_width_);
+        averagine_table.estimate(0.5 * mass_window_width_ + index * mass_window_width_, d);
         //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
         Size size_before = d.size();
         d.trimLeft(intensity_percentage_optional_);
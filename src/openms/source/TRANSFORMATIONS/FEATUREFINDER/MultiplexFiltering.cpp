@@ -36,6 +36,7 @@
 #include <OpenMS/KERNEL/BaseFeature.h>
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CHEMISTRY/IsotopeDistribution.h>
+#include <OpenMS/CHEMISTRY/IsotopeDistributionTable.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFiltering.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexIsotopicPeakPattern.h>
@@ -61,8 +62,21 @@ namespace OpenMS
 {
 
   MultiplexFiltering::MultiplexFiltering(const PeakMap& exp_picked, const std::vector<MultiplexIsotopicPeakPattern> patterns, int peaks_per_peptide_min, int peaks_per_peptide_max, bool missing_peaks, double intensity_cutoff, double mz_tolerance, bool mz_tolerance_unit, double peptide_similarity, double averagine_similarity, double averagine_similarity_scaling, String averigine_type) :
-    exp_picked_(exp_picked), patterns_(patterns), peaks_per_peptide_min_(peaks_per_peptide_min), peaks_per_peptide_max_(peaks_per_peptide_max), missing_peaks_(missing_peaks), intensity_cutoff_(intensity_cutoff), mz_tolerance_(mz_tolerance), mz_tolerance_unit_(mz_tolerance_unit), peptide_similarity_(peptide_similarity), averagine_similarity_(averagine_similarity), averagine_similarity_scaling_(averagine_similarity_scaling), averagine_type_(averigine_type)
+    exp_picked_(exp_picked), patterns_(patterns), peaks_per_peptide_min_(peaks_per_peptide_min), peaks_per_peptide_max_(peaks_per_peptide_max), missing_peaks_(missing_peaks), intensity_cutoff_(intensity_cutoff), mz_tolerance_(mz_tolerance), mz_tolerance_unit_(mz_tolerance_unit), peptide_similarity_(peptide_similarity), averagine_similarity_(averagine_similarity), averagine_similarity_scaling_(averagine_similarity_scaling), averagine_type_(averigine_type), averagine_table_(0)
   {
+    // fetch the shared table once, it is used for every peak
+    if (averagine_type_ == "peptide")
+    {
+      averagine_table_ = &IsotopeDistributionTable::getPeptideTable();
+    }
+    else if (averagine_type_ == "RNA")
+    {
+      averagine_table_ = &IsotopeDistributionTable::getRNATable();
+    }
+    else if (averagine_type_ == "DNA")
+    {
+      averagine_table_ = &IsotopeDistributionTable::getDNATable();
+    }
   }
 
   int MultiplexFiltering::positionsAndBlacklistFilter_(const MultiplexIsotopicPeakPattern& pattern, int spectrum,
@@ -401,32 +415,15 @@ namespace OpenMS
   double MultiplexFiltering::getAveragineSimilarity_(const vector<double>& pattern, double m) const
 
   {
-    // construct averagine distribution
-    IsotopeDistribution distribution;
-    vector<double> averagine_pattern;
-    distribution.setMaxIsotope(pattern.size());
-    if (averagine_type_ == "peptide")
-    {
-        distribution.estimateFromPeptideWeight(m);
-    }
-    else if (averagine_type_ == "RNA")
-    {
-        distribution.estimateFromRNAWeight(m);
-    }
-    else if (averagine_type_ == "DNA")
-    {
-        distribution.estimateFromDNAWeight(m);
-    }
-    else
+    if (averagine_table_ == 0)
     {
         throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
           "Averagine type unrecognized.");;
     }
 
-    for (IsotopeDistribution::Iterator it = distribution.begin(); it != distribution.end(); ++it)
-    {
-      averagine_pattern.push_back(it->second);
-    }
+    // construct averagine distribution
+    vector<double> averagine_pattern;
+    averagine_table_->estimate(m, pattern.size(), averagine_pattern);
 
     return getPatternSimilarity_(pattern, averagine_pattern);
   }
@@ -35,6 +35,7 @@
 
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 
+#include <algorithm>
 #include <vector>
 
 using namespace std;
@@ -92,4 +93,15 @@ namespace OpenMS
     report_FWHM_as_ppm_ = getParameters().getValue("report_FWHM_unit")!="absolute";
   }
 
+  void PeakPickerHiRes::addPeakPoint_(PickingBuffers& buffers, double mz, double intensity, bool overwrite)
+  {
+    if (!buffers.peak_mz.empty() && buffers.peak_mz.back() == mz)
+    {
+      if (overwrite) buffers.peak_int.back() = intensity;
+      return;
+    }
+    buffers.peak_mz.push_back(mz);
+    buffers.peak_int.push_back(intensity);
+  }
+
 }
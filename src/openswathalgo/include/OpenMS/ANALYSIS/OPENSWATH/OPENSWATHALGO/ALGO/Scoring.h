@@ -53,8 +53,37 @@ namespace OpenSwath
   {
     /** @name Type defs */
     //@{
-    /// Cross Correlation array
-    typedef std::map<int, double> XCorrArrayType;
+    /**
+      @brief Cross Correlation array
+
+      Stores (lag, correlation) pairs contiguously in order of increasing lag.
+      It provides the subset of the std::map interface that is used for
+      cross-correlation arrays (iteration, size and lookup by lag) without
+      allocating a tree node per lag.
+    */
+    struct OPENSWATHALGO_DLLAPI XCorrArrayType
+    {
+      typedef std::vector<std::pair<int, double> > ContainerType;
+      typedef ContainerType::iterator iterator;
+      typedef ContainerType::const_iterator const_iterator;
+
+      /// The (lag, correlation) pairs, sorted by lag
+      ContainerType data;
+
+      iterator begin() {return data.begin();}
+      const_iterator begin() const {return data.begin();}
+      iterator end() {return data.end();}
+      const_iterator end() const {return data.end();}
+      std::size_t size() const {return data.size();}
+      bool empty() const {return data.empty();}
+      void clear() {data.clear();}
+
+      /// Returns the entry with lag @p lag or end() if the lag is not contained
+      iterator find(int lag);
+
+      /// Returns the entry with lag @p lag or end() if the lag is not contained
+      const_iterator find(int lag) const;
+    };
     //@}
 
     /** @name Helper functions */
@@ -102,10 +131,28 @@ namespace OpenSwath
     OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelation(std::vector<double>& data1,
                                                             std::vector<double>& data2, int maxdelay, int lag);
 
+    /**
+      @brief Calculate crosscorrelation on std::vector data that is already standardized
+
+      Same as normalizedCrossCorrelation() without the standardization step,
+      i.e. the result is calculateCrossCorrelation() divided by the data
+      length. Use this to correlate many pairs of traces, each of which only
+      needs to be standardized once (see standardize_data). The result is
+      written into @p result to reuse its memory.
+    */
+    OPENSWATHALGO_DLLAPI void normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                           const std::vector<double>& normalized_data2,
+                                                           int maxdelay, int lag, XCorrArrayType& result);
+
     /// Calculate crosscorrelation on std::vector data without normalization
     OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(std::vector<double>& data1,
                                                       std::vector<double>& data2, int maxdelay, int lag);
 
+    /// Calculate crosscorrelation on std::vector data without normalization (result written into @p result)
+    OPENSWATHALGO_DLLAPI void calculateCrossCorrelation(const std::vector<double>& data1,
+                                                      const std::vector<double>& data2, int maxdelay, int lag,
+                                                      XCorrArrayType& result);
+
     /// Find best peak in an cross-correlation (highest apex)
     OPENSWATHALGO_DLLAPI XCorrArrayType::iterator xcorrArrayGetMaxPeak(XCorrArrayType & array);
 
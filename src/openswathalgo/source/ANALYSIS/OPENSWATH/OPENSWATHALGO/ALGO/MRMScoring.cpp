@@ -51,23 +51,31 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    // retrieve and standardize every trace only once
+    std::vector<std::vector<double> > intensities(native_ids.size());
+    for (std::size_t i = 0; i < native_ids.size(); i++)
+    {
+      mrmfeature->getFeature(native_ids[i])->getIntensity(intensities[i]);
+      Scoring::standardize_data(intensities[i]);
+    }
+
+    std::vector<double> intensityi;
     xcorr_matrix_.resize(native_ids.size());
     for (std::size_t i = 0; i < native_ids.size(); i++)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
       xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
+      intensityi = intensities[i];
+      int maxdelay = boost::numeric_cast<int>(intensityi.size());
       for (std::size_t j = i; j < native_ids.size(); j++)
       {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
+        // normalizedCrossCorrelation() standardizes its (here reused) first
+        // argument again for every pair, repeat this to keep the scores identical
+        if (j > i)
+        {
+          Scoring::standardize_data(intensityi);
+        }
         // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        Scoring::normalizedCrossCorrelationPost(intensityi, intensities[j], maxdelay, 1, xcorr_matrix_[i][j]);
       }
     }
   }
@@ -90,7 +98,15 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrIdMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids_identification, std::vector<String> native_ids_detection)
   { 
-    std::vector<double> intensityi, intensityj;
+    // retrieve and standardize every detection trace only once
+    std::vector<std::vector<double> > intensities_detection(native_ids_detection.size());
+    for (std::size_t j = 0; j < native_ids_detection.size(); j++)
+    {
+      mrmfeature->getFeature(native_ids_detection[j])->getIntensity(intensities_detection[j]);
+      Scoring::standardize_data(intensities_detection[j]);
+    }
+
+    std::vector<double> intensityi;
     xcorr_matrix_.resize(native_ids_identification.size());
     for (std::size_t i = 0; i < native_ids_identification.size(); i++)
     { 
@@ -99,14 +115,13 @@ namespace OpenSwath
       xcorr_matrix_[i].resize(native_ids_detection.size());
       intensityi.clear();
       fi->getIntensity(intensityi);
+      int maxdelay = boost::numeric_cast<int>(intensityi.size());
       for (std::size_t j = 0; j < native_ids_detection.size(); j++)
       {
-        String native_id2 = native_ids_detection[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
+        // see initializeXCorrMatrix, the identification trace is standardized for every pair
+        Scoring::standardize_data(intensityi);
         // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        Scoring::normalizedCrossCorrelationPost(intensityi, intensities_detection[j], maxdelay, 1, xcorr_matrix_[i][j]);
       }
     }
   }
@@ -35,6 +35,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OPENSWATHALGO/Macros.h>
 #include <cmath>
+#include <algorithm>
 
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -43,6 +44,31 @@ namespace OpenSwath
   namespace Scoring
   {
 
+    namespace
+    {
+      struct LagLess
+      {
+        bool operator()(const std::pair<int, double>& a, int lag) const
+        {
+          return a.first < lag;
+        }
+      };
+    }
+
+    XCorrArrayType::iterator XCorrArrayType::find(int lag)
+    {
+      iterator it = std::lower_bound(data.begin(), data.end(), lag, LagLess());
+      if (it != data.end() && it->first == lag) return it;
+      return data.end();
+    }
+
+    XCorrArrayType::const_iterator XCorrArrayType::find(int lag) const
+    {
+      const_iterator it = std::lower_bound(data.begin(), data.end(), lag, LagLess());
+      if (it != data.end() && it->first == lag) return it;
+      return data.end();
+    }
+
     void normalize_sum(double x[], unsigned int n)
     {
       double sumx = std::accumulate(&x[0], &x[0] + n, 0.0);
@@ -146,38 +172,57 @@ namespace OpenSwath
       // normalize the data
       standardize_data(data1);
       standardize_data(data2);
-      std::map<int, double> result = calculateCrossCorrelation(data1, data2, maxdelay, lag);
-      for (std::map<int, double>::iterator it = result.begin(); it != result.end(); ++it)
+      XCorrArrayType result;
+      normalizedCrossCorrelationPost(data1, data2, maxdelay, lag, result);
+      return result;
+    }
+
+    void normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                        const std::vector<double>& normalized_data2,
+                                        int maxdelay, int lag, XCorrArrayType& result)
+    {
+      calculateCrossCorrelation(normalized_data1, normalized_data2, maxdelay, lag, result);
+      const double n = (double) normalized_data1.size();
+      for (XCorrArrayType::iterator it = result.begin(); it != result.end(); ++it)
       {
-        it->second = it->second / data1.size();
+        it->second = it->second / n;
       }
-      return result;
     }
 
     XCorrArrayType calculateCrossCorrelation(std::vector<double>& data1,
                                              std::vector<double>& data2, int maxdelay, int lag)
+    {
+      XCorrArrayType result;
+      calculateCrossCorrelation(static_cast<const std::vector<double>&>(data1),
+                                static_cast<const std::vector<double>&>(data2), maxdelay, lag, result);
+      return result;
+    }
+
+    void calculateCrossCorrelation(const std::vector<double>& data1,
+                                   const std::vector<double>& data2, int maxdelay, int lag,
+                                   XCorrArrayType& result)
     {
       OPENSWATH_PRECONDITION(data1.size() != 0 && data1.size() == data2.size(), "Both data vectors need to have the same length");
 
-      XCorrArrayType result;
+      result.data.clear();
+      if (lag > 0) result.data.reserve(2 * maxdelay / lag + 1);
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
+      const double* x = &data1[0];
+      const double* y = &data2[0];
 
-      for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
+      for (int delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
+        // only the overlapping region contributes (i and i + delay valid),
+        // the summation order is the same as iterating over all i
+        int start = std::max(0, -delay);
+        int end = std::min(datasize, datasize - delay);
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        for (int i = start; i < end; ++i)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy += x[i] * y[i + delay];
         }
-        result[delay] = sxy;
+        result.data.push_back(std::make_pair(delay, sxy));
       }
-      return result;
     }
 
     XCorrArrayType calcxcorr_legacy_mquest_(std::vector<double>& data1,
@@ -234,12 +279,12 @@ namespace OpenSwath
 
         if (denominator > 0)
         {
-          result[delay] = sxy / denominator;
+          result.data.push_back(std::make_pair(delay, sxy / denominator));
         }
         else
         {
           // e.g. if all datapoints are zero
-          result[delay] = 0;
+          result.data.push_back(std::make_pair(delay, 0.0));
         }
       }
       return result;
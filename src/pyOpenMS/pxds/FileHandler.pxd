@@ -1,10 +1,12 @@
 from MSExperiment  cimport *
 from FeatureMap cimport *
+from ConsensusMap cimport *
 from Feature cimport *
 from libcpp.string cimport string as libcpp_string
 from FileTypes cimport *
 from Types cimport *
 from PeakFileOptions cimport *
+from FeatureFileOptions cimport *
 
 cdef extern from "<OpenMS/FORMAT/FileHandler.h>" namespace "OpenMS":
 
@@ -15,9 +17,14 @@ cdef extern from "<OpenMS/FORMAT/FileHandler.h>" namespace "OpenMS":
         bool loadExperiment(libcpp_string, MSExperiment &) nogil except+
         void storeExperiment(libcpp_string, MSExperiment) nogil except+
         bool loadFeatures(libcpp_string, FeatureMap &) nogil except +
+        void storeFeatures(libcpp_string, FeatureMap) nogil except +
+        bool loadConsensusFeatures(libcpp_string, ConsensusMap &) nogil except +
+        void storeConsensusFeatures(libcpp_string, ConsensusMap) nogil except +
 
         PeakFileOptions  getOptions() nogil except +
         void setOptions(PeakFileOptions) nogil except +
+        FeatureFileOptions getFeatOptions() nogil except +
+        void setFeatOptions(FeatureFileOptions) nogil except +
 
 #
 # wrap static method:
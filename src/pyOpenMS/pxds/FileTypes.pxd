@@ -32,5 +32,7 @@ cdef extern from "<OpenMS/FORMAT/FileTypes.h>" namespace "OpenMS::FileTypes":
             HARDKLOER,
             KROENIK,
             FASTA,
-            EDTA
+            EDTA,
+            FEATUREBIN,
+            CONSENSUSBIN,
             SIZE_OF_TYPE
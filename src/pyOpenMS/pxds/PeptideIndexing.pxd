@@ -3,6 +3,7 @@ from libcpp.vector cimport vector as libcpp_vector
 from DefaultParamHandler cimport *
 from ProgressLogger cimport *
 from FASTAFile cimport *
+from String cimport *
 
 cdef extern from "<OpenMS/ANALYSIS/ID/PeptideIndexing.h>" namespace "OpenMS":
     
@@ -16,6 +17,10 @@ cdef extern from "<OpenMS/ANALYSIS/ID/PeptideIndexing.h>" namespace "OpenMS":
                                       libcpp_vector[ ProteinIdentification ] & prot_ids,
                                       libcpp_vector[ PeptideIdentification ] & pep_ids) nogil except +
 
+        PeptideIndexing_ExitCodes run(String fasta_file,
+                                      libcpp_vector[ ProteinIdentification ] & prot_ids,
+                                      libcpp_vector[ PeptideIdentification ] & pep_ids) nogil except +
+
 cdef extern from "<OpenMS/ANALYSIS/ID/PeptideIndexing.h>" namespace "OpenMS::PeptideIndexing":
     cdef enum PeptideIndexing_ExitCodes "OpenMS::PeptideIndexing::ExitCodes":
         #wrap-attach:
@@ -0,0 +1,107 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/Base64.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+using namespace OpenMS;
+
+// Compares Base64::decode() (reference implementation) with
+// Base64::decodeFast() on synthetic peak data.
+//
+// Usage: Base64Decode_benchmark [number of values] [repetitions]
+
+namespace
+{
+  template <typename T>
+  void runBenchmark(const String& label, Size n, Size repetitions, bool zlib)
+  {
+    std::vector<T> data(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      data[i] = (T)(400.0 + i * 0.0123);
+    }
+
+    Base64 b64;
+    String encoded;
+    b64.encode(data, Base64::BYTEORDER_LITTLEENDIAN, encoded, zlib);
+
+    std::vector<T> out_ref, out_fast;
+    StopWatch sw_ref, sw_fast;
+
+    sw_ref.start();
+    for (Size r = 0; r < repetitions; ++r)
+    {
+      b64.decode(encoded, Base64::BYTEORDER_LITTLEENDIAN, out_ref, zlib);
+    }
+    sw_ref.stop();
+
+    sw_fast.start();
+    for (Size r = 0; r < repetitions; ++r)
+    {
+      b64.decodeFast(encoded, Base64::BYTEORDER_LITTLEENDIAN, out_fast, zlib);
+    }
+    sw_fast.stop();
+
+    if (out_ref != out_fast)
+    {
+      std::cerr << label << ": decodeFast() result differs from decode()" << std::endl;
+      std::exit(1);
+    }
+
+    double mb = (double)encoded.size() * repetitions / (1024.0 * 1024.0);
+    std::cout << label << (zlib ? " (zlib)" : "       ")
+              << "  decode: " << mb / sw_ref.getClockTime() << " MB/s"
+              << "  decodeFast: " << mb / sw_fast.getClockTime() << " MB/s"
+              << "  speedup: " << sw_ref.getClockTime() / sw_fast.getClockTime() << std::endl;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Size n = argc > 1 ? String(argv[1]).toInt() : 100000;
+  Size repetitions = argc > 2 ? String(argv[2]).toInt() : 100;
+
+  runBenchmark<float>("32 bit float", n, repetitions, false);
+  runBenchmark<float>("32 bit float", n, repetitions, true);
+  runBenchmark<double>("64 bit float", n, repetitions, false);
+  runBenchmark<double>("64 bit float", n, repetitions, true);
+
+  return 0;
+}
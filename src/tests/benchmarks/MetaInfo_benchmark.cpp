@@ -0,0 +1,117 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/METADATA/MetaInfoInterface.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <iostream>
+#include <vector>
+
+using namespace OpenMS;
+
+// Measures the throughput of MetaInfoInterface::setMetaValue (by name, thus
+// including the MetaInfoRegistry lookup) and getMetaValue with an increasing
+// number of threads. Every thread works on its own objects, so the only
+// shared state is the MetaInfoRegistry.
+//
+// Usage: MetaInfo_benchmark [number of objects per thread] [repetitions]
+
+namespace
+{
+  const char* META_NAMES[] =
+  {
+    "charge", "RT", "MZ", "label", "spectrum_reference",
+    "bench_score", "bench_quality", "bench_width", "bench_area", "bench_flag"
+  };
+  const Size NR_META_NAMES = sizeof(META_NAMES) / sizeof(META_NAMES[0]);
+
+  double runBenchmark(int nr_threads, Size nr_objects, Size repetitions)
+  {
+    std::vector<String> names(META_NAMES, META_NAMES + NR_META_NAMES);
+    double checksum = 0;
+
+    StopWatch sw;
+    sw.start();
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads) reduction(+:checksum)
+#endif
+    {
+      std::vector<MetaInfoInterface> objects(nr_objects);
+      for (Size r = 0; r < repetitions; ++r)
+      {
+        for (Size i = 0; i < nr_objects; ++i)
+        {
+          for (Size k = 0; k < NR_META_NAMES; ++k)
+          {
+            objects[i].setMetaValue(names[k], double(i + k + r));
+          }
+          checksum += (double)objects[i].getMetaValue(names[r % NR_META_NAMES]);
+        }
+      }
+    }
+    sw.stop();
+
+    if (checksum < 0) std::cout << checksum << std::endl; // keep the compiler from optimizing the loop away
+    return sw.getClockTime();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Size nr_objects = argc > 1 ? String(argv[1]).toInt() : 10000;
+  Size repetitions = argc > 2 ? String(argv[2]).toInt() : 20;
+
+  int max_threads = 1;
+#ifdef _OPENMP
+  max_threads = omp_get_max_threads();
+#endif
+
+  double single_thread_rate = 0;
+  for (int nr_threads = 1; nr_threads <= max_threads; nr_threads *= 2)
+  {
+    double time = runBenchmark(nr_threads, nr_objects, repetitions);
+    double rate = (double)nr_threads * nr_objects * repetitions * NR_META_NAMES / time;
+    if (nr_threads == 1) single_thread_rate = rate;
+    std::cout << nr_threads << " thread(s)"
+              << "  setMetaValue: " << rate / 1.0e6 << " M/s"
+              << "  scaling: " << rate / single_thread_rate << std::endl;
+  }
+
+  return 0;
+}
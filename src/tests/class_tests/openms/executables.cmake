@@ -11,6 +11,7 @@ set(concept_executables_list
   VersionInfo_test
   LogConfigHandler_test
   LogStream_test
+  ParallelSort_test
   UnaryComposeFunctionAdapter_test
   UniqueIdGenerator_test
   UniqueIdIndexer_test
@@ -20,6 +21,7 @@ set(concept_executables_list
 set(datastructures_executables_list
   Adduct_test
   #BinaryTreeNode_test
+  BoundingBoxIndex_test
   CalibrationData_test
   ClusteringGrid_test
   CVMappingRule_test
@@ -120,6 +122,7 @@ set(kernel_executables_list
   BaseFeature_test
   ChromatogramPeak_test
   ChromatogramTools_test
+  ColumnarSpectrum_test
   ComparatorUtils_test
   ConsensusFeature_test
   ConsensusMap_test
@@ -153,6 +156,7 @@ set(format_executables_list
   Bzip2Ifstream_test
   Bzip2InputStream_test
   CVMappingFile_test
+  ColumnarFeatureFile_test
   CompressedInputSource_test
   ConsensusXMLFile_test
   ControlledVocabulary_test
@@ -178,6 +182,8 @@ set(format_executables_list
   LibSVMEncoder_test
   MS2File_test
   MSPFile_test
+  MappedFASTAFile_test
+  MappedFileHelper_test
   MascotGenericFile_test
   MascotInfile_test
   MascotRemoteQuery_test
@@ -290,6 +296,7 @@ set(filtering_executables_list
   LowessSmoothing_test
   MarkerMower_test
   MassTraceDetection_test
+  MassTraceDetectionConsumer_test
   MorphologicalFilter_test
   MultiplexClustering_test
   MultiplexDeltaMasses_test
@@ -351,6 +358,7 @@ set(comparison_executables_list
 set(chemistry_executables_list
   AAIndex_test
   AASequence_test
+  CompactPeptide_test
   ElementDB_test
   Element_test
   EmpiricalFormula_test
@@ -361,6 +369,7 @@ set(chemistry_executables_list
   FastaIteratorIntern_test
   FastaIterator_test
   IsotopeDistribution_test
+  IsotopeDistributionTable_test
   ModificationDefinition_test
   ModificationDefinitionsSet_test
   ModificationsDB_test
@@ -425,6 +434,7 @@ set(analysis_executables_list
   FeatureGroupingAlgorithmUnlabeled_test
   FeatureGroupingAlgorithm_test
   FeatureHandle_test
+  FragmentIonIndex_test
   HiddenMarkovModel_test
   IDMapper_test
   IDRipper_test
@@ -474,6 +484,7 @@ set(analysis_executables_list
   ProteinInference_test
   ProtonDistributionModel_test
   ProteinResolver_test
+  ProteinSuffixArrayIndex_test
   PSLPFormulation_test
   PSProteinInference_test
   QTClusterFinder_test
@@ -606,6 +617,7 @@ if(NOT DISABLE_OPENSWATH)
     SpectrumHelpers_test
     StatsHelpers_test
     CachedMzML_test
+    MappedCachedMzML_test
   )
 endif(NOT DISABLE_OPENSWATH)
 
@@ -502,6 +502,139 @@ START_SECTION((template <typename FromType> void encodeIntegers(std::vector<From
 }
 END_SECTION
 
+START_SECTION((template <typename ToType> void decodeFast(const char* in, Size in_length, ByteOrder from_byte_order, std::vector<ToType>& out, bool zlib_compression = false)))
+{
+  TOLERANCE_ABSOLUTE(0.001)
+  Base64 b64;
+  String src;
+  std::vector<float> res;
+  std::vector<double> res_double;
+
+  b64.decodeFast(src.c_str(), src.size(), Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 0)
+
+  src = "QvAAAELIAA==";
+  b64.decodeFast(src.c_str(), src.size(), Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 2)
+  TEST_REAL_SIMILAR(res[0], 120)
+  TEST_REAL_SIMILAR(res[1], 100)
+
+  src = "Q+vIuEec9YBD7TgoR/HTgEPt23hHA8UA";
+  b64.decodeFast(src.c_str(), src.size(), Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 6)
+  TEST_REAL_SIMILAR(res[0], 471.568)
+  TEST_REAL_SIMILAR(res[1], 80363)
+  TEST_REAL_SIMILAR(res[2], 474.439)
+  TEST_REAL_SIMILAR(res[3], 123815)
+  TEST_REAL_SIMILAR(res[4], 475.715)
+  TEST_REAL_SIMILAR(res[5], 33733)
+
+  src = "JhOWQ8b/l0PMTJhD";
+  b64.decodeFast(src.c_str(), src.size(), Base64::BYTEORDER_LITTLEENDIAN, res);
+  TEST_REAL_SIMILAR(res[0], 300.15)
+  TEST_REAL_SIMILAR(res[1], 303.998)
+  TEST_REAL_SIMILAR(res[2], 304.6)
+
+  src = "QHLCZmZmZmZAcv/3ztkWh0BzCZmZmZma";
+  b64.decodeFast(src.c_str(), src.size(), Base64::BYTEORDER_BIGENDIAN, res_double);
+  TEST_EQUAL(res_double.size(), 3)
+  TEST_REAL_SIMILAR(res_double[0], 300.15)
+  TEST_REAL_SIMILAR(res_double[1], 303.998)
+  TEST_REAL_SIMILAR(res_double[2], 304.6)
+
+  // too short strings are ignored
+  src = "==";
+  b64.decodeFast(src.c_str(), src.size(), Base64::BYTEORDER_BIGENDIAN, res);
+  TEST_EQUAL(res.size(), 0)
+
+  // long arrays (exercising the vectorized code path) give the same result as decode()
+  for (Size compression = 0; compression < 2; ++compression)
+  {
+    std::vector<double> data_double, decoded_double;
+    std::vector<float> data_float, decoded_float;
+    for (Size i = 0; i < 1001; ++i)
+    {
+      data_double.push_back(400.0 + i * 0.0137);
+      data_float.push_back(1000.0f * (i % 17));
+    }
+    std::vector<double> data_double_copy = data_double;
+    std::vector<float> data_float_copy = data_float;
+
+    b64.encode(data_double_copy, Base64::BYTEORDER_LITTLEENDIAN, src, compression == 1);
+    b64.decode(src, Base64::BYTEORDER_LITTLEENDIAN, res_double, compression == 1);
+    b64.decodeFast(src, Base64::BYTEORDER_LITTLEENDIAN, decoded_double, compression == 1);
+    TEST_EQUAL(decoded_double.size(), data_double.size())
+    TEST_EQUAL(decoded_double == res_double, true)
+    TEST_EQUAL(decoded_double == data_double, true)
+
+    b64.encode(data_float_copy, Base64::BYTEORDER_BIGENDIAN, src, compression == 1);
+    b64.decode(src, Base64::BYTEORDER_BIGENDIAN, res, compression == 1);
+    b64.decodeFast(src, Base64::BYTEORDER_BIGENDIAN, decoded_float, compression == 1);
+    TEST_EQUAL(decoded_float.size(), data_float.size())
+    TEST_EQUAL(decoded_float == res, true)
+    TEST_EQUAL(decoded_float == data_float, true)
+  }
+
+  // integers
+  std::vector<Int32> ints, ints_out;
+  for (Int32 i = -500; i < 500; ++i) ints.push_back(i * 7);
+  std::vector<Int32> ints_copy = ints;
+  b64.encodeIntegers(ints_copy, Base64::BYTEORDER_LITTLEENDIAN, src, true);
+  b64.decodeFast(src, Base64::BYTEORDER_LITTLEENDIAN, ints_out, true);
+  TEST_EQUAL(ints_out == ints, true)
+
+  // corrupted data (invalid characters at the beginning, in the middle and at the end)
+  src = "whoPutMeHere:somecrazyperson,obviously!WhatifIcontaininvalidcharacterslikethese";
+  TEST_EXCEPTION(Exception::ConversionError, b64.decodeFast(src, Base64::BYTEORDER_BIGENDIAN, res))
+  src = String(200, 'A') + "A.AA" + String(200, 'A');
+  TEST_EXCEPTION(Exception::ConversionError, b64.decodeFast(src, Base64::BYTEORDER_BIGENDIAN, res_double))
+  src = String(400, 'A') + "A A=";
+  TEST_EXCEPTION(Exception::ConversionError, b64.decodeFast(src, Base64::BYTEORDER_BIGENDIAN, res))
+  src = "Q+vIuEec9YBD7TgoR/HTgEPt23hHA8U";
+  TEST_EXCEPTION(Exception::ConversionError, b64.decodeFast(src, Base64::BYTEORDER_BIGENDIAN, res))
+  // valid Base64 but not a zlib stream
+  src = "Q+vIuEec9YBD7TgoR/HTgEPt23hHA8UA";
+  TEST_EXCEPTION(Exception::ConversionError, b64.decodeFast(src, Base64::BYTEORDER_BIGENDIAN, res, true))
+  // incomplete elements are ignored (as in decode())
+  src = "QvAAAELIAA==";
+  b64.decodeFast(src, Base64::BYTEORDER_BIGENDIAN, res_double);
+  TEST_EQUAL(res_double.size(), 1)
+}
+END_SECTION
+
+START_SECTION((template <typename ToType> void decodeFast(const String& in, ByteOrder from_byte_order, std::vector<ToType>& out, bool zlib_compression = false)))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((static Size decodedSize(const char* in, Size in_length)))
+{
+  String src = "QvAAAELIAA==";
+  TEST_EQUAL(Base64::decodedSize(src.c_str(), src.size()), 7)
+  src = "QvAAAELIAAA=";
+  TEST_EQUAL(Base64::decodedSize(src.c_str(), src.size()), 8)
+  src = "QvAAAELIAAAA";
+  TEST_EQUAL(Base64::decodedSize(src.c_str(), src.size()), 9)
+  src = "QvAAAELIAAA";
+  TEST_EXCEPTION(Exception::ConversionError, Base64::decodedSize(src.c_str(), src.size()))
+}
+END_SECTION
+
+START_SECTION((static Size decodeRaw(const char* in, Size in_length, unsigned char* out)))
+{
+  // "Hello, World!" with one padding character, repeated to exceed the vector width
+  String text, src;
+  for (Size i = 0; i < 10; ++i) text += "Hello, World! ";
+  std::vector<String> in(1, text);
+  Base64().encodeStrings(in, src, false, false);
+  std::vector<unsigned char> out(Base64::decodedSize(src.c_str(), src.size()));
+  TEST_EQUAL(out.size(), text.size())
+  TEST_EQUAL(Base64::decodeRaw(src.c_str(), src.size(), &out[0]), text.size())
+  TEST_EQUAL(String(out.begin(), out.end()), text)
+}
+END_SECTION
+
 ptr = new Base64;
 
 START_SECTION(inline UInt32 endianize32(const UInt32& n))
@@ -0,0 +1,194 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/DATASTRUCTURES/BoundingBoxIndex.h>
+///////////////////////////
+
+#include <cstdlib>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(BoundingBoxIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+typedef BoundingBoxIndex::BoxType BoxType;
+typedef BoundingBoxIndex::PositionType PositionType;
+
+BoundingBoxIndex* ptr = 0;
+BoundingBoxIndex* null_ptr = 0;
+START_SECTION((BoundingBoxIndex()))
+{
+  ptr = new BoundingBoxIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION((virtual ~BoundingBoxIndex()))
+{
+  delete ptr;
+}
+END_SECTION
+
+// boxes: [0] (0,0)-(10,10), [1] (5,5)-(15,15), [2] invalid, [3] point (20,20)
+std::vector<BoxType> boxes;
+boxes.push_back(BoxType(PositionType(0, 0), PositionType(10, 10)));
+boxes.push_back(BoxType(PositionType(5, 5), PositionType(15, 15)));
+boxes.push_back(BoxType());
+boxes.push_back(BoxType(PositionType(20, 20), PositionType(20, 20)));
+
+START_SECTION((BoundingBoxIndex(const std::vector<BoxType>& boxes)))
+{
+  BoundingBoxIndex index(boxes);
+  TEST_EQUAL(index.size(), 3)
+}
+END_SECTION
+
+START_SECTION((void build(const std::vector<BoxType>& boxes)))
+{
+  BoundingBoxIndex index;
+  index.build(boxes);
+  TEST_EQUAL(index.size(), 3)
+  index.build(std::vector<BoxType>(1, boxes[0]));
+  TEST_EQUAL(index.size(), 1)
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  BoundingBoxIndex index(boxes);
+  index.clear();
+  TEST_EQUAL(index.size(), 0)
+  std::vector<Size> result(1, 0);
+  index.query(PositionType(5, 5), result);
+  TEST_EQUAL(result.empty(), true)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(BoundingBoxIndex().size(), 0)
+  TEST_EQUAL(BoundingBoxIndex(boxes).size(), 3)
+}
+END_SECTION
+
+START_SECTION((bool empty() const))
+{
+  TEST_EQUAL(BoundingBoxIndex().empty(), true)
+  TEST_EQUAL(BoundingBoxIndex(std::vector<BoxType>(2)).empty(), true)
+  TEST_EQUAL(BoundingBoxIndex(boxes).empty(), false)
+}
+END_SECTION
+
+START_SECTION((const BoxType& getBoundingBox() const))
+{
+  BoundingBoxIndex index(boxes);
+  TEST_REAL_SIMILAR(index.getBoundingBox().minPosition()[0], 0)
+  TEST_REAL_SIMILAR(index.getBoundingBox().minPosition()[1], 0)
+  TEST_REAL_SIMILAR(index.getBoundingBox().maxPosition()[0], 20)
+  TEST_REAL_SIMILAR(index.getBoundingBox().maxPosition()[1], 20)
+}
+END_SECTION
+
+START_SECTION((void query(const PositionType& position, std::vector<Size>& result) const))
+{
+  BoundingBoxIndex index(boxes);
+  std::vector<Size> result;
+  index.query(PositionType(7, 7), result);
+  TEST_EQUAL(result.size(), 2)
+  ABORT_IF(result.size() != 2)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 1)
+  // borders are included
+  index.query(PositionType(15, 5), result);
+  TEST_EQUAL(result.size(), 1)
+  ABORT_IF(result.size() != 1)
+  TEST_EQUAL(result[0], 1)
+  index.query(PositionType(20, 20), result);
+  TEST_EQUAL(result.size(), 1)
+  ABORT_IF(result.size() != 1)
+  TEST_EQUAL(result[0], 3)
+  index.query(PositionType(16, 5), result);
+  TEST_EQUAL(result.empty(), true)
+
+  // compare with a linear scan on a larger data set (several tree levels)
+  srand(1);
+  std::vector<BoxType> many;
+  for (Size i = 0; i < 5000; ++i)
+  {
+    double x = rand() % 1000, y = rand() % 1000;
+    many.push_back(BoxType(PositionType(x, y), PositionType(x + rand() % 50, y + rand() % 10)));
+  }
+  index.build(many);
+  bool same = true;
+  for (Size q = 0; q < 1000; ++q)
+  {
+    PositionType pos(rand() % 1050, rand() % 1010);
+    std::vector<Size> expected;
+    for (Size i = 0; i < many.size(); ++i)
+    {
+      if (many[i].encloses(pos)) expected.push_back(i);
+    }
+    index.query(pos, result);
+    same = same && (result == expected);
+  }
+  TEST_EQUAL(same, true)
+}
+END_SECTION
+
+START_SECTION((void query(const BoxType& box, std::vector<Size>& result) const))
+{
+  BoundingBoxIndex index(boxes);
+  std::vector<Size> result;
+  index.query(BoxType(PositionType(12, 12), PositionType(25, 25)), result);
+  TEST_EQUAL(result.size(), 2)
+  ABORT_IF(result.size() != 2)
+  TEST_EQUAL(result[0], 1)
+  TEST_EQUAL(result[1], 3)
+  index.query(BoxType(PositionType(-5, -5), PositionType(-1, 30)), result);
+  TEST_EQUAL(result.empty(), true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
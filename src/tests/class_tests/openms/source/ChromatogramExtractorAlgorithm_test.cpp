@@ -151,6 +151,64 @@ START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input
 }
 END_SECTION
 
+START_SECTION(void extractChromatogramsBatch(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, const std::vector< ExtractionCoordinates > &extraction_coordinates, double mz_extraction_window, bool ppm, String filter))
+{
+  double extract_window = 0.05;
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  ChromatogramExtractorAlgorithm extractor;
+
+  // coordinates do not need to be sorted, output[k] belongs to coordinates[k]
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  std::vector< OpenSwath::ChromatogramPtr > out_exp;
+  for (int i = 0; i < 3; i++)
+  {
+    OpenSwath::ChromatogramPtr s(new OpenSwath::Chromatogram);
+    out_exp.push_back(s);
+  }
+
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 654.38; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr3";
+    coordinates.push_back(coord);
+    coord.mz = 618.31; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr1";
+    coordinates.push_back(coord);
+    coord.mz = 628.45; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr2";
+    coordinates.push_back(coord);
+  }
+  extractor.extractChromatogramsBatch(expptr, out_exp, coordinates, extract_window, false, "tophat");
+
+  double expected_max[] = {577.33, 35.593, 169.792};
+  double expected_rt[] = {3120.26, 3055.16, 3120.26};
+  for (Size k = 0; k < out_exp.size(); k++)
+  {
+    OpenSwath::ChromatogramPtr chrom = out_exp[k];
+    TEST_EQUAL(chrom->getTimeArray()->data.size(), 59);
+    TEST_EQUAL(chrom->getIntensityArray()->data.size(), 59);
+
+    double max_value = -1; double foundat = -1;
+    for (Size i = 0; i < chrom->getTimeArray()->data.size(); i++)
+    {
+      double rt = chrom->getTimeArray()->data[i];
+      double in = chrom->getIntensityArray()->data[i];
+      if (in > max_value)
+      {
+        max_value = in;
+        foundat = rt;
+      }
+    }
+    TEST_REAL_SIMILAR(max_value, expected_max[k]);
+    TEST_REAL_SIMILAR(foundat, expected_rt[k]);
+  }
+
+  // sizes need to match
+  out_exp.pop_back();
+  TEST_EXCEPTION(Exception::IllegalArgument, extractor.extractChromatogramsBatch(expptr, out_exp, coordinates, extract_window, false, "tophat"));
+}
+END_SECTION
+
 ///////////////////////////////////////////////////////////////////////////
 /// Private functions
 ///////////////////////////////////////////////////////////////////////////
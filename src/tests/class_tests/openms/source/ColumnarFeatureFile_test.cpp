@@ -0,0 +1,402 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/ColumnarFeatureFile.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/METADATA/DataProcessing.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <fstream>
+#include <iterator>
+
+using namespace OpenMS;
+using namespace std;
+
+FeatureMap createFeatureMap()
+{
+  FeatureMap map;
+  map.setIdentifier("feature_map");
+  map.setUniqueId(17);
+  map.setMetaValue("spectra_data", DataValue(ListUtils::create<String>("raw.mzML")));
+  map.getProteinIdentifications().resize(1);
+  map.getProteinIdentifications()[0].setIdentifier("run_1");
+  map.getProteinIdentifications()[0].setSearchEngine("engine");
+  map.getProteinIdentifications()[0].getHits().resize(1);
+  map.getProteinIdentifications()[0].getHits()[0].setAccession("P1");
+  map.getUnassignedPeptideIdentifications().resize(1);
+  map.getUnassignedPeptideIdentifications()[0].setIdentifier("run_1");
+  map.getUnassignedPeptideIdentifications()[0].setRT(1234.5);
+  map.getDataProcessing().resize(1);
+  map.getDataProcessing()[0].getSoftware().setName("FeatureFinder");
+  map.getDataProcessing()[0].getProcessingActions().insert(DataProcessing::QUANTITATION);
+
+  for (Size i = 0; i < 4; ++i)
+  {
+    Feature f;
+    f.setRT(100.0 * (i + 1));
+    f.setMZ(400.0 + i);
+    f.setIntensity(1000.0f * (i + 1));
+    f.setCharge(i + 1);
+    f.setOverallQuality(0.5 + 0.1 * i);
+    f.setQuality(0, 0.25);
+    f.setQuality(1, 0.75);
+    f.setWidth(5.0);
+    f.setUniqueId(100 + i);
+    if (i == 1)
+    {
+      // convex hull, meta value, subordinate and peptide identification
+      ConvexHull2D hull;
+      ConvexHull2D::PointArrayType points(2);
+      points[0][0] = 190.0;
+      points[0][1] = 401.0;
+      points[1][0] = 210.0;
+      points[1][1] = 401.5;
+      hull.setHullPoints(points);
+      f.getConvexHulls().push_back(hull);
+      f.setMetaValue("label", "second");
+      f.setMetaValue("score", 3.5);
+      Feature sub;
+      sub.setMZ(401.5);
+      sub.setMetaValue("isotope", 1);
+      f.getSubordinates().push_back(sub);
+      PeptideIdentification id;
+      id.setScoreType("q-value");
+      PeptideHit hit;
+      hit.setSequence(AASequence::fromString("PEPTIDER"));
+      hit.setCharge(2);
+      hit.setScore(0.01);
+      id.insertHit(hit);
+      f.getPeptideIdentifications().push_back(id);
+    }
+    map.push_back(f);
+  }
+  map.updateRanges();
+  return map;
+}
+
+ConsensusMap createConsensusMap()
+{
+  ConsensusMap map;
+  map.setIdentifier("consensus_map");
+  map.setExperimentType("label-free");
+  map.getFileDescriptions()[0].filename = "a.featureXML";
+  map.getFileDescriptions()[0].size = 2;
+  map.getFileDescriptions()[3].filename = "b.featureXML";
+  map.getFileDescriptions()[3].label = "heavy";
+  map.getFileDescriptions()[3].setMetaValue("channel", 3);
+
+  for (Size i = 0; i < 3; ++i)
+  {
+    ConsensusFeature f;
+    f.setRT(50.0 * (i + 1));
+    f.setMZ(600.0 + i);
+    f.setIntensity(200.0f * (i + 1));
+    f.setCharge(2);
+    f.setQuality(0.9);
+    f.setUniqueId(200 + i);
+    // consensus feature 2 has no handles
+    for (UInt64 j = 0; i != 2 && j < i + 1; ++j)
+    {
+      FeatureHandle h;
+      h.setMapIndex(j == 0 ? 0 : 3);
+      h.setUniqueId(10 * i + j);
+      h.setRT(50.0 * (i + 1) + j);
+      h.setMZ(600.0 + i);
+      h.setIntensity(100.0f);
+      h.setCharge(2);
+      f.insert(h);
+    }
+    if (i == 0)
+    {
+      f.setMetaValue("ratio", 1.5);
+    }
+    map.push_back(f);
+  }
+  map.updateRanges();
+  return map;
+}
+
+START_TEST(ColumnarFeatureFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FeatureMap feature_map = createFeatureMap();
+ConsensusMap consensus_map = createConsensusMap();
+std::string feature_filename, consensus_filename;
+NEW_TMP_FILE(feature_filename);
+NEW_TMP_FILE(consensus_filename);
+
+ColumnarFeatureFile* ptr = 0;
+ColumnarFeatureFile* nullPointer = 0;
+
+START_SECTION((static void store(const String& filename, const FeatureMap& feature_map)))
+{
+  ColumnarFeatureFile::store(feature_filename, feature_map);
+  TEST_EQUAL(ColumnarFeatureFile::getTypeByContent(feature_filename), FileTypes::FEATUREBIN)
+}
+END_SECTION
+
+START_SECTION((static void store(const String& filename, const ConsensusMap& consensus_map)))
+{
+  ColumnarFeatureFile::store(consensus_filename, consensus_map);
+  TEST_EQUAL(ColumnarFeatureFile::getTypeByContent(consensus_filename), FileTypes::CONSENSUSBIN)
+}
+END_SECTION
+
+START_SECTION((static FileTypes::Type getTypeByContent(const String& filename)))
+{
+  TEST_EQUAL(ColumnarFeatureFile::getTypeByContent(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML")), FileTypes::UNKNOWN)
+  TEST_EQUAL(ColumnarFeatureFile::getTypeByContent("this_file_does_not_exist.featureBin"), FileTypes::UNKNOWN)
+}
+END_SECTION
+
+START_SECTION((explicit ColumnarFeatureFile(const String& filename)))
+{
+  ptr = new ColumnarFeatureFile(feature_filename);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getFilename(), feature_filename)
+
+  TEST_EXCEPTION(Exception::FileNotFound, ColumnarFeatureFile("this_file_does_not_exist.featureBin"))
+  TEST_EXCEPTION(Exception::ParseError, ColumnarFeatureFile(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML")))
+
+  // a truncated file (directory missing) is detected
+  std::string truncated_filename;
+  NEW_TMP_FILE(truncated_filename);
+  {
+    std::ifstream ifs(feature_filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    std::ofstream ofs(truncated_filename.c_str(), std::ios::binary);
+    ofs.write(content.c_str(), content.size() - 40);
+  }
+  TEST_EXCEPTION(Exception::ParseError, ColumnarFeatureFile(String(truncated_filename)))
+}
+END_SECTION
+
+START_SECTION((~ColumnarFeatureFile()))
+{
+  delete ptr;
+}
+END_SECTION
+
+ColumnarFeatureFile feature_file(feature_filename);
+ColumnarFeatureFile consensus_file(consensus_filename);
+
+START_SECTION((MapKind getMapKind() const))
+{
+  TEST_EQUAL(feature_file.getMapKind(), ColumnarFeatureFile::FEATURE_MAP)
+  TEST_EQUAL(consensus_file.getMapKind(), ColumnarFeatureFile::CONSENSUS_MAP)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  TEST_EQUAL(feature_file.size(), 4)
+  TEST_EQUAL(consensus_file.size(), 3)
+}
+END_SECTION
+
+START_SECTION((bool hasBlock(BlockId id) const))
+{
+  TEST_EQUAL(feature_file.hasBlock(ColumnarFeatureFile::RT), true)
+  TEST_EQUAL(feature_file.hasBlock(ColumnarFeatureFile::HULL_DATA), true)
+  TEST_EQUAL(feature_file.hasBlock(ColumnarFeatureFile::HANDLE_OFFSETS), false)
+  TEST_EQUAL(consensus_file.hasBlock(ColumnarFeatureFile::HANDLE_OFFSETS), true)
+  // empty side tables are not written
+  TEST_EQUAL(consensus_file.hasBlock(ColumnarFeatureFile::PEPTIDE_OFFSETS), false)
+  TEST_EQUAL(consensus_file.hasBlock(ColumnarFeatureFile::META_OFFSETS), true)
+}
+END_SECTION
+
+START_SECTION((const double* getRT() const))
+{
+  TEST_REAL_SIMILAR(feature_file.getRT()[2], 300.0)
+  TEST_REAL_SIMILAR(consensus_file.getRT()[1], 100.0)
+}
+END_SECTION
+
+START_SECTION((const double* getMZ() const))
+{
+  TEST_REAL_SIMILAR(feature_file.getMZ()[3], 403.0)
+  TEST_REAL_SIMILAR(consensus_file.getMZ()[2], 602.0)
+}
+END_SECTION
+
+START_SECTION((const float* getIntensity() const))
+{
+  TEST_REAL_SIMILAR(feature_file.getIntensity()[1], 2000.0)
+}
+END_SECTION
+
+START_SECTION((const Int32* getCharge() const))
+{
+  TEST_EQUAL(feature_file.getCharge()[3], 4)
+}
+END_SECTION
+
+START_SECTION((const float* getQuality() const))
+{
+  TEST_REAL_SIMILAR(feature_file.getQuality()[2], 0.7)
+}
+END_SECTION
+
+START_SECTION((void getFeature(Size index, Feature& feature) const))
+{
+  Feature f;
+  feature_file.getFeature(1, f);
+  TEST_EQUAL(f == feature_map[1], true)
+  TEST_EQUAL(f.getConvexHulls().size(), 1)
+  TEST_EQUAL(f.getSubordinates().size(), 1)
+  TEST_EQUAL(f.getSubordinates()[0].getMetaValue("isotope"), 1)
+  TEST_EQUAL(f.getPeptideIdentifications()[0].getHits()[0].getSequence().toString(), "PEPTIDER")
+  TEST_EQUAL(f.getMetaValue("label"), "second")
+
+  feature_file.getFeature(0, f);
+  TEST_EQUAL(f == feature_map[0], true)
+
+  TEST_EXCEPTION(Exception::ParseError, consensus_file.getFeature(0, f))
+}
+END_SECTION
+
+START_SECTION((void getConsensusFeature(Size index, ConsensusFeature& feature) const))
+{
+  ConsensusFeature f;
+  for (Size i = 0; i < consensus_map.size(); ++i)
+  {
+    consensus_file.getConsensusFeature(i, f);
+    TEST_EQUAL(f == consensus_map[i], true)
+  }
+  consensus_file.getConsensusFeature(1, f);
+  TEST_EQUAL(f.size(), 2)
+  TEST_EQUAL(f.begin()->getUniqueId(), 10)
+
+  TEST_EXCEPTION(Exception::ParseError, feature_file.getConsensusFeature(0, f))
+}
+END_SECTION
+
+START_SECTION((void load(FeatureMap& feature_map) const))
+{
+  FeatureMap loaded;
+  feature_file.load(loaded);
+  TEST_EQUAL(loaded.size(), feature_map.size())
+  TEST_EQUAL(loaded.getIdentifier(), "feature_map")
+  TEST_EQUAL(loaded.getUniqueId(), 17)
+  TEST_EQUAL(loaded.getMetaValue("spectra_data").toStringList()[0], "raw.mzML")
+  TEST_EQUAL(loaded.getProteinIdentifications() == feature_map.getProteinIdentifications(), true)
+  TEST_EQUAL(loaded.getUnassignedPeptideIdentifications() == feature_map.getUnassignedPeptideIdentifications(), true)
+  TEST_EQUAL(loaded.getDataProcessing() == feature_map.getDataProcessing(), true)
+  TEST_EQUAL(loaded.getLoadedFilePath(), feature_filename)
+  for (Size i = 0; i < loaded.size(); ++i)
+  {
+    TEST_EQUAL(loaded[i] == feature_map[i], true)
+  }
+
+  // options
+  ColumnarFeatureFile file(feature_filename);
+  file.getOptions().setRTRange(DRange<1>(150.0, 350.0));
+  file.getOptions().setLoadConvexHull(false);
+  file.getOptions().setLoadSubordinates(false);
+  file.load(loaded);
+  TEST_EQUAL(loaded.size(), 2)
+  TEST_REAL_SIMILAR(loaded[0].getRT(), 200.0)
+  TEST_EQUAL(loaded[0].getConvexHulls().size(), 0)
+  TEST_EQUAL(loaded[0].getSubordinates().size(), 0)
+  TEST_EQUAL(loaded[0].getPeptideIdentifications().size(), 1)
+
+  file.getOptions().setMetadataOnly(true);
+  file.load(loaded);
+  TEST_EQUAL(loaded.size(), 0)
+  TEST_EQUAL(loaded.getIdentifier(), "feature_map")
+
+  ConsensusMap wrong_kind;
+  TEST_EXCEPTION(Exception::ParseError, feature_file.load(wrong_kind))
+}
+END_SECTION
+
+START_SECTION((void load(ConsensusMap& consensus_map) const))
+{
+  ConsensusMap loaded;
+  consensus_file.load(loaded);
+  TEST_EQUAL(loaded.size(), consensus_map.size())
+  TEST_EQUAL(loaded.getIdentifier(), "consensus_map")
+  TEST_EQUAL(loaded.getExperimentType(), "label-free")
+  TEST_EQUAL(loaded.getFileDescriptions().size(), 2)
+  TEST_EQUAL(loaded.getFileDescriptions()[3].label, "heavy")
+  TEST_EQUAL(loaded.getFileDescriptions()[3].getMetaValue("channel"), 3)
+  TEST_EQUAL(loaded.getFileDescriptions()[0].size, 2)
+  for (Size i = 0; i < loaded.size(); ++i)
+  {
+    TEST_EQUAL(loaded[i] == consensus_map[i], true)
+  }
+
+  ColumnarFeatureFile file(consensus_filename);
+  file.getOptions().setMZRange(DRange<1>(600.5, 700.0));
+  file.load(loaded);
+  TEST_EQUAL(loaded.size(), 2)
+  TEST_REAL_SIMILAR(loaded[0].getMZ(), 601.0)
+}
+END_SECTION
+
+START_SECTION((FeatureFileOptions& getOptions()))
+{
+  ColumnarFeatureFile file(feature_filename);
+  file.getOptions().setLoadConvexHull(false);
+  TEST_EQUAL(file.getOptions().getLoadConvexHull(), false)
+}
+END_SECTION
+
+START_SECTION((const FeatureFileOptions& getOptions() const))
+{
+  TEST_EQUAL(feature_file.getOptions().getLoadConvexHull(), true)
+}
+END_SECTION
+
+START_SECTION((const String& getFilename() const))
+{
+  TEST_EQUAL(consensus_file.getFilename(), consensus_filename)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
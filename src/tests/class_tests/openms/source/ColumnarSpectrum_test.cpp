@@ -0,0 +1,380 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/ColumnarSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ColumnarSpectrum, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ColumnarSpectrum* ptr = 0;
+ColumnarSpectrum* nullPointer = 0;
+START_SECTION(ColumnarSpectrum())
+{
+  ptr = new ColumnarSpectrum();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_REAL_SIMILAR(ptr->getRT(), -1.0)
+  TEST_EQUAL(ptr->getMSLevel(), 1)
+}
+END_SECTION
+
+START_SECTION(virtual ~ColumnarSpectrum())
+{
+  delete ptr;
+}
+END_SECTION
+
+MSSpectrum<> spec;
+spec.setRT(12.5);
+spec.setMSLevel(2);
+spec.setName("spec");
+spec.getFloatDataArrays().resize(1);
+for (Size i = 0; i < 5; ++i)
+{
+  Peak1D p;
+  p.setMZ(500.0 + i);
+  p.setIntensity(10.0f * (i + 1));
+  spec.push_back(p);
+  spec.getFloatDataArrays()[0].push_back(0.5f * i);
+}
+
+START_SECTION(explicit ColumnarSpectrum(const MSSpectrum<Peak1D>& spectrum))
+{
+  ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.size(), 5)
+  TEST_REAL_SIMILAR(cs.getRT(), 12.5)
+  TEST_EQUAL(cs.getMSLevel(), 2)
+  TEST_EQUAL(cs.getName(), "spec")
+  TEST_EQUAL(cs.getFloatDataArrays().size(), 1)
+  TEST_REAL_SIMILAR(cs[3].getMZ(), 503.0)
+  TEST_REAL_SIMILAR(cs[3].getIntensity(), 40.0)
+  TEST_REAL_SIMILAR(cs.getMZData()[4], 504.0)
+  TEST_REAL_SIMILAR(cs.getIntensityData()[0], 10.0)
+}
+END_SECTION
+
+START_SECTION(ColumnarSpectrum(const ColumnarSpectrum& source))
+{
+  ColumnarSpectrum cs(spec);
+  ColumnarSpectrum cs2(cs);
+  TEST_EQUAL(cs2 == cs, true)
+  cs2[0].setMZ(1.0);
+  // deep copy
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 500.0)
+  TEST_EQUAL(cs2 != cs, true)
+}
+END_SECTION
+
+START_SECTION(ColumnarSpectrum& operator=(const ColumnarSpectrum& source))
+{
+  ColumnarSpectrum cs(spec);
+  ColumnarSpectrum cs2;
+  cs2 = cs;
+  TEST_EQUAL(cs2 == cs, true)
+  cs2[0].setIntensity(1.0);
+  TEST_REAL_SIMILAR(cs[0].getIntensity(), 10.0)
+}
+END_SECTION
+
+START_SECTION(bool operator==(const ColumnarSpectrum& rhs) const)
+{
+  ColumnarSpectrum cs(spec), cs2(spec);
+  TEST_EQUAL(cs == cs2, true)
+  cs2.setRT(5.0);
+  TEST_EQUAL(cs == cs2, false)
+}
+END_SECTION
+
+START_SECTION(bool operator!=(const ColumnarSpectrum& rhs) const)
+{
+  ColumnarSpectrum cs(spec), cs2(spec);
+  TEST_EQUAL(cs != cs2, false)
+  cs2.push_back(600.0, 1.0);
+  TEST_EQUAL(cs != cs2, true)
+}
+END_SECTION
+
+START_SECTION(explicit ColumnarSpectrum(const OpenSwath::SpectrumPtr& sptr))
+{
+  OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+  sptr->getMZArray()->data.push_back(100.0);
+  sptr->getMZArray()->data.push_back(200.0);
+  sptr->getIntensityArray()->data.push_back(1.0);
+  sptr->getIntensityArray()->data.push_back(2.0);
+
+  ColumnarSpectrum cs(sptr);
+  TEST_EQUAL(cs.size(), 2)
+  TEST_REAL_SIMILAR(cs[1].getMZ(), 200.0)
+  // the arrays are shared
+  TEST_EQUAL(cs.getMZArray() == sptr->getMZArray(), true)
+  cs[1].setIntensity(5.0);
+  TEST_REAL_SIMILAR(sptr->getIntensityArray()->data[1], 5.0)
+
+  sptr->getIntensityArray()->data.push_back(3.0);
+  TEST_EXCEPTION(Exception::IllegalArgument, ColumnarSpectrum cs_err(sptr))
+  TEST_EXCEPTION(Exception::IllegalArgument, ColumnarSpectrum cs_null((OpenSwath::SpectrumPtr())))
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumPtr() const)
+{
+  ColumnarSpectrum cs(spec);
+  OpenSwath::SpectrumPtr sptr = cs.getSpectrumPtr();
+  TEST_EQUAL(sptr->getMZArray()->data.size(), 5)
+  TEST_EQUAL(sptr->getMZArray() == cs.getMZArray(), true)
+  TEST_EQUAL(sptr->getIntensityArray() == cs.getIntensityArray(), true)
+  TEST_REAL_SIMILAR(sptr->getIntensityArray()->data[2], 30.0)
+}
+END_SECTION
+
+START_SECTION(void toMSSpectrum(MSSpectrum<Peak1D>& spectrum) const)
+{
+  ColumnarSpectrum cs(spec);
+  MSSpectrum<> spec2;
+  cs.toMSSpectrum(spec2);
+  spec2.clearRanges();
+  MSSpectrum<> spec_ref = spec;
+  spec_ref.clearRanges();
+  TEST_EQUAL(spec2 == spec_ref, true)
+  TEST_EQUAL(spec2.getName(), "spec")
+}
+END_SECTION
+
+START_SECTION(static void fromExperiment(const MSExperiment& exp, std::vector<ColumnarSpectrum>& spectra))
+{
+  MSExperiment exp;
+  exp.addSpectrum(spec);
+  exp.addSpectrum(spec);
+  exp[1].setRT(20.0);
+  std::vector<ColumnarSpectrum> spectra;
+  ColumnarSpectrum::fromExperiment(exp, spectra);
+  TEST_EQUAL(spectra.size(), 2)
+  TEST_REAL_SIMILAR(spectra[1].getRT(), 20.0)
+  TEST_EQUAL(spectra[1].size(), 5)
+}
+END_SECTION
+
+START_SECTION(static void toExperiment(const std::vector<ColumnarSpectrum>& spectra, MSExperiment& exp))
+{
+  std::vector<ColumnarSpectrum> spectra(2, ColumnarSpectrum(spec));
+  spectra[0].setRT(1.0);
+  MSExperiment exp;
+  ColumnarSpectrum::toExperiment(spectra, exp);
+  TEST_EQUAL(exp.size(), 2)
+  TEST_REAL_SIMILAR(exp[0].getRT(), 1.0)
+  TEST_REAL_SIMILAR(exp[1][4].getMZ(), 504.0)
+  TEST_EQUAL(exp.getSize(), 10)
+}
+END_SECTION
+
+START_SECTION(virtual void updateRanges())
+{
+  ColumnarSpectrum cs(spec);
+  cs.updateRanges();
+  TEST_REAL_SIMILAR(cs.getMin()[0], 500.0)
+  TEST_REAL_SIMILAR(cs.getMax()[0], 504.0)
+  TEST_REAL_SIMILAR(cs.getMinInt(), 10.0)
+  TEST_REAL_SIMILAR(cs.getMaxInt(), 50.0)
+}
+END_SECTION
+
+START_SECTION(void push_back(CoordinateType mz, IntensityType intensity))
+{
+  ColumnarSpectrum cs;
+  cs.push_back(1.0, 2.0);
+  Peak1D p;
+  p.setMZ(3.0);
+  p.setIntensity(4.0f);
+  cs.push_back(p);
+  TEST_EQUAL(cs.size(), 2)
+  TEST_REAL_SIMILAR(cs[1].getMZ(), 3.0)
+  TEST_REAL_SIMILAR(cs[1].getIntensity(), 4.0)
+  Peak1D p2 = cs[0];
+  TEST_REAL_SIMILAR(p2.getMZ(), 1.0)
+}
+END_SECTION
+
+START_SECTION(void resize(Size n))
+{
+  ColumnarSpectrum cs(spec);
+  cs.resize(2);
+  TEST_EQUAL(cs.size(), 2)
+  TEST_EQUAL(cs.getIntensityData().size(), 2)
+}
+END_SECTION
+
+START_SECTION([EXTRA] Iterator)
+{
+  ColumnarSpectrum cs(spec);
+  double sum = 0;
+  for (ColumnarSpectrum::ConstIterator it = cs.begin(); it != cs.end(); ++it)
+  {
+    sum += it->getIntensity();
+  }
+  TEST_REAL_SIMILAR(sum, 150.0)
+  TEST_EQUAL(cs.end() - cs.begin(), 5)
+
+  for (ColumnarSpectrum::Iterator it = cs.begin(); it != cs.end(); ++it)
+  {
+    it->setIntensity(it->getIntensity() * 2);
+  }
+  TEST_REAL_SIMILAR(cs[4].getIntensity(), 100.0)
+  ColumnarSpectrum::ConstIterator cit = cs.begin() + 2;
+  TEST_REAL_SIMILAR((*cit).getMZ(), 502.0)
+  TEST_REAL_SIMILAR(cit[1].getMZ(), 503.0)
+}
+END_SECTION
+
+START_SECTION(void sortByPosition())
+{
+  ColumnarSpectrum cs(spec);
+  std::reverse(cs.getFloatDataArrays()[0].begin(), cs.getFloatDataArrays()[0].end());
+  std::vector<Size> rev;
+  for (Size i = 0; i < 5; ++i) rev.push_back(4 - i);
+  cs.select(rev);
+  TEST_EQUAL(cs.isSorted(), false)
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 504.0)
+  TEST_REAL_SIMILAR(cs.getFloatDataArrays()[0][0], 0.0)
+  cs.sortByPosition();
+  TEST_EQUAL(cs.isSorted(), true)
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 500.0)
+  TEST_REAL_SIMILAR(cs[0].getIntensity(), 10.0)
+  TEST_REAL_SIMILAR(cs.getFloatDataArrays()[0][0], 2.0)
+}
+END_SECTION
+
+START_SECTION(bool isSorted() const)
+{
+  ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.isSorted(), true)
+  cs[0].setMZ(1000.0);
+  TEST_EQUAL(cs.isSorted(), false)
+}
+END_SECTION
+
+START_SECTION(Size findNearest(CoordinateType mz) const)
+{
+  ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.findNearest(400.0), 0)
+  TEST_EQUAL(cs.findNearest(501.4), 1)
+  TEST_EQUAL(cs.findNearest(501.6), 2)
+  TEST_EQUAL(cs.findNearest(600.0), 4)
+  ColumnarSpectrum empty;
+  TEST_EXCEPTION(Exception::Precondition, empty.findNearest(1.0))
+}
+END_SECTION
+
+START_SECTION(Int findNearest(CoordinateType mz, CoordinateType tolerance) const)
+{
+  ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.findNearest(501.4, 0.5), 1)
+  TEST_EQUAL(cs.findNearest(501.4, 0.1), -1)
+  ColumnarSpectrum empty;
+  TEST_EQUAL(empty.findNearest(1.0, 1.0), -1)
+}
+END_SECTION
+
+START_SECTION(ConstIterator MZBegin(CoordinateType mz) const)
+{
+  const ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.MZBegin(501.0) - cs.begin(), 1)
+  TEST_EQUAL(cs.MZBegin(501.5) - cs.begin(), 2)
+  TEST_EQUAL(cs.MZBegin(600.0) == cs.end(), true)
+}
+END_SECTION
+
+START_SECTION(ConstIterator MZEnd(CoordinateType mz) const)
+{
+  const ColumnarSpectrum cs(spec);
+  TEST_EQUAL(cs.MZEnd(501.0) - cs.begin(), 2)
+  TEST_EQUAL(cs.MZEnd(400.0) == cs.begin(), true)
+}
+END_SECTION
+
+START_SECTION(Iterator MZBegin(CoordinateType mz))
+{
+  ColumnarSpectrum cs(spec);
+  TEST_REAL_SIMILAR(cs.MZBegin(502.5)->getMZ(), 503.0)
+}
+END_SECTION
+
+START_SECTION(Iterator MZEnd(CoordinateType mz))
+{
+  ColumnarSpectrum cs(spec);
+  TEST_REAL_SIMILAR(cs.MZEnd(502.0)->getMZ(), 503.0)
+}
+END_SECTION
+
+START_SECTION(void clear(bool clear_meta_data))
+{
+  ColumnarSpectrum cs(spec);
+  cs.clear(false);
+  TEST_EQUAL(cs.size(), 0)
+  TEST_REAL_SIMILAR(cs.getRT(), 12.5)
+  cs.clear(true);
+  TEST_REAL_SIMILAR(cs.getRT(), -1.0)
+  TEST_EQUAL(cs.getFloatDataArrays().size(), 0)
+  TEST_EQUAL(cs == ColumnarSpectrum(), true)
+}
+END_SECTION
+
+START_SECTION(ColumnarSpectrum& select(const std::vector<Size>& indices))
+{
+  ColumnarSpectrum cs(spec);
+  std::vector<Size> idx;
+  idx.push_back(4);
+  idx.push_back(1);
+  cs.select(idx);
+  TEST_EQUAL(cs.size(), 2)
+  TEST_REAL_SIMILAR(cs[0].getMZ(), 504.0)
+  TEST_REAL_SIMILAR(cs[1].getIntensity(), 20.0)
+  TEST_REAL_SIMILAR(cs.getFloatDataArrays()[0][1], 0.5)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
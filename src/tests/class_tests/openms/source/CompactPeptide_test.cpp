@@ -0,0 +1,362 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/CompactPeptide.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CompactPeptide, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CompactPeptide* ptr = 0;
+CompactPeptide* null_ptr = 0;
+START_SECTION(CompactPeptide())
+{
+  ptr = new CompactPeptide();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getAlphabet() == 0, true)
+}
+END_SECTION
+
+START_SECTION(~CompactPeptide())
+{
+  delete ptr;
+}
+END_SECTION
+
+const char* sequences[] = {"PEPTIDE", "DFPIANGER", "C", "ACDEFGHIKLMNPQRSTVWY",
+                           "PEPTM(Oxidation)IDE", "(Acetyl)PEPTC(Carbamidomethyl)IDEK",
+                           "PEPTIDEK(Label:13C(6)15N(2))", "PEPTX[148.5]IDE"};
+const Size n_sequences = 8;
+
+Residue::ResidueType types[] = {Residue::Full, Residue::Internal, Residue::NTerminal, Residue::CTerminal,
+                                Residue::AIon, Residue::BIon, Residue::CIon, Residue::XIon, Residue::YIon, Residue::ZIon};
+const Size n_types = 10;
+
+START_SECTION((Alphabet::Alphabet()))
+{
+  CompactPeptide::Alphabet alphabet;
+  TEST_EQUAL(alphabet.size(), 0)
+  TEST_EQUAL(alphabet.getModification(0) == 0, true)
+  TEST_REAL_SIMILAR(alphabet.getTypeMonoWeight(Residue::Full), Residue::getInternalToFull().getMonoWeight())
+  TEST_REAL_SIMILAR(alphabet.getTypeMonoWeight(Residue::YIon), Residue::getInternalToYIon().getMonoWeight())
+  TEST_EQUAL(alphabet.getTypeMonoWeight(Residue::Internal), 0.0)
+}
+END_SECTION
+
+START_SECTION((Code Alphabet::getResidueCode(const Residue& residue)))
+{
+  CompactPeptide::Alphabet alphabet;
+  const Residue* ala = ResidueDB::getInstance()->getResidue('A');
+  const Residue* gly = ResidueDB::getInstance()->getResidue('G');
+  TEST_EQUAL(alphabet.getResidueCode(*ala), 0)
+  TEST_EQUAL(alphabet.getResidueCode(*gly), 1)
+  TEST_EQUAL(alphabet.getResidueCode(*ala), 0)
+  TEST_EQUAL(alphabet.size(), 2)
+  TEST_EQUAL(&alphabet.getResidue(1), gly)
+  TEST_REAL_SIMILAR(alphabet.getResidueMonoWeight(0), ala->getMonoWeight(Residue::Internal))
+  TEST_REAL_SIMILAR(alphabet.getResidueAverageWeight(1), gly->getAverageWeight(Residue::Internal))
+  TEST_EXCEPTION(Exception::IndexOverflow, alphabet.getResidue(2))
+}
+END_SECTION
+
+START_SECTION((void Alphabet::addUnmodifiedResidues()))
+{
+  CompactPeptide::Alphabet alphabet;
+  const Residue* ala = ResidueDB::getInstance()->getResidue("A");
+  TEST_EQUAL(alphabet.getResidueCode(*ala), 0)
+  alphabet.addUnmodifiedResidues();
+  TEST_EQUAL(alphabet.size() > 20, true)
+  // existing codes are kept
+  TEST_EQUAL(alphabet.getResidueCode(*ala), 0)
+  TEST_EQUAL(alphabet.getResidue(alphabet.getResidueCode('W')).getOneLetterCode(), "W")
+  Size size = alphabet.size();
+  alphabet.addUnmodifiedResidues();
+  TEST_EQUAL(alphabet.size(), size)
+}
+END_SECTION
+
+START_SECTION((Code Alphabet::getResidueCode(char one_letter_code) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  TEST_EXCEPTION(Exception::InvalidValue, alphabet.getResidueCode('A'))
+  // residues encoded from an AASequence can be looked up as well
+  CompactPeptide peptide(AASequence::fromString("PEPTIDE"), alphabet);
+  TEST_EQUAL(alphabet.getResidueCode('E'), peptide.getResidueCodes()[1])
+  TEST_EXCEPTION(Exception::InvalidValue, alphabet.getResidueCode('A'))
+  // modified residues are not looked up by one-letter code
+  CompactPeptide::Alphabet alphabet2;
+  alphabet2.getResidueCode(*ResidueDB::getInstance()->getModifiedResidue("Oxidation (M)"));
+  TEST_EXCEPTION(Exception::InvalidValue, alphabet2.getResidueCode('M'))
+
+  alphabet2.addUnmodifiedResidues();
+  TEST_EXCEPTION(Exception::InvalidValue, alphabet2.getResidueCode('['))
+  TEST_EXCEPTION(Exception::InvalidValue, alphabet2.getResidueCode('1'))
+}
+END_SECTION
+
+START_SECTION((Code Alphabet::getModificationCode(const ResidueModification* mod)))
+{
+  CompactPeptide::Alphabet alphabet;
+  TEST_EQUAL(alphabet.getModificationCode(0), 0)
+  AASequence seq = AASequence::fromString("(Acetyl)PEPTIDE");
+  const ResidueModification* acetyl = seq.getNTerminalModification();
+  TEST_EQUAL(alphabet.getModificationCode(acetyl), 1)
+  TEST_EQUAL(alphabet.getModificationCode(acetyl), 1)
+  TEST_EQUAL(alphabet.getModification(1), acetyl)
+  TEST_REAL_SIMILAR(alphabet.getModificationMonoWeight(1), acetyl->getDiffMonoMass())
+  TEST_EXCEPTION(Exception::IndexOverflow, alphabet.getModification(2))
+}
+END_SECTION
+
+START_SECTION((CompactPeptide(const AASequence& sequence, Alphabet& alphabet)))
+{
+  CompactPeptide::Alphabet alphabet;
+  CompactPeptide peptide(AASequence::fromString("PEPTIDE"), alphabet);
+  TEST_EQUAL(peptide.size(), 7)
+  TEST_EQUAL(peptide.empty(), false)
+  TEST_EQUAL(peptide.getAlphabet(), &alphabet)
+  // P, E, T, I, D
+  TEST_EQUAL(alphabet.size(), 5)
+  TEST_EQUAL(peptide.getResidueCodes()[0], peptide.getResidueCodes()[2])
+  TEST_EQUAL(peptide.getResidueCodes()[1], peptide.getResidueCodes()[6])
+  TEST_EQUAL(peptide.getNTerminalModificationCode(), 0)
+  TEST_EQUAL(peptide.getCTerminalModificationCode(), 0)
+
+  CompactPeptide modified(AASequence::fromString("(Acetyl)PEPTIDE"), alphabet);
+  TEST_EQUAL(modified.getNTerminalModificationCode(), 1)
+  TEST_EQUAL(modified.getCTerminalModificationCode(), 0)
+}
+END_SECTION
+
+START_SECTION((void assign(const AASequence& sequence, Alphabet& alphabet)))
+{
+  CompactPeptide::Alphabet alphabet;
+  CompactPeptide peptide(AASequence::fromString("PEPTIDE"), alphabet);
+  peptide.assign(AASequence::fromString("GG"), alphabet);
+  TEST_EQUAL(peptide.size(), 2)
+  TEST_EQUAL(peptide.getResidueCodes()[0], 5)
+  TEST_REAL_SIMILAR(peptide.getMonoWeight(), AASequence::fromString("GG").getMonoWeight())
+  peptide.assign(AASequence(), alphabet);
+  TEST_EQUAL(peptide.empty(), true)
+}
+END_SECTION
+
+START_SECTION((CompactPeptide(const StringView& sequence, const Alphabet& alphabet)))
+{
+  CompactPeptide::Alphabet alphabet;
+  alphabet.addUnmodifiedResidues();
+  String sequence("PEPTIDE");
+  CompactPeptide peptide(sequence, alphabet);
+  TEST_EQUAL(peptide.size(), 7)
+  TEST_EQUAL(peptide.getAlphabet(), &alphabet)
+  TEST_EQUAL(peptide == CompactPeptide(AASequence::fromString(sequence), alphabet), true)
+
+  String protein("MPEPTIDEKR");
+  CompactPeptide view(StringView(protein.c_str() + 1, 7), alphabet);
+  TEST_EQUAL(view == peptide, true)
+  TEST_EQUAL(CompactPeptide(StringView(), alphabet).empty(), true)
+}
+END_SECTION
+
+START_SECTION((void assign(const StringView& sequence, const Alphabet& alphabet)))
+{
+  CompactPeptide::Alphabet alphabet;
+  alphabet.addUnmodifiedResidues();
+  CompactPeptide peptide(AASequence::fromString("(Acetyl)PEPTIDE"), alphabet);
+  String sequences[] = {"PEPTIDE", "GGG", "ACDEFGHIKLMNPQRSTVWYUOBZJX", "K"};
+  for (Size i = 0; i < 4; ++i)
+  {
+    peptide.assign(sequences[i], alphabet);
+    AASequence aas = AASequence::fromString(sequences[i]);
+    TEST_EQUAL(peptide.size(), aas.size())
+    TEST_EQUAL(peptide.getNTerminalModificationCode(), 0)
+    TEST_EQUAL(peptide.getMonoWeight(), aas.getMonoWeight())
+    TEST_EQUAL(peptide.getMonoWeight(Residue::YIon, 2), aas.getMonoWeight(Residue::YIon, 2))
+    TEST_REAL_SIMILAR(peptide.getAverageWeight(), aas.getAverageWeight())
+    TEST_EQUAL(peptide.getFormula(), aas.getFormula())
+  }
+
+  CompactPeptide::Alphabet empty_alphabet;
+  TEST_EXCEPTION(Exception::InvalidValue, peptide.assign(String("PEPTIDE"), empty_alphabet))
+  TEST_EXCEPTION(Exception::InvalidValue, peptide.assign(String("PEPT(Oxidation)IDE"), alphabet))
+}
+END_SECTION
+
+START_SECTION((bool operator==(const CompactPeptide& rhs) const))
+{
+  CompactPeptide::Alphabet alphabet, alphabet2;
+  CompactPeptide p1(AASequence::fromString("PEPTIDE"), alphabet);
+  CompactPeptide p2(AASequence::fromString("PEPTIDE"), alphabet);
+  CompactPeptide p3(AASequence::fromString("PEPTIDEK"), alphabet);
+  CompactPeptide p4(AASequence::fromString("PEPTIDE"), alphabet2);
+  TEST_EQUAL(p1 == p2, true)
+  TEST_EQUAL(p1 == p3, false)
+  TEST_EQUAL(p1 == p4, false)
+}
+END_SECTION
+
+START_SECTION((bool operator!=(const CompactPeptide& rhs) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  CompactPeptide p1(AASequence::fromString("PEPTIDE"), alphabet);
+  CompactPeptide p2(AASequence::fromString("PEPTIDE"), alphabet);
+  CompactPeptide p3(AASequence::fromString("PEPTIDEK"), alphabet);
+  TEST_EQUAL(p1 != p2, false)
+  TEST_EQUAL(p1 != p3, true)
+}
+END_SECTION
+
+START_SECTION((double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  for (Size i = 0; i < n_sequences; ++i)
+  {
+    AASequence seq = AASequence::fromString(sequences[i]);
+    CompactPeptide peptide(seq, alphabet);
+    for (Size t = 0; t < n_types; ++t)
+    {
+      for (Int charge = 0; charge < 3; ++charge)
+      {
+        TEST_REAL_SIMILAR(peptide.getMonoWeight(types[t], charge), seq.getMonoWeight(types[t], charge))
+      }
+    }
+  }
+  TEST_EQUAL(CompactPeptide().getMonoWeight(), 0.0)
+}
+END_SECTION
+
+START_SECTION((double getAverageWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  for (Size i = 0; i < n_sequences; ++i)
+  {
+    AASequence seq = AASequence::fromString(sequences[i]);
+    CompactPeptide peptide(seq, alphabet);
+    for (Size t = 0; t < n_types; ++t)
+    {
+      for (Int charge = 0; charge < 3; ++charge)
+      {
+        TEST_REAL_SIMILAR(peptide.getAverageWeight(types[t], charge), seq.getAverageWeight(types[t], charge))
+      }
+    }
+  }
+  TEST_EQUAL(CompactPeptide().getAverageWeight(), 0.0)
+}
+END_SECTION
+
+START_SECTION((double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  for (Size i = 0; i < n_sequences; ++i)
+  {
+    AASequence seq = AASequence::fromString(sequences[i]);
+    CompactPeptide peptide(seq, alphabet);
+    for (Size length = 1; length <= seq.size(); ++length)
+    {
+      TEST_REAL_SIMILAR(peptide.getPrefixMonoWeight(length, Residue::BIon, 1), seq.getPrefix(length).getMonoWeight(Residue::BIon, 1))
+      TEST_REAL_SIMILAR(peptide.getPrefixMonoWeight(length), seq.getPrefix(length).getMonoWeight())
+    }
+    TEST_EXCEPTION(Exception::IndexOverflow, peptide.getPrefixMonoWeight(seq.size() + 1))
+  }
+}
+END_SECTION
+
+START_SECTION((double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  for (Size i = 0; i < n_sequences; ++i)
+  {
+    AASequence seq = AASequence::fromString(sequences[i]);
+    CompactPeptide peptide(seq, alphabet);
+    for (Size length = 1; length <= seq.size(); ++length)
+    {
+      TEST_REAL_SIMILAR(peptide.getSuffixMonoWeight(length, Residue::YIon, 2), seq.getSuffix(length).getMonoWeight(Residue::YIon, 2))
+      TEST_REAL_SIMILAR(peptide.getSuffixMonoWeight(length), seq.getSuffix(length).getMonoWeight())
+    }
+    TEST_EXCEPTION(Exception::IndexOverflow, peptide.getSuffixMonoWeight(seq.size() + 1))
+  }
+}
+END_SECTION
+
+START_SECTION((void getComposition(std::vector<SignedSize>& composition, Residue::ResidueType type = Residue::Full) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  CompactPeptide peptide(AASequence::fromString("PEPTIDE"), alphabet);
+  std::vector<SignedSize> composition;
+  peptide.getComposition(composition);
+  const std::vector<const Element*>& elements = alphabet.getElements();
+  TEST_EQUAL(composition.size(), elements.size())
+  EmpiricalFormula formula = AASequence::fromString("PEPTIDE").getFormula();
+  for (Size i = 0; i < elements.size(); ++i)
+  {
+    TEST_EQUAL(composition[i], formula.getNumberOf(elements[i]))
+  }
+}
+END_SECTION
+
+START_SECTION((EmpiricalFormula getFormula(Residue::ResidueType type = Residue::Full, Int charge = 0) const))
+{
+  CompactPeptide::Alphabet alphabet;
+  for (Size i = 0; i < n_sequences; ++i)
+  {
+    AASequence seq = AASequence::fromString(sequences[i]);
+    if (seq.toString().hasSubstring("X[")) continue; // tags have no formula
+    CompactPeptide peptide(seq, alphabet);
+    for (Size t = 0; t < n_types; ++t)
+    {
+      TEST_EQUAL(peptide.getFormula(types[t], 1), seq.getFormula(types[t], 1))
+    }
+  }
+  TEST_EQUAL(CompactPeptide().getFormula(), EmpiricalFormula())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -106,6 +106,33 @@ START_SECTION(CubicSpline2d(const std::map<double, double>& m))
   TEST_NOT_EQUAL(sp4, nullPointer)
 END_SECTION
 
+START_SECTION(CubicSpline2d())
+  CubicSpline2d sp;
+  // an empty spline cannot be evaluated
+  TEST_EXCEPTION(Exception::IllegalArgument, sp.eval(0.0))
+  TEST_EXCEPTION(Exception::IllegalArgument, sp.derivatives(0.0, 1))
+END_SECTION
+
+START_SECTION(void init(const std::vector<double>& x, const std::vector<double>& y))
+  // re-initialization gives the same spline as construction
+  CubicSpline2d sp;
+  sp.init(x, y);
+  TEST_EQUAL(sp.eval(0.3), sp5.eval(0.3))
+  TEST_EQUAL(sp.derivatives(0.3, 1), sp5.derivatives(0.3, 1))
+  sp.init(mz, intensity);
+  TEST_EQUAL(sp.eval(486.799), sp1.eval(486.799))
+  TEST_EQUAL(sp.derivatives(486.799, 2), sp1.derivatives(486.799, 2))
+  // a smaller spline reuses the memory
+  sp.init(x, y);
+  TEST_EQUAL(sp.eval(-0.2), sp5.eval(-0.2))
+  TEST_EXCEPTION(Exception::IllegalArgument, sp.eval(486.799))
+
+  std::vector<double> unsorted(x.rbegin(), x.rend());
+  TEST_EXCEPTION(Exception::IllegalArgument, sp.init(unsorted, y))
+  TEST_EXCEPTION(Exception::IllegalArgument, sp.init(x, std::vector<double>(3, 0.0)))
+  TEST_EXCEPTION(Exception::IllegalArgument, sp.init(std::vector<double>(1, 0.0), std::vector<double>(1, 0.0)))
+END_SECTION
+
 START_SECTION(double eval(double x))
   // near border of spline range
   TEST_REAL_SIMILAR(sp1.eval(486.785), 35173.1841778984);
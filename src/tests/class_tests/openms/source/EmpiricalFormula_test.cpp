@@ -357,6 +357,40 @@ START_SECTION(IsotopeDistribution getIsotopeDistribution(UInt max_depth) const)
   }
 END_SECTION
 
+START_SECTION(IsotopeDistribution getIsotopeDistributionFFT(UInt max_depth) const)
+  EmpiricalFormula ef("C");
+  IsotopeDistribution iso = ef.getIsotopeDistributionFFT(20);
+  double result[] = { 0.9893, 0.0107};
+  TEST_EQUAL(iso.size(), 2)
+  Size i = 0;
+  for (IsotopeDistribution::ConstIterator it = iso.begin(); it != iso.end(); ++it, ++i)
+  {
+    TEST_EQUAL(it->first, 12 + i)
+    TEST_REAL_SIMILAR(it->second, result[i])
+  }
+
+  // same result as the direct convolution
+  ef = EmpiricalFormula("C520H817N139O147S8");
+  UInt depths[] = { 0, 5, 20 };
+  TOLERANCE_ABSOLUTE(1e-10)
+  for (Size d = 0; d < 3; ++d)
+  {
+    IsotopeDistribution fft = ef.getIsotopeDistributionFFT(depths[d]);
+    IsotopeDistribution direct = ef.getIsotopeDistribution(depths[d]);
+    TEST_EQUAL(fft.size(), direct.size())
+    ABORT_IF(fft.size() != direct.size())
+    for (Size k = 0; k < fft.size(); ++k)
+    {
+      TEST_EQUAL(fft.getContainer()[k].first, direct.getContainer()[k].first)
+      TEST_REAL_SIMILAR(fft.getContainer()[k].second, direct.getContainer()[k].second)
+    }
+  }
+
+  TEST_EQUAL(EmpiricalFormula().getIsotopeDistributionFFT(20).size(), 1)
+  TEST_EXCEPTION(Exception::InvalidValue, EmpiricalFormula("C-1").getIsotopeDistributionFFT(20))
+  TOLERANCE_ABSOLUTE(1)
+END_SECTION
+
 START_SECTION(IsotopeDistribution getConditionalFragmentIsotopeDist(const EmpiricalFormula& precursor, const std::set<UInt>& precursor_isotopes) const)
   EmpiricalFormula precursor("C2");
   EmpiricalFormula fragment("C");
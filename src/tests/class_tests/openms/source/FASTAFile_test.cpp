@@ -44,6 +44,7 @@
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
 
+#include <sstream>
 #include <vector>
 
 ///////////////////////////
@@ -182,6 +183,16 @@ START_SECTION((void store(const String& filename, const std::vector< FASTAEntry
   TEST_EQUAL(data==data2,true);
 END_SECTION
 
+START_SECTION((static void writeEntry(std::ostream& os, const FASTAEntry& entry)))
+  std::ostringstream os;
+  FASTAFile::writeEntry(os, FASTAFile::FASTAEntry("ID", "DESC", String(85, 'A')));
+  TEST_EQUAL(os.str(), ">ID DESC\n" + String(80, 'A') + "\nAAAAA\n")
+
+  std::ostringstream os2;
+  FASTAFile::writeEntry(os2, FASTAFile::FASTAEntry("ID", "", ""));
+  TEST_EQUAL(os2.str(), ">ID \n")
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -235,6 +235,60 @@ START_SECTION((void apply(std::vector<ProteinIdentification>& ids)))
 }
 END_SECTION
 
+START_SECTION((static void calculateFDRs(std::vector<ScoredHit>& hits, std::vector<double>& fdrs, bool q_value, bool higher_score_better)))
+{
+  // targets: 10, 9, 8, 7, 6; decoys: 8.5, 6.5, 5
+  double scores[] = {10.0, 9.0, 8.0, 7.0, 6.0, 8.5, 6.5, 5.0};
+  vector<FalseDiscoveryRate::ScoredHit> hits;
+  for (Size i = 0; i < 8; ++i)
+  {
+    hits.push_back(FalseDiscoveryRate::ScoredHit(scores[i], i >= 5, i));
+  }
+  // second group without decoys, third group without targets
+  hits.push_back(FalseDiscoveryRate::ScoredHit(3.0, false, 8, 1));
+  hits.push_back(FalseDiscoveryRate::ScoredHit(4.0, false, 9, 1));
+  hits.push_back(FalseDiscoveryRate::ScoredHit(3.0, true, 10, 2));
+  vector<FalseDiscoveryRate::ScoredHit> fdr_hits(hits.rbegin(), hits.rend());
+
+  TOLERANCE_ABSOLUTE(1e-10)
+  vector<double> fdrs(11, -1.0);
+  FalseDiscoveryRate::calculateFDRs(hits, fdrs, true, true);
+  // decoys get the q-value of the closest target (the worse one if two are equally close)
+  double q_values[] = {0.0, 0.0, 0.25, 0.25, 0.4, 0.25, 0.4, 0.4, 0.0, 0.0, 1.0};
+  for (Size i = 0; i < 11; ++i)
+  {
+    TEST_REAL_SIMILAR(fdrs[i], q_values[i])
+  }
+  // sorted by group, then from best to worst
+  TEST_EQUAL(hits[0].index, 0)
+  TEST_EQUAL(hits[7].index, 7)
+  TEST_EQUAL(hits[8].index, 9)
+  TEST_EQUAL(hits[10].index, 10)
+
+  FalseDiscoveryRate::calculateFDRs(fdr_hits, fdrs, false, true);
+  // decoys get the FDR of the closest target (the better one if two are equally close)
+  double fdr_values[] = {0.0, 0.0, 1.0 / 3.0, 0.25, 0.4, 0.0, 0.25, 0.4, 0.0, 0.0, 1.0};
+  for (Size i = 0; i < 11; ++i)
+  {
+    TEST_REAL_SIMILAR(fdrs[i], fdr_values[i])
+  }
+
+  // lower scores are better
+  for (Size i = 0; i < hits.size(); ++i)
+  {
+    hits[i].score = -hits[i].score;
+  }
+  FalseDiscoveryRate::calculateFDRs(hits, fdrs, true, false);
+  for (Size i = 0; i < 11; ++i)
+  {
+    TEST_REAL_SIMILAR(fdrs[i], q_values[i])
+  }
+
+  fdrs.resize(10);
+  TEST_EXCEPTION(Exception::IndexOverflow, FalseDiscoveryRate::calculateFDRs(hits, fdrs, true, true))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
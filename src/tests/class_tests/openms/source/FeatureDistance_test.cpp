@@ -172,6 +172,31 @@ START_SECTION((FeatureDistance& operator=(const FeatureDistance& other)))
 }
 END_SECTION
 
+START_SECTION((FeatureDistance(const FeatureDistance& other)))
+{
+	FeatureDistance dist(1000.0, true);
+	Param param = dist.getDefaults();
+	param.setValue("distance_RT:max_difference", 100.0);
+	param.setValue("distance_MZ:max_difference", 1.0);
+	param.setValue("distance_MZ:exponent", 1.0);
+	param.setValue("distance_intensity:weight", 1.0);
+	dist.setParameters(param);
+	FeatureDistance dist2(dist);
+	TEST_EQUAL(dist.getParameters(), dist2.getParameters());
+
+	BaseFeature left, right;
+	left.setMZ(100.0);
+	left.setRT(10.0);
+	left.setIntensity(100.0f);
+	right.setMZ(100.5);
+	right.setRT(20.0);
+	right.setIntensity(500.0f);
+	std::pair<bool, double> result = dist(left, right), result2 = dist2(left, right);
+	TEST_EQUAL(result.first, result2.first);
+	TEST_REAL_SIMILAR(result.second, result2.second);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -36,6 +36,8 @@
 #include <OpenMS/test_config.h>
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/FeatureGroupingAlgorithmKD.h>
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/KERNEL/ConversionHelper.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -77,6 +79,77 @@ START_SECTION((virtual void group(const std::vector<ConsensusMap>& maps, Consens
   NOT_TESTABLE;
 END_SECTION
 
+START_SECTION((void group(const StringList& filenames, ConsensusMap& out, Size max_chunk_size)))
+{
+  // three maps with shifted and jittered copies of the same features
+  // (temporary file names depend on the line number)
+  StringList filenames(3);
+  NEW_TMP_FILE(filenames[0]);
+  NEW_TMP_FILE(filenames[1]);
+  NEW_TMP_FILE(filenames[2]);
+  vector<ConsensusMap> maps(3);
+  for (Size k = 0; k < 3; ++k)
+  {
+    FeatureMap fmap;
+    for (Size i = 0; i < 300; ++i)
+    {
+      if ((i + k) % 7 == 0) continue;
+      Feature f;
+      f.setMZ(300.0 + 2.3 * i + 0.0001 * ((i * k) % 5));
+      f.setRT(100.0 + (i * 37) % 1000 + 3.0 * k + (i % 3));
+      f.setIntensity(1000.0f + 100.0f * ((i * 13 + k) % 17));
+      f.setCharge(1 + i % 3);
+      fmap.push_back(f);
+    }
+    fmap.getProteinIdentifications().resize(1);
+    fmap.getProteinIdentifications()[0].setIdentifier(String("run") + k);
+    fmap.applyMemberFunction(&UniqueIdInterface::setUniqueId);
+    FeatureXMLFile().store(filenames[k], fmap);
+
+    // in-memory reference input, loaded the same way
+    FeatureMap loaded;
+    FeatureXMLFile().load(filenames[k], loaded);
+    MapConversion::convert(k, loaded, maps[k]);
+  }
+
+  FeatureGroupingAlgorithmKD algo;
+  Param p = algo.getParameters();
+  p.setValue("nr_partitions", 10);
+  p.setValue("LOWESS:span", 0.5);
+  algo.setParameters(p);
+  ConsensusMap reference;
+  algo.group(maps, reference);
+  TEST_EQUAL(reference.size() > 0, true)
+
+  Size chunk_sizes[] = { 0, 100, 1000000 };
+  for (Size c = 0; c < 3; ++c)
+  {
+    ConsensusMap out;
+    algo.group(filenames, out, chunk_sizes[c]);
+    TEST_EQUAL(out.size(), reference.size())
+    ABORT_IF(out.size() != reference.size())
+    for (Size i = 0; i < out.size(); ++i)
+    {
+      TEST_EQUAL(out[i].getFeatures() == reference[i].getFeatures(), true)
+      TEST_REAL_SIMILAR(out[i].getRT(), reference[i].getRT())
+      TEST_REAL_SIMILAR(out[i].getMZ(), reference[i].getMZ())
+    }
+    TEST_EQUAL(out.getProteinIdentifications().size(), 3)
+    TEST_EQUAL(out.getProteinIdentifications()[2].getIdentifier(), "run2")
+    TEST_EQUAL(out.getFileDescriptions().size(), 3)
+    TEST_EQUAL(out.getFileDescriptions()[1].filename, filenames[1])
+    TEST_EQUAL(out.getFileDescriptions()[1].size, maps[1].size())
+  }
+
+  StringList single(1, filenames[0]);
+  ConsensusMap out;
+  TEST_EXCEPTION(Exception::IllegalArgument, algo.group(single, out, 0))
+  StringList mixed(filenames);
+  mixed.push_back(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"));
+  TEST_EXCEPTION(Exception::InvalidParameter, algo.group(mixed, out, 0))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
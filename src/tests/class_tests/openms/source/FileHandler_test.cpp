@@ -41,6 +41,7 @@
 ///////////////////////////
 
 #include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/RichPeak1D.h>
@@ -240,6 +241,53 @@ TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::MZML)
 //other types cannot be tested, because the NEW_TMP_FILE template does not support file extensions...
 END_SECTION
 
+START_SECTION((void storeFeatures(const String& filename, const FeatureMap& map)))
+FileHandler fh;
+FeatureMap map;
+fh.loadFeatures(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_2_options.featureXML"), map);
+
+String filename;
+NEW_TMP_FILE(filename)
+fh.storeFeatures(filename, map);
+TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::FEATUREXML)
+
+// the binary format is chosen by extension
+filename += ".featureBin";
+fh.storeFeatures(filename, map);
+TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::FEATUREBIN)
+FeatureMap map2;
+TEST_EQUAL(fh.loadFeatures(filename, map2), true)
+TEST_EQUAL(map2.size(), 7)
+END_SECTION
+
+START_SECTION((bool loadConsensusFeatures(const String& filename, ConsensusMap& map, FileTypes::Type force_type = FileTypes::UNKNOWN)))
+FileHandler tmp;
+ConsensusMap map;
+TEST_EQUAL(tmp.loadConsensusFeatures("test.bla", map), false)
+TEST_EQUAL(tmp.loadConsensusFeatures(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_2_options.featureXML"), map), false)
+TEST_EQUAL(tmp.loadConsensusFeatures(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), map), true)
+TEST_EQUAL(map.size(), 6)
+END_SECTION
+
+START_SECTION((void storeConsensusFeatures(const String& filename, const ConsensusMap& map)))
+FileHandler fh;
+ConsensusMap map;
+fh.loadConsensusFeatures(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), map);
+
+String filename;
+NEW_TMP_FILE(filename)
+fh.storeConsensusFeatures(filename, map);
+TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::CONSENSUSXML)
+
+// the binary format is chosen by extension
+filename += ".consensusBin";
+fh.storeConsensusFeatures(filename, map);
+TEST_EQUAL(fh.getTypeByContent(filename), FileTypes::CONSENSUSBIN)
+ConsensusMap map2;
+TEST_EQUAL(fh.loadConsensusFeatures(filename, map2), true)
+TEST_EQUAL(map2.size(), map.size())
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,243 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/FragmentIonIndex.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/RichPeak1D.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FragmentIonIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FragmentIonIndex* ptr = 0;
+FragmentIonIndex* null_ptr = 0;
+START_SECTION(FragmentIonIndex())
+{
+  ptr = new FragmentIonIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getNrPeptides(), 0)
+  TEST_EQUAL(ptr->getNrFragments(), 0)
+}
+END_SECTION
+
+START_SECTION(~FragmentIonIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+TheoreticalSpectrumGenerator generator;
+Param param(generator.getParameters());
+param.setValue("add_first_prefix_ion", "true");
+param.setValue("add_metainfo", "true");
+generator.setParameters(param);
+
+vector<AASequence> peptides;
+peptides.push_back(AASequence::fromString("PEPTIDEK"));
+peptides.push_back(AASequence::fromString("ELVISLIVESK"));
+peptides.push_back(AASequence::fromString("PEPTIDER"));
+peptides.push_back(AASequence::fromString("SAMPLER"));
+peptides.push_back(AASequence::fromString("DFPIANGER"));
+peptides.push_back(AASequence::fromString("EPPTIDEK")); // same mass as PEPTIDEK
+
+// experimental spectrum: all b- and y-ions of PEPTIDEK (shifted slightly) plus noise
+RichPeakSpectrum theo_spectrum;
+generator.getSpectrum(theo_spectrum, peptides[0], 1);
+PeakSpectrum exp_spectrum;
+for (Size i = 0; i < theo_spectrum.size(); ++i)
+{
+  Peak1D p;
+  p.setMZ(theo_spectrum[i].getMZ() + 0.001);
+  p.setIntensity(10.0 + i);
+  exp_spectrum.push_back(p);
+  p.setMZ(theo_spectrum[i].getMZ() + 0.37);
+  p.setIntensity(3.0);
+  exp_spectrum.push_back(p);
+}
+exp_spectrum.sortByPosition();
+
+START_SECTION((void build(const std::vector<AASequence>& peptides, const TheoreticalSpectrumGenerator& generator)))
+{
+  FragmentIonIndex index;
+  index.build(peptides, generator);
+  TEST_EQUAL(index.getNrPeptides(), 6)
+  Size nr_fragments = 0;
+  for (Size i = 0; i < peptides.size(); ++i)
+  {
+    RichPeakSpectrum spec;
+    generator.getSpectrum(spec, peptides[i], 1);
+    nr_fragments += spec.size();
+  }
+  TEST_EQUAL(index.getNrFragments(), nr_fragments)
+
+  // theoretical spectra need to be annotated
+  TheoreticalSpectrumGenerator plain_generator;
+  TEST_EXCEPTION(Exception::MissingInformation, index.build(peptides, plain_generator))
+}
+END_SECTION
+
+START_SECTION((Size getNrPeptides() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size getNrFragments() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((const AASequence& getPeptide(Size index) const))
+{
+  FragmentIonIndex index;
+  index.build(peptides, generator);
+  for (Size i = 1; i < index.getNrPeptides(); ++i)
+  {
+    TEST_EQUAL(index.getPeptideMass(i - 1) <= index.getPeptideMass(i), true)
+    TEST_REAL_SIMILAR(index.getPeptide(i).getMonoWeight(), index.getPeptideMass(i))
+  }
+}
+END_SECTION
+
+START_SECTION((double getPeptideMass(Size index) const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((void search(const PeakSpectrum& spectrum, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, std::vector<PeptideScore>& hits) const))
+{
+  FragmentIonIndex index;
+  index.build(peptides, generator);
+  vector<FragmentIonIndex::PeptideScore> hits;
+  double precursor_mass = peptides[0].getMonoWeight();
+
+  // closed search: only PEPTIDEK and EPPTIDEK have the right mass
+  index.search(exp_spectrum, precursor_mass, 10.0, true, 10.0, true, hits);
+  TEST_EQUAL(hits.size(), 2)
+  for (Size i = 0; i < hits.size(); ++i)
+  {
+    const AASequence& peptide = index.getPeptide(hits[i].first);
+    RichPeakSpectrum spec;
+    generator.getSpectrum(spec, peptide, 1);
+    spec.sortByPosition();
+    TEST_REAL_SIMILAR(hits[i].second, HyperScore::compute(10.0, true, exp_spectrum, spec))
+    if (peptide == peptides[0])
+    {
+      TEST_REAL_SIMILAR(hits[i].second, HyperScore::compute(10.0, true, exp_spectrum, theo_spectrum))
+    }
+  }
+
+  // open search (+/- 250 Da): all peptides are candidates, but those
+  // without sufficiently many matching peaks get no score
+  index.search(exp_spectrum, precursor_mass, 500.0, false, 0.02, false, hits);
+  for (Size i = 0; i < hits.size(); ++i)
+  {
+    RichPeakSpectrum spec;
+    generator.getSpectrum(spec, index.getPeptide(hits[i].first), 1);
+    spec.sortByPosition();
+    TEST_REAL_SIMILAR(hits[i].second, HyperScore::compute(0.02, false, exp_spectrum, spec))
+  }
+  TEST_EQUAL(hits.size() >= 2, true)
+
+  // no candidates
+  index.search(exp_spectrum, 10000.0, 10.0, true, 10.0, true, hits);
+  TEST_EQUAL(hits.size(), 0)
+  index.search(PeakSpectrum(), precursor_mass, 10.0, true, 10.0, true, hits);
+  TEST_EQUAL(hits.size(), 0)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] search gives the same scores as HyperScore::compute))
+{
+  // many candidates (several blocks) and an open search
+  const String amino_acids = "ACDEFGHIKLMNPQRSTVWY";
+  vector<AASequence> candidates;
+  srand(42);
+  for (Size i = 0; i < 2 * FragmentIonIndex::BLOCK_SIZE + 100; ++i)
+  {
+    String seq;
+    Size length = 6 + rand() % 10;
+    for (Size j = 0; j < length; ++j)
+    {
+      seq += amino_acids[rand() % amino_acids.size()];
+    }
+    candidates.push_back(AASequence::fromString(seq));
+  }
+  candidates.push_back(peptides[0]);
+
+  FragmentIonIndex index;
+  index.build(candidates, generator);
+  vector<FragmentIonIndex::PeptideScore> hits;
+  double precursor_mass = peptides[0].getMonoWeight();
+  index.search(exp_spectrum, precursor_mass, 400.0, false, 0.05, false, hits);
+
+  Size nr_scored = 0;
+  Size nr_mismatches = 0;
+  for (Size i = 0; i < index.getNrPeptides(); ++i)
+  {
+    double mass = index.getPeptideMass(i);
+    if (precursor_mass < mass - 200.0 || precursor_mass > mass + 200.0) continue;
+    RichPeakSpectrum spec;
+    generator.getSpectrum(spec, index.getPeptide(i), 1);
+    spec.sortByPosition();
+    double score = HyperScore::compute(0.05, false, exp_spectrum, spec);
+    if (score < 1e-16) continue;
+    ++nr_scored;
+    bool found = false;
+    for (Size k = 0; k < hits.size(); ++k)
+    {
+      if (hits[k].first == i)
+      {
+        found = (hits[k].second == score);
+      }
+    }
+    if (!found) ++nr_mismatches;
+  }
+  TEST_EQUAL(nr_scored, hits.size())
+  TEST_EQUAL(nr_mismatches, 0)
+  TEST_EQUAL(nr_scored > 1, true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
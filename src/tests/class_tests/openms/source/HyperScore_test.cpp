@@ -116,6 +116,59 @@ START_SECTION((static double compute(double fragment_mass_tolerance, bool fragme
 }
 END_SECTION
 
+START_SECTION((static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum &exp_spectrum, const std::vector<double> &theo_mz, const std::vector<TheoreticalSpectrumGenerator::IonAnnotation> &theo_annotations)))
+{
+  PeakSpectrum exp_spectrum;
+  std::vector<double> theo_mz;
+  std::vector<TheoreticalSpectrumGenerator::IonAnnotation> theo_annotations;
+  Peak1D p;
+  p.setIntensity(1);
+  TheoreticalSpectrumGenerator::IonAnnotation annotation;
+  annotation.type = Residue::YIon;
+  annotation.charge = 1;
+
+  // full match, 10 identical masses, identical intensities (=1)
+  for (Size i = 1; i <= 10; ++i)
+  {
+    p.setMZ(i);
+    exp_spectrum.push_back(p);
+    annotation.index = i;
+    theo_mz.push_back(i);
+    theo_annotations.push_back(annotation);
+  }
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_mz, theo_annotations), 18.407);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, exp_spectrum, theo_mz, theo_annotations), 18.407);
+
+  exp_spectrum.clear(true);
+  theo_mz.clear();
+  theo_annotations.clear();
+
+  // full match if ppm tolerance and partial match for Da tolerance
+  annotation.type = Residue::BIon;
+  for (Size i = 1; i <= 10; ++i)
+  {
+    double mz = pow(10.0, static_cast<int>(i));
+    p.setMZ(mz);
+    exp_spectrum.push_back(p);
+    annotation.index = i;
+    theo_mz.push_back(mz + 9 * 1e-6 * mz); // +9 ppm error
+    theo_annotations.push_back(annotation);
+  }
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_mz, theo_annotations), 5.5643482);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, exp_spectrum, theo_mz, theo_annotations), 18.407);
+}
+END_SECTION
+
+START_SECTION((static double computeFromMatches(double dot_product, UInt y_ion_count, UInt b_ion_count)))
+{
+  // 10 matching y-ions with intensity 1 (see above)
+  TEST_REAL_SIMILAR(HyperScore::computeFromMatches(10.0, 10, 0), 18.407);
+  TEST_REAL_SIMILAR(HyperScore::computeFromMatches(10.0, 0, 10), 18.407);
+  // no sufficient match
+  TEST_REAL_SIMILAR(HyperScore::computeFromMatches(0.05, 3, 3), 0.0);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
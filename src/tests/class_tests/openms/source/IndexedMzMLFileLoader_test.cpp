@@ -121,6 +121,129 @@ START_SECTION(bool load(const String& filename, OnDiscPeakMap& exp))
 }
 END_SECTION
 
+START_SECTION(bool load(const String& filename, PeakMap& exp))
+{
+  IndexedMzMLFileLoader file;
+  PeakMap exp;
+  bool success = file.load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"),exp);
+  TEST_EQUAL(success, true)
+
+  PeakMap exp2;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"),exp2);
+
+  TEST_EQUAL(exp.size(), 2)
+  TEST_EQUAL(exp.getChromatograms().size(), 1)
+  TEST_EQUAL(exp.size(), exp2.size())
+  TEST_EQUAL(exp.getChromatograms().size(), exp2.getChromatograms().size())
+  for (Size i = 0; i < exp.size(); i++)
+  {
+    TEST_EQUAL(exp[i] == exp2[i], true)
+  }
+  for (Size i = 0; i < exp.getChromatograms().size(); i++)
+  {
+    TEST_EQUAL(exp.getChromatograms()[i] == exp2.getChromatograms()[i], true)
+  }
+  TEST_EQUAL((OpenMS::ExperimentalSettings)exp == (OpenMS::ExperimentalSettings)exp2, true)
+
+  // not indexed
+  success = file.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+  TEST_EQUAL(success, false)
+
+  // the offsets of the index are wrong (line endings were converted), the file is read sequentially
+  success = file.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML"), exp);
+  TEST_EQUAL(success, true)
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML"), exp2);
+  TEST_EQUAL(exp.size(), exp2.size())
+  TEST_EQUAL(exp == exp2, true)
+
+  // filtering options are applied to every chunk
+  PeakFileOptions options;
+  options.addMSLevel(2);
+  file.setOptions(options);
+  success = file.load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), exp);
+  TEST_EQUAL(success, true)
+  MzMLFile f;
+  f.setOptions(options);
+  f.load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), exp2);
+  TEST_EQUAL(exp.size(), exp2.size())
+  for (Size i = 0; i < exp.size(); i++)
+  {
+    TEST_EQUAL(exp[i] == exp2[i], true)
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] load(const String& filename, PeakMap& exp) compared to MzMLFile::load)
+{
+  // a larger file with additional binary data arrays (ion mobility) and chromatograms
+  PeakMap generated;
+  for (Size i = 0; i < 2000; ++i)
+  {
+    MSSpectrum<> s;
+    s.setRT(i * 0.5);
+    s.setMSLevel(i % 5 == 0 ? 1 : 2);
+    s.setNativeID(String("spectrum=") + i);
+    s.getFloatDataArrays().resize(1);
+    s.getFloatDataArrays()[0].setName("Ion Mobility");
+    for (Size j = 0; j < 200; ++j)
+    {
+      Peak1D p;
+      p.setMZ(100.0 + j * 1.5 + i * 0.001);
+      p.setIntensity(j * 10.0 + i);
+      s.push_back(p);
+      s.getFloatDataArrays()[0].push_back(j * 0.01f);
+    }
+    generated.addSpectrum(s);
+  }
+  for (Size i = 0; i < 50; ++i)
+  {
+    MSChromatogram<> c;
+    c.setNativeID(String("chromatogram=") + i);
+    for (Size j = 0; j < 100; ++j)
+    {
+      ChromatogramPeak p;
+      p.setRT(j * 2.0);
+      p.setIntensity(i * 100.0 + j);
+      c.push_back(p);
+    }
+    generated.addChromatogram(c);
+  }
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  MzMLFile mzml_file;
+  mzml_file.getOptions().setWriteIndex(true);
+  mzml_file.store(tmp_filename, generated);
+
+  PeakMap sequential;
+  MzMLFile().load(tmp_filename, sequential);
+
+  PeakMap parallel;
+  IndexedMzMLFileLoader file;
+  TEST_EQUAL(file.load(tmp_filename, parallel), true)
+
+  TEST_EQUAL(parallel.size(), 2000)
+  TEST_EQUAL(parallel.size(), sequential.size())
+  TEST_EQUAL(parallel.getChromatograms().size(), 50)
+  TEST_EQUAL(parallel.getChromatograms().size(), sequential.getChromatograms().size())
+  bool all_equal = true;
+  for (Size i = 0; i < parallel.size(); i++)
+  {
+    all_equal &= (parallel[i] == sequential[i]);
+  }
+  for (Size i = 0; i < parallel.getChromatograms().size(); i++)
+  {
+    all_equal &= (parallel.getChromatograms()[i] == sequential.getChromatograms()[i]);
+  }
+  TEST_EQUAL(all_equal, true)
+  TEST_EQUAL(parallel[1234].getFloatDataArrays().size(), 1)
+  TEST_EQUAL(parallel[1234].getFloatDataArrays()[0].size(), 200)
+  TEST_REAL_SIMILAR(parallel[1234].getFloatDataArrays()[0][100], 1.0)
+  TEST_EQUAL(parallel[1234].getNativeID(), "spectrum=1234")
+  TEST_EQUAL(parallel.getChromatograms()[49].getNativeID(), "chromatogram=49")
+  TEST_EQUAL((OpenMS::ExperimentalSettings)parallel == (OpenMS::ExperimentalSettings)sequential, true)
+}
+END_SECTION
+
 START_SECTION([EXTRA]CheckParsing)
 {
   // Check return value of load
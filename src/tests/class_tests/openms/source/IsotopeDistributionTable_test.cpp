@@ -0,0 +1,209 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/IsotopeDistributionTable.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+
+using namespace OpenMS;
+using namespace std;
+
+/// compares a table estimate with the conventional one
+void compareDistributions(const IsotopeDistribution& table, const IsotopeDistribution& direct)
+{
+  TEST_EQUAL(table.size(), direct.size())
+  if (table.size() != direct.size()) return;
+  for (Size i = 0; i < table.size(); ++i)
+  {
+    TEST_EQUAL(table.getContainer()[i].first, direct.getContainer()[i].first)
+    TEST_REAL_SIMILAR(table.getContainer()[i].second, direct.getContainer()[i].second)
+  }
+}
+
+START_TEST(IsotopeDistributionTable, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+TOLERANCE_ABSOLUTE(1e-12)
+
+IsotopeDistributionTable* ptr = 0;
+IsotopeDistributionTable* null_ptr = 0;
+START_SECTION((IsotopeDistributionTable(Size max_isotope, double max_weight, double C, double H, double N, double O, double S, double P)))
+{
+  ptr = new IsotopeDistributionTable(10, 5000.0, 4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION((Size getMaxIsotope() const))
+{
+  TEST_EQUAL(ptr->getMaxIsotope(), 10)
+}
+END_SECTION
+
+START_SECTION((double getMaxWeight() const))
+{
+  TEST_REAL_SIMILAR(ptr->getMaxWeight(), 5000.0)
+}
+END_SECTION
+
+START_SECTION((static const IsotopeDistributionTable& getPeptideTable()))
+{
+  const IsotopeDistributionTable& table = IsotopeDistributionTable::getPeptideTable();
+  TEST_EQUAL(&table == &IsotopeDistributionTable::getPeptideTable(), true)
+  TEST_EQUAL(table.getMaxIsotope(), 20)
+  TEST_REAL_SIMILAR(table.getMaxWeight(), 20000.0)
+  for (double weight = 0.0; weight < 21000.0; weight += 97.3)
+  {
+    IsotopeDistribution direct(5), estimated(5);
+    direct.estimateFromPeptideWeight(weight);
+    table.estimate(weight, estimated);
+    compareDistributions(estimated, direct);
+  }
+}
+END_SECTION
+
+START_SECTION((static const IsotopeDistributionTable& getRNATable()))
+{
+  const IsotopeDistributionTable& table = IsotopeDistributionTable::getRNATable();
+  TEST_EQUAL(&table == &IsotopeDistributionTable::getRNATable(), true)
+  for (double weight = 0.0; weight < 21000.0; weight += 211.7)
+  {
+    IsotopeDistribution direct(8), estimated(8);
+    direct.estimateFromRNAWeight(weight);
+    table.estimate(weight, estimated);
+    compareDistributions(estimated, direct);
+  }
+}
+END_SECTION
+
+START_SECTION((static const IsotopeDistributionTable& getDNATable()))
+{
+  const IsotopeDistributionTable& table = IsotopeDistributionTable::getDNATable();
+  TEST_EQUAL(&table == &IsotopeDistributionTable::getDNATable(), true)
+  for (double weight = 0.0; weight < 21000.0; weight += 211.7)
+  {
+    IsotopeDistribution direct(8), estimated(8);
+    direct.estimateFromDNAWeight(weight);
+    table.estimate(weight, estimated);
+    compareDistributions(estimated, direct);
+  }
+}
+END_SECTION
+
+START_SECTION((void estimate(double average_weight, IsotopeDistribution& distribution) const))
+{
+  // within the table
+  IsotopeDistribution direct(4), estimated(4);
+  direct.estimateFromPeptideWeight(1234.5);
+  ptr->estimate(1234.5, estimated);
+  compareDistributions(estimated, direct);
+  TEST_EQUAL(estimated.getMin(), direct.getMin())
+  TEST_EQUAL(estimated.getMax(), direct.getMax())
+
+  // more isotopes than stored
+  direct = IsotopeDistribution(15);
+  estimated = IsotopeDistribution(15);
+  direct.estimateFromPeptideWeight(1234.5);
+  ptr->estimate(1234.5, estimated);
+  compareDistributions(estimated, direct);
+
+  // all isotopes
+  direct = IsotopeDistribution();
+  estimated = IsotopeDistribution();
+  direct.estimateFromPeptideWeight(1234.5);
+  ptr->estimate(1234.5, estimated);
+  compareDistributions(estimated, direct);
+
+  // heavier than the table
+  direct = IsotopeDistribution(4);
+  estimated = IsotopeDistribution(4);
+  direct.estimateFromPeptideWeight(8000.0);
+  ptr->estimate(8000.0, estimated);
+  compareDistributions(estimated, direct);
+
+  // the table notices changed isotope abundances
+  Element* carbon = const_cast<Element*>(ElementDB::getInstance()->getElement("C"));
+  IsotopeDistribution natural = carbon->getIsotopeDistribution();
+  IsotopeDistribution labeled(natural);
+  IsotopeDistribution::ContainerType container = labeled.getContainer();
+  container[0].second = 0.5;
+  container[1].second = 0.5;
+  labeled.set(container);
+  carbon->setIsotopeDistribution(labeled);
+  direct = IsotopeDistribution(4);
+  estimated = IsotopeDistribution(4);
+  direct.estimateFromPeptideWeight(1234.5);
+  ptr->estimate(1234.5, estimated);
+  compareDistributions(estimated, direct);
+  carbon->setIsotopeDistribution(natural);
+}
+END_SECTION
+
+START_SECTION((Size estimate(double average_weight, Size max_isotope, std::vector<double>& probabilities) const))
+{
+  IsotopeDistribution direct(6);
+  direct.estimateFromPeptideWeight(2500.0);
+  std::vector<double> probabilities(100, 1.0);
+  Size nominal_mass = ptr->estimate(2500.0, 6, probabilities);
+  TEST_EQUAL(nominal_mass, direct.getMin())
+  TEST_EQUAL(probabilities.size(), direct.size())
+  for (Size i = 0; i < probabilities.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(probabilities[i], direct.getContainer()[i].second)
+  }
+
+  // light molecules have fewer isotopes
+  direct = IsotopeDistribution(6);
+  direct.estimateFromPeptideWeight(1.0);
+  nominal_mass = ptr->estimate(1.0, 6, probabilities);
+  TEST_EQUAL(nominal_mass, direct.getMin())
+  TEST_EQUAL(probabilities.size(), direct.size())
+  TEST_EQUAL(probabilities.size() < 6, true)
+}
+END_SECTION
+
+delete ptr;
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
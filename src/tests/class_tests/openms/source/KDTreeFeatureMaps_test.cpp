@@ -88,6 +88,16 @@ START_SECTION((KDTreeFeatureMaps(const std::vector<MapType>& maps, const Param&
   delete ptr;
 END_SECTION
 
+START_SECTION((KDTreeFeatureMaps(const std::vector<MapType>& maps, const std::vector<std::vector<Size> >& feature_indices, const Param& param)))
+  vector<vector<Size> > indices(1, vector<Size>(1, 1));
+  ptr = new KDTreeFeatureMaps(fmaps, indices, p);
+  TEST_NOT_EQUAL(ptr, nullPointer);
+  TEST_EQUAL(ptr->size(), 1)
+  TEST_EQUAL(ptr->feature(0), &(fmaps[0][1]))
+  TEST_EQUAL(ptr->numMaps(), 1)
+  delete ptr;
+END_SECTION
+
 KDTreeFeatureMaps kd_data_1(fmaps, p);
 
 START_SECTION((KDTreeFeatureMaps(const KDTreeFeatureMaps& rhs)))
@@ -114,6 +124,22 @@ START_SECTION((void addMaps(const std::vector<MapType>& maps)))
   TEST_EQUAL(kd_data_3.size(), 2);
 END_SECTION
 
+START_SECTION((void addMaps(const std::vector<MapType>& maps, const std::vector<std::vector<Size> >& feature_indices)))
+  KDTreeFeatureMaps kd_data_4;
+  kd_data_4.setParameters(p);
+  vector<vector<Size> > indices(1);
+  indices[0].push_back(0);
+  kd_data_4.addMaps(fmaps, indices);
+  TEST_EQUAL(kd_data_4.size(), 1)
+  TEST_EQUAL(kd_data_4.feature(0), &(fmaps[0][0]))
+  indices[0].clear();
+  kd_data_4.addMaps(fmaps, indices);
+  TEST_EQUAL(kd_data_4.size(), 1)
+  indices.resize(2);
+  TEST_EXCEPTION(Exception::InvalidSize, kd_data_4.addMaps(fmaps, indices))
+  TEST_EXCEPTION(Exception::InvalidSize, kd_data_4.addMaps(fmaps, vector<vector<Size> >()))
+END_SECTION
+
 START_SECTION((void addFeature(Size mt_map_index, const BaseFeature* feature)))
   Feature f3;
   f3.setMZ(300);
@@ -838,6 +838,32 @@ START_SECTION(void clear(bool clear_meta_data))
   TEST_EQUAL(edit==MSChromatogram<>(),true)
 END_SECTION
 
+START_SECTION(void swap(MSChromatogram& from))
+  MSChromatogram<> edit;
+  edit.resize(2);
+  edit[1].setRT(100.0);
+  edit.setMetaValue("label",String("bla"));
+  edit.getProduct().setMZ(5);
+  edit.setName("name");
+  edit.getFloatDataArrays().resize(5);
+  edit.getIntegerDataArrays().resize(4);
+  edit.getStringDataArrays().resize(3);
+  edit.updateRanges();
+  const MSChromatogram<> copy(edit);
+
+  MSChromatogram<> other;
+  other.swap(edit);
+  TEST_EQUAL(other==copy,true)
+  TEST_EQUAL(other.getName(),"name")
+  TEST_REAL_SIMILAR(other.getMax()[0],100.0)
+  TEST_EQUAL(edit==MSChromatogram<>(),true)
+  TEST_EQUAL(edit.getName(),"")
+
+  other.swap(edit);
+  TEST_EQUAL(edit==copy,true)
+  TEST_EQUAL(other==MSChromatogram<>(),true)
+END_SECTION
+
 START_SECTION((double getMZ() const))
 	MSChromatogram<> tmp;
 	Product prod;
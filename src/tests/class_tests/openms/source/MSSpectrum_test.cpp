@@ -1046,6 +1046,34 @@ START_SECTION(void clear(bool clear_meta_data))
 	TEST_EQUAL(edit==MSSpectrum<>(),true)
 END_SECTION
 
+START_SECTION(void swap(MSSpectrum& from))
+  MSSpectrum<> edit;
+  edit.resize(2);
+  edit[1].setMZ(100.0);
+  edit.setMetaValue("label",String("bla"));
+  edit.setRT(5);
+  edit.setDriftTime(6);
+  edit.setMSLevel(3);
+  edit.setName("name");
+  edit.getFloatDataArrays().resize(5);
+  edit.getIntegerDataArrays().resize(4);
+  edit.getStringDataArrays().resize(3);
+  edit.updateRanges();
+  const MSSpectrum<> copy(edit);
+
+  MSSpectrum<> other;
+  other.swap(edit);
+  TEST_EQUAL(other==copy,true)
+  TEST_EQUAL(other.getName(),"name")
+  TEST_REAL_SIMILAR(other.getMax()[0],100.0)
+  TEST_EQUAL(edit==MSSpectrum<>(),true)
+  TEST_EQUAL(edit.getName(),"")
+
+  other.swap(edit);
+  TEST_EQUAL(edit==copy,true)
+  TEST_EQUAL(other==MSSpectrum<>(),true)
+END_SECTION
+
 START_SECTION(([MSSpectrum::RTLess] bool operator()(const MSSpectrum &a, const MSSpectrum &b) const))
   vector< MSSpectrum<> > v;
 
@@ -36,6 +36,7 @@
 #include <OpenMS/test_config.h>
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmKD.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -61,6 +62,76 @@ START_SECTION((void addRTFitData(const KDTreeFeatureMaps& kd_data)))
   NOT_TESTABLE;
 END_SECTION
 
+START_SECTION((void computeRTFitData(const KDTreeFeatureMaps& kd_data, std::vector<TransformationModel::DataPoints>& fit_data) const))
+{
+  Param p;
+  p.setValue("rt_tol", 60.0);
+  p.setValue("mz_tol", 15.0);
+  p.setValue("mz_unit", "ppm");
+  p.setValue("min_rel_cc_size", 0.5);
+  p.setValue("max_nr_conflicts", 0);
+  p.setValue("max_pairwise_log_fc", -1.0);
+
+  // (map, RT, m/z): one component in all three maps, one in two maps, one
+  // with a conflict in map 0 and a singleton
+  double data[][3] = { {0, 100.0, 500.0}, {1, 102.0, 500.0}, {2, 104.0, 500.0},
+                       {0, 200.0, 600.0}, {1, 210.0, 600.0},
+                       {0, 300.0, 700.0}, {0, 301.0, 700.0}, {1, 302.0, 700.0},
+                       {0, 400.0, 800.0} };
+  vector<FeatureMap> maps(3);
+  for (Size i = 0; i < sizeof(data) / sizeof(data[0]); ++i)
+  {
+    Feature f;
+    f.setRT(data[i][1]);
+    f.setMZ(data[i][2]);
+    f.setIntensity(1.0f);
+    maps[(Size)data[i][0]].push_back(f);
+  }
+  KDTreeFeatureMaps kd_data(maps, p);
+
+  MapAlignmentAlgorithmKD aligner(3, p);
+  vector<TransformationModel::DataPoints> fit_data(1);
+  fit_data[0].push_back(make_pair(1.0, 2.0));
+  aligner.computeRTFitData(kd_data, fit_data);
+
+  // existing data points are kept, missing maps are added
+  TEST_EQUAL(fit_data.size(), 3)
+  TEST_EQUAL(fit_data[0].size(), 3)
+  TEST_EQUAL(fit_data[1].size(), 2)
+  TEST_EQUAL(fit_data[2].size(), 1)
+  TEST_REAL_SIMILAR(fit_data[0][0].first, 1.0)
+  TEST_REAL_SIMILAR(fit_data[0][1].first, 100.0)
+  TEST_REAL_SIMILAR(fit_data[0][1].second, 102.0)
+  TEST_REAL_SIMILAR(fit_data[0][2].first, 200.0)
+  TEST_REAL_SIMILAR(fit_data[0][2].second, 205.0)
+  TEST_REAL_SIMILAR(fit_data[1][0].first, 102.0)
+  TEST_REAL_SIMILAR(fit_data[1][0].second, 102.0)
+  TEST_REAL_SIMILAR(fit_data[1][1].first, 210.0)
+  TEST_REAL_SIMILAR(fit_data[1][1].second, 205.0)
+  TEST_REAL_SIMILAR(fit_data[2][0].first, 104.0)
+  TEST_REAL_SIMILAR(fit_data[2][0].second, 102.0)
+
+  // the same data is added by addRTFitData(const KDTreeFeatureMaps&)
+  vector<TransformationModel::DataPoints> fit_data2;
+  aligner.computeRTFitData(kd_data, fit_data2);
+  fit_data.front().erase(fit_data.front().begin());
+  TEST_EQUAL(fit_data2 == fit_data, true)
+
+  // conflicting components are accepted if conflicts are allowed
+  p.setValue("max_nr_conflicts", -1);
+  MapAlignmentAlgorithmKD aligner2(3, p);
+  vector<TransformationModel::DataPoints> fit_data3;
+  aligner2.computeRTFitData(kd_data, fit_data3);
+  TEST_EQUAL(fit_data3[0].size(), 4)
+  TEST_EQUAL(fit_data3[1].size(), 3)
+  TEST_REAL_SIMILAR(fit_data3[0][3].second, 301.0)
+}
+END_SECTION
+
+START_SECTION((void addRTFitData(const std::vector<TransformationModel::DataPoints>& fit_data)))
+  NOT_TESTABLE;
+END_SECTION
+
 START_SECTION((void fitLOWESS()))
   NOT_TESTABLE;
 END_SECTION
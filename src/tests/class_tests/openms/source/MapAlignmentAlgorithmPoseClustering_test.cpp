@@ -69,7 +69,13 @@ START_SECTION((template <typename MapType> void setReference(const MapType& map)
 }
 END_SECTION
 
-START_SECTION((void align(const PeakMap& map, TransformationDescription& trafo)))
+START_SECTION((void setReference(const FeatureMap& map)))
+{
+  NOT_TESTABLE // tested together with "align"
+}
+END_SECTION
+
+START_SECTION((void align(const PeakMap& map, TransformationDescription& trafo) const))
 {
   MzMLFile f;
   std::vector<PeakMap > maps(2);
@@ -95,14 +101,61 @@ START_SECTION((void align(const PeakMap& map, TransformationDescription& trafo))
 }
 END_SECTION
 
-START_SECTION((void align(const FeatureMap& map, TransformationDescription& trafo)))
+START_SECTION((void align(const FeatureMap& map, TransformationDescription& trafo) const))
 {
-  // Tested extensively in TEST/TOPP
-  NOT_TESTABLE;
+  // further tested extensively in TEST/TOPP
+  FeatureMap reference;
+  for (Size i = 0; i < 50; ++i)
+  {
+    Feature feat;
+    feat.setRT(100.0 + 20.0 * i);
+    feat.setMZ(400.0 + 7.3 * i + (i % 4) * 50.0);
+    feat.setIntensity(1000.0f + 10.0f * i);
+    feat.setCharge(2);
+    feat.setUniqueId(i + 1);
+    reference.push_back(feat);
+  }
+  reference.updateRanges();
+
+  // scenes are shifted and scaled copies of the reference
+  std::vector<FeatureMap> scenes(4, reference);
+  for (Size s = 0; s < scenes.size(); ++s)
+  {
+    for (Size i = 0; i < scenes[s].size(); ++i)
+    {
+      scenes[s][i].setRT(1.02 * reference[i].getRT() + 5.0 * s);
+    }
+    scenes[s].updateRanges();
+  }
+
+  MapAlignmentAlgorithmPoseClustering aligner;
+  aligner.setReference(reference);
+
+  // the reference is preprocessed once, scenes can be aligned concurrently
+  std::vector<TransformationDescription> trafos(scenes.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize s = 0; s < (SignedSize)scenes.size(); ++s)
+  {
+    aligner.align(scenes[s], trafos[s]);
+  }
+
+  for (Size s = 0; s < trafos.size(); ++s)
+  {
+    TEST_EQUAL(trafos[s].getModelType(), "linear");
+    TEST_EQUAL(trafos[s].getDataPoints().size(), reference.size());
+    TransformationModelLinear lm(trafos[s].getDataPoints(),
+                                 trafos[s].getModelParameters());
+    double slope, intercept;
+    lm.getParameters(slope, intercept);
+    TEST_REAL_SIMILAR(slope, 1.0 / 1.02);
+    TEST_REAL_SIMILAR(intercept, -5.0 * s / 1.02);
+  }
 }
 END_SECTION
 
-START_SECTION((void align(const ConsensusMap& map, TransformationDescription& trafo)))
+START_SECTION((void align(const ConsensusMap& map, TransformationDescription& trafo) const))
 {
   // Tested extensively in TEST/TOPP
   NOT_TESTABLE;
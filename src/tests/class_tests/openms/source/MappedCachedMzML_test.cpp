@@ -0,0 +1,237 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/MappedCachedMzML.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+using namespace OpenMS;
+using namespace std;
+
+PeakMap createExperiment()
+{
+  PeakMap exp;
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum<Peak1D> s;
+    s.setRT(10.0 + i);
+    s.setMSLevel(i == 0 ? 1 : 2);
+    // spectrum 3 stays empty
+    for (Size j = 0; i != 3 && j < 10 * (i + 1); ++j)
+    {
+      Peak1D p;
+      p.setMZ(100.0 + j * 0.5 + i);
+      p.setIntensity(j * 10.0f + i);
+      s.push_back(p);
+    }
+    exp.addSpectrum(s);
+  }
+  std::vector<MSChromatogram<ChromatogramPeak> > chromatograms(2);
+  for (Size j = 0; j < 7; ++j)
+  {
+    ChromatogramPeak p;
+    p.setRT(j * 2.0);
+    p.setIntensity(j * 100.0);
+    chromatograms[1].push_back(p);
+  }
+  exp.setChromatograms(chromatograms);
+  return exp;
+}
+
+START_TEST(MappedCachedmzML, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeakMap exp = createExperiment();
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+
+MappedCachedmzML* ptr = 0;
+MappedCachedmzML* nullPointer = 0;
+
+START_SECTION((static void store(const String& filename, const MapType& exp)))
+{
+  MappedCachedmzML::store(tmp_filename, exp);
+  TEST_EQUAL(MappedCachedmzML::isMappedCache(tmp_filename), true)
+}
+END_SECTION
+
+START_SECTION((explicit MappedCachedmzML(const String& filename)))
+{
+  ptr = new MappedCachedmzML(tmp_filename);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getFilename(), tmp_filename)
+
+  TEST_EXCEPTION(Exception::FileNotFound, MappedCachedmzML("this_file_does_not_exist.cached"))
+  TEST_EXCEPTION(Exception::ParseError, MappedCachedmzML(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML")))
+
+  // a truncated file (index missing) is detected
+  std::string truncated_filename;
+  NEW_TMP_FILE(truncated_filename);
+  {
+    std::ifstream ifs(tmp_filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    std::ofstream ofs(truncated_filename.c_str(), std::ios::binary);
+    ofs.write(content.c_str(), content.size() - 40);
+  }
+  TEST_EXCEPTION(Exception::ParseError, MappedCachedmzML(String(truncated_filename)))
+
+  // a corrupt spectrum count whose index size overflows 64 bit is detected
+  std::string overflow_filename;
+  NEW_TMP_FILE(overflow_filename);
+  {
+    std::ifstream ifs(tmp_filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    UInt64 nr_spectra;
+    std::memcpy(&nr_spectra, &content[content.size() - 24], sizeof(UInt64));
+    nr_spectra += (UInt64(1) << 59); // times sizeof(IndexEntry) == 32 wraps around
+    std::memcpy(&content[content.size() - 24], &nr_spectra, sizeof(UInt64));
+    std::ofstream ofs(overflow_filename.c_str(), std::ios::binary);
+    ofs.write(content.c_str(), content.size());
+  }
+  TEST_EXCEPTION(Exception::ParseError, MappedCachedmzML(String(overflow_filename)))
+}
+END_SECTION
+
+START_SECTION((~MappedCachedmzML()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((static bool isMappedCache(const String& filename)))
+{
+  TEST_EQUAL(MappedCachedmzML::isMappedCache(tmp_filename), true)
+  TEST_EQUAL(MappedCachedmzML::isMappedCache(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML")), false)
+  TEST_EQUAL(MappedCachedmzML::isMappedCache("this_file_does_not_exist.cached"), false)
+}
+END_SECTION
+
+START_SECTION((Size getNrSpectra() const))
+{
+  MappedCachedmzML cache(tmp_filename);
+  TEST_EQUAL(cache.getNrSpectra(), 5)
+}
+END_SECTION
+
+START_SECTION((Size getNrChromatograms() const))
+{
+  MappedCachedmzML cache(tmp_filename);
+  TEST_EQUAL(cache.getNrChromatograms(), 2)
+}
+END_SECTION
+
+START_SECTION((SpectrumView getSpectrumView(Size id) const))
+{
+  MappedCachedmzML cache(tmp_filename);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    MappedCachedmzML::SpectrumView view = cache.getSpectrumView(i);
+    TEST_EQUAL(view.size, exp[i].size())
+    TEST_REAL_SIMILAR(view.rt, exp[i].getRT())
+    TEST_EQUAL(view.ms_level, (int)exp[i].getMSLevel())
+    for (Size j = 0; j < view.size; ++j)
+    {
+      TEST_REAL_SIMILAR(view.mz[j], exp[i][j].getMZ())
+      TEST_REAL_SIMILAR(view.intensity[j], exp[i][j].getIntensity())
+    }
+    // data is aligned in the file
+    TEST_EQUAL(reinterpret_cast<size_t>(view.mz) % sizeof(double), 0)
+  }
+}
+END_SECTION
+
+START_SECTION((ChromatogramView getChromatogramView(Size id) const))
+{
+  MappedCachedmzML cache(tmp_filename);
+  MappedCachedmzML::ChromatogramView view = cache.getChromatogramView(0);
+  TEST_EQUAL(view.size, 0)
+  view = cache.getChromatogramView(1);
+  TEST_EQUAL(view.size, 7)
+  TEST_REAL_SIMILAR(view.rt[3], 6.0)
+  TEST_REAL_SIMILAR(view.intensity[3], 300.0)
+  TEST_REAL_SIMILAR(view.rt[6], 12.0)
+  TEST_REAL_SIMILAR(view.intensity[6], 600.0)
+}
+END_SECTION
+
+START_SECTION((void load(MapType& exp) const))
+{
+  MappedCachedmzML cache(tmp_filename);
+  PeakMap exp_new;
+  cache.load(exp_new);
+  TEST_EQUAL(exp_new.size(), exp.size())
+  TEST_EQUAL(exp_new.getChromatograms().size(), exp.getChromatograms().size())
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    TEST_EQUAL(exp_new[i] == exp[i], true)
+  }
+  for (Size i = 0; i < exp.getChromatograms().size(); ++i)
+  {
+    TEST_EQUAL(exp_new.getChromatograms()[i] == exp.getChromatograms()[i], true)
+  }
+
+  // an empty experiment can be stored as well
+  std::string empty_filename;
+  NEW_TMP_FILE(empty_filename);
+  MappedCachedmzML::store(empty_filename, PeakMap());
+  MappedCachedmzML empty_cache(empty_filename);
+  TEST_EQUAL(empty_cache.getNrSpectra(), 0)
+  TEST_EQUAL(empty_cache.getNrChromatograms(), 0)
+  empty_cache.load(exp_new);
+  TEST_EQUAL(exp_new.size(), 0)
+}
+END_SECTION
+
+START_SECTION((const String& getFilename() const))
+{
+  MappedCachedmzML cache(tmp_filename);
+  TEST_EQUAL(cache.getFilename(), tmp_filename)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,219 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
+///////////////////////////
+
+#include <fstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(MappedFASTAFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// writes @p content to a new temporary file
+#define WRITE_TMP_FILE(filename, content) \
+  NEW_TMP_FILE(filename); \
+  { \
+    std::ofstream ofs(filename.c_str(), std::ios::binary); \
+    ofs << content; \
+  }
+
+const String first_sequence = String("GDREQLLQRARLAEQAERYDDMASAMKAVTELNEPLSNEDRNLLSVAYKNVVGARRSSWR") +
+  "VISSIEQKTMADGNEKKLEKVKAYREKIEKELETVCNDVLALLDKFLIKNCNDFQYESKV" +
+  "FYLKMKGDYYRYLAEVASGEKKNSVVEASEAAYKEAFEISKEHMQPTHPIRLGLALNFSV" +
+  "FYYEIQNAPEQACLLAKQAFDDAIAELDTLNEDSYKDSTLIMQLLRDNLTLWTSDQQDEE" +
+  "AGEGN";
+
+MappedFASTAFile* ptr = 0;
+MappedFASTAFile* null_ptr = 0;
+START_SECTION((explicit MappedFASTAFile(const String& filename, bool build_index = false)))
+{
+  ptr = new MappedFASTAFile(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->hasIndex(), false)
+  TEST_EXCEPTION(Exception::FileNotFound, MappedFASTAFile("MappedFASTAFile_test_this_file_does_not_exist"))
+
+  String garbage;
+  WRITE_TMP_FILE(garbage, "PEPTIDE\n>ID\nPEPTIDE\n")
+  TEST_EXCEPTION(Exception::ParseError, MappedFASTAFile(garbage, true))
+}
+END_SECTION
+
+START_SECTION((~MappedFASTAFile()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((const String& getFilename() const))
+{
+  MappedFASTAFile fasta(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(fasta.getFilename(), OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"))
+}
+END_SECTION
+
+START_SECTION((Size getFileSize() const))
+{
+  String filename;
+  WRITE_TMP_FILE(filename, ">ID\nPEPTIDE\n")
+  MappedFASTAFile fasta(filename);
+  TEST_EQUAL(fasta.getFileSize(), 12)
+}
+END_SECTION
+
+START_SECTION((bool hasIndex() const))
+{
+  TEST_EQUAL(MappedFASTAFile(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")).hasIndex(), false)
+  TEST_EQUAL(MappedFASTAFile(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), true).hasIndex(), true)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  MappedFASTAFile fasta(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), true);
+  TEST_EQUAL(fasta.size(), 5)
+  TEST_EXCEPTION(Exception::Precondition, MappedFASTAFile(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")).size())
+
+  String empty;
+  WRITE_TMP_FILE(empty, "")
+  TEST_EQUAL(MappedFASTAFile(empty, true).size(), 0)
+}
+END_SECTION
+
+START_SECTION((Size getEntryOffset(Size index) const))
+{
+  String filename;
+  WRITE_TMP_FILE(filename, "\n>A\nPEP\n>B\nTIDE\n")
+  MappedFASTAFile fasta(filename, true);
+  TEST_EQUAL(fasta.getEntryOffset(0), 1)
+  TEST_EQUAL(fasta.getEntryOffset(1), 8)
+  TEST_EXCEPTION(Exception::IndexOverflow, fasta.getEntryOffset(2))
+}
+END_SECTION
+
+START_SECTION((EntryView getEntryView(Size index) const))
+{
+  MappedFASTAFile fasta(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), true);
+  String sequence;
+
+  MappedFASTAFile::EntryView entry = fasta.getEntryView(0);
+  TEST_EQUAL(entry.identifier.getString(), "P68509|1433F_BOVIN")
+  TEST_EQUAL(entry.description.getString(), "This is the description of the first protein")
+  entry.getSequence(sequence);
+  TEST_EQUAL(sequence, first_sequence)
+
+  entry = fasta.getEntryView(2);
+  TEST_EQUAL(entry.identifier.getString(), "sp|P31946|1433B_HUMAN")
+  TEST_EQUAL(entry.description.getString(), "14-3-3 protein beta/alpha OS=Homo sapiens GN=YWHAB PE=1 SV=3")
+
+  entry = fasta.getEntryView(4);
+  TEST_EQUAL(entry.identifier.getString(), "test")
+  TEST_EQUAL(entry.description.getString(), " ##0")
+  entry.getSequence(sequence);
+  TEST_EQUAL(sequence.size(), 361)
+  TEST_EQUAL(sequence.hasSuffix("QRTFKSDFQSV"), true)
+
+  TEST_EXCEPTION(Exception::IndexOverflow, fasta.getEntryView(5))
+}
+END_SECTION
+
+START_SECTION(([MappedFASTAFile::EntryView] void getSequence(String& sequence) const))
+{
+  // Windows line endings, whitespace and a missing final line break
+  String filename;
+  WRITE_TMP_FILE(filename, ">ID1 first protein \r\nPEP TIDE\r\nPEP\r\n\r\n>ID2\r\nAAA")
+  MappedFASTAFile fasta(filename, true);
+  TEST_EQUAL(fasta.size(), 2)
+  String sequence;
+  MappedFASTAFile::EntryView entry = fasta.getEntryView(0);
+  TEST_EQUAL(entry.identifier.getString(), "ID1")
+  TEST_EQUAL(entry.description.getString(), "first protein")
+  TEST_EQUAL(entry.raw_sequence.getString(), "PEP TIDE\r\nPEP\r\n\r\n")
+  entry.getSequence(sequence);
+  TEST_EQUAL(sequence, "PEPTIDEPEP")
+  entry = fasta.getEntryView(1);
+  TEST_EQUAL(entry.identifier.getString(), "ID2")
+  TEST_EQUAL(entry.description.size(), 0)
+  entry.getSequence(sequence);
+  TEST_EQUAL(sequence, "AAA")
+}
+END_SECTION
+
+START_SECTION(([MappedFASTAFile::EntryView] void getEntry(FASTAFile::FASTAEntry& entry) const))
+{
+  MappedFASTAFile fasta(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), true);
+  FASTAFile::FASTAEntry entry;
+  fasta.getEntryView(0).getEntry(entry);
+  TEST_EQUAL(entry == FASTAFile::FASTAEntry("P68509|1433F_BOVIN", "This is the description of the first protein", first_sequence), true)
+}
+END_SECTION
+
+START_SECTION(([MappedFASTAFile::Reader] explicit Reader(const MappedFASTAFile& file)))
+{
+  MappedFASTAFile fasta(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), true);
+  MappedFASTAFile::Reader reader(fasta);
+  MappedFASTAFile::EntryView entry;
+  Size count = 0;
+  while (reader.next(entry))
+  {
+    TEST_EQUAL(entry.identifier.getString(), fasta.getEntryView(count).identifier.getString())
+    ++count;
+  }
+  TEST_EQUAL(count, 5)
+}
+END_SECTION
+
+START_SECTION(([MappedFASTAFile::Reader] bool next(EntryView& entry)))
+{
+  String empty;
+  WRITE_TMP_FILE(empty, " \n")
+  MappedFASTAFile fasta(empty);
+  MappedFASTAFile::Reader reader(fasta);
+  MappedFASTAFile::EntryView entry;
+  TEST_EQUAL(reader.next(entry), false)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
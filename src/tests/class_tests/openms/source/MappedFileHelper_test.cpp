@@ -0,0 +1,141 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/HANDLERS/MappedFileHelper.h>
+///////////////////////////
+
+#include <fstream>
+#include <cstring>
+
+using namespace OpenMS;
+using namespace OpenMS::Internal;
+using namespace std;
+
+START_TEST(MappedFileHelper, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+const UInt64 identifier = 0x5453455448504D4FULL;
+const UInt64 header[2] = {identifier, 42};
+const UInt64 trailer[2] = {4711, 815};
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+
+START_SECTION((static void writeHeader(std::ofstream& ofs, UInt64& pos, const String& filename, const void* header, Size header_size)))
+{
+  std::ofstream ofs;
+  UInt64 pos = 1;
+  MappedFileHelper::writeHeader(ofs, pos, tmp_filename, header, sizeof(header));
+  TEST_EQUAL(pos, MappedFileHelper::HEADER_SIZE)
+  TEST_EQUAL(UInt64(ofs.tellp()), MappedFileHelper::HEADER_SIZE)
+  ofs.close();
+
+  TEST_EXCEPTION(Exception::UnableToCreateFile, MappedFileHelper::writeHeader(ofs, pos, "/this/directory/does/not/exist/file", header, sizeof(header)))
+}
+END_SECTION
+
+START_SECTION((static void pad(std::ofstream& ofs, UInt64& pos, Size alignment)))
+{
+  std::string filename;
+  NEW_TMP_FILE(filename);
+  std::ofstream ofs(filename.c_str(), std::ios::binary);
+  UInt64 pos = 0;
+  MappedFileHelper::pad(ofs, pos, MappedFileHelper::DATA_ALIGNMENT);
+  TEST_EQUAL(pos, 0)
+  ofs.write("abc", 3);
+  pos += 3;
+  MappedFileHelper::pad(ofs, pos, MappedFileHelper::DATA_ALIGNMENT);
+  TEST_EQUAL(pos, MappedFileHelper::DATA_ALIGNMENT)
+  TEST_EQUAL(UInt64(ofs.tellp()), MappedFileHelper::DATA_ALIGNMENT)
+}
+END_SECTION
+
+START_SECTION((static void writeTrailer(std::ofstream& ofs, const String& filename, UInt64 identifier, const void* trailer = 0, Size trailer_size = 0)))
+{
+  std::ofstream ofs;
+  UInt64 pos = 0;
+  MappedFileHelper::writeHeader(ofs, pos, tmp_filename, header, sizeof(header));
+  MappedFileHelper::writeTrailer(ofs, tmp_filename, identifier, trailer, sizeof(trailer));
+  TEST_EQUAL(ofs.is_open(), false)
+}
+END_SECTION
+
+START_SECTION((static bool readHeader(const String& filename, void* header, Size header_size)))
+{
+  UInt64 read[2] = {0, 0};
+  TEST_EQUAL(MappedFileHelper::readHeader(tmp_filename, read, sizeof(read)), true)
+  TEST_EQUAL(read[0], identifier)
+  TEST_EQUAL(read[1], 42)
+  TEST_EQUAL(MappedFileHelper::readHeader("this_file_does_not_exist", read, sizeof(read)), false)
+}
+END_SECTION
+
+START_SECTION((static void mapFile(boost::iostreams::mapped_file_source& file, const String& filename)))
+{
+  boost::iostreams::mapped_file_source file;
+  MappedFileHelper::mapFile(file, tmp_filename);
+  TEST_EQUAL(file.size(), MappedFileHelper::HEADER_SIZE + sizeof(trailer) + sizeof(identifier))
+  UInt64 read;
+  std::memcpy(&read, file.data(), sizeof(read));
+  TEST_EQUAL(read, identifier)
+
+  boost::iostreams::mapped_file_source missing;
+  TEST_EXCEPTION(Exception::FileNotFound, MappedFileHelper::mapFile(missing, "this_file_does_not_exist"))
+}
+END_SECTION
+
+START_SECTION((static bool readTrailer(const boost::iostreams::mapped_file_source& file, UInt64 identifier, void* trailer = 0, Size trailer_size = 0)))
+{
+  boost::iostreams::mapped_file_source file;
+  MappedFileHelper::mapFile(file, tmp_filename);
+  UInt64 read[2] = {0, 0};
+  TEST_EQUAL(MappedFileHelper::readTrailer(file, identifier, read, sizeof(read)), true)
+  TEST_EQUAL(read[0], 4711)
+  TEST_EQUAL(read[1], 815)
+  TEST_EQUAL(MappedFileHelper::readTrailer(file, identifier), true)
+  TEST_EQUAL(MappedFileHelper::readTrailer(file, identifier + 1), false)
+  // the trailer cannot overlap the header
+  UInt64 too_large[3];
+  TEST_EQUAL(MappedFileHelper::readTrailer(file, identifier, too_large, sizeof(too_large)), false)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,345 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetectionConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+#include <cmath>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(MassTraceDetectionConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// synthetic LC-MS map: 60 MS1 spectra (1 s apart) with MS2 spectra in between
+//  - trace A: m/z 300.1, apex at 20 s, one missing peak at 25 s (35 peaks above noise)
+//  - trace B: m/z 450.2, apex at 35 s (23 peaks above noise)
+//  - trace C: m/z 600.3, apex intensity below chrom_peak_snr * noise_threshold_int
+//  - trace D: m/z 800.4, from 50 s until the end of the run (10 peaks)
+PeakMap input;
+for (Size scan = 0; scan < 60; ++scan)
+{
+  MSSpectrum<> spec;
+  spec.setRT(scan);
+  spec.setMSLevel(1);
+  const double d(scan);
+  const double wiggle(1.0 + 2e-6 * std::sin(d));
+  if (scan != 25) spec.push_back(Peak1D(300.1 * wiggle, 1e5 * std::exp(-0.5 * (d - 20) * (d - 20) / 16.0)));
+  spec.push_back(Peak1D(450.2 * wiggle, 1e4 * std::exp(-0.5 * (d - 35) * (d - 35) / 9.0)));
+  spec.push_back(Peak1D(600.3 * wiggle, 25 * std::exp(-0.5 * (d - 10) * (d - 10) / 9.0)));
+  if (scan >= 50) spec.push_back(Peak1D(800.4 * wiggle, 1000.0));
+  input.addSpectrum(spec);
+
+  MSSpectrum<> ms2;
+  ms2.setRT(scan + 0.5);
+  ms2.setMSLevel(2);
+  ms2.push_back(Peak1D(450.2, 1e6));
+  input.addSpectrum(ms2);
+}
+
+// longer run: 120 MS1 spectra (1 s apart) with ten short traces (7 peaks
+// above noise) at m/z 200, 250, ..., 650 and RT 10, 20, ..., 100 s and
+// background peaks (above noise, but no apex) at m/z 100
+PeakMap long_input;
+for (Size scan = 0; scan < 120; ++scan)
+{
+  MSSpectrum<> spec;
+  spec.setRT(scan);
+  spec.setMSLevel(1);
+  spec.push_back(Peak1D(100.0, 20.0));
+  for (Size k = 0; k < 10; ++k)
+  {
+    const double d(double(scan) - 10.0 * (k + 1));
+    if (std::fabs(d) <= 5.0) spec.push_back(Peak1D(200.0 + 50.0 * k, 1e4 * std::exp(-0.5 * d * d)));
+  }
+  long_input.addSpectrum(spec);
+}
+
+std::vector<MassTrace> dummy;
+MassTraceDetectionConsumer* ptr = 0;
+MassTraceDetectionConsumer* null_ptr = 0;
+START_SECTION((MassTraceDetectionConsumer(std::vector<MassTrace>& found_masstraces)))
+{
+  ptr = new MassTraceDetectionConsumer(dummy);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getParameters().exists("mz_stripes"), false)
+  TEST_EQUAL(ptr->getParameters().getValue("trace_termination_outliers"), MassTraceDetection().getParameters().getValue("trace_termination_outliers"))
+  TEST_REAL_SIMILAR(ptr->getParameters().getValue("window_length"), 120.0)
+}
+END_SECTION
+
+START_SECTION((virtual ~MassTraceDetectionConsumer()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((virtual void consumeSpectrum(SpectrumType& s)))
+{
+  // the run is shorter than the window: all spectra are buffered
+  std::vector<MassTrace> traces;
+  MassTraceDetectionConsumer consumer(traces);
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    MSSpectrum<> spec = input[i];
+    consumer.consumeSpectrum(spec);
+  }
+  TEST_EQUAL(traces.size(), 0)
+  TEST_EQUAL(consumer.getNrBufferedSpectra(), 60)
+
+  // spectra need to be ordered by RT
+  MSSpectrum<> spec = input[0];
+  TEST_EXCEPTION(Exception::IllegalArgument, consumer.consumeSpectrum(spec))
+
+  // profile data is rejected with the first spectrum
+  MassTraceDetectionConsumer profile_consumer(traces);
+  spec.setType(SpectrumSettings::RAWDATA);
+  TEST_EXCEPTION(Exception::IllegalArgument, profile_consumer.consumeSpectrum(spec))
+
+  // FWHM meta data needs to be present for all spectra or none
+  MassTraceDetectionConsumer fwhm_consumer(traces);
+  spec = input[0];
+  spec.setType(SpectrumSettings::PEAKS);
+  fwhm_consumer.consumeSpectrum(spec);
+  spec = input[2];
+  spec.getFloatDataArrays().resize(1);
+  spec.getFloatDataArrays()[0].setName("FWHM_ppm");
+  spec.getFloatDataArrays()[0].resize(spec.size(), 5.0);
+  TEST_EXCEPTION(Exception::Precondition, fwhm_consumer.consumeSpectrum(spec))
+
+  // small window: traces are final 10 s after their end
+  std::vector<MassTrace> window_traces;
+  MassTraceDetectionConsumer window_consumer(window_traces);
+  Param p = window_consumer.getParameters();
+  p.setValue("window_length", 10.0);
+  window_consumer.setParameters(p);
+  Size max_buffered(0);
+  for (Size i = 0; i < long_input.size(); ++i)
+  {
+    MSSpectrum<> spec = long_input[i];
+    window_consumer.consumeSpectrum(spec);
+    max_buffered = std::max(max_buffered, window_consumer.getNrBufferedSpectra());
+    if (i == 29) TEST_EQUAL(window_traces.size(), 0)
+    if (i == 30) TEST_EQUAL(window_traces.size(), 1) // trace at 10 s
+  }
+  TEST_EQUAL(max_buffered, 30) // three times the window
+  TEST_EQUAL(window_traces.size(), 9) // trace at 100 s is not final yet
+  ABORT_IF(window_traces.size() != 9)
+  TEST_REAL_SIMILAR(window_traces[0].getCentroidMZ(), 200.0)
+  TEST_REAL_SIMILAR(window_traces[8].getCentroidMZ(), 600.0)
+}
+END_SECTION
+
+START_SECTION((void setAllowProfileData(bool allow)))
+{
+  std::vector<MassTrace> traces;
+  MassTraceDetectionConsumer consumer(traces);
+  consumer.setAllowProfileData(true);
+  MSSpectrum<> spec = input[70]; // 35 s
+  spec.setType(SpectrumSettings::RAWDATA);
+  consumer.consumeSpectrum(spec);
+  TEST_EQUAL(consumer.getNrBufferedSpectra(), 1)
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  std::vector<MassTrace> traces;
+  MassTraceDetectionConsumer consumer(traces);
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    MSSpectrum<> spec = input[i];
+    consumer.consumeSpectrum(spec);
+  }
+  consumer.flush();
+  TEST_EQUAL(consumer.getNrBufferedSpectra(), 0)
+  TEST_EQUAL(traces.size(), 3)
+  ABORT_IF(traces.size() != 3)
+  TEST_EQUAL(traces[0].getSize(), 34)
+  TEST_REAL_SIMILAR(traces[0].getCentroidMZ(), 300.1)
+  TEST_EQUAL(traces[1].getSize(), 23)
+  TEST_REAL_SIMILAR(traces[1].getCentroidMZ(), 450.2)
+  TEST_EQUAL(traces[2].getSize(), 10)
+  TEST_REAL_SIMILAR(traces[2].getCentroidMZ(), 800.4)
+
+  // same traces as MassTraceDetection on the complete map
+  std::vector<MassTrace> traces_mtd;
+  MassTraceDetection().run(input, traces_mtd);
+  TEST_EQUAL(traces_mtd.size(), traces.size())
+  for (Size i = 0; i < std::min(traces.size(), traces_mtd.size()); ++i)
+  {
+    TEST_EQUAL(traces[i].getSize(), traces_mtd[i].getSize())
+    TEST_REAL_SIMILAR(traces[i].getCentroidMZ(), traces_mtd[i].getCentroidMZ())
+    TEST_REAL_SIMILAR(traces[i].getCentroidRT(), traces_mtd[i].getCentroidRT())
+    TEST_EQUAL(traces[i].getLabel(), traces_mtd[i].getLabel())
+  }
+
+  // small window: traces shorter than the window are found as well, sorted by apex intensity
+  std::vector<MassTrace> window_traces;
+  MassTraceDetectionConsumer window_consumer(window_traces);
+  Param p = window_consumer.getParameters();
+  p.setValue("window_length", 10.0);
+  window_consumer.setParameters(p);
+  for (Size i = 0; i < long_input.size(); ++i)
+  {
+    MSSpectrum<> spec = long_input[i];
+    window_consumer.consumeSpectrum(spec);
+  }
+  window_consumer.flush();
+  traces_mtd.clear();
+  MassTraceDetection().run(long_input, traces_mtd);
+  TEST_EQUAL(traces_mtd.size(), 10)
+  TEST_EQUAL(window_traces.size(), traces_mtd.size())
+  for (Size i = 0; i < std::min(window_traces.size(), traces_mtd.size()); ++i)
+  {
+    TEST_EQUAL(window_traces[i].getSize(), traces_mtd[i].getSize())
+    TEST_REAL_SIMILAR(window_traces[i].getCentroidMZ(), traces_mtd[i].getCentroidMZ())
+    TEST_REAL_SIMILAR(window_traces[i].getCentroidRT(), traces_mtd[i].getCentroidRT())
+    TEST_EQUAL(window_traces[i].getLabel(), traces_mtd[i].getLabel())
+  }
+
+  // less than three MS1 spectra are rejected (as by MassTraceDetection)
+  MassTraceDetectionConsumer short_consumer(traces);
+  for (Size i = 0; i < 4; ++i) // two MS1 and two MS2 spectra
+  {
+    MSSpectrum<> spec = input[i];
+    short_consumer.consumeSpectrum(spec);
+  }
+  TEST_EXCEPTION(Exception::InvalidValue, short_consumer.flush())
+  TEST_EQUAL(short_consumer.getNrBufferedSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] comparison with MassTraceDetection on real data))
+{
+  PeakMap real_input;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MassTraceDetection_input1.mzML"), real_input);
+  Param p_mtd = MassTraceDetection().getDefaults();
+  p_mtd.setValue("min_trace_length", 3.0);
+
+  std::vector<MassTrace> traces_mtd;
+  MassTraceDetection mtd;
+  mtd.setParameters(p_mtd);
+  mtd.run(real_input, traces_mtd);
+
+  // the run (33 s) is shorter than the window: same traces as MassTraceDetection
+  std::vector<MassTrace> traces;
+  MassTraceDetectionConsumer consumer(traces);
+  p_mtd.remove("mz_stripes");
+  Param p = consumer.getParameters();
+  p.update(p_mtd);
+  consumer.setParameters(p);
+  for (Size i = 0; i < real_input.size(); ++i)
+  {
+    MSSpectrum<> spec = real_input[i];
+    consumer.consumeSpectrum(spec);
+  }
+  consumer.flush();
+
+  TEST_EQUAL(traces_mtd.size(), 3)
+  TEST_EQUAL(traces.size(), traces_mtd.size())
+  ABORT_IF(traces.size() != 3 || traces_mtd.size() != 3)
+  for (Size i = 0; i < traces.size(); ++i)
+  {
+    TEST_EQUAL(traces[i].getSize(), traces_mtd[i].getSize())
+    TEST_REAL_SIMILAR(traces[i].getCentroidMZ(), traces_mtd[i].getCentroidMZ())
+    TEST_REAL_SIMILAR(traces[i].getCentroidRT(), traces_mtd[i].getCentroidRT())
+    TEST_REAL_SIMILAR(traces[i].computePeakArea(), traces_mtd[i].computePeakArea())
+  }
+
+  // a window of 5 s splits the longest trace (86 peaks, 31 s): only the part around its apex is kept
+  std::vector<MassTrace> window_traces;
+  MassTraceDetectionConsumer window_consumer(window_traces);
+  p.setValue("window_length", 5.0);
+  window_consumer.setParameters(p);
+  for (Size i = 0; i < real_input.size(); ++i)
+  {
+    MSSpectrum<> spec = real_input[i];
+    window_consumer.consumeSpectrum(spec);
+  }
+  window_consumer.flush();
+  TEST_EQUAL(window_traces.size(), 3)
+  ABORT_IF(window_traces.size() != 3)
+  TEST_EQUAL(window_traces[0].getSize(), 56)
+  TEST_EQUAL(window_traces[1].getSize(), traces_mtd[1].getSize())
+  TEST_EQUAL(window_traces[2].getSize(), traces_mtd[2].getSize())
+}
+END_SECTION
+
+START_SECTION((Size getNrBufferedSpectra() const))
+{
+  std::vector<MassTrace> traces;
+  MassTraceDetectionConsumer consumer(traces);
+  TEST_EQUAL(consumer.getNrBufferedSpectra(), 0)
+  MSSpectrum<> spec = input[70]; // 35 s
+  consumer.consumeSpectrum(spec);
+  TEST_EQUAL(consumer.getNrBufferedSpectra(), 1)
+  spec = input[71]; // MS2
+  consumer.consumeSpectrum(spec);
+  TEST_EQUAL(consumer.getNrBufferedSpectra(), 1)
+}
+END_SECTION
+
+START_SECTION((virtual void consumeChromatogram(ChromatogramType&)))
+{
+  NOT_TESTABLE
+}
+END_SECTION
+
+START_SECTION((virtual void setExpectedSize(Size, Size)))
+{
+  NOT_TESTABLE
+}
+END_SECTION
+
+START_SECTION((virtual void setExperimentalSettings(const ExperimentalSettings&)))
+{
+  NOT_TESTABLE
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -172,6 +172,34 @@ START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &)))
       }
 
     }
+
+    // parallel detection in m/z stripes
+    {
+      Param p_stripes(p_mtd);
+      p_stripes.setValue("mz_stripes", 4);
+      MassTraceDetection mtd_stripes;
+      mtd_stripes.setParameters(p_stripes);
+      output_mt.clear();
+      mtd_stripes.run(input, output_mt);
+      TEST_EQUAL(output_mt.size(), 3);
+
+      for (Size i = 0; i < output_mt.size(); ++i)
+      {
+          TEST_EQUAL(output_mt[i].getSize(), exp_mt_lengths[i]);
+          TEST_REAL_SIMILAR(output_mt[i].getCentroidRT(), exp_mt_rts[i]);
+          TEST_REAL_SIMILAR(output_mt[i].getCentroidMZ(), exp_mt_mzs[i]);
+          TEST_REAL_SIMILAR(output_mt[i].computePeakArea(), exp_mt_ints[i]);
+          TEST_EQUAL(output_mt[i].getLabel(), "T" + String(i + 1));
+      }
+    }
+
+    // too few MS1 spectra
+    {
+      PeakMap input_short;
+      input_short.addSpectrum(input[0]);
+      input_short.addSpectrum(input[1]);
+      TEST_EXCEPTION(Exception::InvalidValue, test_mtd.run(input_short, output_mt));
+    }
 }
 END_SECTION
 
@@ -39,6 +39,8 @@
 
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 
+#include <set>
+
 ///////////////////////////
 
 START_TEST(MetaInfoRegistry, "$Id$")
@@ -174,6 +176,49 @@ START_SECTION((MetaInfoRegistry& operator=(const MetaInfoRegistry& rhs)))
 	TEST_STRING_EQUAL(mir2.getUnit("retention time"), "sec")
 END_SECTION
 
+START_SECTION(([EXTRA] registering many names (more than hash buckets) from several threads))
+{
+  MetaInfoRegistry mir2;
+  std::vector<UInt> indices(20000);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < 20000; ++i)
+  {
+    // every name is registered by (up to) two threads
+    indices[i] = mir2.registerName("name_" + String(i / 2));
+  }
+  std::set<UInt> unique_indices;
+  for (Size i = 0; i < 20000; i += 2)
+  {
+    TEST_EQUAL(indices[i], indices[i + 1])
+    unique_indices.insert(indices[i]);
+  }
+  TEST_EQUAL(unique_indices.size(), 10000)
+  TEST_EQUAL(*unique_indices.begin(), 1024)
+  TEST_EQUAL(*unique_indices.rbegin(), 11023)
+  bool all_found = true;
+  for (Size i = 0; i < 10000; ++i)
+  {
+    UInt index = mir2.getIndex("name_" + String(i));
+    all_found &= (index == indices[2 * i]);
+    all_found &= (mir2.getName(index) == "name_" + String(i));
+  }
+  TEST_EQUAL(all_found, true)
+  TEST_STRING_EQUAL(mir2.getName(13), "charge")
+  TEST_EQUAL(mir2.getIndex("charge"), 13)
+  TEST_EQUAL(mir2.getIndex("name_10000"), UInt(-1))
+  TEST_EXCEPTION(Exception::InvalidValue, mir2.getName(11024))
+  TEST_EXCEPTION(Exception::InvalidValue, mir2.getName(100000))
+
+  // copies contain all names
+  MetaInfoRegistry mir3(mir2);
+  TEST_EQUAL(mir3.getIndex("name_9999"), mir2.getIndex("name_9999"))
+  TEST_STRING_EQUAL(mir3.getName(11023), mir2.getName(11023))
+  TEST_EQUAL(mir3.registerName("name_10000"), 11024)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -75,7 +75,29 @@ START_SECTION((void setValue(const String& name, const DataValue& value)))
 END_SECTION
 
 START_SECTION((void setValue(UInt index, const DataValue& value)))
-	NOT_TESTABLE //tested in the get method
+{
+	// the value may refer into the same object, although inserting a new key moves the stored values
+	// (only predefined names are used, so the indices of the registry stay as the other tests expect)
+	MetaInfo tmp;
+	String long_string("a long string that does not fit into a small string buffer");
+	tmp.setValue("label", String("tag"));
+	tmp.setValue("icon", String("kreis"));
+	tmp.setValue("color", long_string);
+	tmp.setValue("RT", 4711.12);
+	tmp.setValue("MZ", String("mz") + long_string);
+	tmp.setValue("predicted_RT", tmp.getValue("color")); // appended
+	tmp.setValue("isotopic_range", tmp.getValue("MZ")); // inserted in front
+	tmp.setValue(2, tmp.getValue(1));
+	TEST_EQUAL(String(tmp.getValue("predicted_RT")), long_string)
+	TEST_EQUAL(String(tmp.getValue("isotopic_range")), String("mz") + long_string)
+	TEST_EQUAL(String(tmp.getValue(2)), String("mz") + long_string)
+	TEST_EQUAL(String(tmp.getValue("label")), "tag")
+	TEST_EQUAL(String(tmp.getValue("color")), long_string)
+	TEST_REAL_SIMILAR(double(tmp.getValue("RT")), 4711.12)
+	// assigning an existing key from itself keeps the value
+	tmp.setValue("label", tmp.getValue("label"));
+	TEST_EQUAL(String(tmp.getValue("label")), "tag")
+}
 END_SECTION
 
 START_SECTION((const DataValue& getValue(UInt index) const))
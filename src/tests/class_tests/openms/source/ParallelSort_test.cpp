@@ -0,0 +1,102 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CONCEPT/ParallelSort.h>
+///////////////////////////
+
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ParallelSort, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION((template <typename RandomAccessIterator, typename Compare> void parallelSort(RandomAccessIterator begin, RandomAccessIterator end, Compare less, Size min_chunk_size = 1)))
+{
+  // empty and single element ranges
+  vector<int> v;
+  parallelSort(v.begin(), v.end(), less<int>());
+  TEST_EQUAL(v.empty(), true)
+  v.push_back(3);
+  parallelSort(v.begin(), v.end(), less<int>());
+  TEST_EQUAL(v[0], 3)
+
+  // sizes that do not split evenly into chunks
+  srand(42);
+  Size sizes[] = {2, 7, 100, 1001, 50000};
+  for (Size s = 0; s < 5; ++s)
+  {
+    v.resize(sizes[s]);
+    for (Size i = 0; i < v.size(); ++i)
+    {
+      v[i] = rand() % 1000;
+    }
+    vector<int> expected(v);
+    sort(expected.begin(), expected.end(), greater<int>());
+    vector<int> w(v);
+    parallelSort(v.begin(), v.end(), greater<int>());
+    TEST_EQUAL(v == expected, true)
+    parallelSort(w.begin(), w.end(), greater<int>(), 10000);
+    TEST_EQUAL(w == expected, true)
+  }
+
+  // a sub-range leaves the rest untouched
+  v.clear();
+  for (int i = 10; i > 0; --i)
+  {
+    v.push_back(i);
+  }
+  parallelSort(v.begin() + 2, v.end() - 2, less<int>());
+  TEST_EQUAL(v[0], 10)
+  TEST_EQUAL(v[1], 9)
+  TEST_EQUAL(v[2], 3)
+  TEST_EQUAL(v[7], 8)
+  TEST_EQUAL(v[8], 2)
+  TEST_EQUAL(v[9], 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -492,4 +492,68 @@ START_SECTION(void pick(const MSSpectrum<PeakType>& input, MSSpectrum<PeakType>&
     
 END_SECTION
 
+START_SECTION([EXTRA] pickExperiment yields the same result as picking each spectrum separately)
+{
+  // synthetic profile spectra with Gaussian peaks, every third one an MS2 scan
+  PeakMap exp_in;
+  for (Size s = 0; s < 25; ++s)
+  {
+    MSSpectrum<Peak1D> spec;
+    spec.setRT(s);
+    spec.setMSLevel(s % 3 == 2 ? 2 : 1);
+    spec.setType(SpectrumSettings::RAWDATA);
+    for (Size i = 0; i < 400; ++i)
+    {
+      const double mz = 400.0 + i * 0.01;
+      const double offset = std::fmod(mz - 400.0 + 0.002 * s, 0.5) - 0.25;
+      Peak1D p;
+      p.setMZ(mz);
+      p.setIntensity(10.0 + (1000.0 + 100.0 * s) * std::exp(-0.5 * offset * offset / 0.0004));
+      spec.push_back(p);
+    }
+    exp_in.addSpectrum(spec);
+  }
+
+  PeakPickerHiRes pp;
+  Param pp_param = pp.getParameters();
+  pp_param.setValue("signal_to_noise", 0.0);
+  pp_param.setValue("ms_levels", ListUtils::create<Int>("1"));
+  pp_param.setValue("report_FWHM", "true");
+  pp.setParameters(pp_param);
+
+  PeakMap exp_out;
+  std::vector<std::vector<PeakPickerHiRes::PeakBoundary> > boundaries_s, boundaries_c;
+  pp.pickExperiment(exp_in, exp_out, boundaries_s, boundaries_c);
+
+  ABORT_IF(exp_out.size() != exp_in.size())
+  Size nr_picked = 0;
+  for (Size s = 0; s < exp_in.size(); ++s)
+  {
+    if (exp_in[s].getMSLevel() != 1)
+    {
+      TEST_EQUAL(exp_out[s] == exp_in[s], true)
+      continue;
+    }
+    MSSpectrum<Peak1D> spec_out;
+    std::vector<PeakPickerHiRes::PeakBoundary> boundaries;
+    pp.pick(exp_in[s], spec_out, boundaries);
+    TEST_EQUAL(spec_out.size(), 8)
+    TEST_EQUAL(exp_out[s] == spec_out, true)
+    ABORT_IF(nr_picked >= boundaries_s.size())
+    ABORT_IF(boundaries_s[nr_picked].size() != boundaries.size())
+    for (Size i = 0; i < boundaries.size(); ++i)
+    {
+      TEST_EQUAL(boundaries_s[nr_picked][i].mz_min, boundaries[i].mz_min)
+      TEST_EQUAL(boundaries_s[nr_picked][i].mz_max, boundaries[i].mz_max)
+    }
+    ++nr_picked;
+  }
+  TEST_EQUAL(boundaries_s.size(), nr_picked)
+
+  // centroided spectra are rejected
+  exp_in[4].setType(SpectrumSettings::PEAKS);
+  TEST_EXCEPTION(Exception::IllegalArgument, pp.pickExperiment(exp_in, exp_out))
+}
+END_SECTION
+
 END_TEST
@@ -183,6 +183,103 @@ START_SECTION((virtual void run(const std::vector<Peak2D> & map_model, const std
 }
 END_SECTION
 
+START_SECTION((void preprocess(const std::vector<Peak2D> & map, PreprocessedMap & result) const))
+{
+  std::vector<Peak2D> map;
+  for (Size i = 0; i < 5; ++i)
+  {
+    Peak2D p;
+    p.setRT(10.0 - i);
+    p.setMZ(100.0 + (i % 3));
+    p.setIntensity(10.0f * (i + 1));
+    map.push_back(p);
+  }
+
+  Param parameters;
+  parameters.setValue("num_used_points", 3);
+  PoseClusteringAffineSuperimposer pcat;
+  pcat.setParameters(parameters);
+
+  PoseClusteringAffineSuperimposer::PreprocessedMap result;
+  pcat.preprocess(map, result);
+  // the three most intense points (i = 2, 3, 4), sorted by m/z
+  TEST_EQUAL(result.points.size(), 3)
+  TEST_REAL_SIMILAR(result.points[0].getMZ(), 100.0)
+  TEST_REAL_SIMILAR(result.points[1].getMZ(), 101.0)
+  TEST_REAL_SIMILAR(result.points[2].getMZ(), 102.0)
+  TEST_REAL_SIMILAR(result.points[2].getIntensity(), 30.0)
+  // RT range of all points
+  TEST_REAL_SIMILAR(result.min_rt, 6.0)
+  TEST_REAL_SIMILAR(result.max_rt, 10.0)
+  TEST_REAL_SIMILAR(result.total_intensity, 120.0)
+
+  pcat.preprocess(std::vector<Peak2D>(), result);
+  TEST_EQUAL(result.points.empty(), true)
+}
+END_SECTION
+
+START_SECTION((void preprocess(const ConsensusMap & map, PreprocessedMap & result) const))
+{
+  ConsensusMap map;
+  Feature feat;
+  feat.setRT(3.0);
+  feat.setMZ(200.0);
+  feat.setIntensity(50.0f);
+  map.push_back(ConsensusFeature(feat));
+
+  PoseClusteringAffineSuperimposer::PreprocessedMap result;
+  PoseClusteringAffineSuperimposer().preprocess(map, result);
+  TEST_EQUAL(result.points.size(), 1)
+  TEST_REAL_SIMILAR(result.points[0].getMZ(), 200.0)
+  TEST_REAL_SIMILAR(result.min_rt, 3.0)
+  TEST_REAL_SIMILAR(result.max_rt, 3.0)
+  TEST_REAL_SIMILAR(result.total_intensity, 50.0)
+}
+END_SECTION
+
+START_SECTION((void run(const PreprocessedMap & map_model, const PreprocessedMap & map_scene, TransformationDescription & transformation) const))
+{
+  std::vector<Peak2D> map_model, map_scene;
+  Peak2D p;
+  p.setIntensity(100.0f);
+  p.setRT(1);
+  p.setMZ(1);
+  map_model.push_back(p);
+  p.setRT(5);
+  p.setMZ(5);
+  map_model.push_back(p);
+  p.setRT(1.4);
+  p.setMZ(1.02);
+  map_scene.push_back(p);
+  p.setRT(5.4);
+  p.setMZ(5.02);
+  map_scene.push_back(p);
+
+  Param parameters;
+  parameters.setValue(String("scaling_bucket_size"), 0.01);
+  parameters.setValue(String("shift_bucket_size"), 0.1);
+  PoseClusteringAffineSuperimposer pcat;
+  pcat.setParameters(parameters);
+
+  PoseClusteringAffineSuperimposer::PreprocessedMap model, scene;
+  pcat.preprocess(map_model, model);
+  pcat.preprocess(map_scene, scene);
+
+  // the preprocessed model can be reused
+  for (Size i = 0; i < 2; ++i)
+  {
+    TransformationDescription transformation;
+    pcat.run(model, scene, transformation);
+    TEST_STRING_EQUAL(transformation.getModelType(), "linear")
+    TEST_REAL_SIMILAR(transformation.getModelParameters().getValue("slope"), 1.0)
+    TEST_REAL_SIMILAR(transformation.getModelParameters().getValue("intercept"), -0.4)
+  }
+
+  TransformationDescription transformation;
+  TEST_EXCEPTION(Exception::IllegalArgument, pcat.run(model, PoseClusteringAffineSuperimposer::PreprocessedMap(), transformation))
+}
+END_SECTION
+
 START_SECTION(([EXTRA]virtual void run(const std::vector<Peak2D> & map_model, const std::vector<Peak2D> & map_scene, TransformationDescription& transformation)))
 {
   std::vector<Peak2D> map_model, map_scene;
@@ -0,0 +1,341 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2016.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArrayIndex.h>
+///////////////////////////
+
+#include <fstream>
+#include <iterator>
+#include <set>
+
+using namespace OpenMS;
+using namespace std;
+
+typedef ProteinSuffixArrayIndex::Occurrence Occurrence;
+
+set<pair<Size, Size> > toSet(const vector<Occurrence>& hits)
+{
+  set<pair<Size, Size> > result;
+  for (Size i = 0; i < hits.size(); ++i)
+  {
+    result.insert(make_pair(hits[i].protein_index, hits[i].position));
+  }
+  return result;
+}
+
+// straightforward implementation of the tolerant matching rules
+bool matchesAt(const String& peptide, const String& protein, Size pos, Size aaa_max, Size mm_max)
+{
+  if (pos + peptide.size() > protein.size()) return false;
+  for (Size i = 0; i < peptide.size(); ++i)
+  {
+    const char p = peptide[i], q = protein[pos + i];
+    const bool p_amb = (p == 'B' || p == 'Z' || p == 'X');
+    const bool q_amb = (q == 'B' || q == 'Z' || q == 'X');
+    bool same_class = (p == q) || p == 'X' || q == 'X' ||
+      (p == 'B' && (q == 'D' || q == 'N')) || (q == 'B' && (p == 'D' || p == 'N')) ||
+      (p == 'Z' && (q == 'E' || q == 'Q')) || (q == 'Z' && (p == 'E' || p == 'Q')) ||
+      (p == 'B' && q == 'B') || (p == 'Z' && q == 'Z');
+    if (same_class)
+    {
+      if (q_amb)
+      {
+        if (aaa_max == 0) return false;
+        --aaa_max;
+      }
+      if (p_amb && p != q) return false;
+    }
+    else
+    {
+      if (mm_max == 0) return false;
+      --mm_max;
+    }
+  }
+  return true;
+}
+
+set<pair<Size, Size> > bruteForce(const String& peptide, const vector<String>& proteins, Size aaa_max, Size mm_max)
+{
+  set<pair<Size, Size> > result;
+  for (Size i = 0; i < proteins.size(); ++i)
+  {
+    for (Size pos = 0; pos < proteins[i].size(); ++pos)
+    {
+      if (matchesAt(peptide, proteins[i], pos, aaa_max, mm_max)) result.insert(make_pair(i, pos));
+    }
+  }
+  return result;
+}
+
+START_TEST(ProteinSuffixArrayIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+vector<String> proteins;
+proteins.push_back("MAAAKPEPTIDERPEPTIDE");
+proteins.push_back("XXXPEPTIDE");
+proteins.push_back("PEPBIDEKAAAK");
+proteins.push_back("edittpepr"); // lower case input is normalized
+proteins.push_back("");
+proteins.push_back("PEPTIDEZQUJ");
+vector<bool> is_decoy(proteins.size(), false);
+is_decoy[3] = true;
+vector<FASTAFile::FASTAEntry> entries;
+for (Size i = 0; i < proteins.size(); ++i)
+{
+  entries.push_back(FASTAFile::FASTAEntry(String("P") + i, String("protein ") + i, proteins[i]));
+}
+
+std::string tmp_filename;
+NEW_TMP_FILE(tmp_filename);
+
+ProteinSuffixArrayIndex* ptr = 0;
+ProteinSuffixArrayIndex* nullPointer = 0;
+
+START_SECTION((static void normalizeSequence(String& sequence)))
+{
+  String seq("peptideBZXJUO*#");
+  ProteinSuffixArrayIndex::normalizeSequence(seq);
+  TEST_EQUAL(seq, "PEPTIDEBZXXXX*X")
+}
+END_SECTION
+
+START_SECTION((static void build(const String& filename, const std::vector<String>& proteins, const std::vector<bool>& is_decoy, UInt64 key, const std::vector<FASTAFile::FASTAEntry>& entries = std::vector<FASTAFile::FASTAEntry>())))
+{
+  ProteinSuffixArrayIndex::build(tmp_filename, proteins, is_decoy, 12345, entries);
+  UInt64 key = 0;
+  TEST_EQUAL(ProteinSuffixArrayIndex::readKey(tmp_filename, key), true)
+  TEST_EQUAL(key, 12345)
+
+  TEST_EXCEPTION(Exception::InvalidSize, ProteinSuffixArrayIndex::build(tmp_filename, proteins, vector<bool>(2), 1))
+  TEST_EXCEPTION(Exception::InvalidSize, ProteinSuffixArrayIndex::build(tmp_filename, proteins, is_decoy, 1, vector<FASTAFile::FASTAEntry>(2)))
+}
+END_SECTION
+
+START_SECTION((static bool readKey(const String& filename, UInt64& key)))
+{
+  UInt64 key = 0;
+  TEST_EQUAL(ProteinSuffixArrayIndex::readKey("this_file_does_not_exist.idx", key), false)
+  TEST_EQUAL(ProteinSuffixArrayIndex::readKey(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), key), false)
+  TEST_EQUAL(key, 0)
+}
+END_SECTION
+
+START_SECTION((explicit ProteinSuffixArrayIndex(const String& filename)))
+{
+  ptr = new ProteinSuffixArrayIndex(tmp_filename);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getFilename(), tmp_filename)
+
+  TEST_EXCEPTION(Exception::FileNotFound, ProteinSuffixArrayIndex("this_file_does_not_exist.idx"))
+  TEST_EXCEPTION(Exception::ParseError, ProteinSuffixArrayIndex(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+
+  // a truncated file is detected
+  std::string truncated_filename;
+  NEW_TMP_FILE(truncated_filename);
+  {
+    std::ifstream ifs(tmp_filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    std::ofstream ofs(truncated_filename.c_str(), std::ios::binary);
+    ofs.write(content.c_str(), content.size() - 16);
+  }
+  TEST_EXCEPTION(Exception::ParseError, ProteinSuffixArrayIndex(String(truncated_filename)))
+}
+END_SECTION
+
+START_SECTION((UInt64 getKey() const))
+{
+  TEST_EQUAL(ptr->getKey(), 12345)
+}
+END_SECTION
+
+START_SECTION((Size getNrProteins() const))
+{
+  TEST_EQUAL(ptr->getNrProteins(), 6)
+}
+END_SECTION
+
+START_SECTION((String getProteinSequence(Size index) const))
+{
+  TEST_EQUAL(ptr->getProteinSequence(0), "MAAAKPEPTIDERPEPTIDE")
+  TEST_EQUAL(ptr->getProteinSequence(3), "EDITTPEPR")
+  TEST_EQUAL(ptr->getProteinSequence(4), "")
+  TEST_EQUAL(ptr->getProteinSequence(5), "PEPTIDEZQXX")
+}
+END_SECTION
+
+START_SECTION((bool hasEntries() const))
+{
+  TEST_EQUAL(ptr->hasEntries(), true)
+
+  std::string no_entries_filename;
+  NEW_TMP_FILE(no_entries_filename);
+  ProteinSuffixArrayIndex::build(no_entries_filename, proteins, is_decoy, 1);
+  ProteinSuffixArrayIndex no_entries(no_entries_filename);
+  TEST_EQUAL(no_entries.hasEntries(), false)
+  TEST_EQUAL(no_entries.getAccession(0), "")
+  TEST_EQUAL(no_entries.getEntry(0).sequence, "")
+  TEST_EQUAL(no_entries.getProteinSequence(0), "MAAAKPEPTIDERPEPTIDE")
+}
+END_SECTION
+
+START_SECTION((String getAccession(Size index) const))
+{
+  TEST_EQUAL(ptr->getAccession(0), "P0")
+  TEST_EQUAL(ptr->getAccession(5), "P5")
+}
+END_SECTION
+
+START_SECTION((FASTAFile::FASTAEntry getEntry(Size index) const))
+{
+  for (Size i = 0; i < entries.size(); ++i)
+  {
+    TEST_EQUAL(ptr->getEntry(i) == entries[i], true)
+  }
+  // the original sequence is stored, not the normalized one
+  TEST_EQUAL(ptr->getEntry(3).sequence, "edittpepr")
+  TEST_EQUAL(ptr->getEntry(4).sequence, "")
+}
+END_SECTION
+
+START_SECTION((bool isDecoy(Size index) const))
+{
+  TEST_EQUAL(ptr->isDecoy(0), false)
+  TEST_EQUAL(ptr->isDecoy(3), true)
+}
+END_SECTION
+
+START_SECTION((bool hasAmbiguousAA(Size index) const))
+{
+  TEST_EQUAL(ptr->hasAmbiguousAA(0), false)
+  TEST_EQUAL(ptr->hasAmbiguousAA(1), true)
+  TEST_EQUAL(ptr->hasAmbiguousAA(2), true)
+  TEST_EQUAL(ptr->hasAmbiguousAA(3), false)
+  TEST_EQUAL(ptr->hasAmbiguousAA(5), true)
+}
+END_SECTION
+
+START_SECTION((void findExact(const String& peptide, std::vector<Occurrence>& hits) const))
+{
+  vector<Occurrence> hits;
+  ptr->findExact("PEPTIDE", hits);
+  set<pair<Size, Size> > found = toSet(hits);
+  TEST_EQUAL(found.size(), 4)
+  TEST_EQUAL(found.count(make_pair(0, 5)), 1)
+  TEST_EQUAL(found.count(make_pair(0, 13)), 1)
+  TEST_EQUAL(found.count(make_pair(1, 3)), 1)
+  TEST_EQUAL(found.count(make_pair(5, 0)), 1)
+
+  ptr->findExact("AAAK", hits);
+  found = toSet(hits);
+  TEST_EQUAL(found.size(), 2)
+  TEST_EQUAL(found.count(make_pair(0, 1)), 1)
+  TEST_EQUAL(found.count(make_pair(2, 8)), 1)
+
+  // peptides do not span protein boundaries
+  ptr->findExact("PEPTIDEX", hits);
+  TEST_EQUAL(hits.size(), 0)
+  ptr->findExact("EPREDIT", hits);
+  TEST_EQUAL(hits.size(), 0)
+  ptr->findExact("", hits);
+  TEST_EQUAL(hits.size(), 0)
+
+  // ambiguous AA's only match exactly
+  ptr->findExact("PEPBIDE", hits);
+  TEST_EQUAL(hits.size(), 1)
+}
+END_SECTION
+
+START_SECTION((void findTolerant(const String& peptide, Size aaa_max, Size mismatches_max, std::vector<Occurrence>& hits) const))
+{
+  vector<Occurrence> hits;
+  // 'B' in protein 2 matches 'T' only as a mismatch, 'XXX' in protein 1 matches anything
+  ptr->findTolerant("PEPDIDE", 0, 0, hits);
+  TEST_EQUAL(hits.size(), 0)
+  ptr->findTolerant("PEPDIDE", 1, 0, hits);
+  TEST_EQUAL(toSet(hits).count(make_pair(2, 0)), 1)
+  TEST_EQUAL(hits.size(), 1)
+  ptr->findTolerant("AAAPEPTIDE", 2, 0, hits);
+  TEST_EQUAL(hits.size(), 0)
+  ptr->findTolerant("AAAPEPTIDE", 3, 0, hits);
+  TEST_EQUAL(hits.size(), 1)
+  ptr->findTolerant("PEPTIDE", 0, 1, hits);
+  TEST_EQUAL(toSet(hits).count(make_pair(2, 0)), 1)
+
+  // compare with brute force matching
+  vector<String> normalized(proteins);
+  for (Size i = 0; i < normalized.size(); ++i)
+  {
+    ProteinSuffixArrayIndex::normalizeSequence(normalized[i]);
+  }
+  const char* peptides[] = {"PEPTIDE", "AAAK", "PEPNIDE", "EDITT", "XXX", "BIDE", "PEPTIDEEQ", "DE", "AAAKPEPTIDERPEPTIDE", "ZQ", "K"};
+  Size mismatches = 0;
+  for (Size p = 0; p < sizeof(peptides) / sizeof(peptides[0]); ++p)
+  {
+    for (Size aaa = 0; aaa <= 3; ++aaa)
+    {
+      for (Size mm = 0; mm <= 2; ++mm)
+      {
+        ptr->findTolerant(peptides[p], aaa, mm, hits);
+        if (toSet(hits) != bruteForce(peptides[p], normalized, aaa, mm) || toSet(hits).size() != hits.size())
+        {
+          ++mismatches;
+        }
+      }
+    }
+    // without any tokens, tolerant search equals exact search (for peptides without AAA's)
+    if (String(peptides[p]).find_first_of("BZX") == String::npos)
+    {
+      ptr->findExact(peptides[p], hits);
+      if (toSet(hits) != bruteForce(peptides[p], normalized, 0, 0)) ++mismatches;
+    }
+  }
+  TEST_EQUAL(mismatches, 0)
+}
+END_SECTION
+
+START_SECTION((~ProteinSuffixArrayIndex()))
+{
+  delete ptr;
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -114,6 +114,43 @@ START_SECTION([EXTRA](virtual void init(const PeakIterator& it_begin, const Peak
 
 END_SECTION
 
+START_SECTION([EXTRA] reuse of one estimator for several containers)
+{
+  MSSpectrum < > raw_data;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+  // second container: reversed intensities
+  MSSpectrum < > raw_data2 = raw_data;
+  for (Size i = 0; i < raw_data2.size(); ++i)
+  {
+    raw_data2[i].setIntensity(raw_data[raw_data.size() - 1 - i].getIntensity());
+  }
+
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+
+  SignalToNoiseEstimatorMedian< MSSpectrum < > > sne_reused, sne1, sne2;
+  sne_reused.setParameters(p);
+  sne1.setParameters(p);
+  sne2.setParameters(p);
+  sne1.init(raw_data);
+  sne2.init(raw_data2);
+
+  sne_reused.init(raw_data);
+  for (Size i = 0; i < raw_data.size(); ++i)
+  {
+    TEST_EQUAL(sne_reused.getSignalToNoise(raw_data[i]), sne1.getSignalToNoise(raw_data[i]))
+  }
+  sne_reused.init(raw_data2);
+  for (Size i = 0; i < raw_data2.size(); ++i)
+  {
+    TEST_EQUAL(sne_reused.getSignalToNoise(raw_data2[i]), sne2.getSignalToNoise(raw_data2[i]))
+  }
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -170,6 +170,39 @@ START_SECTION((void run(const std::vector<ConsensusMap>& input_maps, ConsensusMa
 }
 END_SECTION
 
+START_SECTION((void run(const ConsensusMap& map_0, const ConsensusMap& map_1, ConsensusMap& result_map) const))
+{
+  std::vector<ConsensusMap> input(2);
+  for (Size i = 0; i < 3; ++i)
+  {
+    Feature feat;
+    feat.setPosition(PositionType(200.0 * i, 200.0 * i + 100.0));
+    feat.setIntensity(100.0f * (i + 1));
+    feat.setUniqueId(i);
+    input[0].push_back(ConsensusFeature(0, feat));
+    feat.setPosition(PositionType(200.0 * i + 4, 200.0 * i + 100.04));
+    input[1].push_back(ConsensusFeature(1, feat));
+  }
+  input[0].getFileDescriptions()[0].size = 3;
+  input[1].getFileDescriptions()[1].size = 3;
+
+  const StablePairFinder spf;
+  ConsensusMap result, result_vector;
+  spf.run(input[0], input[1], result);
+  StablePairFinder().run(input, result_vector);
+  TEST_EQUAL(result.size(), 3)
+  ABORT_IF(result.size() != 3)
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    TEST_EQUAL(result[i].size(), 2)
+    TEST_EQUAL(result[i] == result_vector[i], true)
+  }
+
+  // file ids must differ
+  TEST_EXCEPTION(Exception::IllegalArgument, spf.run(input[0], input[0], result))
+}
+END_SECTION
+
 START_SECTION(([EXTRA] void run(const std::vector<ConsensusMap>& input_maps, ConsensusMap &result_map)))
 {
 	// test quality calculation:
@@ -38,6 +38,7 @@
 ///////////////////////////
 
 #include <iostream>
+#include <set>
 
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
@@ -311,6 +312,106 @@ START_SECTION(void getSpectrum(RichPeakSpectrum& spec, const AASequence& peptide
   }
 END_SECTION
 
+START_SECTION((String IonAnnotation::toString() const))
+{
+  TheoreticalSpectrumGenerator::IonAnnotation annotation;
+  annotation.type = Residue::YIon;
+  annotation.charge = 2;
+  annotation.index = 13;
+  TEST_STRING_EQUAL(annotation.toString(), "y13++")
+  annotation.type = Residue::AIon;
+  annotation.charge = 1;
+  annotation.index = 1;
+  TEST_STRING_EQUAL(annotation.toString(), "a1+")
+}
+END_SECTION
+
+START_SECTION((void getIonMZs(std::vector<double>& mz, const AASequence& peptide, Int charge = 1, std::vector<IonAnnotation>* annotations = 0) const))
+{
+  std::vector<AASequence> peptides;
+  peptides.push_back(peptide);
+  peptides.push_back(AASequence::fromString("(Acetyl)DFPIANGER(Amidated)"));
+  peptides.push_back(AASequence::fromString("PEPTM(Oxidation)IDEKCCR"));
+  peptides.push_back(AASequence::fromString("GK"));
+  // longer than the stack buffer for residue masses
+  peptides.push_back(AASequence::fromString(String(30, 'A') + String(30, 'G') + String(20, 'K')));
+
+  std::vector<double> mz;
+  std::vector<TheoreticalSpectrumGenerator::IonAnnotation> annotations;
+  for (Size setting = 0; setting < 4; ++setting)
+  {
+    Param param;
+    param.setValue("add_metainfo", "true");
+    param.setValue("add_first_prefix_ion", (setting % 2) ? "true" : "false");
+    if (setting >= 2)
+    {
+      param.setValue("add_a_ions", "true");
+      param.setValue("add_c_ions", "true");
+      param.setValue("add_x_ions", "true");
+      param.setValue("add_z_ions", "true");
+    }
+    TheoreticalSpectrumGenerator t_gen;
+    t_gen.setParameters(param);
+
+    for (Size p = 0; p < peptides.size(); ++p)
+    {
+      for (Int charge = 1; charge <= 5; charge += 2)
+      {
+        RichPeakSpectrum spec;
+        t_gen.getSpectrum(spec, peptides[p], charge);
+        t_gen.getIonMZs(mz, peptides[p], charge, &annotations);
+
+        TEST_EQUAL(mz.size(), spec.size())
+        ABORT_IF(mz.size() != spec.size())
+        TEST_EQUAL(annotations.size(), spec.size())
+        bool sorted = true, same_mz = true;
+        std::multiset<String> names, expected_names;
+        for (Size i = 0; i < mz.size(); ++i)
+        {
+          sorted = sorted && (i == 0 || mz[i - 1] <= mz[i]);
+          same_mz = same_mz && (fabs(mz[i] - spec[i].getMZ()) < 1e-9);
+          names.insert(annotations[i].toString());
+          expected_names.insert(spec[i].getMetaValue("IonName").toString());
+        }
+        TEST_EQUAL(sorted, true)
+        TEST_EQUAL(same_mz, true)
+        TEST_EQUAL(names == expected_names, true)
+      }
+    }
+  }
+
+  // annotations are optional, buffers are reset
+  TheoreticalSpectrumGenerator t_gen;
+  t_gen.getIonMZs(mz, peptide, 1);
+  TEST_EQUAL(mz.size(), 11) // b2-b6, y1-y6
+  t_gen.getIonMZs(mz, AASequence(), 1, &annotations);
+  TEST_EQUAL(mz.empty(), true)
+  TEST_EQUAL(annotations.empty(), true)
+
+  Param param;
+  param.setValue("add_c_ions", "true");
+  t_gen.setParameters(param);
+  TEST_EXCEPTION(Exception::InvalidSize, t_gen.getIonMZs(mz, AASequence::fromString("R"), 1))
+}
+END_SECTION
+
+START_SECTION((void getIonMZs(std::vector<float>& mz, const AASequence& peptide, Int charge = 1, std::vector<IonAnnotation>* annotations = 0) const))
+{
+  TheoreticalSpectrumGenerator t_gen;
+  std::vector<double> mz;
+  std::vector<float> mz_float;
+  t_gen.getIonMZs(mz, peptide, 2);
+  t_gen.getIonMZs(mz_float, peptide, 2);
+  TEST_EQUAL(mz_float.size(), mz.size())
+  ABORT_IF(mz_float.size() != mz.size())
+  TOLERANCE_ABSOLUTE(0.001)
+  for (Size i = 0; i < mz.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(mz_float[i], mz[i])
+  }
+}
+END_SECTION
+
 START_SECTION(([EXTRA] bugfix test where losses lead to formulae with negative element frequencies))
 {
   AASequence tmp_aa = AASequence::fromString("RDAGGPALKK");
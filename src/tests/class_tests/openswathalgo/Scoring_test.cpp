@@ -200,8 +200,8 @@ BOOST_AUTO_TEST_CASE(test_calculateCrossCorrelation)
   Scoring::standardize_data(data1);
   Scoring::standardize_data(data2);
 
-  std::map<int, double> result = Scoring::calculateCrossCorrelation(data1, data2, 2, 1);
-  for(std::map<int, double>::iterator it = result.begin(); it != result.end(); it++)
+  Scoring::XCorrArrayType result = Scoring::calculateCrossCorrelation(data1, data2, 2, 1);
+  for(Scoring::XCorrArrayType::iterator it = result.begin(); it != result.end(); it++)
   {
     it->second = it->second / 6.0;
   }
@@ -231,7 +231,7 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
   std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
   std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
 
-  std::map<int, double> result = Scoring::normalizedCrossCorrelation(data1, data2, 2, 1);
+  Scoring::XCorrArrayType result = Scoring::normalizedCrossCorrelation(data1, data2, 2, 1);
 
   TEST_REAL_SIMILAR (result.find( 2)->second, -0.7374631);
   TEST_REAL_SIMILAR (result.find( 1)->second, -0.567846);
@@ -242,6 +242,36 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelationPost)
+{
+  static const double arr1[] = {0,1,3,5,2,0};
+  static const double arr2[] = {1,3,5,2,0,0};
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+
+  Scoring::standardize_data(data1);
+  Scoring::standardize_data(data2);
+
+  Scoring::XCorrArrayType result;
+  Scoring::normalizedCrossCorrelationPost(data1, data2, 2, 1, result);
+
+  TEST_EQUAL (result.size(), 5)
+  TEST_EQUAL (result.begin()->first, -2)
+  TEST_REAL_SIMILAR (result.find( 2)->second, -0.7374631);
+  TEST_REAL_SIMILAR (result.find( 1)->second, -0.567846);
+  TEST_REAL_SIMILAR (result.find( 0)->second,  0.4159292);
+  TEST_REAL_SIMILAR (result.find(-1)->second,  0.8215339);
+  TEST_REAL_SIMILAR (result.find(-2)->second,  0.15634218);
+  TEST_EQUAL (result.find(3) == result.end(), true)
+
+  // the result is overwritten
+  Scoring::normalizedCrossCorrelationPost(data1, data2, 1, 1, result);
+  TEST_EQUAL (result.size(), 3)
+  TEST_REAL_SIMILAR (result.find( 0)->second,  0.4159292);
+  TEST_EQUAL (Scoring::xcorrArrayGetMaxPeak(result)->first, -1)
+}
+END_SECTION
+
 BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calcxcorr_legacy_mquest_)
 //START_SECTION((MRMFeatureScoring::XCorrArrayType MRMFeatureScoring::calcxcorr(std::vector<double>& data1, std::vector<double>& data2, bool normalize)))
 {
@@ -251,7 +281,7 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calcxcorr_legacy_mquest_)
   std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
   std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
 
-  std::map<int, double> result = Scoring::calcxcorr_legacy_mquest_(data1, data2, true);
+  Scoring::XCorrArrayType result = Scoring::calcxcorr_legacy_mquest_(data1, data2, true);
 
   TEST_REAL_SIMILAR (result.find( 2)->second, -0.7374631);
   TEST_REAL_SIMILAR (result.find( 1)->second, -0.567846);
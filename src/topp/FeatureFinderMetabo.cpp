@@ -37,6 +37,9 @@
 #include <OpenMS/KERNEL/FeatureMap.h>
 #include <OpenMS/KERNEL/MassTrace.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetectionConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataChainingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/ElutionPeakDetection.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
@@ -94,6 +97,15 @@ using namespace std;
   @endcode
   By default, the linear model is used.
 
+  For very long runs, the flag 'low_memory' detects mass traces while the
+  input is read, i.e. the peaks of the input file are never held in memory
+  at once (see @ref OpenMS::MassTraceDetectionConsumer). Mass traces are
+  detected as in the default mode (apex-first), but on a sliding retention
+  time window of about three times 'low_memory_window' seconds. The result
+  is identical if the window covers the run; otherwise traces longer than
+  the window may be split. The window should therefore be well above the
+  expected chromatographic peak width.
+
   <B>The command line parameters of this tool are:</B>
   @verbinclude TOPP_FeatureFinderMetabo.cli
   <B>INI file documentation of this tool:</B>
@@ -103,6 +115,12 @@ using namespace std;
 // We do not want this class to show up in the docu:
 /// @cond TOPPCLASSES
 
+/// drops the peaks of a spectrum after mass trace detection (low memory mode: only the spectrum meta data is kept)
+void clearPeaks(MSSpectrum<>& s)
+{
+  s.clear(false);
+}
+
 class TOPPFeatureFinderMetabo :
   public TOPPBase
 {
@@ -120,6 +138,9 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("mzML"));
     registerOutputFile_("out", "<file>", "", "FeatureXML file with metabolite features");
     setValidFormats_("out", ListUtils::create<String>("featureXML"));
+    registerFlag_("low_memory", "Detect mass traces while reading the input, so memory does not grow with the length of the run (see 'low_memory_window').", true);
+    registerDoubleOption_("low_memory_window", "<seconds>", 120.0, "Retention time window for 'low_memory' mode. Traces are detected on about three times this length of spectra at once; traces longer than the window may be split.", false, true);
+    setMinFloat_("low_memory_window", 1.0);
 
     addEmptyLine_();
     registerSubsection_("algorithm", "Algorithm parameters section");
@@ -170,6 +191,25 @@ protected:
     String in = getStringOption_("in");
     String out = getStringOption_("out");
 
+    //-------------------------------------------------------------
+    // set parameters
+    //-------------------------------------------------------------
+
+    Param common_param = getParam_().copy("algorithm:common:", true);
+    writeDebug_("Common parameters passed to sub-algorithms (mtd and ffm)", common_param, 3);
+
+    Param mtd_param = getParam_().copy("algorithm:mtd:", true);
+    writeDebug_("Parameters passed to MassTraceDetection", mtd_param, 3);
+
+    Param epd_param = getParam_().copy("algorithm:epd:", true);
+    writeDebug_("Parameters passed to ElutionPeakDetection", epd_param, 3);
+
+    Param ffm_param = getParam_().copy("algorithm:ffm:", true);
+    writeDebug_("Parameters passed to FeatureFindingMetabo", ffm_param, 3);
+
+    mtd_param.insert("", common_param);
+    mtd_param.remove("chrom_fwhm");
+
     //-------------------------------------------------------------
     // loading input
     //-------------------------------------------------------------
@@ -178,58 +218,70 @@ protected:
     PeakMap ms_peakmap;
     std::vector<Int> ms_level(1, 1);
     mz_data_file.getOptions().setMSLevels(ms_level);
-    mz_data_file.load(in, ms_peakmap);
 
-    if (ms_peakmap.empty())
-    {
-      LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.";
-      return INCOMPATIBLE_INPUT_DATA;
-    }
-
-    // determine type of spectral data (profile or centroided)
-    SpectrumSettings::SpectrumType spectrum_type = ms_peakmap[0].getType();
+    vector<MassTrace> m_traces;
 
-    if (spectrum_type == SpectrumSettings::RAWDATA)
+    if (getFlag_("low_memory"))
     {
-      if (!getFlag_("force"))
+      //-------------------------------------------------------------
+      // mass trace detection while loading (keeps only the spectrum meta data)
+      //-------------------------------------------------------------
+      MassTraceDetectionConsumer mtd_consumer(m_traces);
+      mtd_param.remove("mz_stripes");
+      mtd_param.setValue("window_length", getDoubleOption_("low_memory_window"));
+      mtd_consumer.setParameters(mtd_param);
+      // profile data is rejected with the first spectrum (not after the whole run was processed)
+      mtd_consumer.setAllowProfileData(getFlag_("force"));
+      MSDataTransformingConsumer peak_dropping_consumer;
+      peak_dropping_consumer.setSpectraProcessingPtr(&clearPeaks);
+
+      MSDataChainingConsumer chaining_consumer;
+      chaining_consumer.appendConsumer(&mtd_consumer);
+      chaining_consumer.appendConsumer(&peak_dropping_consumer);
+      mz_data_file.transform(in, &chaining_consumer, ms_peakmap, true);
+      if (!ms_peakmap.empty()) // reported below
       {
-        throw OpenMS::Exception::FileEmpty(__FILE__, __LINE__, __FUNCTION__,
-            "Error: Profile data provided but centroided spectra expected. To enforce processing of the data set the -force flag.");
+        mtd_consumer.flush(); // rejects runs with less than three spectra (like MassTraceDetection)
       }
     }
+    else
+    {
+      mz_data_file.load(in, ms_peakmap);
+    }
 
-    // make sure the spectra are sorted by m/z
-    ms_peakmap.sortSpectra(true);
-
-    vector<MassTrace> m_traces;
+    if (ms_peakmap.empty())
+    {
+      LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.";
+      return INCOMPATIBLE_INPUT_DATA;
+    }
 
     //-------------------------------------------------------------
-    // set parameters
+    // configure and run mass trace detection
     //-------------------------------------------------------------
 
-    Param common_param = getParam_().copy("algorithm:common:", true);
-    writeDebug_("Common parameters passed to sub-algorithms (mtd and ffm)", common_param, 3);
-
-    Param mtd_param = getParam_().copy("algorithm:mtd:", true);
-    writeDebug_("Parameters passed to MassTraceDetection", mtd_param, 3);
-
-    Param epd_param = getParam_().copy("algorithm:epd:", true);
-    writeDebug_("Parameters passed to ElutionPeakDetection", epd_param, 3);
+    if (!getFlag_("low_memory"))
+    {
+      // determine type of spectral data (profile or centroided)
+      SpectrumSettings::SpectrumType spectrum_type = ms_peakmap[0].getType();
 
-    Param ffm_param = getParam_().copy("algorithm:ffm:", true);
-    writeDebug_("Parameters passed to FeatureFindingMetabo", ffm_param, 3);
+      if (spectrum_type == SpectrumSettings::RAWDATA)
+      {
+        if (!getFlag_("force"))
+        {
+          throw OpenMS::Exception::FileEmpty(__FILE__, __LINE__, __FUNCTION__,
+              "Error: Profile data provided but centroided spectra expected. To enforce processing of the data set the -force flag.");
+        }
+      }
 
-    //-------------------------------------------------------------
-    // configure and run mass trace detection
-    //-------------------------------------------------------------
+      // make sure the spectra are sorted by m/z
+      ms_peakmap.sortSpectra(true);
 
-    MassTraceDetection mtdet;
-    mtd_param.insert("", common_param);
-    mtd_param.remove("chrom_fwhm");
-    mtdet.setParameters(mtd_param);
+      MassTraceDetection mtdet;
+      mtdet.setParameters(mtd_param);
 
-    mtdet.run(ms_peakmap, m_traces);
+      mtdet.run(ms_peakmap, m_traces);
+    }
 
 
     //-------------------------------------------------------------
@@ -75,9 +75,9 @@ protected:
   void registerOptionsAndFlags_()   // only for "unlabeled" algorithms!
   {
     registerInputFileList_("in", "<files>", ListUtils::create<String>(""), "input files separated by blanks", true);
-    setValidFormats_("in", ListUtils::create<String>("featureXML,consensusXML"));
+    setValidFormats_("in", ListUtils::create<String>("featureXML,consensusXML,featureBin,consensusBin"));
     registerOutputFile_("out", "<file>", "", "Output file", true);
-    setValidFormats_("out", ListUtils::create<String>("consensusXML"));
+    setValidFormats_("out", ListUtils::create<String>("consensusXML,consensusBin"));
     addEmptyLine_();
     registerFlag_("keep_subelements", "For consensusXML input only: If set, the sub-features of the inputs are transferred to the output.");
   }
@@ -120,15 +120,13 @@ protected:
     // load input
     ConsensusMap out_map;
     StringList ms_run_locations;
-    if (file_type == FileTypes::FEATUREXML)
+    if (file_type == FileTypes::FEATUREXML || file_type == FileTypes::FEATUREBIN)
     {
       vector<ConsensusMap > maps(ins.size());
-      FeatureXMLFile f;
-      FeatureFileOptions param = f.getOptions();
+      FileHandler f;
       // to save memory don't load convex hulls and subordinates
-      param.setLoadSubordinates(false);
-      param.setLoadConvexHull(false);
-      f.setOptions(param);
+      f.getFeatOptions().setLoadSubordinates(false);
+      f.getFeatOptions().setLoadConvexHull(false);
 
       Size progress = 0;
       setLogType(ProgressLogger::CMD);
@@ -136,7 +134,7 @@ protected:
       for (Size i = 0; i < ins.size(); ++i)
       {
         FeatureMap tmp;
-        f.load(ins[i], tmp);
+        f.loadFeatures(ins[i], tmp, file_type);
         out_map.getFileDescriptions()[i].filename = ins[i];
         out_map.getFileDescriptions()[i].size = tmp.size();
         out_map.getFileDescriptions()[i].unique_id = tmp.getUniqueId();
@@ -176,10 +174,10 @@ protected:
     else
     {
       vector<ConsensusMap> maps(ins.size());
-      ConsensusXMLFile f;
+      FileHandler f;
       for (Size i = 0; i < ins.size(); ++i)
       {
-        f.load(ins[i], maps[i]);
+        f.loadConsensusFeatures(ins[i], maps[i], file_type);
         maps[i].updateRanges();
         // copy over information on the primary MS run
         const StringList& ms_runs = maps[i].getPrimaryMSRunPath();
@@ -207,6 +205,17 @@ protected:
       }
     }
 
+    // set primary MS runs
+    out_map.setPrimaryMSRunPath(ms_run_locations);
+
+    writeResult_(out_map, out);
+
+    return EXECUTION_OK;
+  }
+
+  /// Assigns unique ids and data processing info, writes @p out_map to @p out and logs statistics
+  void writeResult_(ConsensusMap& out_map, const String& out)
+  {
     // assign unique ids
     out_map.applyMemberFunction(&UniqueIdInterface::setUniqueId);
 
@@ -214,11 +223,8 @@ protected:
     addDataProcessing_(out_map,
                        getProcessingInfo_(DataProcessing::FEATURE_GROUPING));
 
-    // set primary MS runs
-    out_map.setPrimaryMSRunPath(ms_run_locations);
-
     // write output
-    ConsensusXMLFile().store(out, out_map);
+    FileHandler().storeConsensusFeatures(out, out_map);
 
     // some statistics
     map<Size, UInt> num_consfeat_of_size;
@@ -236,8 +242,6 @@ protected:
                << i->second << endl;
     }
     LOG_INFO << "  total:      " << setw(6) << out_map.size() << endl;
-
-    return EXECUTION_OK;
   }
 
 };
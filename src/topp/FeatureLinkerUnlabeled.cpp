@@ -32,6 +32,7 @@
 // $Authors: Marc Sturm, Clemens Groepl, Steffen Sass $
 // --------------------------------------------------------------------------
 #include <OpenMS/ANALYSIS/MAPMATCHING/FeatureGroupingAlgorithmUnlabeled.h>
+#include <OpenMS/FORMAT/ColumnarFeatureFile.h>
 
 #include "FeatureLinkerBase.cpp"
 
@@ -152,14 +153,14 @@ protected:
     // load input
     ConsensusMap out_map;
     StringList ms_run_locations;
-    if (file_type == FileTypes::FEATUREXML)
+    if (file_type == FileTypes::FEATUREXML || file_type == FileTypes::FEATUREBIN)
     {
       // use map with highest number of features as reference:
       Size max_count(0);
       FeatureXMLFile f;
       for (Size i = 0; i < ins.size(); ++i)
       {
-        Size s = f.loadSize(ins[i]);
+        Size s = (file_type == FileTypes::FEATUREBIN) ? ColumnarFeatureFile(ins[i]).size() : f.loadSize(ins[i]);
         if (s > max_count)
         {
           max_count = s;
@@ -174,10 +175,10 @@ protected:
       std::vector<ProteinIdentification> ref_protids;
       {
         FeatureMap map_ref;
-        FeatureXMLFile f_fxml_tmp;
-        f_fxml_tmp.getOptions().setLoadConvexHull(false);
-        f_fxml_tmp.getOptions().setLoadSubordinates(false);
-        f_fxml_tmp.load(ins[reference_index], map_ref);
+        FileHandler f_fxml_tmp;
+        f_fxml_tmp.getFeatOptions().setLoadConvexHull(false);
+        f_fxml_tmp.getFeatOptions().setLoadSubordinates(false);
+        f_fxml_tmp.loadFeatures(ins[reference_index], map_ref, file_type);
         algorithm->setReference(reference_index, map_ref);
         ref_id = map_ref.getUniqueId();
         ref_size = map_ref.size();
@@ -190,11 +191,11 @@ protected:
       for (Size i = 0; i < ins.size(); ++i)
       {
 
-        FeatureXMLFile f_fxml_tmp;
+        FileHandler f_fxml_tmp;
         FeatureMap tmp_map;
-        f_fxml_tmp.getOptions().setLoadConvexHull(false);
-        f_fxml_tmp.getOptions().setLoadSubordinates(false);
-        f_fxml_tmp.load(ins[i], tmp_map);
+        f_fxml_tmp.getFeatOptions().setLoadConvexHull(false);
+        f_fxml_tmp.getFeatOptions().setLoadSubordinates(false);
+        f_fxml_tmp.loadFeatures(ins[i], tmp_map, file_type);
 
         // copy over information on the primary MS run
         const StringList& ms_runs = tmp_map.getPrimaryMSRunPath();
@@ -275,10 +276,10 @@ protected:
     else
     {
       vector<ConsensusMap> maps(ins.size());
-      ConsensusXMLFile f;
+      FileHandler f;
       for (Size i = 0; i < ins.size(); ++i)
       {
-        f.load(ins[i], maps[i]);
+        f.loadConsensusFeatures(ins[i], maps[i], file_type);
         const StringList& ms_runs = maps[i].getPrimaryMSRunPath();
         ms_run_locations.insert(ms_run_locations.end(), ms_runs.begin(), ms_runs.end());
       }
@@ -312,7 +313,7 @@ protected:
 
     out_map.setPrimaryMSRunPath(ms_run_locations);
     // write output
-    ConsensusXMLFile().store(out, out_map);
+    FileHandler().storeConsensusFeatures(out, out_map);
 
     // some statistics
     map<Size, UInt> num_consfeat_of_size;
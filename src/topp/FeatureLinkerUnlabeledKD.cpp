@@ -73,6 +73,13 @@ using namespace std;
  tolerance is not possible anymore, then this algorithm becomes orders of
  magnitudes faster than FLQT.
 
+ For very large cohorts, the -chunk_size option links the input files out
+ of core: instead of loading all input maps, only the features within an m/z
+ range containing at most this many features (summed over all input files)
+ are loaded at a time. The result is the same, but every input file is read
+ repeatedly (once per chunk for the RT transformation and once per chunk for
+ the linking). This mode does not support -keep_subelements.
+
  Notably, this algorithm can be used to align featureXML files containing
  unassembled mass traces (as produced by MassTraceExtractor), which is often
  impossible for reasonably large datasets using other aligners, as these
@@ -107,6 +114,8 @@ protected:
   void registerOptionsAndFlags_()
   {
     TOPPFeatureLinkerBase::registerOptionsAndFlags_();
+    registerIntOption_("chunk_size", "<number>", 0, "Link the input files out of core, loading only the features of an m/z range with at most this many features (summed over all input files) at a time. 0 loads all input maps into memory.", false, true);
+    setMinInt_("chunk_size", 0);
     registerSubsection_("algorithm", "Algorithm parameters section");
   }
 
@@ -120,7 +129,42 @@ protected:
   ExitCodes main_(int, const char **)
   {
     FeatureGroupingAlgorithmKD algo;
-    return TOPPFeatureLinkerBase::common_main_(&algo);
+    Size chunk_size = getIntOption_("chunk_size");
+    if (chunk_size == 0)
+    {
+      return TOPPFeatureLinkerBase::common_main_(&algo);
+    }
+
+    //-------------------------------------------------------------
+    // out of core linking
+    //-------------------------------------------------------------
+    StringList ins = getStringList_("in");
+    String out = getStringOption_("out");
+    if (getFlag_("keep_subelements"))
+    {
+      writeLog_("Error: -keep_subelements is not supported together with -chunk_size!");
+      return ILLEGAL_PARAMETERS;
+    }
+    FileTypes::Type file_type = FileHandler::getType(ins[0]);
+    for (Size i = 0; i < ins.size(); ++i)
+    {
+      if (FileHandler::getType(ins[i]) != file_type)
+      {
+        writeLog_("Error: All input files must be of the same type!");
+        return ILLEGAL_PARAMETERS;
+      }
+    }
+
+    Param algorithm_param = getParam_().copy("algorithm:", true);
+    writeDebug_("Used algorithm parameters", algorithm_param, 3);
+    algo.setParameters(algorithm_param);
+
+    ConsensusMap out_map;
+    algo.group(ins, out_map, chunk_size);
+
+    writeResult_(out_map, out);
+
+    return EXECUTION_OK;
   }
 
 };
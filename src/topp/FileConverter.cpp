@@ -39,6 +39,7 @@
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/FORMAT/ColumnarFeatureFile.h>
 #include <OpenMS/FORMAT/MzXMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/MzDataFile.h>
@@ -110,6 +111,7 @@ using namespace std;
   @ref OpenMS::DTAFile "dta"
   @ref OpenMS::FeatureXMLFile "featureXML"
   @ref OpenMS::ConsensusXMLFile "consensusXML"
+  @ref OpenMS::ColumnarFeatureFile "featureBin/consensusBin"
   @ref OpenMS::MS2File "ms2"
   @ref OpenMS::XMassFile "fid/XMASS"
   @ref OpenMS::MsInspectFile "tsv"
@@ -161,7 +163,7 @@ protected:
   {
     registerInputFile_("in", "<file>", "", "Input file to convert.");
     registerStringOption_("in_type", "<type>", "", "Input file type -- default: determined from file extension or content\n", false);
-    String formats("mzData,mzXML,mzML,cachedMzML,dta,dta2d,mgf,featureXML,consensusXML,ms2,fid,tsv,peplist,kroenik,edta");
+    String formats("mzData,mzXML,mzML,cachedMzML,dta,dta2d,mgf,featureXML,consensusXML,featureBin,consensusBin,ms2,fid,tsv,peplist,kroenik,edta");
     setValidFormats_("in", ListUtils::create<String>(formats));
     setValidStrings_("in_type", ListUtils::create<String>(formats));
     
@@ -169,7 +171,7 @@ protected:
     String method("none,ensure,reassign");
     setValidStrings_("UID_postprocessing", ListUtils::create<String>(method));
 
-    formats = "mzData,mzXML,mzML,cachedMzML,dta2d,mgf,featureXML,consensusXML,edta,csv";
+    formats = "mzData,mzXML,mzML,cachedMzML,dta2d,mgf,featureXML,consensusXML,featureBin,consensusBin,edta,csv";
     registerOutputFile_("out", "<file>", "", "Output file");
     setValidFormats_("out", ListUtils::create<String>(formats));
     registerStringOption_("out_type", "<type>", "", "Output file type -- default: determined from file extension or content\nNote: that not all conversion paths work or make sense.", false);
@@ -260,12 +262,19 @@ protected:
 
     writeDebug_(String("Loading input file"), 1);
 
-    if (in_type == FileTypes::CONSENSUSXML)
+    if (in_type == FileTypes::CONSENSUSXML || in_type == FileTypes::CONSENSUSBIN)
     {
-      ConsensusXMLFile().load(in, cm);
+      if (in_type == FileTypes::CONSENSUSBIN)
+      {
+        ColumnarFeatureFile(in).load(cm);
+      }
+      else
+      {
+        ConsensusXMLFile().load(in, cm);
+      }
       cm.sortByPosition();
-      if ((out_type != FileTypes::FEATUREXML) &&
-          (out_type != FileTypes::CONSENSUSXML))
+      if ((out_type != FileTypes::FEATUREXML) && (out_type != FileTypes::FEATUREBIN) &&
+          (out_type != FileTypes::CONSENSUSXML) && (out_type != FileTypes::CONSENSUSBIN))
       {
         // You you will lose information and waste memory. Enough reasons to issue a warning!
         writeLog_("Warning: Converting consensus features to peaks. You will lose information!");
@@ -276,8 +285,8 @@ protected:
     {
       EDTAFile().load(in, cm);
       cm.sortByPosition();
-      if ((out_type != FileTypes::FEATUREXML) &&
-          (out_type != FileTypes::CONSENSUSXML))
+      if ((out_type != FileTypes::FEATUREXML) && (out_type != FileTypes::FEATUREBIN) &&
+          (out_type != FileTypes::CONSENSUSXML) && (out_type != FileTypes::CONSENSUSBIN))
       {
         // You you will lose information and waste memory. Enough reasons to issue a warning!
         writeLog_("Warning: Converting consensus features to peaks. You will lose information!");
@@ -285,14 +294,15 @@ protected:
       }
     }
     else if (in_type == FileTypes::FEATUREXML ||
+             in_type == FileTypes::FEATUREBIN ||
              in_type == FileTypes::TSV ||
              in_type == FileTypes::PEPLIST ||
              in_type == FileTypes::KROENIK)
     {
       fh.loadFeatures(in, fm, in_type);
       fm.sortByPosition();
-      if ((out_type != FileTypes::FEATUREXML) &&
-          (out_type != FileTypes::CONSENSUSXML))
+      if ((out_type != FileTypes::FEATUREXML) && (out_type != FileTypes::FEATUREBIN) &&
+          (out_type != FileTypes::CONSENSUSXML) && (out_type != FileTypes::CONSENSUSBIN))
       {
         // You will lose information and waste memory. Enough reasons to issue a warning!
         writeLog_("Warning: Converting features to peaks. You will lose information! Mass traces are added, if present as 'num_of_masstraces' and 'masstrace_intensity_<X>' (X>=0) meta values.");
@@ -479,9 +489,9 @@ protected:
       f.setLogType(log_type_);
       f.store(out, exp, getFlag_("MGF_compact"));
     }
-    else if (out_type == FileTypes::FEATUREXML)
+    else if (out_type == FileTypes::FEATUREXML || out_type == FileTypes::FEATUREBIN)
     {
-      if ((in_type == FileTypes::FEATUREXML) || (in_type == FileTypes::TSV) ||
+      if ((in_type == FileTypes::FEATUREXML) || (in_type == FileTypes::FEATUREBIN) || (in_type == FileTypes::TSV) ||
           (in_type == FileTypes::PEPLIST) || (in_type == FileTypes::KROENIK))
       {
         if (uid_postprocessing == "ensure")
@@ -492,7 +502,7 @@ protected:
           fm.applyMemberFunction(&UniqueIdInterface::setUniqueId);
         }
       }
-      else if (in_type == FileTypes::CONSENSUSXML || in_type == FileTypes::EDTA)
+      else if (in_type == FileTypes::CONSENSUSXML || in_type == FileTypes::CONSENSUSBIN || in_type == FileTypes::EDTA)
       {
         MapConversion::convert(cm, true, fm);
       }
@@ -529,11 +539,18 @@ protected:
 
       addDataProcessing_(fm, getProcessingInfo_(DataProcessing::
                                                 FORMAT_CONVERSION));
-      FeatureXMLFile().store(out, fm);
+      if (out_type == FileTypes::FEATUREBIN)
+      {
+        ColumnarFeatureFile::store(out, fm);
+      }
+      else
+      {
+        FeatureXMLFile().store(out, fm);
+      }
     }
-    else if (out_type == FileTypes::CONSENSUSXML)
+    else if (out_type == FileTypes::CONSENSUSXML || out_type == FileTypes::CONSENSUSBIN)
     {
-      if ((in_type == FileTypes::FEATUREXML) || (in_type == FileTypes::TSV) ||
+      if ((in_type == FileTypes::FEATUREXML) || (in_type == FileTypes::FEATUREBIN) || (in_type == FileTypes::TSV) ||
           (in_type == FileTypes::PEPLIST) || (in_type == FileTypes::KROENIK))
       {
         if (uid_postprocessing == "ensure")
@@ -546,7 +563,7 @@ protected:
         MapConversion::convert(0, fm, cm);
       }
       // nothing to do for consensus input
-      else if (in_type == FileTypes::CONSENSUSXML || in_type == FileTypes::EDTA)
+      else if (in_type == FileTypes::CONSENSUSXML || in_type == FileTypes::CONSENSUSBIN || in_type == FileTypes::EDTA)
       {
       }
       else // experimental data
@@ -556,7 +573,14 @@ protected:
 
       addDataProcessing_(cm, getProcessingInfo_(DataProcessing::
                                                 FORMAT_CONVERSION));
-      ConsensusXMLFile().store(out, cm);
+      if (out_type == FileTypes::CONSENSUSBIN)
+      {
+        ColumnarFeatureFile::store(out, cm);
+      }
+      else
+      {
+        ConsensusXMLFile().store(out, cm);
+      }
     }
     else if (out_type == FileTypes::EDTA)
     {
@@ -590,7 +614,7 @@ protected:
       // conversion is requested
 
       // IBSpectra selected as output type
-      if (in_type != FileTypes::CONSENSUSXML)
+      if (in_type != FileTypes::CONSENSUSXML && in_type != FileTypes::CONSENSUSBIN)
       {
         LOG_ERROR << "Incompatible input data: FileConverter can only convert consensusXML files to ibspectra format.";
         return INCOMPATIBLE_INPUT_DATA;
@@ -135,9 +135,9 @@ protected:
     registerInputFile_("id", "<file>", "", "Protein/peptide identifications file");
     setValidFormats_("id", ListUtils::create<String>("mzid,idXML"));
     registerInputFile_("in", "<file>", "", "Feature map/consensus map file");
-    setValidFormats_("in", ListUtils::create<String>("featureXML,consensusXML,mzq"));
+    setValidFormats_("in", ListUtils::create<String>("featureXML,consensusXML,featureBin,consensusBin,mzq"));
     registerOutputFile_("out", "<file>", "", "Output file (the format depends on the input file format).");
-    setValidFormats_("out", ListUtils::create<String>("featureXML,consensusXML,mzq"));
+    setValidFormats_("out", ListUtils::create<String>("featureXML,consensusXML,featureBin,consensusBin,mzq"));
 
     addEmptyLine_();
     IDMapper mapper;
@@ -214,12 +214,12 @@ protected:
     //----------------------------------------------------------------
     // consensusXML
     //----------------------------------------------------------------
-    if (in_type == FileTypes::CONSENSUSXML)
+    if (in_type == FileTypes::CONSENSUSXML || in_type == FileTypes::CONSENSUSBIN)
     {
       // LOG_DEBUG << "Processing consensus map..." << endl;
-      ConsensusXMLFile file;
+      FileHandler file;
       ConsensusMap map;
-      file.load(in, map);
+      file.loadConsensusFeatures(in, map, in_type);
 
       PeakMap exp;
       if (!spectra.empty())
@@ -238,18 +238,18 @@ protected:
       //annotate output with data processing info
       addDataProcessing_(map, getProcessingInfo_(DataProcessing::IDENTIFICATION_MAPPING));
 
-      file.store(out, map);
+      file.storeConsensusFeatures(out, map);
     }
 
     //----------------------------------------------------------------
     // featureXML
     //----------------------------------------------------------------
-    if (in_type == FileTypes::FEATUREXML)
+    if (in_type == FileTypes::FEATUREXML || in_type == FileTypes::FEATUREBIN)
     {
       // LOG_DEBUG << "Processing feature map..." << endl;
       FeatureMap map;
-      FeatureXMLFile file;
-      file.load(in, map);
+      FileHandler file;
+      file.loadFeatures(in, map, in_type);
 
       PeakMap exp;
 
@@ -266,7 +266,7 @@ protected:
       //annotate output with data processing info
       addDataProcessing_(map, getProcessingInfo_(DataProcessing::IDENTIFICATION_MAPPING));
 
-      file.store(out, map);
+      file.storeFeatures(out, map);
     }
 
     //----------------------------------------------------------------
@@ -113,9 +113,30 @@ public:
   }
 
 private:
-  template <typename MapType, typename FileType>
+  // overloads to dispatch feature and consensus maps to the FileHandler:
+  void loadMap_(FileHandler& handler, const String& filename, FeatureMap& map)
+  {
+    handler.loadFeatures(filename, map);
+  }
+
+  void loadMap_(FileHandler& handler, const String& filename, ConsensusMap& map)
+  {
+    handler.loadConsensusFeatures(filename, map);
+  }
+
+  void storeMap_(FileHandler& handler, const String& filename, const FeatureMap& map)
+  {
+    handler.storeFeatures(filename, map);
+  }
+
+  void storeMap_(FileHandler& handler, const String& filename, const ConsensusMap& map)
+  {
+    handler.storeConsensusFeatures(filename, map);
+  }
+
+  template <typename MapType>
   void loadInitialMaps_(vector<MapType>& maps, StringList& ins, 
-                        FileType& input_file)
+                        FileHandler& input_file)
   {
     // custom progress logger for this task:
     ProgressLogger progresslogger;
@@ -124,16 +145,16 @@ private:
     for (Size i = 0; i < ins.size(); ++i)
     {
       progresslogger.setProgress(i);
-      input_file.load(ins[i], maps[i]);
+      loadMap_(input_file, ins[i], maps[i]);
     }
     progresslogger.endProgress();
   }
 
   // helper function to avoid code duplication between consensusXML and
   // featureXML storage operations:
-  template <typename MapType, typename FileType>
+  template <typename MapType>
   void storeTransformedMaps_(vector<MapType>& maps, StringList& outs, 
-                             FileType& output_file)
+                             FileHandler& output_file)
   {
     // custom progress logger for this task:
     ProgressLogger progresslogger;
@@ -145,7 +166,7 @@ private:
       // annotate output with data processing info:
       addDataProcessing_(maps[i], 
                          getProcessingInfo_(DataProcessing::ALIGNMENT));
-      output_file.store(outs[i], maps[i]);
+      storeMap_(output_file, outs[i], maps[i]);
     }
     progresslogger.endProgress();
   }
@@ -209,16 +230,16 @@ private:
         MzMLFile().load(reference_file, experiment);
         algorithm.setReference(experiment);
       }
-      else if (filetype == FileTypes::FEATUREXML)
+      else if (filetype == FileTypes::FEATUREXML || filetype == FileTypes::FEATUREBIN)
       {
         FeatureMap features;
-        FeatureXMLFile().load(reference_file, features);
+        FileHandler().loadFeatures(reference_file, features, filetype);
         algorithm.setReference(features);
       }
-      else if (filetype == FileTypes::CONSENSUSXML)
+      else if (filetype == FileTypes::CONSENSUSXML || filetype == FileTypes::CONSENSUSBIN)
       {
         ConsensusMap consensus;
-        ConsensusXMLFile().load(reference_file, consensus);
+        FileHandler().loadConsensusFeatures(reference_file, consensus, filetype);
         algorithm.setReference(consensus);
       }
       else if (filetype == FileTypes::IDXML)
@@ -235,7 +256,7 @@ private:
 
   void registerOptionsAndFlags_()
   {
-    String formats = "featureXML,consensusXML,idXML";
+    String formats = "featureXML,consensusXML,featureBin,consensusBin,idXML";
     TOPPMapAlignerBase::registerOptionsAndFlags_(formats, REF_FLEXIBLE);
 
     registerSubsection_("algorithm", "Algorithm parameters section");
@@ -281,16 +302,16 @@ private:
     //-------------------------------------------------------------
     // perform feature alignment
     //-------------------------------------------------------------
-    if (in_type == FileTypes::FEATUREXML)
+    if (in_type == FileTypes::FEATUREXML || in_type == FileTypes::FEATUREBIN)
     {
       vector<FeatureMap> feature_maps(input_files.size());
-      FeatureXMLFile fxml_file;
+      FileHandler fxml_file;
       if (output_files.empty())
       {
         // store only transformation descriptions, not transformed data =>
         // we can load only minimum required information:
-        fxml_file.getOptions().setLoadConvexHull(false);
-        fxml_file.getOptions().setLoadSubordinates(false);
+        fxml_file.getFeatOptions().setLoadConvexHull(false);
+        fxml_file.getFeatOptions().setLoadSubordinates(false);
       }
       loadInitialMaps_(feature_maps, input_files, fxml_file);
 
@@ -306,10 +327,10 @@ private:
     //-------------------------------------------------------------
     // perform consensus alignment
     //-------------------------------------------------------------
-    else if (in_type == FileTypes::CONSENSUSXML)
+    else if (in_type == FileTypes::CONSENSUSXML || in_type == FileTypes::CONSENSUSBIN)
     {
       std::vector<ConsensusMap> consensus_maps(input_files.size());
-      ConsensusXMLFile cxml_file;
+      FileHandler cxml_file;
       loadInitialMaps_(consensus_maps, input_files, cxml_file);
 
       performAlignment_(algorithm, consensus_maps, transformations,
@@ -34,6 +34,7 @@
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmPoseClustering.h>
 #include <OpenMS/APPLICATIONS/MapAlignerBase.h>
+#include <OpenMS/FORMAT/ColumnarFeatureFile.h>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -118,7 +119,7 @@ public:
 protected:
   void registerOptionsAndFlags_()
   {
-    TOPPMapAlignerBase::registerOptionsAndFlags_("mzML,featureXML",
+    TOPPMapAlignerBase::registerOptionsAndFlags_("mzML,featureXML,featureBin",
                                                  REF_RESTRICTED);
     registerSubsection_("algorithm", "Algorithm parameters section");
   }
@@ -174,6 +175,10 @@ protected:
         {
           s = f.loadSize(in_files[i]);
         }
+        else if (in_type == FileTypes::FEATUREBIN)
+        {
+          s = ColumnarFeatureFile(in_files[i]).size();
+        }
         else if (in_type == FileTypes::MZML) // this is expensive!
         {
           PeakMap exp;
@@ -191,19 +196,19 @@ protected:
       file = in_files[reference_index];
     }
 
-    FeatureXMLFile f_fxml;
+    FileHandler f_fxml;
     if (out_files.empty()) // no need to store featureXML, thus we can load only minimum required information
     {
-      f_fxml.getOptions().setLoadConvexHull(false);
-      f_fxml.getOptions().setLoadSubordinates(false);
+      f_fxml.getFeatOptions().setLoadConvexHull(false);
+      f_fxml.getFeatOptions().setLoadSubordinates(false);
     }
-    if (in_type == FileTypes::FEATUREXML)
+    if (in_type == FileTypes::FEATUREXML || in_type == FileTypes::FEATUREBIN)
     {
       FeatureMap map_ref;
-      FeatureXMLFile f_fxml_tmp; // for the reference, we never need CH or subordinates
-      f_fxml_tmp.getOptions().setLoadConvexHull(false);
-      f_fxml_tmp.getOptions().setLoadSubordinates(false);
-      f_fxml_tmp.load(file, map_ref);
+      FileHandler f_fxml_tmp; // for the reference, we never need CH or subordinates
+      f_fxml_tmp.getFeatOptions().setLoadConvexHull(false);
+      f_fxml_tmp.getFeatOptions().setLoadSubordinates(false);
+      f_fxml_tmp.loadFeatures(file, map_ref, in_type);
       algorithm.setReference(map_ref);
     }
     else if (in_type == FileTypes::MZML)
@@ -225,13 +230,13 @@ protected:
     for (int i = 0; i < static_cast<int>(in_files.size()); ++i)
     {
       TransformationDescription trafo;
-      if (in_type == FileTypes::FEATUREXML)
+      if (in_type == FileTypes::FEATUREXML || in_type == FileTypes::FEATUREBIN)
       {
         FeatureMap map;
-        // workaround for loading: use temporary FeatureXMLFile since it is not thread-safe
-        FeatureXMLFile f_fxml_tmp; // do not use OMP-firstprivate, since FeatureXMLFile has no copy c'tor
-        f_fxml_tmp.getOptions() = f_fxml.getOptions();
-        f_fxml_tmp.load(in_files[i], map);
+        // workaround for loading: use temporary FileHandler since FeatureXMLFile is not thread-safe
+        FileHandler f_fxml_tmp;
+        f_fxml_tmp.getFeatOptions() = f_fxml.getFeatOptions();
+        f_fxml_tmp.loadFeatures(in_files[i], map, in_type);
         if (i == static_cast<int>(reference_index)) trafo.fitModel("identity");
         else algorithm.align(map, trafo);
         if (out_files.size())
@@ -239,7 +244,7 @@ protected:
           MapAlignmentTransformer::transformRetentionTimes(map, trafo);
           // annotate output with data processing info
           addDataProcessing_(map, getProcessingInfo_(DataProcessing::ALIGNMENT));
-          f_fxml_tmp.store(out_files[i], map);
+          f_fxml_tmp.storeFeatures(out_files[i], map);
         }
       }
       else if (in_type == FileTypes::MZML)
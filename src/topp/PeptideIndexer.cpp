@@ -39,7 +39,6 @@
 #include <OpenMS/CHEMISTRY/EnzymesDB.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
-#include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/SYSTEM/File.h>
@@ -149,10 +148,6 @@ protected:
     // reading input
     //-------------------------------------------------------------
 
-    // we stream the Fasta file
-    std::vector<FASTAFile::FASTAEntry> proteins;
-    FASTAFile().load(db_name, proteins);
-
     std::vector<ProteinIdentification> prot_ids;
     std::vector<PeptideIdentification> pep_ids;
 
@@ -162,7 +157,8 @@ protected:
     // calculations
     //-------------------------------------------------------------
 
-    PeptideIndexing::ExitCodes indexer_exit = indexer.run(proteins, prot_ids,
+    // the database is loaded by the indexer (not at all if a protein index can be reused)
+    PeptideIndexing::ExitCodes indexer_exit = indexer.run(db_name, prot_ids,
                                                           pep_ids);
     if ((indexer_exit != PeptideIndexing::EXECUTION_OK) &&
         (indexer_exit != PeptideIndexing::PEPTIDE_IDS_EMPTY))
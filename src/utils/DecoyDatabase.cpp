@@ -34,8 +34,12 @@
 
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <fstream>
 
 using namespace OpenMS;
 using namespace std;
@@ -110,100 +114,95 @@ protected:
     bool append = (!getFlag_("only_decoy"));
     bool shuffle = (getStringOption_("method") == "shuffle");
 
-    //-------------------------------------------------------------
-    // reading input
-    //-------------------------------------------------------------
-
-    vector<FASTAFile::FASTAEntry> proteins;
-    for (Size i=0; i<in.size(); ++i)
-    {
-      vector<FASTAFile::FASTAEntry> single_proteins;
-      // this is a little inefficient since it requires copying; appending during load() would be better...
-      FASTAFile().load(in[i], single_proteins);  
-      // append
-      proteins.insert(proteins.end(), single_proteins.begin(), single_proteins.end());
-    }
-
     if (in.size() == 1)
     {
       LOG_WARN << "Warning: Only one FASTA input file was provided, which might not contain contaminants. You probably want to have them! Just add the contaminant file to the input file list 'in'." << endl;
     }
 
-    //-------------------------------------------------------------
-    // calculations
-    //-------------------------------------------------------------
-
     String decoy_string(getStringOption_("decoy_string"));
     bool decoy_string_position_prefix =   (String(getStringOption_("decoy_string_position")) == "prefix" ? true : false);
-    Size num_proteins = proteins.size();
-    set<String> identifiers;
-    if (shuffle)
+
+    // the inputs are read while the output is written, so they must differ
+    for (Size i = 0; i < in.size(); ++i)
     {
-      for (Size i = 0; i < num_proteins; ++i)
+      if (File::absolutePath(in[i]) == File::absolutePath(out))
       {
-        if (identifiers.find(proteins[i].identifier) != identifiers.end())
-        {
-          LOG_WARN << "DecoyDatabase: Warning, identifier is not unique to sequence file: '" << proteins[i].identifier << "'!" << endl;
-        }
-        identifiers.insert(proteins[i].identifier);
+        writeLog_("Error: The output file '" + out + "' must not be one of the input files.");
+        return ILLEGAL_PARAMETERS;
+      }
+    }
 
-        FASTAFile::FASTAEntry entry = proteins[i];
+    ofstream outfile(out.c_str());
+    if (!outfile.good())
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, out);
+    }
 
-        String pro_seq, temp;
-        pro_seq = entry.sequence;
-        Size x = pro_seq.size();
-        srand(time(0));
-        while (x != 0)
-        {
-          Size y = rand() % x;
-          temp += pro_seq[y];
-          pro_seq[y] = pro_seq[x - 1];
-          --x;
-        }
-        entry.sequence = temp;
+    // The input files are streamed twice (targets first, then decoys), so the
+    // proteins never need to be held in memory.
+    FASTAFile::FASTAEntry entry;
+    MappedFASTAFile::EntryView view;
 
-        if (append)
-        {
-          entry.identifier = getIdentifier_(entry.identifier, decoy_string, decoy_string_position_prefix);
-          proteins.push_back(entry);
-        }
-        else
+    //-------------------------------------------------------------
+    // writing targets
+    //-------------------------------------------------------------
+
+    if (append)
+    {
+      for (Size i = 0; i < in.size(); ++i)
+      {
+        MappedFASTAFile fasta(in[i]);
+        MappedFASTAFile::Reader reader(fasta);
+        while (reader.next(view))
         {
-          proteins[i].sequence = entry.sequence;
-          proteins[i].identifier = getIdentifier_(proteins[i].identifier, decoy_string, decoy_string_position_prefix);
+          view.getEntry(entry);
+          FASTAFile::writeEntry(outfile, entry);
         }
       }
     }
-    else         // !shuffle
+
+    //-------------------------------------------------------------
+    // writing decoys
+    //-------------------------------------------------------------
+
+    set<String> identifiers;
+    for (Size i = 0; i < in.size(); ++i)
     {
-      for (Size i = 0; i < num_proteins; ++i)
+      MappedFASTAFile fasta(in[i]);
+      MappedFASTAFile::Reader reader(fasta);
+      while (reader.next(view))
       {
-        if (identifiers.find(proteins[i].identifier) != identifiers.end())
+        view.getEntry(entry);
+        if (identifiers.find(entry.identifier) != identifiers.end())
         {
-          LOG_WARN << "DecoyDatabase: Warning, identifier is not unique to sequence file: '" << proteins[i].identifier << "'!" << endl;
+          LOG_WARN << "DecoyDatabase: Warning, identifier is not unique to sequence file: '" << entry.identifier << "'!" << endl;
         }
-        identifiers.insert(proteins[i].identifier);
+        identifiers.insert(entry.identifier);
 
-        if (append)
+        if (shuffle)
         {
-          FASTAFile::FASTAEntry entry = proteins[i];
-          entry.sequence.reverse();
-          entry.identifier = getIdentifier_(entry.identifier, decoy_string, decoy_string_position_prefix);
-          proteins.push_back(entry);
+          String pro_seq, temp;
+          pro_seq = entry.sequence;
+          Size x = pro_seq.size();
+          srand(time(0));
+          while (x != 0)
+          {
+            Size y = rand() % x;
+            temp += pro_seq[y];
+            pro_seq[y] = pro_seq[x - 1];
+            --x;
+          }
+          entry.sequence = temp;
         }
         else
         {
-          proteins[i].sequence.reverse();
-          proteins[i].identifier = getIdentifier_(proteins[i].identifier, decoy_string, decoy_string_position_prefix);
+          entry.sequence.reverse();
         }
+        entry.identifier = getIdentifier_(entry.identifier, decoy_string, decoy_string_position_prefix);
+        FASTAFile::writeEntry(outfile, entry);
       }
     }
-
-    //-------------------------------------------------------------
-    // writing output
-    //-------------------------------------------------------------
-
-    FASTAFile().store(out, proteins);
+    outfile.close();
 
     return EXECUTION_OK;
   }
@@ -35,11 +35,14 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
 #include <OpenMS/CHEMISTRY/EnzymesDB.h>
+#include <OpenMS/SYSTEM/File.h>
 
+#include <fstream>
 #include <map>
 
 using namespace OpenMS;
@@ -158,8 +161,27 @@ protected:
     //-------------------------------------------------------------
     // reading input
     //-------------------------------------------------------------
-    std::vector<FASTAFile::FASTAEntry> protein_data;
-    FASTAFile().load(inputfile_name, protein_data);
+    // proteins are streamed from the mapped file; FASTA output is written
+    // directly, idXML output needs all identifications for storing
+    MappedFASTAFile protein_file(inputfile_name);
+    MappedFASTAFile::Reader protein_reader(protein_file);
+    MappedFASTAFile::EntryView protein_view;
+    FASTAFile::FASTAEntry protein;
+
+    ofstream fasta_outfile;
+    if (has_FASTA_output)
+    {
+      if (File::absolutePath(inputfile_name) == File::absolutePath(outputfile_name))
+      {
+        writeLog_("Error: The output file '" + outputfile_name + "' must not be the input file.");
+        return ILLEGAL_PARAMETERS;
+      }
+      fasta_outfile.open(outputfile_name.c_str());
+      if (!fasta_outfile.good())
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, outputfile_name);
+      }
+    }
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
@@ -180,30 +202,30 @@ protected:
     protein_identifications[0].setSearchEngine("In-silico digestion");
     protein_identifications[0].setIdentifier("In-silico_digestion" + date_time_string);
 
-    std::vector<FASTAFile::FASTAEntry> all_peptides;
-
+    Size fasta_peptides(0);
     Size dropped_bylength(0); // stats for removing candidates
 
-    for (Size i = 0; i < protein_data.size(); ++i)
+    while (protein_reader.next(protein_view))
     {
+      protein_view.getEntry(protein);
       if (!has_FASTA_output)
       {
         ProteinHit temp_protein_hit;
-        temp_protein_hit.setSequence(protein_data[i].sequence);
-        temp_protein_hit.setAccession(protein_data[i].identifier);
+        temp_protein_hit.setSequence(protein.sequence);
+        temp_protein_hit.setAccession(protein.identifier);
         protein_identifications[0].insertHit(temp_protein_hit);
-        temp_pe.setProteinAccession(protein_data[i].identifier);
+        temp_pe.setProteinAccession(protein.identifier);
         temp_peptide_hit.setPeptideEvidences(vector<PeptideEvidence>(1, temp_pe));
       }
 
       vector<AASequence> temp_peptides;
       if (enzyme == "none")
       {
-        temp_peptides.push_back(AASequence::fromString(protein_data[i].sequence));
+        temp_peptides.push_back(AASequence::fromString(protein.sequence));
       }
       else
       {
-        digestor.digest(AASequence::fromString(protein_data[i].sequence), temp_peptides);
+        digestor.digest(AASequence::fromString(protein.sequence), temp_peptides);
       }
 
       for (Size j = 0; j < temp_peptides.size(); ++j)
@@ -220,8 +242,8 @@ protected:
           }
           else // for FASTA file output
           {
-            FASTAFile::FASTAEntry pep(protein_data[i].identifier, protein_data[i].description, temp_peptides[j].toString());
-            all_peptides.push_back(pep);
+            FASTAFile::writeEntry(fasta_outfile, FASTAFile::FASTAEntry(protein.identifier, protein.description, temp_peptides[j].toString()));
+            ++fasta_peptides;
           }
         }
         else
@@ -237,7 +259,7 @@ protected:
 
     if (has_FASTA_output)
     {
-      FASTAFile().store(outputfile_name, all_peptides);
+      fasta_outfile.close();
     }
     else
     {
@@ -246,7 +268,7 @@ protected:
                         identifications);
     }
 
-    Size pep_remaining_count = (has_FASTA_output ? all_peptides.size() : identifications.size());
+    Size pep_remaining_count = (has_FASTA_output ? fasta_peptides : identifications.size());
     LOG_INFO << "Statistics:\n"
              << "  total #peptides after digestion:         " << pep_remaining_count + dropped_bylength << "\n"
              << "  removed #peptides (length restrictions): " << dropped_bylength << "\n"
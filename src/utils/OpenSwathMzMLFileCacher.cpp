@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include "OpenMS/FORMAT/CachedMzML.h"
+#include "OpenMS/FORMAT/MappedCachedMzML.h"
 
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
@@ -62,6 +63,11 @@ using namespace std;
   - read only an index (read_memdump_idx) of the spectra and chromatograms and then use
     random-access to retrieve a specific spectra from the disk (read_memdump_spectra)
 
+  With the flag @p memory_mapped, the data is written in the memory-mapped
+  format (see MappedCachedmzML), which allows lock-free concurrent random
+  access (e.g. by OpenSwathWorkflow). Both formats are detected automatically
+  when reading.
+
   @note This tool is experimental!
 
   <B>The command line parameters of this tool are:</B>
@@ -99,6 +105,7 @@ class TOPPOpenSwathMzMLFileCacher
     //setValidFormats_("out_meta",ListUtils::create<String>("mzML"));
 
     registerFlag_("convert_back", "Convert back to mzML");
+    registerFlag_("memory_mapped", "Write the cached data in the memory-mapped format which supports lock-free concurrent access");
 
   }
 
@@ -109,6 +116,7 @@ class TOPPOpenSwathMzMLFileCacher
     String in_cached = in + ".cached";
     String out_cached = out_meta + ".cached";
     bool convert_back =  getFlag_("convert_back");
+    bool memory_mapped = getFlag_("memory_mapped");
 
     if (!convert_back)
     {
@@ -120,7 +128,14 @@ class TOPPOpenSwathMzMLFileCacher
       f.setLogType(log_type_);
 
       f.load(in,exp);
-      cacher.writeMemdump(exp, out_cached);
+      if (memory_mapped)
+      {
+        MappedCachedmzML::store(out_cached, exp);
+      }
+      else
+      {
+        cacher.writeMemdump(exp, out_cached);
+      }
       cacher.writeMetadata(exp, out_meta, true);
     }
     else
@@ -134,7 +149,14 @@ class TOPPOpenSwathMzMLFileCacher
       f.setLogType(log_type_);
 
       f.load(in,meta_exp);
-      cacher.readMemdump(exp_reading, in_cached);
+      if (MappedCachedmzML::isMappedCache(in_cached))
+      {
+        MappedCachedmzML(in_cached).load(exp_reading);
+      }
+      else
+      {
+        cacher.readMemdump(exp_reading, in_cached);
+      }
 
       std::cout << " read back, got " << exp_reading.size() << " spectra " << exp_reading.getChromatograms().size() << " chromats " << std::endl;
 
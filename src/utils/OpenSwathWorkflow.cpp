@@ -457,6 +457,12 @@ protected:
     registerIntOption_("batchSize", "<number>", 0, "The batch size of chromatograms to process (0 means to only have one batch, sensible values are around 500-1000)", false, true);
     setMinInt_("batchSize", 0);
 
+    registerFlag_("pipeline", "Overlap loading, extraction and scoring of the SWATH maps instead of processing one SWATH map per thread (memory use is bounded by pipeline_max_loaded_maps and pipeline_max_pending_batches)", true);
+    registerIntOption_("pipeline_max_loaded_maps", "<number>", 2, "Maximal number of SWATH maps held at the same time when using -pipeline", false, true);
+    setMinInt_("pipeline_max_loaded_maps", 1);
+    registerIntOption_("pipeline_max_pending_batches", "<number>", 4, "Maximal number of extracted batches waiting to be scored when using -pipeline", false, true);
+    setMinInt_("pipeline_max_pending_batches", 1);
+
     registerSubsection_("Scoring", "Scoring parameters section");
 
     registerSubsection_("outlierDetection", "Parameters for the outlierDetection for iRT petides. Outlier detection can be done iteratively (by default) which removes one outlier per iteration or using the RANSAC algorithm.");
@@ -678,6 +684,9 @@ protected:
     String extraction_function = getStringOption_("extraction_function");
     String swath_windows_file = getStringOption_("swath_windows_file");
     int batchSize = (int)getIntOption_("batchSize");
+    bool pipeline = getFlag_("pipeline");
+    Size pipeline_max_loaded_maps = (Size)getIntOption_("pipeline_max_loaded_maps");
+    Size pipeline_max_pending_batches = (Size)getIntOption_("pipeline_max_pending_batches");
     Size debug_level = (Size)getIntOption_("debug");
 
     double min_rsq = getDoubleOption_("min_rsq");
@@ -903,6 +912,14 @@ protected:
       wf.performExtractionSonar(swath_maps, trafo_rtnorm, cp, feature_finder_param, transition_exp,
           out_featureFile, !out.empty(), tsvwriter, chromConsumer, batchSize, load_into_memory);
     }
+    else if (pipeline)
+    {
+      OpenSwathWorkflow wf(use_ms1_traces);
+      wf.setLogType(log_type_);
+      wf.performExtractionPipelined(swath_maps, trafo_rtnorm, cp, feature_finder_param, transition_exp,
+          out_featureFile, !out.empty(), tsvwriter, chromConsumer, batchSize, load_into_memory,
+          pipeline_max_loaded_maps, pipeline_max_pending_batches);
+    }
     else
     {
       OpenSwathWorkflow wf(use_ms1_traces);
@@ -44,6 +44,7 @@
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
 #include <OpenMS/CHEMISTRY/EnzymesDB.h>
+#include <OpenMS/CHEMISTRY/CompactPeptide.h>
 
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
@@ -64,6 +65,7 @@
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
 #include <OpenMS/FILTERING/ID/IDFilter.h>
+#include <OpenMS/ANALYSIS/ID/FragmentIonIndex.h>
 
 #include <map>
 #include <algorithm>
@@ -164,6 +166,8 @@ class SimpleSearchEngine :
 
       registerTOPPSubsection_("report", "Reporting Options");
       registerIntOption_("report:top_hits", "<num>", 1, "Maximum number of top scoring hits per spectrum that are reported.", false, true);
+
+      registerFlag_("fragment_index", "Build a fragment ion index of all candidate peptides once and score the spectra by fragment lookup (faster, in particular for large precursor mass tolerances).", false);
     }
 
     vector<ResidueModification> getModifications_(StringList modNames)
@@ -399,6 +403,164 @@ class SimpleSearchEngine :
       protein_ids[0].setSearchParameters(search_parameters);
     }
 
+    /// Post-processes the hits of all spectra and writes them to @p out_idxml
+    void storeHits_(const PeakMap& spectra, const vector<vector<PeptideHit> >& peptide_hits, Size report_top_hits, const String& out_idxml)
+    {
+      ProgressLogger progresslogger;
+      progresslogger.setLogType(log_type_);
+
+      vector<PeptideIdentification> peptide_ids;
+      vector<ProteinIdentification> protein_ids;
+      progresslogger.startProgress(0, 1, "Post-processing PSMs...");
+      postProcessHits_(spectra, peptide_hits, protein_ids, peptide_ids, report_top_hits);
+      progresslogger.endProgress();
+
+      protein_ids[0].setPrimaryMSRunPath(spectra.getPrimaryMSRunPath());
+
+      // write ProteinIdentifications and PeptideIdentifications to IdXML
+      IdXMLFile().store(out_idxml, protein_ids, peptide_ids);
+    }
+
+    /// Returns whether a precursor in @p multimap_mass_2_scan_index matches the peptide mass @p mass
+    static bool hasMatchingPrecursor_(const multimap<double, Size>& multimap_mass_2_scan_index, double mass,
+                                      double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm)
+    {
+      double half_window = precursor_mass_tolerance_unit_ppm ? 0.5 * mass * precursor_mass_tolerance * 1e-6 : 0.5 * precursor_mass_tolerance;
+      return multimap_mass_2_scan_index.lower_bound(mass - half_window) != multimap_mass_2_scan_index.upper_bound(mass + half_window);
+    }
+
+    /**
+      @brief Search using a fragment ion index
+
+      All candidate peptides (digested, modified and with a mass matching at
+      least one precursor) are collected first and their theoretical spectra
+      are stored in a FragmentIonIndex. The spectra are then scored in
+      parallel, each thread only writes the hits of its own spectra.
+    */
+    void searchFragmentIndex_(const PeakMap& spectra, const multimap<double, Size>& multimap_mass_2_scan_index,
+                              const vector<FASTAFile::FASTAEntry>& fasta_db, const EnzymaticDigestion& digestor,
+                              Size min_peptide_length, Size max_peptide_length,
+                              const vector<ResidueModification>& fixedMods, const vector<ResidueModification>& varMods,
+                              Size max_variable_mods_per_peptide, const TheoreticalSpectrumGenerator& spectrum_generator,
+                              double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm,
+                              double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm,
+                              vector<vector<PeptideHit> >& peptide_hits)
+    {
+      ProgressLogger progresslogger;
+      progresslogger.setLogType(log_type_);
+
+      // digest all proteins
+      progresslogger.startProgress(0, 1, "Digesting proteins...");
+      vector<vector<StringView> > digests(fasta_db.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
+      {
+        digestor.digestUnmodifiedString(fasta_db[fasta_index].sequence, digests[fasta_index], min_peptide_length, max_peptide_length);
+      }
+      set<StringView> unique_peptide_set;
+      for (Size fasta_index = 0; fasta_index < digests.size(); ++fasta_index)
+      {
+        unique_peptide_set.insert(digests[fasta_index].begin(), digests[fasta_index].end());
+      }
+      const vector<StringView> unique_peptides(unique_peptide_set.begin(), unique_peptide_set.end());
+      set<StringView>().swap(unique_peptide_set);
+      progresslogger.endProgress();
+
+      // generate modified candidates in parallel, only keep those which match
+      // at least one precursor (candidates are collected per peptide to keep
+      // the order independent of the scheduling)
+      progresslogger.startProgress(0, unique_peptides.size(), "Generating candidate peptides...");
+      vector<vector<AASequence> > peptide_candidates(unique_peptides.size());
+
+      // without modifications, the unmodified peptide is the only candidate and its mass
+      // can be checked before an AASequence is created (and ResidueDB is locked)
+      const bool unmodified_only = fixedMods.empty() && varMods.empty();
+      CompactPeptide::Alphabet alphabet;
+      alphabet.addUnmodifiedResidues();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)unique_peptides.size(); ++i)
+      {
+        IF_MASTERTHREAD
+        {
+          progresslogger.setProgress((SignedSize)i);
+        }
+
+        if (unmodified_only && !hasMatchingPrecursor_(multimap_mass_2_scan_index, CompactPeptide(unique_peptides[i], alphabet).getMonoWeight(),
+                                                      precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm))
+        {
+          continue;
+        }
+
+        vector<AASequence> all_modified_peptides;
+
+        // ResidueDB is not thread safe and new residues are created based on the PTMs
+#ifdef _OPENMP
+#pragma omp critical (residuedb_access)
+#endif
+        {
+          AASequence aas = AASequence::fromString(unique_peptides[i].getString());
+          ModifiedPeptideGenerator::applyFixedModifications(fixedMods.begin(), fixedMods.end(), aas);
+          ModifiedPeptideGenerator::applyVariableModifications(varMods.begin(), varMods.end(), aas, max_variable_mods_per_peptide, all_modified_peptides);
+        }
+
+        for (vector<AASequence>::const_iterator mod_it = all_modified_peptides.begin(); mod_it != all_modified_peptides.end(); ++mod_it)
+        {
+          if (hasMatchingPrecursor_(multimap_mass_2_scan_index, mod_it->getMonoWeight(), precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm))
+          {
+            peptide_candidates[i].push_back(*mod_it);
+          }
+        }
+      }
+      vector<AASequence> candidates;
+      for (Size i = 0; i < peptide_candidates.size(); ++i)
+      {
+        candidates.insert(candidates.end(), peptide_candidates[i].begin(), peptide_candidates[i].end());
+      }
+      vector<vector<AASequence> >().swap(peptide_candidates);
+      progresslogger.endProgress();
+
+      progresslogger.startProgress(0, 1, "Building fragment ion index...");
+      FragmentIonIndex index;
+      index.build(candidates, spectrum_generator);
+      vector<AASequence>().swap(candidates);
+      progresslogger.endProgress();
+      LOG_INFO << "Fragment ion index: " << index.getNrPeptides() << " candidate peptides, " << index.getNrFragments() << " fragment ions." << endl;
+
+      // score all spectra with a valid precursor
+      vector<pair<double, Size> > scans(multimap_mass_2_scan_index.begin(), multimap_mass_2_scan_index.end());
+      progresslogger.startProgress(0, scans.size(), "Scoring spectra...");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)scans.size(); ++i)
+      {
+        IF_MASTERTHREAD
+        {
+          progresslogger.setProgress((SignedSize)i);
+        }
+
+        const Size scan_index = scans[i].second;
+        const MSSpectrum<Peak1D>& exp_spectrum = spectra[scan_index];
+        vector<FragmentIonIndex::PeptideScore> scores;
+        index.search(exp_spectrum, scans[i].first, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm,
+                     fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, scores);
+
+        for (vector<FragmentIonIndex::PeptideScore>::const_iterator score_it = scores.begin(); score_it != scores.end(); ++score_it)
+        {
+          PeptideHit hit;
+          hit.setSequence(index.getPeptide(score_it->first));
+          hit.setCharge(exp_spectrum.getPrecursors()[0].getCharge());
+          hit.setScore(score_it->second);
+          peptide_hits[scan_index].push_back(hit);
+        }
+      }
+      progresslogger.endProgress();
+    }
+
     ExitCodes main_(int, const char**)
     {
       ProgressLogger progresslogger;
@@ -499,14 +661,30 @@ class SimpleSearchEngine :
       digestor.setEnzyme(getStringOption_("enzyme"));
       digestor.setMissedCleavages(missed_cleavages);
 
+      // set minimum / maximum size of peptide after digestion
+      Size min_peptide_length = getIntOption_("peptide:min_size");
+      Size max_peptide_length = getIntOption_("peptide:max_size");
+
+      if (getFlag_("fragment_index"))
+      {
+        searchFragmentIndex_(spectra, multimap_mass_2_scan_index, fasta_db, digestor, min_peptide_length, max_peptide_length,
+                             fixedMods, varMods, max_variable_mods_per_peptide, spectrum_generator,
+                             precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm,
+                             fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, peptide_hits);
+        storeHits_(spectra, peptide_hits, report_top_hits, out_idxml);
+        return EXECUTION_OK;
+      }
+
       progresslogger.startProgress(0, (Size)(fasta_db.end() - fasta_db.begin()), "Scoring peptide models against spectra...");
 
       // lookup for processed peptides. must be defined outside of omp section and synchronized
       set<StringView> processed_petides;
 
-      // set minimum / maximum size of peptide after digestion
-      Size min_peptide_length = getIntOption_("peptide:min_size");
-      Size max_peptide_length = getIntOption_("peptide:max_size");
+      // without modifications, the unmodified peptide is the only candidate and its mass
+      // can be checked before an AASequence is created (and ResidueDB is locked)
+      const bool unmodified_only = fixedMods.empty() && varMods.empty();
+      CompactPeptide::Alphabet alphabet;
+      alphabet.addUnmodifiedResidues();
 
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -521,6 +699,11 @@ class SimpleSearchEngine :
         vector<StringView> current_digest;
         digestor.digestUnmodifiedString(fasta_db[fasta_index].sequence, current_digest, min_peptide_length, max_peptide_length);
 
+        // theoretical spectrum buffers (reused for all candidates of this protein)
+        vector<double> theo_mz;
+        vector<TheoreticalSpectrumGenerator::IonAnnotation> theo_annotations;
+        CompactPeptide compact_peptide;
+
         for (vector<StringView>::iterator cit = current_digest.begin(); cit != current_digest.end(); ++cit)
         {
           bool already_processed = false;
@@ -547,6 +730,15 @@ class SimpleSearchEngine :
             processed_petides.insert(*cit);
           }
 
+          if (unmodified_only)
+          {
+            compact_peptide.assign(*cit, alphabet);
+            if (!hasMatchingPrecursor_(multimap_mass_2_scan_index, compact_peptide.getMonoWeight(), precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm))
+            {
+              continue;
+            }
+          }
+
           vector<AASequence> all_modified_peptides;
 
           // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
@@ -584,21 +776,15 @@ class SimpleSearchEngine :
               continue;     // no matching precursor in data
             }
 
-            //create theoretical spectrum
-            MSSpectrum<RichPeak1D> theo_spectrum = MSSpectrum<RichPeak1D>();
-
-            //add peaks for b and y ions with charge 1
-            spectrum_generator.getSpectrum(theo_spectrum, candidate, 1);
-
-            //sort by mz
-            theo_spectrum.sortByPosition();
+            //create theoretical spectrum: b and y ions with charge 1 (sorted by mz)
+            spectrum_generator.getIonMZs(theo_mz, candidate, 1, &theo_annotations);
 
             for (; low_it != up_it; ++low_it)
             {
               const Size& scan_index = low_it->second;
               const MSSpectrum<Peak1D>& exp_spectrum = spectra[scan_index];
 
-              double score = HyperScore::compute(fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
+              double score = HyperScore::compute(fragment_mass_tolerance, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_mz, theo_annotations);
 
               // no hit
               if (score < 1e-16)
@@ -622,16 +808,7 @@ class SimpleSearchEngine :
       }
       progresslogger.endProgress();
 
-      vector<PeptideIdentification> peptide_ids;
-      vector<ProteinIdentification> protein_ids;
-      progresslogger.startProgress(0, 1, "Post-processing PSMs...");
-      postProcessHits_(spectra, peptide_hits, protein_ids, peptide_ids, report_top_hits);
-      progresslogger.endProgress();
-
-      protein_ids[0].setPrimaryMSRunPath(spectra.getPrimaryMSRunPath());
-
-      // write ProteinIdentifications and PeptideIdentifications to IdXML
-      IdXMLFile().store(out_idxml, protein_ids, peptide_ids);
+      storeHits_(spectra, peptide_hits, report_top_hits, out_idxml);
 
       return EXECUTION_OK;
     }